@@ -51,6 +51,48 @@ class LruCache {
     return std::get<1>(data_[key]);
   }
 
+  /**
+   * @brief Looks up the key and refreshes it if present. Unlike Contains()
+   * followed by Get(), the lookup is atomic, so the element cannot be evicted
+   * in between.
+   *
+   * @param key the key to look up.
+   * @param value set to a copy of the cached value if the key is present.
+   * @return true if the key is present.
+   */
+  bool TryGet(const TKey& key, TVal& value) {
+    std::lock_guard lock(data_mutex_);
+
+    auto it = data_.find(key);
+    if (it == data_.end()) {
+      return false;
+    }
+    // Move the element to the front of the freshness list. Splicing keeps the
+    // stored iterator valid.
+    freshness_list_.splice(freshness_list_.begin(), freshness_list_,
+                           std::get<0>(it->second));
+    value = std::get<1>(it->second);
+    return true;
+  }
+
+  /**
+   * @brief Removes the key if present.
+   *
+   * @param key the key to remove.
+   * @return true if the key was present.
+   */
+  bool Erase(const TKey& key) {
+    std::lock_guard lock(data_mutex_);
+
+    auto it = data_.find(key);
+    if (it == data_.end()) {
+      return false;
+    }
+    freshness_list_.erase(std::get<0>(it->second));
+    data_.erase(it);
+    return true;
+  }
+
   size_t Size() {
     std::lock_guard lock(data_mutex_);
     return data_.size();
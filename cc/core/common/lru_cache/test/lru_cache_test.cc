@@ -204,4 +204,48 @@ TEST(LruCacheTest, ShouldBeAbleToGetAllItems) {
   EXPECT_EQ(all_items[key1], value1);
   EXPECT_EQ(all_items[key2], value2);
 }
+
+TEST(LruCacheTest, TryGetShouldReturnFalseForMissingKey) {
+  LruCache<string, string> cache(2);
+  string value = "Untouched";
+
+  EXPECT_FALSE(cache.TryGet("Key1", value));
+  EXPECT_EQ(value, "Untouched");
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(LruCacheTest, LruPolicyShouldBeAffectedByTryGets) {
+  LruCache<string, string> cache(2);
+
+  cache.Set("Key1", "Value1");
+  cache.Set("Key2", "Value2");
+
+  string value;
+  EXPECT_TRUE(cache.TryGet("Key1", value));
+  EXPECT_EQ(value, "Value1");
+
+  // Key2 is now the least recently used element.
+  cache.Set("Key3", "Value3");
+
+  EXPECT_TRUE(cache.Contains("Key1"));
+  EXPECT_FALSE(cache.Contains("Key2"));
+  EXPECT_TRUE(cache.Contains("Key3"));
+}
+
+TEST(LruCacheTest, EraseShouldRemoveElement) {
+  LruCache<string, string> cache(2);
+
+  cache.Set("Key1", "Value1");
+  cache.Set("Key2", "Value2");
+
+  EXPECT_TRUE(cache.Erase("Key1"));
+  EXPECT_FALSE(cache.Erase("Key1"));
+  EXPECT_FALSE(cache.Contains("Key1"));
+  EXPECT_EQ(cache.Size(), 1);
+
+  // The freed slot is reused without evicting Key2.
+  cache.Set("Key3", "Value3");
+  EXPECT_TRUE(cache.Contains("Key2"));
+  EXPECT_TRUE(cache.Contains("Key3"));
+}
 }  // namespace google::scp::core::common::test
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "core/interface/async_context.h"
+
+namespace google::scp::core::common {
+/**
+ * @brief Collapses concurrent identical async operations into one.
+ *
+ * The first caller for a key (the leader) runs the operation. Callers with
+ * the same key arriving while it is in flight (the followers) do not run it,
+ * and are finished with the leader's result and a copy of its response.
+ * Nothing is cached: once the leader finishes, the next caller runs the
+ * operation again.
+ *
+ * @tparam TRequest the request type of the operation.
+ * @tparam TResponse the response type of the operation. Must be copyable.
+ */
+template <typename TRequest, typename TResponse>
+class SingleFlight {
+ public:
+  using Operation = std::function<void(AsyncContext<TRequest, TResponse>&)>;
+
+  /**
+   * @brief Runs the operation for the context, unless one for the same key is
+   * already in flight. The context is finished either way.
+   *
+   * @param key identifies the requests that are served by the same operation.
+   * @param context the context of the caller.
+   * @param operation runs the request and finishes the context it is given.
+   */
+  void Execute(const std::string& key,
+               AsyncContext<TRequest, TResponse>& context,
+               const Operation& operation) noexcept {
+    {
+      std::lock_guard lock(mutex_);
+      auto [it, inserted] = followers_.try_emplace(key);
+      if (!inserted) {
+        it->second.push_back(context);
+        coalesced_count_++;
+        return;
+      }
+    }
+
+    auto leader_context = context;
+    // Results are converted by the callers' own contexts.
+    leader_context.convert_to_public_error = false;
+    leader_context.callback =
+        [this, key,
+         context](AsyncContext<TRequest, TResponse>& leader_context) mutable {
+          std::vector<AsyncContext<TRequest, TResponse>> followers;
+          {
+            std::lock_guard lock(mutex_);
+            auto it = followers_.find(key);
+            followers = std::move(it->second);
+            followers_.erase(it);
+          }
+
+          for (auto& follower : followers) {
+            follower.result = leader_context.result;
+            // Every caller owns its response.
+            if (leader_context.response) {
+              follower.response =
+                  std::make_shared<TResponse>(*leader_context.response);
+            }
+            follower.Finish();
+          }
+          context.result = leader_context.result;
+          context.response = std::move(leader_context.response);
+          context.Finish();
+        };
+    operation(leader_context);
+  }
+
+  /// Gets the number of callers served by an operation already in flight.
+  size_t GetCoalescedCount() noexcept {
+    std::lock_guard lock(mutex_);
+    return coalesced_count_;
+  }
+
+ private:
+  std::mutex mutex_;
+  /// The callers waiting for each operation in flight.
+  absl::flat_hash_map<std::string,
+                      std::vector<AsyncContext<TRequest, TResponse>>>
+      followers_;
+  size_t coalesced_count_ = 0;
+};
+}  // namespace google::scp::core::common
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/single_flight/src/single_flight.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/test/utils/conditional_wait.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::WaitUntil;
+using std::atomic;
+using std::make_shared;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+
+namespace google::scp::core::common::test {
+using StringContext = AsyncContext<string, string>;
+
+class SingleFlightTest : public testing::Test {
+ protected:
+  // Holds the operations in flight until FinishOperations().
+  void StartOperation(StringContext& context) {
+    operation_count_++;
+    in_flight_.push_back(context);
+  }
+
+  void FinishOperations() {
+    auto in_flight = std::move(in_flight_);
+    for (auto& context : in_flight) {
+      context.response = make_shared<string>("value:" + *context.request);
+      context.result = SuccessExecutionResult();
+      context.Finish();
+    }
+  }
+
+  void Execute(const string& key, const string& request) {
+    StringContext context(make_shared<string>(request),
+                          [this](StringContext& context) {
+                            EXPECT_SUCCESS(context.result);
+                            responses_.push_back(context.response);
+                          });
+    single_flight_.Execute(key, context, [this](StringContext& context) {
+      StartOperation(context);
+    });
+  }
+
+  SingleFlight<string, string> single_flight_;
+  int operation_count_ = 0;
+  vector<StringContext> in_flight_;
+  vector<shared_ptr<string>> responses_;
+};
+
+TEST_F(SingleFlightTest, FollowersGetLeaderResponse) {
+  Execute("key", "request");
+  Execute("key", "request");
+  Execute("key", "request");
+  EXPECT_EQ(operation_count_, 1);
+  EXPECT_TRUE(responses_.empty());
+
+  FinishOperations();
+  ASSERT_EQ(responses_.size(), 3);
+  for (const auto& response : responses_) {
+    EXPECT_EQ(*response, "value:request");
+  }
+  // Every caller gets its own copy of the response.
+  EXPECT_NE(responses_[0], responses_[1]);
+  EXPECT_NE(responses_[1], responses_[2]);
+  EXPECT_EQ(single_flight_.GetCoalescedCount(), 2);
+}
+
+TEST_F(SingleFlightTest, DifferentKeysRunSeparately) {
+  Execute("key1", "request1");
+  Execute("key2", "request2");
+  EXPECT_EQ(operation_count_, 2);
+
+  FinishOperations();
+  ASSERT_EQ(responses_.size(), 2);
+  EXPECT_EQ(*responses_[0], "value:request1");
+  EXPECT_EQ(*responses_[1], "value:request2");
+  EXPECT_EQ(single_flight_.GetCoalescedCount(), 0);
+}
+
+TEST_F(SingleFlightTest, RunsAgainOnceLeaderFinishes) {
+  Execute("key", "request");
+  FinishOperations();
+  Execute("key", "request");
+  EXPECT_EQ(operation_count_, 2);
+  FinishOperations();
+  EXPECT_EQ(responses_.size(), 2);
+}
+
+TEST_F(SingleFlightTest, FailureIsPassedToFollowers) {
+  auto failure = FailureExecutionResult(SC_UNKNOWN);
+  atomic<int> finished_count = 0;
+  vector<StringContext> in_flight;
+  for (int i = 0; i < 2; ++i) {
+    StringContext context(make_shared<string>("request"),
+                          [&](StringContext& context) {
+                            EXPECT_THAT(context.result, ResultIs(failure));
+                            EXPECT_EQ(context.response, nullptr);
+                            finished_count++;
+                          });
+    single_flight_.Execute("key", context, [&](StringContext& context) {
+      in_flight.push_back(context);
+    });
+  }
+  ASSERT_EQ(in_flight.size(), 1);
+  in_flight[0].result = failure;
+  in_flight[0].Finish();
+  EXPECT_EQ(finished_count, 2);
+}
+
+TEST_F(SingleFlightTest, SynchronousOperation) {
+  int operation_count = 0;
+  int finished_count = 0;
+  for (int i = 0; i < 2; ++i) {
+    StringContext context(
+        make_shared<string>("request"),
+        [&](StringContext& context) {
+          EXPECT_SUCCESS(context.result);
+          finished_count++;
+        });
+    single_flight_.Execute("key", context, [&](StringContext& context) {
+      operation_count++;
+      context.result = SuccessExecutionResult();
+      context.Finish();
+    });
+  }
+  EXPECT_EQ(operation_count, 2);
+  EXPECT_EQ(finished_count, 2);
+}
+
+TEST(SingleFlightConcurrencyTest, ConcurrentCallersAreAllFinished) {
+  SingleFlight<string, string> single_flight;
+  mutex in_flight_mutex;
+  vector<StringContext> in_flight;
+  atomic<int> operation_count = 0;
+  atomic<int> finished_count = 0;
+  atomic<bool> stop = false;
+
+  // Finishes the operations in flight from another thread, like an I/O
+  // thread would.
+  thread finisher([&]() {
+    while (!stop.load()) {
+      vector<StringContext> to_finish;
+      {
+        std::lock_guard lock(in_flight_mutex);
+        to_finish.swap(in_flight);
+      }
+      for (auto& context : to_finish) {
+        context.response = make_shared<string>(*context.request);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+      }
+      std::this_thread::yield();
+    }
+  });
+
+  constexpr int kNumThreads = 8;
+  constexpr int kCallsPerThread = 200;
+  vector<thread> callers;
+  for (int t = 0; t < kNumThreads; ++t) {
+    callers.emplace_back([&, t]() {
+      for (int i = 0; i < kCallsPerThread; ++i) {
+        auto key = to_string(i % 4);
+        StringContext context(make_shared<string>(key),
+                              [&, key](StringContext& context) {
+                                EXPECT_SUCCESS(context.result);
+                                EXPECT_EQ(*context.response, key);
+                                finished_count++;
+                              });
+        single_flight.Execute(key, context, [&](StringContext& context) {
+          operation_count++;
+          std::lock_guard lock(in_flight_mutex);
+          in_flight.push_back(context);
+        });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  WaitUntil([&]() {
+    return finished_count.load() == kNumThreads * kCallsPerThread;
+  });
+  stop = true;
+  finisher.join();
+
+  EXPECT_EQ(operation_count.load() + single_flight.GetCoalescedCount(),
+            kNumThreads * kCallsPerThread);
+}
+}  // namespace google::scp::core::common::test
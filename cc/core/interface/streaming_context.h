@@ -183,6 +183,11 @@ struct ConsumerStreamingContext : public StreamingContext<TRequest, TResponse> {
     return response_queue->TryEnqueue(std::move(resp));
   }
 
+  /// The number of responses pushed but not acquired by the consumer yet.
+  size_t GetNumOutstandingResponses() noexcept {
+    return response_queue->Size();
+  }
+
   using ProcessCallback = typename std::function<void(
       ConsumerStreamingContext<TRequest, TResponse>&, bool)>;
 
@@ -64,6 +64,23 @@ ExecutionResultOr<string> Base64Encode(const string& decoded) {
   return string(reinterpret_cast<char*>(buffer.get()), ret);
 }
 
+ExecutionResult Base64Encode(const char* decoded, size_t size,
+                             string& encoded) {
+  size_t required_len = 0;
+  if (EVP_EncodedLength(&required_len, size) == 0) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+  // The required length includes the trailing NUL.
+  encoded.resize(required_len);
+  int ret = EVP_EncodeBlock(reinterpret_cast<uint8_t*>(encoded.data()),
+                            reinterpret_cast<const uint8_t*>(decoded), size);
+  encoded.resize(ret);
+  if (ret == 0) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+  return SuccessExecutionResult();
+}
+
 ExecutionResult Base64Decode(const string& encoded, string& decoded) {
   ASSIGN_OR_RETURN(decoded, Base64Decode(encoded));
   return SuccessExecutionResult();
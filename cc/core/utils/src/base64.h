@@ -37,6 +37,19 @@ ExecutionResultOr<std::string> Base64Decode(const std::string& encoded);
  */
 ExecutionResultOr<std::string> Base64Encode(const std::string& decoded);
 
+/**
+ * @brief Encodes values to base64 into the caller's string, replacing its
+ * content. No temporary copy of the encoding is made, so it can be written
+ * straight into e.g. a proto field.
+ *
+ * @param decoded The input value to be encoded.
+ * @param size The size of the input value.
+ * @param encoded The output value.
+ * @return ExecutionResult Fails if the input value is empty.
+ */
+ExecutionResult Base64Encode(const char* decoded, size_t size,
+                             std::string& encoded);
+
 
 // DEPRECATED, please use the above options.
 ExecutionResult Base64Decode(const std::string& encoded, std::string& decoded);
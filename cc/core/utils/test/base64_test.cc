@@ -47,6 +47,17 @@ TEST(Base64Test, Base64EncodeValidValueOLD) {
   EXPECT_EQ(encoded, "dGVzdF90ZXN0X3Rlc3Q=");
 }
 
+TEST(Base64Test, Base64EncodeIntoString) {
+  string decoded("test_test_test");
+  string encoded = "previous content";
+  EXPECT_SUCCESS(Base64Encode(decoded.data(), decoded.size(), encoded));
+  EXPECT_EQ(encoded, "dGVzdF90ZXN0X3Rlc3Q=");
+
+  EXPECT_THAT(
+      Base64Encode(decoded.data(), 0, encoded),
+      ResultIs(FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT)));
+}
+
 TEST(Base64Test, Base64DecodeInvalidValue) {
   // Not correctly padded - needs "==" appended.
   string encoded("sdasdasdas");
@@ -64,6 +64,14 @@ class MockBlobStorageClientProvider
           cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&)),
       (noexcept, override));
 
+  MOCK_METHOD(
+      void, ListAllBlobsMetadata,
+      ((core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::
+              ListAllBlobsMetadataResponse>&)),
+      (noexcept, override));
+
   MOCK_METHOD(void, PutBlob,
               ((core::AsyncContext<
                   cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
@@ -83,6 +91,12 @@ class MockBlobStorageClientProvider
                   cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&)),
               (noexcept, override));
 
+  MOCK_METHOD(void, DeleteBlobs,
+              ((core::AsyncContext<
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&)),
+              (noexcept, override));
+
   MOCK_METHOD(core::ExecutionResultOr<std::unique_ptr<std::istream>>,
               GetBlobStreamSync,
               ((const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
@@ -19,10 +19,12 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
+#include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/Outcome.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/AbortMultipartUploadRequest.h>
@@ -30,6 +32,7 @@
 #include <aws/s3/model/CompletedMultipartUpload.h>
 #include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
@@ -41,9 +44,16 @@
 #include "cc/cpio/common/src/common_error_codes.h"
 #include "core/async_executor/src/aws/aws_async_executor.h"
 #include "core/utils/src/base64.h"
-#include "core/utils/src/hashing.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/aws/aws_blob_storage_client_streams.h"
 #include "cpio/client_providers/blob_storage_client_provider/src/aws/aws_blob_storage_client_utils.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/cache/caching_blob_storage_client_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
 #include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_blob_lister.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_part_uploader.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_range_reader.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/local/local_blob_storage_client_provider.h"
 #include "cpio/client_providers/instance_client_provider/src/aws/aws_instance_client_utils.h"
 #include "cpio/common/src/aws/aws_utils.h"
 #include "public/cpio/interface/blob_storage_client/type_def.h"
@@ -53,6 +63,7 @@ using Aws::String;
 using Aws::StringStream;
 using Aws::Client::AsyncCallerContext;
 using Aws::Client::ClientConfiguration;
+using Aws::Http::HttpResponseCode;
 using Aws::S3::S3Client;
 using Aws::S3::Model::AbortMultipartUploadOutcome;
 using Aws::S3::Model::AbortMultipartUploadRequest;
@@ -62,15 +73,19 @@ using Aws::S3::Model::CompleteMultipartUploadOutcome;
 using Aws::S3::Model::CompleteMultipartUploadRequest;
 using Aws::S3::Model::CreateMultipartUploadOutcome;
 using Aws::S3::Model::CreateMultipartUploadRequest;
+using Aws::S3::Model::Delete;
 using Aws::S3::Model::DeleteObjectOutcome;
 using Aws::S3::Model::DeleteObjectRequest;
 using Aws::S3::Model::DeleteObjectResult;
+using Aws::S3::Model::DeleteObjectsOutcome;
+using Aws::S3::Model::DeleteObjectsRequest;
 using Aws::S3::Model::GetObjectOutcome;
 using Aws::S3::Model::GetObjectRequest;
 using Aws::S3::Model::GetObjectResult;
 using Aws::S3::Model::ListObjectsOutcome;
 using Aws::S3::Model::ListObjectsRequest;
 using Aws::S3::Model::ListObjectsResult;
+using Aws::S3::Model::ObjectIdentifier;
 using Aws::S3::Model::PutObjectOutcome;
 using Aws::S3::Model::PutObjectRequest;
 using Aws::S3::Model::PutObjectResult;
@@ -79,12 +94,21 @@ using Aws::S3::Model::UploadPartRequest;
 using google::cmrt::sdk::blob_storage_service::v1::Blob;
 using google::cmrt::sdk::blob_storage_service::v1::BlobIdentity;
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
 using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
@@ -114,20 +138,24 @@ using google::scp::core::errors::
     SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
 using google::scp::core::errors::SC_COMMON_ERRORS_UNIMPLEMENTED;
 using google::scp::core::utils::Base64Encode;
-using google::scp::core::utils::CalculateMd5Hash;
 using google::scp::cpio::client_providers::AwsInstanceClientUtils;
+using google::scp::cpio::client_providers::BorrowedBytesStreamBuffer;
+using google::scp::cpio::client_providers::BufferedIOStream;
+using google::scp::cpio::client_providers::StringStreamBuffer;
 using std::bind;
 using std::make_shared;
 using std::move;
+using std::nullopt;
 using std::optional;
 using std::shared_ptr;
 using std::string;
-using std::stringstream;
+using std::unordered_map;
 using std::vector;
 using std::chrono::duration_cast;
 using std::chrono::minutes;
 using std::chrono::nanoseconds;
 using std::chrono::seconds;
+using std::chrono::steady_clock;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -137,28 +165,49 @@ namespace {
 constexpr char kAwsS3Provider[] = "AwsBlobStorageClientProvider";
 constexpr size_t kMaxConcurrentConnections = 1000;
 constexpr size_t kListBlobsMetadataMaxResults = 1000;
+// The max number of keys of an S3 DeleteObjects.
+constexpr size_t kDeleteObjectsMaxKeys = 1000;
 constexpr size_t k64KbCount = 64 << 10;
+constexpr size_t kAdaptiveMaxBytesPerResponse = 8 << 20;
 constexpr size_t kMinimumPartSize = 5 << 20;
 constexpr nanoseconds kDefaultStreamKeepaliveNanos =
     duration_cast<nanoseconds>(minutes(5));
 constexpr nanoseconds kMaximumStreamKeepaliveNanos =
     duration_cast<nanoseconds>(minutes(10));
 constexpr seconds kPutBlobRescanTime = seconds(5);
+constexpr char kChecksumCrc32cHeader[] = "x-amz-checksum-crc32c";
 
+// Sets the checksum of the body for S3 to check the body against.
 template <typename Context, typename Request>
-ExecutionResult SetContentMd5(Context& context, Request& request,
-                              const string& body) {
-  ASSIGN_OR_LOG_AND_RETURN_CONTEXT(string md5_checksum, CalculateMd5Hash(body),
-                                   kAwsS3Provider, context,
-                                   "MD5 Hash generation failed");
-
-  ASSIGN_OR_LOG_AND_RETURN_CONTEXT(string base64_md5_checksum,
-                                   Base64Encode(md5_checksum), kAwsS3Provider,
-                                   context, "Encoding MD5 to base64 failed");
-  request.SetContentMD5(base64_md5_checksum.c_str());
+ExecutionResult SetChecksum(Context& context, Request& request,
+                            const string& body, ChecksumAlgorithm algorithm) {
+  BlobChecksum checksum(algorithm);
+  if (checksum.GetAlgorithm() == CHECKSUM_ALGORITHM_NONE) {
+    return SuccessExecutionResult();
+  }
+  checksum.Update(body);
+  ASSIGN_OR_LOG_AND_RETURN_CONTEXT(
+      string base64_checksum, Base64Encode(checksum.Finish()), kAwsS3Provider,
+      context, "Encoding the checksum to base64 failed");
+  if (checksum.GetAlgorithm() == CHECKSUM_ALGORITHM_CRC32C) {
+    request.SetAdditionalCustomHeaderValue(kChecksumCrc32cHeader,
+                                           base64_checksum.c_str());
+  } else {
+    request.SetContentMD5(base64_checksum.c_str());
+  }
   return SuccessExecutionResult();
 }
 
+// Gets the checksum of the parts of a PutBlobStream. Completing a multipart
+// upload of CRC32C parts takes the CRC32C of each part, which this SDK cannot
+// send, so the parts are checked by MD5 unless checksums are off.
+ChecksumAlgorithm GetPartChecksumAlgorithm(
+    const PutBlobStreamRequest& request) {
+  return request.checksum_algorithm() == CHECKSUM_ALGORITHM_NONE
+             ? CHECKSUM_ALGORITHM_NONE
+             : CHECKSUM_ALGORITHM_MD5;
+}
+
 // Validates the bucket_name, blob_name and byte_range for GetBlobRequest or
 // GetBlobStreamRequest.
 template <typename Context>
@@ -197,9 +246,24 @@ GetObjectRequest MakeGetObjectRequest(const ProtoRequest& proto_request,
   if (range.has_value()) {
     get_object_request.SetRange(move(*range));
   }
+  // Write the body into a string which TakeBodyBytes can move out, rather
+  // than the default Aws::StringStream which has to be copied out of.
+  get_object_request.SetResponseStreamFactory([]() {
+    return Aws::New<BufferedIOStream<StringStreamBuffer>>(kAwsS3Provider);
+  });
   return get_object_request;
 }
 
+// Gets the total size of the object out of a ContentRange of the form
+// "bytes 0-83886079/1258291200".
+optional<uint64_t> GetObjectSize(const String& content_range) {
+  vector<string> parts = absl::StrSplit(content_range, "/");
+  if (parts.size() != 2 || parts[1] == "*") {
+    return nullopt;
+  }
+  return strtoull(parts[1].c_str(), nullptr, 10);
+}
+
 }  // namespace
 
 namespace google::scp::cpio::client_providers {
@@ -253,6 +317,9 @@ void AwsBlobStorageClientProvider::GetBlob(
                          request.byte_range().end_byte_index());
   }
   auto get_object_request = MakeGetObjectRequest(request, move(range));
+  if (request.has_if_none_match_etag()) {
+    get_object_request.SetIfNoneMatch(request.if_none_match_etag());
+  }
 
   s3_client_->GetObjectAsync(
       get_object_request,
@@ -266,6 +333,22 @@ void AwsBlobStorageClientProvider::OnGetObjectCallback(
     const S3Client* s3_client, const GetObjectRequest& get_object_request,
     GetObjectOutcome get_object_outcome,
     const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  // S3 answers a GetObject whose IfNoneMatch still matches with a 304.
+  if (!get_object_outcome.IsSuccess() &&
+      get_blob_context.request->has_if_none_match_etag() &&
+      get_object_outcome.GetError().GetResponseCode() ==
+          HttpResponseCode::NOT_MODIFIED) {
+    get_blob_context.response = make_shared<GetBlobResponse>();
+    get_blob_context.response->mutable_blob()->mutable_metadata()->CopyFrom(
+        get_blob_context.request->blob_metadata());
+    get_blob_context.response->set_etag(
+        get_blob_context.request->if_none_match_etag());
+    get_blob_context.response->set_not_modified(true);
+    get_blob_context.result = SuccessExecutionResult();
+    FinishContext(get_blob_context.result, get_blob_context,
+                  cpu_async_executor_, AsyncPriority::High);
+    return;
+  }
   if (!get_object_outcome.IsSuccess()) {
     get_blob_context.result =
         AwsBlobStorageClientUtils::ConvertS3ErrorToExecutionResult(
@@ -281,22 +364,22 @@ void AwsBlobStorageClientProvider::OnGetObjectCallback(
   }
 
   auto& result = get_object_outcome.GetResult();
-  auto& body = result.GetBody();
-  auto content_length = result.GetContentLength();
+  auto bytes_or = TakeBodyBytes(result.GetBody(), result.GetContentLength());
+  if (!bytes_or.Successful()) {
+    get_blob_context.result = bytes_or.result();
+    SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_context, get_blob_context.result,
+                      "Reading GetBlob body failed");
+    FinishContext(get_blob_context.result, get_blob_context,
+                  cpu_async_executor_, AsyncPriority::High);
+    return;
+  }
 
   get_blob_context.response = make_shared<GetBlobResponse>();
   get_blob_context.response->mutable_blob()->mutable_metadata()->CopyFrom(
       get_blob_context.request->blob_metadata());
-  get_blob_context.response->mutable_blob()->mutable_data()->resize(
-      content_length);
+  get_blob_context.response->mutable_blob()->set_data(move(*bytes_or));
+  get_blob_context.response->set_etag(result.GetETag());
   get_blob_context.result = SuccessExecutionResult();
-
-  if (!body.read(
-          get_blob_context.response->mutable_blob()->mutable_data()->data(),
-          content_length)) {
-    get_blob_context.result =
-        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
-  }
   FinishContext(get_blob_context.result, get_blob_context, cpu_async_executor_,
                 AsyncPriority::High);
 }
@@ -309,15 +392,31 @@ void AwsBlobStorageClientProvider::GetBlobStream(
     get_blob_stream_context.result = result;
     get_blob_stream_context.MarkDone();
     get_blob_stream_context.Finish();
+    return;
+  }
+
+  if (options_ && options_->get_blob_stream_parallelism > 1) {
+    GetBlobStreamInParallel(get_blob_stream_context);
+    return;
   }
 
   const auto& request = *get_blob_stream_context.request;
 
   auto tracker = make_shared<GetBlobStreamTracker>();
 
-  tracker->max_bytes_per_response = request.max_bytes_per_response() == 0
-                                        ? k64KbCount
-                                        : request.max_bytes_per_response();
+  if (request.adaptive_bytes_per_response()) {
+    // Each response is a separate ranged GetObject, so small responses after
+    // the first take a round trip each for little data.
+    tracker->chunk_sizer.emplace(k64KbCount,
+                                 request.max_bytes_per_response() == 0
+                                     ? kAdaptiveMaxBytesPerResponse
+                                     : request.max_bytes_per_response());
+    tracker->max_bytes_per_response = tracker->chunk_sizer->GetChunkSize();
+  } else {
+    tracker->max_bytes_per_response = request.max_bytes_per_response() == 0
+                                          ? k64KbCount
+                                          : request.max_bytes_per_response();
+  }
   size_t read_size = tracker->max_bytes_per_response;
 
   // If the end index is out of bounds of the object, that's fine - S3 will
@@ -343,6 +442,7 @@ void AwsBlobStorageClientProvider::GetBlobStream(
     tracker->last_end_byte_index = read_size - 1;
   }
 
+  tracker->read_start_time = steady_clock::now();
   s3_client_->GetObjectAsync(
       MakeGetObjectRequest(request, move(range)),
       bind(&AwsBlobStorageClientProvider::OnGetObjectStreamCallback, this,
@@ -403,12 +503,9 @@ void AwsBlobStorageClientProvider::OnGetObjectStreamCallback(
       tracker->last_begin_byte_index);
   response.mutable_byte_range()->set_end_byte_index(
       tracker->last_end_byte_index);
-  response.mutable_blob_portion()->mutable_data()->resize(actual_length_read);
-  auto& body = result.GetBody();
-  if (!body.read(response.mutable_blob_portion()->mutable_data()->data(),
-                 actual_length_read)) {
-    get_blob_stream_context.result =
-        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+  auto bytes_or = TakeBodyBytes(result.GetBody(), actual_length_read);
+  if (!bytes_or.Successful()) {
+    get_blob_stream_context.result = bytes_or.result();
     SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context,
                       get_blob_stream_context.result,
                       "Reading GetBlobStream body failed");
@@ -416,6 +513,14 @@ void AwsBlobStorageClientProvider::OnGetObjectStreamCallback(
                            get_blob_stream_context, cpu_async_executor_);
     return;
   }
+  response.mutable_blob_portion()->set_data(move(*bytes_or));
+
+  if (tracker->chunk_sizer) {
+    tracker->chunk_sizer->RecordRead(
+        actual_length_read, steady_clock::now() - tracker->read_start_time,
+        get_blob_stream_context.GetNumOutstandingResponses());
+    tracker->max_bytes_per_response = tracker->chunk_sizer->GetChunkSize();
+  }
 
   auto push_result = get_blob_stream_context.TryPushResponse(move(response));
   if (!push_result.Successful()) {
@@ -479,6 +584,7 @@ void AwsBlobStorageClientProvider::OnGetObjectStreamCallback(
   tracker->last_begin_byte_index = tracker->last_end_byte_index + 1;
   tracker->last_end_byte_index = new_end_index;
 
+  tracker->read_start_time = steady_clock::now();
   s3_client_->GetObjectAsync(
       MakeGetObjectRequest(request, move(range)),
       bind(&AwsBlobStorageClientProvider::OnGetObjectStreamCallback, this,
@@ -486,6 +592,55 @@ void AwsBlobStorageClientProvider::OnGetObjectStreamCallback(
       nullptr);
 }
 
+void AwsBlobStorageClientProvider::GetBlobStreamInParallel(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
+        get_blob_stream_context) noexcept {
+  auto read_range = [this, get_blob_stream_context](
+                        uint64_t begin_byte_index, uint64_t end_byte_index,
+                        ParallelRangeReader::PartCallback callback) {
+    // SetRange is inclusive on both ends. If the end index is out of bounds of
+    // the object, S3 truncates the response to the end of the object.
+    optional<string> range =
+        absl::StrCat("bytes=", begin_byte_index, "-", end_byte_index);
+    s3_client_->GetObjectAsync(
+        MakeGetObjectRequest(*get_blob_stream_context.request, move(range)),
+        [get_blob_stream_context, callback = move(callback)](
+            const S3Client*, const GetObjectRequest&,
+            GetObjectOutcome get_object_outcome,
+            const shared_ptr<const AsyncCallerContext>&) {
+          if (!get_object_outcome.IsSuccess()) {
+            auto result =
+                AwsBlobStorageClientUtils::ConvertS3ErrorToExecutionResult(
+                    get_object_outcome.GetError().GetErrorType());
+            SCP_ERROR_CONTEXT(
+                kAwsS3Provider, get_blob_stream_context, result,
+                "Get blob stream request failed. Error code: %d, message: %s",
+                get_object_outcome.GetError().GetResponseCode(),
+                get_object_outcome.GetError().GetMessage().c_str());
+            callback(result, nullopt);
+            return;
+          }
+          auto& result = get_object_outcome.GetResult();
+          auto part_or =
+              TakeBodyBytes(result.GetBody(), result.GetContentLength());
+          if (!part_or.Successful()) {
+            SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context,
+                              part_or.result(),
+                              "Reading GetBlobStream body failed");
+            callback(part_or.result(), nullopt);
+            return;
+          }
+          callback(move(*part_or), GetObjectSize(result.GetContentRange()));
+        },
+        nullptr);
+  };
+  make_shared<ParallelRangeReader>(
+      get_blob_stream_context, move(read_range),
+      options_->get_blob_stream_part_size,
+      options_->get_blob_stream_parallelism, cpu_async_executor_)
+      ->Start();
+}
+
 void AwsBlobStorageClientProvider::ListBlobsMetadata(
     AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
         list_blobs_context) noexcept {
@@ -507,6 +662,7 @@ void AwsBlobStorageClientProvider::ListBlobsMetadata(
         kAwsS3Provider, list_blobs_context, list_blobs_context.result,
         "List blobs metadata request failed. Max page size cannot be "
         "greater than 1000.");
+    list_blobs_context.Finish();
     return;
   }
   String bucket_name(list_blobs_context.request->blob_metadata().bucket_name());
@@ -577,6 +733,19 @@ void AwsBlobStorageClientProvider::OnListObjectsMetadataCallback(
                 cpu_async_executor_, AsyncPriority::High);
 }
 
+void AwsBlobStorageClientProvider::ListAllBlobsMetadata(
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>&
+        list_all_blobs_context) noexcept {
+  // The lister checks the request before any page is listed.
+  make_shared<ParallelBlobLister>(
+      list_all_blobs_context,
+      [this](AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+                 list_blobs_context) { ListBlobsMetadata(list_blobs_context); },
+      options_ ? options_->list_all_blobs_parallelism : 1, cpu_async_executor_)
+      ->Start();
+}
+
 void AwsBlobStorageClientProvider::PutBlob(
     AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) noexcept {
   const auto& request = *put_blob_context.request;
@@ -599,21 +768,21 @@ void AwsBlobStorageClientProvider::PutBlob(
   put_object_request.SetBucket(bucket_name);
   put_object_request.SetKey(blob_name);
 
-  if (auto md5_result = SetContentMd5(put_blob_context, put_object_request,
-                                      request.blob().data());
-      !md5_result.Successful()) {
-    put_blob_context.result = md5_result;
+  if (auto checksum_result =
+          SetChecksum(put_blob_context, put_object_request,
+                      request.blob().data(), request.checksum_algorithm());
+      !checksum_result.Successful()) {
+    put_blob_context.result = checksum_result;
     put_blob_context.Finish();
     return;
   }
 
-  auto input_data = Aws::MakeShared<Aws::StringStream>(
-      "PutObjectInputStream",
-      stringstream::in | stringstream::out | stringstream::binary);
-  input_data->write(request.blob().data().c_str(),
-                    request.blob().data().size());
-
-  put_object_request.SetBody(input_data);
+  // Send the data out of the request instead of copying it into an
+  // Aws::StringStream. The body keeps the request alive.
+  put_object_request.SetBody(
+      MakeShared<BufferedIOStream<BorrowedBytesStreamBuffer>>(
+          "PutObjectInputStream", put_blob_context.request,
+          request.blob().data()));
 
   s3_client_->PutObjectAsync(
       put_object_request,
@@ -719,6 +888,11 @@ void AwsBlobStorageClientProvider::OnCreateMultipartUploadCallback(
   tracker->expiry_time_ns =
       TimeProvider::GetWallTimestampInNanoseconds() + duration;
 
+  if (options_ && options_->put_blob_stream_parallelism > 1) {
+    PutBlobStreamInParallel(put_blob_stream_context, tracker);
+    return;
+  }
+
   if (request.blob_portion().data().size() < kMinimumPartSize) {
     // Not enough data to upload in a part yet.
     // Copy data into a staging variable.
@@ -741,13 +915,16 @@ void AwsBlobStorageClientProvider::OnCreateMultipartUploadCallback(
   part_request.SetPartNumber(1);
   part_request.SetUploadId(tracker->upload_id.c_str());
 
-  part_request.SetBody(MakeShared<StringStream>("WriteStream::Upload",
-                                                request.blob_portion().data()));
+  part_request.SetBody(MakeShared<BufferedIOStream<BorrowedBytesStreamBuffer>>(
+      "WriteStream::Upload", put_blob_stream_context.request,
+      request.blob_portion().data()));
 
-  if (auto md5_result = SetContentMd5(put_blob_stream_context, part_request,
-                                      request.blob_portion().data());
-      !md5_result.Successful()) {
-    put_blob_stream_context.result = md5_result;
+  if (auto checksum_result =
+          SetChecksum(put_blob_stream_context, part_request,
+                      request.blob_portion().data(),
+                      GetPartChecksumAlgorithm(request));
+      !checksum_result.Successful()) {
+    put_blob_stream_context.result = checksum_result;
     FinishStreamingContext(put_blob_stream_context.result,
                            put_blob_stream_context, cpu_async_executor_);
     return;
@@ -760,6 +937,92 @@ void AwsBlobStorageClientProvider::OnCreateMultipartUploadCallback(
       nullptr);
 }
 
+void AwsBlobStorageClientProvider::PutBlobStreamInParallel(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
+        put_blob_stream_context,
+    shared_ptr<PutBlobStreamTracker> tracker) noexcept {
+  auto upload_part = [this, put_blob_stream_context, tracker](
+                         int part_number, string part, string md5_digest,
+                         ParallelPartUploader::PartCallback callback) {
+    UploadPartRequest part_request;
+    part_request.SetBucket(tracker->bucket_name.c_str());
+    part_request.SetKey(tracker->blob_name.c_str());
+    part_request.SetPartNumber(part_number);
+    part_request.SetUploadId(tracker->upload_id.c_str());
+    // The digest is empty when checksums are off.
+    if (!md5_digest.empty()) {
+      auto base64_md5_or = Base64Encode(md5_digest);
+      if (!base64_md5_or.Successful()) {
+        SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
+                          base64_md5_or.result(),
+                          "Encoding MD5 to base64 failed");
+        callback(base64_md5_or.result());
+        return;
+      }
+      part_request.SetContentMD5(base64_md5_or->c_str());
+    }
+    part_request.SetBody(MakeShared<BufferedIOStream<StringStreamBuffer>>(
+        "WriteStream::Upload", move(part)));
+
+    s3_client_->UploadPartAsync(
+        part_request,
+        [put_blob_stream_context, callback = move(callback)](
+            const S3Client*, const UploadPartRequest&,
+            UploadPartOutcome upload_part_outcome,
+            const shared_ptr<const AsyncCallerContext>&) {
+          if (!upload_part_outcome.IsSuccess()) {
+            auto result =
+                AwsBlobStorageClientUtils::ConvertS3ErrorToExecutionResult(
+                    upload_part_outcome.GetError().GetErrorType());
+            SCP_ERROR_CONTEXT(
+                kAwsS3Provider, put_blob_stream_context, result,
+                "Upload part request failed. Error code: %d, message: %s",
+                upload_part_outcome.GetError().GetResponseCode(),
+                upload_part_outcome.GetError().GetMessage().c_str());
+            callback(result);
+            return;
+          }
+          const auto& etag = upload_part_outcome.GetResult().GetETag();
+          if (etag.empty()) {
+            auto result =
+                FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_EMPTY_ETAG);
+            SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context, result,
+                              "Upload part request returned an empty ETag.");
+            callback(result);
+            return;
+          }
+          callback(string(etag));
+        },
+        nullptr);
+  };
+  auto done_callback = [this, put_blob_stream_context, tracker](
+                           ExecutionResult result,
+                           vector<string> part_etags) mutable {
+    if (!result.Successful()) {
+      put_blob_stream_context.result = result;
+      SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context, result,
+                        "Put blob stream request failed.");
+      AbortUpload(put_blob_stream_context, tracker);
+      return;
+    }
+    for (size_t i = 0; i < part_etags.size(); i++) {
+      CompletedPart completed_part;
+      completed_part.SetPartNumber(i + 1);
+      completed_part.SetETag(part_etags[i]);
+      tracker->completed_multipart_upload.AddParts(move(completed_part));
+    }
+    CompleteUpload(put_blob_stream_context, tracker);
+  };
+  make_shared<ParallelPartUploader>(
+      put_blob_stream_context, move(upload_part), move(done_callback),
+      std::max<uint64_t>(options_->put_blob_stream_part_size,
+                         kMinimumPartSize),
+      GetPartChecksumAlgorithm(*put_blob_stream_context.request),
+      options_->put_blob_stream_parallelism, tracker->expiry_time_ns,
+      kPutBlobRescanTime, io_async_executor_)
+      ->Start();
+}
+
 void AwsBlobStorageClientProvider::ScheduleAnotherPutBlobStreamPoll(
     ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
         put_blob_stream_context,
@@ -926,10 +1189,11 @@ void AwsBlobStorageClientProvider::OnUploadPartCallback(
 
   new_upload_request.SetBody(stream_to_write);
 
-  if (auto md5_result = SetContentMd5(
-          put_blob_stream_context, new_upload_request, stream_to_write->str());
-      !md5_result.Successful()) {
-    put_blob_stream_context.result = md5_result;
+  if (auto checksum_result = SetChecksum(
+          put_blob_stream_context, new_upload_request, stream_to_write->str(),
+          GetPartChecksumAlgorithm(*put_blob_stream_context.request));
+      !checksum_result.Successful()) {
+    put_blob_stream_context.result = checksum_result;
     FinishStreamingContext(put_blob_stream_context.result,
                            put_blob_stream_context, cpu_async_executor_);
     return;
@@ -960,11 +1224,12 @@ void AwsBlobStorageClientProvider::CompleteUpload(
     new_upload_request.SetBody(MakeShared<StringStream>(
         "WriteStream::Upload", tracker->accumulated_contents));
 
-    if (auto md5_result =
-            SetContentMd5(put_blob_stream_context, new_upload_request,
-                          tracker->accumulated_contents);
-        !md5_result.Successful()) {
-      put_blob_stream_context.result = md5_result;
+    if (auto checksum_result = SetChecksum(
+            put_blob_stream_context, new_upload_request,
+            tracker->accumulated_contents,
+            GetPartChecksumAlgorithm(*put_blob_stream_context.request));
+        !checksum_result.Successful()) {
+      put_blob_stream_context.result = checksum_result;
       FinishStreamingContext(put_blob_stream_context.result,
                              put_blob_stream_context, cpu_async_executor_);
       return;
@@ -1110,6 +1375,76 @@ void AwsBlobStorageClientProvider::OnDeleteObjectCallback(
                 cpu_async_executor_, AsyncPriority::High);
 }
 
+void AwsBlobStorageClientProvider::DeleteBlobs(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+        delete_blobs_context) noexcept {
+  make_shared<BatchBlobDeleter>(
+      delete_blobs_context,
+      bind(&AwsBlobStorageClientProvider::DeleteObjects, this, _1, _2, _3),
+      kDeleteObjectsMaxKeys,
+      options_ ? options_->delete_blobs_parallelism : 1, cpu_async_executor_)
+      ->Start();
+}
+
+void AwsBlobStorageClientProvider::DeleteObjects(
+    const string& bucket_name, const vector<string>& blob_names,
+    BatchBlobDeleter::DeleteBatchCallback callback) noexcept {
+  Delete delete_objects;
+  for (const auto& blob_name : blob_names) {
+    delete_objects.AddObjects(ObjectIdentifier().WithKey(String(blob_name)));
+  }
+  // Only the keys which failed to be deleted are returned.
+  delete_objects.SetQuiet(true);
+  DeleteObjectsRequest delete_objects_request;
+  delete_objects_request.SetBucket(String(bucket_name));
+  delete_objects_request.SetDelete(move(delete_objects));
+
+  s3_client_->DeleteObjectsAsync(
+      delete_objects_request,
+      bind(&AwsBlobStorageClientProvider::OnDeleteObjectsCallback, this,
+           blob_names, move(callback), _1, _2, _3, _4),
+      nullptr);
+}
+
+void AwsBlobStorageClientProvider::OnDeleteObjectsCallback(
+    const vector<string>& blob_names,
+    const BatchBlobDeleter::DeleteBatchCallback& callback,
+    const S3Client* s3_client,
+    const DeleteObjectsRequest& delete_objects_request,
+    DeleteObjectsOutcome delete_objects_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  if (!delete_objects_outcome.IsSuccess()) {
+    auto result = AwsBlobStorageClientUtils::ConvertS3ErrorToExecutionResult(
+        delete_objects_outcome.GetError().GetErrorType());
+    SCP_ERROR(kAwsS3Provider, kZeroUuid, result,
+              "Delete objects request failed. Error code: %d, message: %s",
+              delete_objects_outcome.GetError().GetResponseCode(),
+              delete_objects_outcome.GetError().GetMessage().c_str());
+    callback(vector<ExecutionResult>(blob_names.size(), result));
+    return;
+  }
+  unordered_map<string, ExecutionResult> failed_results;
+  for (const auto& error : delete_objects_outcome.GetResult().GetErrors()) {
+    failed_results.emplace(
+        error.GetKey(),
+        AwsBlobStorageClientUtils::ConvertS3ErrorCodeToExecutionResult(
+            error.GetCode()));
+  }
+  if (!failed_results.empty()) {
+    SCP_ERROR(kAwsS3Provider, kZeroUuid, failed_results.begin()->second,
+              "Delete objects request failed for %zu of %zu keys.",
+              failed_results.size(), blob_names.size());
+  }
+  vector<ExecutionResult> results;
+  results.reserve(blob_names.size());
+  for (const auto& blob_name : blob_names) {
+    auto it = failed_results.find(blob_name);
+    results.push_back(it == failed_results.end() ? SuccessExecutionResult()
+                                                 : it->second);
+  }
+  callback(move(results));
+}
+
 ExecutionResultOr<std::unique_ptr<std::istream>>
 AwsBlobStorageClientProvider::GetBlobStreamSync(
     const BlobIdentity& blob_identity) noexcept {
@@ -1139,8 +1474,19 @@ BlobStorageClientProviderFactory::Create(
     const shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
     const shared_ptr<core::AsyncExecutorInterface>&
         io_async_executor) noexcept {
-  return make_shared<AwsBlobStorageClientProvider>(
-      options, instance_client, cpu_async_executor, io_async_executor);
+  shared_ptr<BlobStorageClientProviderInterface> provider;
+  if (options && !options->local_root_directory.empty()) {
+    provider = make_shared<LocalBlobStorageClientProvider>(
+        options, cpu_async_executor, io_async_executor);
+  } else {
+    provider = make_shared<AwsBlobStorageClientProvider>(
+        options, instance_client, cpu_async_executor, io_async_executor);
+  }
+  if (options && !options->cache_directory.empty()) {
+    return make_shared<CachingBlobStorageClientProvider>(options, provider,
+                                                         io_async_executor);
+  }
+  return provider;
 }
 #endif
 }  // namespace google::scp::cpio::client_providers
@@ -16,21 +16,27 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <aws/core/Aws.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/CompleteMultipartUploadRequest.h>
 #include <aws/s3/model/CompletedMultipartUpload.h>
 #include <aws/s3/model/CreateMultipartUploadRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 
 #include "core/interface/async_executor_interface.h"
 #include "core/interface/config_provider_interface.h"
 #include "core/interface/streaming_context.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/adaptive_chunk_sizer.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
 #include "public/cpio/interface/blob_storage_client/type_def.h"
@@ -50,7 +56,8 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
       const std::shared_ptr<core::AsyncExecutorInterface>& io_async_executor,
       std::shared_ptr<AwsS3Factory> s3_factory =
           std::make_shared<AwsS3Factory>())
-      : instance_client_(instance_client),
+      : options_(options),
+        instance_client_(instance_client),
         cpu_async_executor_(cpu_async_executor),
         io_async_executor_(io_async_executor),
         s3_factory_(s3_factory) {}
@@ -76,6 +83,12 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
           cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
           list_blobs_metadata_context) noexcept override;
 
+  void ListAllBlobsMetadata(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>&
+          list_all_blobs_context) noexcept override;
+
   void PutBlob(
       core::AsyncContext<cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
                          cmrt::sdk::blob_storage_service::v1::PutBlobResponse>&
@@ -92,6 +105,11 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
                   cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&
                       delete_blob_context) noexcept override;
 
+  void DeleteBlobs(core::AsyncContext<
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+                       delete_blobs_context) noexcept override;
+
   core::ExecutionResultOr<std::unique_ptr<std::istream>> GetBlobStreamSync(
       const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
           blob_identity) noexcept override;
@@ -128,6 +146,11 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
     int64_t bytes_remaining;
     // How many bytes (maximum) should be placed in each GetBlobStreamResponse.
     int64_t max_bytes_per_response;
+    // Picks max_bytes_per_response after each read, if the request asks for
+    // adaptive responses.
+    std::optional<AdaptiveChunkSizer> chunk_sizer;
+    // When the last read was sent.
+    std::chrono::steady_clock::time_point read_start_time;
   };
 
   /**
@@ -152,6 +175,18 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Reads the blob of the get blob stream context with up to
+   * get_blob_stream_parallelism ranged GetObject calls in flight.
+   *
+   * @param get_blob_stream_context The get blob stream context object.
+   */
+  void GetBlobStreamInParallel(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
+          get_blob_stream_context) noexcept;
+
   /**
    * @brief Is called when objects are list and returned from the S3 ListObjects
    * callback.
@@ -251,6 +286,22 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Uploads the data of the put blob stream context as parts of
+   * put_blob_stream_part_size bytes, with up to put_blob_stream_parallelism
+   * UploadPart calls in flight, then completes the upload with the parts in
+   * order.
+   *
+   * @param put_blob_stream_context The put blob stream context object.
+   * @param tracker The tracker of the created multipart upload.
+   */
+  void PutBlobStreamInParallel(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
+          put_blob_stream_context,
+      std::shared_ptr<PutBlobStreamTracker> tracker) noexcept;
+
   /**
    * @brief Is called when an UploadPart is done.
    *
@@ -367,6 +418,40 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Deletes a batch of blobs of a DeleteBlobs with a single S3
+   * DeleteObjects.
+   *
+   * @param bucket_name The bucket of the blobs.
+   * @param blob_names The names of the blobs, up to 1000 of them.
+   * @param callback Is called with the result of each blob.
+   */
+  void DeleteObjects(
+      const std::string& bucket_name,
+      const std::vector<std::string>& blob_names,
+      BatchBlobDeleter::DeleteBatchCallback callback) noexcept;
+
+  /**
+   * @brief Is called when the object is returned from the S3 DeleteObjects
+   * callback.
+   *
+   * @param blob_names The names of the blobs of the batch.
+   * @param callback Is called with the result of each blob.
+   * @param s3_client An instance of the S3 client.
+   * @param delete_objects_request The delete objects request.
+   * @param delete_objects_outcome The delete objects outcome of the async
+   * operation, which has the keys which failed to be deleted.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnDeleteObjectsCallback(
+      const std::vector<std::string>& blob_names,
+      const BatchBlobDeleter::DeleteBatchCallback& callback,
+      const Aws::S3::S3Client* s3_client,
+      const Aws::S3::Model::DeleteObjectsRequest& delete_objects_request,
+      Aws::S3::Model::DeleteObjectsOutcome delete_objects_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
   /**
    * @brief Creates the Client Config object.
    *
@@ -377,6 +462,8 @@ class AwsBlobStorageClientProvider : public BlobStorageClientProviderInterface {
   virtual std::shared_ptr<Aws::Client::ClientConfiguration>
   CreateClientConfiguration(const std::string& region) noexcept;
 
+  std::shared_ptr<BlobStorageClientOptions> options_;
+
   std::shared_ptr<InstanceClientProviderInterface> instance_client_;
 
   /// Instances of the async executor for local compute and blocking IO
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aws_blob_storage_client_streams.h"
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
+using std::ios_base;
+using std::iostream;
+using std::move;
+using std::shared_ptr;
+using std::streambuf;
+using std::streamsize;
+using std::string;
+
+namespace {
+// The position of a seek by offset from direction, within bytes of the given
+// size, or -1 if it is out of them.
+streambuf::pos_type GetSeekPosition(streambuf::off_type offset,
+                                    ios_base::seekdir direction,
+                                    streambuf::off_type current,
+                                    streambuf::off_type size) {
+  auto base = direction == ios_base::beg   ? 0
+              : direction == ios_base::cur ? current
+                                           : size;
+  auto position = base + offset;
+  if (position < 0 || position > size) {
+    return streambuf::pos_type(streambuf::off_type(-1));
+  }
+  return streambuf::pos_type(position);
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+BorrowedBytesStreamBuffer::BorrowedBytesStreamBuffer(
+    shared_ptr<const void> owner, const string& bytes)
+    : owner_(move(owner)) {
+  // The get area is never written to, as there is no put area.
+  auto* begin = const_cast<char*>(bytes.data());
+  setg(begin, begin, begin + bytes.size());
+}
+
+BorrowedBytesStreamBuffer::pos_type BorrowedBytesStreamBuffer::seekoff(
+    off_type offset, ios_base::seekdir direction, ios_base::openmode mode) {
+  if ((mode & ios_base::out) || !(mode & ios_base::in)) {
+    return pos_type(off_type(-1));
+  }
+  auto position =
+      GetSeekPosition(offset, direction, gptr() - eback(), egptr() - eback());
+  if (position != pos_type(off_type(-1))) {
+    setg(eback(), eback() + off_type(position), egptr());
+  }
+  return position;
+}
+
+BorrowedBytesStreamBuffer::pos_type BorrowedBytesStreamBuffer::seekpos(
+    pos_type position, ios_base::openmode mode) {
+  return seekoff(off_type(position), ios_base::beg, mode);
+}
+
+StringStreamBuffer::StringStreamBuffer(string bytes) : bytes_(move(bytes)) {
+  ResetGetArea(0);
+}
+
+string StringStreamBuffer::Release() noexcept {
+  auto bytes = move(bytes_);
+  bytes_ = string();
+  ResetGetArea(0);
+  return bytes;
+}
+
+void StringStreamBuffer::ResetGetArea(size_t read_position) noexcept {
+  auto* begin = bytes_.data();
+  setg(begin, begin + read_position, begin + bytes_.size());
+}
+
+streamsize StringStreamBuffer::xsputn(const char_type* bytes,
+                                      streamsize count) {
+  // Appending may move the bytes, so the get area is pointed at them again.
+  auto read_position = gptr() - eback();
+  bytes_.append(bytes, count);
+  ResetGetArea(read_position);
+  return count;
+}
+
+StringStreamBuffer::int_type StringStreamBuffer::overflow(int_type byte) {
+  if (traits_type::eq_int_type(byte, traits_type::eof())) {
+    return traits_type::not_eof(byte);
+  }
+  auto c = traits_type::to_char_type(byte);
+  xsputn(&c, 1);
+  return byte;
+}
+
+StringStreamBuffer::pos_type StringStreamBuffer::seekoff(
+    off_type offset, ios_base::seekdir direction, ios_base::openmode mode) {
+  if (mode & ios_base::in) {
+    auto position =
+        GetSeekPosition(offset, direction, gptr() - eback(), bytes_.size());
+    if (position != pos_type(off_type(-1))) {
+      ResetGetArea(off_type(position));
+    }
+    return position;
+  }
+  // Writes always append, so the write position can only be told.
+  if ((mode & ios_base::out) && offset == 0 && direction != ios_base::beg) {
+    return pos_type(off_type(bytes_.size()));
+  }
+  return pos_type(off_type(-1));
+}
+
+StringStreamBuffer::pos_type StringStreamBuffer::seekpos(
+    pos_type position, ios_base::openmode mode) {
+  return seekoff(off_type(position), ios_base::beg, mode);
+}
+
+ExecutionResultOr<string> TakeBodyBytes(iostream& body,
+                                        uint64_t content_length) noexcept {
+  if (auto* string_body =
+          dynamic_cast<BufferedIOStream<StringStreamBuffer>*>(&body);
+      string_body != nullptr) {
+    auto bytes = string_body->GetBuffer().Release();
+    if (bytes.size() != content_length) {
+      return FailureExecutionResult(
+          SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+    }
+    return bytes;
+  }
+  string bytes(content_length, '\0');
+  if (!body.read(bytes.data(), content_length)) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+  }
+  return bytes;
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief A read-only stream buffer over bytes which are owned elsewhere, so a
+ * request body can be sent to S3 without copying it into an Aws::StringStream.
+ * Seeking is supported, as the SDK seeks the body to size, sign and resend it.
+ */
+class BorrowedBytesStreamBuffer : public std::streambuf {
+ public:
+  /**
+   * @param owner keeps the bytes alive for as long as the buffer.
+   * @param bytes the bytes to read.
+   */
+  BorrowedBytesStreamBuffer(std::shared_ptr<const void> owner,
+                            const std::string& bytes);
+
+ protected:
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                   std::ios_base::openmode mode) override;
+  pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+ private:
+  const std::shared_ptr<const void> owner_;
+};
+
+/**
+ * @brief A stream buffer which appends what is written to a string, and reads
+ * it back. A GetObject response written through it can have its bytes moved
+ * into the response proto instead of being read out of an Aws::StringStream.
+ */
+class StringStreamBuffer : public std::streambuf {
+ public:
+  StringStreamBuffer() = default;
+
+  /// @param bytes the initial bytes of the buffer, which are read first.
+  explicit StringStreamBuffer(std::string bytes);
+
+  /// Moves the bytes out of the buffer, leaving it empty.
+  std::string Release() noexcept;
+
+ protected:
+  std::streamsize xsputn(const char_type* bytes,
+                         std::streamsize count) override;
+  int_type overflow(int_type byte) override;
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                   std::ios_base::openmode mode) override;
+  pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+ private:
+  /// Points the get area at bytes_, keeping the read position.
+  void ResetGetArea(size_t read_position) noexcept;
+
+  std::string bytes_;
+};
+
+/**
+ * @brief An iostream, such as the Aws::IOStream of a request or response body,
+ * which owns its stream buffer.
+ */
+template <typename StreamBuffer>
+class BufferedIOStream : public std::iostream {
+ public:
+  template <typename... Args>
+  explicit BufferedIOStream(Args&&... args)
+      : std::iostream(nullptr), buffer_(std::forward<Args>(args)...) {
+    rdbuf(&buffer_);
+  }
+
+  StreamBuffer& GetBuffer() noexcept { return buffer_; }
+
+ private:
+  StreamBuffer buffer_;
+};
+
+/**
+ * @brief Takes the content_length bytes of a response body. The bytes of a
+ * body written through a StringStreamBuffer are moved out without a copy, and
+ * any other body is read into a new string.
+ */
+core::ExecutionResultOr<std::string> TakeBodyBytes(
+    std::iostream& body, uint64_t content_length) noexcept;
+}  // namespace google::scp::cpio::client_providers
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <aws/s3/S3Client.h>
+#include <aws/s3/S3Errors.h>
 
 #include "cpio/common/src/aws/error_codes.h"
 
@@ -51,5 +52,19 @@ class AwsBlobStorageClientUtils {
             core::errors::SC_AWS_INTERNAL_SERVICE_ERROR);
     }
   }
+
+  /**
+   * @brief Converts the error code S3 returns for a key of a DeleteObjects,
+   * such as AccessDenied, to ExecutionResult.
+   *
+   * @param error_code The S3 error code.
+   * @return core::ExecutionResult The converted result of the operation.
+   */
+  static core::ExecutionResult ConvertS3ErrorCodeToExecutionResult(
+      const Aws::String& error_code) noexcept {
+    return ConvertS3ErrorToExecutionResult(static_cast<Aws::S3::S3Errors>(
+        Aws::S3::S3ErrorMapper::GetErrorForName(error_code.c_str())
+            .GetErrorType()));
+  }
 };
 }  // namespace google::scp::cpio::client_providers
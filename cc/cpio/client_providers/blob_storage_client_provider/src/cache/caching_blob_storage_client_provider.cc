@@ -0,0 +1,493 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "caching_blob_storage_client_provider.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/uuid/src/uuid.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/local/local_blob_storage_client_utils.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::BlobIdentity;
+using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::cmrt::sdk::common::v1::CloudIdentityInfo;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR;
+using std::error_code;
+using std::istream;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::nullopt;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::vector;
+using std::chrono::steady_clock;
+using std::filesystem::create_directories;
+using std::filesystem::remove_all;
+
+namespace {
+constexpr char kCachingBlobStorageClientProvider[] =
+    "CachingBlobStorageClientProvider";
+constexpr char kCacheDirectoryTemplate[] = "/blob_cache.XXXXXX";
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+CachingBlobStorageClientProvider::CachedBlob::~CachedBlob() {
+  unlink(path.c_str());
+}
+
+ExecutionResult CachingBlobStorageClientProvider::Init() noexcept {
+  if (!options_ || options_->cache_directory.empty()) {
+    auto result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR(kCachingBlobStorageClientProvider, kZeroUuid, result,
+              "The cache directory is not set.");
+    return result;
+  }
+  return provider_->Init();
+}
+
+ExecutionResult CachingBlobStorageClientProvider::Run() noexcept {
+  // Cached blobs are only indexed in memory, so every provider starts with an
+  // empty directory of its own.
+  error_code error;
+  create_directories(options_->cache_directory, error);
+  cache_directory_ = options_->cache_directory + kCacheDirectoryTemplate;
+  if (error || mkdtemp(cache_directory_.data()) == nullptr) {
+    auto result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+    SCP_ERROR(kCachingBlobStorageClientProvider, kZeroUuid, result,
+              "Failed to create a cache directory under %s.",
+              options_->cache_directory.c_str());
+    return result;
+  }
+  return provider_->Run();
+}
+
+ExecutionResult CachingBlobStorageClientProvider::Stop() noexcept {
+  auto result = provider_->Stop();
+  auto stats = GetCacheStats();
+  SCP_INFO(kCachingBlobStorageClientProvider, kZeroUuid,
+           "Blob cache hit ratio: %.3f (%llu hits, %llu revalidated, %llu "
+           "misses, %llu coalesced). Bytes saved: %llu.",
+           stats.HitRatio(), stats.hits, stats.revalidations, stats.misses,
+           stats.coalesced, stats.bytes_saved);
+  {
+    lock_guard lock(mutex_);
+    entries_.clear();
+    lru_keys_.clear();
+    cached_bytes_ = 0;
+  }
+  error_code error;
+  remove_all(cache_directory_, error);
+  return result;
+}
+
+void CachingBlobStorageClientProvider::GetBlob(
+    AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context) noexcept {
+  const auto& request = *get_blob_context.request;
+  // Only whole blobs are cached. Callers revalidating their own copy of a blob
+  // are answered by the provider.
+  if (request.has_byte_range() || request.has_if_none_match_etag()) {
+    provider_->GetBlob(get_blob_context);
+    return;
+  }
+
+  auto key =
+      GetCacheKey(request.blob_metadata(), request.cloud_identity_info());
+  bool is_fresh = false;
+  auto cached_blob = FindCachedBlob(key, is_fresh);
+  if (!cached_blob || !is_fresh) {
+    single_flight_.Execute(
+        key, get_blob_context,
+        [this, &key, &cached_blob](
+            AsyncContext<GetBlobRequest, GetBlobResponse>& context) {
+          ReadThrough(context, key, cached_blob);
+        });
+    return;
+  }
+
+  // The blob file is read off the caller's thread.
+  if (auto schedule_result = io_async_executor_->Schedule(
+          [this, get_blob_context, key, cached_blob]() mutable {
+            if (ServeCachedBlob(get_blob_context, *cached_blob,
+                                false /*is_revalidated*/)) {
+              return;
+            }
+            EraseCachedBlob(key);
+            single_flight_.Execute(
+                key, get_blob_context,
+                [this,
+                 &key](AsyncContext<GetBlobRequest, GetBlobResponse>& context) {
+                  ReadThrough(context, key, nullptr);
+                });
+          },
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    get_blob_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kCachingBlobStorageClientProvider, get_blob_context,
+                      get_blob_context.result,
+                      "Get blob request failed to be scheduled");
+    get_blob_context.Finish();
+  }
+}
+
+void CachingBlobStorageClientProvider::ReadThrough(
+    AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context,
+    const string& key, shared_ptr<CachedBlob> cached_blob) noexcept {
+  auto request = make_shared<GetBlobRequest>(*get_blob_context.request);
+  if (cached_blob) {
+    request->set_if_none_match_etag(cached_blob->etag);
+  }
+  AsyncContext<GetBlobRequest, GetBlobResponse> read_context(
+      move(request),
+      [this, get_blob_context, key, cached_blob](
+          AsyncContext<GetBlobRequest, GetBlobResponse>& read_context) mutable {
+        if (!read_context.result.Successful()) {
+          if (read_context.result ==
+              FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)) {
+            EraseCachedBlob(key);
+          }
+          get_blob_context.result = read_context.result;
+          get_blob_context.Finish();
+          return;
+        }
+
+        if (read_context.response->not_modified() && cached_blob) {
+          MarkValidated(*cached_blob);
+          // The blob file is read off the provider's callback thread.
+          if (auto schedule_result = io_async_executor_->Schedule(
+                  [this, get_blob_context, key, cached_blob]() mutable {
+                    if (ServeCachedBlob(get_blob_context, *cached_blob,
+                                        true /*is_revalidated*/)) {
+                      return;
+                    }
+                    // The blob file could not be read, so read the blob
+                    // again.
+                    EraseCachedBlob(key);
+                    ReadThrough(get_blob_context, key, nullptr);
+                  },
+                  AsyncPriority::Normal);
+              !schedule_result.Successful()) {
+            get_blob_context.result = schedule_result;
+            SCP_ERROR_CONTEXT(kCachingBlobStorageClientProvider,
+                              get_blob_context, get_blob_context.result,
+                              "Get blob request failed to be scheduled");
+            get_blob_context.Finish();
+          }
+          return;
+        }
+
+        {
+          lock_guard lock(mutex_);
+          stats_.misses++;
+        }
+        InsertCachedBlob(key, *read_context.response);
+        get_blob_context.response = move(read_context.response);
+        get_blob_context.result = SuccessExecutionResult();
+        get_blob_context.Finish();
+      },
+      get_blob_context);
+  provider_->GetBlob(read_context);
+}
+
+bool CachingBlobStorageClientProvider::ServeCachedBlob(
+    AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context,
+    const CachedBlob& cached_blob, bool is_revalidated) noexcept {
+  auto range_or = MappedBlobRange::Map(cached_blob.path, 0, nullopt);
+  if (!range_or.Successful() || (*range_or)->size() != cached_blob.size) {
+    return false;
+  }
+  // A blob file damaged on disk is read again from the provider.
+  if (get_blob_context.request->checksum_algorithm() !=
+          CHECKSUM_ALGORITHM_NONE &&
+      BlobChecksum::ExtendCrc32c(
+          0, string_view((*range_or)->data(), (*range_or)->size())) !=
+          cached_blob.crc32c) {
+    SCP_ERROR(kCachingBlobStorageClientProvider, kZeroUuid,
+              FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR),
+              "The cached blob file %s does not match its checksum.",
+              cached_blob.path.c_str());
+    return false;
+  }
+  {
+    lock_guard lock(mutex_);
+    stats_.hits++;
+    if (is_revalidated) {
+      stats_.revalidations++;
+    }
+    stats_.bytes_saved += cached_blob.size;
+  }
+  get_blob_context.response = make_shared<GetBlobResponse>();
+  get_blob_context.response->mutable_blob()->mutable_metadata()->CopyFrom(
+      get_blob_context.request->blob_metadata());
+  get_blob_context.response->mutable_blob()->mutable_data()->assign(
+      (*range_or)->data(), (*range_or)->size());
+  get_blob_context.response->set_etag(cached_blob.etag);
+  get_blob_context.result = SuccessExecutionResult();
+  get_blob_context.Finish();
+  return true;
+}
+
+string CachingBlobStorageClientProvider::GetCacheKey(
+    const BlobMetadata& blob_metadata,
+    const CloudIdentityInfo& cloud_identity_info) noexcept {
+  // Length-prefixed, so that no two blobs have the same key.
+  return absl::StrCat(blob_metadata.bucket_name().size(), ":",
+                      blob_metadata.bucket_name(),
+                      blob_metadata.blob_name().size(), ":",
+                      blob_metadata.blob_name(),
+                      cloud_identity_info.SerializeAsString());
+}
+
+shared_ptr<CachingBlobStorageClientProvider::CachedBlob>
+CachingBlobStorageClientProvider::FindCachedBlob(const string& key,
+                                                 bool& is_fresh) noexcept {
+  lock_guard lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  // Splicing keeps the stored position valid.
+  lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_position);
+  auto& cached_blob = it->second.cached_blob;
+  is_fresh = steady_clock::now() - cached_blob->validate_time <
+             options_->cache_revalidation_interval;
+  return cached_blob;
+}
+
+void CachingBlobStorageClientProvider::MarkValidated(
+    CachedBlob& cached_blob) noexcept {
+  lock_guard lock(mutex_);
+  cached_blob.validate_time = steady_clock::now();
+}
+
+void CachingBlobStorageClientProvider::InsertCachedBlob(
+    const string& key, const GetBlobResponse& response) noexcept {
+  const auto& data = response.blob().data();
+  // Blobs without an etag could never be revalidated.
+  if (response.etag().empty() || data.size() > options_->cache_size_bytes) {
+    return;
+  }
+
+  auto writer_or = BlobFileWriter::Create(cache_directory_);
+  auto path = absl::StrCat(cache_directory_, "/", next_file_id_++);
+  if (!writer_or.Successful() || !(*writer_or)->Append(data).Successful() ||
+      !(*writer_or)->Commit(path).Successful()) {
+    SCP_ERROR(kCachingBlobStorageClientProvider, kZeroUuid,
+              FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR),
+              "Failed to write the cached blob file %s.", path.c_str());
+    return;
+  }
+  auto cached_blob = make_shared<CachedBlob>();
+  cached_blob->path = move(path);
+  cached_blob->etag = response.etag();
+  cached_blob->size = data.size();
+  cached_blob->crc32c = BlobChecksum::ExtendCrc32c(0, data);
+
+  // The evicted blob files are removed once their last readers are done.
+  lock_guard lock(mutex_);
+  cached_blob->validate_time = steady_clock::now();
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    cached_bytes_ -= it->second.cached_blob->size;
+    lru_keys_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+  while (!lru_keys_.empty() &&
+         cached_bytes_ + cached_blob->size > options_->cache_size_bytes) {
+    auto it = entries_.find(lru_keys_.back());
+    cached_bytes_ -= it->second.cached_blob->size;
+    entries_.erase(it);
+    lru_keys_.pop_back();
+  }
+  lru_keys_.push_front(key);
+  cached_bytes_ += cached_blob->size;
+  entries_[key] = CacheEntry{move(cached_blob), lru_keys_.begin()};
+}
+
+void CachingBlobStorageClientProvider::EraseCachedBlob(
+    const string& key) noexcept {
+  lock_guard lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  cached_bytes_ -= it->second.cached_blob->size;
+  lru_keys_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+CachingBlobStorageClientProvider::CacheStats
+CachingBlobStorageClientProvider::GetCacheStats() noexcept {
+  lock_guard lock(mutex_);
+  auto stats = stats_;
+  stats.coalesced = single_flight_.GetCoalescedCount();
+  return stats;
+}
+
+void CachingBlobStorageClientProvider::GetBlobStream(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
+        get_blob_stream_context) noexcept {
+  provider_->GetBlobStream(get_blob_stream_context);
+}
+
+void CachingBlobStorageClientProvider::ListBlobsMetadata(
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+        list_blobs_context) noexcept {
+  provider_->ListBlobsMetadata(list_blobs_context);
+}
+
+void CachingBlobStorageClientProvider::ListAllBlobsMetadata(
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>&
+        list_all_blobs_context) noexcept {
+  provider_->ListAllBlobsMetadata(list_all_blobs_context);
+}
+
+void CachingBlobStorageClientProvider::PutBlob(
+    AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) noexcept {
+  const auto& request = *put_blob_context.request;
+  auto key = GetCacheKey(request.blob().metadata(),
+                         request.cloud_identity_info());
+  EraseCachedBlob(key);
+  // Reads which were in flight during the write may have cached the old blob
+  // again.
+  auto forward_context = put_blob_context;
+  forward_context.callback =
+      [this, key, callback = put_blob_context.callback](
+          AsyncContext<PutBlobRequest, PutBlobResponse>& context) {
+        EraseCachedBlob(key);
+        callback(context);
+      };
+  provider_->PutBlob(forward_context);
+}
+
+void CachingBlobStorageClientProvider::PutBlobStream(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
+        put_blob_stream_context) noexcept {
+  const auto& request = *put_blob_stream_context.request;
+  auto key = GetCacheKey(request.blob_portion().metadata(),
+                         request.cloud_identity_info());
+  EraseCachedBlob(key);
+  // Reads which were in flight during the write may have cached the old blob
+  // again.
+  auto forward_context = put_blob_stream_context;
+  forward_context.callback =
+      [this, key, callback = put_blob_stream_context.callback](
+          AsyncContext<PutBlobStreamRequest, PutBlobStreamResponse>& context) {
+        EraseCachedBlob(key);
+        callback(context);
+      };
+  provider_->PutBlobStream(forward_context);
+}
+
+void CachingBlobStorageClientProvider::DeleteBlob(
+    AsyncContext<DeleteBlobRequest, DeleteBlobResponse>&
+        delete_blob_context) noexcept {
+  const auto& request = *delete_blob_context.request;
+  auto key =
+      GetCacheKey(request.blob_metadata(), request.cloud_identity_info());
+  EraseCachedBlob(key);
+  auto forward_context = delete_blob_context;
+  forward_context.callback =
+      [this, key, callback = delete_blob_context.callback](
+          AsyncContext<DeleteBlobRequest, DeleteBlobResponse>& context) {
+        EraseCachedBlob(key);
+        callback(context);
+      };
+  provider_->DeleteBlob(forward_context);
+}
+
+void CachingBlobStorageClientProvider::DeleteBlobs(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+        delete_blobs_context) noexcept {
+  const auto& request = *delete_blobs_context.request;
+  vector<string> keys;
+  for (const auto& blob_metadata : request.blob_metadatas()) {
+    keys.push_back(GetCacheKey(blob_metadata, request.cloud_identity_info()));
+    EraseCachedBlob(keys.back());
+  }
+  auto forward_context = delete_blobs_context;
+  forward_context.callback =
+      [this, keys = move(keys), callback = delete_blobs_context.callback](
+          AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>& context) {
+        for (const auto& key : keys) {
+          EraseCachedBlob(key);
+        }
+        callback(context);
+      };
+  provider_->DeleteBlobs(forward_context);
+}
+
+ExecutionResultOr<unique_ptr<istream>>
+CachingBlobStorageClientProvider::GetBlobStreamSync(
+    const BlobIdentity& blob_identity) noexcept {
+  return provider_->GetBlobStreamSync(blob_identity);
+}
+
+ExecutionResultOr<unique_ptr<ostream>>
+CachingBlobStorageClientProvider::PutBlobStreamSync(
+    const BlobIdentity& blob_identity) noexcept {
+  EraseCachedBlob(GetCacheKey(blob_identity.blob_metadata(),
+                              blob_identity.cloud_identity_info()));
+  return provider_->PutBlobStreamSync(blob_identity);
+}
+}  // namespace google::scp::cpio::client_providers
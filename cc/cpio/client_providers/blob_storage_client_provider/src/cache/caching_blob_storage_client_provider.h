@@ -0,0 +1,242 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "core/common/single_flight/src/single_flight.h"
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/streaming_context.h"
+#include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
+#include "public/cpio/interface/blob_storage_client/type_def.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @copydoc BlobStorageClientProviderInterface
+ *
+ * Wraps another provider and caches the whole blobs read with GetBlob as files
+ * under BlobStorageClientOptions::cache_directory. A cached blob is
+ * revalidated with a GetBlob for its etag, which only downloads the blob again
+ * if it changed, and concurrent reads of a blob which is not cached share one
+ * GetBlob. The least recently used blobs are evicted once the cached blobs are
+ * larger than BlobStorageClientOptions::cache_size_bytes.
+ *
+ * Ranged and streamed reads are not cached. Writes and deletes through this
+ * provider drop the cached blob.
+ */
+class CachingBlobStorageClientProvider
+    : public BlobStorageClientProviderInterface {
+ public:
+  /// Counters since construction.
+  struct CacheStats {
+    /// GetBlobs served from the cache without reading the blob.
+    uint64_t hits = 0;
+    /// Hits which revalidated the cached blob first.
+    uint64_t revalidations = 0;
+    /// GetBlobs which downloaded the blob.
+    uint64_t misses = 0;
+    /// Misses which joined a GetBlob of the same blob already in flight.
+    uint64_t coalesced = 0;
+    /// The bytes of the blobs served from the cache.
+    uint64_t bytes_saved = 0;
+
+    double HitRatio() const {
+      return hits + misses == 0 ? 0 : static_cast<double>(hits) /
+                                          static_cast<double>(hits + misses);
+    }
+  };
+
+  CachingBlobStorageClientProvider(
+      std::shared_ptr<BlobStorageClientOptions> options,
+      std::shared_ptr<BlobStorageClientProviderInterface> provider,
+      const std::shared_ptr<core::AsyncExecutorInterface>& io_async_executor)
+      : options_(options),
+        provider_(provider),
+        io_async_executor_(io_async_executor) {}
+
+  core::ExecutionResult Init() noexcept override;
+  core::ExecutionResult Run() noexcept override;
+  core::ExecutionResult Stop() noexcept override;
+
+  void GetBlob(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::GetBlobResponse>&
+          get_blob_context) noexcept override;
+
+  void GetBlobStream(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
+          get_blob_stream_context) noexcept override;
+
+  void ListBlobsMetadata(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
+          list_blobs_context) noexcept override;
+
+  void ListAllBlobsMetadata(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>&
+          list_all_blobs_context) noexcept override;
+
+  void PutBlob(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::PutBlobResponse>&
+          put_blob_context) noexcept override;
+
+  void PutBlobStream(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
+          put_blob_stream_context) noexcept override;
+
+  void DeleteBlob(core::AsyncContext<
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest,
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&
+                      delete_blob_context) noexcept override;
+
+  void DeleteBlobs(core::AsyncContext<
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+                       delete_blobs_context) noexcept override;
+
+  core::ExecutionResultOr<std::unique_ptr<std::istream>> GetBlobStreamSync(
+      const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
+          blob_identity) noexcept override;
+
+  core::ExecutionResultOr<std::unique_ptr<std::ostream>> PutBlobStreamSync(
+      const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
+          blob_identity) noexcept override;
+
+  /// Gets the stats of the cache since construction.
+  CacheStats GetCacheStats() noexcept;
+
+ private:
+  /// A cached blob file. Removes the file on destruction, so it stays
+  /// readable while any reader still holds the entry.
+  struct CachedBlob {
+    ~CachedBlob();
+
+    std::string path;
+    std::string etag;
+    uint64_t size = 0;
+    /// The CRC32C of the blob data, checked before the blob file is served.
+    uint32_t crc32c = 0;
+    /// When the blob was last known to be current. Guarded by mutex_.
+    std::chrono::steady_clock::time_point validate_time;
+  };
+
+  /**
+   * @brief Gets the key of the cached blob of a request. Blobs are cached per
+   * identity, so that a blob is only served to callers allowed to read it.
+   */
+  static std::string GetCacheKey(
+      const cmrt::sdk::blob_storage_service::v1::BlobMetadata& blob_metadata,
+      const cmrt::sdk::common::v1::CloudIdentityInfo&
+          cloud_identity_info) noexcept;
+
+  /**
+   * @brief Gets the cached blob of the key, marking it as recently used.
+   *
+   * @param key The key of the cached blob.
+   * @param is_fresh Set to whether the blob can be served without being
+   * revalidated.
+   */
+  std::shared_ptr<CachedBlob> FindCachedBlob(const std::string& key,
+                                             bool& is_fresh) noexcept;
+
+  /// Marks the cached blob as current as of now.
+  void MarkValidated(CachedBlob& cached_blob) noexcept;
+
+  /// Caches the blob of the response under the key, evicting the least
+  /// recently used blobs to make room for it.
+  void InsertCachedBlob(
+      const std::string& key,
+      const cmrt::sdk::blob_storage_service::v1::GetBlobResponse&
+          response) noexcept;
+
+  /// Drops the cached blob of the key, if any.
+  void EraseCachedBlob(const std::string& key) noexcept;
+
+  /**
+   * @brief Finishes the context with the data of the cached blob, unless the
+   * blob file cannot be read or does not match its checksum.
+   *
+   * @param get_blob_context The get blob context object.
+   * @param cached_blob The cached blob to serve.
+   * @param is_revalidated Whether the cached blob was just revalidated.
+   * @return Whether the cached blob could be read.
+   */
+  bool ServeCachedBlob(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::GetBlobResponse>&
+          get_blob_context,
+      const CachedBlob& cached_blob, bool is_revalidated) noexcept;
+
+  /**
+   * @brief Reads the blob through the wrapped provider, conditionally if it is
+   * cached, and caches the blob it returns.
+   *
+   * @param get_blob_context The get blob context of the leading caller.
+   * @param key The key of the cached blob.
+   * @param cached_blob The cached blob to revalidate, if any.
+   */
+  void ReadThrough(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::GetBlobResponse>&
+          get_blob_context,
+      const std::string& key,
+      std::shared_ptr<CachedBlob> cached_blob) noexcept;
+
+  std::shared_ptr<BlobStorageClientOptions> options_;
+  std::shared_ptr<BlobStorageClientProviderInterface> provider_;
+  const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_;
+
+  /// The directory of the cached blob files of this provider, under the cache
+  /// directory.
+  std::string cache_directory_;
+  /// Used to name the cached blob files.
+  std::atomic<uint64_t> next_file_id_ = 0;
+
+  std::mutex mutex_;
+  /// The keys of the cached blobs, most recently used first.
+  std::list<std::string> lru_keys_;
+  struct CacheEntry {
+    std::shared_ptr<CachedBlob> cached_blob;
+    std::list<std::string>::iterator lru_position;
+  };
+  absl::flat_hash_map<std::string, CacheEntry> entries_;
+  /// The total size of the cached blobs.
+  uint64_t cached_bytes_ = 0;
+  CacheStats stats_;
+
+  core::common::SingleFlight<
+      cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+      cmrt::sdk::blob_storage_service::v1::GetBlobResponse>
+      single_flight_;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "adaptive_chunk_sizer.h"
+
+#include <algorithm>
+
+using std::chrono::duration;
+using std::chrono::nanoseconds;
+
+namespace {
+// A read of twice the size takes the round trip plus twice the transfer time,
+// so doubling raises the throughput by less than this once the transfer takes
+// about twice the round trip.
+constexpr double kMinThroughputGain = 1.2;
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+AdaptiveChunkSizer::AdaptiveChunkSizer(uint64_t initial_chunk_size,
+                                       uint64_t max_chunk_size) noexcept
+    : chunk_size_(std::max<uint64_t>(
+          1, std::min(initial_chunk_size, max_chunk_size))),
+      max_chunk_size_(std::max<uint64_t>(1, max_chunk_size)) {}
+
+void AdaptiveChunkSizer::RecordRead(uint64_t bytes_read, nanoseconds read_time,
+                                    size_t outstanding_responses) noexcept {
+  // Short reads at the end of the blob say nothing of the throughput.
+  if (chunk_size_ >= max_chunk_size_ || bytes_read < chunk_size_ ||
+      read_time <= nanoseconds::zero() || outstanding_responses > 0) {
+    return;
+  }
+  auto throughput = bytes_read / duration<double>(read_time).count();
+  if (throughput < previous_throughput_ * kMinThroughputGain) {
+    return;
+  }
+  previous_throughput_ = throughput;
+  chunk_size_ = std::min(chunk_size_ * 2, max_chunk_size_);
+}
+}  // namespace google::scp::cpio::client_providers
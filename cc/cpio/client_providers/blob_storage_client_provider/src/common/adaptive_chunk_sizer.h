@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Picks the size of each read of a GetBlobStream. The first read is
+ * small, so that the first bytes come back soon, and the size then doubles
+ * toward a cap after each read.
+ *
+ * The size stops doubling while the last doubling raised the throughput of the
+ * reads by less than a fifth, as the reads then take long enough for their
+ * round trips not to matter, or while the consumer has not taken the earlier
+ * responses yet, as larger reads then only buffer more.
+ */
+class AdaptiveChunkSizer {
+ public:
+  /**
+   * @brief Construct a new sizer.
+   *
+   * @param initial_chunk_size the size of the first read.
+   * @param max_chunk_size the cap of the size.
+   */
+  AdaptiveChunkSizer(uint64_t initial_chunk_size,
+                     uint64_t max_chunk_size) noexcept;
+
+  /// The size of the next read.
+  uint64_t GetChunkSize() const noexcept { return chunk_size_; }
+
+  /**
+   * @brief Records a read of the current size, and picks the size of the next
+   * one.
+   *
+   * @param bytes_read the bytes read, which are fewer at the end of the blob.
+   * @param read_time how long the read took.
+   * @param outstanding_responses how many responses the consumer has not taken
+   * yet.
+   */
+  void RecordRead(uint64_t bytes_read, std::chrono::nanoseconds read_time,
+                  size_t outstanding_responses) noexcept;
+
+ private:
+  uint64_t chunk_size_;
+  const uint64_t max_chunk_size_;
+  /// The throughput of the last read before the last doubling, in bytes per
+  /// second. 0 before the first doubling.
+  double previous_throughput_ = 0;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "batch_blob_deleter.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::FinishContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_UNRETRIABLE_ERROR;
+using std::lock_guard;
+using std::make_shared;
+using std::map;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::cpio::client_providers {
+BatchBlobDeleter::BatchBlobDeleter(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> context,
+    DeleteBatchFunction delete_batch, size_t batch_size, size_t parallelism,
+    shared_ptr<AsyncExecutorInterface> cpu_async_executor)
+    : context_(move(context)),
+      delete_batch_(move(delete_batch)),
+      batch_size_(std::max<size_t>(1, batch_size)),
+      parallelism_(std::max<size_t>(1, parallelism)),
+      cpu_async_executor_(move(cpu_async_executor)) {}
+
+void BatchBlobDeleter::Start() noexcept {
+  const auto& request = *context_.request;
+  auto response = make_shared<DeleteBlobsResponse>();
+  for (const auto& blob_metadata : request.blob_metadatas()) {
+    if (blob_metadata.bucket_name().empty() ||
+        blob_metadata.blob_name().empty()) {
+      context_.result =
+          FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+      context_.Finish();
+      return;
+    }
+    *response->add_blob_results()->mutable_blob_metadata() = blob_metadata;
+  }
+  context_.response = move(response);
+  batches_ = GetBatches();
+  if (batches_.empty()) {
+    FinishContext(SuccessExecutionResult(), context_, cpu_async_executor_);
+    return;
+  }
+
+  batches_left_ = batches_.size();
+  for (size_t i = 0; i < std::min(parallelism_, batches_.size()); ++i) {
+    DeleteNextBatch();
+  }
+}
+
+vector<BatchBlobDeleter::Batch> BatchBlobDeleter::GetBatches()
+    const noexcept {
+  vector<Batch> batches;
+  // The index of the batch being filled for each bucket.
+  map<string, size_t> open_batch_indexes;
+  const auto& blob_metadatas = context_.request->blob_metadatas();
+  for (int i = 0; i < blob_metadatas.size(); ++i) {
+    const auto& bucket_name = blob_metadatas[i].bucket_name();
+    auto it = open_batch_indexes.find(bucket_name);
+    if (it == open_batch_indexes.end() ||
+        batches[it->second].blob_names.size() >= batch_size_) {
+      batches.push_back(Batch{bucket_name, {}, {}});
+      it = open_batch_indexes.insert_or_assign(bucket_name, batches.size() - 1)
+               .first;
+    }
+    batches[it->second].blob_names.push_back(blob_metadatas[i].blob_name());
+    batches[it->second].indexes.push_back(i);
+  }
+  return batches;
+}
+
+void BatchBlobDeleter::DeleteNextBatch() noexcept {
+  size_t batch_index;
+  {
+    lock_guard lock(mutex_);
+    if (next_batch_index_ >= batches_.size()) {
+      return;
+    }
+    batch_index = next_batch_index_++;
+  }
+  const auto& batch = batches_[batch_index];
+  delete_batch_(batch.bucket_name, batch.blob_names,
+                [self = shared_from_this(),
+                 batch_index](vector<ExecutionResult> results) {
+                  self->OnBatchDeleted(batch_index, move(results));
+                });
+}
+
+void BatchBlobDeleter::OnBatchDeleted(
+    size_t batch_index, vector<ExecutionResult> results) noexcept {
+  const auto& batch = batches_[batch_index];
+  bool is_done;
+  {
+    lock_guard lock(mutex_);
+    for (size_t i = 0; i < batch.indexes.size(); ++i) {
+      auto result =
+          i < results.size()
+              ? results[i]
+              : FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_UNRETRIABLE_ERROR);
+      *context_.response->mutable_blob_results(batch.indexes[i])
+           ->mutable_result() = result.ToProto();
+    }
+    is_done = --batches_left_ == 0;
+  }
+
+  // The batches may call back on this thread, so they are deleted outside the
+  // lock.
+  if (is_done) {
+    FinishContext(SuccessExecutionResult(), context_, cpu_async_executor_);
+  } else {
+    DeleteNextBatch();
+  }
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Serves a DeleteBlobs by grouping the blobs by bucket into batches of
+ * up to batch_size, and deleting up to parallelism batches at once.
+ *
+ * The context is successful once every batch is done, with the result of each
+ * blob in the response, in the order of the request. A batch which fails as a
+ * whole fails each of its blobs.
+ */
+class BatchBlobDeleter
+    : public std::enable_shared_from_this<BatchBlobDeleter> {
+ public:
+  /// Is called with the result of each blob of a batch, in order.
+  using DeleteBatchCallback =
+      std::function<void(std::vector<core::ExecutionResult>)>;
+
+  /**
+   * @brief Deletes a batch of blobs of one bucket and calls back with their
+   * results. The callback may be called on any thread, including the calling
+   * one.
+   */
+  using DeleteBatchFunction = std::function<void(
+      const std::string& bucket_name,
+      const std::vector<std::string>& blob_names,
+      DeleteBatchCallback callback)>;
+
+  /**
+   * @brief Construct a new deleter. Nothing is deleted until Start().
+   *
+   * @param context the context of the DeleteBlobs.
+   * @param delete_batch deletes a batch of blobs.
+   * @param batch_size the max number of blobs in a batch.
+   * @param parallelism the max number of batches in flight.
+   * @param cpu_async_executor the executor to finish the context on.
+   */
+  BatchBlobDeleter(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>
+          context,
+      DeleteBatchFunction delete_batch, size_t batch_size, size_t parallelism,
+      std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor);
+
+  /// Starts deleting the first batches, or fails the context if a blob is
+  /// missing its bucket or name.
+  void Start() noexcept;
+
+ private:
+  /// Blobs of one bucket, and their indexes in the request.
+  struct Batch {
+    std::string bucket_name;
+    std::vector<std::string> blob_names;
+    std::vector<int> indexes;
+  };
+
+  /// Groups the blobs of the request by bucket, in the order the buckets come
+  /// in, and splits each group into batches.
+  std::vector<Batch> GetBatches() const noexcept;
+
+  /// Deletes the next batch, if any is left.
+  void DeleteNextBatch() noexcept;
+
+  /// Sets the results of the batch, and deletes the next one or finishes the
+  /// context.
+  void OnBatchDeleted(size_t batch_index,
+                      std::vector<core::ExecutionResult> results) noexcept;
+
+  core::AsyncContext<cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                     cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>
+      context_;
+  const DeleteBatchFunction delete_batch_;
+  const size_t batch_size_;
+  const size_t parallelism_;
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+  std::vector<Batch> batches_;
+
+  std::mutex mutex_;
+  size_t next_batch_index_ = 0;
+  size_t batches_left_ = 0;
+};
+}  // namespace google::scp::cpio::client_providers
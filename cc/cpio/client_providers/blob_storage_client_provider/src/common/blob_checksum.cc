@@ -0,0 +1,213 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "blob_checksum.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+using google::cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm;
+using google::cmrt::sdk::blob_storage_service::v1::
+    CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::
+    CHECKSUM_ALGORITHM_UNSPECIFIED;
+using std::array;
+using std::string;
+using std::string_view;
+
+namespace {
+// The CRC32C polynomial, with its bits reversed as the CRC is computed
+// least significant bit first.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// Gets the 8 bytes at data in little-endian order.
+uint64_t LoadWord(const uint8_t* data) noexcept {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+// Tables to extend a CRC by 8 bytes at once. Entry i of table k is the CRC of
+// the byte i followed by k zero bytes.
+using Crc32cTables = array<array<uint32_t, 256>, 8>;
+
+const Crc32cTables& GetCrc32cTables() noexcept {
+  static const Crc32cTables tables = [] {
+    Crc32cTables tables;
+    for (uint32_t i = 0; i < 256; ++i) {
+      auto crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >> 1) ^ (crc & 1 ? kCrc32cPolynomial : 0);
+      }
+      tables[0][i] = crc;
+    }
+    for (size_t k = 1; k < tables.size(); ++k) {
+      for (uint32_t i = 0; i < 256; ++i) {
+        auto previous = tables[k - 1][i];
+        tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+      }
+    }
+    return tables;
+  }();
+  return tables;
+}
+
+// Extends the CRC register, which is the CRC without its final inversion.
+uint32_t ExtendCrc32cSoftware(uint32_t crc, const uint8_t* data,
+                              size_t size) noexcept {
+  const auto& tables = GetCrc32cTables();
+  for (; size >= 8; data += 8, size -= 8) {
+    auto word = LoadWord(data) ^ crc;
+    crc = tables[7][word & 0xff] ^ tables[6][(word >> 8) & 0xff] ^
+          tables[5][(word >> 16) & 0xff] ^ tables[4][(word >> 24) & 0xff] ^
+          tables[3][(word >> 32) & 0xff] ^ tables[2][(word >> 40) & 0xff] ^
+          tables[1][(word >> 48) & 0xff] ^ tables[0][word >> 56];
+  }
+  for (; size > 0; ++data, --size) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xff];
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+// The bytes each of the three interleaved streams takes per round. Combining
+// the streams after each round costs a few hundred cycles.
+constexpr size_t kCrc32cStreamSize = 8 << 10;
+
+// Multiplies two polynomials with reversed bits modulo the CRC32C polynomial.
+uint32_t MultiplyModulo(uint32_t a, uint32_t b) noexcept {
+  uint32_t product = 0;
+  for (uint32_t bit = 1u << 31; bit != 0; bit >>= 1) {
+    if (a & bit) {
+      product ^= b;
+    }
+    b = (b >> 1) ^ (b & 1 ? kCrc32cPolynomial : 0);
+  }
+  return product;
+}
+
+// Gets x^(8 * size) modulo the CRC32C polynomial. Multiplying a CRC register
+// by it extends the register by size zero bytes.
+uint32_t GetZerosOperator(size_t size) noexcept {
+  // x^0 and x^8, with reversed bits.
+  uint32_t result = 1u << 31;
+  uint32_t power = 1u << 23;
+  for (; size > 0; size >>= 1) {
+    if (size & 1) {
+      result = MultiplyModulo(result, power);
+    }
+    power = MultiplyModulo(power, power);
+  }
+  return result;
+}
+
+// The crc32 instruction takes 3 cycles but can start every cycle, so three
+// independent streams keep it busy. As the register is linear in both the
+// register and the data, the CRC of the second and third streams are
+// computed from a zero register and added in after extending the CRCs before
+// them past their bytes.
+__attribute__((target("sse4.2"))) uint32_t ExtendCrc32cHardware(
+    uint32_t crc, const uint8_t* data, size_t size) noexcept {
+  static const uint32_t stream_operator = GetZerosOperator(kCrc32cStreamSize);
+  for (; size >= 3 * kCrc32cStreamSize;
+       data += 3 * kCrc32cStreamSize, size -= 3 * kCrc32cStreamSize) {
+    uint64_t crc0 = crc;
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    for (size_t i = 0; i < kCrc32cStreamSize; i += 8) {
+      crc0 = _mm_crc32_u64(crc0, LoadWord(data + i));
+      crc1 = _mm_crc32_u64(crc1, LoadWord(data + kCrc32cStreamSize + i));
+      crc2 = _mm_crc32_u64(crc2, LoadWord(data + 2 * kCrc32cStreamSize + i));
+    }
+    crc = MultiplyModulo(static_cast<uint32_t>(crc0), stream_operator) ^
+          static_cast<uint32_t>(crc1);
+    crc = MultiplyModulo(crc, stream_operator) ^ static_cast<uint32_t>(crc2);
+  }
+  uint64_t crc64 = crc;
+  for (; size >= 8; data += 8, size -= 8) {
+    crc64 = _mm_crc32_u64(crc64, LoadWord(data));
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; ++data, --size) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+#endif
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+BlobChecksum::BlobChecksum(ChecksumAlgorithm algorithm) noexcept
+    : algorithm_(ResolveAlgorithm(algorithm)) {
+  MD5_Init(&md5_);
+}
+
+ChecksumAlgorithm BlobChecksum::ResolveAlgorithm(
+    ChecksumAlgorithm algorithm) noexcept {
+  return algorithm == CHECKSUM_ALGORITHM_UNSPECIFIED ? CHECKSUM_ALGORITHM_MD5
+                                                     : algorithm;
+}
+
+void BlobChecksum::Update(string_view data) noexcept {
+  if (algorithm_ == CHECKSUM_ALGORITHM_MD5) {
+    MD5_Update(&md5_, data.data(), data.size());
+  } else if (algorithm_ == CHECKSUM_ALGORITHM_CRC32C) {
+    crc32c_ = ExtendCrc32c(crc32c_, data);
+  }
+}
+
+string BlobChecksum::Finish() noexcept {
+  string digest;
+  if (algorithm_ == CHECKSUM_ALGORITHM_MD5) {
+    digest.resize(MD5_DIGEST_LENGTH);
+    MD5_Final(reinterpret_cast<uint8_t*>(digest.data()), &md5_);
+    MD5_Init(&md5_);
+  } else if (algorithm_ == CHECKSUM_ALGORITHM_CRC32C) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      digest.push_back(static_cast<char>(crc32c_ >> shift));
+    }
+    crc32c_ = 0;
+  }
+  return digest;
+}
+
+uint32_t BlobChecksum::ExtendCrc32c(uint32_t crc, string_view data) noexcept {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+#if defined(__x86_64__)
+  if (IsCrc32cAccelerated()) {
+    return ~ExtendCrc32cHardware(~crc, bytes, data.size());
+  }
+#endif
+  return ~ExtendCrc32cSoftware(~crc, bytes, data.size());
+}
+
+bool BlobChecksum::IsCrc32cAccelerated() noexcept {
+#if defined(__x86_64__)
+  static const bool is_accelerated = __builtin_cpu_supports("sse4.2");
+  return is_accelerated;
+#else
+  return false;
+#endif
+}
+}  // namespace google::scp::cpio::client_providers
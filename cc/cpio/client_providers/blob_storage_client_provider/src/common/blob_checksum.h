@@ -0,0 +1,80 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/md5.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Computes the checksum of blob data incrementally, as the data is
+ * handed over in pieces, so that no separate pass over the data is needed.
+ *
+ * CRC32C uses the SSE4.2 crc32 instruction on three interleaved streams where
+ * the CPU has it, and a table otherwise. MD5 uses BoringSSL.
+ */
+class BlobChecksum {
+ public:
+  /**
+   * @brief Construct a new checksum of no data.
+   *
+   * @param algorithm the algorithm, of which unspecified means MD5.
+   */
+  explicit BlobChecksum(
+      cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm
+          algorithm) noexcept;
+
+  /// Gets the algorithm used for the requested one, of which unspecified
+  /// means MD5.
+  static cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm
+  ResolveAlgorithm(cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm
+                       algorithm) noexcept;
+
+  /// The algorithm, which is never unspecified.
+  cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm GetAlgorithm()
+      const noexcept {
+    return algorithm_;
+  }
+
+  /// Adds the data to the checksum.
+  void Update(std::string_view data) noexcept;
+
+  /**
+   * @brief Gets the binary digest of the data added since the last call, and
+   * starts over with no data. The digest of CRC32C is its 4 bytes in big-endian
+   * order, as the storage services expect, and that of none is empty.
+   */
+  std::string Finish() noexcept;
+
+  /// Extends the CRC32C of some data with the data which follows it. The CRC32C
+  /// of no data is 0.
+  static uint32_t ExtendCrc32c(uint32_t crc, std::string_view data) noexcept;
+
+  /// Whether CRC32C is computed in hardware on this CPU.
+  static bool IsCrc32cAccelerated() noexcept;
+
+ private:
+  cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm algorithm_;
+  MD5_CTX md5_;
+  uint32_t crc32c_ = 0;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -73,6 +73,11 @@ DEFINE_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_ERROR_INVALID_PUT_BLOB_STREAM,
                   "Invalid input stream data.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR,
+                  SC_BLOB_STORAGE_PROVIDER, 0x000C,
+                  "Reading or writing a local blob file failed.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 MAP_TO_PUBLIC_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND,
                          SC_CPIO_ENTITY_NOT_FOUND)
 MAP_TO_PUBLIC_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB,
@@ -96,4 +101,6 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_ERROR_INVALID_PUT_BLOB_STREAM,
                          SC_CPIO_INTERNAL_ERROR)
 MAP_TO_PUBLIC_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_ERROR_INVALID_GET_BLOB_STREAM,
                          SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR,
+                         SC_CPIO_INTERNAL_ERROR)
 }  // namespace google::scp::core::errors
@@ -0,0 +1,362 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_blob_lister.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using std::lock_guard;
+using std::make_shared;
+using std::max;
+using std::move;
+using std::nullopt;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+constexpr uint64_t kListBlobsMetadataMaxResults = 1000;
+// Split names are made of ASCII bytes, which sort below the rest of UTF-8.
+constexpr unsigned kSplitBase = 128;
+// Stands for the end of the names with the prefix when splitting the last
+// range, which has no upper bound.
+constexpr char kPrefixEnd[] = "\x7f";
+
+// The digits of a name as a base-128 fraction.
+using Digits = vector<unsigned>;
+
+// Gets the first length digits of the name, clamped to the base.
+Digits ToDigits(const string& name, size_t length) noexcept {
+  Digits digits(length, 0);
+  for (size_t i = 0; i < std::min(length, name.size()); ++i) {
+    digits[i] = std::min<unsigned>(static_cast<unsigned char>(name[i]),
+                                   kSplitBase - 1);
+  }
+  return digits;
+}
+
+// Gets the shortest name with the digits. Trailing zero digits do not change
+// the fraction.
+string ToName(const Digits& digits) noexcept {
+  string name(digits.begin(), digits.end());
+  name.erase(name.find_last_not_of('\0') + 1);
+  return name;
+}
+
+// Adds the addend to the digits. Returns false if the sum overflows.
+bool AddDigits(Digits& digits, const Digits& addend) noexcept {
+  unsigned carry = 0;
+  for (size_t i = digits.size(); i-- > 0;) {
+    auto digit = digits[i] + addend[i] + carry;
+    digits[i] = digit % kSplitBase;
+    carry = digit / kSplitBase;
+  }
+  return carry == 0;
+}
+
+// Divides the digits by the divisor, rounding down.
+void DivideDigits(Digits& digits, uint64_t divisor) noexcept {
+  uint64_t remainder = 0;
+  for (auto& digit : digits) {
+    auto dividend = remainder * kSplitBase + digit;
+    digit = dividend / divisor;
+    remainder = dividend % divisor;
+  }
+}
+
+// Subtracts the subtrahend, which is at most the digits, from the digits.
+void SubtractDigits(Digits& digits, const Digits& subtrahend) noexcept {
+  unsigned borrow = 0;
+  for (size_t i = digits.size(); i-- > 0;) {
+    auto subtracted = subtrahend[i] + borrow;
+    borrow = digits[i] < subtracted ? 1 : 0;
+    digits[i] = digits[i] + borrow * kSplitBase - subtracted;
+  }
+}
+
+// Gets the base-2 logarithm of the digits, which are not all zero.
+double GetLog2(const Digits& digits) noexcept {
+  auto it = std::find_if(digits.begin(), digits.end(),
+                         [](unsigned digit) { return digit != 0; });
+  auto index = it - digits.begin();
+  double value = *it;
+  if (it + 1 != digits.end()) {
+    value += static_cast<double>(*(it + 1)) / kSplitBase;
+  }
+  return std::log2(value) - 7.0 * index;
+}
+
+// Gets the smallest ASCII name which sorts after the bytes of the name ahead
+// of its first non-ASCII byte, as every ASCII name after the name does, or
+// the name itself if it is ASCII.
+optional<string> GetAsciiCeiling(string name) noexcept {
+  auto non_ascii = std::find_if(name.begin(), name.end(), [](char byte) {
+    return static_cast<unsigned char>(byte) >= kSplitBase;
+  });
+  if (non_ascii == name.end()) {
+    return name;
+  }
+  name.erase(non_ascii, name.end());
+  while (!name.empty() &&
+         static_cast<unsigned char>(name.back()) == kSplitBase - 1) {
+    name.pop_back();
+  }
+  if (name.empty()) {
+    return nullopt;
+  }
+  name.back()++;
+  return name;
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+ParallelBlobLister::ParallelBlobLister(
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>
+        context,
+    ListPageFunction list_page, size_t parallelism,
+    shared_ptr<AsyncExecutorInterface> cpu_async_executor)
+    : context_(move(context)),
+      list_page_(move(list_page)),
+      parallelism_(max<size_t>(parallelism, 1)),
+      cpu_async_executor_(move(cpu_async_executor)) {
+  const auto& request = *context_.request;
+  page_size_ = request.has_max_page_size() && request.max_page_size() > 0
+                   ? request.max_page_size()
+                   : kListBlobsMetadataMaxResults;
+}
+
+void ParallelBlobLister::Start() noexcept {
+  // A page of an invalid request fails before it is listed, so the request is
+  // checked up front to fail the stream the same way on every provider.
+  const auto& request = *context_.request;
+  if (request.blob_metadata().bucket_name().empty() ||
+      (request.has_max_page_size() &&
+       request.max_page_size() > kListBlobsMetadataMaxResults)) {
+    {
+      lock_guard lock(mutex_);
+      is_done_ = true;
+    }
+    FinishStreamingContext(
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS), context_,
+        cpu_async_executor_);
+    return;
+  }
+
+  {
+    lock_guard lock(mutex_);
+    pages_in_flight_ = 1;
+  }
+  ListRange(NameRange());
+}
+
+vector<string> ParallelBlobLister::GetSplitNames(const string& first,
+                                                 const string& last,
+                                                 const string& before,
+                                                 size_t count) noexcept {
+  auto lower = GetAsciiCeiling(last);
+  if (!lower.has_value() || count == 0) {
+    return {};
+  }
+  // One digit past the longest name leaves room for a split name between
+  // names which are next to each other at their own length.
+  auto length = std::max({first.size(), lower->size(), before.size()}) + 1;
+  auto lower_digits = ToDigits(*lower, length);
+  auto span = ToDigits(before, length);
+  if (span <= lower_digits) {
+    return {};
+  }
+  SubtractDigits(span, lower_digits);
+  auto page_width = lower_digits;
+  SubtractDigits(page_width, ToDigits(first, length));
+  if (std::all_of(page_width.begin(), page_width.end(),
+                  [](unsigned digit) { return digit == 0; })) {
+    page_width.back() = 1;
+  }
+
+  // Ranges narrower than the page are likely done after a single page, so the
+  // names are split into no more ranges than pages seem to be left.
+  auto page_count =
+      std::llround(std::exp2(GetLog2(span) - GetLog2(page_width)));
+  if (page_count < static_cast<long long>(count) + 1) {
+    count = page_count < 2 ? 0 : static_cast<size_t>(page_count) - 1;
+  }
+  auto step = span;
+  DivideDigits(step, count + 1);
+  auto split_digits = lower_digits;
+  vector<string> split_names;
+  auto previous = last;
+  for (size_t i = 0; i < count; ++i) {
+    AddDigits(split_digits, step);
+    auto split_name = ToName(split_digits);
+    // The bytes of before above the base are clamped, so the split names are
+    // only checked to be in order here. Names cannot contain NUL.
+    if (split_name >= before) {
+      break;
+    }
+    if (split_name > previous && split_name.find('\0') == string::npos) {
+      previous = split_name;
+      split_names.push_back(move(split_name));
+    }
+  }
+  return split_names;
+}
+
+vector<ParallelBlobLister::NameRange> ParallelBlobLister::SplitRange(
+    NameRange range, const string& first, size_t range_count) const noexcept {
+  const auto& prefix = context_.request->blob_metadata().blob_name();
+  auto split_names =
+      GetSplitNames(first, *range.after,
+                    range.until.value_or(prefix + kPrefixEnd), range_count - 1);
+  vector<NameRange> ranges;
+  auto after = move(range.after);
+  for (auto& split_name : split_names) {
+    ranges.push_back(NameRange{move(after), split_name});
+    after = move(split_name);
+  }
+  ranges.push_back(NameRange{move(after), move(range.until)});
+  return ranges;
+}
+
+void ParallelBlobLister::ListRange(NameRange range) noexcept {
+  const auto& request = *context_.request;
+  auto page_request = make_shared<ListBlobsMetadataRequest>();
+  *page_request->mutable_blob_metadata() = request.blob_metadata();
+  page_request->set_max_page_size(page_size_);
+  if (request.has_cloud_identity_info()) {
+    *page_request->mutable_cloud_identity_info() =
+        request.cloud_identity_info();
+  }
+  if (range.after.has_value()) {
+    page_request->set_page_token(*range.after);
+  }
+  AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>
+      page_context(
+          move(page_request),
+          [self = shared_from_this(), range = move(range)](
+              AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+                  page_context) { self->OnPageListed(range, page_context); },
+          context_);
+  list_page_(page_context);
+}
+
+void ParallelBlobLister::OnPageListed(
+    const NameRange& range,
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+        page_context) noexcept {
+  optional<ExecutionResult> finish_result;
+  bool is_pushed = false;
+  vector<NameRange> ranges_to_list;
+  {
+    lock_guard lock(mutex_);
+    if (is_done_) {
+      return;
+    }
+    pages_in_flight_--;
+    if (context_.IsCancelled()) {
+      finish_result = FailureExecutionResult(
+          SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+    } else if (!page_context.result.Successful()) {
+      finish_result = page_context.result;
+    } else {
+      static const ListBlobsMetadataResponse kEmptyPage;
+      const auto& page = page_context.response ? *page_context.response
+                                               : kEmptyPage;
+      // A page which is not full is the end of the names with the prefix, and
+      // a name past the range is the end of the range.
+      bool is_range_done =
+          static_cast<uint64_t>(page.blob_metadatas().size()) < page_size_;
+      ListAllBlobsMetadataResponse response;
+      for (const auto& blob_metadata : page.blob_metadatas()) {
+        if (range.until.has_value() &&
+            blob_metadata.blob_name() > *range.until) {
+          is_range_done = true;
+          break;
+        }
+        *response.add_blob_metadatas() = blob_metadata;
+      }
+      if (!response.blob_metadatas().empty()) {
+        auto push_result = context_.TryPushResponse(move(response));
+        if (!push_result.Successful()) {
+          finish_result = push_result;
+        }
+        is_pushed = true;
+      }
+      if (!finish_result.has_value() && !is_range_done) {
+        // Hand the slots nothing is listed in to the rest of this range.
+        ranges_to_list = SplitRange(
+            NameRange{page.blob_metadatas().rbegin()->blob_name(), range.until},
+            page.blob_metadatas(0).blob_name(),
+            parallelism_ - pages_in_flight_);
+        pages_in_flight_ += ranges_to_list.size();
+      }
+      if (!finish_result.has_value() && pages_in_flight_ == 0) {
+        finish_result = SuccessExecutionResult();
+      }
+    }
+    if (finish_result.has_value()) {
+      is_done_ = true;
+    }
+  }
+
+  // The pages and the context callbacks may run on this thread, so they are
+  // listed outside the lock.
+  if (is_pushed && (!finish_result.has_value() ||
+                    finish_result->Successful())) {
+    auto schedule_result = cpu_async_executor_->Schedule(
+        [context = context_]() mutable { context.ProcessNextMessage(); },
+        AsyncPriority::Normal);
+    if (!schedule_result.Successful()) {
+      {
+        lock_guard lock(mutex_);
+        if (is_done_ && !finish_result.has_value()) {
+          // Another page already finished the context.
+          return;
+        }
+        is_done_ = true;
+      }
+      finish_result = schedule_result;
+      ranges_to_list.clear();
+    }
+  }
+  for (auto& range_to_list : ranges_to_list) {
+    ListRange(move(range_to_list));
+  }
+  if (finish_result.has_value()) {
+    FinishStreamingContext(*finish_result, context_, cpu_async_executor_);
+  }
+}
+}  // namespace google::scp::cpio::client_providers
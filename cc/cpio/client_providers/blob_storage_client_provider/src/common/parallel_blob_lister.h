@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/streaming_context.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Serves a ListAllBlobsMetadata by listing ranges of the blob names
+ * with the prefix side by side, up to parallelism pages at once, and pushing
+ * each page to the context as soon as it is listed.
+ *
+ * The names are listed as a single range at first. Whenever a page comes back
+ * full while fewer than parallelism pages are in flight, the rest of its range
+ * is split evenly into a range per idle slot. Ranges without many blobs finish
+ * early and hand their slot over to the dense ones, which are split again. The
+ * names within a page are in order, but the pages are not.
+ */
+class ParallelBlobLister
+    : public std::enable_shared_from_this<ParallelBlobLister> {
+ public:
+  /**
+   * @brief Lists a page of the blob names and finishes the context with it.
+   * The context may be finished on any thread, including the calling one.
+   */
+  using ListPageFunction = std::function<void(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&)>;
+
+  /**
+   * @brief Construct a new lister. Nothing is listed until Start().
+   *
+   * @param context the context of the ListAllBlobsMetadata, which is finished
+   * once all the names are listed or a page fails.
+   * @param list_page lists a page of the blob names.
+   * @param parallelism the max number of pages in flight.
+   * @param cpu_async_executor the executor to process responses on.
+   */
+  ParallelBlobLister(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>
+          context,
+      ListPageFunction list_page, size_t parallelism,
+      std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor);
+
+  /// Starts listing the first page, or fails the context if the request has
+  /// no bucket name or asks for pages larger than 1000 names.
+  void Start() noexcept;
+
+  /**
+   * @brief Gets up to count names to split the names left after a page at,
+   * all of which sort after last and before before. The ranges between them
+   * are equally wide, and no narrower than the page from first to last, so
+   * that a range near the end is not split into empty ones. Names are treated
+   * as base-128 fractions, so the split names are made of ASCII bytes only.
+   */
+  static std::vector<std::string> GetSplitNames(const std::string& first,
+                                                const std::string& last,
+                                                const std::string& before,
+                                                size_t count) noexcept;
+
+ private:
+  /// The blob names in (after, until]. No after starts at the first name of
+  /// the prefix, and no until ends at the last one.
+  struct NameRange {
+    std::optional<std::string> after;
+    std::optional<std::string> until;
+  };
+
+  /// Lists the next page of the range.
+  void ListRange(NameRange range) noexcept;
+
+  /// Pushes the names of the page which are in the range, and lists the rest
+  /// of the range, or finishes the context.
+  void OnPageListed(
+      const NameRange& range,
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
+          page_context) noexcept;
+
+  /// Splits the rest of the range after a page, which starts at first, into
+  /// up to range_count ranges.
+  std::vector<NameRange> SplitRange(NameRange range, const std::string& first,
+                                    size_t range_count) const noexcept;
+
+  core::ConsumerStreamingContext<
+      cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+      cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>
+      context_;
+  const ListPageFunction list_page_;
+  const size_t parallelism_;
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+  /// The number of names a full page has.
+  uint64_t page_size_;
+
+  std::mutex mutex_;
+  size_t pages_in_flight_ = 0;
+  /// Whether the context is finished.
+  bool is_done_ = false;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_part_uploader.h"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
+using std::lock_guard;
+using std::min;
+using std::move;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::vector;
+using std::chrono::nanoseconds;
+
+namespace google::scp::cpio::client_providers {
+ParallelPartUploader::ParallelPartUploader(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+        context,
+    UploadPartFunction upload_part, DoneCallback done_callback,
+    uint64_t part_size, ChecksumAlgorithm checksum_algorithm,
+    size_t parallelism, nanoseconds expiry_time_ns,
+    nanoseconds rescan_time,
+    shared_ptr<AsyncExecutorInterface> io_async_executor)
+    : context_(move(context)),
+      upload_part_(move(upload_part)),
+      done_callback_(move(done_callback)),
+      part_size_(std::max<uint64_t>(part_size, 1)),
+      parallelism_(std::max<size_t>(parallelism, 1)),
+      expiry_time_ns_(expiry_time_ns),
+      rescan_time_(rescan_time),
+      io_async_executor_(move(io_async_executor)),
+      current_part_checksum_(checksum_algorithm) {}
+
+void ParallelPartUploader::Start() noexcept {
+  {
+    lock_guard lock(mutex_);
+    AppendData(context_.request->blob_portion().data());
+  }
+  Pump();
+}
+
+void ParallelPartUploader::AppendData(const string& data) noexcept {
+  for (size_t offset = 0; offset < data.size();) {
+    if (current_part_.empty()) {
+      current_part_.reserve(part_size_);
+    }
+    auto size = min<uint64_t>(data.size() - offset,
+                              part_size_ - current_part_.size());
+    current_part_.append(data, offset, size);
+    current_part_checksum_.Update(string_view(data).substr(offset, size));
+    offset += size;
+    if (current_part_.size() == part_size_) {
+      CutPart();
+    }
+  }
+}
+
+void ParallelPartUploader::CutPart() noexcept {
+  full_parts_.push_back(Part{next_part_number_++, move(current_part_),
+                            current_part_checksum_.Finish()});
+  current_part_ = string();
+}
+
+void ParallelPartUploader::Pump() noexcept {
+  vector<Part> parts_to_upload;
+  optional<ExecutionResult> done_result;
+  vector<string> part_ids;
+  bool should_poll = false;
+  {
+    lock_guard lock(mutex_);
+    if (is_done_) {
+      return;
+    }
+    while (!failure_.has_value()) {
+      while (!full_parts_.empty() && parts_in_flight_ < parallelism_) {
+        parts_to_upload.push_back(move(full_parts_.front()));
+        full_parts_.pop_front();
+        parts_in_flight_++;
+      }
+      if (!full_parts_.empty() || parts_in_flight_ >= parallelism_ ||
+          is_input_done_) {
+        break;
+      }
+      if (context_.IsCancelled()) {
+        failure_ = FailureExecutionResult(
+            SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+        break;
+      }
+      auto request = context_.TryGetNextRequest();
+      if (request == nullptr) {
+        if (context_.IsMarkedDone()) {
+          // Upload whatever is left as the last part.
+          is_input_done_ = true;
+          if (!current_part_.empty()) {
+            CutPart();
+          }
+          continue;
+        }
+        if (TimeProvider::GetWallTimestampInNanoseconds() >= expiry_time_ns_) {
+          failure_ = FailureExecutionResult(
+              SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED);
+          break;
+        }
+        // A part in flight pumps again once it is done, so only poll when
+        // there is none.
+        should_poll = parts_in_flight_ == 0;
+        break;
+      }
+      // Validate that the new request specifies the same blob.
+      if (request->blob_portion().metadata().bucket_name() !=
+              context_.request->blob_portion().metadata().bucket_name() ||
+          request->blob_portion().metadata().blob_name() !=
+              context_.request->blob_portion().metadata().blob_name()) {
+        failure_ =
+            FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+        break;
+      }
+      AppendData(request->blob_portion().data());
+    }
+
+    if (parts_in_flight_ == 0 &&
+        (failure_.has_value() || (is_input_done_ && full_parts_.empty()))) {
+      is_done_ = true;
+      done_result = failure_.value_or(SuccessExecutionResult());
+      if (!failure_.has_value()) {
+        for (auto& [part_number, part_id] : part_ids_) {
+          part_ids.push_back(move(part_id));
+        }
+      }
+      full_parts_.clear();
+      current_part_.clear();
+      part_ids_.clear();
+    }
+  }
+
+  // The uploads may call back on this thread, so they are done outside the
+  // lock.
+  for (auto& part : parts_to_upload) {
+    auto part_number = part.part_number;
+    upload_part_(part_number, move(part.data), move(part.checksum),
+                 [self = shared_from_this(),
+                  part_number](ExecutionResultOr<string> part_id_or) {
+                   self->OnPartUploaded(part_number, move(part_id_or));
+                 });
+  }
+  if (should_poll) {
+    auto schedule_result = io_async_executor_->ScheduleFor(
+        [self = shared_from_this()]() { self->Pump(); },
+        (TimeProvider::GetSteadyTimestampInNanoseconds() + rescan_time_)
+            .count());
+    if (!schedule_result.Successful()) {
+      {
+        lock_guard lock(mutex_);
+        if (is_done_) {
+          return;
+        }
+        is_done_ = true;
+      }
+      done_result = schedule_result;
+    }
+  }
+  if (done_result.has_value()) {
+    done_callback_(*done_result, move(part_ids));
+  }
+}
+
+void ParallelPartUploader::OnPartUploaded(
+    int part_number, ExecutionResultOr<string> part_id_or) noexcept {
+  {
+    lock_guard lock(mutex_);
+    parts_in_flight_--;
+    if (!part_id_or.Successful()) {
+      if (!failure_.has_value()) {
+        failure_ = part_id_or.result();
+      }
+    } else {
+      part_ids_[part_number] = move(*part_id_or);
+    }
+  }
+  Pump();
+}
+}  // namespace google::scp::cpio::client_providers
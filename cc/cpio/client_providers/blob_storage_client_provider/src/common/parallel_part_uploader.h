@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/streaming_context.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Uploads the data of a PutBlobStream as numbered parts of part_size
+ * bytes, up to parallelism parts at once.
+ *
+ * The data of the requests is copied into the buffer of the current part, and
+ * its checksum is computed during the copy. Once the buffer is full, the part
+ * is uploaded. No more requests are taken while parallelism parts are in
+ * flight or full parts wait to be uploaded, so besides the parts in flight
+ * only the data of the last request taken is buffered. The IDs of the
+ * uploaded parts are returned in part order once all of them are done.
+ */
+class ParallelPartUploader
+    : public std::enable_shared_from_this<ParallelPartUploader> {
+ public:
+  /// Is called with the ID of an uploaded part, such as its ETag, or the
+  /// failure to upload it.
+  using PartCallback =
+      std::function<void(core::ExecutionResultOr<std::string> part_id_or)>;
+  /**
+   * @brief Uploads a part and calls the callback once it is done. The callback
+   * may be called on any thread, including the calling one.
+   *
+   * @param part_number the number of the part, starting at 1.
+   * @param part the bytes of the part.
+   * @param checksum the binary digest of the bytes, which is empty when no
+   * checksum is computed.
+   */
+  using UploadPartFunction =
+      std::function<void(int part_number, std::string part,
+                         std::string checksum, PartCallback callback)>;
+  /// Is called once, after no part is in flight anymore, with the IDs of all
+  /// the parts in part order or the failure which stopped the upload.
+  using DoneCallback = std::function<void(
+      core::ExecutionResult result, std::vector<std::string> part_ids)>;
+
+  /**
+   * @brief Construct a new uploader. Nothing is uploaded until Start().
+   *
+   * @param context the context of the PutBlobStream. The data of its request
+   * is the first data uploaded.
+   * @param upload_part uploads a part.
+   * @param done_callback is called once the upload is done.
+   * @param part_size the size of each part but the last one.
+   * @param checksum_algorithm the checksum computed of each part.
+   * @param parallelism the max number of parts in flight.
+   * @param expiry_time_ns the wall time at which waiting for more requests
+   * fails the upload.
+   * @param rescan_time how long to wait before checking for requests again
+   * when none is available and no part is in flight.
+   * @param io_async_executor the executor to schedule the checks on.
+   */
+  ParallelPartUploader(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>
+          context,
+      UploadPartFunction upload_part, DoneCallback done_callback,
+      uint64_t part_size,
+      cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm checksum_algorithm,
+      size_t parallelism,
+      std::chrono::nanoseconds expiry_time_ns,
+      std::chrono::nanoseconds rescan_time,
+      std::shared_ptr<core::AsyncExecutorInterface> io_async_executor);
+
+  /// Starts uploading the data of the first request.
+  void Start() noexcept;
+
+ private:
+  /// A part which is full and ready to be uploaded.
+  struct Part {
+    int part_number;
+    std::string data;
+    std::string checksum;
+  };
+
+  /// Uploads the full parts and takes more requests until parallelism parts
+  /// are in flight, or finishes once no part is in flight after the last
+  /// request or a failure.
+  void Pump() noexcept;
+
+  /// Copies the data into the current part, cutting the parts which are full.
+  /// Must be called with mutex_ held.
+  void AppendData(const std::string& data) noexcept;
+
+  /// Cuts the current part into full_parts_. Must be called with mutex_ held.
+  void CutPart() noexcept;
+
+  /// Records the result of uploading the part and pumps more requests.
+  void OnPartUploaded(int part_number,
+                      core::ExecutionResultOr<std::string> part_id_or) noexcept;
+
+  core::ProducerStreamingContext<
+      cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+      cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>
+      context_;
+  const UploadPartFunction upload_part_;
+  const DoneCallback done_callback_;
+  const uint64_t part_size_;
+  const size_t parallelism_;
+  const std::chrono::nanoseconds expiry_time_ns_;
+  const std::chrono::nanoseconds rescan_time_;
+  const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_;
+
+  std::mutex mutex_;
+  /// The bytes of the part being filled and their running checksum.
+  std::string current_part_;
+  BlobChecksum current_part_checksum_;
+  /// The parts which are full and wait to be uploaded.
+  std::deque<Part> full_parts_;
+  int next_part_number_ = 1;
+  size_t parts_in_flight_ = 0;
+  /// The IDs of the uploaded parts, by part number.
+  std::map<int, std::string> part_ids_;
+  /// Whether the last request was taken.
+  bool is_input_done_ = false;
+  /// The failure which stops the upload, if any.
+  std::optional<core::ExecutionResult> failure_;
+  /// Whether the done callback was called.
+  bool is_done_ = false;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_range_reader.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using std::lock_guard;
+using std::min;
+using std::move;
+using std::mutex;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+constexpr uint64_t k64KbCount = 64 << 10;
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+ParallelRangeReader::ParallelRangeReader(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+        context,
+    ReadRangeFunction read_range, uint64_t part_size, size_t parallelism,
+    shared_ptr<AsyncExecutorInterface> cpu_async_executor)
+    : context_(move(context)),
+      read_range_(move(read_range)),
+      part_size_(std::max<uint64_t>(part_size, 1)),
+      parallelism_(std::max<size_t>(parallelism, 1)),
+      cpu_async_executor_(move(cpu_async_executor)) {
+  const auto& request = *context_.request;
+  if (request.has_byte_range()) {
+    begin_byte_index_ = request.byte_range().begin_byte_index();
+    end_byte_index_ = request.byte_range().end_byte_index();
+  } else {
+    begin_byte_index_ = 0;
+    end_byte_index_ = std::numeric_limits<uint64_t>::max();
+  }
+  // If max_bytes_per_response is provided, use it. Otherwise use 64KB.
+  max_bytes_per_response_ = request.max_bytes_per_response() == 0
+                                ? k64KbCount
+                                : request.max_bytes_per_response();
+}
+
+void ParallelRangeReader::Start() noexcept {
+  {
+    lock_guard lock(mutex_);
+    next_part_to_read_ = 1;
+  }
+  ReadPart(0);
+}
+
+uint64_t ParallelRangeReader::GetPartBeginByteIndex(
+    size_t part_index) const noexcept {
+  return begin_byte_index_ + part_index * part_size_;
+}
+
+void ParallelRangeReader::ReadPart(size_t part_index) noexcept {
+  auto begin_byte_index = GetPartBeginByteIndex(part_index);
+  // If the end index is beyond the end of the blob, the read is truncated.
+  auto end_byte_index =
+      min(begin_byte_index + (part_size_ - 1), end_byte_index_);
+  read_range_(begin_byte_index, end_byte_index,
+              [self = shared_from_this(), part_index](
+                  ExecutionResultOr<string> part_or,
+                  optional<uint64_t> blob_size) {
+                self->OnPartRead(part_index, move(part_or), blob_size);
+              });
+}
+
+void ParallelRangeReader::OnPartRead(size_t part_index,
+                                     ExecutionResultOr<string> part_or,
+                                     optional<uint64_t> blob_size) noexcept {
+  optional<ExecutionResult> finish_result;
+  size_t responses_pushed = 0;
+  vector<size_t> parts_to_read;
+  {
+    lock_guard lock(mutex_);
+    if (is_done_) {
+      return;
+    }
+    if (context_.IsCancelled()) {
+      finish_result = FailureExecutionResult(
+          SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+    } else if (!part_or.Successful()) {
+      finish_result = part_or.result();
+    } else {
+      if (blob_size.has_value() && !part_count_.has_value()) {
+        // Only read up to the end of the blob.
+        auto last_byte_index =
+            *blob_size > 0 ? min(*blob_size - 1, end_byte_index_) : 0;
+        part_count_ = last_byte_index < begin_byte_index_
+                          ? 1
+                          : (last_byte_index - begin_byte_index_) / part_size_ +
+                                1;
+      }
+      auto expected_size =
+          min(part_size_ - 1,
+              end_byte_index_ - GetPartBeginByteIndex(part_index)) +
+          1;
+      if (part_or->size() < expected_size) {
+        // The blob ends within this part.
+        part_count_ = min(part_count_.value_or(part_index + 1), part_index + 1);
+      }
+      read_parts_[part_index] = move(*part_or);
+
+      // Push the parts which are next in order.
+      while (!finish_result.has_value()) {
+        auto it = read_parts_.find(next_part_to_push_);
+        if (it == read_parts_.end()) {
+          break;
+        }
+        auto pushed_or = PushPart(it->first, move(it->second));
+        read_parts_.erase(it);
+        if (!pushed_or.Successful()) {
+          finish_result = pushed_or.result();
+          break;
+        }
+        responses_pushed += *pushed_or;
+        next_part_to_push_++;
+      }
+
+      if (!finish_result.has_value()) {
+        if (part_count_.has_value() && next_part_to_push_ >= *part_count_) {
+          finish_result = SuccessExecutionResult();
+        } else {
+          // Until the number of parts is known, there is nothing safe to read
+          // ahead of the next part.
+          auto window = part_count_.has_value() ? parallelism_ : 1;
+          auto read_limit = next_part_to_push_ + window;
+          if (part_count_.has_value()) {
+            read_limit = min(read_limit, *part_count_);
+          }
+          for (; next_part_to_read_ < read_limit; next_part_to_read_++) {
+            parts_to_read.push_back(next_part_to_read_);
+          }
+        }
+      }
+    }
+    if (finish_result.has_value()) {
+      is_done_ = true;
+      read_parts_.clear();
+    }
+  }
+
+  // The reads and the context callbacks may run on this thread, so they are
+  // done outside the lock.
+  for (size_t i = 0; i < responses_pushed; i++) {
+    auto schedule_result = cpu_async_executor_->Schedule(
+        [context = context_]() mutable { context.ProcessNextMessage(); },
+        AsyncPriority::Normal);
+    if (!schedule_result.Successful()) {
+      {
+        lock_guard lock(mutex_);
+        if (is_done_ && !finish_result.has_value()) {
+          // Another part already finished the context.
+          return;
+        }
+        is_done_ = true;
+        read_parts_.clear();
+      }
+      finish_result = schedule_result;
+      parts_to_read.clear();
+      break;
+    }
+  }
+  for (auto part_to_read : parts_to_read) {
+    ReadPart(part_to_read);
+  }
+  if (finish_result.has_value()) {
+    FinishStreamingContext(*finish_result, context_, cpu_async_executor_);
+  }
+}
+
+ExecutionResultOr<size_t> ParallelRangeReader::PushPart(
+    size_t part_index, string part) noexcept {
+  auto begin_byte_index = GetPartBeginByteIndex(part_index);
+  size_t responses_pushed = 0;
+  for (uint64_t offset = 0; offset < part.size();
+       offset += max_bytes_per_response_) {
+    GetBlobStreamResponse response;
+    response.mutable_blob_portion()->mutable_metadata()->CopyFrom(
+        context_.request->blob_metadata());
+    auto& data = *response.mutable_blob_portion()->mutable_data();
+    if (offset == 0 && part.size() <= max_bytes_per_response_) {
+      data = move(part);
+    } else {
+      data = part.substr(offset, max_bytes_per_response_);
+    }
+    response.mutable_byte_range()->set_begin_byte_index(begin_byte_index +
+                                                        offset);
+    response.mutable_byte_range()->set_end_byte_index(begin_byte_index +
+                                                      offset + data.size() - 1);
+    auto push_result = context_.TryPushResponse(move(response));
+    if (!push_result.Successful()) {
+      return push_result;
+    }
+    responses_pushed++;
+  }
+  return responses_pushed;
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/streaming_context.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Serves a GetBlobStream by reading the blob as parts of consecutive
+ * byte ranges, up to parallelism parts at once, and pushing their bytes to the
+ * context in order.
+ *
+ * The first part is read alone to learn the size of the blob. A part which is
+ * read before the parts ahead of it is held until they are pushed, and no part
+ * is read beyond parallelism parts of the oldest part not pushed yet, so at
+ * most parallelism parts are buffered or in flight at once.
+ */
+class ParallelRangeReader
+    : public std::enable_shared_from_this<ParallelRangeReader> {
+ public:
+  /**
+   * @brief Is called with the bytes of a part, or the failure to read them,
+   * and the size of the whole blob if the read returned it.
+   */
+  using PartCallback =
+      std::function<void(core::ExecutionResultOr<std::string> part_or,
+                         std::optional<uint64_t> blob_size)>;
+  /**
+   * @brief Reads the bytes [begin_byte_index, end_byte_index] of the blob and
+   * calls the callback with them. Fewer bytes are returned only if the blob
+   * ends within the range. The callback may be called on any thread, including
+   * the calling one.
+   */
+  using ReadRangeFunction =
+      std::function<void(uint64_t begin_byte_index, uint64_t end_byte_index,
+                         PartCallback callback)>;
+
+  /**
+   * @brief Construct a new reader. Nothing is read until Start().
+   *
+   * @param context the context of the GetBlobStream, which is finished once
+   * the blob is read or a part fails.
+   * @param read_range reads a part of the blob.
+   * @param part_size the size of each part. 0 is taken as 1.
+   * @param parallelism the max number of parts buffered or in flight.
+   * @param cpu_async_executor the executor to process responses on.
+   */
+  ParallelRangeReader(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>
+          context,
+      ReadRangeFunction read_range, uint64_t part_size, size_t parallelism,
+      std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor);
+
+  /// Starts reading the first part.
+  void Start() noexcept;
+
+ private:
+  /// Reads the part at part_index.
+  void ReadPart(size_t part_index) noexcept;
+
+  /// Buffers the part, pushes the parts which are next in order and reads
+  /// more parts, or finishes the context.
+  void OnPartRead(size_t part_index,
+                  core::ExecutionResultOr<std::string> part_or,
+                  std::optional<uint64_t> blob_size) noexcept;
+
+  /// Pushes the bytes of a part as responses of up to max_bytes_per_response_.
+  /// Returns the number of responses pushed.
+  core::ExecutionResultOr<size_t> PushPart(size_t part_index,
+                                           std::string part) noexcept;
+
+  /// The index of the first byte of the part.
+  uint64_t GetPartBeginByteIndex(size_t part_index) const noexcept;
+
+  core::ConsumerStreamingContext<
+      cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+      cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>
+      context_;
+  const ReadRangeFunction read_range_;
+  const uint64_t part_size_;
+  const size_t parallelism_;
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+  /// The first and last byte of the blob to read, inclusive.
+  uint64_t begin_byte_index_, end_byte_index_;
+  uint64_t max_bytes_per_response_;
+
+  std::mutex mutex_;
+  /// Known once the size of the blob is known, or a part comes back short.
+  std::optional<size_t> part_count_;
+  size_t next_part_to_read_ = 0;
+  size_t next_part_to_push_ = 0;
+  /// Parts read ahead of next_part_to_push_.
+  std::map<size_t, std::string> read_parts_;
+  /// Whether the context is finished.
+  bool is_done_ = false;
+};
+}  // namespace google::scp::cpio::client_providers
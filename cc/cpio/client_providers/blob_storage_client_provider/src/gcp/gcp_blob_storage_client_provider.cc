@@ -20,6 +20,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -28,6 +29,7 @@
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/util/time_util.h>
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 #include "cc/core/interface/configuration_keys.h"
 #include "core/common/global_logger/src/global_logger.h"
@@ -36,8 +38,14 @@
 #include "core/interface/blob_storage_provider_interface.h"
 #include "core/interface/configuration_keys.h"
 #include "core/interface/type_def.h"
-#include "core/utils/src/hashing.h"
+#include "core/utils/src/base64.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/cache/caching_blob_storage_client_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
 #include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_blob_lister.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_range_reader.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/local/local_blob_storage_client_provider.h"
 #include "cpio/client_providers/instance_client_provider/src/gcp/gcp_instance_client_utils.h"
 #include "google/cloud/options.h"
 #include "google/cloud/status_or.h"
@@ -54,11 +62,13 @@ using google::cloud::StatusCode;
 using google::cloud::StatusOr;
 using google::cloud::UnifiedCredentialsOption;
 using google::cloud::storage::Client;
-using google::cloud::storage::ComputeMD5Hash;
 using google::cloud::storage::ConnectionPoolSizeOption;
+using google::cloud::storage::Crc32cChecksumValue;
 using google::cloud::storage::DisableCrc32cChecksum;
+using google::cloud::storage::DisableMD5Hash;
 using google::cloud::storage::EnableMD5Hash;
 using google::cloud::storage::IdempotencyPolicyOption;
+using google::cloud::storage::IfGenerationNotMatch;
 using google::cloud::storage::LimitedErrorCountRetryPolicy;
 using google::cloud::storage::ListObjectsReader;
 using google::cloud::storage::MaxResults;
@@ -77,11 +87,19 @@ using google::cloud::storage::StrictIdempotencyPolicy;
 using google::cloud::storage::TransferStallTimeoutOption;
 using google::cmrt::sdk::blob_storage_service::v1::Blob;
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
 using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
@@ -118,6 +136,7 @@ using google::scp::core::errors::
     SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
 using google::scp::core::errors::
     SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
+using google::scp::core::utils::Base64Encode;
 
 using google::scp::cpio::client_providers::GcpInstanceClientUtils;
 using google::scp::cpio::common::GcpUtils;
@@ -127,9 +146,13 @@ using std::function;
 using std::ios_base;
 using std::istream;
 using std::make_shared;
+using std::lock_guard;
 using std::make_unique;
 using std::min;
 using std::move;
+using std::mutex;
+using std::nullopt;
+using std::optional;
 using std::ostream;
 using std::ref;
 using std::shared_ptr;
@@ -141,12 +164,17 @@ using std::chrono::duration_cast;
 using std::chrono::minutes;
 using std::chrono::nanoseconds;
 using std::chrono::seconds;
+using std::chrono::steady_clock;
 
 namespace {
 
 constexpr size_t kMaxConcurrentConnections = 1000;
 constexpr size_t kListBlobsMetadataMaxResults = 1000;
+// The max number of objects of a DeleteBlobs deleted at once per batch, as in
+// a Cloud Storage batch request.
+constexpr size_t kDeleteObjectsBatchSize = 100;
 constexpr size_t k64KbCount = 64 << 10;
+constexpr size_t kAdaptiveMaxBytesPerResponse = 8 << 20;
 constexpr size_t kMaxSizeBytesToRead = std::numeric_limits<size_t>::max();
 constexpr nanoseconds kDefaultStreamKeepaliveNanos =
     duration_cast<nanoseconds>(minutes(5));
@@ -279,10 +307,38 @@ void GcpBlobStorageClientProvider::GetBlobInternal(
         ReadRange(get_blob_context.request->byte_range().begin_byte_index(),
                   get_blob_context.request->byte_range().end_byte_index() + 1);
   }
+  // The etags of GCP blobs are their generations, so an etag which is not a
+  // generation can never match.
+  IfGenerationNotMatch if_generation_not_match;
+  int64_t generation;
+  if (get_blob_context.request->has_if_none_match_etag() &&
+      absl::SimpleAtoi(get_blob_context.request->if_none_match_etag(),
+                       &generation)) {
+    if_generation_not_match = IfGenerationNotMatch(generation);
+  }
+  // The client library checks whole blobs against the hash as they are read.
+  auto checksum_algorithm = BlobChecksum::ResolveAlgorithm(
+      get_blob_context.request->checksum_algorithm());
   ObjectReadStream blob_stream = cloud_storage_client.ReadObject(
       get_blob_context.request->blob_metadata().bucket_name(),
       get_blob_context.request->blob_metadata().blob_name(),
-      DisableCrc32cChecksum(true), EnableMD5Hash(), read_range);
+      DisableCrc32cChecksum(checksum_algorithm != CHECKSUM_ALGORITHM_CRC32C),
+      DisableMD5Hash(checksum_algorithm != CHECKSUM_ALGORITHM_MD5), read_range,
+      if_generation_not_match);
+  // Cloud Storage answers a matching generation with a 304, which the client
+  // reports as a failed precondition.
+  if (if_generation_not_match.has_value() &&
+      blob_stream.status().code() == StatusCode::kFailedPrecondition) {
+    get_blob_context.response = make_shared<GetBlobResponse>();
+    get_blob_context.response->mutable_blob()->mutable_metadata()->CopyFrom(
+        get_blob_context.request->blob_metadata());
+    get_blob_context.response->set_etag(
+        get_blob_context.request->if_none_match_etag());
+    get_blob_context.response->set_not_modified(true);
+    FinishContext(SuccessExecutionResult(), get_blob_context,
+                  cpu_async_executor_);
+    return;
+  }
   if (!ValidateStream(get_blob_context, blob_stream).Successful()) {
     return;
   }
@@ -313,6 +369,10 @@ void GcpBlobStorageClientProvider::GetBlobInternal(
   if (!ValidateStream(get_blob_context, blob_stream).Successful()) {
     return;
   }
+  if (blob_stream.generation().has_value()) {
+    get_blob_context.response->set_etag(
+        std::to_string(*blob_stream.generation()));
+  }
 
   FinishContext(SuccessExecutionResult(), get_blob_context,
                 cpu_async_executor_);
@@ -348,10 +408,16 @@ void GcpBlobStorageClientProvider::GetBlobStream(
     return;
   }
 
+  function<void()> get_blob_stream =
+      bind(&GcpBlobStorageClientProvider::GetBlobStreamInternal, this,
+           get_blob_stream_context, nullptr /*tracker*/);
+  if (options_->get_blob_stream_parallelism > 1) {
+    get_blob_stream =
+        bind(&GcpBlobStorageClientProvider::GetBlobStreamInParallel, this,
+             get_blob_stream_context);
+  }
   if (auto schedule_result = io_async_executor_->Schedule(
-          bind(&GcpBlobStorageClientProvider::GetBlobStreamInternal, this,
-               get_blob_stream_context, nullptr /*tracker*/),
-          AsyncPriority::Normal);
+          move(get_blob_stream), AsyncPriority::Normal);
       !schedule_result.Successful()) {
     get_blob_stream_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, get_blob_stream_context,
@@ -382,11 +448,18 @@ void GcpBlobStorageClientProvider::GetBlobStreamInternal(
                            cpu_async_executor_);
     return;
   }
+  auto read_start_time = steady_clock::now();
   auto response = ReadNextPortion(*get_blob_stream_context.request, *tracker);
 
   if (!ValidateStream(get_blob_stream_context, tracker->stream).Successful()) {
     return;
   }
+  if (tracker->chunk_sizer) {
+    tracker->chunk_sizer->RecordRead(
+        response.blob_portion().data().size(),
+        steady_clock::now() - read_start_time,
+        get_blob_stream_context.GetNumOutstandingResponses());
+  }
 
   auto push_result = get_blob_stream_context.TryPushResponse(move(response));
   if (!push_result.Successful()) {
@@ -434,6 +507,75 @@ void GcpBlobStorageClientProvider::GetBlobStreamInternal(
   }
 }
 
+void GcpBlobStorageClientProvider::GetBlobStreamInParallel(
+    ConsumerStreamingContext<
+        cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+        GetBlobStreamResponse>
+        get_blob_stream_context) noexcept {
+  auto client_or = GetOrCreateCloudStroageClient(
+      get_blob_stream_context.request->cloud_identity_info());
+  if (!client_or.Successful()) {
+    auto result = client_or.result();
+    SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, get_blob_stream_context,
+                      result,
+                      "Create google cloud storage client failed for get blob "
+                      "stream request.");
+    FinishStreamingContext(result, get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  auto read_range = [this, client = move(*client_or),
+                     get_blob_stream_context](
+                        uint64_t begin_byte_index, uint64_t end_byte_index,
+                        ParallelRangeReader::PartCallback callback) {
+    auto read_part = [this, client, get_blob_stream_context, begin_byte_index,
+                      end_byte_index, callback]() {
+      const auto& metadata = get_blob_stream_context.request->blob_metadata();
+      // ReadRange is right-open, add one. The hashes of the object cannot be
+      // checked against a part of it.
+      auto stream = client->ReadObject(
+          metadata.bucket_name(), metadata.blob_name(),
+          DisableCrc32cChecksum(true), DisableMD5Hash(true),
+          ReadRange(begin_byte_index, end_byte_index + 1));
+      string part(end_byte_index - begin_byte_index + 1, '\0');
+      stream.read(part.data(), part.size());
+      if (stream.eof()) {
+        // The object ends within the range.
+        part.resize(stream.gcount());
+      }
+      if (!stream.status().ok()) {
+        auto result = GcpUtils::GcpErrorConverter(stream.status());
+        SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider,
+                          get_blob_stream_context, result,
+                          "Blob stream failed. Message: %s.",
+                          stream.status().message().c_str());
+        callback(result, nullopt);
+        return;
+      }
+      // size() has the full size of the object, not just the read range.
+      optional<uint64_t> blob_size;
+      if (stream.size()) {
+        blob_size = *stream.size();
+      }
+      callback(move(part), blob_size);
+    };
+    if (auto schedule_result =
+            io_async_executor_->Schedule(read_part, AsyncPriority::Normal);
+        !schedule_result.Successful()) {
+      SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, get_blob_stream_context,
+                        schedule_result,
+                        "Get blob stream part read failed to be scheduled");
+      callback(schedule_result, nullopt);
+    }
+  };
+  make_shared<ParallelRangeReader>(
+      get_blob_stream_context, move(read_range),
+      options_->get_blob_stream_part_size,
+      options_->get_blob_stream_parallelism, cpu_async_executor_)
+      ->Start();
+}
+
 ExecutionResultOr<
     shared_ptr<GcpBlobStorageClientProvider::GetBlobStreamTracker>>
 GcpBlobStorageClientProvider::InitGetBlobStreamTracker(
@@ -497,6 +639,12 @@ GcpBlobStorageClientProvider::InitGetBlobStreamTracker(
   // The first portion will start at begin_byte_index.
   tracker->last_end_byte_index =
       context.request->byte_range().begin_byte_index() - 1;
+  if (context.request->adaptive_bytes_per_response()) {
+    tracker->chunk_sizer.emplace(
+        k64KbCount, context.request->max_bytes_per_response() == 0
+                        ? kAdaptiveMaxBytesPerResponse
+                        : context.request->max_bytes_per_response());
+  }
   return tracker;
 }
 
@@ -508,6 +656,9 @@ GetBlobStreamResponse GcpBlobStorageClientProvider::ReadNextPortion(
   size_t next_read_size = request.max_bytes_per_response() == 0
                               ? k64KbCount
                               : request.max_bytes_per_response();
+  if (tracker.chunk_sizer) {
+    next_read_size = tracker.chunk_sizer->GetChunkSize();
+  }
   // Read up to next_read_size or bytes_remaining. If we don't know how many
   // bytes are remaining, naively read next_read_size; we will check if all
   // bytes were read via eof().
@@ -596,6 +747,7 @@ void GcpBlobStorageClientProvider::ListBlobsMetadata(
         list_blobs_context.result,
         "List blobs metadata request failed. Max page size cannot be "
         "greater than 1000.");
+    list_blobs_context.Finish();
     return;
   }
 
@@ -689,6 +841,19 @@ void GcpBlobStorageClientProvider::ListBlobsMetadataInternal(
                 cpu_async_executor_);
 }
 
+void GcpBlobStorageClientProvider::ListAllBlobsMetadata(
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>&
+        list_all_blobs_context) noexcept {
+  // The lister checks the request before any page is listed.
+  make_shared<ParallelBlobLister>(
+      list_all_blobs_context,
+      [this](AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+                 list_blobs_context) { ListBlobsMetadata(list_blobs_context); },
+      options_->list_all_blobs_parallelism, cpu_async_executor_)
+      ->Start();
+}
+
 void GcpBlobStorageClientProvider::PutBlob(
     AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) noexcept {
   const auto& request = *put_blob_context.request;
@@ -731,11 +896,34 @@ void GcpBlobStorageClientProvider::PutBlobInternal(
   }
   Client cloud_storage_client(*(client_or.value()));
 
-  string md5_hash = ComputeMD5Hash(request.blob().data());
+  BlobChecksum checksum(request.checksum_algorithm());
+  string base64_checksum;
+  if (checksum.GetAlgorithm() != CHECKSUM_ALGORITHM_NONE) {
+    checksum.Update(request.blob().data());
+    auto base64_checksum_or = Base64Encode(checksum.Finish());
+    if (!base64_checksum_or.Successful()) {
+      SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, put_blob_context,
+                        base64_checksum_or.result(),
+                        "Encoding the checksum to base64 failed");
+      FinishContext(base64_checksum_or.result(), put_blob_context,
+                    cpu_async_executor_);
+      return;
+    }
+    base64_checksum = move(*base64_checksum_or);
+  }
+  // The client library computes no CRC32C of its own when it is given one or
+  // it is disabled.
   auto object_metadata = cloud_storage_client.InsertObject(
       request.blob().metadata().bucket_name(),
       request.blob().metadata().blob_name(), request.blob().data(),
-      MD5HashValue(md5_hash));
+      checksum.GetAlgorithm() == CHECKSUM_ALGORITHM_MD5
+          ? MD5HashValue(base64_checksum)
+          : MD5HashValue(),
+      checksum.GetAlgorithm() == CHECKSUM_ALGORITHM_CRC32C
+          ? Crc32cChecksumValue(base64_checksum)
+          : Crc32cChecksumValue(),
+      DisableCrc32cChecksum(checksum.GetAlgorithm() !=
+                            CHECKSUM_ALGORITHM_CRC32C));
   if (!object_metadata) {
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, put_blob_context,
                       put_blob_context.result,
@@ -1064,6 +1252,89 @@ void GcpBlobStorageClientProvider::DeleteBlobInternal(
                 cpu_async_executor_);
 }
 
+void GcpBlobStorageClientProvider::DeleteBlobs(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+        delete_blobs_context) noexcept {
+  make_shared<BatchBlobDeleter>(
+      delete_blobs_context,
+      [this, cloud_identity_info =
+                 delete_blobs_context.request->cloud_identity_info()](
+          const string& bucket_name, const vector<string>& blob_names,
+          BatchBlobDeleter::DeleteBatchCallback callback) {
+        DeleteObjects(cloud_identity_info, bucket_name, blob_names,
+                      move(callback));
+      },
+      kDeleteObjectsBatchSize,
+      options_ ? options_->delete_blobs_parallelism : 1, cpu_async_executor_)
+      ->Start();
+}
+
+void GcpBlobStorageClientProvider::DeleteObjects(
+    const CloudIdentityInfo& cloud_identity_info, const string& bucket_name,
+    const vector<string>& blob_names,
+    BatchBlobDeleter::DeleteBatchCallback callback) noexcept {
+  struct BatchTracker {
+    mutex results_mutex;
+    vector<ExecutionResult> results;
+    size_t blobs_left;
+    BatchBlobDeleter::DeleteBatchCallback callback;
+  };
+  auto tracker = make_shared<BatchTracker>();
+  tracker->results.resize(blob_names.size());
+  tracker->blobs_left = blob_names.size();
+  tracker->callback = move(callback);
+  auto on_blob_deleted = [tracker](size_t index, ExecutionResult result) {
+    bool is_done;
+    {
+      lock_guard lock(tracker->results_mutex);
+      tracker->results[index] = result;
+      is_done = --tracker->blobs_left == 0;
+    }
+    if (is_done) {
+      tracker->callback(move(tracker->results));
+    }
+  };
+
+  for (size_t i = 0; i < blob_names.size(); ++i) {
+    if (auto schedule_result = io_async_executor_->Schedule(
+            [this, cloud_identity_info, bucket_name,
+             blob_name = blob_names[i], i, on_blob_deleted]() {
+              on_blob_deleted(
+                  i, DeleteObject(cloud_identity_info, bucket_name, blob_name));
+            },
+            AsyncPriority::Normal);
+        !schedule_result.Successful()) {
+      SCP_ERROR(kGcpBlobStorageClientProvider, kZeroUuid, schedule_result,
+                "Delete blobs request failed to be scheduled");
+      on_blob_deleted(i, schedule_result);
+    }
+  }
+}
+
+ExecutionResult GcpBlobStorageClientProvider::DeleteObject(
+    const CloudIdentityInfo& cloud_identity_info, const string& bucket_name,
+    const string& blob_name) noexcept {
+  auto client_or = GetOrCreateCloudStroageClient(cloud_identity_info);
+  if (!client_or.Successful()) {
+    SCP_ERROR(
+        kGcpBlobStorageClientProvider, kZeroUuid, client_or.result(),
+        "Create google cloud storage client failed for delete blobs request.");
+    return client_or.result();
+  }
+  Client cloud_storage_client(*(client_or.value()));
+
+  auto status = cloud_storage_client.DeleteObject(bucket_name, blob_name);
+  if (!status.ok()) {
+    SCP_DEBUG(kGcpBlobStorageClientProvider, kZeroUuid,
+              "Delete blobs request failed for a blob. Error code: %d, "
+              "message: %s",
+              status.code(), status.message().c_str());
+    return GcpBlobStorageClientUtils::ConvertCloudStorageErrorToExecutionResult(
+        status.code());
+  }
+  return SuccessExecutionResult();
+}
+
 ExecutionResultOr<shared_ptr<Client>>
 GcpBlobStorageClientProvider::GetOrCreateCloudStroageClient(
     CloudIdentityInfo cloud_identity_info) noexcept {
@@ -1137,8 +1408,19 @@ BlobStorageClientProviderFactory::Create(
     shared_ptr<InstanceClientProviderInterface> instance_client,
     const shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
     const shared_ptr<AsyncExecutorInterface>& io_async_executor) noexcept {
-  return make_shared<GcpBlobStorageClientProvider>(
-      options, instance_client, cpu_async_executor, io_async_executor);
+  shared_ptr<BlobStorageClientProviderInterface> provider;
+  if (options && !options->local_root_directory.empty()) {
+    provider = make_shared<LocalBlobStorageClientProvider>(
+        options, cpu_async_executor, io_async_executor);
+  } else {
+    provider = make_shared<GcpBlobStorageClientProvider>(
+        options, instance_client, cpu_async_executor, io_async_executor);
+  }
+  if (options && !options->cache_directory.empty()) {
+    return make_shared<CachingBlobStorageClientProvider>(options, provider,
+                                                         io_async_executor);
+  }
+  return provider;
 }
 #endif
 }  // namespace google::scp::cpio::client_providers
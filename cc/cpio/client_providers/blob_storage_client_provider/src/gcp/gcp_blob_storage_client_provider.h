@@ -20,12 +20,15 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "core/common/auto_expiry_concurrent_map/src/auto_expiry_concurrent_map.h"
 #include "core/interface/async_context.h"
 #include "core/interface/async_executor_interface.h"
 #include "core/interface/config_provider_interface.h"
 #include "core/interface/streaming_context.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/adaptive_chunk_sizer.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
 #include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
@@ -84,6 +87,12 @@ class GcpBlobStorageClientProvider : public BlobStorageClientProviderInterface {
           cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
           list_blobs_context) noexcept override;
 
+  void ListAllBlobsMetadata(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>&
+          list_all_blobs_context) noexcept override;
+
   void PutBlob(
       core::AsyncContext<cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
                          cmrt::sdk::blob_storage_service::v1::PutBlobResponse>&
@@ -100,6 +109,11 @@ class GcpBlobStorageClientProvider : public BlobStorageClientProviderInterface {
                   cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&
                       delete_blob_context) noexcept override;
 
+  void DeleteBlobs(core::AsyncContext<
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+                       delete_blobs_context) noexcept override;
+
   core::ExecutionResultOr<std::unique_ptr<std::istream>> GetBlobStreamSync(
       const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
           blob_identity) noexcept override;
@@ -129,6 +143,9 @@ class GcpBlobStorageClientProvider : public BlobStorageClientProviderInterface {
     uint64_t last_end_byte_index = -1;
     // How many bytes remain to be read out of stream.
     size_t remaining_bytes_count = 0;
+    // Picks the size of each read, if the request asks for adaptive
+    // responses.
+    std::optional<AdaptiveChunkSizer> chunk_sizer;
   };
 
   // Starts a GetBlobStream read and returns the associated tracker.
@@ -158,6 +175,19 @@ class GcpBlobStorageClientProvider : public BlobStorageClientProviderInterface {
           get_blob_stream_context,
       std::shared_ptr<GetBlobStreamTracker> tracker) noexcept;
 
+  /**
+   * @brief Reads the blob of the get blob stream context with up to
+   * get_blob_stream_parallelism ranged ReadObject calls in flight on the IO
+   * executor.
+   *
+   * @param get_blob_stream_context The get blob stream context object.
+   */
+  void GetBlobStreamInParallel(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>
+          get_blob_stream_context) noexcept;
+
   /**
    * @brief Is called when objects are list and returned from the Cloud Storage
    * ListObjects callback.
@@ -233,6 +263,34 @@ class GcpBlobStorageClientProvider : public BlobStorageClientProviderInterface {
           cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>
           delete_blob_context) noexcept;
 
+  /**
+   * @brief Deletes a batch of blobs of a DeleteBlobs. The client has no batch
+   * requests, so each blob is deleted by its own IO task, all at once.
+   *
+   * @param cloud_identity_info The cloud identity info of the request.
+   * @param bucket_name The bucket of the blobs.
+   * @param blob_names The names of the blobs.
+   * @param callback Is called with the result of each blob once all of them
+   * are done.
+   */
+  void DeleteObjects(
+      const cmrt::sdk::common::v1::CloudIdentityInfo& cloud_identity_info,
+      const std::string& bucket_name,
+      const std::vector<std::string>& blob_names,
+      BatchBlobDeleter::DeleteBatchCallback callback) noexcept;
+
+  /**
+   * @brief Deletes a single blob of a batch with Cloud Storage DeleteObject.
+   *
+   * @param cloud_identity_info The cloud identity info of the request.
+   * @param bucket_name The bucket of the blob.
+   * @param blob_name The name of the blob.
+   * @return core::ExecutionResult The result of deleting the blob.
+   */
+  core::ExecutionResult DeleteObject(
+      const cmrt::sdk::common::v1::CloudIdentityInfo& cloud_identity_info,
+      const std::string& bucket_name, const std::string& blob_name) noexcept;
+
   /**
    * @brief Creates a gcs client for a request that contains
    * CloudIdentityInfo or get the default client.
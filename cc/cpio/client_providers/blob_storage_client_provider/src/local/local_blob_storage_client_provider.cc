@@ -0,0 +1,893 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "local_blob_storage_client_provider.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/util/time_util.h>
+
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/uuid/src/uuid.h"
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_blob_lister.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::BlobIdentity;
+using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::protobuf::util::TimeUtil;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::FinishContext;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
+using google::scp::cpio::client_providers::LocalBlobStorageClientUtils;
+using google::scp::cpio::client_providers::MappedBlobRange;
+using std::bind;
+using std::error_code;
+using std::ifstream;
+using std::ios_base;
+using std::istream;
+using std::make_shared;
+using std::make_unique;
+using std::min;
+using std::move;
+using std::nullopt;
+using std::optional;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::minutes;
+using std::chrono::nanoseconds;
+using std::filesystem::create_directories;
+using std::filesystem::exists;
+using std::filesystem::recursive_directory_iterator;
+using std::placeholders::_1;
+using std::placeholders::_2;
+using std::placeholders::_3;
+
+namespace {
+constexpr char kLocalBlobStorageClientProvider[] =
+    "LocalBlobStorageClientProvider";
+// Temporary blob files are kept apart from the buckets, whose names cannot
+// start with a '.'.
+constexpr char kTempDirectoryName[] = "/.tmp";
+constexpr size_t kListBlobsMetadataMaxResults = 1000;
+// The max number of files of a DeleteBlobs deleted by one IO task.
+constexpr size_t kDeleteBlobsBatchSize = 100;
+constexpr size_t k64KbCount = 64 << 10;
+constexpr nanoseconds kDefaultStreamKeepaliveNanos =
+    duration_cast<nanoseconds>(minutes(5));
+constexpr nanoseconds kMaximumStreamKeepaliveNanos =
+    duration_cast<nanoseconds>(minutes(10));
+// Writing a portion only takes as long as copying it to the page cache, so
+// check for the next one much sooner than the cloud providers do.
+constexpr milliseconds kPutBlobRescanTime = milliseconds(10);
+
+// Maps the range of the blob file which a GetBlob or GetBlobStream request
+// asks for.
+template <typename Request>
+ExecutionResultOr<shared_ptr<MappedBlobRange>> MapRequestedRange(
+    const string& root_directory, const Request& request) noexcept {
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      root_directory, request.blob_metadata());
+  if (!blob_path_or.Successful()) {
+    return blob_path_or.result();
+  }
+  return MappedBlobRange::Map(
+      *blob_path_or, request.byte_range().begin_byte_index(),
+      request.has_byte_range()
+          ? optional<uint64_t>(request.byte_range().end_byte_index())
+          : nullopt);
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+ExecutionResult LocalBlobStorageClientProvider::Init() noexcept {
+  if (!options_ || options_->local_root_directory.empty()) {
+    auto result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR(kLocalBlobStorageClientProvider, kZeroUuid, result,
+              "The local root directory is not set.");
+    return result;
+  }
+  temp_directory_ = options_->local_root_directory + kTempDirectoryName;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LocalBlobStorageClientProvider::Run() noexcept {
+  error_code error;
+  create_directories(temp_directory_, error);
+  if (error) {
+    auto result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+    SCP_ERROR(kLocalBlobStorageClientProvider, kZeroUuid, result,
+              "Failed to create the directory %s. Message: %s.",
+              temp_directory_.c_str(), error.message().c_str());
+    return result;
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LocalBlobStorageClientProvider::Stop() noexcept {
+  return SuccessExecutionResult();
+}
+
+void LocalBlobStorageClientProvider::GetBlob(
+    AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context) noexcept {
+  const auto& request = *get_blob_context.request;
+  if (request.blob_metadata().bucket_name().empty() ||
+      request.blob_metadata().blob_name().empty()) {
+    get_blob_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_context,
+                      get_blob_context.result,
+                      "Get blob request is missing bucket or blob name");
+    get_blob_context.Finish();
+    return;
+  }
+  if (request.has_byte_range() && request.byte_range().begin_byte_index() >
+                                      request.byte_range().end_byte_index()) {
+    get_blob_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, get_blob_context,
+        get_blob_context.result,
+        "Get blob request provides begin_byte_index that is larger "
+        "than end_byte_index");
+    get_blob_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::GetBlobInternal, this,
+               get_blob_context),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    get_blob_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_context,
+                      get_blob_context.result,
+                      "Get blob request failed to be scheduled");
+    get_blob_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::GetBlobInternal(
+    AsyncContext<GetBlobRequest, GetBlobResponse> get_blob_context) noexcept {
+  const auto& request = *get_blob_context.request;
+  auto range_or = MapRequestedRange(options_->local_root_directory, request);
+  if (!range_or.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_context,
+                      range_or.result(), "Get blob request failed.");
+    FinishContext(range_or.result(), get_blob_context, cpu_async_executor_);
+    return;
+  }
+  const auto& range = **range_or;
+
+  get_blob_context.response = make_shared<GetBlobResponse>();
+  get_blob_context.response->mutable_blob()->mutable_metadata()->CopyFrom(
+      request.blob_metadata());
+  get_blob_context.response->set_etag(range.etag());
+  if (request.has_if_none_match_etag() &&
+      request.if_none_match_etag() == range.etag()) {
+    get_blob_context.response->set_not_modified(true);
+    FinishContext(SuccessExecutionResult(), get_blob_context,
+                  cpu_async_executor_);
+    return;
+  }
+  // The bytes are copied straight out of the page cache, without reading them
+  // into a buffer first.
+  get_blob_context.response->mutable_blob()->mutable_data()->assign(
+      range.data(), range.size());
+  FinishContext(SuccessExecutionResult(), get_blob_context,
+                cpu_async_executor_);
+}
+
+void LocalBlobStorageClientProvider::GetBlobStream(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
+        get_blob_stream_context) noexcept {
+  const auto& request = *get_blob_stream_context.request;
+  if (request.blob_metadata().bucket_name().empty() ||
+      request.blob_metadata().blob_name().empty()) {
+    get_blob_stream_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_stream_context,
+                      get_blob_stream_context.result,
+                      "Get blob stream request is missing bucket or blob name");
+    get_blob_stream_context.MarkDone();
+    get_blob_stream_context.Finish();
+    return;
+  }
+  if (request.has_byte_range() && request.byte_range().begin_byte_index() >
+                                      request.byte_range().end_byte_index()) {
+    get_blob_stream_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, get_blob_stream_context,
+        get_blob_stream_context.result,
+        "Get blob stream request provides begin_byte_index that is larger "
+        "than end_byte_index");
+    get_blob_stream_context.MarkDone();
+    get_blob_stream_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::GetBlobStreamInternal, this,
+               get_blob_stream_context, nullptr /*range*/, 0 /*next_offset*/),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    get_blob_stream_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_stream_context,
+                      get_blob_stream_context.result,
+                      "Get blob stream request failed to be scheduled");
+    get_blob_stream_context.MarkDone();
+    get_blob_stream_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::GetBlobStreamInternal(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+        get_blob_stream_context,
+    shared_ptr<MappedBlobRange> range, size_t next_offset) noexcept {
+  const auto& request = *get_blob_stream_context.request;
+  if (!range) {
+    auto range_or = MapRequestedRange(options_->local_root_directory, request);
+    if (!range_or.Successful()) {
+      SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider,
+                        get_blob_stream_context, range_or.result(),
+                        "Get blob stream request failed.");
+      FinishStreamingContext(range_or.result(), get_blob_stream_context,
+                             cpu_async_executor_);
+      return;
+    }
+    range = move(*range_or);
+  }
+  if (get_blob_stream_context.IsCancelled()) {
+    auto result = FailureExecutionResult(
+        SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_stream_context,
+                      result, "Get blob stream request was cancelled.");
+    FinishStreamingContext(result, get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+  if (next_offset == range->size()) {
+    // Only an empty blob has nothing to return on the first call.
+    FinishStreamingContext(SuccessExecutionResult(), get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  // If max_bytes_per_response is provided, use it. Otherwise use 64KB.
+  size_t read_size = request.max_bytes_per_response() == 0
+                         ? k64KbCount
+                         : request.max_bytes_per_response();
+  read_size = min(read_size, range->size() - next_offset);
+  GetBlobStreamResponse response;
+  response.mutable_blob_portion()->mutable_metadata()->CopyFrom(
+      request.blob_metadata());
+  response.mutable_byte_range()->set_begin_byte_index(
+      range->begin_byte_index() + next_offset);
+  response.mutable_byte_range()->set_end_byte_index(
+      range->begin_byte_index() + next_offset + read_size - 1);
+  response.mutable_blob_portion()->mutable_data()->assign(
+      range->data() + next_offset, read_size);
+  next_offset += read_size;
+
+  auto push_result = get_blob_stream_context.TryPushResponse(move(response));
+  if (!push_result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_stream_context,
+                      push_result, "Failed to push new message.");
+    FinishStreamingContext(push_result, get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  // Schedule processing the next message.
+  auto schedule_result = cpu_async_executor_->Schedule(
+      [get_blob_stream_context]() mutable {
+        get_blob_stream_context.ProcessNextMessage();
+      },
+      AsyncPriority::Normal);
+  if (!schedule_result.Successful()) {
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, get_blob_stream_context,
+        schedule_result,
+        "Get blob stream process next message failed to be scheduled");
+    FinishStreamingContext(schedule_result, get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  if (next_offset == range->size()) {
+    FinishStreamingContext(SuccessExecutionResult(), get_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  // Schedule reading the next section.
+  schedule_result = io_async_executor_->Schedule(
+      bind(&LocalBlobStorageClientProvider::GetBlobStreamInternal, this,
+           get_blob_stream_context, move(range), next_offset),
+      AsyncPriority::Normal);
+  if (!schedule_result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, get_blob_stream_context,
+                      schedule_result,
+                      "Get blob stream follow up read failed to be scheduled");
+    FinishStreamingContext(schedule_result, get_blob_stream_context,
+                           cpu_async_executor_);
+  }
+}
+
+void LocalBlobStorageClientProvider::ListBlobsMetadata(
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+        list_blobs_context) noexcept {
+  const auto& request = *list_blobs_context.request;
+  if (request.blob_metadata().bucket_name().empty()) {
+    list_blobs_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, list_blobs_context,
+                      list_blobs_context.result,
+                      "List blobs metadata request failed. Bucket name empty.");
+    list_blobs_context.Finish();
+    return;
+  }
+  if (request.has_max_page_size() &&
+      request.max_page_size() > kListBlobsMetadataMaxResults) {
+    list_blobs_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, list_blobs_context,
+        list_blobs_context.result,
+        "List blobs metadata request failed. Max page size cannot be "
+        "greater than 1000.");
+    list_blobs_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::ListBlobsMetadataInternal,
+               this, list_blobs_context),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    list_blobs_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, list_blobs_context,
+                      list_blobs_context.result,
+                      "List blobs metadata request failed to be scheduled");
+    list_blobs_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::ListBlobsMetadataInternal(
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>
+        list_blobs_context) noexcept {
+  const auto& request = *list_blobs_context.request;
+  auto bucket_path_or = LocalBlobStorageClientUtils::GetBucketPath(
+      options_->local_root_directory, request.blob_metadata().bucket_name());
+  if (!bucket_path_or.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, list_blobs_context,
+                      bucket_path_or.result(),
+                      "List blobs metadata request has an invalid bucket.");
+    FinishContext(bucket_path_or.result(), list_blobs_context,
+                  cpu_async_executor_);
+    return;
+  }
+  const auto& bucket_path = *bucket_path_or;
+  error_code error;
+  if (!exists(bucket_path, error)) {
+    auto result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, list_blobs_context,
+                      result, "List blobs metadata request failed. Bucket %s "
+                      "does not exist.", bucket_path.c_str());
+    FinishContext(result, list_blobs_context, cpu_async_executor_);
+    return;
+  }
+
+  // Only the directory of the prefix can have blobs which start with it.
+  const auto& prefix = request.blob_metadata().blob_name();
+  auto prefix_directory_length = prefix.rfind('/');
+  auto start_path =
+      prefix_directory_length == string::npos
+          ? bucket_path
+          : bucket_path + "/" + prefix.substr(0, prefix_directory_length);
+  vector<string> blob_names;
+  if (exists(start_path, error)) {
+    for (recursive_directory_iterator it(start_path, error), end;
+         !error && it != end; it.increment(error)) {
+      auto blob_name = it->path().string().substr(bucket_path.size() + 1);
+      if (it->is_directory(error)) {
+        // Skip the directories which cannot have blobs with the prefix.
+        auto directory_prefix = blob_name + "/";
+        auto length = min(directory_prefix.size(), prefix.size());
+        if (directory_prefix.compare(0, length, prefix, 0, length) != 0) {
+          it.disable_recursion_pending();
+        }
+        continue;
+      }
+      if (it->is_regular_file(error) &&
+          blob_name.compare(0, prefix.size(), prefix) == 0 &&
+          (!request.has_page_token() || blob_name > request.page_token())) {
+        blob_names.push_back(move(blob_name));
+      }
+    }
+  }
+  if (error) {
+    auto result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, list_blobs_context,
+                      result,
+                      "List blobs metadata request failed. Message: %s.",
+                      error.message().c_str());
+    FinishContext(result, list_blobs_context, cpu_async_executor_);
+    return;
+  }
+
+  // The page token is the last blob name of the previous page, and blob names
+  // are returned in order like in the cloud.
+  size_t max_page_size = request.has_max_page_size() &&
+                                 request.max_page_size() > 0
+                             ? request.max_page_size()
+                             : kListBlobsMetadataMaxResults;
+  auto page_size = min(max_page_size, blob_names.size());
+  std::partial_sort(blob_names.begin(), blob_names.begin() + page_size,
+                    blob_names.end());
+  list_blobs_context.response = make_shared<ListBlobsMetadataResponse>();
+  for (size_t i = 0; i < page_size; ++i) {
+    BlobMetadata blob_metadata;
+    blob_metadata.set_bucket_name(request.blob_metadata().bucket_name());
+    blob_metadata.set_blob_name(move(blob_names[i]));
+    *list_blobs_context.response->add_blob_metadatas() = move(blob_metadata);
+  }
+  if (page_size < blob_names.size()) {
+    list_blobs_context.response->set_next_page_token(
+        list_blobs_context.response->blob_metadatas().rbegin()->blob_name());
+  }
+  FinishContext(SuccessExecutionResult(), list_blobs_context,
+                cpu_async_executor_);
+}
+
+void LocalBlobStorageClientProvider::ListAllBlobsMetadata(
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>&
+        list_all_blobs_context) noexcept {
+  // The lister checks the request before any page is listed.
+  make_shared<ParallelBlobLister>(
+      list_all_blobs_context,
+      [this](AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+                 list_blobs_context) { ListBlobsMetadata(list_blobs_context); },
+      options_->list_all_blobs_parallelism, cpu_async_executor_)
+      ->Start();
+}
+
+void LocalBlobStorageClientProvider::PutBlob(
+    AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) noexcept {
+  const auto& request = *put_blob_context.request;
+  if (request.blob().metadata().bucket_name().empty() ||
+      request.blob().metadata().blob_name().empty() ||
+      request.blob().data().empty()) {
+    put_blob_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_context,
+                      put_blob_context.result,
+                      "Put blob request failed. Ensure that bucket name, blob "
+                      "name, and data are present.");
+    put_blob_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::PutBlobInternal, this,
+               put_blob_context),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    put_blob_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_context,
+                      put_blob_context.result,
+                      "Put blob request failed to be scheduled");
+    put_blob_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::PutBlobInternal(
+    AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context) noexcept {
+  const auto& request = *put_blob_context.request;
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      options_->local_root_directory, request.blob().metadata());
+  if (!blob_path_or.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_context,
+                      blob_path_or.result(),
+                      "Put blob request has an invalid bucket or blob name.");
+    FinishContext(blob_path_or.result(), put_blob_context,
+                  cpu_async_executor_);
+    return;
+  }
+  auto writer_or = BlobFileWriter::Create(temp_directory_);
+  auto result = writer_or.result();
+  if (writer_or.Successful()) {
+    result = (*writer_or)->Append(request.blob().data());
+  }
+  if (result.Successful()) {
+    result = (*writer_or)->Commit(*blob_path_or);
+  }
+  if (!result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_context,
+                      result, "Put blob request failed. Path: %s.",
+                      blob_path_or->c_str());
+    FinishContext(result, put_blob_context, cpu_async_executor_);
+    return;
+  }
+  put_blob_context.response = make_shared<PutBlobResponse>();
+  FinishContext(SuccessExecutionResult(), put_blob_context,
+                cpu_async_executor_);
+}
+
+void LocalBlobStorageClientProvider::PutBlobStream(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
+        put_blob_stream_context) noexcept {
+  const auto& request = *put_blob_stream_context.request;
+  if (request.blob_portion().metadata().bucket_name().empty() ||
+      request.blob_portion().metadata().blob_name().empty() ||
+      request.blob_portion().data().empty()) {
+    put_blob_stream_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, put_blob_stream_context,
+        put_blob_stream_context.result,
+        "Put blob stream request failed. Ensure that bucket name, blob "
+        "name, and data are present.");
+    put_blob_stream_context.MarkDone();
+    put_blob_stream_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::InitPutBlobStream, this,
+               put_blob_stream_context),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    put_blob_stream_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      put_blob_stream_context.result,
+                      "Put blob stream request failed to be scheduled");
+    put_blob_stream_context.MarkDone();
+    put_blob_stream_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::InitPutBlobStream(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+        put_blob_stream_context) noexcept {
+  const auto& request = *put_blob_stream_context.request;
+  auto duration = request.has_stream_keepalive_duration()
+                      ? nanoseconds(TimeUtil::DurationToNanoseconds(
+                            request.stream_keepalive_duration()))
+                      : kDefaultStreamKeepaliveNanos;
+  if (duration > kMaximumStreamKeepaliveNanos) {
+    auto result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, put_blob_stream_context, result,
+        "Supplied keepalive duration is greater than the maximum of "
+        "10 minutes.");
+    FinishStreamingContext(result, put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      options_->local_root_directory, request.blob_portion().metadata());
+  if (!blob_path_or.Successful()) {
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, put_blob_stream_context,
+        blob_path_or.result(),
+        "Put blob stream request has an invalid bucket or blob name.");
+    FinishStreamingContext(blob_path_or.result(), put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+  auto writer_or = BlobFileWriter::Create(temp_directory_);
+  auto result = writer_or.result();
+  if (writer_or.Successful()) {
+    // Write the initial data from the first request.
+    result = (*writer_or)->Append(request.blob_portion().data());
+  }
+  if (!result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      result, "Put blob stream request failed to write.");
+    FinishStreamingContext(result, put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  auto tracker = make_shared<PutBlobStreamTracker>();
+  tracker->writer = move(*writer_or);
+  tracker->blob_path = move(*blob_path_or);
+  tracker->expiry_time_ns =
+      TimeProvider::GetWallTimestampInNanoseconds() + duration;
+  PutBlobStreamInternal(put_blob_stream_context, tracker);
+}
+
+void LocalBlobStorageClientProvider::PutBlobStreamInternal(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+        put_blob_stream_context,
+    shared_ptr<PutBlobStreamTracker> tracker) noexcept {
+  // Dropping the tracker on failure removes the temporary file.
+  if (put_blob_stream_context.IsCancelled()) {
+    auto result = FailureExecutionResult(
+        SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      result, "Put blob stream request was cancelled");
+    FinishStreamingContext(result, put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+
+  // If there's no message, schedule again. If there's a message - write it.
+  auto request = put_blob_stream_context.TryGetNextRequest();
+  if (request == nullptr) {
+    if (put_blob_stream_context.IsMarkedDone()) {
+      // We've processed all messages and there won't be any more.
+      auto result = tracker->writer->Commit(tracker->blob_path);
+      if (!result.Successful()) {
+        SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider,
+                          put_blob_stream_context, result,
+                          "Put blob stream request failed to commit %s.",
+                          tracker->blob_path.c_str());
+      }
+      put_blob_stream_context.response = make_shared<PutBlobStreamResponse>();
+      FinishStreamingContext(result, put_blob_stream_context,
+                             cpu_async_executor_);
+      return;
+    }
+    // If this session expired, cancel the upload and finish.
+    if (TimeProvider::GetWallTimestampInNanoseconds() >=
+        tracker->expiry_time_ns) {
+      auto result = FailureExecutionResult(
+          SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED);
+      SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider,
+                        put_blob_stream_context, result,
+                        "Put blob stream session expired.");
+      FinishStreamingContext(result, put_blob_stream_context,
+                             cpu_async_executor_);
+      return;
+    }
+    // Schedule checking for a new message.
+    auto schedule_result = io_async_executor_->ScheduleFor(
+        bind(&LocalBlobStorageClientProvider::PutBlobStreamInternal, this,
+             put_blob_stream_context, tracker),
+        (TimeProvider::GetSteadyTimestampInNanoseconds() + kPutBlobRescanTime)
+            .count());
+    if (!schedule_result.Successful()) {
+      SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider,
+                        put_blob_stream_context, schedule_result,
+                        "Put blob stream request failed to be scheduled");
+      FinishStreamingContext(schedule_result, put_blob_stream_context,
+                             cpu_async_executor_);
+    }
+    return;
+  }
+  // Validate that the new request specifies the same blob.
+  const auto& first_metadata =
+      put_blob_stream_context.request->blob_portion().metadata();
+  if (request->blob_portion().metadata().bucket_name() !=
+          first_metadata.bucket_name() ||
+      request->blob_portion().metadata().blob_name() !=
+          first_metadata.blob_name()) {
+    auto result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      result,
+                      "Enqueued message does not specify the same blob (bucket "
+                      "name, blob name) as previously.");
+    FinishStreamingContext(result, put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+  auto result = tracker->writer->Append(request->blob_portion().data());
+  if (!result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      result, "Put blob stream request failed to write.");
+    FinishStreamingContext(result, put_blob_stream_context,
+                           cpu_async_executor_);
+    return;
+  }
+  // Schedule writing the next portion.
+  auto schedule_result = io_async_executor_->Schedule(
+      bind(&LocalBlobStorageClientProvider::PutBlobStreamInternal, this,
+           put_blob_stream_context, tracker),
+      AsyncPriority::Normal);
+  if (!schedule_result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, put_blob_stream_context,
+                      schedule_result,
+                      "Put blob stream request failed to be scheduled");
+    FinishStreamingContext(schedule_result, put_blob_stream_context,
+                           cpu_async_executor_);
+  }
+}
+
+void LocalBlobStorageClientProvider::DeleteBlob(
+    AsyncContext<DeleteBlobRequest, DeleteBlobResponse>&
+        delete_blob_context) noexcept {
+  const auto& request = *delete_blob_context.request;
+  if (request.blob_metadata().bucket_name().empty() ||
+      request.blob_metadata().blob_name().empty()) {
+    delete_blob_context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    SCP_ERROR_CONTEXT(
+        kLocalBlobStorageClientProvider, delete_blob_context,
+        delete_blob_context.result,
+        "Delete blob request failed. Missing bucket or blob name.");
+    delete_blob_context.Finish();
+    return;
+  }
+
+  if (auto schedule_result = io_async_executor_->Schedule(
+          bind(&LocalBlobStorageClientProvider::DeleteBlobInternal, this,
+               delete_blob_context),
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    delete_blob_context.result = schedule_result;
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, delete_blob_context,
+                      delete_blob_context.result,
+                      "Delete blob request failed to be scheduled");
+    delete_blob_context.Finish();
+  }
+}
+
+void LocalBlobStorageClientProvider::DeleteBlobInternal(
+    AsyncContext<DeleteBlobRequest, DeleteBlobResponse>
+        delete_blob_context) noexcept {
+  auto result = DeleteBlobFile(delete_blob_context.request->blob_metadata());
+  if (!result.Successful()) {
+    SCP_ERROR_CONTEXT(kLocalBlobStorageClientProvider, delete_blob_context,
+                      result, "Delete blob request failed.");
+    FinishContext(result, delete_blob_context, cpu_async_executor_);
+    return;
+  }
+  delete_blob_context.response = make_shared<DeleteBlobResponse>();
+  FinishContext(SuccessExecutionResult(), delete_blob_context,
+                cpu_async_executor_);
+}
+
+ExecutionResult LocalBlobStorageClientProvider::DeleteBlobFile(
+    const BlobMetadata& blob_metadata) noexcept {
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      options_->local_root_directory, blob_metadata);
+  if (!blob_path_or.Successful()) {
+    return blob_path_or.result();
+  }
+  if (unlink(blob_path_or->c_str()) != 0) {
+    return FailureExecutionResult(
+        errno == ENOENT || errno == ENOTDIR || errno == EISDIR
+            ? SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND
+            : SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  return SuccessExecutionResult();
+}
+
+void LocalBlobStorageClientProvider::DeleteBlobs(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+        delete_blobs_context) noexcept {
+  make_shared<BatchBlobDeleter>(
+      delete_blobs_context,
+      bind(&LocalBlobStorageClientProvider::DeleteBlobFiles, this, _1, _2, _3),
+      kDeleteBlobsBatchSize,
+      options_ ? options_->delete_blobs_parallelism : 1, cpu_async_executor_)
+      ->Start();
+}
+
+void LocalBlobStorageClientProvider::DeleteBlobFiles(
+    const string& bucket_name, const vector<string>& blob_names,
+    BatchBlobDeleter::DeleteBatchCallback callback) noexcept {
+  if (auto schedule_result = io_async_executor_->Schedule(
+          [this, bucket_name, blob_names, callback]() {
+            BlobMetadata blob_metadata;
+            blob_metadata.set_bucket_name(bucket_name);
+            vector<ExecutionResult> results;
+            for (const auto& blob_name : blob_names) {
+              blob_metadata.set_blob_name(blob_name);
+              results.push_back(DeleteBlobFile(blob_metadata));
+            }
+            callback(move(results));
+          },
+          AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    SCP_ERROR(kLocalBlobStorageClientProvider, kZeroUuid, schedule_result,
+              "Delete blobs request failed to be scheduled");
+    callback(vector<ExecutionResult>(blob_names.size(), schedule_result));
+  }
+}
+
+ExecutionResultOr<unique_ptr<istream>>
+LocalBlobStorageClientProvider::GetBlobStreamSync(
+    const BlobIdentity& blob_identity) noexcept {
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      options_->local_root_directory, blob_identity.blob_metadata());
+  if (!blob_path_or.Successful()) {
+    return blob_path_or.result();
+  }
+  auto stream = make_unique<ifstream>(*blob_path_or, ios_base::binary);
+  if (!stream->is_open()) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND);
+  }
+  return stream;
+}
+
+ExecutionResultOr<unique_ptr<ostream>>
+LocalBlobStorageClientProvider::PutBlobStreamSync(
+    const BlobIdentity& blob_identity) noexcept {
+  auto blob_path_or = LocalBlobStorageClientUtils::GetBlobPath(
+      options_->local_root_directory, blob_identity.blob_metadata());
+  if (!blob_path_or.Successful()) {
+    return blob_path_or.result();
+  }
+  auto stream_or =
+      BlobFileOutputStream::Create(temp_directory_, move(*blob_path_or));
+  if (!stream_or.Successful()) {
+    return stream_or.result();
+  }
+  return unique_ptr<ostream>(move(*stream_or));
+}
+}  // namespace google::scp::cpio::client_providers
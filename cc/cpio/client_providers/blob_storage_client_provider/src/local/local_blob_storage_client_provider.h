@@ -0,0 +1,235 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/streaming_context.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
+#include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
+#include "public/cpio/interface/blob_storage_client/type_def.h"
+
+#include "local_blob_storage_client_utils.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @copydoc BlobStorageClientProviderInterface
+ *
+ * Keeps blobs as files under BlobStorageClientOptions::local_root_directory,
+ * with a directory per bucket and the '/'s of blob names as directories.
+ * Blobs are read through mappings of their files, and written to temporary
+ * files which are renamed over them once complete, so readers never see a
+ * partially written blob.
+ */
+class LocalBlobStorageClientProvider
+    : public BlobStorageClientProviderInterface {
+ public:
+  LocalBlobStorageClientProvider(
+      std::shared_ptr<BlobStorageClientOptions> options,
+      const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
+      const std::shared_ptr<core::AsyncExecutorInterface>& io_async_executor)
+      : options_(options),
+        cpu_async_executor_(cpu_async_executor),
+        io_async_executor_(io_async_executor) {}
+
+  core::ExecutionResult Init() noexcept override;
+  core::ExecutionResult Run() noexcept override;
+  core::ExecutionResult Stop() noexcept override;
+
+  void GetBlob(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::GetBlobResponse>&
+          get_blob_context) noexcept override;
+
+  void GetBlobStream(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
+          get_blob_stream_context) noexcept override;
+
+  void ListBlobsMetadata(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
+          list_blobs_context) noexcept override;
+
+  void ListAllBlobsMetadata(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>&
+          list_all_blobs_context) noexcept override;
+
+  void PutBlob(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::PutBlobResponse>&
+          put_blob_context) noexcept override;
+
+  void PutBlobStream(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
+          put_blob_stream_context) noexcept override;
+
+  void DeleteBlob(core::AsyncContext<
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest,
+                  cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&
+                      delete_blob_context) noexcept override;
+
+  void DeleteBlobs(core::AsyncContext<
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+                       delete_blobs_context) noexcept override;
+
+  core::ExecutionResultOr<std::unique_ptr<std::istream>> GetBlobStreamSync(
+      const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
+          blob_identity) noexcept override;
+
+  core::ExecutionResultOr<std::unique_ptr<std::ostream>> PutBlobStreamSync(
+      const cmrt::sdk::blob_storage_service::v1::BlobIdentity&
+          blob_identity) noexcept override;
+
+ private:
+  /**
+   * @brief Copies the requested range of the mapped blob file into the
+   * response.
+   *
+   * @param get_blob_context The get blob context object.
+   */
+  void GetBlobInternal(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::GetBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::GetBlobResponse>
+          get_blob_context) noexcept;
+
+  /**
+   * @brief Pushes the next response of the get blob stream, sliced out of the
+   * mapped range, and schedules pushing the one after it. The range is mapped
+   * on the first call.
+   *
+   * @param get_blob_stream_context The get blob stream context object.
+   * @param range The mapped range of the blob to return.
+   * @param next_offset The offset in range of the next response.
+   */
+  void GetBlobStreamInternal(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>
+          get_blob_stream_context,
+      std::shared_ptr<MappedBlobRange> range, size_t next_offset) noexcept;
+
+  /**
+   * @brief Lists a page of the blob files of the bucket directory.
+   *
+   * @param list_blobs_context The list blobs context object.
+   */
+  void ListBlobsMetadataInternal(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>
+          list_blobs_context) noexcept;
+
+  /**
+   * @brief Writes the blob to a temporary file and renames it over the blob
+   * file.
+   *
+   * @param put_blob_context The put blob context object.
+   */
+  void PutBlobInternal(
+      core::AsyncContext<cmrt::sdk::blob_storage_service::v1::PutBlobRequest,
+                         cmrt::sdk::blob_storage_service::v1::PutBlobResponse>
+          put_blob_context) noexcept;
+
+  // Housekeeping object for tracking the progress of a single PutBlobStream.
+  struct PutBlobStreamTracker {
+    // The temporary file the blob is written to.
+    std::unique_ptr<BlobFileWriter> writer;
+    // The path the blob file is renamed to once complete.
+    std::string blob_path;
+    // Timestamp in nanoseconds of when this PutBlobStream session should
+    // expire.
+    std::chrono::nanoseconds expiry_time_ns = std::chrono::nanoseconds::min();
+  };
+
+  void InitPutBlobStream(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>
+          put_blob_stream_context) noexcept;
+
+  /**
+   * @brief Writes the data of the next request of the put blob stream, or
+   * commits the blob file once the stream is done.
+   *
+   * @param put_blob_stream_context The put blob stream context object.
+   * @param tracker The tracker for this specific upload.
+   */
+  void PutBlobStreamInternal(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>
+          put_blob_stream_context,
+      std::shared_ptr<PutBlobStreamTracker> tracker) noexcept;
+
+  /**
+   * @brief Removes the blob file.
+   *
+   * @param delete_blob_context The delete blob context object.
+   */
+  void DeleteBlobInternal(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest,
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>
+          delete_blob_context) noexcept;
+
+  /**
+   * @brief Deletes the file of a blob.
+   *
+   * @param blob_metadata The blob.
+   * @return core::ExecutionResult The result of deleting the file.
+   */
+  core::ExecutionResult DeleteBlobFile(
+      const cmrt::sdk::blob_storage_service::v1::BlobMetadata&
+          blob_metadata) noexcept;
+
+  /**
+   * @brief Deletes the files of a batch of blobs of a DeleteBlobs, one after
+   * another on an IO thread.
+   *
+   * @param bucket_name The bucket of the blobs.
+   * @param blob_names The names of the blobs.
+   * @param callback Is called with the result of each blob.
+   */
+  void DeleteBlobFiles(
+      const std::string& bucket_name,
+      const std::vector<std::string>& blob_names,
+      BatchBlobDeleter::DeleteBatchCallback callback) noexcept;
+
+  std::shared_ptr<BlobStorageClientOptions> options_;
+
+  /// The directory temporary blob files are written to, under the root
+  /// directory so they can be renamed over the blob files.
+  std::string temp_directory_;
+
+  /// An instance of the async executor.
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_,
+      io_async_executor_;
+};
+}  // namespace google::scp::cpio::client_providers
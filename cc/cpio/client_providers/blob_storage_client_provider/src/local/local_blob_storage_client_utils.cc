@@ -0,0 +1,273 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "local_blob_storage_client_utils.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR;
+using std::error_code;
+using std::ios_base;
+using std::min;
+using std::move;
+using std::optional;
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::filesystem::create_directories;
+using std::filesystem::path;
+
+namespace {
+constexpr char kTempFileTemplate[] = "/blob.XXXXXX";
+constexpr mode_t kBlobFileMode = 0644;
+
+// Creates a new empty file in temp_directory and opens it for writing.
+ExecutionResultOr<pair<int, string>> CreateTempFile(
+    const string& temp_directory) noexcept {
+  string temp_path = temp_directory + kTempFileTemplate;
+  int file_descriptor = mkostemp(temp_path.data(), O_CLOEXEC);
+  if (file_descriptor < 0) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  // mkostemp only lets the owner read the file.
+  fchmod(file_descriptor, kBlobFileMode);
+  return pair<int, string>(file_descriptor, move(temp_path));
+}
+
+// Blob files are replaced by renaming new files over them, so a new version
+// of a blob is a new inode.
+string GetEtag(const struct stat& file_stat) noexcept {
+  return std::to_string(file_stat.st_ino) + "-" +
+         std::to_string(file_stat.st_mtim.tv_sec) + "." +
+         std::to_string(file_stat.st_mtim.tv_nsec) + "-" +
+         std::to_string(file_stat.st_size);
+}
+
+// Renames the temporary file to blob_path, creating the directories of
+// blob_path first.
+ExecutionResult RenameToBlobPath(const string& temp_path,
+                                 const string& blob_path) noexcept {
+  error_code error;
+  create_directories(path(blob_path).parent_path(), error);
+  if (error || rename(temp_path.c_str(), blob_path.c_str()) != 0) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  return SuccessExecutionResult();
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+ExecutionResultOr<shared_ptr<MappedBlobRange>> MappedBlobRange::Map(
+    const string& path, uint64_t begin_byte_index,
+    optional<uint64_t> end_byte_index) noexcept {
+  int file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_descriptor < 0) {
+    if (errno == ENOENT || errno == ENOTDIR) {
+      return FailureExecutionResult(
+          SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND);
+    }
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  struct stat file_stat;
+  if (fstat(file_descriptor, &file_stat) != 0) {
+    close(file_descriptor);
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  // A directory is only a prefix of other blobs.
+  if (!S_ISREG(file_stat.st_mode)) {
+    close(file_descriptor);
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND);
+  }
+  uint64_t file_size = file_stat.st_size;
+  if (begin_byte_index >= file_size) {
+    close(file_descriptor);
+    if (begin_byte_index == 0) {
+      // Empty files cannot be mapped, and have no bytes to map anyway.
+      return shared_ptr<MappedBlobRange>(
+          new MappedBlobRange(nullptr, 0, nullptr, 0, 0, GetEtag(file_stat)));
+    }
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+  }
+
+  auto last_byte_index =
+      min(end_byte_index.value_or(file_size - 1), file_size - 1);
+  size_t size = last_byte_index - begin_byte_index + 1;
+  // Mappings start at a page boundary, so the range starts within the page.
+  static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+  auto page_offset = begin_byte_index % page_size;
+  auto mapping_size = size + page_offset;
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE,
+                       file_descriptor, begin_byte_index - page_offset);
+  // The mapping keeps the file open.
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  // Ranges are read from front to back, so let the kernel read ahead.
+  madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+  return shared_ptr<MappedBlobRange>(new MappedBlobRange(
+      mapping, mapping_size, static_cast<const char*>(mapping) + page_offset,
+      size, begin_byte_index, GetEtag(file_stat)));
+}
+
+MappedBlobRange::~MappedBlobRange() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+ExecutionResultOr<unique_ptr<BlobFileWriter>> BlobFileWriter::Create(
+    const string& temp_directory) noexcept {
+  auto temp_file_or = CreateTempFile(temp_directory);
+  if (!temp_file_or.Successful()) {
+    return temp_file_or.result();
+  }
+  auto& [file_descriptor, temp_path] = *temp_file_or;
+  return unique_ptr<BlobFileWriter>(
+      new BlobFileWriter(file_descriptor, move(temp_path)));
+}
+
+BlobFileWriter::~BlobFileWriter() {
+  if (file_descriptor_ >= 0) {
+    close(file_descriptor_);
+  }
+  if (!is_committed_) {
+    unlink(temp_path_.c_str());
+  }
+}
+
+ExecutionResult BlobFileWriter::Append(const string& bytes) noexcept {
+  if (file_descriptor_ < 0) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  // A write may be cut short, so keep writing the rest.
+  for (size_t offset = 0; offset < bytes.size();) {
+    auto written = write(file_descriptor_, bytes.data() + offset,
+                         bytes.size() - offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+    }
+    offset += written;
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BlobFileWriter::Commit(const string& blob_path) noexcept {
+  if (file_descriptor_ < 0) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  auto close_result = close(file_descriptor_);
+  file_descriptor_ = -1;
+  if (close_result != 0) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  auto rename_result = RenameToBlobPath(temp_path_, blob_path);
+  if (!rename_result.Successful()) {
+    return rename_result;
+  }
+  is_committed_ = true;
+  return SuccessExecutionResult();
+}
+
+ExecutionResultOr<unique_ptr<BlobFileOutputStream>>
+BlobFileOutputStream::Create(const string& temp_directory,
+                             string blob_path) noexcept {
+  auto temp_file_or = CreateTempFile(temp_directory);
+  if (!temp_file_or.Successful()) {
+    return temp_file_or.result();
+  }
+  auto& [file_descriptor, temp_path] = *temp_file_or;
+  // The file is opened again by the stream.
+  ::close(file_descriptor);
+  auto stream = unique_ptr<BlobFileOutputStream>(
+      new BlobFileOutputStream(std::move(temp_path), std::move(blob_path)));
+  if (!stream->is_open()) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_LOCAL_FILE_ERROR);
+  }
+  return stream;
+}
+
+BlobFileOutputStream::BlobFileOutputStream(string temp_path, string blob_path)
+    : std::ofstream(temp_path, ios_base::binary | ios_base::trunc),
+      temp_path_(std::move(temp_path)),
+      blob_path_(std::move(blob_path)) {}
+
+BlobFileOutputStream::~BlobFileOutputStream() {
+  if (is_open()) {
+    close();
+  }
+  if (fail() || !RenameToBlobPath(temp_path_, blob_path_).Successful()) {
+    unlink(temp_path_.c_str());
+  }
+}
+
+ExecutionResultOr<string> LocalBlobStorageClientUtils::GetBucketPath(
+    const string& root_directory, const string& bucket_name) noexcept {
+  if (bucket_name.empty() || bucket_name.front() == '.' ||
+      bucket_name.find('/') != string::npos) {
+    return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+  }
+  return root_directory + "/" + bucket_name;
+}
+
+ExecutionResultOr<string> LocalBlobStorageClientUtils::GetBlobPath(
+    const string& root_directory,
+    const BlobMetadata& blob_metadata) noexcept {
+  auto bucket_path_or =
+      GetBucketPath(root_directory, blob_metadata.bucket_name());
+  if (!bucket_path_or.Successful()) {
+    return bucket_path_or.result();
+  }
+  const auto& blob_name = blob_metadata.blob_name();
+  // Every directory of the blob name, and the blob itself, must be a single
+  // component of the path under the bucket.
+  size_t begin = 0;
+  do {
+    auto end = min(blob_name.find('/', begin), blob_name.size());
+    auto length = end - begin;
+    if (length == 0 ||
+        (blob_name[begin] == '.' &&
+         (length == 1 || (length == 2 && blob_name[begin + 1] == '.')))) {
+      return FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    }
+    begin = end + 1;
+  } while (begin <= blob_name.size());
+  return *bucket_path_or + "/" + blob_name;
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief A byte range of a blob file mapped into memory, which is unmapped
+ * once destroyed.
+ *
+ * Blob files are only ever replaced by renaming a new file over them, so a
+ * mapped file is never truncated under its readers.
+ */
+class MappedBlobRange {
+ public:
+  /**
+   * @brief Maps the bytes of the file at path from begin_byte_index to
+   * end_byte_index, inclusive. An end past the end of the file is truncated to
+   * it, and no end maps up to the end of the file.
+   *
+   * @return The mapped range, or SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND
+   * if there is no such file, or SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS if
+   * begin_byte_index is past the end of a non-empty file.
+   */
+  static core::ExecutionResultOr<std::shared_ptr<MappedBlobRange>> Map(
+      const std::string& path, uint64_t begin_byte_index,
+      std::optional<uint64_t> end_byte_index) noexcept;
+
+  ~MappedBlobRange();
+
+  MappedBlobRange(const MappedBlobRange&) = delete;
+  MappedBlobRange& operator=(const MappedBlobRange&) = delete;
+
+  /// The mapped bytes of the range.
+  const char* data() const noexcept { return data_; }
+
+  size_t size() const noexcept { return size_; }
+
+  /// The index of the first byte of the range in the file.
+  uint64_t begin_byte_index() const noexcept { return begin_byte_index_; }
+
+  /// The etag of the version of the blob file which was mapped.
+  const std::string& etag() const noexcept { return etag_; }
+
+ private:
+  MappedBlobRange(void* mapping, size_t mapping_size, const char* data,
+                  size_t size, uint64_t begin_byte_index, std::string etag)
+      : mapping_(mapping),
+        mapping_size_(mapping_size),
+        data_(data),
+        size_(size),
+        begin_byte_index_(begin_byte_index),
+        etag_(std::move(etag)) {}
+
+  /// The page aligned mapping which holds the range, if it is not empty.
+  void* const mapping_;
+  const size_t mapping_size_;
+  const char* const data_;
+  const size_t size_;
+  const uint64_t begin_byte_index_;
+  const std::string etag_;
+};
+
+/**
+ * @brief A temporary file which a blob is written to and then renamed over the
+ * blob file, so readers see either the old or the new blob. The file is
+ * removed if it is destroyed before being committed.
+ */
+class BlobFileWriter {
+ public:
+  /**
+   * @brief Creates a new empty temporary file in temp_directory, which must be
+   * on the same filesystem as the blob files.
+   */
+  static core::ExecutionResultOr<std::unique_ptr<BlobFileWriter>> Create(
+      const std::string& temp_directory) noexcept;
+
+  ~BlobFileWriter();
+
+  BlobFileWriter(const BlobFileWriter&) = delete;
+  BlobFileWriter& operator=(const BlobFileWriter&) = delete;
+
+  /// Appends the bytes to the file.
+  core::ExecutionResult Append(const std::string& bytes) noexcept;
+
+  /// Closes the file and renames it to blob_path, creating its directories.
+  core::ExecutionResult Commit(const std::string& blob_path) noexcept;
+
+ private:
+  BlobFileWriter(int file_descriptor, std::string temp_path)
+      : file_descriptor_(file_descriptor), temp_path_(std::move(temp_path)) {}
+
+  int file_descriptor_;
+  const std::string temp_path_;
+  bool is_committed_ = false;
+};
+
+/**
+ * @brief An output file stream which writes a blob to a temporary file and
+ * renames it over the blob file once it is destroyed, unless writing failed.
+ */
+class BlobFileOutputStream : public std::ofstream {
+ public:
+  /**
+   * @brief Creates a stream which writes a temporary file in temp_directory,
+   * which must be on the same filesystem as blob_path.
+   */
+  static core::ExecutionResultOr<std::unique_ptr<BlobFileOutputStream>> Create(
+      const std::string& temp_directory, std::string blob_path) noexcept;
+
+  ~BlobFileOutputStream() override;
+
+ private:
+  BlobFileOutputStream(std::string temp_path, std::string blob_path);
+
+  const std::string temp_path_;
+  const std::string blob_path_;
+};
+
+class LocalBlobStorageClientUtils {
+ public:
+  /**
+   * @brief Gets the path of the directory of a bucket under root_directory.
+   * Bucket names which are empty, have a '/' or start with a '.' are invalid.
+   */
+  static core::ExecutionResultOr<std::string> GetBucketPath(
+      const std::string& root_directory,
+      const std::string& bucket_name) noexcept;
+
+  /**
+   * @brief Gets the path of the file of a blob under root_directory. The '/'s
+   * of blob names separate directories, which must not be empty, '.' or '..'.
+   */
+  static core::ExecutionResultOr<std::string> GetBlobPath(
+      const std::string& root_directory,
+      const cmrt::sdk::blob_storage_service::v1::BlobMetadata&
+          blob_metadata) noexcept;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -59,12 +59,14 @@ using Aws::S3::Model::CreateMultipartUploadOutcome;
 using Aws::S3::Model::CreateMultipartUploadRequest;
 using Aws::S3::Model::CreateMultipartUploadResult;
 using Aws::S3::Model::GetObjectOutcome;
+using Aws::S3::GetObjectResponseReceivedHandler;
 using Aws::S3::Model::GetObjectRequest;
 using Aws::S3::Model::GetObjectResult;
 using Aws::S3::Model::Object;
 using Aws::S3::Model::UploadPartOutcome;
 using Aws::S3::Model::UploadPartRequest;
 using Aws::S3::Model::UploadPartResult;
+using Aws::S3::UploadPartResponseReceivedHandler;
 using google::cmrt::sdk::blob_storage_service::v1::Blob;
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
@@ -374,6 +376,98 @@ TEST_F(AwsBlobStorageClientProviderStreamTest, PutBlobStreamMultiplePortions) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsBlobStorageClientProviderStreamTest, PutBlobStreamInParallel) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->put_blob_stream_parallelism = 2;
+  // Raised to kMinimumPartSize.
+  options->put_blob_stream_part_size = 4;
+  AwsBlobStorageClientProvider parallel_provider(
+      options, instance_client_, make_shared<MockAsyncExecutor>(),
+      make_shared<MockAsyncExecutor>(), s3_factory_);
+  EXPECT_SUCCESS(parallel_provider.Init());
+  EXPECT_SUCCESS(parallel_provider.Run());
+
+  put_blob_stream_context_.request->mutable_blob_portion()
+      ->mutable_metadata()
+      ->set_bucket_name(kBucketName);
+  put_blob_stream_context_.request->mutable_blob_portion()
+      ->mutable_metadata()
+      ->set_blob_name(kBlobName);
+  vector<string> parts{string(kMinimumPartSize, 'a'),
+                       string(kMinimumPartSize, 'b'),
+                       string(kMinimumPartSize, 'c'), "d"};
+  put_blob_stream_context_.request->mutable_blob_portion()->set_data(
+      parts[0] + parts[1]);
+  auto request2 = *put_blob_stream_context_.request;
+  request2.mutable_blob_portion()->set_data(parts[2] + parts[3]);
+  put_blob_stream_context_.TryPushRequest(move(request2));
+  put_blob_stream_context_.MarkDone();
+
+  put_blob_stream_context_.callback = [this](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_NE(context.response, nullptr);
+
+    finish_called_ = true;
+  };
+
+  string upload_id = "upload id";
+  EXPECT_CALL(*s3_client_, CreateMultipartUploadAsync(
+                               HasBucketAndKey(kBucketName, kBlobName), _, _))
+      .WillOnce([this, &upload_id](auto request, auto& callback, auto) {
+        CreateMultipartUploadResult result;
+        result.SetUploadId(upload_id);
+        CreateMultipartUploadOutcome outcome(move(result));
+        callback(abstract_client_, request, move(outcome), nullptr);
+      });
+
+  // Up to 2 parts are uploaded at once.
+  vector<UploadPartRequest> requests;
+  vector<UploadPartResponseReceivedHandler> callbacks;
+  EXPECT_CALL(*s3_client_, UploadPartAsync)
+      .Times(4)
+      .WillRepeatedly([&](auto request, auto& callback, auto) {
+        EXPECT_FALSE(request.GetContentMD5().empty());
+        requests.push_back(request);
+        callbacks.push_back(callback);
+      });
+  auto finish_upload_part = [&](size_t i) {
+    EXPECT_THAT(requests[i],
+                UploadPartRequestEquals(kBucketName, kBlobName, upload_id,
+                                        i + 1, parts[i]));
+    UploadPartResult result;
+    result.SetETag(absl::StrCat("tag ", i + 1));
+    UploadPartOutcome outcome(move(result));
+    callbacks[i](abstract_client_, requests[i], move(outcome), nullptr);
+  };
+
+  // The parts are completed in order whatever order they finish in.
+  EXPECT_CALL(*s3_client_, CompleteMultipartUploadAsync)
+      .WillOnce([this](auto request, auto& callback, auto) {
+        EXPECT_THAT(request, HasBucketAndKey(kBucketName, kBlobName));
+        const auto& completed_parts = request.GetMultipartUpload().GetParts();
+        ASSERT_EQ(completed_parts.size(), 4);
+        for (size_t i = 0; i < completed_parts.size(); i++) {
+          EXPECT_EQ(completed_parts[i].GetPartNumber(), i + 1);
+          EXPECT_EQ(completed_parts[i].GetETag(), absl::StrCat("tag ", i + 1));
+        }
+        CompleteMultipartUploadResult result;
+        CompleteMultipartUploadOutcome outcome(move(result));
+        callback(abstract_client_, request, outcome, nullptr);
+      });
+
+  parallel_provider.PutBlobStream(put_blob_stream_context_);
+  ASSERT_EQ(callbacks.size(), 2);
+  finish_upload_part(1);
+  ASSERT_EQ(callbacks.size(), 3);
+  finish_upload_part(0);
+  ASSERT_EQ(callbacks.size(), 4);
+  finish_upload_part(3);
+  EXPECT_FALSE(finish_called_);
+  finish_upload_part(2);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(AwsBlobStorageClientProviderStreamTest, PutBlobStreamAccumulates) {
   put_blob_stream_context_.request->mutable_blob_portion()
       ->mutable_metadata()
@@ -1013,6 +1107,61 @@ TEST_F(AwsBlobStorageClientProviderStreamTest, GetBlobStreamMultipleResponses) {
               Pointwise(GetBlobStreamResponseEquals(), expected_responses));
 }
 
+TEST_F(AwsBlobStorageClientProviderStreamTest, GetBlobStreamAdaptive) {
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+  get_blob_stream_context_.request->set_adaptive_bytes_per_response(true);
+
+  // 64KB, then 128KB, then the last 100 bytes of a 256KB read.
+  constexpr size_t kKb = 1 << 10;
+  string bytes_str((192 * kKb) + 100, 'a');
+  vector<std::pair<size_t, size_t>> ranges = {{0, 64 * kKb - 1},
+                                              {64 * kKb, 192 * kKb - 1},
+                                              {192 * kKb, 448 * kKb - 1}};
+  InSequence in_sequence;
+  for (const auto& [begin, end] : ranges) {
+    EXPECT_CALL(*s3_client_,
+                GetObjectAsync(HasBucketKeyAndRange(
+                                   kBucketName, kBlobName,
+                                   absl::StrCat("bytes=", begin, "-", end)),
+                               _, _))
+        .WillOnce([this, &bytes_str, begin = begin](auto request,
+                                                     auto& callback, auto) {
+          // The round trip takes far longer than the transfer, so larger
+          // reads raise the throughput.
+          sleep_for(milliseconds(20));
+          auto data = bytes_str.substr(begin, 256 * kKb);
+          GetObjectResult result;
+          result.ReplaceBody(new StringStream(data));
+          result.SetContentRange(absl::StrCat("bytes ", begin, "-",
+                                              begin + data.size() - 1, "/",
+                                              bytes_str.size()));
+          result.SetContentLength(data.size());
+          GetObjectOutcome outcome(move(result));
+          callback(abstract_client_, request, move(outcome), nullptr);
+        });
+  }
+
+  vector<size_t> response_sizes;
+  get_blob_stream_context_.process_callback = [this, &response_sizes](
+                                                  auto& context, bool) {
+    auto resp = context.TryGetNextResponse();
+    if (resp != nullptr) {
+      response_sizes.push_back(resp->blob_portion().data().size());
+    } else {
+      EXPECT_SUCCESS(context.result);
+      finish_called_ = true;
+    }
+  };
+
+  provider_.GetBlobStream(get_blob_stream_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_THAT(response_sizes, ElementsAre(64 * kKb, 128 * kKb, 100));
+}
+
 TEST_F(AwsBlobStorageClientProviderStreamTest, GetBlobStreamByteRange) {
   get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
       kBucketName);
@@ -1151,6 +1300,86 @@ TEST_F(AwsBlobStorageClientProviderStreamTest, GetBlobStreamIndexBeyondEnd) {
               ElementsAre(GetBlobStreamResponseEquals(expected_response)));
 }
 
+TEST_F(AwsBlobStorageClientProviderStreamTest, GetBlobStreamInParallel) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->get_blob_stream_parallelism = 3;
+  options->get_blob_stream_part_size = 4;
+  AwsBlobStorageClientProvider parallel_provider(
+      options, instance_client_, make_shared<MockAsyncExecutor>(),
+      make_shared<MockAsyncExecutor>(), s3_factory_);
+  EXPECT_SUCCESS(parallel_provider.Init());
+  EXPECT_SUCCESS(parallel_provider.Run());
+
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+
+  // 15 chars.
+  string bytes_str = "response_string";
+  // The first part is read alone, then the other 3 parts at once. They are
+  // held until the last one is read.
+  vector<GetObjectResponseReceivedHandler> callbacks;
+  vector<GetObjectRequest> requests;
+  EXPECT_CALL(*s3_client_, GetObjectAsync)
+      .Times(4)
+      .WillRepeatedly([&](auto request, auto& callback, auto) {
+        requests.push_back(request);
+        callbacks.push_back(callback);
+      });
+  auto finish_get_object = [&](size_t i) {
+    auto begin_index = i * 4;
+    auto end_index = std::min(begin_index + 3, bytes_str.length() - 1);
+    GetObjectResult result;
+    result.ReplaceBody(new StringStream(
+        bytes_str.substr(begin_index, end_index - begin_index + 1)));
+    result.SetContentRange(
+        absl::StrCat("bytes ", begin_index, "-", end_index, "/15"));
+    result.SetContentLength(end_index - begin_index + 1);
+    GetObjectOutcome outcome(move(result));
+    callbacks[i](abstract_client_, requests[i], move(outcome), nullptr);
+  };
+
+  vector<GetBlobStreamResponse> actual_responses;
+  get_blob_stream_context_.process_callback = [this, &actual_responses](
+                                                  auto& context, bool) {
+    auto resp = context.TryGetNextResponse();
+    if (resp != nullptr) {
+      actual_responses.push_back(move(*resp));
+    } else {
+      if (!context.IsMarkedDone()) {
+        ADD_FAILURE();
+      }
+      EXPECT_SUCCESS(context.result);
+      finish_called_ = true;
+    }
+  };
+
+  parallel_provider.GetBlobStream(get_blob_stream_context_);
+  ASSERT_EQ(callbacks.size(), 1);
+  finish_get_object(0);
+  ASSERT_EQ(callbacks.size(), 4);
+  EXPECT_THAT(requests[1],
+              HasBucketKeyAndRange(kBucketName, kBlobName, "bytes=4-7"));
+  EXPECT_THAT(requests[2],
+              HasBucketKeyAndRange(kBucketName, kBlobName, "bytes=8-11"));
+  EXPECT_THAT(requests[3],
+              HasBucketKeyAndRange(kBucketName, kBlobName, "bytes=12-15"));
+  finish_get_object(3);
+  finish_get_object(2);
+  EXPECT_EQ(actual_responses.size(), 1);
+  finish_get_object(1);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_TRUE(get_blob_stream_context_.IsMarkedDone());
+  string actual_bytes;
+  for (const auto& response : actual_responses) {
+    EXPECT_EQ(response.byte_range().begin_byte_index(), actual_bytes.length());
+    actual_bytes += response.blob_portion().data();
+  }
+  EXPECT_EQ(actual_bytes, bytes_str);
+}
+
 TEST_F(AwsBlobStorageClientProviderStreamTest,
        GetBlobStreamFailsIfGetObjectFails) {
   get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
@@ -19,8 +19,10 @@
 #include <utility>
 #include <vector>
 
+#include <aws/core/http/HttpResponse.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/Object.h>
@@ -29,6 +31,7 @@
 #include "core/async_executor/mock/mock_async_executor.h"
 #include "core/test/utils/conditional_wait.h"
 #include "core/test/utils/scp_test_base.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
 #include "cpio/client_providers/blob_storage_client_provider/test/aws/mock_s3_client.h"
 #include "cpio/client_providers/instance_client_provider/mock/mock_instance_client_provider.h"
 #include "cpio/common/src/aws/error_codes.h"
@@ -41,10 +44,15 @@ using Aws::StringStream;
 using Aws::Vector;
 using Aws::Client::AWSError;
 using Aws::Client::ClientConfiguration;
+using Aws::Http::HttpResponseCode;
 using Aws::S3::S3Errors;
 using Aws::S3::Model::DeleteObjectOutcome;
 using Aws::S3::Model::DeleteObjectRequest;
 using Aws::S3::Model::DeleteObjectResult;
+using Aws::S3::Model::DeleteObjectsOutcome;
+using Aws::S3::Model::DeleteObjectsRequest;
+using Aws::S3::Model::DeleteObjectsResult;
+using Aws::S3::Model::Error;
 using Aws::S3::Model::GetObjectOutcome;
 using Aws::S3::Model::GetObjectRequest;
 using Aws::S3::Model::GetObjectResult;
@@ -57,8 +65,11 @@ using Aws::S3::Model::PutObjectRequest;
 using Aws::S3::Model::PutObjectResult;
 using google::cmrt::sdk::blob_storage_service::v1::Blob;
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
@@ -66,9 +77,13 @@ using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
 using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
 using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
+using google::scp::core::RetryExecutionResult;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_AWS_INTERNAL_SERVICE_ERROR;
+using google::scp::core::errors::SC_AWS_SERVICE_UNAVAILABLE;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
 using google::scp::core::test::IsSuccessful;
 using google::scp::core::test::ResultIs;
 using google::scp::core::test::ScpTestBase;
@@ -241,6 +256,77 @@ TEST_F(AwsBlobStorageClientProviderTest, GetBlobSuccess) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+MATCHER_P3(HasBucketKeyAndIfNoneMatch, bucket, key, etag, "") {
+  return ExplainMatchResult(HasBucketAndKey(bucket, key), arg,
+                            result_listener) &&
+         ExplainMatchResult(Eq(etag), arg.GetIfNoneMatch(), result_listener);
+}
+
+TEST_F(AwsBlobStorageClientProviderTest, GetBlobReturnsEtag) {
+  auto bucket_name = "bucket_name";
+  auto blob_name = "blob_name";
+  get_blob_context_.request->mutable_blob_metadata()->set_bucket_name(
+      bucket_name);
+  get_blob_context_.request->mutable_blob_metadata()->set_blob_name(blob_name);
+  get_blob_context_.callback =
+      [this](AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context) {
+        EXPECT_SUCCESS(get_blob_context.result);
+        EXPECT_EQ(get_blob_context.response->etag(), "\"etag\"");
+        EXPECT_FALSE(get_blob_context.response->not_modified());
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*s3_client_,
+              GetObjectAsync(HasBucketAndKey(bucket_name, blob_name), _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        GetObjectRequest get_object_request;
+        GetObjectResult get_object_result;
+        get_object_result.ReplaceBody(new StringStream(""));
+        get_object_result.SetETag("\"etag\"");
+        GetObjectOutcome get_object_outcome(move(get_object_result));
+        callback(nullptr /*s3_client*/, get_object_request,
+                 move(get_object_outcome), nullptr /*async_context*/);
+      });
+
+  provider_.GetBlob(get_blob_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsBlobStorageClientProviderTest, GetBlobNotModified) {
+  auto bucket_name = "bucket_name";
+  auto blob_name = "blob_name";
+  get_blob_context_.request->mutable_blob_metadata()->set_bucket_name(
+      bucket_name);
+  get_blob_context_.request->mutable_blob_metadata()->set_blob_name(blob_name);
+  get_blob_context_.request->set_if_none_match_etag("\"etag\"");
+  get_blob_context_.callback =
+      [this](AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context) {
+        EXPECT_SUCCESS(get_blob_context.result);
+        EXPECT_TRUE(get_blob_context.response->not_modified());
+        EXPECT_EQ(get_blob_context.response->etag(), "\"etag\"");
+        EXPECT_TRUE(get_blob_context.response->blob().data().empty());
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*s3_client_,
+              GetObjectAsync(HasBucketKeyAndIfNoneMatch(bucket_name, blob_name,
+                                                        "\"etag\""),
+                             _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        GetObjectRequest get_object_request;
+        AWSError<S3Errors> s3_error(S3Errors::UNKNOWN, false);
+        s3_error.SetResponseCode(HttpResponseCode::NOT_MODIFIED);
+        GetObjectOutcome get_object_outcome(s3_error);
+        callback(nullptr /*s3_client*/, get_object_request,
+                 move(get_object_outcome), nullptr /*async_context*/);
+      });
+
+  provider_.GetBlob(get_blob_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 MATCHER_P3(HasBucketKeyAndRange, bucket, key, range, "") {
   return ExplainMatchResult(HasBucketAndKey(bucket, key), arg,
                             result_listener) &&
@@ -351,6 +437,26 @@ TEST_F(AwsBlobStorageClientProviderTest, ListBlobsWithMaxPageSize) {
   provider_.ListBlobsMetadata(list_blobs_metadata_context_);
 }
 
+TEST_F(AwsBlobStorageClientProviderTest, ListBlobsWithTooLargeMaxPageSize) {
+  list_blobs_metadata_context_.request->mutable_blob_metadata()
+      ->set_bucket_name("bucket_name");
+  list_blobs_metadata_context_.request->set_max_page_size(1001);
+  list_blobs_metadata_context_.callback =
+      [this](AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>&
+                 list_blobs_metadata_context) {
+        EXPECT_THAT(list_blobs_metadata_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*s3_client_, ListObjectsAsync).Times(0);
+
+  provider_.ListBlobsMetadata(list_blobs_metadata_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(AwsBlobStorageClientProviderTest, ListBlobsFailure) {
   auto bucket_name = "bucket_name";
   list_blobs_metadata_context_.request->mutable_blob_metadata()
@@ -499,6 +605,33 @@ TEST_F(AwsBlobStorageClientProviderTest, PutBlobSuccess) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsBlobStorageClientProviderTest, PutBlobWithCrc32c) {
+  put_blob_context_.request->mutable_blob()
+      ->mutable_metadata()
+      ->set_bucket_name("bucket_name");
+  put_blob_context_.request->mutable_blob()->mutable_metadata()->set_blob_name(
+      "blob_name");
+  put_blob_context_.request->mutable_blob()->set_data("1234567890");
+  put_blob_context_.request->set_checksum_algorithm(CHECKSUM_ALGORITHM_CRC32C);
+  put_blob_context_.callback = [this](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finish_called_ = true;
+  };
+
+  EXPECT_CALL(*s3_client_, PutObjectAsync)
+      .WillOnce([](const PutObjectRequest& request, auto& callback, auto) {
+        // The CRC32C of the data, base64-encoded, instead of its MD5.
+        EXPECT_EQ(request.GetHeaders()["x-amz-checksum-crc32c"], "89vU/g==");
+        EXPECT_TRUE(request.GetContentMD5().empty());
+        callback(nullptr /*s3_client*/, request,
+                 PutObjectOutcome(PutObjectResult()), nullptr /*async_context*/);
+      });
+
+  provider_.PutBlob(put_blob_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(AwsBlobStorageClientProviderTest, DeleteBlobFailure) {
   auto bucket_name = "bucket_name";
   auto blob_name = "blob_name";
@@ -561,4 +694,63 @@ TEST_F(AwsBlobStorageClientProviderTest, DeleteBlobSuccess) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsBlobStorageClientProviderTest, DeleteBlobsInBatchesOfAThousand) {
+  AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> delete_blobs_context;
+  delete_blobs_context.request = make_shared<DeleteBlobsRequest>();
+  for (int i = 0; i < 1001; ++i) {
+    auto* blob_metadata = delete_blobs_context.request->add_blob_metadatas();
+    blob_metadata->set_bucket_name("bucket_name");
+    blob_metadata->set_blob_name("blob_" + std::to_string(i));
+  }
+  auto* other_blob_metadata =
+      delete_blobs_context.request->add_blob_metadatas();
+  other_blob_metadata->set_bucket_name("other_bucket_name");
+  other_blob_metadata->set_blob_name("blob_0");
+  delete_blobs_context.callback =
+      [this](AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+                 delete_blobs_context) {
+        ASSERT_SUCCESS(delete_blobs_context.result);
+        const auto& blob_results =
+            delete_blobs_context.response->blob_results();
+        ASSERT_EQ(blob_results.size(), 1002);
+        EXPECT_EQ(blob_results[1].blob_metadata().blob_name(), "blob_1");
+        EXPECT_SUCCESS(ExecutionResult(blob_results[0].result()));
+        EXPECT_THAT(
+            ExecutionResult(blob_results[1].result()),
+            ResultIs(FailureExecutionResult(SC_AWS_INTERNAL_SERVICE_ERROR)));
+        EXPECT_SUCCESS(ExecutionResult(blob_results[1000].result()));
+        EXPECT_THAT(
+            ExecutionResult(blob_results[1001].result()),
+            ResultIs(RetryExecutionResult(SC_AWS_SERVICE_UNAVAILABLE)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*s3_client_, DeleteObjectsAsync)
+      .WillOnce([](const DeleteObjectsRequest& request, auto callback, auto) {
+        EXPECT_EQ(request.GetBucket(), "bucket_name");
+        EXPECT_EQ(request.GetDelete().GetObjects().size(), 1000);
+        DeleteObjectsResult result;
+        result.AddErrors(Error().WithKey("blob_1").WithCode("AccessDenied"));
+        callback(nullptr /*s3_client*/, request,
+                 DeleteObjectsOutcome(move(result)), nullptr /*async_context*/);
+      })
+      .WillOnce([](const DeleteObjectsRequest& request, auto callback, auto) {
+        EXPECT_EQ(request.GetBucket(), "bucket_name");
+        EXPECT_EQ(request.GetDelete().GetObjects().size(), 1);
+        callback(nullptr /*s3_client*/, request,
+                 DeleteObjectsOutcome(DeleteObjectsResult()),
+                 nullptr /*async_context*/);
+      })
+      .WillOnce([](const DeleteObjectsRequest& request, auto callback, auto) {
+        EXPECT_EQ(request.GetBucket(), "other_bucket_name");
+        AWSError<S3Errors> s3_error(S3Errors::SERVICE_UNAVAILABLE, true);
+        callback(nullptr /*s3_client*/, request, DeleteObjectsOutcome(s3_error),
+                 nullptr /*async_context*/);
+      });
+
+  provider_.DeleteBlobs(delete_blobs_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 }  // namespace google::scp::cpio::client_providers
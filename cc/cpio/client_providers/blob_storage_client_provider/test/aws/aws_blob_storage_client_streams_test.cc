@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/aws/aws_blob_storage_client_streams.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
+using google::scp::core::test::ResultIs;
+using std::ios_base;
+using std::istreambuf_iterator;
+using std::make_shared;
+using std::string;
+using std::stringstream;
+
+namespace google::scp::cpio::client_providers::test {
+namespace {
+string ReadAll(std::iostream& stream) {
+  return string(istreambuf_iterator<char>(stream), istreambuf_iterator<char>());
+}
+}  // namespace
+
+TEST(AwsBlobStorageClientStreamsTest, BorrowedBytesAreReadWithoutCopy) {
+  auto bytes = make_shared<string>("0123456789");
+  BufferedIOStream<BorrowedBytesStreamBuffer> stream(bytes, *bytes);
+
+  char first[4];
+  ASSERT_TRUE(stream.read(first, 4));
+  EXPECT_EQ(string(first, 4), "0123");
+  EXPECT_EQ(stream.tellg(), 4);
+
+  // The SDK sizes the body by seeking to its end, then rewinds it.
+  stream.seekg(0, ios_base::end);
+  EXPECT_EQ(stream.tellg(), 10);
+  stream.seekg(0, ios_base::beg);
+  EXPECT_EQ(ReadAll(stream), "0123456789");
+
+  stream.clear();
+  stream.seekg(-3, ios_base::end);
+  EXPECT_EQ(ReadAll(stream), "789");
+
+  // Seeking out of the bytes fails.
+  stream.clear();
+  stream.seekg(11, ios_base::beg);
+  EXPECT_TRUE(stream.fail());
+}
+
+TEST(AwsBlobStorageClientStreamsTest, BorrowedBytesCannotBeWritten) {
+  auto bytes = make_shared<string>("0123");
+  BufferedIOStream<BorrowedBytesStreamBuffer> stream(bytes, *bytes);
+  stream.write("ab", 2);
+  EXPECT_TRUE(stream.bad());
+  EXPECT_EQ(*bytes, "0123");
+}
+
+TEST(AwsBlobStorageClientStreamsTest, StringBufferReadsBackWhatIsWritten) {
+  BufferedIOStream<StringStreamBuffer> stream;
+  stream.write("abc", 3);
+  EXPECT_EQ(stream.tellp(), 3);
+  char first[2];
+  ASSERT_TRUE(stream.read(first, 2));
+  EXPECT_EQ(string(first, 2), "ab");
+
+  // Reading continues after the bytes written since.
+  stream << string(1000, 'd');
+  EXPECT_EQ(ReadAll(stream), "c" + string(1000, 'd'));
+
+  stream.clear();
+  stream.seekg(1);
+  EXPECT_EQ(ReadAll(stream).substr(0, 3), "bcd");
+}
+
+TEST(AwsBlobStorageClientStreamsTest, StringBufferOwnsInitialBytes) {
+  BufferedIOStream<StringStreamBuffer> stream(string("part"));
+  EXPECT_EQ(ReadAll(stream), "part");
+  stream.clear();
+  stream.seekg(0, ios_base::end);
+  EXPECT_EQ(stream.tellg(), 4);
+}
+
+TEST(AwsBlobStorageClientStreamsTest, TakeBodyBytesMovesStringBuffer) {
+  BufferedIOStream<StringStreamBuffer> stream;
+  string body(1 << 20, 'a');
+  stream.write(body.data(), body.size());
+  auto bytes_or = TakeBodyBytes(stream, body.size());
+  ASSERT_SUCCESS(bytes_or);
+  EXPECT_EQ(*bytes_or, body);
+  // The bytes were moved out of the buffer.
+  stream.seekg(0, ios_base::end);
+  EXPECT_EQ(stream.tellg(), 0);
+}
+
+TEST(AwsBlobStorageClientStreamsTest, TakeBodyBytesReadsOtherStreams) {
+  stringstream stream("some bytes");
+  auto bytes_or = TakeBodyBytes(stream, 4);
+  ASSERT_SUCCESS(bytes_or);
+  EXPECT_EQ(*bytes_or, "some");
+}
+
+TEST(AwsBlobStorageClientStreamsTest, TakeBodyBytesFailsOnShortBody) {
+  BufferedIOStream<StringStreamBuffer> string_stream(string("abc"));
+  EXPECT_THAT(TakeBodyBytes(string_stream, 4),
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB)));
+
+  stringstream stream("abc");
+  EXPECT_THAT(TakeBodyBytes(stream, 4),
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB)));
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -162,4 +162,23 @@ TEST(AwsBlobStorageClientUtilsTest, ConvertS3ErrorToExecutionResult) {
       ResultIs(FailureExecutionResult(errors::SC_AWS_INTERNAL_SERVICE_ERROR)));
 }
 
+TEST(AwsBlobStorageClientUtilsTest, ConvertS3ErrorCodeToExecutionResult) {
+  EXPECT_THAT(AwsBlobStorageClientUtils::ConvertS3ErrorCodeToExecutionResult(
+                  "ServiceUnavailable"),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_AWS_SERVICE_UNAVAILABLE)));
+  EXPECT_THAT(AwsBlobStorageClientUtils::ConvertS3ErrorCodeToExecutionResult(
+                  "NoSuchKey"),
+              ResultIs(FailureExecutionResult(errors::SC_AWS_NOT_FOUND)));
+  EXPECT_THAT(
+      AwsBlobStorageClientUtils::ConvertS3ErrorCodeToExecutionResult(
+          "AccessDenied"),
+      ResultIs(FailureExecutionResult(errors::SC_AWS_INTERNAL_SERVICE_ERROR)));
+  // Unknown codes.
+  EXPECT_THAT(
+      AwsBlobStorageClientUtils::ConvertS3ErrorCodeToExecutionResult(
+          "SomethingElse"),
+      ResultIs(FailureExecutionResult(errors::SC_AWS_INTERNAL_SERVICE_ERROR)));
+}
+
 }  // namespace google::scp::cpio::client_providers::test
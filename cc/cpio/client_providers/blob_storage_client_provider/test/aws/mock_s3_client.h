@@ -22,6 +22,7 @@
 
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
@@ -56,6 +57,12 @@ class MockS3Client : public Aws::S3::S3Client {
                const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
               (const, override));
 
+  MOCK_METHOD(void, DeleteObjectsAsync,
+              (const Aws::S3::Model::DeleteObjectsRequest&,
+               const Aws::S3::DeleteObjectsResponseReceivedHandler&,
+               const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
+              (const, override));
+
   MOCK_METHOD(void, CreateMultipartUploadAsync,
               (const Aws::S3::Model::CreateMultipartUploadRequest&,
                const Aws::S3::CreateMultipartUploadResponseReceivedHandler&,
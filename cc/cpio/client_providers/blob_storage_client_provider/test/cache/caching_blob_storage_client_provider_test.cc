@@ -0,0 +1,381 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/cache/caching_blob_storage_client_provider.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/test/utils/scp_test_base.h"
+#include "cpio/client_providers/blob_storage_client_provider/mock/mock_blob_storage_client_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::ScpTestBase;
+using google::scp::cpio::client_providers::mock::MockBlobStorageClientProvider;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::hours;
+using std::filesystem::recursive_directory_iterator;
+using std::filesystem::is_empty;
+using std::filesystem::remove_all;
+using testing::ElementsAre;
+using testing::NiceMock;
+
+namespace {
+constexpr char kBucketName[] = "bucket";
+constexpr char kBlobName[] = "blob";
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class CachingBlobStorageClientProviderTest : public ScpTestBase {
+ protected:
+  CachingBlobStorageClientProviderTest()
+      : cache_directory_(CreateCacheDirectory()),
+        options_(make_shared<BlobStorageClientOptions>()),
+        mock_provider_(make_shared<NiceMock<MockBlobStorageClientProvider>>()) {
+    options_->cache_directory = cache_directory_;
+    client_ = make_shared<CachingBlobStorageClientProvider>(
+        options_, mock_provider_, make_shared<MockAsyncExecutor>());
+    EXPECT_SUCCESS(client_->Init());
+    EXPECT_SUCCESS(client_->Run());
+  }
+
+  ~CachingBlobStorageClientProviderTest() {
+    EXPECT_SUCCESS(client_->Stop());
+    // The cache files are removed on Stop.
+    EXPECT_TRUE(is_empty(cache_directory_));
+    remove_all(cache_directory_);
+  }
+
+  static string CreateCacheDirectory() {
+    string cache_directory = testing::TempDir() + "/blob_cache_test_XXXXXX";
+    EXPECT_NE(mkdtemp(cache_directory.data()), nullptr);
+    return cache_directory;
+  }
+
+  /// Expects a GetBlob of the blob, which finishes with the data and etag.
+  void ExpectGetBlob(const string& blob_name, const string& if_none_match_etag,
+                     const string& data, const string& etag) {
+    EXPECT_CALL(*mock_provider_, GetBlob)
+        .WillOnce([=](AsyncContext<GetBlobRequest, GetBlobResponse>& context) {
+          EXPECT_EQ(context.request->blob_metadata().blob_name(), blob_name);
+          EXPECT_EQ(context.request->if_none_match_etag(), if_none_match_etag);
+          context.response = make_shared<GetBlobResponse>();
+          context.response->set_etag(etag);
+          if (!etag.empty() && if_none_match_etag == etag) {
+            context.response->set_not_modified(true);
+          } else {
+            context.response->mutable_blob()->set_data(data);
+          }
+          context.result = SuccessExecutionResult();
+          context.Finish();
+        });
+  }
+
+  /// Gets the blob through the cache, and returns its data.
+  string GetBlob(const string& blob_name) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> context;
+    context.request = make_shared<GetBlobRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context.request->mutable_blob_metadata()->set_blob_name(blob_name);
+    string data;
+    bool finished = false;
+    context.callback = [&data, &finished](auto& context) {
+      EXPECT_SUCCESS(context.result);
+      data = context.response->blob().data();
+      finished = true;
+    };
+    client_->GetBlob(context);
+    EXPECT_TRUE(finished);
+    return data;
+  }
+
+  string cache_directory_;
+  shared_ptr<BlobStorageClientOptions> options_;
+  shared_ptr<MockBlobStorageClientProvider> mock_provider_;
+  shared_ptr<CachingBlobStorageClientProvider> client_;
+};
+
+TEST_F(CachingBlobStorageClientProviderTest, InitFailsWithoutCacheDirectory) {
+  CachingBlobStorageClientProvider client(
+      make_shared<BlobStorageClientOptions>(), mock_provider_,
+      make_shared<MockAsyncExecutor>());
+  EXPECT_THAT(client.Init(), ResultIs(FailureExecutionResult(
+                                 SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, RevalidatesCachedBlob) {
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  ExpectGetBlob(kBlobName, "v1", "", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  auto stats = client_->GetCacheStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.revalidations, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.bytes_saved, 9);
+  EXPECT_DOUBLE_EQ(stats.HitRatio(), 0.5);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, ReplacesChangedBlob) {
+  ExpectGetBlob(kBlobName, "", "old data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "old data");
+
+  ExpectGetBlob(kBlobName, "v1", "new data", "v2");
+  EXPECT_EQ(GetBlob(kBlobName), "new data");
+
+  ExpectGetBlob(kBlobName, "v2", "", "v2");
+  EXPECT_EQ(GetBlob(kBlobName), "new data");
+
+  auto stats = client_->GetCacheStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, ServesFreshBlobWithoutReading) {
+  options_->cache_revalidation_interval = hours(1);
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  // No more GetBlobs are expected.
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  auto stats = client_->GetCacheStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.revalidations, 0);
+  EXPECT_EQ(stats.bytes_saved, 18);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, RereadsDamagedBlobFile) {
+  options_->cache_revalidation_interval = hours(1);
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  // Damage the blob file without changing its size.
+  for (const auto& entry : recursive_directory_iterator(cache_directory_)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    std::ofstream(entry.path(), std::ios::binary) << "some dat4";
+  }
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  auto stats = client_->GetCacheStats();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 2);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, EvictsLeastRecentlyUsedBlobs) {
+  options_->cache_size_bytes = 10;
+  ExpectGetBlob("a", "", "aaaa", "a1");
+  EXPECT_EQ(GetBlob("a"), "aaaa");
+  ExpectGetBlob("b", "", "bbbb", "b1");
+  EXPECT_EQ(GetBlob("b"), "bbbb");
+  // Reading a makes b the least recently used blob.
+  ExpectGetBlob("a", "a1", "", "a1");
+  EXPECT_EQ(GetBlob("a"), "aaaa");
+  ExpectGetBlob("c", "", "cccc", "c1");
+  EXPECT_EQ(GetBlob("c"), "cccc");
+
+  ExpectGetBlob("a", "a1", "", "a1");
+  EXPECT_EQ(GetBlob("a"), "aaaa");
+  ExpectGetBlob("b", "", "bbbb", "b1");
+  EXPECT_EQ(GetBlob("b"), "bbbb");
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, DoesNotCacheLargeBlobs) {
+  options_->cache_size_bytes = 4;
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, DoesNotCacheBlobsWithoutEtag) {
+  ExpectGetBlob(kBlobName, "", "some data", "");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+  ExpectGetBlob(kBlobName, "", "some data", "");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, CoalescesConcurrentMisses) {
+  vector<AsyncContext<GetBlobRequest, GetBlobResponse>> in_flight;
+  EXPECT_CALL(*mock_provider_, GetBlob).WillOnce([&in_flight](auto& context) {
+    in_flight.push_back(context);
+  });
+
+  vector<string> data;
+  for (int i = 0; i < 3; ++i) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> context;
+    context.request = make_shared<GetBlobRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+    context.callback = [&data](auto& context) {
+      EXPECT_SUCCESS(context.result);
+      data.push_back(context.response->blob().data());
+    };
+    client_->GetBlob(context);
+  }
+  ASSERT_EQ(in_flight.size(), 1);
+  in_flight[0].response = make_shared<GetBlobResponse>();
+  in_flight[0].response->mutable_blob()->set_data("some data");
+  in_flight[0].response->set_etag("v1");
+  in_flight[0].result = SuccessExecutionResult();
+  in_flight[0].Finish();
+
+  EXPECT_THAT(data, ElementsAre("some data", "some data", "some data"));
+  auto stats = client_->GetCacheStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.coalesced, 2);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, PassesThroughRangedReads) {
+  EXPECT_CALL(*mock_provider_, GetBlob)
+      .Times(2)
+      .WillRepeatedly([](auto& context) {
+        EXPECT_TRUE(context.request->has_byte_range());
+        EXPECT_FALSE(context.request->has_if_none_match_etag());
+        context.response = make_shared<GetBlobResponse>();
+        context.response->mutable_blob()->set_data("some");
+        context.response->set_etag("v1");
+        context.result = SuccessExecutionResult();
+        context.Finish();
+      });
+  for (int i = 0; i < 2; ++i) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> context;
+    context.request = make_shared<GetBlobRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+    context.request->mutable_byte_range()->set_end_byte_index(3);
+    client_->GetBlob(context);
+  }
+  EXPECT_EQ(client_->GetCacheStats().misses, 0);
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, PutBlobDropsCachedBlob) {
+  ExpectGetBlob(kBlobName, "", "old data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "old data");
+
+  EXPECT_CALL(*mock_provider_, PutBlob).WillOnce([](auto& context) {
+    context.result = SuccessExecutionResult();
+    context.Finish();
+  });
+  AsyncContext<PutBlobRequest, PutBlobResponse> put_context;
+  put_context.request = make_shared<PutBlobRequest>();
+  put_context.request->mutable_blob()->mutable_metadata()->set_bucket_name(
+      kBucketName);
+  put_context.request->mutable_blob()->mutable_metadata()->set_blob_name(
+      kBlobName);
+  bool finished = false;
+  put_context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finished = true;
+  };
+  client_->PutBlob(put_context);
+  EXPECT_TRUE(finished);
+
+  ExpectGetBlob(kBlobName, "", "new data", "v2");
+  EXPECT_EQ(GetBlob(kBlobName), "new data");
+}
+
+TEST_F(CachingBlobStorageClientProviderTest,
+       PutBlobStreamDropsBlobCachedDuringWrite) {
+  ExpectGetBlob(kBlobName, "", "old data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "old data");
+
+  // A read racing with the write caches the old blob again.
+  EXPECT_CALL(*mock_provider_, PutBlobStream).WillOnce([this](auto& context) {
+    ExpectGetBlob(kBlobName, "", "old data", "v1");
+    EXPECT_EQ(GetBlob(kBlobName), "old data");
+    context.result = SuccessExecutionResult();
+    context.Finish();
+  });
+  ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+      put_context;
+  put_context.request = make_shared<PutBlobStreamRequest>();
+  auto* metadata =
+      put_context.request->mutable_blob_portion()->mutable_metadata();
+  metadata->set_bucket_name(kBucketName);
+  metadata->set_blob_name(kBlobName);
+  bool finished = false;
+  put_context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finished = true;
+  };
+  client_->PutBlobStream(put_context);
+  EXPECT_TRUE(finished);
+
+  ExpectGetBlob(kBlobName, "", "new data", "v2");
+  EXPECT_EQ(GetBlob(kBlobName), "new data");
+}
+
+TEST_F(CachingBlobStorageClientProviderTest, DeletedBlobIsDropped) {
+  ExpectGetBlob(kBlobName, "", "some data", "v1");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+
+  EXPECT_CALL(*mock_provider_, GetBlob).WillOnce([](auto& context) {
+    context.result =
+        FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND);
+    context.Finish();
+  });
+  AsyncContext<GetBlobRequest, GetBlobResponse> context;
+  context.request = make_shared<GetBlobRequest>();
+  context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+  context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    finished = true;
+  };
+  client_->GetBlob(context);
+  EXPECT_TRUE(finished);
+
+  ExpectGetBlob(kBlobName, "", "some data", "v2");
+  EXPECT_EQ(GetBlob(kBlobName), "some data");
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/adaptive_chunk_sizer.h"
+
+using std::deque;
+using std::nullopt;
+using std::optional;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+namespace {
+constexpr uint64_t kBlobSize = 256 << 20;
+constexpr uint64_t kInitialChunkSize = 64 << 10;
+constexpr uint64_t kMaxChunkSize = 8 << 20;
+// The bandwidth of a single ranged read.
+constexpr double kBytesPerSecond = 100e6;
+
+enum class ChunkSizing { kFixedSmall = 0, kFixedLarge = 1, kAdaptive = 2 };
+
+struct StreamStats {
+  double first_byte_seconds = 0;
+  double total_seconds = 0;
+  int reads = 0;
+};
+
+// Streams the blob one read at a time, the next read being sent when a
+// response is pushed, as the AWS provider does. Each read takes the round
+// trip plus its transfer, and the consumer takes each response once it has
+// processed the earlier ones.
+StreamStats SimulateStream(ChunkSizing chunk_sizing, double round_trip_seconds,
+                           double consumer_bytes_per_second) {
+  optional<google::scp::cpio::client_providers::AdaptiveChunkSizer> sizer;
+  if (chunk_sizing == ChunkSizing::kAdaptive) {
+    sizer.emplace(kInitialChunkSize, kMaxChunkSize);
+  }
+  StreamStats stats;
+  double now = 0;
+  double consumer_free_time = 0;
+  // When each response not taken yet is taken.
+  deque<double> take_times;
+  for (uint64_t offset = 0; offset < kBlobSize;) {
+    uint64_t chunk_size = chunk_sizing == ChunkSizing::kFixedSmall
+                              ? kInitialChunkSize
+                              : kMaxChunkSize;
+    if (sizer) {
+      chunk_size = sizer->GetChunkSize();
+    }
+    auto bytes = std::min(chunk_size, kBlobSize - offset);
+    auto read_seconds = round_trip_seconds + bytes / kBytesPerSecond;
+    now += read_seconds;
+    if (stats.reads++ == 0) {
+      stats.first_byte_seconds = now;
+    }
+    while (!take_times.empty() && take_times.front() <= now) {
+      take_times.pop_front();
+    }
+    if (sizer) {
+      sizer->RecordRead(
+          bytes, duration_cast<nanoseconds>(duration<double>(read_seconds)),
+          take_times.size());
+    }
+    auto take_time = std::max(now, consumer_free_time);
+    consumer_free_time = take_time + bytes / consumer_bytes_per_second;
+    take_times.push_back(take_time);
+    offset += bytes;
+  }
+  stats.total_seconds = consumer_free_time;
+  return stats;
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+
+// Args: chunk sizing (0 fixed 64KB, 1 fixed 8MB, 2 adaptive), round trip in
+// milliseconds, consumer MB/s. The time to the first byte and the throughput
+// of a 256MiB stream are reported.
+static void BM_GetBlobStreamChunkSizing(benchmark::State& state) {
+  auto chunk_sizing = static_cast<ChunkSizing>(state.range(0));
+  double round_trip_seconds = state.range(1) / 1e3;
+  double consumer_bytes_per_second = state.range(2) * 1e6;
+  StreamStats stats;
+  for (auto _ : state) {
+    stats = SimulateStream(chunk_sizing, round_trip_seconds,
+                           consumer_bytes_per_second);
+    benchmark::DoNotOptimize(stats);
+  }
+  state.counters["first_byte_ms"] = stats.first_byte_seconds * 1e3;
+  state.counters["mb_per_second"] = kBlobSize / stats.total_seconds / 1e6;
+  state.counters["reads"] = stats.reads;
+}
+
+BENCHMARK(BM_GetBlobStreamChunkSizing)
+    ->ArgNames({"sizing", "round_trip_ms", "consumer_mbps"})
+    ->ArgsProduct({{0, 1, 2}, {5, 20, 80}, {1000, 40}});
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/adaptive_chunk_sizer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+namespace {
+constexpr uint64_t kInitialChunkSize = 64 << 10;
+constexpr uint64_t kMaxChunkSize = 1 << 20;
+
+// How long a read takes over a link with the round trip and bandwidth.
+nanoseconds GetReadTime(uint64_t bytes, microseconds round_trip_time,
+                        uint64_t bytes_per_second) {
+  return round_trip_time + nanoseconds(bytes * 1000000000 / bytes_per_second);
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+TEST(AdaptiveChunkSizerTest, StartsAtInitialSize) {
+  EXPECT_EQ(AdaptiveChunkSizer(kInitialChunkSize, kMaxChunkSize).GetChunkSize(),
+            kInitialChunkSize);
+  // The cap is lower than the initial size.
+  EXPECT_EQ(AdaptiveChunkSizer(kInitialChunkSize, 1000).GetChunkSize(), 1000);
+}
+
+TEST(AdaptiveChunkSizerTest, DoublesUpToCapWhileRoundTripsDominate) {
+  AdaptiveChunkSizer sizer(kInitialChunkSize, kMaxChunkSize);
+  for (auto expected_chunk_size :
+       {128 << 10, 256 << 10, 512 << 10, 1 << 20, 1 << 20}) {
+    // The reads take as long regardless of their size.
+    sizer.RecordRead(sizer.GetChunkSize(), milliseconds(50),
+                     0 /*outstanding_responses*/);
+    EXPECT_EQ(sizer.GetChunkSize(), expected_chunk_size);
+  }
+}
+
+TEST(AdaptiveChunkSizerTest, StopsDoublingOnceThroughputFlattens) {
+  AdaptiveChunkSizer sizer(kInitialChunkSize, 64 << 20);
+  // A 10ms round trip and 100MB/s, at which the transfer takes twice the round
+  // trip at 2MB.
+  for (int i = 0; i < 20; ++i) {
+    auto chunk_size = sizer.GetChunkSize();
+    sizer.RecordRead(chunk_size,
+                     GetReadTime(chunk_size, milliseconds(10), 100000000),
+                     0 /*outstanding_responses*/);
+  }
+  EXPECT_EQ(sizer.GetChunkSize(), 4 << 20);
+}
+
+TEST(AdaptiveChunkSizerTest, HoldsWhileConsumerLags) {
+  AdaptiveChunkSizer sizer(kInitialChunkSize, kMaxChunkSize);
+  sizer.RecordRead(kInitialChunkSize, milliseconds(50),
+                   2 /*outstanding_responses*/);
+  EXPECT_EQ(sizer.GetChunkSize(), kInitialChunkSize);
+
+  // Once the consumer catches up, the size doubles again.
+  sizer.RecordRead(kInitialChunkSize, milliseconds(50),
+                   0 /*outstanding_responses*/);
+  EXPECT_EQ(sizer.GetChunkSize(), 2 * kInitialChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, IgnoresShortReads) {
+  AdaptiveChunkSizer sizer(kInitialChunkSize, kMaxChunkSize);
+  sizer.RecordRead(kInitialChunkSize - 1, milliseconds(50),
+                   0 /*outstanding_responses*/);
+  EXPECT_EQ(sizer.GetChunkSize(), kInitialChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, KeepsGrowingAfterSlowRead) {
+  AdaptiveChunkSizer sizer(kInitialChunkSize, kMaxChunkSize);
+  sizer.RecordRead(kInitialChunkSize, milliseconds(50),
+                   0 /*outstanding_responses*/);
+  // A read slowed down by something else only holds the size.
+  sizer.RecordRead(2 * kInitialChunkSize, milliseconds(500),
+                   0 /*outstanding_responses*/);
+  EXPECT_EQ(sizer.GetChunkSize(), 2 * kInitialChunkSize);
+  sizer.RecordRead(2 * kInitialChunkSize, milliseconds(50),
+                   0 /*outstanding_responses*/);
+  EXPECT_EQ(sizer.GetChunkSize(), 4 * kInitialChunkSize);
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/batch_blob_deleter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_UNRETRIABLE_ERROR;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::move;
+using std::optional;
+using std::string;
+using std::vector;
+
+namespace google::scp::cpio::client_providers::test {
+class BatchBlobDeleterTest : public testing::Test {
+ protected:
+  BatchBlobDeleterTest() {
+    context_.request = make_shared<DeleteBlobsRequest>();
+    context_.callback = [this](auto& context) {
+      result_ = context.result;
+      response_ = context.response;
+    };
+  }
+
+  void AddBlob(const string& bucket_name, const string& blob_name) {
+    auto* blob_metadata = context_.request->add_blob_metadatas();
+    blob_metadata->set_bucket_name(bucket_name);
+    blob_metadata->set_blob_name(blob_name);
+  }
+
+  // Starts a deleter which keeps each batch for the test to call back.
+  void Start(size_t batch_size, size_t parallelism) {
+    make_shared<BatchBlobDeleter>(
+        context_,
+        [this](const string& bucket_name, const vector<string>& blob_names,
+               BatchBlobDeleter::DeleteBatchCallback callback) {
+          batches_.push_back({bucket_name, blob_names});
+          callbacks_.push_back(move(callback));
+        },
+        batch_size, parallelism, cpu_async_executor_)
+        ->Start();
+  }
+
+  AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> context_;
+  std::shared_ptr<MockAsyncExecutor> cpu_async_executor_ =
+      make_shared<MockAsyncExecutor>();
+  vector<std::pair<string, vector<string>>> batches_;
+  vector<BatchBlobDeleter::DeleteBatchCallback> callbacks_;
+  optional<ExecutionResult> result_;
+  std::shared_ptr<DeleteBlobsResponse> response_;
+};
+
+TEST_F(BatchBlobDeleterTest, SucceedsWithoutBlobs) {
+  Start(10 /*batch_size*/, 2 /*parallelism*/);
+
+  EXPECT_TRUE(batches_.empty());
+  ASSERT_TRUE(result_);
+  EXPECT_SUCCESS(*result_);
+  ASSERT_NE(response_, nullptr);
+  EXPECT_EQ(response_->blob_results_size(), 0);
+}
+
+TEST_F(BatchBlobDeleterTest, FailsWithoutBucketOrName) {
+  AddBlob("bucket", "blob");
+  AddBlob("bucket", "");
+  Start(10 /*batch_size*/, 2 /*parallelism*/);
+
+  EXPECT_TRUE(batches_.empty());
+  ASSERT_TRUE(result_);
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(BatchBlobDeleterTest, GroupsBlobsByBucketIntoBatches) {
+  AddBlob("a", "a0");
+  AddBlob("b", "b0");
+  AddBlob("a", "a1");
+  AddBlob("a", "a2");
+  AddBlob("b", "b1");
+  Start(2 /*batch_size*/, 10 /*parallelism*/);
+
+  vector<std::pair<string, vector<string>>> expected_batches = {
+      {"a", {"a0", "a1"}}, {"b", {"b0", "b1"}}, {"a", {"a2"}}};
+  EXPECT_EQ(batches_, expected_batches);
+  EXPECT_FALSE(result_);
+
+  // The batches are done out of order, and a1 is not found.
+  callbacks_[2]({SuccessExecutionResult()});
+  callbacks_[0](
+      {SuccessExecutionResult(),
+       FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)});
+  EXPECT_FALSE(result_);
+  callbacks_[1]({SuccessExecutionResult(), SuccessExecutionResult()});
+
+  ASSERT_TRUE(result_);
+  EXPECT_SUCCESS(*result_);
+  ASSERT_EQ(response_->blob_results_size(), 5);
+  vector<string> expected_names = {"a0", "b0", "a1", "a2", "b1"};
+  for (int i = 0; i < response_->blob_results_size(); ++i) {
+    const auto& blob_result = response_->blob_results(i);
+    EXPECT_EQ(blob_result.blob_metadata().blob_name(), expected_names[i]);
+    if (expected_names[i] == "a1") {
+      EXPECT_THAT(ExecutionResult(blob_result.result()),
+                  ResultIs(FailureExecutionResult(
+                      SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    } else {
+      EXPECT_SUCCESS(ExecutionResult(blob_result.result()));
+    }
+  }
+}
+
+TEST_F(BatchBlobDeleterTest, DeletesUpToParallelismBatchesAtOnce) {
+  for (int i = 0; i < 5; ++i) {
+    AddBlob("bucket", std::to_string(i));
+  }
+  Start(1 /*batch_size*/, 2 /*parallelism*/);
+  EXPECT_EQ(batches_.size(), 2);
+
+  // Each batch done starts the next one.
+  for (size_t i = 0; i < 3; ++i) {
+    callbacks_[i]({SuccessExecutionResult()});
+    EXPECT_EQ(batches_.size(), i + 3);
+  }
+  callbacks_[3]({SuccessExecutionResult()});
+  EXPECT_FALSE(result_);
+  callbacks_[4]({SuccessExecutionResult()});
+
+  ASSERT_TRUE(result_);
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(BatchBlobDeleterTest, FailsBlobsWithoutResult) {
+  AddBlob("bucket", "blob_1");
+  AddBlob("bucket", "blob_2");
+  Start(10 /*batch_size*/, 2 /*parallelism*/);
+  ASSERT_EQ(callbacks_.size(), 1);
+
+  callbacks_[0]({SuccessExecutionResult()});
+
+  ASSERT_TRUE(result_);
+  EXPECT_SUCCESS(*result_);
+  EXPECT_SUCCESS(ExecutionResult(response_->blob_results(0).result()));
+  EXPECT_THAT(ExecutionResult(response_->blob_results(1).result()),
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_UNRETRIABLE_ERROR)));
+}
+}  // namespace google::scp::cpio::client_providers::test
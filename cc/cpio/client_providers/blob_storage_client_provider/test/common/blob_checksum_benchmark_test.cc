@@ -0,0 +1,73 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
+using std::string;
+using std::string_view;
+
+namespace {
+constexpr uint64_t kBlobSize = 64 << 20;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+
+// Args: checksum algorithm, bytes per update, which stands for the bytes per
+// PutBlobStream request. The CPU time per GiB checksummed is reported.
+static void BM_BlobChecksum(benchmark::State& state) {
+  string blob(kBlobSize, 'a');
+  for (size_t i = 0; i < blob.size(); ++i) {
+    blob[i] = static_cast<char>(i * 0x9e3779b9 >> 24);
+  }
+  auto algorithm = static_cast<ChecksumAlgorithm>(state.range(0));
+  const size_t update_size = state.range(1);
+
+  for (auto _ : state) {
+    BlobChecksum checksum(algorithm);
+    for (size_t offset = 0; offset < blob.size(); offset += update_size) {
+      checksum.Update(string_view(blob).substr(offset, update_size));
+    }
+    benchmark::DoNotOptimize(checksum.Finish());
+  }
+  state.SetBytesProcessed(state.iterations() * kBlobSize);
+  state.counters["cpu_seconds_per_gib"] = benchmark::Counter(
+      static_cast<double>(kBlobSize) / (1 << 30),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+  state.counters["crc32c_accelerated"] = BlobChecksum::IsCrc32cAccelerated();
+}
+
+BENCHMARK(BM_BlobChecksum)
+    ->ArgNames({"algorithm", "update_size"})
+    ->ArgsProduct({{CHECKSUM_ALGORITHM_NONE, CHECKSUM_ALGORITHM_MD5,
+                    CHECKSUM_ALGORITHM_CRC32C},
+                   {64 << 10, 1 << 20}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
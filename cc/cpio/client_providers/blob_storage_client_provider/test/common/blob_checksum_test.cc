@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/blob_checksum.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
+using google::cmrt::sdk::blob_storage_service::v1::
+    CHECKSUM_ALGORITHM_UNSPECIFIED;
+using std::string;
+
+namespace {
+// Computes the CRC32C a bit at a time, as in its definition.
+uint32_t ComputeCrc32cBitwise(const string& data) {
+  uint32_t crc = ~0u;
+  for (unsigned char byte : data) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (crc & 1 ? 0x82f63b78 : 0);
+    }
+  }
+  return ~crc;
+}
+
+string CreateRandomData(size_t size) {
+  std::mt19937 generator(size);
+  string data(size, '\0');
+  for (auto& byte : data) {
+    byte = static_cast<char>(generator());
+  }
+  return data;
+}
+
+string ToHex(const string& bytes) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  string hex;
+  for (unsigned char byte : bytes) {
+    hex.push_back(kHexDigits[byte >> 4]);
+    hex.push_back(kHexDigits[byte & 0xf]);
+  }
+  return hex;
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+TEST(BlobChecksumTest, ComputesKnownCrc32c) {
+  EXPECT_EQ(BlobChecksum::ExtendCrc32c(0, ""), 0);
+  EXPECT_EQ(BlobChecksum::ExtendCrc32c(0, "123456789"), 0xe3069283);
+  EXPECT_EQ(BlobChecksum::ExtendCrc32c(0, string(32, '\0')), 0x8a9136aa);
+  EXPECT_EQ(BlobChecksum::ExtendCrc32c(0, string(32, '\xff')), 0x62a8ab43);
+}
+
+TEST(BlobChecksumTest, ComputesCrc32cOfLongData) {
+  // Long enough for a few rounds of the interleaved streams, and not a
+  // multiple of them.
+  for (size_t size : {7, 8, 100, 24 << 10, (100 << 10) + 13}) {
+    auto data = CreateRandomData(size);
+    EXPECT_EQ(BlobChecksum::ExtendCrc32c(0, data), ComputeCrc32cBitwise(data))
+        << size;
+  }
+}
+
+TEST(BlobChecksumTest, ExtendsCrc32cAcrossUpdates) {
+  auto data = CreateRandomData(200 << 10);
+  BlobChecksum whole(CHECKSUM_ALGORITHM_CRC32C);
+  whole.Update(data);
+  BlobChecksum pieces(CHECKSUM_ALGORITHM_CRC32C);
+  for (size_t offset = 0, size = 1; offset < data.size();
+       offset += size, size = size * 3 + 1) {
+    pieces.Update(std::string_view(data).substr(offset, size));
+  }
+
+  auto crc = ComputeCrc32cBitwise(data);
+  string expected_digest = {
+      static_cast<char>(crc >> 24), static_cast<char>(crc >> 16),
+      static_cast<char>(crc >> 8), static_cast<char>(crc)};
+  EXPECT_EQ(whole.Finish(), expected_digest);
+  EXPECT_EQ(pieces.Finish(), expected_digest);
+}
+
+TEST(BlobChecksumTest, ComputesKnownMd5) {
+  BlobChecksum checksum(CHECKSUM_ALGORITHM_MD5);
+  EXPECT_EQ(ToHex(checksum.Finish()), "d41d8cd98f00b204e9800998ecf8427e");
+  checksum.Update("a");
+  checksum.Update("bc");
+  EXPECT_EQ(ToHex(checksum.Finish()), "900150983cd24fb0d6963f7d28e17f72");
+}
+
+TEST(BlobChecksumTest, StartsOverAfterFinish) {
+  for (auto algorithm : {CHECKSUM_ALGORITHM_MD5, CHECKSUM_ALGORITHM_CRC32C}) {
+    BlobChecksum checksum(algorithm);
+    checksum.Update("first");
+    checksum.Finish();
+    checksum.Update("second");
+    BlobChecksum expected(algorithm);
+    expected.Update("second");
+    EXPECT_EQ(checksum.Finish(), expected.Finish());
+  }
+}
+
+TEST(BlobChecksumTest, DefaultsToMd5) {
+  BlobChecksum checksum(CHECKSUM_ALGORITHM_UNSPECIFIED);
+  EXPECT_EQ(checksum.GetAlgorithm(), CHECKSUM_ALGORITHM_MD5);
+  EXPECT_EQ(checksum.Finish().size(), 16);
+}
+
+TEST(BlobChecksumTest, HasNoDigestWithoutAlgorithm) {
+  BlobChecksum checksum(CHECKSUM_ALGORITHM_NONE);
+  checksum.Update("data");
+  EXPECT_EQ(checksum.Finish(), "");
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_blob_lister.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::promise;
+using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using PageContext =
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>;
+
+namespace {
+constexpr size_t kBlobCount = 1 << 20;
+constexpr char kPrefix[] = "blobs/";
+// Latency injected in each page, which stands for the round trip to the
+// storage service.
+constexpr milliseconds kPageLatency = milliseconds(20);
+
+// Names the blobs either in the order they were written, which packs them
+// into a few digits, or by a hash, which spreads them over the hex digits.
+vector<string> CreateBlobNames(bool is_hashed) {
+  vector<string> blob_names;
+  blob_names.reserve(kBlobCount);
+  char name[32];
+  for (uint64_t i = 0; i < kBlobCount; ++i) {
+    auto id = is_hashed ? i * 0x9e3779b97f4a7c15 : i;
+    snprintf(name, sizeof(name), is_hashed ? "%016" PRIx64 : "%08" PRIu64, id);
+    blob_names.push_back(string(kPrefix) + name);
+  }
+  std::sort(blob_names.begin(), blob_names.end());
+  return blob_names;
+}
+
+// Emulates a storage service holding the blobs, which lists each page after
+// the latency no matter how many pages are in flight.
+class EmulatedBlobStorage {
+ public:
+  explicit EmulatedBlobStorage(vector<string> blob_names)
+      : blob_names_(move(blob_names)), thread_([this] { Serve(); }) {}
+
+  ~EmulatedBlobStorage() {
+    {
+      lock_guard lock(mutex_);
+      is_stopped_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+  }
+
+  void ListPage(PageContext& page_context) {
+    {
+      lock_guard lock(mutex_);
+      pages_.emplace(steady_clock::now() + kPageLatency, page_context);
+      page_count_++;
+    }
+    condition_.notify_one();
+  }
+
+  size_t GetPageCount() {
+    lock_guard lock(mutex_);
+    return page_count_;
+  }
+
+ private:
+  void Serve() {
+    std::unique_lock lock(mutex_);
+    while (!is_stopped_) {
+      if (pages_.empty()) {
+        condition_.wait(lock);
+        continue;
+      }
+      auto due_time = pages_.begin()->first;
+      if (steady_clock::now() < due_time) {
+        condition_.wait_until(lock, due_time);
+        continue;
+      }
+      auto page_context = move(pages_.begin()->second);
+      pages_.erase(pages_.begin());
+      lock.unlock();
+      FinishPage(page_context);
+      lock.lock();
+    }
+  }
+
+  void FinishPage(PageContext& page_context) {
+    const auto& request = *page_context.request;
+    auto it = request.has_page_token()
+                  ? std::upper_bound(blob_names_.begin(), blob_names_.end(),
+                                     request.page_token())
+                  : blob_names_.begin();
+    page_context.response = make_shared<ListBlobsMetadataResponse>();
+    for (uint64_t i = 0; it != blob_names_.end() && i < request.max_page_size();
+         ++it, ++i) {
+      page_context.response->add_blob_metadatas()->set_blob_name(*it);
+    }
+    page_context.result = SuccessExecutionResult();
+    page_context.Finish();
+  }
+
+  const vector<string> blob_names_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::multimap<steady_clock::time_point, PageContext> pages_;
+  size_t page_count_ = 0;
+  bool is_stopped_ = false;
+  std::thread thread_;
+};
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+
+// Args: parallelism, whether the names are hashed. Parallelism of 1 lists
+// like a loop over ListBlobsMetadata.
+static void BM_ListAllBlobsMetadata(benchmark::State& state) {
+  auto cpu_async_executor =
+      make_shared<AsyncExecutor>(2 /* thread_count */, 100000 /* queue_cap */);
+  cpu_async_executor->Init();
+  cpu_async_executor->Run();
+  EmulatedBlobStorage storage(CreateBlobNames(state.range(1)));
+
+  std::atomic<size_t> listed_count = 0;
+  for (auto _ : state) {
+    promise<void> done;
+    ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                             ListAllBlobsMetadataResponse>
+        context;
+    context.request = make_shared<ListAllBlobsMetadataRequest>();
+    context.request->mutable_blob_metadata()->set_blob_name(kPrefix);
+    context.process_callback = [&](auto& context, bool is_finish) {
+      if (is_finish) {
+        // Responses may still be queued behind the finish.
+        while (auto response = context.TryGetNextResponse()) {
+          listed_count += response->blob_metadatas().size();
+        }
+        done.set_value();
+        return;
+      }
+      if (auto response = context.TryGetNextResponse()) {
+        listed_count += response->blob_metadatas().size();
+      }
+    };
+    make_shared<ParallelBlobLister>(
+        context,
+        [&storage](PageContext& page_context) {
+          storage.ListPage(page_context);
+        },
+        state.range(0), cpu_async_executor)
+        ->Start();
+    done.get_future().wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kBlobCount);
+  state.counters["listed_per_iteration"] =
+      static_cast<double>(listed_count.load()) / state.iterations();
+  // Pages beyond the blob count over the page size are spent on ranges which
+  // turned out to be sparse.
+  state.counters["pages_per_iteration"] =
+      static_cast<double>(storage.GetPageCount()) / state.iterations();
+
+  cpu_async_executor->Stop();
+}
+
+BENCHMARK(BM_ListAllBlobsMetadata)
+    ->ArgNames({"parallelism", "hashed"})
+    ->ArgsProduct({{1, 4, 16, 64}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
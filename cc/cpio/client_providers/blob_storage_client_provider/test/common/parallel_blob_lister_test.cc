@@ -0,0 +1,336 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_blob_lister.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::
+    ListAllBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::move;
+using std::optional;
+using std::set;
+using std::string;
+using std::to_string;
+using std::vector;
+
+namespace {
+constexpr char kBucketName[] = "bucket";
+constexpr char kPrefix[] = "dir/";
+constexpr uint64_t kPageSize = 10;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class ParallelBlobListerTest : public testing::Test {
+ protected:
+  using PageContext =
+      AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>;
+
+  ParallelBlobListerTest() {
+    context_.request = make_shared<ListAllBlobsMetadataRequest>();
+    context_.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context_.request->mutable_blob_metadata()->set_blob_name(kPrefix);
+    context_.request->set_max_page_size(kPageSize);
+    context_.process_callback = [this](auto& context, bool is_finish) {
+      if (is_finish) {
+        result_ = context.result;
+        return;
+      }
+      auto response = context.TryGetNextResponse();
+      ASSERT_NE(response, nullptr);
+      responses_.push_back(move(*response));
+    };
+    // Blobs outside of the prefix are never listed.
+    blob_names_ = {"a", "dir", "dir0", "z"};
+  }
+
+  // Adds count blobs with the name prefix, numbered from 0.
+  void AddBlobs(const string& name_prefix, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      auto number = to_string(i);
+      blob_names_.insert(name_prefix + string(6 - number.size(), '0') +
+                         number);
+    }
+  }
+
+  // Starts a lister whose pages are held until FinishPage().
+  void Start(size_t parallelism) {
+    make_shared<ParallelBlobLister>(
+        context_,
+        [this](PageContext& page_context) {
+          pages_.push_back(page_context);
+        },
+        parallelism, make_shared<MockAsyncExecutor>())
+        ->Start();
+  }
+
+  // Finishes the oldest page in flight with the blobs of its request.
+  void FinishPage() {
+    ASSERT_FALSE(pages_.empty());
+    auto page_context = move(pages_.front());
+    pages_.erase(pages_.begin());
+    const auto& request = *page_context.request;
+    EXPECT_EQ(request.blob_metadata().bucket_name(), kBucketName);
+    EXPECT_EQ(request.max_page_size(), kPageSize);
+    const auto& prefix = request.blob_metadata().blob_name();
+    page_context.response = make_shared<ListBlobsMetadataResponse>();
+    auto it = request.has_page_token()
+                  ? blob_names_.upper_bound(request.page_token())
+                  : blob_names_.lower_bound(prefix);
+    for (; it != blob_names_.end() &&
+           it->compare(0, prefix.size(), prefix) == 0 &&
+           page_context.response->blob_metadatas().size() <
+               request.max_page_size();
+         ++it) {
+      auto* blob_metadata = page_context.response->add_blob_metadatas();
+      blob_metadata->set_bucket_name(kBucketName);
+      blob_metadata->set_blob_name(*it);
+    }
+    page_context.result = SuccessExecutionResult();
+    page_context.Finish();
+  }
+
+  // Finishes pages until none is in flight.
+  void FinishAllPages() {
+    while (!pages_.empty()) {
+      FinishPage();
+    }
+  }
+
+  // The names of all the responses, checking that each response is in order.
+  vector<string> GetListedNames() {
+    vector<string> names;
+    for (const auto& response : responses_) {
+      EXPECT_FALSE(response.blob_metadatas().empty());
+      vector<string> response_names;
+      for (const auto& blob_metadata : response.blob_metadatas()) {
+        EXPECT_EQ(blob_metadata.bucket_name(), kBucketName);
+        response_names.push_back(blob_metadata.blob_name());
+      }
+      EXPECT_TRUE(std::is_sorted(response_names.begin(), response_names.end()));
+      names.insert(names.end(), response_names.begin(), response_names.end());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  // The names of the blobs with the prefix, in order.
+  vector<string> GetExpectedNames() {
+    vector<string> names;
+    for (const auto& name : blob_names_) {
+      if (name.compare(0, sizeof(kPrefix) - 1, kPrefix) == 0) {
+        names.push_back(name);
+      }
+    }
+    return names;
+  }
+
+  ConsumerStreamingContext<ListAllBlobsMetadataRequest,
+                           ListAllBlobsMetadataResponse>
+      context_;
+  set<string> blob_names_;
+  vector<PageContext> pages_;
+  vector<ListAllBlobsMetadataResponse> responses_;
+  optional<ExecutionResult> result_;
+};
+
+TEST_F(ParallelBlobListerTest, ListsFirstPageAlone) {
+  AddBlobs("dir/", 100);
+  Start(4);
+  ASSERT_EQ(pages_.size(), 1);
+  EXPECT_FALSE(pages_[0].request->has_page_token());
+
+  FinishPage();
+  // The rest of the names are split into a range per slot.
+  ASSERT_EQ(pages_.size(), 4);
+  EXPECT_EQ(pages_[0].request->page_token(), "dir/000009");
+  for (size_t i = 1; i < pages_.size(); ++i) {
+    EXPECT_GT(pages_[i].request->page_token(),
+              pages_[i - 1].request->page_token());
+  }
+  EXPECT_EQ(GetListedNames().size(), kPageSize);
+}
+
+TEST_F(ParallelBlobListerTest, ListsEveryNameOnce) {
+  AddBlobs("dir/a/", 137);
+  AddBlobs("dir/b", 5);
+  AddBlobs("dir/z/", 61);
+  Start(8);
+  FinishAllPages();
+
+  EXPECT_EQ(GetListedNames(), GetExpectedNames());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+  EXPECT_TRUE(context_.IsMarkedDone());
+}
+
+TEST_F(ParallelBlobListerTest, ListsNonAsciiNames) {
+  AddBlobs("dir/\xc3\xa9/", 45);
+  AddBlobs("dir/", 45);
+  Start(4);
+  FinishAllPages();
+
+  EXPECT_EQ(GetListedNames(), GetExpectedNames());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelBlobListerTest, ListsWithoutParallelism) {
+  AddBlobs("dir/", 35);
+  Start(1);
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(pages_.size(), 1);
+    FinishPage();
+  }
+
+  EXPECT_TRUE(pages_.empty());
+  EXPECT_EQ(GetListedNames(), GetExpectedNames());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelBlobListerTest, FinishesWithoutBlobs) {
+  Start(4);
+  FinishPage();
+
+  EXPECT_TRUE(pages_.empty());
+  EXPECT_TRUE(responses_.empty());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelBlobListerTest, FailsWhenAPageFails) {
+  AddBlobs("dir/", 100);
+  Start(4);
+  FinishPage();
+  ASSERT_EQ(pages_.size(), 4);
+
+  auto failed_page = move(pages_[1]);
+  pages_.erase(pages_.begin() + 1);
+  failed_page.result =
+      FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+  failed_page.Finish();
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB)));
+
+  // The pages still in flight are dropped, and nothing more is listed.
+  auto response_count = responses_.size();
+  FinishAllPages();
+  EXPECT_EQ(responses_.size(), response_count);
+}
+
+TEST_F(ParallelBlobListerTest, FailsWithTooLargePageSize) {
+  AddBlobs("dir/", 100);
+  context_.request->set_max_page_size(1001);
+  Start(4);
+
+  // Nothing is listed, and the stream is finished right away.
+  EXPECT_TRUE(pages_.empty());
+  EXPECT_TRUE(responses_.empty());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(ParallelBlobListerTest, FailsWithoutBucketName) {
+  context_.request->mutable_blob_metadata()->clear_bucket_name();
+  Start(4);
+
+  EXPECT_TRUE(pages_.empty());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(ParallelBlobListerTest, FailsWhenCancelled) {
+  AddBlobs("dir/", 100);
+  Start(4);
+  context_.TryCancel();
+  FinishPage();
+
+  EXPECT_TRUE(pages_.empty());
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_,
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED)));
+}
+
+TEST(ParallelBlobListerSplitTest, SplitsEvenly) {
+  EXPECT_EQ(ParallelBlobLister::GetSplitNames("a", "a", "c", 1),
+            vector<string>({"b"}));
+  EXPECT_EQ(ParallelBlobLister::GetSplitNames("a", "a", "b", 1),
+            vector<string>({"a@"}));
+  EXPECT_EQ(ParallelBlobLister::GetSplitNames("a", "a", "e", 3),
+            vector<string>({"b", "c", "d"}));
+
+  for (const auto& [last, before] :
+       vector<std::pair<string, string>>{{"a", "a0"},
+                                         {"dir/a", "dir/b/0"},
+                                         {"a\xc3\xa9", "c"}}) {
+    auto split_names = ParallelBlobLister::GetSplitNames(last, last, before, 4);
+    ASSERT_FALSE(split_names.empty()) << last << " " << before;
+    EXPECT_TRUE(std::is_sorted(split_names.begin(), split_names.end()));
+    EXPECT_GT(split_names.front(), last);
+    EXPECT_LT(split_names.back(), before);
+  }
+}
+
+TEST(ParallelBlobListerSplitTest, SplitsNoFinerThanThePage) {
+  // The page took a tenth of the names left, so there is room for 9 ranges.
+  EXPECT_EQ(ParallelBlobLister::GetSplitNames("a", "b", "l", 16).size(), 9);
+  // The names left would fit in a page.
+  EXPECT_TRUE(ParallelBlobLister::GetSplitNames("a", "k", "l", 16).empty());
+}
+
+TEST(ParallelBlobListerSplitTest, FailsWithoutNameInBetween) {
+  EXPECT_TRUE(ParallelBlobLister::GetSplitNames("a", "a", "a", 1).empty());
+  EXPECT_TRUE(ParallelBlobLister::GetSplitNames("b", "b", "a", 1).empty());
+  // Every ASCII name between them starts with "a", which sorts before "a\xc3".
+  EXPECT_TRUE(
+      ParallelBlobLister::GetSplitNames("a", "a\xc3\xa9", "b", 1).empty());
+  // Only a name with a NUL is in between.
+  EXPECT_TRUE(ParallelBlobLister::GetSplitNames("a", "a", "a\x01", 1).empty());
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_part_uploader.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::common::TimeProvider;
+using std::make_shared;
+using std::promise;
+using std::string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+namespace {
+constexpr uint64_t kBlobSize = 64 << 20;
+constexpr uint64_t kBytesPerRequest = 1 << 20;
+// Latency injected in each part upload, which stands for the round trip to
+// the storage service.
+constexpr milliseconds kUploadLatency = milliseconds(20);
+// The bandwidth of a single connection to the storage service.
+constexpr double kConnectionBytesPerSecond = 100 << 20;
+constexpr size_t kIoThreadCount = 32;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+
+// Args: parallelism, part size in bytes. Parallelism of 1 uploads like the
+// sequential PutBlobStream.
+static void BM_PutBlobStream(benchmark::State& state) {
+  auto io_async_executor =
+      make_shared<AsyncExecutor>(kIoThreadCount, 100000 /* queue_cap */);
+  io_async_executor->Init();
+  io_async_executor->Run();
+
+  // Acknowledges the part after the latency and transfer time of a
+  // connection.
+  auto upload_part = [&](int part_number, string part, string checksum,
+                         ParallelPartUploader::PartCallback callback) {
+    io_async_executor->Schedule(
+        [size = part.size(), callback]() {
+          sleep_for(kUploadLatency +
+                    duration<double>(size / kConnectionBytesPerSecond));
+          callback(string("etag"));
+        },
+        AsyncPriority::Normal);
+  };
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+        context;
+    context.request = make_shared<PutBlobStreamRequest>();
+    context.request->mutable_blob_portion()->mutable_metadata()->set_blob_name(
+        "blob");
+    context.request->mutable_blob_portion()->set_data(
+        string(kBytesPerRequest, 'a'));
+    for (uint64_t i = 1; i < kBlobSize / kBytesPerRequest; i++) {
+      context.TryPushRequest(*context.request);
+    }
+    context.MarkDone();
+    state.ResumeTiming();
+
+    promise<void> done;
+    make_shared<ParallelPartUploader>(
+        context, upload_part,
+        [&done](ExecutionResult result, vector<string> part_ids) {
+          benchmark::DoNotOptimize(part_ids);
+          done.set_value();
+        },
+        state.range(1), CHECKSUM_ALGORITHM_MD5, state.range(0),
+        TimeProvider::GetWallTimestampInNanoseconds() + hours(1),
+        milliseconds(1), io_async_executor)
+        ->Start();
+    done.get_future().wait();
+  }
+  state.SetBytesProcessed(state.iterations() * kBlobSize);
+
+  io_async_executor->Stop();
+}
+
+BENCHMARK(BM_PutBlobStream)
+    ->ArgNames({"parallelism", "part_size"})
+    ->ArgsProduct({{1, 2, 4, 8, 16, 32}, {5 << 20, 8 << 20, 16 << 20}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
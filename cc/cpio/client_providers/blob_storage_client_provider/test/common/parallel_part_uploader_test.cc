@@ -0,0 +1,359 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_part_uploader.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <openssl/md5.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::ChecksumAlgorithm;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_MD5;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_NONE;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncOperation;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
+using google::scp::core::test::ResultIs;
+using std::function;
+using std::make_shared;
+using std::move;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::hours;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+using testing::UnorderedElementsAre;
+
+namespace {
+constexpr char kBucketName[] = "bucket";
+constexpr char kBlobName[] = "blob";
+
+string GetMd5Digest(const string& data) {
+  unsigned char md5_digest[MD5_DIGEST_LENGTH];
+  MD5(reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+      md5_digest);
+  return string(reinterpret_cast<char*>(md5_digest), MD5_DIGEST_LENGTH);
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class ParallelPartUploaderTest : public testing::Test {
+ protected:
+  struct Upload {
+    int part_number;
+    string part, checksum;
+    ParallelPartUploader::PartCallback callback;
+  };
+
+  ParallelPartUploaderTest() {
+    context_.request = MakeRequest("abcdefghij");
+    io_async_executor_->schedule_for_mock =
+        [this](const AsyncOperation& work, Timestamp,
+               function<bool()>&) -> ExecutionResult {
+      polls_.push_back(work);
+      return SuccessExecutionResult();
+    };
+  }
+
+  static shared_ptr<PutBlobStreamRequest> MakeRequest(
+      const string& data, const string& blob_name = kBlobName) {
+    auto request = make_shared<PutBlobStreamRequest>();
+    request->mutable_blob_portion()->mutable_metadata()->set_bucket_name(
+        kBucketName);
+    request->mutable_blob_portion()->mutable_metadata()->set_blob_name(
+        blob_name);
+    request->mutable_blob_portion()->set_data(data);
+    return request;
+  }
+
+  // Starts an uploader whose uploads are held until FinishUpload().
+  void Start(uint64_t part_size, size_t parallelism,
+             nanoseconds expiry_time_ns =
+                 TimeProvider::GetWallTimestampInNanoseconds() + hours(1)) {
+    make_shared<ParallelPartUploader>(
+        context_,
+        [this](int part_number, string part, string checksum,
+               ParallelPartUploader::PartCallback callback) {
+          uploads_.push_back(
+              {part_number, move(part), move(checksum), move(callback)});
+        },
+        [this](ExecutionResult result, vector<string> part_ids) {
+          ASSERT_FALSE(result_.has_value());
+          result_ = result;
+          part_ids_ = move(part_ids);
+        },
+        part_size, checksum_algorithm_, parallelism, expiry_time_ns,
+        seconds(5), io_async_executor_)
+        ->Start();
+  }
+
+  void PushRequest(const string& data, const string& blob_name = kBlobName) {
+    EXPECT_SUCCESS(
+        context_.TryPushRequest(move(*MakeRequest(data, blob_name))));
+  }
+
+  // Finishes the upload in flight of the part, with an ID of "id<part>".
+  void FinishUpload(int part_number) {
+    TakeUpload(part_number).callback("id" + to_string(part_number));
+  }
+
+  Upload TakeUpload(int part_number) {
+    for (auto it = uploads_.begin(); it != uploads_.end(); ++it) {
+      if (it->part_number == part_number) {
+        auto upload = move(*it);
+        uploads_.erase(it);
+        return upload;
+      }
+    }
+    ADD_FAILURE() << "No upload in flight of part " << part_number;
+    return {};
+  }
+
+  vector<string> GetPartsInFlight() {
+    vector<string> parts;
+    for (const auto& upload : uploads_) {
+      parts.push_back(upload.part);
+    }
+    return parts;
+  }
+
+  void RunPolls() {
+    auto polls = move(polls_);
+    polls_.clear();
+    for (auto& poll : polls) {
+      poll();
+    }
+  }
+
+  ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+      context_;
+  ChecksumAlgorithm checksum_algorithm_ = CHECKSUM_ALGORITHM_MD5;
+  shared_ptr<MockAsyncExecutor> io_async_executor_ =
+      make_shared<MockAsyncExecutor>();
+  vector<Upload> uploads_;
+  vector<AsyncOperation> polls_;
+  optional<ExecutionResult> result_;
+  vector<string> part_ids_;
+};
+
+TEST_F(ParallelPartUploaderTest, UploadsUpToParallelismParts) {
+  Start(4, 2);
+  // "ij" stays in the current part.
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"abcd", "efgh"}));
+  EXPECT_TRUE(polls_.empty());
+
+  PushRequest("klmnopqrstu");
+  FinishUpload(2);
+  // Only one more part is in flight, and the data after it waits.
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"abcd", "ijkl"}));
+  FinishUpload(1);
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"ijkl", "mnop"}));
+  FinishUpload(3);
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"mnop", "qrst"}));
+  EXPECT_FALSE(result_.has_value());
+}
+
+TEST_F(ParallelPartUploaderTest, ReturnsPartIdsInOrder) {
+  Start(4, 3);
+  PushRequest("klmnopqrstuvwxyz");
+  context_.MarkDone();
+  FinishUpload(2);
+  FinishUpload(3);
+  FinishUpload(4);
+  FinishUpload(1);
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"qrst", "uvwx", "yz"}));
+  FinishUpload(7);
+  FinishUpload(5);
+  EXPECT_FALSE(result_.has_value());
+  FinishUpload(6);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+  EXPECT_EQ(part_ids_, vector<string>({"id1", "id2", "id3", "id4", "id5", "id6",
+                                       "id7"}));
+  EXPECT_TRUE(uploads_.empty());
+}
+
+TEST_F(ParallelPartUploaderTest, ComputesMd5OfEachPart) {
+  PushRequest("klm");
+  context_.MarkDone();
+  Start(6, 4);
+
+  ASSERT_EQ(uploads_.size(), 3);
+  for (const auto& upload : uploads_) {
+    EXPECT_EQ(upload.checksum, GetMd5Digest(upload.part)) << upload.part;
+  }
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"abcdef", "ghijkl", "m"}));
+}
+
+TEST_F(ParallelPartUploaderTest, ComputesCrc32cOfEachPart) {
+  checksum_algorithm_ = CHECKSUM_ALGORITHM_CRC32C;
+  PushRequest("klm");
+  context_.MarkDone();
+  Start(6, 4);
+
+  ASSERT_EQ(uploads_.size(), 3);
+  for (const auto& upload : uploads_) {
+    BlobChecksum checksum(CHECKSUM_ALGORITHM_CRC32C);
+    checksum.Update(upload.part);
+    EXPECT_EQ(upload.checksum, checksum.Finish()) << upload.part;
+  }
+}
+
+TEST_F(ParallelPartUploaderTest, ComputesNoChecksumWithoutAlgorithm) {
+  checksum_algorithm_ = CHECKSUM_ALGORITHM_NONE;
+  context_.MarkDone();
+  Start(6, 4);
+
+  ASSERT_EQ(uploads_.size(), 2);
+  for (const auto& upload : uploads_) {
+    EXPECT_TRUE(upload.checksum.empty());
+  }
+}
+
+TEST_F(ParallelPartUploaderTest, PollsOnlyWithoutPartsInFlight) {
+  Start(4, 2);
+  FinishUpload(1);
+  // The part in flight pumps once it is done.
+  EXPECT_TRUE(polls_.empty());
+  FinishUpload(2);
+  EXPECT_EQ(polls_.size(), 1);
+
+  RunPolls();
+  EXPECT_EQ(polls_.size(), 1);
+  PushRequest("kl");
+  context_.MarkDone();
+  RunPolls();
+  EXPECT_TRUE(polls_.empty());
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"ijkl"}));
+  FinishUpload(3);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+  EXPECT_EQ(part_ids_, vector<string>({"id1", "id2", "id3"}));
+}
+
+TEST_F(ParallelPartUploaderTest, FailsOnceNoPartIsInFlight) {
+  Start(2, 3);
+  auto failure =
+      FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+  TakeUpload(2).callback(failure);
+  // No new part is uploaded after the failure.
+  EXPECT_EQ(GetPartsInFlight(), vector<string>({"ab", "ef"}));
+  FinishUpload(1);
+  EXPECT_FALSE(result_.has_value());
+  FinishUpload(3);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(failure));
+  EXPECT_TRUE(part_ids_.empty());
+  EXPECT_TRUE(uploads_.empty());
+}
+
+TEST_F(ParallelPartUploaderTest, FailsOnRequestForAnotherBlob) {
+  Start(4, 4);
+  PushRequest("kl", "other_blob");
+  FinishUpload(1);
+  FinishUpload(2);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(ParallelPartUploaderTest, StopsWhenCancelled) {
+  Start(4, 2);
+  context_.TryCancel();
+  FinishUpload(1);
+  EXPECT_FALSE(result_.has_value());
+  FinishUpload(2);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_,
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED)));
+  EXPECT_TRUE(uploads_.empty());
+}
+
+TEST_F(ParallelPartUploaderTest, FailsWhenExpired) {
+  Start(4, 2, TimeProvider::GetWallTimestampInNanoseconds() - seconds(1));
+  FinishUpload(1);
+  FinishUpload(2);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(FailureExecutionResult(
+                            SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED)));
+  EXPECT_TRUE(polls_.empty());
+}
+
+TEST_F(ParallelPartUploaderTest, UploadsCalledBackOnTheCallingThread) {
+  vector<string> parts;
+  context_.MarkDone();
+  make_shared<ParallelPartUploader>(
+      context_,
+      [&parts](int part_number, string part, string checksum,
+               ParallelPartUploader::PartCallback callback) {
+        parts.push_back(move(part));
+        callback("id" + to_string(part_number));
+      },
+      [this](ExecutionResult result, vector<string> part_ids) {
+        result_ = result;
+        part_ids_ = move(part_ids);
+      },
+      3, CHECKSUM_ALGORITHM_MD5, 2,
+      TimeProvider::GetWallTimestampInNanoseconds() + hours(1), seconds(5),
+      io_async_executor_)
+      ->Start();
+
+  // Each upload which finishes starts the next one before returning.
+  EXPECT_THAT(parts, UnorderedElementsAre("abc", "def", "ghi", "j"));
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+  EXPECT_EQ(part_ids_, vector<string>({"id1", "id2", "id3", "id4"}));
+}
+}  // namespace google::scp::cpio::client_providers::test
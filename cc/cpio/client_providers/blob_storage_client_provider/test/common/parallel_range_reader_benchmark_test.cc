@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_range_reader.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ConsumerStreamingContext;
+using std::make_shared;
+using std::promise;
+using std::shared_ptr;
+using std::string;
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+namespace {
+constexpr uint64_t kBlobSize = 32 << 20;
+constexpr uint64_t kMaxBytesPerResponse = 1 << 20;
+// Latency injected in each ranged read, which stands for the round trip to
+// the storage service.
+constexpr milliseconds kReadLatency = milliseconds(20);
+// The bandwidth of a single connection to the storage service.
+constexpr double kConnectionBytesPerSecond = 100 << 20;
+constexpr size_t kIoThreadCount = 32;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+
+// Args: parallelism, part size in bytes. Parallelism of 1 with a part size of
+// kMaxBytesPerResponse reads like the sequential GetBlobStream.
+static void BM_GetBlobStream(benchmark::State& state) {
+  auto io_async_executor =
+      make_shared<AsyncExecutor>(kIoThreadCount, 100000 /* queue_cap */);
+  auto cpu_async_executor =
+      make_shared<AsyncExecutor>(2 /* thread_count */, 100000 /* queue_cap */);
+  io_async_executor->Init();
+  io_async_executor->Run();
+  cpu_async_executor->Init();
+  cpu_async_executor->Run();
+  const string blob(kBlobSize, 'a');
+
+  // Serves the part out of memory after the latency and transfer time of a
+  // connection.
+  auto read_range = [&](uint64_t begin_byte_index, uint64_t end_byte_index,
+                        ParallelRangeReader::PartCallback callback) {
+    io_async_executor->Schedule(
+        [&blob, begin_byte_index, end_byte_index, callback]() {
+          auto size = end_byte_index - begin_byte_index + 1;
+          sleep_for(kReadLatency +
+                    duration<double>(size / kConnectionBytesPerSecond));
+          callback(blob.substr(begin_byte_index, size), blob.size());
+        },
+        AsyncPriority::Normal);
+  };
+
+  for (auto _ : state) {
+    promise<void> done;
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+        context;
+    context.request = make_shared<GetBlobStreamRequest>();
+    context.request->set_max_bytes_per_response(kMaxBytesPerResponse);
+    context.process_callback = [&done](auto& context, bool is_finish) {
+      if (is_finish) {
+        done.set_value();
+        return;
+      }
+      benchmark::DoNotOptimize(context.TryGetNextResponse());
+    };
+    make_shared<ParallelRangeReader>(context, read_range, state.range(1),
+                                     state.range(0), cpu_async_executor)
+        ->Start();
+    done.get_future().wait();
+  }
+  state.SetBytesProcessed(state.iterations() * kBlobSize);
+
+  cpu_async_executor->Stop();
+  io_async_executor->Stop();
+}
+
+BENCHMARK(BM_GetBlobStream)
+    ->ArgNames({"parallelism", "part_size"})
+    ->ArgsProduct({{1, 2, 4, 8, 16, 32}, {1 << 20, 4 << 20, 8 << 20}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
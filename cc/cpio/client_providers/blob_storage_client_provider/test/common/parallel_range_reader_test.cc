@@ -0,0 +1,308 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/common/parallel_range_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::move;
+using std::nullopt;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+constexpr char kBucketName[] = "bucket";
+constexpr char kBlobName[] = "blob";
+constexpr char kBlob[] = "abcdefghijklmnopqrstuvwxyz";
+constexpr uint64_t kBlobSize = sizeof(kBlob) - 1;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class ParallelRangeReaderTest : public testing::Test {
+ protected:
+  struct Read {
+    uint64_t begin_byte_index, end_byte_index;
+    ParallelRangeReader::PartCallback callback;
+  };
+
+  ParallelRangeReaderTest() {
+    context_.request = make_shared<GetBlobStreamRequest>();
+    context_.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context_.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+    context_.process_callback = [this](auto& context, bool is_finish) {
+      if (is_finish) {
+        result_ = context.result;
+        return;
+      }
+      auto response = context.TryGetNextResponse();
+      ASSERT_NE(response, nullptr);
+      responses_.push_back(move(*response));
+    };
+  }
+
+  // Starts a reader whose reads are held until FinishRead().
+  void Start(uint64_t part_size, size_t parallelism) {
+    make_shared<ParallelRangeReader>(
+        context_,
+        [this](uint64_t begin_byte_index, uint64_t end_byte_index,
+               ParallelRangeReader::PartCallback callback) {
+          reads_.push_back({begin_byte_index, end_byte_index, move(callback)});
+        },
+        part_size, parallelism, make_shared<MockAsyncExecutor>())
+        ->Start();
+  }
+
+  // Finishes the read in flight which begins at begin_byte_index, with the
+  // bytes of the blob in its range.
+  void FinishRead(uint64_t begin_byte_index,
+                  optional<uint64_t> blob_size = kBlobSize) {
+    auto read = TakeRead(begin_byte_index);
+    auto part =
+        begin_byte_index < blob_.size()
+            ? blob_.substr(begin_byte_index,
+                           read.end_byte_index - begin_byte_index + 1)
+            : "";
+    read.callback(move(part), blob_size);
+  }
+
+  Read TakeRead(uint64_t begin_byte_index) {
+    for (auto it = reads_.begin(); it != reads_.end(); ++it) {
+      if (it->begin_byte_index == begin_byte_index) {
+        auto read = move(*it);
+        reads_.erase(it);
+        return read;
+      }
+    }
+    ADD_FAILURE() << "No read in flight at " << begin_byte_index;
+    return {};
+  }
+
+  vector<uint64_t> GetReadsInFlight() {
+    vector<uint64_t> begin_byte_indices;
+    for (const auto& read : reads_) {
+      begin_byte_indices.push_back(read.begin_byte_index);
+    }
+    return begin_byte_indices;
+  }
+
+  // The data of all the responses, checking that they are consecutive.
+  string GetStreamedData(uint64_t begin_byte_index = 0) {
+    string data;
+    for (const auto& response : responses_) {
+      EXPECT_EQ(response.blob_portion().metadata().bucket_name(), kBucketName);
+      EXPECT_EQ(response.blob_portion().metadata().blob_name(), kBlobName);
+      EXPECT_EQ(response.byte_range().begin_byte_index(),
+                begin_byte_index + data.size());
+      EXPECT_EQ(response.byte_range().end_byte_index(),
+                begin_byte_index + data.size() +
+                    response.blob_portion().data().size() - 1);
+      data += response.blob_portion().data();
+    }
+    return data;
+  }
+
+  string blob_ = kBlob;
+  ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+      context_;
+  vector<Read> reads_;
+  vector<GetBlobStreamResponse> responses_;
+  optional<ExecutionResult> result_;
+};
+
+TEST_F(ParallelRangeReaderTest, ReadsFirstPartAlone) {
+  Start(4, 3);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({0}));
+
+  FinishRead(0);
+  // Only 3 parts are read ahead of the first part not pushed yet.
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({4, 8, 12}));
+  EXPECT_EQ(GetStreamedData(), "abcd");
+}
+
+TEST_F(ParallelRangeReaderTest, ReadsOneByteAtATimeWithZeroPartSize) {
+  Start(0, 3);
+  ASSERT_EQ(reads_.size(), 1);
+  EXPECT_EQ(reads_[0].end_byte_index, 0);
+
+  FinishRead(0);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({1, 2, 3}));
+  EXPECT_EQ(GetStreamedData(), "a");
+}
+
+TEST_F(ParallelRangeReaderTest, PushesPartsInOrder) {
+  Start(4, 3);
+  FinishRead(0);
+
+  FinishRead(12);
+  FinishRead(8);
+  // Nothing can be pushed, or read, before the part at 4.
+  EXPECT_EQ(GetStreamedData(), "abcd");
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({4}));
+
+  FinishRead(4);
+  EXPECT_EQ(GetStreamedData(), "abcdefghijklmnop");
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({16, 20, 24}));
+
+  FinishRead(24);
+  FinishRead(20);
+  FinishRead(16);
+  EXPECT_EQ(GetStreamedData(), kBlob);
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+  EXPECT_TRUE(context_.IsMarkedDone());
+  EXPECT_TRUE(reads_.empty());
+}
+
+TEST_F(ParallelRangeReaderTest, SplitsPartsIntoResponses) {
+  context_.request->set_max_bytes_per_response(3);
+  Start(8, 4);
+  FinishRead(0);
+  FinishRead(16);
+  FinishRead(8);
+  FinishRead(24);
+
+  EXPECT_EQ(GetStreamedData(), kBlob);
+  ASSERT_EQ(responses_.size(), 10);
+  for (size_t i = 0; i < responses_.size(); i++) {
+    // Every part starts a new response.
+    auto expected_size = i % 3 == 2 || i == 9 ? 2 : 3;
+    EXPECT_EQ(responses_[i].blob_portion().data().size(), expected_size) << i;
+  }
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelRangeReaderTest, ReadsByteRange) {
+  context_.request->mutable_byte_range()->set_begin_byte_index(3);
+  context_.request->mutable_byte_range()->set_end_byte_index(12);
+  Start(4, 4);
+  ASSERT_EQ(reads_.size(), 1);
+  EXPECT_EQ(reads_[0].end_byte_index, 6);
+
+  FinishRead(3);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({7, 11}));
+  // The last part is cut at the end of the range.
+  EXPECT_EQ(reads_.back().end_byte_index, 12);
+  FinishRead(11);
+  FinishRead(7);
+
+  EXPECT_EQ(GetStreamedData(3), "defghijklm");
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelRangeReaderTest, ByteRangeBeyondEndOfBlob) {
+  context_.request->mutable_byte_range()->set_begin_byte_index(20);
+  context_.request->mutable_byte_range()->set_end_byte_index(100);
+  Start(4, 4);
+  FinishRead(20);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({24}));
+  FinishRead(24);
+
+  EXPECT_EQ(GetStreamedData(20), "uvwxyz");
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelRangeReaderTest, ReadsOneAtATimeWithoutBlobSize) {
+  Start(10, 4);
+  FinishRead(0, nullopt);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({10}));
+  FinishRead(10, nullopt);
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({20}));
+  // The short part is the last one.
+  FinishRead(20, nullopt);
+
+  EXPECT_EQ(GetStreamedData(), kBlob);
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+
+TEST_F(ParallelRangeReaderTest, FailsOnFailedPart) {
+  Start(4, 3);
+  FinishRead(0);
+  FinishRead(8);
+
+  auto failure =
+      FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+  TakeRead(4).callback(failure, nullopt);
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_, ResultIs(failure));
+  EXPECT_EQ(GetStreamedData(), "abcd");
+
+  // Reads which finish later are dropped.
+  FinishRead(12);
+  EXPECT_EQ(GetStreamedData(), "abcd");
+  EXPECT_TRUE(reads_.empty());
+}
+
+TEST_F(ParallelRangeReaderTest, StopsWhenCancelled) {
+  Start(4, 3);
+  FinishRead(0);
+  context_.TryCancel();
+  FinishRead(4);
+
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_THAT(*result_,
+              ResultIs(FailureExecutionResult(
+                  SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED)));
+  EXPECT_EQ(GetReadsInFlight(), vector<uint64_t>({8, 12}));
+  FinishRead(8);
+  FinishRead(12);
+  EXPECT_EQ(GetStreamedData(), "abcd");
+}
+
+TEST_F(ParallelRangeReaderTest, ReadsCalledBackOnTheCallingThread) {
+  make_shared<ParallelRangeReader>(
+      context_,
+      [this](uint64_t begin_byte_index, uint64_t end_byte_index,
+             ParallelRangeReader::PartCallback callback) {
+        callback(blob_.substr(begin_byte_index,
+                              end_byte_index - begin_byte_index + 1),
+                 blob_.size());
+      },
+      5, 2, make_shared<MockAsyncExecutor>())
+      ->Start();
+
+  EXPECT_EQ(GetStreamedData(), kBlob);
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_SUCCESS(*result_);
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+
+#include <aws/core/Aws.h>
+
+#include "blob_storage_e2e_benchmark.h"
+#include "core/interface/async_executor_interface.h"
+#include "cpio/client_providers/blob_storage_client_provider/test/aws/test_aws_blob_storage_client_provider.h"
+#include "cpio/client_providers/instance_client_provider/mock/mock_instance_client_provider.h"
+#include "public/cpio/test/blob_storage_client/test_aws_blob_storage_client_options.h"
+
+using Aws::InitAPI;
+using Aws::SDKOptions;
+using Aws::ShutdownAPI;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::cpio::TestAwsBlobStorageClientOptions;
+using google::scp::cpio::client_providers::TestAwsBlobStorageClientProvider;
+using google::scp::cpio::client_providers::mock::MockInstanceClientProvider;
+using google::scp::cpio::client_providers::test::GetEnvOrDefault;
+using google::scp::cpio::client_providers::test::RunBlobStorageE2eBenchmarks;
+using std::make_shared;
+using std::shared_ptr;
+
+// Runs against the S3 API at BLOB_BENCHMARK_S3_ENDPOINT, such as a local
+// MinIO, with the credentials in AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY.
+int main(int argc, char** argv) {
+  SDKOptions sdk_options;
+  InitAPI(sdk_options);
+  auto options = make_shared<TestAwsBlobStorageClientOptions>();
+  options->s3_endpoint_override =
+      GetEnvOrDefault("BLOB_BENCHMARK_S3_ENDPOINT", "http://127.0.0.1:9000");
+  auto exit_code = RunBlobStorageE2eBenchmarks(
+      argc, argv, "aws",
+      [&](const shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
+          const shared_ptr<AsyncExecutorInterface>& io_async_executor) {
+        return make_shared<TestAwsBlobStorageClientProvider>(
+            options, make_shared<MockInstanceClientProvider>(),
+            cpu_async_executor, io_async_executor);
+      },
+      GetEnvOrDefault("BLOB_BENCHMARK_BUCKET", "blob-storage-e2e-benchmark"));
+  ShutdownAPI(sdk_options);
+  return exit_code;
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "blob_storage_e2e_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+#include "core/async_executor/src/async_executor.h"
+#include "core/interface/async_context.h"
+#include "core/interface/errors.h"
+#include "core/interface/streaming_context.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::GetErrorMessage;
+using std::function;
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::promise;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace {
+constexpr char kDefaultCsvPath[] = "blob_storage_e2e_benchmark.csv";
+constexpr int64_t kBlobSizes[] = {1 << 10,   64 << 10,  1 << 20,
+                                  16 << 20,  256 << 20, 1 << 30};
+constexpr int64_t kConcurrencies[] = {1, 8, 32};
+// Blobs of all the operations in flight are held in memory at once, so larger
+// sizes are only run at lower concurrency.
+constexpr int64_t kMaxBytesInFlight = int64_t(4) << 30;
+// The size of each PutBlobStream request and GetBlobStream response.
+constexpr uint64_t kPortionSize = 4 << 20;
+constexpr size_t kCpuThreadCount = 8;
+constexpr size_t kIoThreadCount = 64;
+constexpr size_t kQueueCap = 100000;
+
+enum class Operation { kGetBlob, kGetBlobStream, kPutBlob, kPutBlobStream };
+
+const char* GetOperationName(Operation operation) {
+  switch (operation) {
+    case Operation::kGetBlob:
+      return "GetBlob";
+    case Operation::kGetBlobStream:
+      return "GetBlobStream";
+    case Operation::kPutBlob:
+      return "PutBlob";
+    case Operation::kPutBlobStream:
+      return "PutBlobStream";
+  }
+  return "";
+}
+
+string CreateBlobData(uint64_t size) {
+  string data(size, '\0');
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  return data;
+}
+
+// Gets the percentile of the sorted values.
+double GetPercentile(const vector<double>& sorted_values, double percentile) {
+  if (sorted_values.empty()) {
+    return 0;
+  }
+  auto index = static_cast<size_t>(percentile * (sorted_values.size() - 1));
+  return sorted_values[index];
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+namespace {
+/// Runs the operations of the benchmarks on blobs of one bucket.
+class BlobStorageE2eBenchmark {
+ public:
+  BlobStorageE2eBenchmark(
+      shared_ptr<BlobStorageClientProviderInterface> provider,
+      string bucket_name)
+      : provider_(std::move(provider)), bucket_name_(std::move(bucket_name)) {}
+
+  /// Runs the operation on the blob and calls done with its result. data is
+  /// what is put, and is ignored by reads.
+  void Run(Operation operation, const string& blob_name, const string& data,
+           function<void(ExecutionResult)> done) {
+    switch (operation) {
+      case Operation::kGetBlob:
+        return GetBlob(blob_name, std::move(done));
+      case Operation::kGetBlobStream:
+        return GetBlobStream(blob_name, std::move(done));
+      case Operation::kPutBlob:
+        return PutBlob(blob_name, data, std::move(done));
+      case Operation::kPutBlobStream:
+        return PutBlobStream(blob_name, data, std::move(done));
+    }
+  }
+
+  /**
+   * @brief Runs the operation on each of the blobs at once, and waits for all
+   * of them.
+   *
+   * @param latencies the seconds each operation took are appended to it.
+   * @return the first failure, if any.
+   */
+  ExecutionResult RunConcurrently(Operation operation,
+                                  const vector<string>& blob_names,
+                                  const string& data,
+                                  vector<double>& latencies) {
+    mutex result_mutex;
+    ExecutionResult result = SuccessExecutionResult();
+    size_t remaining = blob_names.size();
+    promise<void> all_done;
+    for (const auto& blob_name : blob_names) {
+      auto start_time = steady_clock::now();
+      Run(operation, blob_name, data,
+          [&, start_time](ExecutionResult operation_result) {
+            auto latency =
+                duration<double>(steady_clock::now() - start_time).count();
+            bool is_last = false;
+            {
+              lock_guard lock(result_mutex);
+              latencies.push_back(latency);
+              if (result.Successful() && !operation_result.Successful()) {
+                result = operation_result;
+              }
+              is_last = --remaining == 0;
+            }
+            if (is_last) {
+              all_done.set_value();
+            }
+          });
+    }
+    all_done.get_future().wait();
+    return result;
+  }
+
+ private:
+  void GetBlob(const string& blob_name, function<void(ExecutionResult)> done) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> context;
+    context.request = make_shared<GetBlobRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(bucket_name_);
+    context.request->mutable_blob_metadata()->set_blob_name(blob_name);
+    context.callback = [done = std::move(done)](auto& context) {
+      done(context.result);
+    };
+    provider_->GetBlob(context);
+  }
+
+  void GetBlobStream(const string& blob_name,
+                     function<void(ExecutionResult)> done) {
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+        context;
+    context.request = make_shared<GetBlobStreamRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(bucket_name_);
+    context.request->mutable_blob_metadata()->set_blob_name(blob_name);
+    context.request->set_max_bytes_per_response(kPortionSize);
+    context.process_callback = [done = std::move(done)](auto& context,
+                                                         bool is_finish) {
+      while (context.TryGetNextResponse() != nullptr) {}
+      if (is_finish) {
+        done(context.result);
+      }
+    };
+    provider_->GetBlobStream(context);
+  }
+
+  void PutBlob(const string& blob_name, const string& data,
+               function<void(ExecutionResult)> done) {
+    AsyncContext<PutBlobRequest, PutBlobResponse> context;
+    context.request = make_shared<PutBlobRequest>();
+    context.request->mutable_blob()->mutable_metadata()->set_bucket_name(
+        bucket_name_);
+    context.request->mutable_blob()->mutable_metadata()->set_blob_name(
+        blob_name);
+    context.request->mutable_blob()->set_data(data);
+    context.callback = [done = std::move(done)](auto& context) {
+      done(context.result);
+    };
+    provider_->PutBlob(context);
+  }
+
+  void PutBlobStream(const string& blob_name, const string& data,
+                     function<void(ExecutionResult)> done) {
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+        context;
+    auto make_request = [&](uint64_t offset) {
+      PutBlobStreamRequest request;
+      request.mutable_blob_portion()->mutable_metadata()->set_bucket_name(
+          bucket_name_);
+      request.mutable_blob_portion()->mutable_metadata()->set_blob_name(
+          blob_name);
+      request.mutable_blob_portion()->set_data(
+          data.substr(offset, kPortionSize));
+      return request;
+    };
+    context.request = make_shared<PutBlobStreamRequest>(make_request(0));
+    context.callback = [done = std::move(done)](auto& context) {
+      done(context.result);
+    };
+    for (uint64_t offset = kPortionSize; offset < data.size();
+         offset += kPortionSize) {
+      if (auto result = context.TryPushRequest(make_request(offset));
+          !result.Successful()) {
+        return done(result);
+      }
+    }
+    context.MarkDone();
+    provider_->PutBlobStream(context);
+  }
+
+  shared_ptr<BlobStorageClientProviderInterface> provider_;
+  const string bucket_name_;
+};
+
+void BM_BlobStorage(benchmark::State& state,
+                    BlobStorageE2eBenchmark* e2e_benchmark,
+                    Operation operation) {
+  const uint64_t blob_size = state.range(0);
+  const size_t concurrency = state.range(1);
+  auto data = CreateBlobData(blob_size);
+  vector<string> blob_names;
+  for (size_t i = 0; i < concurrency; ++i) {
+    blob_names.push_back(
+        absl::StrCat("blob_storage_e2e_benchmark/", blob_size, "/", i));
+  }
+
+  vector<double> latencies;
+  // The blobs are read back from puts before the timing starts.
+  if (operation == Operation::kGetBlob ||
+      operation == Operation::kGetBlobStream) {
+    if (auto result = e2e_benchmark->RunConcurrently(
+            Operation::kPutBlob, blob_names, data, latencies);
+        !result.Successful()) {
+      state.SkipWithError(
+          absl::StrCat("Putting the blobs to read failed: ",
+                       GetErrorMessage(result.status_code))
+              .c_str());
+      return;
+    }
+    latencies.clear();
+  }
+
+  for (auto _ : state) {
+    if (auto result = e2e_benchmark->RunConcurrently(operation, blob_names,
+                                                     data, latencies);
+        !result.Successful()) {
+      state.SkipWithError(absl::StrCat(GetOperationName(operation),
+                                       " failed: ",
+                                       GetErrorMessage(result.status_code))
+                              .c_str());
+      return;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  state.SetBytesProcessed(state.iterations() * concurrency * blob_size);
+  state.SetItemsProcessed(state.iterations() * concurrency);
+  state.counters["blob_size"] = blob_size;
+  state.counters["concurrency"] = concurrency;
+  state.counters["latency_p50_ms"] = GetPercentile(latencies, 0.5) * 1e3;
+  state.counters["latency_p99_ms"] = GetPercentile(latencies, 0.99) * 1e3;
+}
+}  // namespace
+
+int RunBlobStorageE2eBenchmarks(int argc, char** argv,
+                                const string& provider_name,
+                                const CreateProviderFunction& create_provider,
+                                const string& bucket_name) {
+  // The results go to a CSV file unless told otherwise.
+  vector<char*> args(argv, argv + argc);
+  string out_flag = absl::StrCat("--benchmark_out=", kDefaultCsvPath);
+  string out_format_flag = "--benchmark_out_format=csv";
+  if (std::none_of(args.begin(), args.end(), [](const char* arg) {
+        return std::strncmp(arg, "--benchmark_out=", 16) == 0;
+      })) {
+    args.push_back(out_flag.data());
+    args.push_back(out_format_flag.data());
+  }
+  int args_count = args.size();
+  benchmark::Initialize(&args_count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) {
+    return 1;
+  }
+
+  auto cpu_async_executor =
+      make_shared<AsyncExecutor>(kCpuThreadCount, kQueueCap);
+  auto io_async_executor =
+      make_shared<AsyncExecutor>(kIoThreadCount, kQueueCap);
+  if (!cpu_async_executor->Init().Successful() ||
+      !cpu_async_executor->Run().Successful() ||
+      !io_async_executor->Init().Successful() ||
+      !io_async_executor->Run().Successful()) {
+    std::cerr << "Failed to start the async executors." << std::endl;
+    return 1;
+  }
+  auto provider = create_provider(cpu_async_executor, io_async_executor);
+  if (auto result = provider->Init(); !result.Successful()) {
+    std::cerr << "Failed to init the provider: "
+              << GetErrorMessage(result.status_code) << std::endl;
+    return 1;
+  }
+  if (auto result = provider->Run(); !result.Successful()) {
+    std::cerr << "Failed to run the provider: "
+              << GetErrorMessage(result.status_code) << std::endl;
+    return 1;
+  }
+
+  BlobStorageE2eBenchmark e2e_benchmark(provider, bucket_name);
+  for (auto operation : {Operation::kGetBlob, Operation::kGetBlobStream,
+                         Operation::kPutBlob, Operation::kPutBlobStream}) {
+    auto* registered_benchmark = benchmark::RegisterBenchmark(
+        absl::StrCat(provider_name, "/", GetOperationName(operation)).c_str(),
+        BM_BlobStorage, &e2e_benchmark, operation);
+    registered_benchmark->ArgNames({"blob_size", "concurrency"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+    for (auto blob_size : kBlobSizes) {
+      for (auto concurrency : kConcurrencies) {
+        if (blob_size * concurrency <= kMaxBytesInFlight) {
+          registered_benchmark->Args({blob_size, concurrency});
+        }
+      }
+    }
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  provider->Stop();
+  io_async_executor->Stop();
+  cpu_async_executor->Stop();
+  return 0;
+}
+
+string GetEnvOrDefault(const char* name, const string& value) {
+  const char* env_value = std::getenv(name);
+  return env_value == nullptr ? value : env_value;
+}
+}  // namespace google::scp::cpio::client_providers::test
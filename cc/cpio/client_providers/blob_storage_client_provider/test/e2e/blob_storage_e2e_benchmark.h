@@ -0,0 +1,59 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "core/interface/async_executor_interface.h"
+#include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
+
+namespace google::scp::cpio::client_providers::test {
+/// Creates the provider to benchmark, on the given executors.
+using CreateProviderFunction =
+    std::function<std::shared_ptr<BlobStorageClientProviderInterface>(
+        const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
+        const std::shared_ptr<core::AsyncExecutorInterface>&
+            io_async_executor)>;
+
+/**
+ * @brief Benchmarks GetBlob, GetBlobStream, PutBlob and PutBlobStream of a
+ * provider, end to end against a storage service or a local stand-in of it,
+ * at blob sizes from 1KiB to 1GiB and several concurrency levels.
+ *
+ * The results are written as CSV to blob_storage_e2e_benchmark.csv, unless
+ * --benchmark_out is given. Each row is named by the provider and operation,
+ * and has the blob size, the concurrency, and the median and 99th percentile
+ * latency of the operations besides the Google Benchmark columns.
+ *
+ * @param argc the argc of main, which may hold Google Benchmark flags.
+ * @param argv the argv of main.
+ * @param provider_name the name of the provider in the results.
+ * @param create_provider creates the provider.
+ * @param bucket_name the bucket to put the blobs in, which must exist.
+ * @return int the exit code of the benchmark binary.
+ */
+int RunBlobStorageE2eBenchmarks(int argc, char** argv,
+                                const std::string& provider_name,
+                                const CreateProviderFunction& create_provider,
+                                const std::string& bucket_name);
+
+/// Gets the environment variable of the name, or the default value if it is
+/// not set.
+std::string GetEnvOrDefault(const char* name, const std::string& value);
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+
+#include "blob_storage_e2e_benchmark.h"
+#include "core/interface/async_executor_interface.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/gcp/gcp_blob_storage_client_provider.h"
+#include "cpio/client_providers/blob_storage_client_provider/test/gcp/test_gcp_blob_storage_client_provider.h"
+#include "cpio/client_providers/instance_client_provider/mock/mock_instance_client_provider.h"
+#include "public/cpio/test/blob_storage_client/test_gcp_blob_storage_client_options.h"
+
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::cpio::TestGcpBlobStorageClientOptions;
+using google::scp::cpio::client_providers::GcpBlobStorageClientProvider;
+using google::scp::cpio::client_providers::TestGcpCloudStorageFactory;
+using google::scp::cpio::client_providers::mock::MockInstanceClientProvider;
+using google::scp::cpio::client_providers::test::GetEnvOrDefault;
+using google::scp::cpio::client_providers::test::RunBlobStorageE2eBenchmarks;
+using std::make_shared;
+using std::shared_ptr;
+
+namespace {
+constexpr char kInstanceResourceName[] =
+    "//compute.googleapis.com/projects/123456789/zones/us-central1-c/"
+    "instances/987654321";
+}  // namespace
+
+// Runs against the GCS JSON API at BLOB_BENCHMARK_GCS_ENDPOINT, such as a
+// local fake-gcs-server, without credentials.
+int main(int argc, char** argv) {
+  auto options = make_shared<TestGcpBlobStorageClientOptions>();
+  options->gcs_endpoint_override =
+      GetEnvOrDefault("BLOB_BENCHMARK_GCS_ENDPOINT", "http://127.0.0.1:4443");
+  return RunBlobStorageE2eBenchmarks(
+      argc, argv, "gcp",
+      [&](const shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
+          const shared_ptr<AsyncExecutorInterface>& io_async_executor) {
+        auto instance_client = make_shared<MockInstanceClientProvider>();
+        instance_client->instance_resource_name = kInstanceResourceName;
+        return make_shared<GcpBlobStorageClientProvider>(
+            options, instance_client, cpu_async_executor, io_async_executor,
+            make_shared<TestGcpCloudStorageFactory>());
+      },
+      GetEnvOrDefault("BLOB_BENCHMARK_BUCKET", "blob-storage-e2e-benchmark"));
+}
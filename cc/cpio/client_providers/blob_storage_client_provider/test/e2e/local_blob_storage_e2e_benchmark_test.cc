@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "blob_storage_e2e_benchmark.h"
+#include "core/interface/async_executor_interface.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/local/local_blob_storage_client_provider.h"
+#include "public/cpio/interface/blob_storage_client/type_def.h"
+
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::cpio::BlobStorageClientOptions;
+using google::scp::cpio::client_providers::LocalBlobStorageClientProvider;
+using google::scp::cpio::client_providers::test::GetEnvOrDefault;
+using google::scp::cpio::client_providers::test::RunBlobStorageE2eBenchmarks;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+
+namespace {
+constexpr char kBucketName[] = "blob-storage-e2e-benchmark";
+}  // namespace
+
+// Runs against the local filesystem under BLOB_BENCHMARK_LOCAL_ROOT, as the
+// baseline of the other providers.
+int main(int argc, char** argv) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->local_root_directory = GetEnvOrDefault(
+      "BLOB_BENCHMARK_LOCAL_ROOT",
+      (std::filesystem::temp_directory_path() / "blob_storage_e2e_benchmark")
+          .string());
+  // Buckets are directories under the root.
+  std::error_code error;
+  std::filesystem::create_directories(
+      std::filesystem::path(options->local_root_directory) / kBucketName,
+      error);
+  return RunBlobStorageE2eBenchmarks(
+      argc, argv, "local",
+      [&](const shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
+          const shared_ptr<AsyncExecutorInterface>& io_async_executor) {
+        return make_shared<LocalBlobStorageClientProvider>(
+            options, cpu_async_executor, io_async_executor);
+      },
+      kBucketName);
+}
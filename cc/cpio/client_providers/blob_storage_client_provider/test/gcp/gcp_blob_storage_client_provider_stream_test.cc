@@ -541,6 +541,105 @@ TEST_F(GcpBlobStorageClientProviderStreamTest, GetBlobStreamByteRange) {
               Pointwise(GetBlobStreamResponseEquals(), expected_responses));
 }
 
+// Matches a ReadObjectRequest of the range [begin, end) which does not check
+// hashes.
+MATCHER_P4(RangedReadObjectRequestEqual, bucket_name, blob_name, begin, end,
+           "") {
+  if (!ExplainMatchResult(Eq(bucket_name), arg.bucket_name(),
+                          result_listener) ||
+      !ExplainMatchResult(Eq(blob_name), arg.object_name(), result_listener)) {
+    return false;
+  }
+  if (!arg.template HasOption<DisableMD5Hash>() ||
+      !arg.template GetOption<DisableMD5Hash>().value() ||
+      !arg.template HasOption<DisableCrc32cChecksum>() ||
+      !arg.template GetOption<DisableCrc32cChecksum>().value()) {
+    *result_listener << "Expected ReadObjectRequest to disable hashes.";
+    return false;
+  }
+  if (!arg.template HasOption<ReadRange>()) {
+    *result_listener << "Expected ReadObjectRequest to have a ReadRange.";
+    return false;
+  }
+  auto range = arg.template GetOption<ReadRange>().value();
+  return ExplainMatchResult(Eq(begin), range.begin, result_listener) &&
+         ExplainMatchResult(Eq(end), range.end, result_listener);
+}
+
+// Builds an ObjectReadSource of a range of an object of object_size bytes.
+StatusOr<unique_ptr<ObjectReadSource>> BuildRangedReadResponse(
+    const string& bytes_str, uint64_t object_size) {
+  InSequence seq;
+  auto mock_source = make_unique<MockObjectReadSource>();
+  EXPECT_CALL(*mock_source, IsOpen).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_source, Read)
+      .WillOnce([bytes_str, object_size](void* buf, std::size_t n) {
+        auto length = std::min(bytes_str.length(), n);
+        std::memcpy(buf, bytes_str.data(), length);
+        ReadSourceResult result{length, HttpResponse{200, {}, {}}};
+        result.size = object_size;
+        return result;
+      });
+  EXPECT_CALL(*mock_source, IsOpen).WillRepeatedly(Return(false));
+  return unique_ptr<ObjectReadSource>(move(mock_source));
+}
+
+TEST_F(GcpBlobStorageClientProviderStreamTest, GetBlobStreamInParallel) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->get_blob_stream_parallelism = 2;
+  options->get_blob_stream_part_size = 8;
+  GcpBlobStorageClientProvider parallel_client(
+      options, instance_client_, real_cpu_async_executor_,
+      real_io_async_executor_, storage_factory_);
+  EXPECT_SUCCESS(parallel_client.Init());
+  EXPECT_SUCCESS(parallel_client.Run());
+
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+
+  // 15 chars, read as [0, 8) and [8, 16).
+  string bytes_str = "response_string";
+  EXPECT_CALL(*mock_client_, ReadObject(RangedReadObjectRequestEqual(
+                                 kBucketName, kBlobName, 0, 8)))
+      .WillOnce(
+          Return(ByMove(BuildRangedReadResponse(bytes_str.substr(0, 8), 15))));
+  EXPECT_CALL(*mock_client_, ReadObject(RangedReadObjectRequestEqual(
+                                 kBucketName, kBlobName, 8, 16)))
+      .WillOnce(
+          Return(ByMove(BuildRangedReadResponse(bytes_str.substr(8), 15))));
+
+  vector<GetBlobStreamResponse> actual_responses;
+  get_blob_stream_context_.process_callback =
+      [this, &actual_responses](auto& context, bool is_finish) {
+        if (is_finish) {
+          EXPECT_SUCCESS(context.result);
+          finish_conditions_met_++;
+        }
+        auto resp = context.TryGetNextResponse();
+        if (resp != nullptr) {
+          actual_responses.push_back(move(*resp));
+        } else if (!context.IsMarkedDone()) {
+          ADD_FAILURE();
+        } else {
+          finish_conditions_met_++;
+        }
+      };
+
+  parallel_client.GetBlobStream(get_blob_stream_context_);
+
+  WaitUntil([this]() { return finish_conditions_met_.load() == 2; });
+  EXPECT_TRUE(get_blob_stream_context_.IsMarkedDone());
+  string actual_bytes;
+  for (const auto& response : actual_responses) {
+    EXPECT_EQ(response.byte_range().begin_byte_index(), actual_bytes.length());
+    actual_bytes += response.blob_portion().data();
+  }
+  EXPECT_EQ(actual_bytes, bytes_str);
+  EXPECT_SUCCESS(parallel_client.Stop());
+}
+
 TEST_F(GcpBlobStorageClientProviderStreamTest, GetBlobStreamFailsIfQueueDone) {
   get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
       kBucketName);
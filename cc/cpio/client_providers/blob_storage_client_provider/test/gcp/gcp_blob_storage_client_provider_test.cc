@@ -39,6 +39,7 @@ using google::cloud::Status;
 using google::cloud::StatusOr;
 using CloudStatusCode = google::cloud::StatusCode;
 using google::cloud::storage::Client;
+using google::cloud::storage::Crc32cChecksumValue;
 using google::cloud::storage::DisableCrc32cChecksum;
 using google::cloud::storage::DisableMD5Hash;
 using google::cloud::storage::MaxResults;
@@ -63,8 +64,11 @@ using ::google::cloud::storage::testing::canonical_errors::TransientError;
 using google::cmrt::sdk::blob_storage_service::v1::Blob;
 using google::cmrt::sdk::blob_storage_service::v1::BlobIdentity;
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
+using google::cmrt::sdk::blob_storage_service::v1::CHECKSUM_ALGORITHM_CRC32C;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
@@ -77,6 +81,7 @@ using google::scp::core::AsyncExecutor;
 using google::scp::core::AsyncExecutorInterface;
 using google::scp::core::AsyncOperation;
 using google::scp::core::BytesBuffer;
+using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
@@ -883,6 +888,25 @@ TEST_F(GcpBlobStorageClientProviderTest, ListBlobsPropagatesFailure) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpBlobStorageClientProviderTest, ListBlobsWithTooLargeMaxPageSize) {
+  list_blobs_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName1);
+  list_blobs_context_.request->set_max_page_size(1001);
+
+  EXPECT_CALL(*mock_gcs_client_, ListObjects).Times(0);
+
+  list_blobs_context_.callback = [this](auto& context) {
+    EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(
+                                    SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+
+    finish_called_ = true;
+  };
+
+  gcp_blob_storage_client_.ListBlobsMetadata(list_blobs_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 ///////////// PutBlob /////////////////////////////////////////////////////////
 
 MATCHER_P(InsertObjectRequestEquals, expected_request, "") {
@@ -943,6 +967,37 @@ TEST_P(GcpBlobStorageClientProviderWithAttestationTest, PutBlob) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpBlobStorageClientProviderTest, PutBlobWithCrc32c) {
+  put_blob_context_.request->mutable_blob()
+      ->mutable_metadata()
+      ->set_bucket_name(kBucketName1);
+  put_blob_context_.request->mutable_blob()->mutable_metadata()->set_blob_name(
+      kBlobName1);
+  string bytes_str = "put_string";
+  put_blob_context_.request->mutable_blob()->set_data(bytes_str);
+  put_blob_context_.request->set_checksum_algorithm(CHECKSUM_ALGORITHM_CRC32C);
+
+  EXPECT_CALL(*mock_gcs_client_, InsertObjectMedia)
+      .WillOnce([&bytes_str](const InsertObjectMediaRequest& request) {
+        // The CRC32C matches the one of the client library.
+        EXPECT_TRUE(request.HasOption<Crc32cChecksumValue>());
+        EXPECT_EQ(request.GetOption<Crc32cChecksumValue>().value(),
+                  google::cloud::storage::ComputeCrc32cChecksum(bytes_str));
+        EXPECT_FALSE(request.HasOption<MD5HashValue>());
+        return ObjectMetadata();
+      });
+
+  put_blob_context_.callback = [this](auto& context) {
+    EXPECT_SUCCESS(context.result);
+
+    finish_called_ = true;
+  };
+
+  gcp_blob_storage_client_.PutBlob(put_blob_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_P(GcpBlobStorageClientProviderWithAttestationTest, PutBlobStreamSync) {
   blob_identity_.mutable_blob_metadata()->set_bucket_name(kBucketName1);
   blob_identity_.mutable_blob_metadata()->set_blob_name(kBlobName1);
@@ -1031,6 +1086,40 @@ TEST_P(GcpBlobStorageClientProviderWithAttestationTest, DeleteBlob) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpBlobStorageClientProviderTest, DeleteBlobsReturnsResultOfEachBlob) {
+  AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> delete_blobs_context;
+  delete_blobs_context.request = make_shared<DeleteBlobsRequest>();
+  for (const auto* blob_name : {kBlobName1, kBlobName2}) {
+    auto* blob_metadata = delete_blobs_context.request->add_blob_metadatas();
+    blob_metadata->set_bucket_name(kBucketName1);
+    blob_metadata->set_blob_name(blob_name);
+  }
+
+  EXPECT_CALL(*mock_gcs_client_,
+              DeleteObject(DeleteObjectRequestEquals(kBucketName1, kBlobName1)))
+      .WillOnce(Return(EmptyResponse{}));
+  EXPECT_CALL(*mock_gcs_client_,
+              DeleteObject(DeleteObjectRequestEquals(kBucketName1, kBlobName2)))
+      .WillOnce(Return(Status(CloudStatusCode::kNotFound, "Blob not found")));
+
+  delete_blobs_context.callback = [this](auto& context) {
+    ASSERT_SUCCESS(context.result);
+    const auto& blob_results = context.response->blob_results();
+    ASSERT_EQ(blob_results.size(), 2);
+    EXPECT_EQ(blob_results[0].blob_metadata().blob_name(), kBlobName1);
+    EXPECT_SUCCESS(ExecutionResult(blob_results[0].result()));
+    EXPECT_EQ(blob_results[1].blob_metadata().blob_name(), kBlobName2);
+    EXPECT_THAT(ExecutionResult(blob_results[1].result()),
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    finish_called_ = true;
+  };
+
+  gcp_blob_storage_client_.DeleteBlobs(delete_blobs_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(GcpBlobStorageClientProviderTest,
        OperationsWithMissingAttestationsUseDefaultGCSClient) {
   get_blob_context_.request->mutable_blob_metadata()->set_bucket_name(
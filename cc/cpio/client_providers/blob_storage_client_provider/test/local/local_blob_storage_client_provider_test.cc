@@ -0,0 +1,592 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/blob_storage_client_provider/src/local/local_blob_storage_client_provider.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/test/utils/scp_test_base.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::blob_storage_service::v1::BlobIdentity;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataRequest;
+using google::cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
+using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncOperation;
+using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
+using google::scp::core::errors::
+    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::ScpTestBase;
+using std::function;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::filesystem::exists;
+using std::filesystem::remove_all;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace {
+constexpr char kBucketName[] = "bucket";
+constexpr char kBlobName[] = "dir/blob";
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class LocalBlobStorageClientProviderTest : public ScpTestBase {
+ protected:
+  LocalBlobStorageClientProviderTest()
+      : root_directory_(CreateRootDirectory()),
+        options_(make_shared<BlobStorageClientOptions>()),
+        io_async_executor_(make_shared<MockAsyncExecutor>()) {
+    options_->local_root_directory = root_directory_;
+    client_ = make_shared<LocalBlobStorageClientProvider>(
+        options_, make_shared<MockAsyncExecutor>(), io_async_executor_);
+    EXPECT_SUCCESS(client_->Init());
+    EXPECT_SUCCESS(client_->Run());
+  }
+
+  ~LocalBlobStorageClientProviderTest() {
+    EXPECT_SUCCESS(client_->Stop());
+    remove_all(root_directory_);
+  }
+
+  static string CreateRootDirectory() {
+    string root_directory = testing::TempDir() + "/local_blob_storage_XXXXXX";
+    EXPECT_NE(mkdtemp(root_directory.data()), nullptr);
+    return root_directory;
+  }
+
+  string ReadFile(const string& path) {
+    ifstream file(path, std::ios_base::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  }
+
+  ExecutionResult PutBlob(const string& blob_name, const string& data) {
+    AsyncContext<PutBlobRequest, PutBlobResponse> context;
+    context.request = make_shared<PutBlobRequest>();
+    context.request->mutable_blob()->mutable_metadata()->set_bucket_name(
+        kBucketName);
+    context.request->mutable_blob()->mutable_metadata()->set_blob_name(
+        blob_name);
+    context.request->mutable_blob()->set_data(data);
+    ExecutionResult result;
+    context.callback = [&result](auto& context) { result = context.result; };
+    client_->PutBlob(context);
+    return result;
+  }
+
+  AsyncContext<GetBlobRequest, GetBlobResponse> GetBlob(
+      const string& blob_name) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> context;
+    context.request = make_shared<GetBlobRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context.request->mutable_blob_metadata()->set_blob_name(blob_name);
+    return context;
+  }
+
+  AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse> ListBlobs(
+      const string& prefix) {
+    AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse> context;
+    context.request = make_shared<ListBlobsMetadataRequest>();
+    context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+    context.request->mutable_blob_metadata()->set_blob_name(prefix);
+    return context;
+  }
+
+  vector<string> BlobNames(const ListBlobsMetadataResponse& response) {
+    vector<string> blob_names;
+    for (const auto& blob_metadata : response.blob_metadatas()) {
+      EXPECT_EQ(blob_metadata.bucket_name(), kBucketName);
+      blob_names.push_back(blob_metadata.blob_name());
+    }
+    return blob_names;
+  }
+
+  PutBlobStreamRequest MakePutBlobStreamRequest(const string& data) {
+    PutBlobStreamRequest request;
+    request.mutable_blob_portion()->mutable_metadata()->set_bucket_name(
+        kBucketName);
+    request.mutable_blob_portion()->mutable_metadata()->set_blob_name(
+        kBlobName);
+    request.mutable_blob_portion()->set_data(data);
+    return request;
+  }
+
+  string root_directory_;
+  shared_ptr<BlobStorageClientOptions> options_;
+  shared_ptr<MockAsyncExecutor> io_async_executor_;
+  shared_ptr<LocalBlobStorageClientProvider> client_;
+};
+
+TEST_F(LocalBlobStorageClientProviderTest, InitFailsWithoutRootDirectory) {
+  LocalBlobStorageClientProvider client(
+      make_shared<BlobStorageClientOptions>(), make_shared<MockAsyncExecutor>(),
+      make_shared<MockAsyncExecutor>());
+  EXPECT_THAT(client.Init(), ResultIs(FailureExecutionResult(
+                                 SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, PutBlobThenGetBlob) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "some data"));
+  EXPECT_EQ(ReadFile(root_directory_ + "/bucket/dir/blob"), "some data");
+
+  auto context = GetBlob(kBlobName);
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_EQ(context.response->blob().metadata().bucket_name(), kBucketName);
+    EXPECT_EQ(context.response->blob().metadata().blob_name(), kBlobName);
+    EXPECT_EQ(context.response->blob().data(), "some data");
+    finished = true;
+  };
+  client_->GetBlob(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, PutBlobReplacesBlob) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "old data which is longer"));
+  EXPECT_SUCCESS(PutBlob(kBlobName, "new data"));
+
+  EXPECT_EQ(ReadFile(root_directory_ + "/bucket/dir/blob"), "new data");
+  // No temporary files are left behind.
+  EXPECT_TRUE(std::filesystem::is_empty(root_directory_ + "/.tmp"));
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobIfNoneMatchEtag) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "old data"));
+  string etag;
+  auto context = GetBlob(kBlobName);
+  context.callback = [&etag](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_FALSE(context.response->not_modified());
+    etag = context.response->etag();
+  };
+  client_->GetBlob(context);
+  EXPECT_FALSE(etag.empty());
+
+  context = GetBlob(kBlobName);
+  context.request->set_if_none_match_etag(etag);
+  bool finished = false;
+  context.callback = [&etag, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_TRUE(context.response->not_modified());
+    EXPECT_EQ(context.response->etag(), etag);
+    EXPECT_THAT(context.response->blob().data(), IsEmpty());
+    finished = true;
+  };
+  client_->GetBlob(context);
+  EXPECT_TRUE(finished);
+
+  // Replacing the blob changes its etag.
+  EXPECT_SUCCESS(PutBlob(kBlobName, "new data"));
+  finished = false;
+  context.callback = [&etag, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_FALSE(context.response->not_modified());
+    EXPECT_NE(context.response->etag(), etag);
+    EXPECT_EQ(context.response->blob().data(), "new data");
+    finished = true;
+  };
+  client_->GetBlob(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobRanges) {
+  // Cross a page boundary, so ranges start within a page.
+  string data(10000, 'a');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 26;
+  }
+  EXPECT_SUCCESS(PutBlob(kBlobName, data));
+
+  for (auto [begin, end] : vector<std::pair<uint64_t, uint64_t>>{
+           {0, 0}, {1, 5}, {4095, 4097}, {5000, 9999}, {9000, 20000}}) {
+    auto context = GetBlob(kBlobName);
+    context.request->mutable_byte_range()->set_begin_byte_index(begin);
+    context.request->mutable_byte_range()->set_end_byte_index(end);
+    bool finished = false;
+    context.callback = [&, begin = begin, end = end](auto& context) {
+      EXPECT_SUCCESS(context.result);
+      EXPECT_EQ(context.response->blob().data(),
+                data.substr(begin, end - begin + 1));
+      finished = true;
+    };
+    client_->GetBlob(context);
+    EXPECT_TRUE(finished);
+  }
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobRangePastEndFails) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "data"));
+
+  auto context = GetBlob(kBlobName);
+  context.request->mutable_byte_range()->set_begin_byte_index(4);
+  context.request->mutable_byte_range()->set_end_byte_index(10);
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(
+                                    SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+    finished = true;
+  };
+  client_->GetBlob(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobNotFound) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "data"));
+
+  // Neither a missing blob nor a directory of blobs is a blob.
+  for (const auto& blob_name : {"other", "dir", "dir/blob/other"}) {
+    auto context = GetBlob(blob_name);
+    bool finished = false;
+    context.callback = [&finished](auto& context) {
+      EXPECT_THAT(context.result,
+                  ResultIs(FailureExecutionResult(
+                      SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+      finished = true;
+    };
+    client_->GetBlob(context);
+    EXPECT_TRUE(finished);
+  }
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, InvalidNamesFail) {
+  for (const auto& [bucket_name, blob_name] :
+       vector<std::pair<string, string>>{{".tmp", "blob"},
+                                         {"a/b", "blob"},
+                                         {"..", "blob"},
+                                         {kBucketName, "../blob"},
+                                         {kBucketName, "dir/../../blob"},
+                                         {kBucketName, "./blob"},
+                                         {kBucketName, "/blob"},
+                                         {kBucketName, "dir//blob"},
+                                         {kBucketName, "dir/"}}) {
+    auto context = GetBlob(blob_name);
+    context.request->mutable_blob_metadata()->set_bucket_name(bucket_name);
+    bool finished = false;
+    context.callback = [&finished](auto& context) {
+      EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(
+                                      SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS)));
+      finished = true;
+    };
+    client_->GetBlob(context);
+    EXPECT_TRUE(finished) << bucket_name << " " << blob_name;
+  }
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobStream) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "0123456789"));
+
+  ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+      context;
+  context.request = make_shared<GetBlobStreamRequest>();
+  context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+  context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+  context.request->mutable_byte_range()->set_begin_byte_index(1);
+  context.request->mutable_byte_range()->set_end_byte_index(8);
+  context.request->set_max_bytes_per_response(3);
+  vector<string> portions;
+  vector<uint64_t> begin_byte_indexes;
+  bool finished = false;
+  context.process_callback = [&](auto& context, bool is_finish) {
+    if (is_finish) {
+      EXPECT_SUCCESS(context.result);
+      finished = true;
+      return;
+    }
+    auto response = context.TryGetNextResponse();
+    ASSERT_NE(response, nullptr);
+    portions.push_back(response->blob_portion().data());
+    begin_byte_indexes.push_back(response->byte_range().begin_byte_index());
+    EXPECT_EQ(response->byte_range().end_byte_index() -
+                  response->byte_range().begin_byte_index() + 1,
+              response->blob_portion().data().size());
+  };
+  client_->GetBlobStream(context);
+
+  EXPECT_TRUE(finished);
+  EXPECT_THAT(portions, ElementsAre("123", "456", "78"));
+  EXPECT_THAT(begin_byte_indexes, ElementsAre(1, 4, 7));
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, GetBlobStreamCancelled) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "0123456789"));
+
+  ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>
+      context;
+  context.request = make_shared<GetBlobStreamRequest>();
+  context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+  context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+  context.request->set_max_bytes_per_response(3);
+  bool finished = false;
+  context.process_callback = [&finished](auto& context, bool is_finish) {
+    if (is_finish) {
+      EXPECT_THAT(context.result,
+                  ResultIs(FailureExecutionResult(
+                      SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED)));
+      finished = true;
+      return;
+    }
+    context.TryCancel();
+  };
+  client_->GetBlobStream(context);
+
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, ListBlobsWithPrefixAndPages) {
+  for (const auto& blob_name : {"a/1", "a/2", "a/3", "ab", "b/1", "dir/a/1"}) {
+    EXPECT_SUCCESS(PutBlob(blob_name, "data"));
+  }
+
+  auto context = ListBlobs("a");
+  context.request->set_max_page_size(3);
+  bool finished = false;
+  context.callback = [this, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_THAT(BlobNames(*context.response), ElementsAre("a/1", "a/2", "a/3"));
+    EXPECT_EQ(context.response->next_page_token(), "a/3");
+    finished = true;
+  };
+  client_->ListBlobsMetadata(context);
+  EXPECT_TRUE(finished);
+
+  context = ListBlobs("a");
+  context.request->set_max_page_size(3);
+  context.request->set_page_token("a/3");
+  finished = false;
+  context.callback = [this, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_THAT(BlobNames(*context.response), ElementsAre("ab"));
+    EXPECT_FALSE(context.response->has_next_page_token());
+    finished = true;
+  };
+  client_->ListBlobsMetadata(context);
+  EXPECT_TRUE(finished);
+
+  context = ListBlobs("dir/");
+  finished = false;
+  context.callback = [this, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_THAT(BlobNames(*context.response), ElementsAre("dir/a/1"));
+    finished = true;
+  };
+  client_->ListBlobsMetadata(context);
+  EXPECT_TRUE(finished);
+
+  context = ListBlobs("c/");
+  finished = false;
+  context.callback = [this, &finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    EXPECT_THAT(BlobNames(*context.response), IsEmpty());
+    finished = true;
+  };
+  client_->ListBlobsMetadata(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, ListBlobsMissingBucket) {
+  auto context = ListBlobs("");
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    finished = true;
+  };
+  client_->ListBlobsMetadata(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, PutBlobStream) {
+  ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+      context;
+  context.request =
+      make_shared<PutBlobStreamRequest>(MakePutBlobStreamRequest("first "));
+  EXPECT_SUCCESS(context.TryPushRequest(MakePutBlobStreamRequest("second ")));
+  EXPECT_SUCCESS(context.TryPushRequest(MakePutBlobStreamRequest("third")));
+  context.MarkDone();
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finished = true;
+  };
+  client_->PutBlobStream(context);
+
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(ReadFile(root_directory_ + "/bucket/dir/blob"),
+            "first second third");
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, PutBlobStreamExpiresWithoutBlob) {
+  ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+      context;
+  context.request =
+      make_shared<PutBlobStreamRequest>(MakePutBlobStreamRequest("first"));
+  context.request->mutable_stream_keepalive_duration()->set_seconds(0);
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED)));
+    finished = true;
+  };
+  client_->PutBlobStream(context);
+
+  EXPECT_TRUE(finished);
+  EXPECT_FALSE(exists(root_directory_ + "/bucket/dir/blob"));
+  EXPECT_TRUE(std::filesystem::is_empty(root_directory_ + "/.tmp"));
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, PutBlobStreamPollsForRequests) {
+  ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>
+      context;
+  context.request =
+      make_shared<PutBlobStreamRequest>(MakePutBlobStreamRequest("first "));
+  AsyncOperation poll;
+  io_async_executor_->schedule_for_mock =
+      [&poll](const AsyncOperation& work, Timestamp, function<bool()>&) {
+        poll = work;
+        return SuccessExecutionResult();
+      };
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finished = true;
+  };
+  client_->PutBlobStream(context);
+  ASSERT_TRUE(poll);
+  EXPECT_FALSE(finished);
+
+  EXPECT_SUCCESS(context.TryPushRequest(MakePutBlobStreamRequest("second")));
+  context.MarkDone();
+  poll();
+
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(ReadFile(root_directory_ + "/bucket/dir/blob"), "first second");
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, DeleteBlob) {
+  EXPECT_SUCCESS(PutBlob(kBlobName, "data"));
+
+  AsyncContext<DeleteBlobRequest, DeleteBlobResponse> context;
+  context.request = make_shared<DeleteBlobRequest>();
+  context.request->mutable_blob_metadata()->set_bucket_name(kBucketName);
+  context.request->mutable_blob_metadata()->set_blob_name(kBlobName);
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    finished = true;
+  };
+  client_->DeleteBlob(context);
+  EXPECT_TRUE(finished);
+  EXPECT_FALSE(exists(root_directory_ + "/bucket/dir/blob"));
+
+  finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    finished = true;
+  };
+  client_->DeleteBlob(context);
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, DeleteBlobs) {
+  EXPECT_SUCCESS(PutBlob("dir/blob_1", "data"));
+  EXPECT_SUCCESS(PutBlob("dir/blob_3", "data"));
+
+  AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> context;
+  context.request = make_shared<DeleteBlobsRequest>();
+  for (const auto* blob_name : {"dir/blob_1", "dir/blob_2", "dir/blob_3"}) {
+    auto* blob_metadata = context.request->add_blob_metadatas();
+    blob_metadata->set_bucket_name(kBucketName);
+    blob_metadata->set_blob_name(blob_name);
+  }
+  bool finished = false;
+  context.callback = [&finished](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    ASSERT_EQ(context.response->blob_results_size(), 3);
+    EXPECT_SUCCESS(ExecutionResult(context.response->blob_results(0).result()));
+    EXPECT_THAT(ExecutionResult(context.response->blob_results(1).result()),
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+    EXPECT_SUCCESS(ExecutionResult(context.response->blob_results(2).result()));
+    finished = true;
+  };
+  client_->DeleteBlobs(context);
+  EXPECT_TRUE(finished);
+  EXPECT_FALSE(exists(root_directory_ + "/bucket/dir/blob_1"));
+  EXPECT_FALSE(exists(root_directory_ + "/bucket/dir/blob_3"));
+}
+
+TEST_F(LocalBlobStorageClientProviderTest, BlobStreamSync) {
+  BlobIdentity blob_identity;
+  blob_identity.mutable_blob_metadata()->set_bucket_name(kBucketName);
+  blob_identity.mutable_blob_metadata()->set_blob_name(kBlobName);
+  {
+    auto stream_or = client_->PutBlobStreamSync(blob_identity);
+    ASSERT_SUCCESS(stream_or);
+    **stream_or << "some data";
+    // The blob is only visible once the stream is closed.
+    EXPECT_FALSE(exists(root_directory_ + "/bucket/dir/blob"));
+  }
+
+  auto stream_or = client_->GetBlobStreamSync(blob_identity);
+  ASSERT_SUCCESS(stream_or);
+  EXPECT_EQ(string(istreambuf_iterator<char>(**stream_or),
+                   istreambuf_iterator<char>()),
+            "some data");
+}
+}  // namespace google::scp::cpio::client_providers::test
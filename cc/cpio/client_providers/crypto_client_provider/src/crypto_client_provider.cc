@@ -16,14 +16,20 @@
 
 #include "crypto_client_provider.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 
 #include <tink/aead.h>
@@ -52,6 +58,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
 #include "core/interface/service_interface.h"
 #include "core/utils/src/base64.h"
 #include "cpio/client_providers/interface/type_def.h"
@@ -93,6 +100,10 @@ using google::cmrt::sdk::crypto_service::v1::AeadDecryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacRequest;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacResponse;
 using google::cmrt::sdk::crypto_service::v1::HashType;
@@ -105,6 +116,7 @@ using google::cmrt::sdk::crypto_service::v1::HpkeKdf;
 using google::cmrt::sdk::crypto_service::v1::HpkeKem;
 using google::cmrt::sdk::crypto_service::v1::HpkeParams;
 using google::cmrt::sdk::crypto_service::v1::SecretLength;
+using google::cmrt::sdk::crypto_service::v1::StreamingAeadParams;
 using google::crypto::tink::AesCtrHmacStreamingKey;
 using google::crypto::tink::AesGcmHkdfStreamingKey;
 using google::crypto::tink::HpkePrivateKey;
@@ -112,6 +124,8 @@ using google::crypto::tink::HpkePublicKey;
 using google::crypto::tink::KeyData;
 using google::crypto::tink::Keyset;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncPriority;
 using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
@@ -155,19 +169,29 @@ using google::scp::core::errors::
 using google::scp::core::errors::
     SC_CRYPTO_CLIENT_PROVIDER_UNSUPPORTED_ENCRYPTION_ALGORITHM;
 using google::scp::core::utils::Base64Decode;
+using std::atomic;
 using std::bind;
+using std::condition_variable;
+using std::function;
 using std::istream;
 using std::isxdigit;
+using std::lock_guard;
 using std::make_shared;
 using std::make_unique;
 using std::map;
+using std::max;
+using std::min;
 using std::move;
+using std::mutex;
 using std::mt19937;
 using std::ostream;
 using std::random_device;
 using std::shared_ptr;
 using std::string;
+using std::string_view;
+using std::thread;
 using std::uniform_int_distribution;
+using std::unique_lock;
 using std::unique_ptr;
 using std::placeholders::_1;
 
@@ -175,6 +199,10 @@ namespace {
 /// Filename for logging errors
 constexpr char kCryptoClientProvider[] = "CryptoClientProvider";
 constexpr char kDefaultExporterContext[] = "aead key";
+/// Min number of batch items processed by one task.
+constexpr size_t kMinBatchChunkSize = 8;
+/// Number of chunks per hardware thread a batch is split into.
+constexpr size_t kChunksPerThread = 4;
 }  // namespace
 
 namespace google::scp::cpio::client_providers {
@@ -328,6 +356,72 @@ uint64_t GetRandomNumber(int size) {
   return distribution(random_generator) % size;
 }
 
+/// State shared by the tasks of one ParallelFor call.
+struct ParallelForState {
+  atomic<size_t> next_chunk{0};
+  mutex done_mutex;
+  condition_variable done_condition;
+  size_t done_chunks = 0;
+};
+
+/**
+ * @brief Runs work(i) for every i in [0, size), split into chunks which are
+ * claimed from a shared counter by the calling thread and by tasks scheduled
+ * on the executor. The calling thread takes part in the work and returns once
+ * every chunk is done, so a busy, failing or missing executor only means the
+ * calling thread does more of the work itself.
+ *
+ * @param executor the executor to schedule helper tasks on. Can be null.
+ * @param size the number of items.
+ * @param work the work for one item. Called concurrently for different items.
+ */
+void ParallelFor(const shared_ptr<AsyncExecutorInterface>& executor,
+                 size_t size, const function<void(size_t)>& work) {
+  if (size == 0) {
+    return;
+  }
+  size_t num_threads = max<size_t>(thread::hardware_concurrency(), 1);
+  // Smaller chunks than threads balance uneven items, while a minimum chunk
+  // size keeps the scheduling cost small next to cheap items.
+  size_t chunk_size = max(kMinBatchChunkSize,
+                          (size + kChunksPerThread * num_threads - 1) /
+                              (kChunksPerThread * num_threads));
+  size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+
+  auto state = make_shared<ParallelForState>();
+  // A helper task only calls work for the chunks it claims, and this function
+  // waits for all the claimed chunks, so work outlives every use of it even if
+  // the helper task itself runs late.
+  auto run_chunks = [state, &work, size, chunk_size, num_chunks]() {
+    size_t chunk;
+    while ((chunk = state->next_chunk.fetch_add(1)) < num_chunks) {
+      size_t end = min(size, (chunk + 1) * chunk_size);
+      for (size_t i = chunk * chunk_size; i < end; ++i) {
+        work(i);
+      }
+      lock_guard<mutex> lock(state->done_mutex);
+      if (++state->done_chunks == num_chunks) {
+        state->done_condition.notify_all();
+      }
+    }
+  };
+
+  if (executor) {
+    size_t num_helpers = min(num_chunks, num_threads) - 1;
+    for (size_t i = 0; i < num_helpers; ++i) {
+      if (!executor->Schedule(run_chunks, AsyncPriority::Normal).Successful()) {
+        break;
+      }
+    }
+  }
+  run_chunks();
+
+  unique_lock<mutex> lock(state->done_mutex);
+  state->done_condition.wait(lock, [&state, num_chunks]() {
+    return state->done_chunks == num_chunks;
+  });
+}
+
 ExecutionResultOr<unique_ptr<KeysetReader>> CreateBinaryKeysetReader(
     const string& key) {
   auto keyset_reader_or = BinaryKeysetReader::New(key);
@@ -433,22 +527,8 @@ ExecutionResult CryptoClientProvider::Stop() noexcept {
 ExecutionResultOr<HpkeEncryptResponse>
 CryptoClientProvider::HpkeEncryptUsingExternalInterface(
     const HpkeEncryptRequest& encrypt_request) noexcept {
-  auto keyset_handle_or = CreateKeysetHandle(encrypt_request.tink_key_binary());
-  if (!keyset_handle_or.Successful()) {
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, keyset_handle_or.result(),
-              "Creating KeysetHandle failed with error.");
-    return keyset_handle_or.result();
-  }
-
-  auto primitive_or = (*keyset_handle_or)->GetPrimitive<HybridEncrypt>();
-  if (!primitive_or.ok()) {
-    auto execution_result = FailureExecutionResult(
-        SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Creating Hpke Encrypt Primitive failed with error %s.",
-              primitive_or.status().ToString().c_str());
-    return execution_result;
-  }
+  auto primitive_or = GetHybridEncrypt(encrypt_request);
+  RETURN_IF_FAILURE(primitive_or.result());
 
   auto encrypt_result_or =
       (*primitive_or)
@@ -487,45 +567,12 @@ ExecutionResultOr<HpkeEncryptResponse> CryptoClientProvider::HpkeEncryptSync(
     return HpkeEncryptUsingExternalInterface(encrypt_request);
   }
 
-  string raw_key;
-  tink::HpkeParams hpke_params;
-  auto& encoded_key = encrypt_request.has_raw_key_with_params()
-                          ? encrypt_request.raw_key_with_params().raw_key()
-                          : encrypt_request.tink_key_binary();
-  auto decoded_key_or = Base64Decode(encoded_key);
-  if (!decoded_key_or.Successful()) {
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
-              "HPKE encryption failed.");
-    return decoded_key_or.result();
-  }
-  auto decoded_key = decoded_key_or.release();
-  if (encrypt_request.has_raw_key_with_params()) {
-    raw_key = decoded_key;
-    auto hpke_params_or = ToTinkHpkeParamsFromScp(
-        encrypt_request.raw_key_with_params().hpke_params());
-    RETURN_AND_LOG_IF_FAILURE(hpke_params_or.result(), kCryptoClientProvider,
-                              kZeroUuid, "Invalid HpkeParams");
-    hpke_params = std::move(*hpke_params_or);
-  } else {
-    auto keyset_or = CreateKeyset(decoded_key);
-    RETURN_IF_FAILURE(keyset_or.result());
-    HpkePublicKey public_key;
-    if (!public_key.ParseFromString(
-            keyset_or.value()->key(0).key_data().value())) {
-      auto execution_result = FailureExecutionResult(
-          SC_CRYPTO_CLIENT_PROVIDER_PARSE_HPKE_PUBLIC_KEY_FAILED);
-      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-                "Failed to construct HpkePublicKey.");
-      return execution_result;
-    }
-    raw_key = public_key.public_key();
-    auto hpke_params_or = ToTinkHpkeParamsFromTinkProto(public_key.params());
-    RETURN_AND_LOG_IF_FAILURE(hpke_params_or.result(), kCryptoClientProvider,
-                              kZeroUuid, "Invalid HpkeParams");
-    hpke_params = std::move(*hpke_params_or);
-  }
+  auto hpke_key_or = GetHpkePublicKey(encrypt_request);
+  RETURN_IF_FAILURE(hpke_key_or.result());
+  const HpkeKey& hpke_key = **hpke_key_or;
 
-  auto cipher = HpkeContext::SetupSender(hpke_params, raw_key,
+  auto cipher = HpkeContext::SetupSender(hpke_key.params,
+                                         SecretDataAsStringView(hpke_key.key),
                                          encrypt_request.shared_info());
   if (!cipher.ok()) {
     auto execution_result = FailureExecutionResult(
@@ -571,45 +618,8 @@ ExecutionResultOr<HpkeEncryptResponse> CryptoClientProvider::HpkeEncryptSync(
   return response;
 }
 
-ExecutionResultOr<HpkeDecryptResponse>
-CryptoClientProvider::HpkeDecryptUsingExternalInterface(
-    const HpkeDecryptRequest& decrypt_request) noexcept {
-  auto keyset_handle_or = CreateKeysetHandle(decrypt_request.tink_key_binary());
-  if (!keyset_handle_or.Successful()) {
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, keyset_handle_or.result(),
-              "Creating KeysetHandle failed with error.");
-    return keyset_handle_or.result();
-  }
-
-  auto primitive_or = (*keyset_handle_or)->GetPrimitive<HybridDecrypt>();
-  if (!primitive_or.ok()) {
-    auto execution_result = FailureExecutionResult(
-        SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Creating Hpke Decrypt Primitive failed with error %s.",
-              primitive_or.status().ToString().c_str());
-    return execution_result;
-  }
-
-  auto decrypt_result_or =
-      (*primitive_or)
-          ->Decrypt(decrypt_request.encrypted_data().ciphertext(),
-                    decrypt_request.shared_info());
-  if (!decrypt_result_or.ok()) {
-    auto execution_result =
-        FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_HPKE_DECRYPT_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Hpke decryption failed with error %s.",
-              decrypt_result_or.status().ToString().c_str());
-    return execution_result;
-  }
-
-  HpkeDecryptResponse response;
-  response.set_payload(std::move(*decrypt_result_or));
-  return response;
-}
-
-ExecutionResultOr<HpkeDecryptResponse> CryptoClientProvider::HpkeDecryptSync(
+ExecutionResultOr<CryptoClientProvider::HpkeDecryptKey>
+CryptoClientProvider::GetHpkeDecryptKey(
     const HpkeDecryptRequest& decrypt_request) noexcept {
   if (!decrypt_request.has_raw_key_with_params() &&
       !decrypt_request.has_tink_key_binary()) {
@@ -620,75 +630,69 @@ ExecutionResultOr<HpkeDecryptResponse> CryptoClientProvider::HpkeDecryptSync(
     return execution_result;
   }
 
+  HpkeDecryptKey key;
   // Use Tink's external interface for non bidirectional decryption when input
   // the tink_binary_key.
   if (!decrypt_request.is_bidirectional() &&
       decrypt_request.has_tink_key_binary()) {
-    return HpkeDecryptUsingExternalInterface(decrypt_request);
+    auto primitive_or = GetHybridDecrypt(decrypt_request);
+    RETURN_IF_FAILURE(primitive_or.result());
+    key.hybrid_decrypt = primitive_or.release();
+    return key;
   }
 
-  string raw_key;
-  tink::HpkeParams tink_hpke_params;
-  auto& encoded_key = decrypt_request.has_raw_key_with_params()
-                          ? decrypt_request.raw_key_with_params().raw_key()
-                          : decrypt_request.tink_key_binary();
+  auto hpke_key_or = GetHpkePrivateKey(decrypt_request);
+  RETURN_IF_FAILURE(hpke_key_or.result());
+  key.hpke_key = hpke_key_or.release();
+  return key;
+}
 
-  auto decoded_key_or = Base64Decode(encoded_key);
-  if (!decoded_key_or.Successful()) {
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
-              "HPKE decryption failed.");
-    return decoded_key_or.result();
-  }
-  if (decrypt_request.has_raw_key_with_params()) {
-    raw_key = decoded_key_or.release();
-    auto tink_hpke_params_or = ToTinkHpkeParamsFromScp(
-        decrypt_request.raw_key_with_params().hpke_params());
-    RETURN_AND_LOG_IF_FAILURE(tink_hpke_params_or.result(),
-                              kCryptoClientProvider, kZeroUuid,
-                              "Invalid HpkeParams");
-    tink_hpke_params = std::move(*tink_hpke_params_or);
-  } else {
-    auto key_set_or = CreateKeyset(decoded_key_or.release());
-    RETURN_IF_FAILURE(key_set_or.result());
-    HpkePrivateKey private_key;
-    if (!private_key.ParseFromString(
-            key_set_or.value()->key(0).key_data().value())) {
-      auto execution_result = FailureExecutionResult(
-          SC_CRYPTO_CLIENT_PROVIDER_PARSE_HPKE_PRIVATE_KEY_FAILED);
-      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-                "Hpke decryption failed with error.");
+ExecutionResult CryptoClientProvider::HpkeDecryptWithKey(
+    const HpkeDecryptKey& key, const HpkeDecryptRequest& decrypt_request,
+    const string& ciphertext, HpkeDecryptResponse& response,
+    bool log_failure) noexcept {
+  if (key.hybrid_decrypt) {
+    auto decrypt_result_or =
+        key.hybrid_decrypt->Decrypt(ciphertext, decrypt_request.shared_info());
+    if (!decrypt_result_or.ok()) {
+      auto execution_result =
+          FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_HPKE_DECRYPT_FAILED);
+      if (log_failure) {
+        SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                  "Hpke decryption failed with error %s.",
+                  decrypt_result_or.status().ToString().c_str());
+      }
       return execution_result;
     }
-    raw_key = private_key.private_key();
-    auto tink_hpke_params_or =
-        ToTinkHpkeParamsFromTinkProto(private_key.public_key().params());
-    RETURN_AND_LOG_IF_FAILURE(tink_hpke_params_or.result(),
-                              kCryptoClientProvider, kZeroUuid,
-                              "Invalid HpkeParams");
-    tink_hpke_params = std::move(*tink_hpke_params_or);
+    response.set_payload(std::move(*decrypt_result_or));
+    return SuccessExecutionResult();
   }
 
-  auto splitted_ciphertext = SplitPayload(
-      tink_hpke_params.kem, decrypt_request.encrypted_data().ciphertext());
+  const HpkeKey& hpke_key = *key.hpke_key;
+  auto splitted_ciphertext = SplitPayload(hpke_key.params.kem, ciphertext);
   if (!splitted_ciphertext.ok()) {
     auto execution_result = FailureExecutionResult(
         SC_CRYPTO_CLIENT_PROVIDER_SPLIT_CIPHERTEXT_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Hpke decryption failed with error %s.",
-              splitted_ciphertext.status().ToString().c_str());
+    if (log_failure) {
+      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                "Hpke decryption failed with error %s.",
+                splitted_ciphertext.status().ToString().c_str());
+    }
     return execution_result;
   }
 
   auto cipher = HpkeContext::SetupRecipient(
-      tink_hpke_params, SecretDataFromStringView(raw_key),
-      splitted_ciphertext->encapsulated_key, decrypt_request.shared_info());
+      hpke_key.params, hpke_key.key, splitted_ciphertext->encapsulated_key,
+      decrypt_request.shared_info());
 
   if (!cipher.ok()) {
     auto execution_result = FailureExecutionResult(
         SC_CRYPTO_CLIENT_PROVIDER_CREATE_HPKE_CONTEXT_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Hpke decryption failed with error %s.",
-              cipher.status().ToString().c_str());
+    if (log_failure) {
+      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                "Hpke decryption failed with error %s.",
+                cipher.status().ToString().c_str());
+    }
     return execution_result;
   }
 
@@ -697,13 +701,14 @@ ExecutionResultOr<HpkeDecryptResponse> CryptoClientProvider::HpkeDecryptSync(
   if (!payload.ok()) {
     auto execution_result =
         FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_HPKE_DECRYPT_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Hpke decryption failed with error %s.",
-              payload.status().ToString().c_str());
+    if (log_failure) {
+      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                "Hpke decryption failed with error %s.",
+                payload.status().ToString().c_str());
+    }
     return execution_result;
   }
 
-  HpkeDecryptResponse response;
   if (decrypt_request.is_bidirectional()) {
     auto secret =
         (*cipher)->Export(decrypt_request.exporter_context().empty()
@@ -713,31 +718,99 @@ ExecutionResultOr<HpkeDecryptResponse> CryptoClientProvider::HpkeDecryptSync(
     if (!secret.ok()) {
       auto execution_result = FailureExecutionResult(
           SC_CRYPTO_CLIENT_PROVIDER_SECRET_EXPORT_FAILED);
-      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-                "Hpke decryption failed with error %s.",
-                secret.status().ToString().c_str());
+      if (log_failure) {
+        SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                  "Hpke decryption failed with error %s.",
+                  secret.status().ToString().c_str());
+      }
       return execution_result;
     }
     response.set_secret(string(SecretDataAsStringView(*secret)));
   }
 
-  response.set_payload(*payload);
+  response.set_payload(std::move(*payload));
+  return SuccessExecutionResult();
+}
+
+ExecutionResultOr<HpkeDecryptResponse> CryptoClientProvider::HpkeDecryptSync(
+    const HpkeDecryptRequest& decrypt_request) noexcept {
+  auto key_or = GetHpkeDecryptKey(decrypt_request);
+  RETURN_IF_FAILURE(key_or.result());
 
+  HpkeDecryptResponse response;
+  RETURN_IF_FAILURE(HpkeDecryptWithKey(
+      *key_or, decrypt_request, decrypt_request.encrypted_data().ciphertext(),
+      response));
+  return response;
+}
+
+/**
+ * @brief Sets the result of a batch to the result of its first failed item, or
+ * to success if no item failed, and logs the failures of the batch once.
+ *
+ * @param operation the name of the batch operation, for the log.
+ * @param batch_response the batch response, with all its item responses set.
+ */
+template <typename BatchResponse>
+void SetBatchResult(const char* operation, BatchResponse& batch_response) {
+  size_t num_failures = 0;
+  for (const auto& item_response : batch_response.responses()) {
+    if (!ExecutionResult(item_response.result()).Successful() &&
+        num_failures++ == 0) {
+      *batch_response.mutable_result() = item_response.result();
+    }
+  }
+  if (num_failures == 0) {
+    *batch_response.mutable_result() = SuccessExecutionResult().ToProto();
+    return;
+  }
+  SCP_ERROR(kCryptoClientProvider, kZeroUuid,
+            ExecutionResult(batch_response.result()),
+            "%s failed for %zu of %d ciphertexts.", operation, num_failures,
+            batch_response.responses_size());
+}
+
+ExecutionResultOr<BatchHpkeDecryptResponse>
+CryptoClientProvider::BatchHpkeDecryptSync(
+    const BatchHpkeDecryptRequest& request) noexcept {
+  // Everything but the ciphertext is shared by the batch, so one request
+  // carries the key and options for all of them.
+  HpkeDecryptRequest options;
+  if (request.has_raw_key_with_params()) {
+    *options.mutable_raw_key_with_params() = request.raw_key_with_params();
+  } else if (request.has_tink_key_binary()) {
+    options.set_tink_key_binary(request.tink_key_binary());
+  }
+  options.mutable_encrypted_data()->set_key_id(request.key_id());
+  options.set_shared_info(request.shared_info());
+  options.set_is_bidirectional(request.is_bidirectional());
+  options.set_exporter_context(request.exporter_context());
+  options.set_secret_length(request.secret_length());
+
+  auto key_or = GetHpkeDecryptKey(options);
+  RETURN_IF_FAILURE(key_or.result());
+  const HpkeDecryptKey& key = *key_or;
+
+  BatchHpkeDecryptResponse response;
+  auto* responses = response.mutable_responses();
+  responses->Reserve(request.ciphertexts_size());
+  for (int i = 0; i < request.ciphertexts_size(); ++i) {
+    responses->Add();
+  }
+  ParallelFor(cpu_async_executor_, request.ciphertexts_size(), [&](size_t i) {
+    auto& item_response = *responses->Mutable(i);
+    auto result = HpkeDecryptWithKey(key, options, request.ciphertexts(i),
+                                     item_response, false /*log_failure*/);
+    *item_response.mutable_result() = result.ToProto();
+  });
+  SetBatchResult("Batch Hpke decryption", response);
   return response;
 }
 
 ExecutionResultOr<AeadEncryptResponse> CryptoClientProvider::AeadEncryptSync(
     const AeadEncryptRequest& request) noexcept {
-  SecretData key = SecretDataFromStringView(request.secret());
-  auto cipher = AesGcmBoringSsl::New(key);
-  if (!cipher.ok()) {
-    auto execution_result =
-        FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Aead encryption failed with error %s.",
-              cipher.status().ToString().c_str());
-    return execution_result;
-  }
+  auto cipher = GetAead(request.secret());
+  RETURN_IF_FAILURE(cipher.result());
   auto ciphertext =
       (*cipher)->Encrypt(request.payload(), request.shared_info());
   if (!ciphertext.ok()) {
@@ -753,38 +826,121 @@ ExecutionResultOr<AeadEncryptResponse> CryptoClientProvider::AeadEncryptSync(
   return response;
 }
 
-ExecutionResultOr<AeadDecryptResponse> CryptoClientProvider::AeadDecryptSync(
-    const AeadDecryptRequest& request) noexcept {
-  SecretData key = SecretDataFromStringView(request.secret());
-  auto cipher = AesGcmBoringSsl::New(key);
-  if (!cipher.ok()) {
-    auto execution_result =
-        FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Aead decryption failed with error %s.",
-              cipher.status().ToString().c_str());
-    return execution_result;
-  }
-  auto payload = (*cipher)->Decrypt(request.encrypted_data().ciphertext(),
-                                    request.shared_info());
+/**
+ * @brief Decrypts one ciphertext with the Aead primitive.
+ *
+ * @param cipher the Aead primitive.
+ * @param ciphertext the ciphertext to decrypt.
+ * @param shared_info the associated data.
+ * @param response the response to write the payload into.
+ * @param log_failure whether to log a failure.
+ * @return ExecutionResult the result of the decryption.
+ */
+ExecutionResult AeadDecryptWithPrimitive(const Aead& cipher,
+                                         const string& ciphertext,
+                                         const string& shared_info,
+                                         AeadDecryptResponse& response,
+                                         bool log_failure = true) {
+  auto payload = cipher.Decrypt(ciphertext, shared_info);
   if (!payload.ok()) {
     auto execution_result =
         FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_AEAD_DECRYPT_FAILED);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Aead decryption failed with error %s.",
-              payload.status().ToString().c_str());
+    if (log_failure) {
+      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                "Aead decryption failed with error %s.",
+                payload.status().ToString().c_str());
+    }
     return execution_result;
   }
+  response.set_payload(std::move(*payload));
+  return SuccessExecutionResult();
+}
+
+ExecutionResultOr<AeadDecryptResponse> CryptoClientProvider::AeadDecryptSync(
+    const AeadDecryptRequest& request) noexcept {
+  auto cipher = GetAead(request.secret());
+  RETURN_IF_FAILURE(cipher.result());
   AeadDecryptResponse response;
-  response.set_payload((*payload));
+  RETURN_IF_FAILURE(AeadDecryptWithPrimitive(
+      **cipher, request.encrypted_data().ciphertext(), request.shared_info(),
+      response));
+  return response;
+}
+
+ExecutionResultOr<BatchAeadDecryptResponse>
+CryptoClientProvider::BatchAeadDecryptSync(
+    const BatchAeadDecryptRequest& request) noexcept {
+  auto cipher_or = GetAead(request.secret());
+  RETURN_IF_FAILURE(cipher_or.result());
+  const Aead& cipher = **cipher_or;
+
+  BatchAeadDecryptResponse response;
+  auto* responses = response.mutable_responses();
+  responses->Reserve(request.ciphertexts_size());
+  for (int i = 0; i < request.ciphertexts_size(); ++i) {
+    responses->Add();
+  }
+  ParallelFor(cpu_async_executor_, request.ciphertexts_size(), [&](size_t i) {
+    auto& item_response = *responses->Mutable(i);
+    auto result = AeadDecryptWithPrimitive(cipher, request.ciphertexts(i),
+                                           request.shared_info(), item_response,
+                                           false /*log_failure*/);
+    *item_response.mutable_result() = result.ToProto();
+  });
+  SetBatchResult("Batch Aead decryption", response);
   return response;
 }
 
+/// Creates the Tink key from the key in the request.
+ExecutionResultOr<AesGcmHkdfStreamingKey> CreateAesGcmHkdfStreamingKey(
+    const google::cmrt::sdk::crypto_service::v1::AesGcmHkdfStreamingKey&
+        proto_key) {
+  AesGcmHkdfStreamingKey key;
+  auto decoded_key_or =
+      proto_key.has_tink_key_binary()
+          ? Base64Decode(proto_key.tink_key_binary())
+          : Base64Decode(proto_key.raw_key_with_params().key_value());
+  if (!decoded_key_or.Successful()) {
+    SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
+              "Decoding AesGcmHkdfStreamingKey key failed with error.");
+    return decoded_key_or.result();
+  }
+  auto decoded_key = decoded_key_or.release();
+  if (proto_key.has_raw_key_with_params()) {
+    const auto& raw_key = proto_key.raw_key_with_params();
+    key.set_version(raw_key.version());
+    key.set_key_value(decoded_key);
+    key.mutable_params()->set_ciphertext_segment_size(
+        raw_key.params().ciphertext_segment_size());
+    key.mutable_params()->set_derived_key_size(
+        raw_key.params().derived_key_size());
+    key.mutable_params()->set_hkdf_hash_type(
+        kHashTypeMap.at(raw_key.params().hkdf_hash_type()));
+  } else if (proto_key.has_tink_key_binary()) {
+    auto keyset_or = CreateKeyset(decoded_key);
+    RETURN_IF_FAILURE(keyset_or.result());
+    if (!key.ParseFromString(keyset_or.value()->key(0).key_data().value())) {
+      auto execution_result = FailureExecutionResult(
+          SC_CRYPTO_CLIENT_PROVIDER_PARSE_STREAMING_AEAD_KEY_FAILED);
+      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                "Failed to construct AesGcmHkdfStreamingKey.");
+      return execution_result;
+    }
+  } else {
+    auto execution_result =
+        FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
+    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+              "No config found for AesGcmHkdfStreamingKey.");
+    return execution_result;
+  }
+  return key;
+}
+
 ExecutionResultOr<unique_ptr<StreamingAead>> CreateSaead(
-    cmrt::sdk::crypto_service::v1::StreamingAeadParams saead_params) {
+    const StreamingAeadParams& saead_params) {
   if (saead_params.has_aes_ctr_hmac_key()) {
     AesCtrHmacStreamingKey key;
-    auto proto_key = saead_params.aes_ctr_hmac_key();
+    const auto& proto_key = saead_params.aes_ctr_hmac_key();
     auto decoded_key_or =
         proto_key.has_tink_key_binary()
             ? Base64Decode(proto_key.tink_key_binary())
@@ -797,7 +953,7 @@ ExecutionResultOr<unique_ptr<StreamingAead>> CreateSaead(
     }
     auto decoded_key = decoded_key_or.release();
     if (proto_key.has_raw_key_with_params()) {
-      auto raw_key = proto_key.raw_key_with_params();
+      const auto& raw_key = proto_key.raw_key_with_params();
       key.set_version(raw_key.version());
       key.set_key_value(decoded_key);
       key.mutable_params()->set_ciphertext_segment_size(
@@ -840,45 +996,10 @@ ExecutionResultOr<unique_ptr<StreamingAead>> CreateSaead(
     }
     return move(streaming_result.value());
   } else if (saead_params.has_aes_gcm_hkdf_key()) {
-    AesGcmHkdfStreamingKey key;
-    auto proto_key = saead_params.aes_gcm_hkdf_key();
-    auto decoded_key_or =
-        proto_key.has_tink_key_binary()
-            ? Base64Decode(proto_key.tink_key_binary())
-            : Base64Decode(proto_key.raw_key_with_params().key_value());
-    if (!decoded_key_or.Successful()) {
-      SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
-                "Decoding AesGcmHkdfStreamingKey key failed with error.");
-      return decoded_key_or.result();
-    }
-    auto decoded_key = decoded_key_or.release();
-    if (proto_key.has_raw_key_with_params()) {
-      auto raw_key = proto_key.raw_key_with_params();
-      key.set_version(raw_key.version());
-      key.set_key_value(decoded_key);
-      key.mutable_params()->set_ciphertext_segment_size(
-          raw_key.params().ciphertext_segment_size());
-      key.mutable_params()->set_derived_key_size(
-          raw_key.params().derived_key_size());
-      key.mutable_params()->set_hkdf_hash_type(
-          kHashTypeMap.at(raw_key.params().hkdf_hash_type()));
-    } else if (proto_key.has_tink_key_binary()) {
-      auto keyset_or = CreateKeyset(decoded_key);
-      RETURN_IF_FAILURE(keyset_or.result());
-      if (!key.ParseFromString(keyset_or.value()->key(0).key_data().value())) {
-        auto execution_result = FailureExecutionResult(
-            SC_CRYPTO_CLIENT_PROVIDER_PARSE_STREAMING_AEAD_KEY_FAILED);
-        SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-                  "Failed to construct AesGcmHkdfStreamingKey.");
-        return execution_result;
-      }
-    } else {
-      auto execution_result =
-          FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
-      SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-                "No config found for AesGcmHkdfStreamingKey.");
-      return execution_result;
-    }
+    auto key_or =
+        CreateAesGcmHkdfStreamingKey(saead_params.aes_gcm_hkdf_key());
+    RETURN_IF_FAILURE(key_or.result());
+    const auto& key = *key_or;
 
     auto streaming_result =
         AesGcmHkdfStreamingKeyManager().GetPrimitive<StreamingAead>(key);
@@ -900,12 +1021,309 @@ ExecutionResultOr<unique_ptr<StreamingAead>> CreateSaead(
   }
 }
 
+/**
+ * @brief Gets the bytes identifying the key of an HPKE request, to be used as
+ * the cache key.
+ *
+ * @param request the HPKE request.
+ * @param buffer storage for the serialized raw key, if used.
+ * @return string_view the bytes. Valid as long as request and buffer.
+ */
+template <typename Request>
+string_view GetHpkeKeyBytes(const Request& request, string& buffer) {
+  if (request.has_raw_key_with_params()) {
+    buffer = request.raw_key_with_params().SerializeAsString();
+    return buffer;
+  }
+  return request.tink_key_binary();
+}
+
+CryptoClientProvider::KeyCacheStats
+CryptoClientProvider::GetKeyCacheStats() noexcept {
+  KeyCacheStats stats;
+  stats.hits = hpke_public_key_cache_.Hits() +
+               hpke_private_key_cache_.Hits() + hybrid_encrypt_cache_.Hits() +
+               hybrid_decrypt_cache_.Hits() + aead_cache_.Hits() +
+               streaming_aead_cache_.Hits() +
+               parallel_streaming_aead_cache_.Hits() + mac_cache_.Hits();
+  stats.misses = hpke_public_key_cache_.Misses() +
+                 hpke_private_key_cache_.Misses() +
+                 hybrid_encrypt_cache_.Misses() +
+                 hybrid_decrypt_cache_.Misses() + aead_cache_.Misses() +
+                 streaming_aead_cache_.Misses() +
+                 parallel_streaming_aead_cache_.Misses() + mac_cache_.Misses();
+  return stats;
+}
+
+ExecutionResultOr<shared_ptr<const CryptoClientProvider::HpkeKey>>
+CryptoClientProvider::GetHpkePublicKey(
+    const HpkeEncryptRequest& encrypt_request) noexcept {
+  string buffer;
+  auto key_bytes = GetHpkeKeyBytes(encrypt_request, buffer);
+  return hpke_public_key_cache_.GetOrCreate(
+      encrypt_request.key_id(), key_bytes,
+      [&encrypt_request]() -> ExecutionResultOr<shared_ptr<const HpkeKey>> {
+        auto& encoded_key =
+            encrypt_request.has_raw_key_with_params()
+                ? encrypt_request.raw_key_with_params().raw_key()
+                : encrypt_request.tink_key_binary();
+        auto decoded_key_or = Base64Decode(encoded_key);
+        if (!decoded_key_or.Successful()) {
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
+                    "HPKE encryption failed.");
+          return decoded_key_or.result();
+        }
+        auto decoded_key = decoded_key_or.release();
+        auto hpke_key = make_shared<HpkeKey>();
+        if (encrypt_request.has_raw_key_with_params()) {
+          hpke_key->key = SecretDataFromStringView(decoded_key);
+          auto hpke_params_or = ToTinkHpkeParamsFromScp(
+              encrypt_request.raw_key_with_params().hpke_params());
+          RETURN_AND_LOG_IF_FAILURE(hpke_params_or.result(),
+                                    kCryptoClientProvider, kZeroUuid,
+                                    "Invalid HpkeParams");
+          hpke_key->params = std::move(*hpke_params_or);
+        } else {
+          auto keyset_or = CreateKeyset(decoded_key);
+          RETURN_IF_FAILURE(keyset_or.result());
+          HpkePublicKey public_key;
+          if (!public_key.ParseFromString(
+                  keyset_or.value()->key(0).key_data().value())) {
+            auto execution_result = FailureExecutionResult(
+                SC_CRYPTO_CLIENT_PROVIDER_PARSE_HPKE_PUBLIC_KEY_FAILED);
+            SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                      "Failed to construct HpkePublicKey.");
+            return execution_result;
+          }
+          hpke_key->key = SecretDataFromStringView(public_key.public_key());
+          auto hpke_params_or =
+              ToTinkHpkeParamsFromTinkProto(public_key.params());
+          RETURN_AND_LOG_IF_FAILURE(hpke_params_or.result(),
+                                    kCryptoClientProvider, kZeroUuid,
+                                    "Invalid HpkeParams");
+          hpke_key->params = std::move(*hpke_params_or);
+        }
+        return shared_ptr<const HpkeKey>(move(hpke_key));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const CryptoClientProvider::HpkeKey>>
+CryptoClientProvider::GetHpkePrivateKey(
+    const HpkeDecryptRequest& decrypt_request) noexcept {
+  string buffer;
+  auto key_bytes = GetHpkeKeyBytes(decrypt_request, buffer);
+  return hpke_private_key_cache_.GetOrCreate(
+      decrypt_request.encrypted_data().key_id(), key_bytes,
+      [&decrypt_request]() -> ExecutionResultOr<shared_ptr<const HpkeKey>> {
+        auto& encoded_key =
+            decrypt_request.has_raw_key_with_params()
+                ? decrypt_request.raw_key_with_params().raw_key()
+                : decrypt_request.tink_key_binary();
+        auto decoded_key_or = Base64Decode(encoded_key);
+        if (!decoded_key_or.Successful()) {
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, decoded_key_or.result(),
+                    "HPKE decryption failed.");
+          return decoded_key_or.result();
+        }
+        auto hpke_key = make_shared<HpkeKey>();
+        if (decrypt_request.has_raw_key_with_params()) {
+          hpke_key->key = SecretDataFromStringView(decoded_key_or.release());
+          auto tink_hpke_params_or = ToTinkHpkeParamsFromScp(
+              decrypt_request.raw_key_with_params().hpke_params());
+          RETURN_AND_LOG_IF_FAILURE(tink_hpke_params_or.result(),
+                                    kCryptoClientProvider, kZeroUuid,
+                                    "Invalid HpkeParams");
+          hpke_key->params = std::move(*tink_hpke_params_or);
+        } else {
+          auto key_set_or = CreateKeyset(decoded_key_or.release());
+          RETURN_IF_FAILURE(key_set_or.result());
+          HpkePrivateKey private_key;
+          if (!private_key.ParseFromString(
+                  key_set_or.value()->key(0).key_data().value())) {
+            auto execution_result = FailureExecutionResult(
+                SC_CRYPTO_CLIENT_PROVIDER_PARSE_HPKE_PRIVATE_KEY_FAILED);
+            SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                      "Hpke decryption failed with error.");
+            return execution_result;
+          }
+          hpke_key->key = SecretDataFromStringView(private_key.private_key());
+          auto tink_hpke_params_or =
+              ToTinkHpkeParamsFromTinkProto(private_key.public_key().params());
+          RETURN_AND_LOG_IF_FAILURE(tink_hpke_params_or.result(),
+                                    kCryptoClientProvider, kZeroUuid,
+                                    "Invalid HpkeParams");
+          hpke_key->params = std::move(*tink_hpke_params_or);
+        }
+        return shared_ptr<const HpkeKey>(move(hpke_key));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const HybridEncrypt>>
+CryptoClientProvider::GetHybridEncrypt(
+    const HpkeEncryptRequest& encrypt_request) noexcept {
+  return hybrid_encrypt_cache_.GetOrCreate(
+      encrypt_request.key_id(), encrypt_request.tink_key_binary(),
+      [&encrypt_request]()
+          -> ExecutionResultOr<shared_ptr<const HybridEncrypt>> {
+        auto keyset_handle_or =
+            CreateKeysetHandle(encrypt_request.tink_key_binary());
+        if (!keyset_handle_or.Successful()) {
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid,
+                    keyset_handle_or.result(),
+                    "Creating KeysetHandle failed with error.");
+          return keyset_handle_or.result();
+        }
+
+        auto primitive_or = (*keyset_handle_or)->GetPrimitive<HybridEncrypt>();
+        if (!primitive_or.ok()) {
+          auto execution_result = FailureExecutionResult(
+              SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                    "Creating Hpke Encrypt Primitive failed with error %s.",
+                    primitive_or.status().ToString().c_str());
+          return execution_result;
+        }
+        return shared_ptr<const HybridEncrypt>(move(*primitive_or));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const HybridDecrypt>>
+CryptoClientProvider::GetHybridDecrypt(
+    const HpkeDecryptRequest& decrypt_request) noexcept {
+  return hybrid_decrypt_cache_.GetOrCreate(
+      decrypt_request.encrypted_data().key_id(),
+      decrypt_request.tink_key_binary(),
+      [&decrypt_request]()
+          -> ExecutionResultOr<shared_ptr<const HybridDecrypt>> {
+        auto keyset_handle_or =
+            CreateKeysetHandle(decrypt_request.tink_key_binary());
+        if (!keyset_handle_or.Successful()) {
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid,
+                    keyset_handle_or.result(),
+                    "Creating KeysetHandle failed with error.");
+          return keyset_handle_or.result();
+        }
+
+        auto primitive_or = (*keyset_handle_or)->GetPrimitive<HybridDecrypt>();
+        if (!primitive_or.ok()) {
+          auto execution_result = FailureExecutionResult(
+              SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                    "Creating Hpke Decrypt Primitive failed with error %s.",
+                    primitive_or.status().ToString().c_str());
+          return execution_result;
+        }
+        return shared_ptr<const HybridDecrypt>(move(*primitive_or));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const Aead>> CryptoClientProvider::GetAead(
+    const string& secret) noexcept {
+  return aead_cache_.GetOrCreate(
+      "" /*The secret has no id*/, secret,
+      [&secret]() -> ExecutionResultOr<shared_ptr<const Aead>> {
+        auto cipher = AesGcmBoringSsl::New(SecretDataFromStringView(secret));
+        if (!cipher.ok()) {
+          auto execution_result = FailureExecutionResult(
+              SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                    "Aead creation failed with error %s.",
+                    cipher.status().ToString().c_str());
+          return execution_result;
+        }
+        return shared_ptr<const Aead>(move(*cipher));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const StreamingAead>>
+CryptoClientProvider::GetStreamingAead(
+    const StreamingAeadParams& saead_params) noexcept {
+  // The two key types are told apart by the id, as their serialized forms
+  // could in theory be the same.
+  string key_bytes;
+  string key_type;
+  if (saead_params.has_aes_ctr_hmac_key()) {
+    key_type = "aes_ctr_hmac";
+    key_bytes = saead_params.aes_ctr_hmac_key().SerializeAsString();
+  } else if (saead_params.has_aes_gcm_hkdf_key()) {
+    key_type = "aes_gcm_hkdf";
+    key_bytes = saead_params.aes_gcm_hkdf_key().SerializeAsString();
+  } else {
+    // Nothing to cache. Let CreateSaead report the error.
+    auto saead_or = CreateSaead(saead_params);
+    RETURN_IF_FAILURE(saead_or.result());
+    return shared_ptr<const StreamingAead>(move(*saead_or));
+  }
+  return streaming_aead_cache_.GetOrCreate(
+      key_type, key_bytes,
+      [&saead_params]() -> ExecutionResultOr<shared_ptr<const StreamingAead>> {
+        auto saead_or = CreateSaead(saead_params);
+        RETURN_IF_FAILURE(saead_or.result());
+        return shared_ptr<const StreamingAead>(move(*saead_or));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const ParallelStreamingAead>>
+CryptoClientProvider::GetParallelStreamingAead(
+    const StreamingAeadParams& saead_params) noexcept {
+  return parallel_streaming_aead_cache_.GetOrCreate(
+      "aes_gcm_hkdf", saead_params.aes_gcm_hkdf_key().SerializeAsString(),
+      [&saead_params]()
+          -> ExecutionResultOr<shared_ptr<const ParallelStreamingAead>> {
+        auto key_or =
+            CreateAesGcmHkdfStreamingKey(saead_params.aes_gcm_hkdf_key());
+        RETURN_IF_FAILURE(key_or.result());
+        auto saead_or = ParallelStreamingAead::Create(*key_or);
+        RETURN_IF_FAILURE(saead_or.result());
+        return shared_ptr<const ParallelStreamingAead>(move(*saead_or));
+      });
+}
+
+ExecutionResultOr<shared_ptr<const Mac>> CryptoClientProvider::GetMac(
+    const string& key) noexcept {
+  return mac_cache_.GetOrCreate(
+      "" /*The key has no id*/, key,
+      [&key]() -> ExecutionResultOr<shared_ptr<const Mac>> {
+        auto keyset_handle_or = CreateKeysetHandle(key);
+        if (!keyset_handle_or.Successful()) {
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid,
+                    keyset_handle_or.result(),
+                    "Creating KeysetHandle failed with error.");
+          return keyset_handle_or.result();
+        }
+
+        auto mac_primitive_or = (*keyset_handle_or)->GetPrimitive<Mac>();
+        if (!mac_primitive_or.ok()) {
+          auto execution_result = FailureExecutionResult(
+              SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
+          SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
+                    "Creating mac failed with error %s.",
+                    mac_primitive_or.status().ToString().c_str());
+          return execution_result;
+        }
+        return shared_ptr<const Mac>(move(*mac_primitive_or));
+      });
+}
+
 ExecutionResultOr<unique_ptr<OutputStream>>
 CryptoClientProvider::AeadEncryptStreamSync(
     const google::scp::cpio::AeadEncryptStreamRequest& request) noexcept {
-  auto result = CreateSaead(request.saead_params);
-  RETURN_IF_FAILURE(result.result());
-  unique_ptr<StreamingAead> saead = move(result.value());
+  // Tink has no parallel streams, so AesGcmHkdf streams with a window are
+  // encrypted in the same segment format by ParallelStreamingAead.
+  if (request.parallel_window_size_in_bytes > 0 &&
+      request.saead_params.has_aes_gcm_hkdf_key()) {
+    auto parallel_saead_or = GetParallelStreamingAead(request.saead_params);
+    RETURN_IF_FAILURE(parallel_saead_or.result());
+    return (*parallel_saead_or)
+        ->NewEncryptingStream(
+            make_unique<ostream>(move(request.ciphertext_stream->rdbuf())),
+            request.saead_params.shared_info(), cpu_async_executor_,
+            request.parallel_window_size_in_bytes);
+  }
+
+  auto saead_or = GetStreamingAead(request.saead_params);
+  RETURN_IF_FAILURE(saead_or.result());
+  const auto& saead = *saead_or;
 
   std::unique_ptr<OutputStream> ct_destination(
       absl::make_unique<OstreamOutputStream>(
@@ -928,9 +1346,20 @@ CryptoClientProvider::AeadEncryptStreamSync(
 ExecutionResultOr<unique_ptr<InputStream>>
 CryptoClientProvider::AeadDecryptStreamSync(
     const google::scp::cpio::AeadDecryptStreamRequest& request) noexcept {
-  auto result = CreateSaead(request.saead_params);
-  RETURN_IF_FAILURE(result.result());
-  unique_ptr<StreamingAead> saead = move(result.value());
+  if (request.parallel_window_size_in_bytes > 0 &&
+      request.saead_params.has_aes_gcm_hkdf_key()) {
+    auto parallel_saead_or = GetParallelStreamingAead(request.saead_params);
+    RETURN_IF_FAILURE(parallel_saead_or.result());
+    return (*parallel_saead_or)
+        ->NewDecryptingStream(
+            make_unique<istream>(move(request.ciphertext_stream->rdbuf())),
+            request.saead_params.shared_info(), cpu_async_executor_,
+            request.parallel_window_size_in_bytes);
+  }
+
+  auto saead_or = GetStreamingAead(request.saead_params);
+  RETURN_IF_FAILURE(saead_or.result());
+  const auto& saead = *saead_or;
 
   // Prepare ciphertext source stream.
   unique_ptr<InputStream> ct_source(make_unique<IstreamInputStream>(
@@ -968,22 +1397,8 @@ ExecutionResultOr<ComputeMacResponse> CryptoClientProvider::ComputeMacSync(
     return execution_result;
   }
 
-  auto keyset_handle_or = CreateKeysetHandle(request.key());
-  if (!keyset_handle_or.Successful()) {
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, keyset_handle_or.result(),
-              "Creating KeysetHandle failed with error.");
-    return keyset_handle_or.result();
-  }
-
-  auto mac_primitive_or = (*keyset_handle_or)->GetPrimitive<Mac>();
-  if (!mac_primitive_or.ok()) {
-    auto execution_result = FailureExecutionResult(
-        SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_TINK_PRIMITIVE);
-    SCP_ERROR(kCryptoClientProvider, kZeroUuid, execution_result,
-              "Creating mac failed with error %s.",
-              mac_primitive_or.status().ToString().c_str());
-    return execution_result;
-  }
+  auto mac_primitive_or = GetMac(request.key());
+  RETURN_IF_FAILURE(mac_primitive_or.result());
 
   auto compute_result_or = (*mac_primitive_or)->ComputeMac(request.data());
   if (!compute_result_or.ok()) {
@@ -16,12 +16,21 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
+#include <tink/aead.h>
 #include <tink/hybrid/internal/hpke_context.h>
+#include <tink/hybrid_decrypt.h>
+#include <tink/hybrid_encrypt.h>
 #include <tink/input_stream.h>
+#include <tink/mac.h>
+#include <tink/streaming_aead.h>
+#include <tink/util/secret_data.h>
 
 #include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
 #include "core/interface/service_interface.h"
 #include "google/protobuf/any.pb.h"
 #include "public/core/interface/execution_result.h"
@@ -29,7 +38,9 @@
 #include "public/cpio/interface/crypto_client/type_def.h"
 #include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
 
+#include "crypto_key_cache.h"
 #include "error_codes.h"
+#include "parallel_streaming_aead.h"
 
 namespace google::scp::cpio::client_providers {
 /**
@@ -37,9 +48,27 @@ namespace google::scp::cpio::client_providers {
  */
 class CryptoClientProvider : public CryptoClientInterface {
  public:
+  /**
+   * @brief Construct a new Crypto Client Provider.
+   *
+   * @param options the configurations.
+   * @param cpu_async_executor optional executor to run batch operations in
+   * parallel on. Without it, batches are processed on the calling thread.
+   */
   explicit CryptoClientProvider(
-      const std::shared_ptr<CryptoClientOptions>& options)
-      : options_(options) {}
+      const std::shared_ptr<CryptoClientOptions>& options,
+      const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor =
+          nullptr)
+      : options_(options),
+        cpu_async_executor_(cpu_async_executor),
+        hpke_public_key_cache_(KeyCacheSize(options)),
+        hpke_private_key_cache_(KeyCacheSize(options)),
+        hybrid_encrypt_cache_(KeyCacheSize(options)),
+        hybrid_decrypt_cache_(KeyCacheSize(options)),
+        aead_cache_(KeyCacheSize(options)),
+        streaming_aead_cache_(KeyCacheSize(options)),
+        parallel_streaming_aead_cache_(KeyCacheSize(options)),
+        mac_cache_(KeyCacheSize(options)) {}
 
   core::ExecutionResult Init() noexcept override;
 
@@ -62,6 +91,18 @@ class CryptoClientProvider : public CryptoClientInterface {
   AeadDecryptSync(const cmrt::sdk::crypto_service::v1::AeadDecryptRequest&
                       request) noexcept override;
 
+  core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse>
+  BatchHpkeDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest&
+          request) noexcept override;
+
+  core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse>
+  BatchAeadDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest&
+          request) noexcept override;
+
   core::ExecutionResultOr<std::unique_ptr<::crypto::tink::InputStream>>
   AeadDecryptStreamSync(const google::scp::cpio::AeadDecryptStreamRequest&
                             request) noexcept override;
@@ -74,18 +115,120 @@ class CryptoClientProvider : public CryptoClientInterface {
   ComputeMacSync(const cmrt::sdk::crypto_service::v1::ComputeMacRequest&
                      request) noexcept override;
 
+  /// Hit and miss counts summed over all the key caches.
+  struct KeyCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  /**
+   * @brief Gets the hit and miss counts of the key caches.
+   *
+   * @return KeyCacheStats the counts since construction.
+   */
+  KeyCacheStats GetKeyCacheStats() noexcept;
+
  private:
+  /// A decoded HPKE key together with its params.
+  struct HpkeKey {
+    ::crypto::tink::internal::HpkeParams params;
+    ::crypto::tink::util::SecretData key;
+  };
+
+  /// A private key set up for HPKE decryption. Tink keys used for one
+  /// direction decryption go through the HybridDecrypt primitive, and all the
+  /// other keys through HpkeContext.
+  struct HpkeDecryptKey {
+    std::shared_ptr<const ::crypto::tink::HybridDecrypt> hybrid_decrypt;
+    std::shared_ptr<const HpkeKey> hpke_key;
+  };
+
+  static size_t KeyCacheSize(
+      const std::shared_ptr<CryptoClientOptions>& options) {
+    return options == nullptr ? 0 : options->key_cache_size;
+  }
+
+  /// Gets the decoded public key of the request, from the cache if possible.
+  core::ExecutionResultOr<std::shared_ptr<const HpkeKey>> GetHpkePublicKey(
+      const cmrt::sdk::crypto_service::v1::HpkeEncryptRequest&) noexcept;
+
+  /// Gets the decoded private key of the request, from the cache if possible.
+  core::ExecutionResultOr<std::shared_ptr<const HpkeKey>> GetHpkePrivateKey(
+      const cmrt::sdk::crypto_service::v1::HpkeDecryptRequest&) noexcept;
+
+  /// Gets the HybridEncrypt primitive of the Tink key in the request.
+  core::ExecutionResultOr<std::shared_ptr<const ::crypto::tink::HybridEncrypt>>
+  GetHybridEncrypt(
+      const cmrt::sdk::crypto_service::v1::HpkeEncryptRequest&) noexcept;
+
+  /// Gets the HybridDecrypt primitive of the Tink key in the request.
+  core::ExecutionResultOr<std::shared_ptr<const ::crypto::tink::HybridDecrypt>>
+  GetHybridDecrypt(
+      const cmrt::sdk::crypto_service::v1::HpkeDecryptRequest&) noexcept;
+
+  /// Gets the AES-GCM primitive of the secret.
+  core::ExecutionResultOr<std::shared_ptr<const ::crypto::tink::Aead>> GetAead(
+      const std::string& secret) noexcept;
+
+  /// Gets the StreamingAead primitive of the key in the params.
+  core::ExecutionResultOr<std::shared_ptr<const ::crypto::tink::StreamingAead>>
+  GetStreamingAead(
+      const cmrt::sdk::crypto_service::v1::StreamingAeadParams&) noexcept;
+
+  /// Gets the ParallelStreamingAead of the AesGcmHkdfStreamingKey in the
+  /// params.
+  core::ExecutionResultOr<std::shared_ptr<const ParallelStreamingAead>>
+  GetParallelStreamingAead(
+      const cmrt::sdk::crypto_service::v1::StreamingAeadParams&) noexcept;
+
+  /// Gets the Mac primitive of the encoded Tink key.
+  core::ExecutionResultOr<std::shared_ptr<const ::crypto::tink::Mac>> GetMac(
+      const std::string& key) noexcept;
+
   core::ExecutionResultOr<cmrt::sdk::crypto_service::v1::HpkeEncryptResponse>
   HpkeEncryptUsingExternalInterface(
       const cmrt::sdk::crypto_service::v1::HpkeEncryptRequest&) noexcept;
 
-  core::ExecutionResultOr<cmrt::sdk::crypto_service::v1::HpkeDecryptResponse>
-  HpkeDecryptUsingExternalInterface(
+  /// Sets up the private key of the request for decryption.
+  core::ExecutionResultOr<HpkeDecryptKey> GetHpkeDecryptKey(
       const cmrt::sdk::crypto_service::v1::HpkeDecryptRequest&) noexcept;
 
+  /**
+   * @brief Decrypts one ciphertext with a key that is already set up.
+   *
+   * @param key the key from GetHpkeDecryptKey.
+   * @param request the decryption options. Its key and ciphertext are not
+   * used.
+   * @param ciphertext the ciphertext to decrypt.
+   * @param response the response to write the payload and secret into.
+   * @param log_failure whether to log a failure. Batches log their failures
+   * at once instead.
+   * @return core::ExecutionResult the result of the decryption.
+   */
+  static core::ExecutionResult HpkeDecryptWithKey(
+      const HpkeDecryptKey& key,
+      const cmrt::sdk::crypto_service::v1::HpkeDecryptRequest& request,
+      const std::string& ciphertext,
+      cmrt::sdk::crypto_service::v1::HpkeDecryptResponse& response,
+      bool log_failure = true) noexcept;
+
  protected:
   /// HpkeParams passed in from configuration which will override the default
   /// params.
   std::shared_ptr<CryptoClientOptions> options_;
+
+  /// Executor to run batch operations and parallel streams on. Can be null.
+  std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+
+  /// Caches of the decoded keys and Tink primitives. Each cache is bounded by
+  /// CryptoClientOptions::key_cache_size.
+  CryptoKeyCache<HpkeKey> hpke_public_key_cache_;
+  CryptoKeyCache<HpkeKey> hpke_private_key_cache_;
+  CryptoKeyCache<::crypto::tink::HybridEncrypt> hybrid_encrypt_cache_;
+  CryptoKeyCache<::crypto::tink::HybridDecrypt> hybrid_decrypt_cache_;
+  CryptoKeyCache<::crypto::tink::Aead> aead_cache_;
+  CryptoKeyCache<::crypto::tink::StreamingAead> streaming_aead_cache_;
+  CryptoKeyCache<ParallelStreamingAead> parallel_streaming_aead_cache_;
+  CryptoKeyCache<::crypto::tink::Mac> mac_cache_;
 };
 }  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/sha.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "core/common/lru_cache/src/lru_cache.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Bounded, thread-safe cache of decoded keys and ready-to-use Tink
+ * primitives. Entries are keyed by the key id plus a SHA-256 digest of the
+ * encoded key, so a rotated key reusing an id never hits a stale entry, and
+ * the cache never holds the encoded key itself. Least recently used entries
+ * are evicted once the capacity is reached.
+ *
+ * @tparam T the cached type. Cached values are shared by concurrent callers,
+ * so T must be safe to use from multiple threads through a const pointer,
+ * which holds for Tink primitives.
+ */
+template <typename T>
+class CryptoKeyCache {
+ public:
+  /**
+   * @brief Construct a new cache.
+   *
+   * @param capacity the max number of entries. 0 disables caching.
+   */
+  explicit CryptoKeyCache(size_t capacity)
+      : cache_(capacity), enabled_(capacity > 0) {}
+
+  /**
+   * @brief Gets the cached value for the key, or creates it with factory and
+   * caches it. Failures are not cached.
+   *
+   * @param key_id the id of the key. Can be empty.
+   * @param key the encoded key, or any bytes that uniquely identify it.
+   * @param factory callable returning
+   * core::ExecutionResultOr<std::shared_ptr<const T>>.
+   * @return core::ExecutionResultOr<std::shared_ptr<const T>> the value.
+   */
+  template <typename Factory>
+  core::ExecutionResultOr<std::shared_ptr<const T>> GetOrCreate(
+      std::string_view key_id, std::string_view key, Factory&& factory) {
+    if (!enabled_) {
+      return factory();
+    }
+    auto cache_key = MakeCacheKey(key_id, key);
+    std::shared_ptr<const T> value;
+    if (cache_.TryGet(cache_key, value)) {
+      hits_.fetch_add(1);
+      return value;
+    }
+    misses_.fetch_add(1);
+    core::ExecutionResultOr<std::shared_ptr<const T>> value_or = factory();
+    if (value_or.Successful()) {
+      cache_.Set(cache_key, *value_or);
+    }
+    return value_or;
+  }
+
+  /// The number of lookups served from the cache.
+  uint64_t Hits() const { return hits_.load(); }
+
+  /// The number of lookups that had to create the value.
+  uint64_t Misses() const { return misses_.load(); }
+
+  /// The number of cached entries.
+  size_t Size() { return enabled_ ? cache_.Size() : 0; }
+
+  void Clear() { cache_.Clear(); }
+
+ private:
+  static std::string MakeCacheKey(std::string_view key_id,
+                                  std::string_view key) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const uint8_t*>(key.data()), key.size(), digest);
+    // The digest has a fixed length, so appending it after the key id cannot
+    // make two different pairs collide.
+    std::string cache_key;
+    cache_key.reserve(key_id.size() + sizeof(digest));
+    cache_key.append(key_id);
+    cache_key.append(reinterpret_cast<const char*>(digest), sizeof(digest));
+    return cache_key;
+  }
+
+  core::common::LruCache<std::string, std::shared_ptr<const T>> cache_;
+  const bool enabled_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+}  // namespace google::scp::cpio::client_providers
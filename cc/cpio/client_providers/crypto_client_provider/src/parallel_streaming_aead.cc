@@ -0,0 +1,742 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_streaming_aead.h"
+
+#include <openssl/aead.h>
+#include <openssl/digest.h>
+#include <openssl/hkdf.h>
+#include <openssl/mem.h>
+#include <openssl/rand.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "error_codes.h"
+
+using crypto::tink::InputStream;
+using crypto::tink::OutputStream;
+using crypto::tink::util::Status;
+using crypto::tink::util::StatusOr;
+using google::crypto::tink::AesGcmHkdfStreamingKey;
+using google::crypto::tink::HashType;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncPriority;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED;
+using google::scp::core::errors::
+    SC_CRYPTO_CLIENT_PROVIDER_SAEAD_CREATE_ENCRYPT_STREAM_FAILED;
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::function;
+using std::istream;
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::max;
+using std::min;
+using std::move;
+using std::mutex;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace {
+/// Filename for logging errors
+constexpr char kParallelStreamingAead[] = "ParallelStreamingAead";
+/// Size of the random prefix of the segment nonces, stored in the header.
+constexpr size_t kNoncePrefixSize = 7;
+/// A segment nonce is the nonce prefix, the big-endian 32-bit segment number
+/// and a byte which is 1 for the last segment.
+constexpr size_t kNonceSize = kNoncePrefixSize + 4 + 1;
+constexpr size_t kTagSize = 16;
+/// Chunks hold about this much ciphertext, so that scheduling a chunk costs
+/// little next to encrypting it.
+constexpr size_t kTargetChunkSize = 1 << 20;
+/// Smaller windows are split into at least this many chunks, so that they
+/// still have chunks to process in parallel.
+constexpr size_t kMinChunksPerWindow = 8;
+
+/// Seals and opens the segments of one stream. Safe to use from multiple
+/// threads, as the AEAD context is only read.
+class SegmentCipher {
+ public:
+  SegmentCipher(EVP_AEAD_CTX* ctx, string nonce_prefix,
+                size_t ciphertext_segment_size, size_t header_size)
+      : ctx_(ctx, &EVP_AEAD_CTX_free),
+        nonce_prefix_(move(nonce_prefix)),
+        ciphertext_segment_size_(ciphertext_segment_size),
+        header_size_(header_size) {}
+
+  /// The ciphertext size of a full segment. The first segment shares its
+  /// space with the header.
+  size_t CiphertextSegmentSize(size_t segment_number) const {
+    return ciphertext_segment_size_ - (segment_number == 0 ? header_size_ : 0);
+  }
+
+  size_t PlaintextSegmentSize(size_t segment_number) const {
+    return CiphertextSegmentSize(segment_number) - kTagSize;
+  }
+
+  /**
+   * @brief Encrypts the plaintext of consecutive segments.
+   *
+   * @param first_segment the number of the first segment.
+   * @param last whether the chunk ends the stream. Only the last chunk can
+   * end with a partial or empty segment.
+   * @param plaintext the plaintext of the segments.
+   * @param[out] ciphertext the ciphertext of the segments.
+   */
+  Status EncryptSegments(size_t first_segment, bool last,
+                         string_view plaintext, string& ciphertext) const {
+    ciphertext.resize(plaintext.size() +
+                      (plaintext.size() / PlaintextSegmentSize(0) + 2) *
+                          kTagSize);
+    size_t in_offset = 0;
+    size_t out_offset = 0;
+    for (size_t segment = first_segment;; ++segment) {
+      size_t remaining = plaintext.size() - in_offset;
+      bool last_segment = last && remaining <= PlaintextSegmentSize(segment);
+      size_t size = min(remaining, PlaintextSegmentSize(segment));
+      if (segment > UINT32_MAX) {
+        return Status(absl::StatusCode::kInvalidArgument,
+                      "Too many segments in the stream.");
+      }
+      uint8_t nonce[kNonceSize];
+      MakeNonce(segment, last_segment, nonce);
+      size_t out_size = 0;
+      if (EVP_AEAD_CTX_seal(
+              ctx_.get(),
+              reinterpret_cast<uint8_t*>(ciphertext.data()) + out_offset,
+              &out_size, ciphertext.size() - out_offset, nonce, kNonceSize,
+              reinterpret_cast<const uint8_t*>(plaintext.data()) + in_offset,
+              size, nullptr, 0) != 1) {
+        return Status(absl::StatusCode::kInternal,
+                      "Encrypting the segment failed.");
+      }
+      in_offset += size;
+      out_offset += out_size;
+      if (last_segment || (!last && in_offset == plaintext.size())) {
+        break;
+      }
+    }
+    ciphertext.resize(out_offset);
+    return Status();
+  }
+
+  /**
+   * @brief Decrypts the ciphertext of consecutive segments.
+   *
+   * @param first_segment the number of the first segment.
+   * @param last whether the chunk ends the stream.
+   * @param ciphertext the ciphertext of the segments.
+   * @param[out] plaintext the plaintext of the segments.
+   */
+  Status DecryptSegments(size_t first_segment, bool last,
+                         string_view ciphertext, string& plaintext) const {
+    plaintext.resize(ciphertext.size());
+    size_t in_offset = 0;
+    size_t out_offset = 0;
+    for (size_t segment = first_segment;; ++segment) {
+      size_t remaining = ciphertext.size() - in_offset;
+      bool last_segment = last && remaining <= CiphertextSegmentSize(segment);
+      size_t size = min(remaining, CiphertextSegmentSize(segment));
+      if (size < kTagSize) {
+        return Status(absl::StatusCode::kInvalidArgument,
+                      "Ciphertext segment is too short.");
+      }
+      if (segment > UINT32_MAX) {
+        return Status(absl::StatusCode::kInvalidArgument,
+                      "Too many segments in the stream.");
+      }
+      uint8_t nonce[kNonceSize];
+      MakeNonce(segment, last_segment, nonce);
+      size_t out_size = 0;
+      if (EVP_AEAD_CTX_open(
+              ctx_.get(),
+              reinterpret_cast<uint8_t*>(plaintext.data()) + out_offset,
+              &out_size, plaintext.size() - out_offset, nonce, kNonceSize,
+              reinterpret_cast<const uint8_t*>(ciphertext.data()) + in_offset,
+              size, nullptr, 0) != 1) {
+        return Status(absl::StatusCode::kInvalidArgument,
+                      "Decrypting the segment failed.");
+      }
+      in_offset += size;
+      out_offset += out_size;
+      if (last_segment || (!last && in_offset == ciphertext.size())) {
+        break;
+      }
+    }
+    plaintext.resize(out_offset);
+    return Status();
+  }
+
+ private:
+  void MakeNonce(size_t segment, bool last_segment, uint8_t* nonce) const {
+    std::copy(nonce_prefix_.begin(), nonce_prefix_.end(), nonce);
+    nonce[kNoncePrefixSize] = static_cast<uint8_t>(segment >> 24);
+    nonce[kNoncePrefixSize + 1] = static_cast<uint8_t>(segment >> 16);
+    nonce[kNoncePrefixSize + 2] = static_cast<uint8_t>(segment >> 8);
+    nonce[kNoncePrefixSize + 3] = static_cast<uint8_t>(segment);
+    nonce[kNoncePrefixSize + 4] = last_segment ? 1 : 0;
+  }
+
+  unique_ptr<EVP_AEAD_CTX, decltype(&EVP_AEAD_CTX_free)> ctx_;
+  string nonce_prefix_;
+  size_t ciphertext_segment_size_;
+  size_t header_size_;
+};
+
+/**
+ * @brief Derives the key of a stream from the main key and creates the
+ * cipher of its segments.
+ *
+ * @return shared_ptr<const SegmentCipher> the cipher, or null on failure.
+ */
+shared_ptr<const SegmentCipher> CreateSegmentCipher(
+    string_view main_key, const EVP_MD* hkdf_hash, string_view salt,
+    string_view associated_data, string nonce_prefix,
+    size_t ciphertext_segment_size) {
+  size_t derived_key_size = salt.size();
+  uint8_t key[32];
+  if (HKDF(key, derived_key_size, hkdf_hash,
+           reinterpret_cast<const uint8_t*>(main_key.data()), main_key.size(),
+           reinterpret_cast<const uint8_t*>(salt.data()), salt.size(),
+           reinterpret_cast<const uint8_t*>(associated_data.data()),
+           associated_data.size()) != 1) {
+    return nullptr;
+  }
+  auto* ctx = EVP_AEAD_CTX_new(derived_key_size == 16 ? EVP_aead_aes_128_gcm()
+                                                      : EVP_aead_aes_256_gcm(),
+                               key, derived_key_size, kTagSize);
+  OPENSSL_cleanse(key, sizeof(key));
+  if (ctx == nullptr) {
+    return nullptr;
+  }
+  return make_shared<const SegmentCipher>(
+      ctx, move(nonce_prefix), ciphertext_segment_size,
+      1 + derived_key_size + kNoncePrefixSize);
+}
+
+/// A run of consecutive segments which is encrypted or decrypted as one task.
+struct Chunk {
+  size_t first_segment = 0;
+  bool last = false;
+  string input;
+  string output;
+  /// Set by whoever processes the chunk, so that it is processed only once.
+  atomic<bool> started = false;
+  /// Guarded by ChunkPipeline::State::done_mutex.
+  bool done = false;
+  Status status;
+};
+
+/**
+ * @brief Processes chunks on an executor and hands them back in submission
+ * order, with at most max_in_flight chunks submitted but not handed back.
+ * Used from one thread.
+ */
+class ChunkPipeline {
+ public:
+  using ChunkWork = function<Status(Chunk&)>;
+
+  ChunkPipeline(shared_ptr<AsyncExecutorInterface> executor,
+                size_t max_in_flight, ChunkWork work)
+      : executor_(move(executor)),
+        max_in_flight_(max<size_t>(max_in_flight, 1)),
+        work_(make_shared<const ChunkWork>(std::move(work))),
+        state_(make_shared<State>()) {}
+
+  bool IsFull() const { return chunks_.size() >= max_in_flight_; }
+
+  bool IsEmpty() const { return chunks_.empty(); }
+
+  /// Starts processing the chunk. Must not be called when full.
+  void Submit(shared_ptr<Chunk> chunk) {
+    chunks_.push_back(chunk);
+    auto task = [work = work_, state = state_, chunk]() {
+      Run(*work, *state, *chunk);
+    };
+    if (!executor_ ||
+        !executor_->Schedule(task, AsyncPriority::Normal).Successful()) {
+      task();
+    }
+  }
+
+  /// Waits for the oldest chunk to be processed and hands it back. A chunk
+  /// the executor has not picked up yet is processed on the calling thread.
+  shared_ptr<Chunk> PopFront() {
+    auto chunk = move(chunks_.front());
+    chunks_.pop_front();
+    Run(*work_, *state_, *chunk);
+    unique_lock lock(state_->done_mutex);
+    state_->done_condition.wait(lock, [&chunk]() { return chunk->done; });
+    return chunk;
+  }
+
+ private:
+  struct State {
+    mutex done_mutex;
+    condition_variable done_condition;
+  };
+
+  static void Run(const ChunkWork& work, State& state, Chunk& chunk) {
+    if (chunk.started.exchange(true)) {
+      return;
+    }
+    auto status = work(chunk);
+    lock_guard lock(state.done_mutex);
+    chunk.status = std::move(status);
+    chunk.done = true;
+    state.done_condition.notify_all();
+  }
+
+  shared_ptr<AsyncExecutorInterface> executor_;
+  const size_t max_in_flight_;
+  /// Tasks share the work and the state, so that they can outlive the
+  /// pipeline.
+  shared_ptr<const ChunkWork> work_;
+  shared_ptr<State> state_;
+  deque<shared_ptr<Chunk>> chunks_;
+};
+
+/// Number of segments per chunk and chunks in flight for the window.
+void GetChunking(size_t ciphertext_segment_size, size_t window_size_in_bytes,
+                 size_t& segments_per_chunk, size_t& max_chunks_in_flight) {
+  size_t chunk_size =
+      min(kTargetChunkSize, window_size_in_bytes / kMinChunksPerWindow);
+  segments_per_chunk = max<size_t>(chunk_size / ciphertext_segment_size, 1);
+  max_chunks_in_flight = max<size_t>(
+      window_size_in_bytes / (segments_per_chunk * ciphertext_segment_size),
+      1);
+}
+
+/// Encrypts the plaintext written to it in chunks, and writes the ciphertext
+/// of the chunks in order once they are done.
+class ParallelEncryptingStream : public OutputStream {
+ public:
+  ParallelEncryptingStream(shared_ptr<const SegmentCipher> cipher,
+                           unique_ptr<ostream> ciphertext_destination,
+                           shared_ptr<AsyncExecutorInterface> executor,
+                           size_t segments_per_chunk,
+                           size_t max_chunks_in_flight)
+      : cipher_(cipher),
+        ciphertext_destination_(move(ciphertext_destination)),
+        segments_per_chunk_(segments_per_chunk),
+        pipeline_(move(executor), max_chunks_in_flight,
+                  [cipher](Chunk& chunk) {
+                    auto status = cipher->EncryptSegments(
+                        chunk.first_segment, chunk.last, chunk.input,
+                        chunk.output);
+                    string().swap(chunk.input);
+                    return status;
+                  }) {
+    StartChunk();
+  }
+
+  StatusOr<int> Next(void** data) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (closed_) {
+      return Status(absl::StatusCode::kFailedPrecondition, "Stream closed");
+    }
+    if (used_ == current_->input.size()) {
+      status_ = SubmitChunk(false);
+      if (!status_.ok()) {
+        return status_;
+      }
+    }
+    *data = current_->input.data() + used_;
+    int size = static_cast<int>(current_->input.size() - used_);
+    used_ = current_->input.size();
+    return size;
+  }
+
+  void BackUp(int count) override {
+    used_ -= min(static_cast<size_t>(max(count, 0)), used_);
+  }
+
+  Status Close() override {
+    if (closed_) {
+      return Status(absl::StatusCode::kFailedPrecondition, "Stream closed");
+    }
+    closed_ = true;
+    if (!status_.ok()) {
+      return status_;
+    }
+    status_ = SubmitChunk(true);
+    while (status_.ok() && !pipeline_.IsEmpty()) {
+      status_ = WriteFront();
+    }
+    if (status_.ok() && !ciphertext_destination_->flush()) {
+      status_ = Status(absl::StatusCode::kUnknown,
+                       "Writing the ciphertext failed.");
+    }
+    return status_;
+  }
+
+  int64_t Position() const override { return position_ + used_; }
+
+ private:
+  /// Sets up an empty chunk to take the next plaintext.
+  void StartChunk() {
+    current_ = make_shared<Chunk>();
+    current_->first_segment = chunk_number_ * segments_per_chunk_;
+    size_t size = 0;
+    for (size_t i = 0; i < segments_per_chunk_; ++i) {
+      size += cipher_->PlaintextSegmentSize(current_->first_segment + i);
+    }
+    current_->input.resize(min<size_t>(size, INT_MAX));
+    used_ = 0;
+  }
+
+  /// Submits the current chunk, after making room in the window by writing
+  /// out the oldest chunks.
+  Status SubmitChunk(bool last) {
+    while (pipeline_.IsFull()) {
+      auto status = WriteFront();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    current_->input.resize(used_);
+    current_->last = last;
+    position_ += used_;
+    ++chunk_number_;
+    pipeline_.Submit(move(current_));
+    if (!last) {
+      StartChunk();
+    } else {
+      used_ = 0;
+    }
+    return Status();
+  }
+
+  /// Waits for the oldest chunk and writes out its ciphertext.
+  Status WriteFront() {
+    auto chunk = pipeline_.PopFront();
+    if (!chunk->status.ok()) {
+      return chunk->status;
+    }
+    if (!ciphertext_destination_->write(chunk->output.data(),
+                                        chunk->output.size())) {
+      return Status(absl::StatusCode::kUnknown,
+                    "Writing the ciphertext failed.");
+    }
+    return Status();
+  }
+
+  shared_ptr<const SegmentCipher> cipher_;
+  unique_ptr<ostream> ciphertext_destination_;
+  const size_t segments_per_chunk_;
+  ChunkPipeline pipeline_;
+  /// The chunk taking the plaintext, and how much of it is filled.
+  shared_ptr<Chunk> current_;
+  size_t used_ = 0;
+  size_t chunk_number_ = 0;
+  /// The plaintext size of the submitted chunks.
+  int64_t position_ = 0;
+  bool closed_ = false;
+  Status status_;
+};
+
+/// Reads the ciphertext ahead of the reader in chunks, and hands out the
+/// plaintext of the chunks in order once they are decrypted.
+class ParallelDecryptingStream : public InputStream {
+ public:
+  ParallelDecryptingStream(string main_key, const EVP_MD* hkdf_hash,
+                           size_t derived_key_size,
+                           size_t ciphertext_segment_size,
+                           unique_ptr<istream> ciphertext_source,
+                           string associated_data,
+                           shared_ptr<AsyncExecutorInterface> executor,
+                           size_t segments_per_chunk,
+                           size_t max_chunks_in_flight)
+      : main_key_(move(main_key)),
+        hkdf_hash_(hkdf_hash),
+        derived_key_size_(derived_key_size),
+        ciphertext_segment_size_(ciphertext_segment_size),
+        ciphertext_source_(move(ciphertext_source)),
+        associated_data_(move(associated_data)),
+        executor_(move(executor)),
+        segments_per_chunk_(segments_per_chunk),
+        max_chunks_in_flight_(max_chunks_in_flight) {}
+
+  ~ParallelDecryptingStream() override {
+    OPENSSL_cleanse(main_key_.data(), main_key_.size());
+  }
+
+  StatusOr<int> Next(const void** data) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (!pipeline_) {
+      status_ = ReadHeader();
+      if (!status_.ok()) {
+        return status_;
+      }
+    }
+    // Empty chunks only end the stream, but are skipped all the same.
+    while (!current_ || read_ == current_->output.size()) {
+      status_ = ReadAhead();
+      if (!status_.ok()) {
+        return status_;
+      }
+      if (pipeline_->IsEmpty()) {
+        status_ = Status(absl::StatusCode::kOutOfRange, "EOF");
+        return status_;
+      }
+      current_ = pipeline_->PopFront();
+      read_ = 0;
+      if (!current_->status.ok()) {
+        status_ = current_->status;
+        return status_;
+      }
+      // Keeps the window full while the reader takes this chunk.
+      status_ = ReadAhead();
+      if (!status_.ok()) {
+        return status_;
+      }
+    }
+    *data = current_->output.data() + read_;
+    int size = static_cast<int>(
+        min<size_t>(current_->output.size() - read_, INT_MAX));
+    read_ += size;
+    position_ += size;
+    return size;
+  }
+
+  void BackUp(int count) override {
+    size_t backed_up = min(static_cast<size_t>(max(count, 0)), read_);
+    read_ -= backed_up;
+    position_ -= backed_up;
+  }
+
+  int64_t Position() const override { return position_; }
+
+ private:
+  /// Reads the header and sets up the cipher of the stream.
+  Status ReadHeader() {
+    size_t header_size = 1 + derived_key_size_ + kNoncePrefixSize;
+    string header(header_size, '\0');
+    ciphertext_source_->read(header.data(), header_size);
+    if (static_cast<size_t>(ciphertext_source_->gcount()) != header_size ||
+        static_cast<uint8_t>(header[0]) != header_size) {
+      return Status(absl::StatusCode::kInvalidArgument,
+                    "Invalid stream header.");
+    }
+    auto cipher = CreateSegmentCipher(
+        main_key_, hkdf_hash_, string_view(header).substr(1, derived_key_size_),
+        associated_data_, header.substr(1 + derived_key_size_),
+        ciphertext_segment_size_);
+    OPENSSL_cleanse(main_key_.data(), main_key_.size());
+    if (!cipher) {
+      return Status(absl::StatusCode::kInternal,
+                    "Deriving the key of the stream failed.");
+    }
+    cipher_ = cipher;
+    pipeline_ = make_unique<ChunkPipeline>(
+        executor_, max_chunks_in_flight_, [cipher](Chunk& chunk) {
+          auto status = cipher->DecryptSegments(
+              chunk.first_segment, chunk.last, chunk.input, chunk.output);
+          string().swap(chunk.input);
+          return status;
+        });
+    return Status();
+  }
+
+  /// Reads chunks of ciphertext and submits them until the window is full or
+  /// the ciphertext ends.
+  Status ReadAhead() {
+    while (!end_of_ciphertext_ && !pipeline_->IsFull()) {
+      auto chunk = make_shared<Chunk>();
+      chunk->first_segment = chunk_number_ * segments_per_chunk_;
+      size_t size = 0;
+      for (size_t i = 0; i < segments_per_chunk_; ++i) {
+        size += cipher_->CiphertextSegmentSize(chunk->first_segment + i);
+      }
+      chunk->input.resize(size);
+      ciphertext_source_->read(chunk->input.data(), size);
+      if (ciphertext_source_->bad()) {
+        return Status(absl::StatusCode::kUnknown,
+                      "Reading the ciphertext failed.");
+      }
+      size_t read = ciphertext_source_->gcount();
+      chunk->input.resize(read);
+      // A chunk which fills up exactly ends the stream only if nothing
+      // follows it.
+      chunk->last = read < size ||
+                    ciphertext_source_->peek() == istream::traits_type::eof();
+      end_of_ciphertext_ = chunk->last;
+      ++chunk_number_;
+      pipeline_->Submit(move(chunk));
+    }
+    return Status();
+  }
+
+  /// The main key, wiped once the key of the stream is derived.
+  string main_key_;
+  const EVP_MD* hkdf_hash_;
+  const size_t derived_key_size_;
+  const size_t ciphertext_segment_size_;
+  unique_ptr<istream> ciphertext_source_;
+  const string associated_data_;
+  shared_ptr<AsyncExecutorInterface> executor_;
+  const size_t segments_per_chunk_;
+  const size_t max_chunks_in_flight_;
+
+  /// Set up once the header is read.
+  shared_ptr<const SegmentCipher> cipher_;
+  unique_ptr<ChunkPipeline> pipeline_;
+  size_t chunk_number_ = 0;
+  bool end_of_ciphertext_ = false;
+  /// The chunk being read, and how much of it has been handed out.
+  shared_ptr<Chunk> current_;
+  size_t read_ = 0;
+  int64_t position_ = 0;
+  Status status_;
+};
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+ParallelStreamingAead::ParallelStreamingAead(string main_key,
+                                             const EVP_MD* hkdf_hash,
+                                             size_t derived_key_size,
+                                             size_t ciphertext_segment_size)
+    : main_key_(move(main_key)),
+      hkdf_hash_(hkdf_hash),
+      derived_key_size_(derived_key_size),
+      ciphertext_segment_size_(ciphertext_segment_size) {}
+
+ParallelStreamingAead::~ParallelStreamingAead() {
+  OPENSSL_cleanse(main_key_.data(), main_key_.size());
+}
+
+ExecutionResultOr<unique_ptr<ParallelStreamingAead>>
+ParallelStreamingAead::Create(const AesGcmHkdfStreamingKey& key) noexcept {
+  const EVP_MD* hkdf_hash = nullptr;
+  switch (key.params().hkdf_hash_type()) {
+    case HashType::SHA1:
+      hkdf_hash = EVP_sha1();
+      break;
+    case HashType::SHA256:
+      hkdf_hash = EVP_sha256();
+      break;
+    case HashType::SHA512:
+      hkdf_hash = EVP_sha512();
+      break;
+    default:
+      break;
+  }
+  size_t derived_key_size = key.params().derived_key_size();
+  size_t ciphertext_segment_size = key.params().ciphertext_segment_size();
+  // The same limits as Tink's AesGcmHkdfStreaming, so that both accept the
+  // same keys.
+  if (hkdf_hash == nullptr ||
+      (derived_key_size != 16 && derived_key_size != 32) ||
+      key.key_value().size() < derived_key_size ||
+      ciphertext_segment_size <=
+          1 + derived_key_size + kNoncePrefixSize + kTagSize ||
+      ciphertext_segment_size > INT_MAX) {
+    auto execution_result =
+        FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED);
+    SCP_ERROR(kParallelStreamingAead, kZeroUuid, execution_result,
+              "Invalid AesGcmHkdfStreamingKey parameters.");
+    return execution_result;
+  }
+  return unique_ptr<ParallelStreamingAead>(new ParallelStreamingAead(
+      key.key_value(), hkdf_hash, derived_key_size, ciphertext_segment_size));
+}
+
+ExecutionResultOr<unique_ptr<OutputStream>>
+ParallelStreamingAead::NewEncryptingStream(
+    unique_ptr<ostream> ciphertext_destination, string_view associated_data,
+    const shared_ptr<AsyncExecutorInterface>& executor,
+    size_t window_size_in_bytes) const noexcept {
+  size_t header_size = 1 + derived_key_size_ + kNoncePrefixSize;
+  string header(header_size, '\0');
+  header[0] = static_cast<char>(header_size);
+  if (RAND_bytes(reinterpret_cast<uint8_t*>(header.data()) + 1,
+                 header_size - 1) != 1) {
+    auto execution_result = FailureExecutionResult(
+        SC_CRYPTO_CLIENT_PROVIDER_SAEAD_CREATE_ENCRYPT_STREAM_FAILED);
+    SCP_ERROR(kParallelStreamingAead, kZeroUuid, execution_result,
+              "Generating the stream header failed.");
+    return execution_result;
+  }
+  auto cipher = CreateSegmentCipher(
+      main_key_, hkdf_hash_, string_view(header).substr(1, derived_key_size_),
+      associated_data, header.substr(1 + derived_key_size_),
+      ciphertext_segment_size_);
+  if (!cipher) {
+    auto execution_result = FailureExecutionResult(
+        SC_CRYPTO_CLIENT_PROVIDER_SAEAD_CREATE_ENCRYPT_STREAM_FAILED);
+    SCP_ERROR(kParallelStreamingAead, kZeroUuid, execution_result,
+              "Deriving the key of the stream failed.");
+    return execution_result;
+  }
+  if (!ciphertext_destination->write(header.data(), header.size())) {
+    auto execution_result = FailureExecutionResult(
+        SC_CRYPTO_CLIENT_PROVIDER_SAEAD_CREATE_ENCRYPT_STREAM_FAILED);
+    SCP_ERROR(kParallelStreamingAead, kZeroUuid, execution_result,
+              "Writing the stream header failed.");
+    return execution_result;
+  }
+
+  size_t segments_per_chunk;
+  size_t max_chunks_in_flight;
+  GetChunking(ciphertext_segment_size_, window_size_in_bytes,
+              segments_per_chunk, max_chunks_in_flight);
+  return unique_ptr<OutputStream>(make_unique<ParallelEncryptingStream>(
+      move(cipher), move(ciphertext_destination), executor,
+      segments_per_chunk, max_chunks_in_flight));
+}
+
+ExecutionResultOr<unique_ptr<InputStream>>
+ParallelStreamingAead::NewDecryptingStream(
+    unique_ptr<istream> ciphertext_source, string_view associated_data,
+    const shared_ptr<AsyncExecutorInterface>& executor,
+    size_t window_size_in_bytes) const noexcept {
+  size_t segments_per_chunk;
+  size_t max_chunks_in_flight;
+  GetChunking(ciphertext_segment_size_, window_size_in_bytes,
+              segments_per_chunk, max_chunks_in_flight);
+  // The key of the stream depends on the header, which is read on the first
+  // call to Next() like Tink's decrypting streams do.
+  return unique_ptr<InputStream>(make_unique<ParallelDecryptingStream>(
+      main_key_, hkdf_hash_, derived_key_size_, ciphertext_segment_size_,
+      move(ciphertext_source), string(associated_data), executor,
+      segments_per_chunk, max_chunks_in_flight));
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/base.h>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <tink/input_stream.h>
+#include <tink/output_stream.h>
+
+#include "core/interface/async_executor_interface.h"
+#include "proto/aes_gcm_hkdf_streaming.pb.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief AES-GCM-HKDF streaming AEAD which encrypts and decrypts the segments
+ * of a stream in parallel on an executor.
+ *
+ * The ciphertext has the segment format of Tink's AesGcmHkdfStreaming, so it
+ * can be decrypted by Tink's sequential streams and vice versa:
+ * a header of [header size | salt | nonce prefix], followed by segments which
+ * are each sealed with AES-GCM under a key derived from the salt and the
+ * associated data, and a nonce made of the nonce prefix, the segment number
+ * and whether the segment is the last one.
+ *
+ * The streams work on chunks of consecutive segments. Up to
+ * window_size_in_bytes of chunks are encrypted or decrypted at once, and are
+ * written or returned in order. A missing or busy executor only means that
+ * chunks are processed on the calling thread.
+ */
+class ParallelStreamingAead {
+ public:
+  /**
+   * @brief Creates the streaming AEAD of the Tink key.
+   *
+   * @param key the Tink key. Its key_value is the raw main key.
+   * @return core::ExecutionResultOr<std::unique_ptr<ParallelStreamingAead>>
+   * the streaming AEAD, or a failure if the key parameters are invalid.
+   */
+  static core::ExecutionResultOr<std::unique_ptr<ParallelStreamingAead>> Create(
+      const google::crypto::tink::AesGcmHkdfStreamingKey& key) noexcept;
+
+  /// Wipes the main key.
+  ~ParallelStreamingAead();
+
+  /**
+   * @brief Creates a stream which encrypts the plaintext written to it into
+   * ciphertext_destination. The ciphertext is complete once the stream is
+   * closed.
+   *
+   * @param ciphertext_destination where the ciphertext is written to.
+   * @param associated_data the associated data bound to the ciphertext.
+   * @param executor the executor to encrypt chunks on. Can be null.
+   * @param window_size_in_bytes the max size of the chunks being encrypted at
+   * once.
+   */
+  core::ExecutionResultOr<std::unique_ptr<::crypto::tink::OutputStream>>
+  NewEncryptingStream(
+      std::unique_ptr<std::ostream> ciphertext_destination,
+      std::string_view associated_data,
+      const std::shared_ptr<core::AsyncExecutorInterface>& executor,
+      size_t window_size_in_bytes) const noexcept;
+
+  /**
+   * @brief Creates a stream which decrypts the ciphertext read from
+   * ciphertext_source. Chunks are read and decrypted ahead of the reader.
+   *
+   * @param ciphertext_source where the ciphertext is read from.
+   * @param associated_data the associated data bound to the ciphertext.
+   * @param executor the executor to decrypt chunks on. Can be null.
+   * @param window_size_in_bytes the max size of the chunks being decrypted at
+   * once.
+   */
+  core::ExecutionResultOr<std::unique_ptr<::crypto::tink::InputStream>>
+  NewDecryptingStream(
+      std::unique_ptr<std::istream> ciphertext_source,
+      std::string_view associated_data,
+      const std::shared_ptr<core::AsyncExecutorInterface>& executor,
+      size_t window_size_in_bytes) const noexcept;
+
+ private:
+  ParallelStreamingAead(std::string main_key, const EVP_MD* hkdf_hash,
+                        size_t derived_key_size,
+                        size_t ciphertext_segment_size);
+
+  /// The main key which the keys of the streams are derived from.
+  std::string main_key_;
+  const EVP_MD* hkdf_hash_;
+  /// Size of the AES-GCM keys derived for each stream.
+  size_t derived_key_size_;
+  /// Size of every ciphertext segment but the last one.
+  size_t ciphertext_segment_size_;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,672 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tink/binary_keyset_writer.h>
+#include <tink/cleartext_keyset_handle.h>
+#include <tink/hybrid/hybrid_key_templates.h>
+#include <tink/keyset_handle.h>
+#include <tink/subtle/random.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/utils/src/base64.h"
+#include "cpio/client_providers/crypto_client_provider/src/crypto_client_provider.h"
+#include "proto/hpke.pb.h"
+#include "proto/tink.pb.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+#include "public/cpio/interface/crypto_client/type_def.h"
+#include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
+
+using crypto::tink::BinaryKeysetWriter;
+using crypto::tink::CleartextKeysetHandle;
+using crypto::tink::HybridKeyTemplates;
+using crypto::tink::KeysetHandle;
+using crypto::tink::subtle::Random;
+using google::cmrt::sdk::crypto_service::v1::AeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::HashType;
+using google::cmrt::sdk::crypto_service::v1::HpkeAead;
+using google::cmrt::sdk::crypto_service::v1::HpkeDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::HpkeDecryptResponse;
+using google::cmrt::sdk::crypto_service::v1::HpkeEncryptRequest;
+using google::cmrt::sdk::crypto_service::v1::HpkeKdf;
+using google::cmrt::sdk::crypto_service::v1::HpkeKem;
+using google::cmrt::sdk::crypto_service::v1::RawKeyWithParams;
+using google::cmrt::sdk::crypto_service::v1::StreamingAeadParams;
+using google::crypto::tink::HpkeKeyFormat;
+using google::crypto::tink::HpkePrivateKey;
+using google::crypto::tink::KeyTemplate;
+using google::crypto::tink::OutputPrefixType;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::utils::Base64Encode;
+using google::scp::cpio::AeadDecryptStreamRequest;
+using google::scp::cpio::AeadEncryptStreamRequest;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::unique_ptr;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// Heap allocations of the process, counted by the global operator new below
+// so that the benchmarks can report the allocations per operation.
+static std::atomic<int64_t> allocation_count{0};
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace google::scp::cpio::client_providers::test {
+
+static constexpr size_t kPayloadSize = 1024;
+static constexpr size_t kStreamSize = 256 << 20;
+// 64 B to 16 MiB, for the throughput by payload size.
+static const vector<int64_t> kPayloadSizes = {
+    64, 1 << 10, 16 << 10, 256 << 10, 1 << 20, 4 << 20, 16 << 20};
+// The HPKE suites in kHpkeKemMap, kHpkeKdfMap and kHpkeAeadMap.
+static const vector<int64_t> kHpkeKems = {HpkeKem::DHKEM_X25519_HKDF_SHA256,
+                                          HpkeKem::DHKEM_P256_HKDF_SHA256};
+static const vector<int64_t> kHpkeKdfs = {HpkeKdf::HKDF_SHA256};
+static const vector<int64_t> kHpkeAeads = {
+    HpkeAead::AES_128_GCM, HpkeAead::AES_256_GCM, HpkeAead::CHACHA20_POLY1305};
+
+// Gets the value below which the given fraction of values fall.
+static double Percentile(vector<double>& values, double fraction) {
+  if (values.empty()) {
+    return 0;
+  }
+  auto nth =
+      values.begin() + static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+// Runs operation once per iteration, and reports next to the timings:
+// allocs_per_op, the heap allocations of one operation, and p50_latency_us
+// and p99_latency_us over all the iterations.
+template <typename Operation>
+static void RunAndReport(benchmark::State& state, Operation&& operation) {
+  vector<double> latencies_us;
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    auto start = steady_clock::now();
+    auto allocations_before = allocation_count.load(std::memory_order_relaxed);
+    operation();
+    allocations +=
+        allocation_count.load(std::memory_order_relaxed) - allocations_before;
+    latencies_us.push_back(
+        duration<double, std::micro>(steady_clock::now() - start).count());
+  }
+  state.counters["allocs_per_op"] =
+      benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+  state.counters["p50_latency_us"] = Percentile(latencies_us, 0.5);
+  state.counters["p99_latency_us"] = Percentile(latencies_us, 0.99);
+}
+
+static unique_ptr<CryptoClientProvider> CreateClient(
+    size_t key_cache_size,
+    const shared_ptr<AsyncExecutorInterface>& cpu_async_executor = nullptr) {
+  auto options = make_shared<CryptoClientOptions>();
+  options->key_cache_size = key_cache_size;
+  auto client = make_unique<CryptoClientProvider>(options, cpu_async_executor);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+  return client;
+}
+
+static string EncodeKeyset(const KeysetHandle& keyset_handle) {
+  std::stringbuf key_buf(std::ios_base::out);
+  auto keyset_writer =
+      BinaryKeysetWriter::New(make_unique<std::ostream>(&key_buf));
+  auto write_result =
+      CleartextKeysetHandle::Write(keyset_writer->get(), keyset_handle);
+  return *Base64Encode(key_buf.str());
+}
+
+// Creates one HPKE decrypt request for each of num_keys new keys, so that the
+// benchmark rotates through a working set of keys like a decryption worker.
+static vector<HpkeDecryptRequest> CreateHpkeDecryptRequests(
+    CryptoClientProvider& client, size_t num_keys, bool is_bidirectional) {
+  vector<HpkeDecryptRequest> requests;
+  for (size_t i = 0; i < num_keys; ++i) {
+    auto private_handle = KeysetHandle::GenerateNew(
+        HybridKeyTemplates::HpkeX25519HkdfSha256Aes256GcmRaw());
+    auto public_handle = (*private_handle)->GetPublicKeysetHandle();
+
+    HpkeEncryptRequest encrypt_request;
+    encrypt_request.set_key_id(to_string(i));
+    encrypt_request.set_tink_key_binary(EncodeKeyset(**public_handle));
+    encrypt_request.set_is_bidirectional(is_bidirectional);
+    encrypt_request.set_payload(Random::GetRandomBytes(kPayloadSize));
+    auto encrypt_response_or = client.HpkeEncryptSync(encrypt_request);
+    EXPECT_SUCCESS(encrypt_response_or.result());
+
+    HpkeDecryptRequest decrypt_request;
+    *decrypt_request.mutable_encrypted_data() =
+        encrypt_response_or->encrypted_data();
+    decrypt_request.set_tink_key_binary(EncodeKeyset(**private_handle));
+    decrypt_request.set_is_bidirectional(is_bidirectional);
+    requests.push_back(decrypt_request);
+  }
+  return requests;
+}
+
+// Args: key cache size (0 for cold, i.e. key setup on every call), number of
+// keys.
+static void BM_HpkeDecrypt(benchmark::State& state, bool is_bidirectional) {
+  auto client = CreateClient(state.range(0));
+  auto requests =
+      CreateHpkeDecryptRequests(*client, state.range(1), is_bidirectional);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto response_or = client->HpkeDecryptSync(requests[i++ % requests.size()]);
+    benchmark::DoNotOptimize(response_or);
+  }
+  state.SetItemsProcessed(state.iterations());
+  auto stats = client->GetKeyCacheStats();
+  state.counters["cache_hits"] = stats.hits;
+  state.counters["cache_misses"] = stats.misses;
+}
+
+static void BM_HpkeDecryptBidirectional(benchmark::State& state) {
+  BM_HpkeDecrypt(state, true /*is_bidirectional*/);
+}
+
+static void BM_HpkeDecryptOneDirection(benchmark::State& state) {
+  BM_HpkeDecrypt(state, false /*is_bidirectional*/);
+}
+
+static void BM_AeadDecrypt(benchmark::State& state) {
+  auto client = CreateClient(state.range(0));
+  vector<AeadDecryptRequest> requests;
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    AeadEncryptRequest encrypt_request;
+    encrypt_request.set_secret(Random::GetRandomBytes(32));
+    encrypt_request.set_payload(Random::GetRandomBytes(kPayloadSize));
+    auto encrypt_response_or = client->AeadEncryptSync(encrypt_request);
+    EXPECT_SUCCESS(encrypt_response_or.result());
+
+    AeadDecryptRequest decrypt_request;
+    *decrypt_request.mutable_encrypted_data() =
+        encrypt_response_or->encrypted_data();
+    decrypt_request.set_secret(encrypt_request.secret());
+    requests.push_back(decrypt_request);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto response_or = client->AeadDecryptSync(requests[i++ % requests.size()]);
+    benchmark::DoNotOptimize(response_or);
+  }
+  state.SetItemsProcessed(state.iterations());
+  auto stats = client->GetKeyCacheStats();
+  state.counters["cache_hits"] = stats.hits;
+  state.counters["cache_misses"] = stats.misses;
+}
+
+// A new key pair of the HPKE suite, in the raw form the provider maps to Tink
+// through kHpkeKemMap, kHpkeKdfMap and kHpkeAeadMap.
+struct HpkeRawKeyPair {
+  RawKeyWithParams public_key;
+  RawKeyWithParams private_key;
+};
+
+static HpkeRawKeyPair CreateHpkeRawKeyPair(HpkeKem kem, HpkeKdf kdf,
+                                           HpkeAead aead) {
+  // The HPKE enums of the crypto service have the values of Tink's.
+  HpkeKeyFormat key_format;
+  key_format.mutable_params()->set_kem(
+      static_cast<google::crypto::tink::HpkeKem>(kem));
+  key_format.mutable_params()->set_kdf(
+      static_cast<google::crypto::tink::HpkeKdf>(kdf));
+  key_format.mutable_params()->set_aead(
+      static_cast<google::crypto::tink::HpkeAead>(aead));
+  KeyTemplate key_template;
+  key_template.set_type_url(
+      "type.googleapis.com/google.crypto.tink.HpkePrivateKey");
+  key_template.set_output_prefix_type(OutputPrefixType::RAW);
+  key_template.set_value(key_format.SerializeAsString());
+  auto keyset_handle = KeysetHandle::GenerateNew(key_template);
+  EXPECT_TRUE(keyset_handle.ok());
+  HpkePrivateKey private_key;
+  EXPECT_TRUE(private_key.ParseFromString(
+      CleartextKeysetHandle::GetKeyset(**keyset_handle)
+          .key(0)
+          .key_data()
+          .value()));
+
+  HpkeRawKeyPair key_pair;
+  key_pair.public_key.set_raw_key(
+      *Base64Encode(private_key.public_key().public_key()));
+  key_pair.public_key.mutable_hpke_params()->set_kem(kem);
+  key_pair.public_key.mutable_hpke_params()->set_kdf(kdf);
+  key_pair.public_key.mutable_hpke_params()->set_aead(aead);
+  key_pair.private_key.set_raw_key(*Base64Encode(private_key.private_key()));
+  *key_pair.private_key.mutable_hpke_params() =
+      key_pair.public_key.hpke_params();
+  return key_pair;
+}
+
+// Encrypts a random payload of the given size with the public key, and
+// returns the request to decrypt it with the private key.
+static HpkeDecryptRequest CreateHpkeDecryptRequest(
+    CryptoClientProvider& client, const HpkeRawKeyPair& key_pair,
+    size_t payload_size) {
+  HpkeEncryptRequest encrypt_request;
+  encrypt_request.set_key_id("key_id");
+  *encrypt_request.mutable_raw_key_with_params() = key_pair.public_key;
+  encrypt_request.set_payload(Random::GetRandomBytes(payload_size));
+  auto encrypt_response_or = client.HpkeEncryptSync(encrypt_request);
+  EXPECT_SUCCESS(encrypt_response_or.result());
+
+  HpkeDecryptRequest decrypt_request;
+  *decrypt_request.mutable_encrypted_data() =
+      encrypt_response_or->encrypted_data();
+  *decrypt_request.mutable_raw_key_with_params() = key_pair.private_key;
+  return decrypt_request;
+}
+
+// Args: KEM, KDF, AEAD, payload size in bytes.
+static void BM_HpkeEncryptSuite(benchmark::State& state) {
+  auto client = CreateClient(128);
+  auto key_pair = CreateHpkeRawKeyPair(static_cast<HpkeKem>(state.range(0)),
+                                       static_cast<HpkeKdf>(state.range(1)),
+                                       static_cast<HpkeAead>(state.range(2)));
+  HpkeEncryptRequest request;
+  request.set_key_id("key_id");
+  *request.mutable_raw_key_with_params() = key_pair.public_key;
+  request.set_payload(Random::GetRandomBytes(state.range(3)));
+  RunAndReport(state, [&] {
+    auto response_or = client->HpkeEncryptSync(request);
+    benchmark::DoNotOptimize(response_or);
+  });
+  state.SetBytesProcessed(state.iterations() * state.range(3));
+}
+
+// Args: KEM, KDF, AEAD, payload size in bytes.
+static void BM_HpkeDecryptSuite(benchmark::State& state) {
+  auto client = CreateClient(128);
+  auto key_pair = CreateHpkeRawKeyPair(static_cast<HpkeKem>(state.range(0)),
+                                       static_cast<HpkeKdf>(state.range(1)),
+                                       static_cast<HpkeAead>(state.range(2)));
+  auto request = CreateHpkeDecryptRequest(*client, key_pair, state.range(3));
+  RunAndReport(state, [&] {
+    auto response_or = client->HpkeDecryptSync(request);
+    benchmark::DoNotOptimize(response_or);
+  });
+  state.SetBytesProcessed(state.iterations() * state.range(3));
+}
+
+// Args: KEM, KDF, AEAD, key cache size. With a cache size of 0 the key is set
+// up on every decrypt, so the difference to a cache size of 128 is the cost of
+// the key setup.
+static void BM_HpkeKeySetup(benchmark::State& state) {
+  auto client = CreateClient(state.range(3));
+  auto key_pair = CreateHpkeRawKeyPair(static_cast<HpkeKem>(state.range(0)),
+                                       static_cast<HpkeKdf>(state.range(1)),
+                                       static_cast<HpkeAead>(state.range(2)));
+  auto request = CreateHpkeDecryptRequest(*client, key_pair, 64);
+  RunAndReport(state, [&] {
+    auto response_or = client->HpkeDecryptSync(request);
+    benchmark::DoNotOptimize(response_or);
+  });
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Args: secret size in bytes, payload size in bytes.
+static void BM_AeadEncryptPayload(benchmark::State& state) {
+  auto client = CreateClient(128);
+  AeadEncryptRequest request;
+  request.set_secret(Random::GetRandomBytes(state.range(0)));
+  request.set_payload(Random::GetRandomBytes(state.range(1)));
+  RunAndReport(state, [&] {
+    auto response_or = client->AeadEncryptSync(request);
+    benchmark::DoNotOptimize(response_or);
+  });
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+// Args: secret size in bytes, payload size in bytes.
+static void BM_AeadDecryptPayload(benchmark::State& state) {
+  auto client = CreateClient(128);
+  AeadEncryptRequest encrypt_request;
+  encrypt_request.set_secret(Random::GetRandomBytes(state.range(0)));
+  encrypt_request.set_payload(Random::GetRandomBytes(state.range(1)));
+  auto encrypt_response_or = client->AeadEncryptSync(encrypt_request);
+  EXPECT_SUCCESS(encrypt_response_or.result());
+  AeadDecryptRequest request;
+  *request.mutable_encrypted_data() = encrypt_response_or->encrypted_data();
+  request.set_secret(encrypt_request.secret());
+  RunAndReport(state, [&] {
+    auto response_or = client->AeadDecryptSync(request);
+    benchmark::DoNotOptimize(response_or);
+  });
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+// Args: payload size in bytes. Serializes and parses the request, as the
+// crypto service does around every HpkeDecrypt call. bytes_per_second is the
+// serialized size.
+static void BM_HpkeDecryptRequestMarshaling(benchmark::State& state) {
+  auto client = CreateClient(128);
+  auto key_pair = CreateHpkeRawKeyPair(HpkeKem::DHKEM_X25519_HKDF_SHA256,
+                                       HpkeKdf::HKDF_SHA256,
+                                       HpkeAead::AES_256_GCM);
+  auto request = CreateHpkeDecryptRequest(*client, key_pair, state.range(0));
+  string serialized;
+  HpkeDecryptRequest parsed;
+  RunAndReport(state, [&] {
+    request.SerializeToString(&serialized);
+    parsed.ParseFromString(serialized);
+    benchmark::DoNotOptimize(parsed);
+  });
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+
+// Args: payload size in bytes. Like BM_HpkeDecryptRequestMarshaling, for the
+// response of a bidirectional decrypt.
+static void BM_HpkeDecryptResponseMarshaling(benchmark::State& state) {
+  HpkeDecryptResponse response;
+  response.set_payload(Random::GetRandomBytes(state.range(0)));
+  response.set_secret(Random::GetRandomBytes(32));
+  string serialized;
+  HpkeDecryptResponse parsed;
+  RunAndReport(state, [&] {
+    response.SerializeToString(&serialized);
+    parsed.ParseFromString(serialized);
+    benchmark::DoNotOptimize(parsed);
+  });
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+
+// Creates an executor with the given number of threads, or null for 0.
+static shared_ptr<AsyncExecutor> CreateExecutor(size_t thread_count) {
+  if (thread_count == 0) {
+    return nullptr;
+  }
+  auto executor = make_shared<AsyncExecutor>(thread_count, 100000);
+  EXPECT_SUCCESS(executor->Init());
+  EXPECT_SUCCESS(executor->Run());
+  return executor;
+}
+
+// Args: executor thread count (0 for the calling thread only), batch size.
+static void BM_BatchHpkeDecrypt(benchmark::State& state) {
+  auto executor = CreateExecutor(state.range(0));
+  auto client = CreateClient(128, executor);
+  auto requests = CreateHpkeDecryptRequests(*client, 1, true);
+  BatchHpkeDecryptRequest batch_request;
+  batch_request.set_tink_key_binary(requests[0].tink_key_binary());
+  batch_request.set_is_bidirectional(true);
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    // Every HPKE ciphertext has its own encapsulated key, so reusing one
+    // ciphertext costs as much as distinct ones.
+    batch_request.add_ciphertexts(requests[0].encrypted_data().ciphertext());
+  }
+  for (auto _ : state) {
+    auto response_or = client->BatchHpkeDecryptSync(batch_request);
+    benchmark::DoNotOptimize(response_or);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  if (executor) {
+    executor->Stop();
+  }
+}
+
+// Args: executor thread count (0 for the calling thread only), batch size.
+static void BM_BatchAeadDecrypt(benchmark::State& state) {
+  auto executor = CreateExecutor(state.range(0));
+  auto client = CreateClient(128, executor);
+  BatchAeadDecryptRequest batch_request;
+  batch_request.set_secret(Random::GetRandomBytes(32));
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    AeadEncryptRequest encrypt_request;
+    encrypt_request.set_secret(batch_request.secret());
+    encrypt_request.set_payload(Random::GetRandomBytes(kPayloadSize));
+    auto encrypt_response_or = client->AeadEncryptSync(encrypt_request);
+    EXPECT_SUCCESS(encrypt_response_or.result());
+    batch_request.add_ciphertexts(
+        encrypt_response_or->encrypted_data().ciphertext());
+  }
+  for (auto _ : state) {
+    auto response_or = client->BatchAeadDecryptSync(batch_request);
+    benchmark::DoNotOptimize(response_or);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  if (executor) {
+    executor->Stop();
+  }
+}
+
+// AES-GCM-HKDF key with 1 MiB segments, like Tink's AES128_GCM_HKDF_1MB.
+static StreamingAeadParams CreateStreamingAeadParams() {
+  StreamingAeadParams params;
+  auto* raw_key =
+      params.mutable_aes_gcm_hkdf_key()->mutable_raw_key_with_params();
+  raw_key->set_key_value(*Base64Encode(Random::GetRandomBytes(16)));
+  raw_key->mutable_params()->set_ciphertext_segment_size(1 << 20);
+  raw_key->mutable_params()->set_derived_key_size(16);
+  raw_key->mutable_params()->set_hkdf_hash_type(HashType::SHA256);
+  params.set_shared_info("shared_info");
+  return params;
+}
+
+// Encrypts the plaintext with a stream, in parallel if the window is not 0.
+static string EncryptStream(CryptoClientProvider& client,
+                            const StreamingAeadParams& params,
+                            const string& plaintext,
+                            size_t parallel_window_size_in_bytes) {
+  AeadEncryptStreamRequest request;
+  request.saead_params = params;
+  request.parallel_window_size_in_bytes = parallel_window_size_in_bytes;
+  auto ciphertext_stream = make_unique<std::stringstream>();
+  auto* ciphertext_buffer = ciphertext_stream->rdbuf();
+  request.ciphertext_stream = move(ciphertext_stream);
+  auto stream_or = client.AeadEncryptStreamSync(request);
+  EXPECT_SUCCESS(stream_or.result());
+  auto& stream = **stream_or;
+  size_t position = 0;
+  while (position < plaintext.size()) {
+    void* buffer;
+    int size = *stream.Next(&buffer);
+    size_t copied = std::min<size_t>(size, plaintext.size() - position);
+    memcpy(buffer, plaintext.data() + position, copied);
+    stream.BackUp(size - copied);
+    position += copied;
+  }
+  EXPECT_TRUE(stream.Close().ok());
+  return ciphertext_buffer->str();
+}
+
+// Args: executor thread count, parallel window size in MiB (0 for Tink's
+// sequential stream). bytes_per_second is the plaintext throughput.
+static void BM_AeadEncryptStream(benchmark::State& state) {
+  auto executor = CreateExecutor(state.range(0));
+  auto client = CreateClient(128, executor);
+  auto params = CreateStreamingAeadParams();
+  auto plaintext = Random::GetRandomBytes(kStreamSize);
+  for (auto _ : state) {
+    auto ciphertext =
+        EncryptStream(*client, params, plaintext, state.range(1) << 20);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * kStreamSize);
+  if (executor) {
+    executor->Stop();
+  }
+}
+
+// Args: executor thread count, parallel window size in MiB (0 for Tink's
+// sequential stream). bytes_per_second is the plaintext throughput.
+static void BM_AeadDecryptStream(benchmark::State& state) {
+  auto executor = CreateExecutor(state.range(0));
+  auto client = CreateClient(128, executor);
+  auto params = CreateStreamingAeadParams();
+  auto ciphertext =
+      EncryptStream(*client, params, Random::GetRandomBytes(kStreamSize), 0);
+  for (auto _ : state) {
+    AeadDecryptStreamRequest request;
+    request.saead_params = params;
+    request.parallel_window_size_in_bytes = state.range(1) << 20;
+    request.ciphertext_stream = make_unique<std::stringstream>(ciphertext);
+    auto stream_or = client->AeadDecryptStreamSync(request);
+    EXPECT_SUCCESS(stream_or.result());
+    const void* buffer;
+    while ((*stream_or)->Next(&buffer).ok()) {
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * kStreamSize);
+  if (executor) {
+    executor->Stop();
+  }
+}
+}  // namespace google::scp::cpio::client_providers::test
+
+// ArgPair<Key cache size, Number of keys>. items_per_second is the number of
+// decrypts per second.
+BENCHMARK(
+    google::scp::cpio::client_providers::test::BM_HpkeDecryptBidirectional)
+    ->ArgPair(0, 32)
+    ->ArgPair(128, 32);
+
+BENCHMARK(
+    google::scp::cpio::client_providers::test::BM_HpkeDecryptOneDirection)
+    ->ArgPair(0, 32)
+    ->ArgPair(128, 32);
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_AeadDecrypt)
+    ->ArgPair(0, 32)
+    ->ArgPair(128, 32);
+
+// The benchmarks below report allocs_per_op, p50_latency_us and
+// p99_latency_us next to the throughput. For machine-readable results, run
+// with --benchmark_out=<file> --benchmark_out_format=json (or csv).
+
+// ArgsProduct<KEM, KDF, AEAD, Payload size> over all the HPKE suites the
+// provider supports.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_HpkeEncryptSuite)
+    ->ArgsProduct({google::scp::cpio::client_providers::test::kHpkeKems,
+                   google::scp::cpio::client_providers::test::kHpkeKdfs,
+                   google::scp::cpio::client_providers::test::kHpkeAeads,
+                   google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"kem", "kdf", "aead", "payload"});
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_HpkeDecryptSuite)
+    ->ArgsProduct({google::scp::cpio::client_providers::test::kHpkeKems,
+                   google::scp::cpio::client_providers::test::kHpkeKdfs,
+                   google::scp::cpio::client_providers::test::kHpkeAeads,
+                   google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"kem", "kdf", "aead", "payload"});
+
+// ArgsProduct<KEM, KDF, AEAD, Key cache size>.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_HpkeKeySetup)
+    ->ArgsProduct({google::scp::cpio::client_providers::test::kHpkeKems,
+                   google::scp::cpio::client_providers::test::kHpkeKdfs,
+                   google::scp::cpio::client_providers::test::kHpkeAeads,
+                   {0, 128}})
+    ->ArgNames({"kem", "kdf", "aead", "key_cache_size"});
+
+// ArgsProduct<Secret size, Payload size>, for AES-128-GCM and AES-256-GCM.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_AeadEncryptPayload)
+    ->ArgsProduct({{16, 32},
+                   google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"secret", "payload"});
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_AeadDecryptPayload)
+    ->ArgsProduct({{16, 32},
+                   google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"secret", "payload"});
+
+// Arg<Payload size>.
+BENCHMARK(google::scp::cpio::client_providers::test::
+              BM_HpkeDecryptRequestMarshaling)
+    ->ArgsProduct({google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"payload"});
+
+BENCHMARK(google::scp::cpio::client_providers::test::
+              BM_HpkeDecryptResponseMarshaling)
+    ->ArgsProduct({google::scp::cpio::client_providers::test::kPayloadSizes})
+    ->ArgNames({"payload"});
+
+// ArgPair<Executor thread count, Batch size>. items_per_second is the number of
+// decrypts per second.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_BatchHpkeDecrypt)
+    ->ArgPair(0, 256)
+    ->ArgPair(4, 256)
+    ->ArgPair(8, 256)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_BatchAeadDecrypt)
+    ->ArgPair(0, 1024)
+    ->ArgPair(4, 1024)
+    ->ArgPair(8, 1024)
+    ->UseRealTime();
+
+// ArgPair<Executor thread count, Parallel window size in MiB>.
+// bytes_per_second against the thread count shows how the parallel streams
+// scale with cores; window 0 is the sequential baseline.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_AeadEncryptStream)
+    ->ArgPair(0, 0)
+    ->ArgPair(0, 64)
+    ->ArgPair(2, 64)
+    ->ArgPair(4, 64)
+    ->ArgPair(8, 64)
+    ->ArgPair(16, 64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_AeadDecryptStream)
+    ->ArgPair(0, 0)
+    ->ArgPair(0, 64)
+    ->ArgPair(2, 64)
+    ->ArgPair(4, 64)
+    ->ArgPair(8, 64)
+    ->ArgPair(16, 64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <tink/binary_keyset_writer.h>
@@ -37,6 +38,7 @@
 #include <tink/util/secret_data.h>
 
 #include "absl/strings/escaping.h"
+#include "core/async_executor/src/async_executor.h"
 #include "core/interface/async_context.h"
 #include "core/test/utils/conditional_wait.h"
 #include "core/test/utils/proto_test_utils.h"
@@ -73,6 +75,8 @@ using google::cmrt::sdk::crypto_service::v1::AeadDecryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacRequest;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacResponse;
 using google::cmrt::sdk::crypto_service::v1::HashType;
@@ -94,12 +98,14 @@ using google::crypto::tink::KeyStatusType;
 using google::crypto::tink::OutputPrefixType;
 using google::protobuf::Any;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
 using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::ExecutionStatus;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::errors::SC_CORE_UTILS_INVALID_BASE64_ENCODING_LENGTH;
+using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_AEAD_DECRYPT_FAILED;
 using google::scp::core::errors::
     SC_CRYPTO_CLIENT_PROVIDER_CANNOT_CREATE_KEYSET_HANDLE;
 using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED;
@@ -110,6 +116,8 @@ using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_MISSING_KEY;
 using google::scp::core::errors::
     SC_CRYPTO_CLIENT_PROVIDER_PARSE_HPKE_PUBLIC_KEY_FAILED;
 using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_READ_KEYSET_FAILED;
+using google::scp::core::errors::
+    SC_CRYPTO_CLIENT_PROVIDER_SPLIT_CIPHERTEXT_FAILED;
 using google::scp::core::errors::
     SC_CRYPTO_CLIENT_PROVIDER_UNSUPPORTED_ENCRYPTION_ALGORITHM;
 using google::scp::core::test::EqualsProto;
@@ -127,10 +135,12 @@ using std::make_unique;
 using std::min;
 using std::move;
 using std::ostream;
+using std::pair;
 using std::shared_ptr;
 using std::string;
 using std::string_view;
 using std::stringstream;
+using std::to_string;
 using std::unique_ptr;
 using std::vector;
 
@@ -915,6 +925,242 @@ TEST_F(CryptoClientProviderTest, CannotCreateAeadDueToInvalidSecret) {
                   SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED)));
 }
 
+TEST_F(CryptoClientProviderTest, HpkeDecryptReusesCachedKey) {
+  auto encrypt_request =
+      CreateHpkeEncryptRequest(true /*is_bidirectional*/, false /*is_raw_key*/);
+  auto encrypt_response_or = client_->HpkeEncryptSync(encrypt_request);
+  AssertHpkeEncryptResponse(true, encrypt_response_or);
+
+  auto decrypt_request = CreateHpkeDecryptRequest(
+      encrypt_response_or->encrypted_data().ciphertext(),
+      true /*is_bidirectional*/, false /*is_raw_key*/,
+      encrypt_response_or->secret());
+  auto stats_before = client_->GetKeyCacheStats();
+  for (int i = 0; i < 3; ++i) {
+    AssertHpkeDecryptResponse(client_->HpkeDecryptSync(decrypt_request),
+                              encrypt_response_or->secret());
+  }
+  auto stats_after = client_->GetKeyCacheStats();
+  EXPECT_EQ(stats_after.misses - stats_before.misses, 1);
+  EXPECT_EQ(stats_after.hits - stats_before.hits, 2);
+}
+
+TEST_F(CryptoClientProviderTest, KeyCacheDistinguishesKeysWithSameId) {
+  // Both requests use kKeyId, but carry different keys.
+  auto chacha_request = CreateHpkeEncryptRequestWithTinkKey(
+      crypto::tink::HpkeKem::DHKEM_X25519_HKDF_SHA256,
+      crypto::tink::HpkeKdf::HKDF_SHA256,
+      crypto::tink::HpkeAead::CHACHA20_POLY1305, true /*is_bidirectional*/);
+  auto aes_request = CreateHpkeEncryptRequestWithTinkKey(
+      crypto::tink::HpkeKem::DHKEM_X25519_HKDF_SHA256,
+      crypto::tink::HpkeKdf::HKDF_SHA256, crypto::tink::HpkeAead::AES_256_GCM,
+      true /*is_bidirectional*/);
+  ASSERT_EQ(chacha_request.key_id(), aes_request.key_id());
+
+  auto chacha_response_or = client_->HpkeEncryptSync(chacha_request);
+  AssertHpkeEncryptResponse(true, chacha_response_or);
+  auto aes_response_or = client_->HpkeEncryptSync(aes_request);
+  AssertHpkeEncryptResponse(true, aes_response_or);
+  EXPECT_EQ(client_->GetKeyCacheStats().hits, 0);
+
+  HpkeDecryptRequest decrypt_request;
+  decrypt_request.mutable_encrypted_data()->set_key_id(kKeyId);
+  decrypt_request.set_is_bidirectional(true);
+  decrypt_request.set_shared_info(kSharedInfo);
+  decrypt_request.set_tink_key_binary(GetEncodedPrivateKey(
+      crypto::tink::HpkeKem::DHKEM_X25519_HKDF_SHA256,
+      crypto::tink::HpkeKdf::HKDF_SHA256, crypto::tink::HpkeAead::AES_256_GCM));
+  decrypt_request.mutable_encrypted_data()->set_ciphertext(
+      aes_response_or->encrypted_data().ciphertext());
+  AssertHpkeDecryptResponse(client_->HpkeDecryptSync(decrypt_request),
+                            aes_response_or->secret());
+}
+
+TEST_F(CryptoClientProviderTest, AeadFailuresAreNotCached) {
+  SecretData invalid_secret(4, 'x');
+  string secret_str(invalid_secret.begin(), invalid_secret.end());
+  auto decrypt_request = CreateAeadDecryptRequest(secret_str, kPayload);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(client_->AeadDecryptSync(decrypt_request).result(),
+                ResultIs(FailureExecutionResult(
+                    SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED)));
+  }
+  EXPECT_EQ(client_->GetKeyCacheStats().hits, 0);
+  EXPECT_EQ(client_->GetKeyCacheStats().misses, 2);
+}
+
+TEST_F(CryptoClientProviderTest, AeadSucceedsWithKeyCacheDisabled) {
+  auto options = make_shared<CryptoClientOptions>();
+  options->key_cache_size = 0;
+  auto client = make_unique<CryptoClientProvider>(options);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  for (int i = 0; i < 2; ++i) {
+    auto encrypt_response_or =
+        client->AeadEncryptSync(CreateAeadEncryptRequest(kSecret128));
+    EXPECT_SUCCESS(encrypt_response_or.result());
+    auto decrypt_response_or = client->AeadDecryptSync(CreateAeadDecryptRequest(
+        kSecret128, encrypt_response_or->encrypted_data().ciphertext()));
+    EXPECT_SUCCESS(decrypt_response_or.result());
+    EXPECT_EQ(decrypt_response_or->payload(), kPayload);
+  }
+  EXPECT_EQ(client->GetKeyCacheStats().hits, 0);
+  EXPECT_EQ(client->GetKeyCacheStats().misses, 0);
+  EXPECT_SUCCESS(client->Stop());
+}
+
+TEST_F(CryptoClientProviderTest, BatchHpkeDecryptSetsUpKeyOnce) {
+  auto async_executor = make_shared<AsyncExecutor>(4, 1000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto client = make_unique<CryptoClientProvider>(
+      make_shared<CryptoClientOptions>(), async_executor);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  constexpr int kNumCiphertexts = 100;
+  auto encrypt_request =
+      CreateHpkeEncryptRequest(true /*is_bidirectional*/, false /*is_raw_key*/);
+  BatchHpkeDecryptRequest batch_request;
+  vector<string> secrets;
+  for (int i = 0; i < kNumCiphertexts; ++i) {
+    auto encrypt_response_or = client->HpkeEncryptSync(encrypt_request);
+    AssertHpkeEncryptResponse(true, encrypt_response_or);
+    batch_request.add_ciphertexts(
+        encrypt_response_or->encrypted_data().ciphertext());
+    secrets.push_back(encrypt_response_or->secret());
+  }
+  // Corrupt one ciphertext. Only its own response fails.
+  batch_request.set_ciphertexts(7, "abcdefgh");
+
+  auto decrypt_request = CreateHpkeDecryptRequest(
+      "" /*ciphertext*/, true /*is_bidirectional*/, false /*is_raw_key*/,
+      "" /*secret*/);
+  batch_request.set_tink_key_binary(decrypt_request.tink_key_binary());
+  batch_request.set_key_id(kKeyId);
+  batch_request.set_shared_info(kSharedInfo);
+  batch_request.set_is_bidirectional(true);
+
+  auto stats_before = client->GetKeyCacheStats();
+  auto response_or = client->BatchHpkeDecryptSync(batch_request);
+  ASSERT_SUCCESS(response_or);
+  auto stats_after = client->GetKeyCacheStats();
+  EXPECT_EQ(stats_after.misses + stats_after.hits -
+                (stats_before.misses + stats_before.hits),
+            1);
+
+  // The batch result is the failure of the corrupted ciphertext.
+  EXPECT_THAT(ExecutionResult(response_or->result()),
+              ResultIs(FailureExecutionResult(
+                  SC_CRYPTO_CLIENT_PROVIDER_SPLIT_CIPHERTEXT_FAILED)));
+  ASSERT_EQ(response_or->responses_size(), kNumCiphertexts);
+  for (int i = 0; i < kNumCiphertexts; ++i) {
+    const auto& response = response_or->responses(i);
+    if (i == 7) {
+      EXPECT_THAT(ExecutionResult(response.result()),
+                  ResultIs(FailureExecutionResult(
+                      SC_CRYPTO_CLIENT_PROVIDER_SPLIT_CIPHERTEXT_FAILED)));
+      continue;
+    }
+    EXPECT_SUCCESS(ExecutionResult(response.result()));
+    EXPECT_EQ(response.payload(), kPayload);
+    EXPECT_EQ(response.secret(), secrets[i]);
+  }
+
+  EXPECT_SUCCESS(client->Stop());
+  EXPECT_SUCCESS(async_executor->Stop());
+}
+
+TEST_F(CryptoClientProviderTest, BatchHpkeDecryptForOneDirectionTinkKey) {
+  auto encrypt_request = CreateHpkeEncryptRequest(false /*is_bidirectional*/,
+                                                  false /*is_raw_key*/);
+  BatchHpkeDecryptRequest batch_request;
+  for (int i = 0; i < 3; ++i) {
+    auto encrypt_response_or = client_->HpkeEncryptSync(encrypt_request);
+    AssertHpkeEncryptResponse(false, encrypt_response_or);
+    batch_request.add_ciphertexts(
+        encrypt_response_or->encrypted_data().ciphertext());
+  }
+  auto decrypt_request = CreateHpkeDecryptRequest(
+      "" /*ciphertext*/, false /*is_bidirectional*/, false /*is_raw_key*/,
+      "" /*secret*/);
+  batch_request.set_tink_key_binary(decrypt_request.tink_key_binary());
+  batch_request.set_shared_info(kSharedInfo);
+
+  // Without an executor the batch runs on the calling thread.
+  auto response_or = client_->BatchHpkeDecryptSync(batch_request);
+  ASSERT_SUCCESS(response_or);
+  EXPECT_SUCCESS(ExecutionResult(response_or->result()));
+  ASSERT_EQ(response_or->responses_size(), 3);
+  for (const auto& response : response_or->responses()) {
+    EXPECT_SUCCESS(ExecutionResult(response.result()));
+    EXPECT_EQ(response.payload(), kPayload);
+  }
+}
+
+TEST_F(CryptoClientProviderTest, BatchHpkeDecryptFailedWithoutKey) {
+  BatchHpkeDecryptRequest batch_request;
+  batch_request.add_ciphertexts("abcdefgh");
+  EXPECT_THAT(
+      client_->BatchHpkeDecryptSync(batch_request).result(),
+      ResultIs(FailureExecutionResult(SC_CRYPTO_CLIENT_PROVIDER_MISSING_KEY)));
+}
+
+TEST_F(CryptoClientProviderTest, BatchAeadDecryptSuccess) {
+  auto async_executor = make_shared<AsyncExecutor>(4, 1000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto client = make_unique<CryptoClientProvider>(
+      make_shared<CryptoClientOptions>(), async_executor);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  constexpr int kNumCiphertexts = 1000;
+  BatchAeadDecryptRequest batch_request;
+  batch_request.set_secret(HexStringToBytes(kSecret256));
+  batch_request.set_shared_info(kSharedInfo);
+  for (int i = 0; i < kNumCiphertexts; ++i) {
+    auto encrypt_request = CreateAeadEncryptRequest(kSecret256);
+    encrypt_request.set_payload(to_string(i));
+    auto encrypt_response_or = client->AeadEncryptSync(encrypt_request);
+    EXPECT_SUCCESS(encrypt_response_or.result());
+    batch_request.add_ciphertexts(
+        encrypt_response_or->encrypted_data().ciphertext());
+  }
+  batch_request.set_ciphertexts(42, "abcdefgh");
+
+  auto response_or = client->BatchAeadDecryptSync(batch_request);
+  ASSERT_SUCCESS(response_or);
+  EXPECT_THAT(ExecutionResult(response_or->result()),
+              ResultIs(FailureExecutionResult(
+                  SC_CRYPTO_CLIENT_PROVIDER_AEAD_DECRYPT_FAILED)));
+  ASSERT_EQ(response_or->responses_size(), kNumCiphertexts);
+  for (int i = 0; i < kNumCiphertexts; ++i) {
+    const auto& response = response_or->responses(i);
+    if (i == 42) {
+      EXPECT_THAT(ExecutionResult(response.result()),
+                  ResultIs(FailureExecutionResult(
+                      SC_CRYPTO_CLIENT_PROVIDER_AEAD_DECRYPT_FAILED)));
+      continue;
+    }
+    EXPECT_SUCCESS(ExecutionResult(response.result()));
+    EXPECT_EQ(response.payload(), to_string(i));
+  }
+
+  EXPECT_SUCCESS(client->Stop());
+  EXPECT_SUCCESS(async_executor->Stop());
+}
+
+TEST_F(CryptoClientProviderTest, BatchAeadDecryptFailedWithInvalidSecret) {
+  BatchAeadDecryptRequest batch_request;
+  batch_request.set_secret("xxxx");
+  batch_request.add_ciphertexts("abcdefgh");
+  EXPECT_THAT(client_->BatchAeadDecryptSync(batch_request).result(),
+              ResultIs(FailureExecutionResult(
+                  SC_CRYPTO_CLIENT_PROVIDER_CREATE_AEAD_FAILED)));
+}
+
 TEST_F(CryptoClientProviderTest, ComputeMacFailedDueToMissingKey) {
   ComputeMacRequest request;
   string data = "some sensitive data";
@@ -1204,4 +1450,135 @@ TEST_F(CryptoClientProviderTest,
   EXPECT_TRUE(status.ok());
   EXPECT_EQ(plaintext, decrypted);
 }
+
+/// Encrypts the plaintext with a stream, in parallel if the window is not 0.
+string EncryptWithStream(CryptoClientProvider& client,
+                         const StreamingAeadParams& params,
+                         const string& plaintext,
+                         size_t parallel_window_size_in_bytes) {
+  AeadEncryptStreamRequest encrypt_request;
+  encrypt_request.saead_params = params;
+  encrypt_request.parallel_window_size_in_bytes =
+      parallel_window_size_in_bytes;
+  encrypt_request.ciphertext_stream = make_unique<stringstream>();
+  auto enc_stream_result = client.AeadEncryptStreamSync(encrypt_request);
+  EXPECT_SUCCESS(enc_stream_result);
+  EXPECT_TRUE(
+      WriteToStream(enc_stream_result.value().get(), plaintext, true).ok());
+  stringstream ss;
+  ss << encrypt_request.ciphertext_stream->rdbuf();
+  return ss.str();
+}
+
+/// Decrypts the ciphertext with a stream, in parallel if the window is not 0.
+Status DecryptWithStream(CryptoClientProvider& client,
+                         const StreamingAeadParams& params,
+                         const string& ciphertext,
+                         size_t parallel_window_size_in_bytes,
+                         string& plaintext) {
+  AeadDecryptStreamRequest decrypt_request;
+  decrypt_request.saead_params = params;
+  decrypt_request.parallel_window_size_in_bytes =
+      parallel_window_size_in_bytes;
+  decrypt_request.ciphertext_stream = make_unique<stringstream>(ciphertext);
+  auto dec_stream_result = client.AeadDecryptStreamSync(decrypt_request);
+  EXPECT_SUCCESS(dec_stream_result);
+  return ReadFromStream(dec_stream_result.value().get(), &plaintext);
+}
+
+TEST_F(CryptoClientProviderTest, ParallelAeadStreamInteroperatesWithTink) {
+  auto async_executor = make_shared<AsyncExecutor>(4, 1000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto client = make_unique<CryptoClientProvider>(
+      make_shared<CryptoClientOptions>(), async_executor);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  // The segments are 1024 bytes, so a window of 64 KiB has 8 chunks of 8
+  // segments in flight. The sizes cover an empty stream, the end of the first
+  // segment, which shares its space with the header, and many chunks.
+  constexpr size_t kWindowSize = 64 * 1024;
+  for (bool is_binary : {false, true}) {
+    auto params = ValidAesGcmHkdfParams(is_binary);
+    for (size_t size : {0, 1, 983, 984, 985, 2000, 300000}) {
+      string plaintext = Random::GetRandomBytes(size);
+      // Parallel to sequential, sequential to parallel, and parallel to
+      // parallel.
+      for (auto [encrypt_window, decrypt_window] :
+           vector<pair<size_t, size_t>>{{kWindowSize, 0},
+                                        {0, kWindowSize},
+                                        {kWindowSize, kWindowSize}}) {
+        auto ciphertext =
+            EncryptWithStream(*client, params, plaintext, encrypt_window);
+        string decrypted;
+        EXPECT_TRUE(DecryptWithStream(*client, params, ciphertext,
+                                      decrypt_window, decrypted)
+                        .ok());
+        EXPECT_EQ(plaintext, decrypted);
+      }
+    }
+  }
+
+  EXPECT_SUCCESS(client->Stop());
+  EXPECT_SUCCESS(async_executor->Stop());
+}
+
+TEST_F(CryptoClientProviderTest, ParallelAeadStreamWorksWithoutExecutor) {
+  auto params = ValidAesGcmHkdfParams(false);
+  string plaintext = Random::GetRandomBytes(100000);
+  auto ciphertext = EncryptWithStream(*client_, params, plaintext, 4096);
+  string decrypted;
+  EXPECT_TRUE(
+      DecryptWithStream(*client_, params, ciphertext, 4096, decrypted).ok());
+  EXPECT_EQ(plaintext, decrypted);
+}
+
+TEST_F(CryptoClientProviderTest, ParallelAeadStreamReusesCachedKey) {
+  auto params = ValidAesGcmHkdfParams(false);
+  string plaintext = Random::GetRandomBytes(1000);
+  auto stats_before = client_->GetKeyCacheStats();
+  for (int i = 0; i < 3; ++i) {
+    EncryptWithStream(*client_, params, plaintext, 4096);
+  }
+  auto stats_after = client_->GetKeyCacheStats();
+  EXPECT_EQ(stats_after.misses - stats_before.misses, 1);
+  EXPECT_EQ(stats_after.hits - stats_before.hits, 2);
+}
+
+TEST_F(CryptoClientProviderTest, ParallelAeadStreamRejectsModifiedCiphertext) {
+  auto async_executor = make_shared<AsyncExecutor>(4, 1000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto client = make_unique<CryptoClientProvider>(
+      make_shared<CryptoClientOptions>(), async_executor);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  constexpr size_t kWindowSize = 64 * 1024;
+  auto params = ValidAesGcmHkdfParams(false);
+  string plaintext = Random::GetRandomBytes(100000);
+  auto ciphertext = EncryptWithStream(*client, params, plaintext, kWindowSize);
+  string decrypted;
+
+  auto modified_ciphertext = ciphertext;
+  modified_ciphertext[ciphertext.size() / 2] ^= 1;
+  EXPECT_FALSE(DecryptWithStream(*client, params, modified_ciphertext,
+                                 kWindowSize, decrypted)
+                   .ok());
+  // Dropping the last segment is detected, as the segment before it is not
+  // marked as the last one.
+  EXPECT_FALSE(DecryptWithStream(*client, params,
+                                 ciphertext.substr(0, 1024 * 10), kWindowSize,
+                                 decrypted)
+                   .ok());
+  auto other_params = params;
+  other_params.set_shared_info("other shared info");
+  EXPECT_FALSE(DecryptWithStream(*client, other_params, ciphertext,
+                                 kWindowSize, decrypted)
+                   .ok());
+
+  EXPECT_SUCCESS(client->Stop());
+  EXPECT_SUCCESS(async_executor->Stop());
+}
 }  // namespace google::scp::cpio::client_providers::test
@@ -212,6 +212,17 @@ void AwsInstanceClientProvider::GetCurrentInstanceResourceName(
     AsyncContext<GetCurrentInstanceResourceNameRequest,
                  GetCurrentInstanceResourceNameResponse>&
         get_resource_name_context) noexcept {
+  get_resource_name_single_flight_.Execute(
+      get_resource_name_context.request->SerializeAsString(),
+      get_resource_name_context,
+      bind(&AwsInstanceClientProvider::FetchCurrentInstanceResourceName, this,
+           _1));
+}
+
+void AwsInstanceClientProvider::FetchCurrentInstanceResourceName(
+    AsyncContext<GetCurrentInstanceResourceNameRequest,
+                 GetCurrentInstanceResourceNameResponse>&
+        get_resource_name_context) noexcept {
   AsyncContext<GetSessionTokenRequest, GetSessionTokenResponse>
       get_token_context(
           make_shared<GetSessionTokenRequest>(),
@@ -351,6 +362,17 @@ void AwsInstanceClientProvider::GetInstanceDetailsByResourceName(
     AsyncContext<GetInstanceDetailsByResourceNameRequest,
                  GetInstanceDetailsByResourceNameResponse>&
         get_details_context) noexcept {
+  get_instance_details_single_flight_.Execute(
+      get_details_context.request->instance_resource_name(),
+      get_details_context,
+      bind(&AwsInstanceClientProvider::FetchInstanceDetailsByResourceName, this,
+           _1));
+}
+
+void AwsInstanceClientProvider::FetchInstanceDetailsByResourceName(
+    AsyncContext<GetInstanceDetailsByResourceNameRequest,
+                 GetInstanceDetailsByResourceNameResponse>&
+        get_details_context) noexcept {
   AwsResourceNameDetails details;
   auto execution_result = AwsInstanceClientUtils::GetResourceNameDetails(
       get_details_context.request->instance_resource_name(), details);
@@ -448,6 +470,14 @@ void AwsInstanceClientProvider::OnDescribeInstancesAsyncCallback(
 void AwsInstanceClientProvider::GetTagsByResourceName(
     AsyncContext<GetTagsByResourceNameRequest, GetTagsByResourceNameResponse>&
         get_tags_context) noexcept {
+  get_tags_single_flight_.Execute(
+      get_tags_context.request->resource_name(), get_tags_context,
+      bind(&AwsInstanceClientProvider::FetchTagsByResourceName, this, _1));
+}
+
+void AwsInstanceClientProvider::FetchTagsByResourceName(
+    AsyncContext<GetTagsByResourceNameRequest, GetTagsByResourceNameResponse>&
+        get_tags_context) noexcept {
   AwsResourceNameDetails details;
   auto execution_result = AwsInstanceClientUtils::GetResourceNameDetails(
       get_tags_context.request->resource_name(), details);
@@ -25,6 +25,7 @@
 #include <aws/ec2/EC2Client.h>
 
 #include "cc/core/common/concurrent_map/src/concurrent_map.h"
+#include "core/common/single_flight/src/single_flight.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
 #include "public/core/interface/execution_result.h"
 
@@ -87,6 +88,44 @@ class AwsInstanceClientProvider : public InstanceClientProviderInterface {
           instance_details) noexcept override;
 
  private:
+  /**
+   * @brief Fetches the resource name of the current instance. Concurrent
+   * calls of GetCurrentInstanceResourceName() share one fetch.
+   *
+   * @param get_resource_name_context the context of the fetch.
+   */
+  void FetchCurrentInstanceResourceName(
+      core::AsyncContext<cmrt::sdk::instance_service::v1::
+                             GetCurrentInstanceResourceNameRequest,
+                         cmrt::sdk::instance_service::v1::
+                             GetCurrentInstanceResourceNameResponse>&
+          get_resource_name_context) noexcept;
+
+  /**
+   * @brief Fetches the tags of a resource. Concurrent calls of
+   * GetTagsByResourceName() for the same resource share one fetch.
+   *
+   * @param get_tags_context the context of the fetch.
+   */
+  void FetchTagsByResourceName(
+      core::AsyncContext<
+          cmrt::sdk::instance_service::v1::GetTagsByResourceNameRequest,
+          cmrt::sdk::instance_service::v1::GetTagsByResourceNameResponse>&
+          get_tags_context) noexcept;
+
+  /**
+   * @brief Fetches the details of an instance. Concurrent calls of
+   * GetInstanceDetailsByResourceName() for the same instance share one fetch.
+   *
+   * @param get_instance_details_context the context of the fetch.
+   */
+  void FetchInstanceDetailsByResourceName(
+      core::AsyncContext<cmrt::sdk::instance_service::v1::
+                             GetInstanceDetailsByResourceNameRequest,
+                         cmrt::sdk::instance_service::v1::
+                             GetInstanceDetailsByResourceNameResponse>&
+          get_instance_details_context) noexcept;
+
   /**
    * @brief Is called after auth_token_provider GetSessionToken() for session
    * token is completed
@@ -182,6 +221,20 @@ class AwsInstanceClientProvider : public InstanceClientProviderInterface {
 
   /// An instance of the factory for Aws::EC2::EC2Client.
   std::shared_ptr<AwsEC2ClientFactory> ec2_factory_;
+
+  /// Collapses concurrent identical requests into one fetch.
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetCurrentInstanceResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetCurrentInstanceResourceNameResponse>
+      get_resource_name_single_flight_;
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetTagsByResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetTagsByResourceNameResponse>
+      get_tags_single_flight_;
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetInstanceDetailsByResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetInstanceDetailsByResourceNameResponse>
+      get_instance_details_single_flight_;
 };
 
 /// Creates Aws::EC2::EC2Client
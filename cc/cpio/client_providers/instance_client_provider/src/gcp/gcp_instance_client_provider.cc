@@ -214,6 +214,17 @@ void GcpInstanceClientProvider::GetCurrentInstanceResourceName(
     AsyncContext<GetCurrentInstanceResourceNameRequest,
                  GetCurrentInstanceResourceNameResponse>&
         get_resource_name_context) noexcept {
+  get_resource_name_single_flight_.Execute(
+      get_resource_name_context.request->SerializeAsString(),
+      get_resource_name_context,
+      bind(&GcpInstanceClientProvider::FetchCurrentInstanceResourceName, this,
+           _1));
+}
+
+void GcpInstanceClientProvider::FetchCurrentInstanceResourceName(
+    AsyncContext<GetCurrentInstanceResourceNameRequest,
+                 GetCurrentInstanceResourceNameResponse>&
+        get_resource_name_context) noexcept {
   auto instance_resource_name_tracker =
       make_shared<InstanceResourceNameTracker>();
 
@@ -373,6 +384,14 @@ void GcpInstanceClientProvider::OnGetInstanceResourceName(
 void GcpInstanceClientProvider::GetTagsByResourceName(
     AsyncContext<GetTagsByResourceNameRequest, GetTagsByResourceNameResponse>&
         get_tags_context) noexcept {
+  get_tags_single_flight_.Execute(
+      get_tags_context.request->resource_name(), get_tags_context,
+      bind(&GcpInstanceClientProvider::FetchTagsByResourceName, this, _1));
+}
+
+void GcpInstanceClientProvider::FetchTagsByResourceName(
+    AsyncContext<GetTagsByResourceNameRequest, GetTagsByResourceNameResponse>&
+        get_tags_context) noexcept {
   AsyncContext<GetSessionTokenRequest, GetSessionTokenResponse>
       get_token_context(
           make_shared<GetSessionTokenRequest>(),
@@ -548,6 +567,17 @@ void GcpInstanceClientProvider::GetInstanceDetailsByResourceName(
     AsyncContext<GetInstanceDetailsByResourceNameRequest,
                  GetInstanceDetailsByResourceNameResponse>&
         get_instance_details_context) noexcept {
+  get_instance_details_single_flight_.Execute(
+      get_instance_details_context.request->instance_resource_name(),
+      get_instance_details_context,
+      bind(&GcpInstanceClientProvider::FetchInstanceDetailsByResourceName, this,
+           _1));
+}
+
+void GcpInstanceClientProvider::FetchInstanceDetailsByResourceName(
+    AsyncContext<GetInstanceDetailsByResourceNameRequest,
+                 GetInstanceDetailsByResourceNameResponse>&
+        get_instance_details_context) noexcept {
   auto execution_result =
       GcpInstanceClientUtils::ValidateInstanceResourceNameFormat(
           get_instance_details_context.request->instance_resource_name());
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "core/common/single_flight/src/single_flight.h"
 #include "core/interface/http_client_interface.h"
 #include "cpio/client_providers/interface/auth_token_provider_interface.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
@@ -68,6 +69,44 @@ class GcpInstanceClientProvider : public InstanceClientProviderInterface {
           instance_details) noexcept override;
 
  private:
+  /**
+   * @brief Fetches the resource name of the current instance. Concurrent
+   * calls of GetCurrentInstanceResourceName() share one fetch.
+   *
+   * @param get_resource_name_context the context of the fetch.
+   */
+  void FetchCurrentInstanceResourceName(
+      core::AsyncContext<cmrt::sdk::instance_service::v1::
+                             GetCurrentInstanceResourceNameRequest,
+                         cmrt::sdk::instance_service::v1::
+                             GetCurrentInstanceResourceNameResponse>&
+          get_resource_name_context) noexcept;
+
+  /**
+   * @brief Fetches the tags of a resource. Concurrent calls of
+   * GetTagsByResourceName() for the same resource share one fetch.
+   *
+   * @param get_tags_context the context of the fetch.
+   */
+  void FetchTagsByResourceName(
+      core::AsyncContext<
+          cmrt::sdk::instance_service::v1::GetTagsByResourceNameRequest,
+          cmrt::sdk::instance_service::v1::GetTagsByResourceNameResponse>&
+          get_tags_context) noexcept;
+
+  /**
+   * @brief Fetches the details of an instance. Concurrent calls of
+   * GetInstanceDetailsByResourceName() for the same instance share one fetch.
+   *
+   * @param get_instance_details_context the context of the fetch.
+   */
+  void FetchInstanceDetailsByResourceName(
+      core::AsyncContext<cmrt::sdk::instance_service::v1::
+                             GetInstanceDetailsByResourceNameRequest,
+                         cmrt::sdk::instance_service::v1::
+                             GetInstanceDetailsByResourceNameResponse>&
+          get_instance_details_context) noexcept;
+
   // The tracker for instance resource id fetching status.
   struct InstanceResourceNameTracker {
     // Project ID fetching response.
@@ -207,5 +246,19 @@ class GcpInstanceClientProvider : public InstanceClientProviderInterface {
   std::shared_ptr<std::string> http_uri_instance_id_;
   std::shared_ptr<std::string> http_uri_project_id_;
   std::shared_ptr<std::string> http_uri_instance_zone_;
+
+  /// Collapses concurrent identical requests into one fetch.
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetCurrentInstanceResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetCurrentInstanceResourceNameResponse>
+      get_resource_name_single_flight_;
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetTagsByResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetTagsByResourceNameResponse>
+      get_tags_single_flight_;
+  core::common::SingleFlight<
+      cmrt::sdk::instance_service::v1::GetInstanceDetailsByResourceNameRequest,
+      cmrt::sdk::instance_service::v1::GetInstanceDetailsByResourceNameResponse>
+      get_instance_details_single_flight_;
 };
 }  // namespace google::scp::cpio::client_providers
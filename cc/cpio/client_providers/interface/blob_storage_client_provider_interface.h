@@ -70,6 +70,18 @@ class BlobStorageClientProviderInterface : public core::ServiceInterface {
           cmrt::sdk::blob_storage_service::v1::ListBlobsMetadataResponse>&
           list_blobs_context) noexcept = 0;
 
+  /**
+   * @brief Used to list metadata of all the blobs with a prefix as a stream.
+   *
+   * @param list_all_blobs_context The list all blobs context object which
+   * returns the metadata a page at a time.
+   */
+  virtual void ListAllBlobsMetadata(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataRequest,
+          cmrt::sdk::blob_storage_service::v1::ListAllBlobsMetadataResponse>&
+          list_all_blobs_context) noexcept = 0;
+
   /**
    * @brief Used to create a blob using blob identifiers.
    *
@@ -102,6 +114,19 @@ class BlobStorageClientProviderInterface : public core::ServiceInterface {
           cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest,
           cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse>&
           delete_blob_context) noexcept = 0;
+
+  /**
+   * @brief Used to delete many blobs, in batches.
+   *
+   * @param delete_blobs_context The delete blobs context object which returns
+   * the result of each blob.
+   */
+  virtual void DeleteBlobs(
+      core::AsyncContext<
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+          cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+          delete_blobs_context) noexcept = 0;
+
   /**
    * @brief Gets a Blob from storage in a blocking call using streaming manner.
    *
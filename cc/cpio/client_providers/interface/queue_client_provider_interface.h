@@ -44,6 +44,15 @@ class QueueClientProviderInterface : public core::ServiceInterface {
       core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessageRequest,
                          cmrt::sdk::queue_service::v1::EnqueueMessageResponse>&
           enqueue_message_context) noexcept = 0;
+  /**
+   * @brief Enqueue messages to the queue with as few calls as possible.
+   * @param enqueue_messages_context context of the operation.
+   * @return ExecutionResult result of the operation.
+   */
+  virtual void EnqueueMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept = 0;
   /**
    * @brief Get top message from the queue.
    * @param get_top_message_context context of the operation.
@@ -53,6 +62,15 @@ class QueueClientProviderInterface : public core::ServiceInterface {
       core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept = 0;
+  /**
+   * @brief Get up to max_messages top messages from the queue.
+   * @param get_top_messages_context context of the operation.
+   * @return ExecutionResult result of the operation.
+   */
+  virtual void GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept = 0;
   /**
    * @brief Update visibility timeout of a message from the queue.
    * @param update_message_visibility_timeout_context context of the operation.
@@ -72,6 +90,15 @@ class QueueClientProviderInterface : public core::ServiceInterface {
       core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessageRequest,
                          cmrt::sdk::queue_service::v1::DeleteMessageResponse>&
           delete_message_context) noexcept = 0;
+  /**
+   * @brief Delete messages from the queue with as few calls as possible.
+   * @param delete_messages_context context of the operation.
+   * @return ExecutionResult result of the operation.
+   */
+  virtual void DeleteMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept = 0;
 };
 
 class QueueClientProviderFactory {
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Stand-in for the kmstool decrypt helper used by KmstoolDecryptChannel in
+// tests. "Decrypts" by echoing the ciphertext back as the base64 plaintext,
+// and fails requests whose ciphertext is "fail". The responses to the
+// requests read in one go are written in reverse order, to exercise
+// out-of-order matching.
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+static constexpr char kFailingCiphertext[] = "fail";
+static constexpr size_t kNumFields = 6;
+
+static std::string HandleRequest(const std::string& line) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true) {
+    auto end = line.find('\t', start);
+    fields.push_back(line.substr(start, end - start));
+    if (end == std::string::npos) {
+      break;
+    }
+    start = end + 1;
+  }
+  if (fields.size() != kNumFields) {
+    return fields[0] + "\tERR\tmalformed request\n";
+  }
+  const auto& ciphertext = fields.back();
+  if (ciphertext == kFailingCiphertext) {
+    return fields[0] + "\tERR\tdecryption failed\n";
+  }
+  return fields[0] + "\tOK\t" + ciphertext + "\n";
+}
+
+static bool WriteAll(const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    auto n = write(STDOUT_FILENO, data.data() + written, data.size() - written);
+    if (n <= 0) {
+      return false;
+    }
+    written += n;
+  }
+  return true;
+}
+
+int main() {
+  std::string buffer;
+  char chunk[4096];
+  while (true) {
+    auto n = read(STDIN_FILENO, chunk, sizeof(chunk));
+    if (n <= 0) {
+      return 0;
+    }
+    buffer.append(chunk, n);
+
+    std::vector<std::string> responses;
+    size_t start = 0;
+    size_t end;
+    while ((end = buffer.find('\n', start)) != std::string::npos) {
+      responses.push_back(HandleRequest(buffer.substr(start, end - start)));
+      start = end + 1;
+    }
+    buffer.erase(0, start);
+
+    std::string output;
+    for (auto it = responses.rbegin(); it != responses.rend(); ++it) {
+      output += *it;
+    }
+    if (!WriteAll(output)) {
+      return 1;
+    }
+  }
+}
@@ -28,8 +28,11 @@ class MockTeeAwsKmsClientProviderWithOverrides
  public:
   MockTeeAwsKmsClientProviderWithOverrides(
       const std::shared_ptr<RoleCredentialsProviderInterface>&
-          credential_provider)
-      : TeeAwsKmsClientProvider(credential_provider) {}
+          credential_provider,
+      const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
+      const std::shared_ptr<KmstoolDecryptChannel>& decrypt_channel = nullptr)
+      : TeeAwsKmsClientProvider(credential_provider, cpu_async_executor,
+                                decrypt_channel) {}
 
   core::ExecutionResult DecryptUsingEnclavesKmstoolCli(
       const std::string& command, std::string& plaintext) noexcept override {
@@ -0,0 +1,394 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kmstool_decrypt_channel.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "tee_error_codes.h"
+
+extern char** environ;
+
+using google::cmrt::sdk::kms_service::v1::DecryptRequest;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED;
+using std::atomic;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::mutex;
+using std::promise;
+using std::shared_future;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::thread;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+/// Filename for logging errors
+static constexpr char kKmstoolDecryptChannel[] = "KmstoolDecryptChannel";
+
+static constexpr size_t kReadBufferSize = 64 * 1024;
+static constexpr char kFieldSeparator = '\t';
+static constexpr char kLineSeparator = '\n';
+static constexpr char kStatusOk[] = "OK";
+/// How long Stop() lets the helper drain its requests before killing it.
+static constexpr milliseconds kStopGracePeriod = milliseconds(1000);
+
+namespace {
+bool IsValidField(string_view field) {
+  return field.find_first_of("\t\n") == string_view::npos;
+}
+
+string_view StringOrEmpty(const shared_ptr<string>& value) {
+  return value ? string_view(*value) : string_view();
+}
+
+/// Writes all of data to fd. Returns false if the helper is gone.
+bool SendAll(int fd, string_view data) {
+  while (!data.empty()) {
+    // MSG_NOSIGNAL so that a dead helper fails the write instead of raising
+    // SIGPIPE.
+    auto sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(sent);
+  }
+  return true;
+}
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+
+struct KmstoolDecryptChannel::Connection {
+  Connection(pid_t pid, int fd) : pid(pid), fd(fd) {}
+
+  ~Connection() { close(fd); }
+
+  const pid_t pid;
+  const int fd;
+
+  /// False once the helper is gone or the channel stopped.
+  atomic<bool> open{true};
+  /// Guards next_id and pending.
+  mutex pending_mutex;
+  uint64_t next_id = 0;
+  absl::flat_hash_map<uint64_t, DecryptCallback> pending;
+  /// Serializes writes, so that concurrent requests do not interleave.
+  mutex write_mutex;
+
+  thread::id reader_id;
+  promise<void> reader_done;
+  shared_future<void> reader_done_future = reader_done.get_future().share();
+};
+
+KmstoolDecryptChannel::KmstoolDecryptChannel(const string& helper_path,
+                                             const vector<string>& helper_args,
+                                             milliseconds restart_backoff)
+    : helper_path_(helper_path),
+      helper_args_(helper_args),
+      restart_backoff_(restart_backoff) {}
+
+KmstoolDecryptChannel::~KmstoolDecryptChannel() {
+  Stop();
+}
+
+ExecutionResult KmstoolDecryptChannel::Start() noexcept {
+  lock_guard lock(mutex_);
+  if (connection_ && connection_->open.load()) {
+    return SuccessExecutionResult();
+  }
+  connection_.reset();
+
+  auto now = steady_clock::now();
+  if (start_attempted_ && now - last_start_attempt_ < restart_backoff_) {
+    return FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED);
+  }
+  start_attempted_ = true;
+  last_start_attempt_ = now;
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED);
+    SCP_ERROR(kKmstoolDecryptChannel, kZeroUuid, execution_result,
+              "Failed to create the socket pair. Error code: %d", errno);
+    return execution_result;
+  }
+
+  // The helper talks over its stdin and stdout. dup2 clears close-on-exec on
+  // the duplicated descriptors, so only these two survive the exec.
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDOUT_FILENO);
+
+  vector<char*> argv;
+  argv.push_back(const_cast<char*>(helper_path_.c_str()));
+  for (const auto& arg : helper_args_) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  auto spawn_error = posix_spawn(&pid, helper_path_.c_str(), &file_actions,
+                                 nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&file_actions);
+  close(fds[1]);
+  if (spawn_error != 0) {
+    close(fds[0]);
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED);
+    SCP_ERROR(kKmstoolDecryptChannel, kZeroUuid, execution_result,
+              "Failed to spawn the decrypt helper %s. Error code: %d",
+              helper_path_.c_str(), spawn_error);
+    return execution_result;
+  }
+
+  auto connection = make_shared<Connection>(pid, fds[0]);
+  thread reader(&KmstoolDecryptChannel::ReadResponses, connection);
+  connection->reader_id = reader.get_id();
+  reader.detach();
+  connection_ = move(connection);
+  return SuccessExecutionResult();
+}
+
+void KmstoolDecryptChannel::Stop() noexcept {
+  shared_ptr<Connection> connection;
+  {
+    lock_guard lock(mutex_);
+    connection = move(connection_);
+  }
+  if (!connection) {
+    return;
+  }
+  if (std::this_thread::get_id() == connection->reader_id) {
+    // The reader cannot wait for itself, so the helper gets no grace period.
+    shutdown(connection->fd, SHUT_RDWR);
+    return;
+  }
+  // Closes the helper's stdin, so that it answers the requests it has read
+  // and exits, which the reader sees as EOF.
+  shutdown(connection->fd, SHUT_WR);
+  if (connection->reader_done_future.wait_for(kStopGracePeriod) ==
+      std::future_status::ready) {
+    return;
+  }
+  // Wakes up the reader, which fails the in-flight requests and kills the
+  // helper.
+  shutdown(connection->fd, SHUT_RDWR);
+  connection->reader_done_future.wait();
+}
+
+bool KmstoolDecryptChannel::IsRunning() noexcept {
+  lock_guard lock(mutex_);
+  return connection_ && connection_->open.load();
+}
+
+void KmstoolDecryptChannel::Decrypt(
+    const DecryptRequest& request,
+    const GetRoleCredentialsResponse& credentials,
+    DecryptCallback callback) noexcept {
+  string_view fields[] = {request.kms_region(),
+                          StringOrEmpty(credentials.access_key_id),
+                          StringOrEmpty(credentials.access_key_secret),
+                          StringOrEmpty(credentials.security_token),
+                          request.ciphertext()};
+  for (const auto& field : fields) {
+    if (!IsValidField(field)) {
+      callback(FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST));
+      return;
+    }
+  }
+
+  shared_ptr<Connection> connection;
+  {
+    lock_guard lock(mutex_);
+    connection = connection_;
+  }
+  uint64_t id = 0;
+  bool open = false;
+  if (connection) {
+    // Checked under the pending lock, so that a callback added here is always
+    // failed by the reader if the helper exits.
+    lock_guard lock(connection->pending_mutex);
+    open = connection->open.load();
+    if (open) {
+      id = connection->next_id++;
+      connection->pending.emplace(id, move(callback));
+    }
+  }
+  if (!open) {
+    callback(FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE));
+    return;
+  }
+
+  string line = std::to_string(id);
+  for (const auto& field : fields) {
+    line += kFieldSeparator;
+    line.append(field.data(), field.size());
+  }
+  line += kLineSeparator;
+
+  bool sent;
+  {
+    lock_guard lock(connection->write_mutex);
+    sent = SendAll(connection->fd, line);
+  }
+  if (sent) {
+    return;
+  }
+
+  // The helper is gone. If the reader already failed the request, the
+  // callback was invoked there.
+  DecryptCallback failed_callback;
+  {
+    lock_guard lock(connection->pending_mutex);
+    auto it = connection->pending.find(id);
+    if (it != connection->pending.end()) {
+      failed_callback = move(it->second);
+      connection->pending.erase(it);
+    }
+  }
+  shutdown(connection->fd, SHUT_RDWR);
+  if (failed_callback) {
+    failed_callback(FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE));
+  }
+}
+
+void KmstoolDecryptChannel::ReadResponses(
+    shared_ptr<Connection> connection) noexcept {
+  string buffer;
+  vector<char> chunk(kReadBufferSize);
+  while (true) {
+    auto bytes_read = read(connection->fd, chunk.data(), chunk.size());
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_read <= 0) {
+      break;
+    }
+    buffer.append(chunk.data(), bytes_read);
+
+    size_t line_start = 0;
+    size_t line_end;
+    while ((line_end = buffer.find(kLineSeparator, line_start)) !=
+           string::npos) {
+      string_view line(buffer.data() + line_start, line_end - line_start);
+      line_start = line_end + 1;
+
+      auto id_end = line.find(kFieldSeparator);
+      auto status_end = id_end == string_view::npos
+                            ? string_view::npos
+                            : line.find(kFieldSeparator, id_end + 1);
+      if (status_end == string_view::npos) {
+        SCP_ERROR(kKmstoolDecryptChannel, kZeroUuid,
+                  FailureExecutionResult(
+                      SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED),
+                  "Malformed response from the decrypt helper.");
+        continue;
+      }
+      auto id = strtoull(string(line.substr(0, id_end)).c_str(), nullptr, 10);
+      auto status = line.substr(id_end + 1, status_end - id_end - 1);
+      auto payload = line.substr(status_end + 1);
+
+      DecryptCallback callback;
+      {
+        lock_guard lock(connection->pending_mutex);
+        auto it = connection->pending.find(id);
+        if (it == connection->pending.end()) {
+          continue;
+        }
+        callback = move(it->second);
+        connection->pending.erase(it);
+      }
+      if (status == kStatusOk) {
+        callback(string(payload));
+      } else {
+        auto execution_result = FailureExecutionResult(
+            SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED);
+        SCP_ERROR(kKmstoolDecryptChannel, kZeroUuid, execution_result,
+                  "Decrypt helper failed the request: %s",
+                  string(payload).c_str());
+        callback(execution_result);
+      }
+    }
+    buffer.erase(0, line_start);
+  }
+
+  absl::flat_hash_map<uint64_t, DecryptCallback> pending;
+  {
+    lock_guard lock(connection->pending_mutex);
+    connection->open = false;
+    pending.swap(connection->pending);
+  }
+  shutdown(connection->fd, SHUT_RDWR);
+  // The helper exited, or did not exit in time after Stop(). Killing an
+  // exited helper is a no-op.
+  kill(connection->pid, SIGKILL);
+  waitpid(connection->pid, nullptr, 0);
+  if (!pending.empty()) {
+    SCP_ERROR(kKmstoolDecryptChannel, kZeroUuid,
+              FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE),
+              "Decrypt helper exited with %zu requests in flight.",
+              pending.size());
+  }
+  for (auto& [id, callback] : pending) {
+    callback(FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE));
+  }
+  connection->reader_done.set_value();
+}
+}  // namespace google::scp::cpio::client_providers
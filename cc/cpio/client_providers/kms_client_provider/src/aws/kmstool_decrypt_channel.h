@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpio/client_providers/interface/role_credentials_provider_interface.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/kms_service/v1/kms_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Sends decrypt requests to one long-lived kmstool helper process
+ * instead of spawning kmstool_enclave_cli for every request.
+ *
+ * The helper reads requests from stdin and writes responses to stdout, one
+ * line each, with tab separated fields:
+ *   request:  <id> <region> <access_key_id> <secret> <token> <ciphertext>
+ *   response: <id> OK <base64 plaintext>
+ *         or: <id> ERR <message>
+ * Requests are pipelined: many can be in flight at once, and the helper may
+ * answer them in any order. Responses are matched to requests by id.
+ *
+ * If the helper exits, all in-flight requests fail and the next Start()
+ * spawns a new one.
+ */
+class KmstoolDecryptChannel {
+ public:
+  /// Invoked with the base64 encoded plaintext or the failure.
+  using DecryptCallback =
+      std::function<void(core::ExecutionResultOr<std::string>)>;
+
+  /**
+   * @brief Construct a new channel.
+   *
+   * @param helper_path the path of the helper binary.
+   * @param helper_args the arguments passed to the helper.
+   * @param restart_backoff the min time between two attempts to start the
+   * helper, so that a helper that keeps failing is not respawned for every
+   * request.
+   */
+  explicit KmstoolDecryptChannel(
+      const std::string& helper_path,
+      const std::vector<std::string>& helper_args = {},
+      std::chrono::milliseconds restart_backoff = std::chrono::seconds(1));
+
+  ~KmstoolDecryptChannel();
+
+  /**
+   * @brief Spawns the helper unless it is already running.
+   *
+   * @return core::ExecutionResult the start result.
+   */
+  core::ExecutionResult Start() noexcept;
+
+  /**
+   * @brief Closes the helper's stdin and waits for it to answer the
+   * requests in flight and exit. A helper that has not exited after a grace
+   * period is killed, and the requests still in flight fail. Called on the
+   * reader thread, e.g. from a callback, the helper is killed right away.
+   */
+  void Stop() noexcept;
+
+  /// Whether the helper is running.
+  bool IsRunning() noexcept;
+
+  /**
+   * @brief Sends one decrypt request to the helper. The callback is invoked
+   * on the channel's reader thread once the response arrives, or inline if
+   * the request could not be sent. The reader serves all the requests, so
+   * the callback must not block.
+   *
+   * @param request the decrypt request. Uses its kms_region and ciphertext.
+   * @param credentials the credentials to decrypt with.
+   * @param callback invoked exactly once with the result.
+   */
+  void Decrypt(const cmrt::sdk::kms_service::v1::DecryptRequest& request,
+               const GetRoleCredentialsResponse& credentials,
+               DecryptCallback callback) noexcept;
+
+ private:
+  struct Connection;
+
+  /// Reads and dispatches the responses of the connection until EOF.
+  static void ReadResponses(std::shared_ptr<Connection> connection) noexcept;
+
+  const std::string helper_path_;
+  const std::vector<std::string> helper_args_;
+  const std::chrono::milliseconds restart_backoff_;
+
+  std::mutex mutex_;
+  /// The connection to the running helper, if any.
+  std::shared_ptr<Connection> connection_;
+  std::chrono::steady_clock::time_point last_start_attempt_;
+  bool start_attempted_ = false;
+};
+}  // namespace google::scp::cpio::client_providers
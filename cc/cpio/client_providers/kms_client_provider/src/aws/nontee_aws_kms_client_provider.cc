@@ -16,6 +16,7 @@
 
 #include "nontee_aws_kms_client_provider.h"
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -64,9 +65,11 @@ using google::scp::core::utils::Base64Decode;
 using google::scp::cpio::common::CreateClientConfiguration;
 using std::bind;
 using std::make_shared;
+using std::make_unique;
 using std::move;
 using std::shared_ptr;
 using std::string;
+using std::chrono::seconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -104,6 +107,12 @@ ExecutionResult NonteeAwsKmsClientProvider::Init() noexcept {
     return execution_result;
   }
 
+  if (options_ && options_->decrypt_cache_ttl_in_s > 0) {
+    decrypt_cache_ = make_unique<KmsDecryptCache>(
+        options_->decrypt_cache_size,
+        seconds(options_->decrypt_cache_ttl_in_s));
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -112,12 +121,38 @@ ExecutionResult NonteeAwsKmsClientProvider::Run() noexcept {
 }
 
 ExecutionResult NonteeAwsKmsClientProvider::Stop() noexcept {
+  if (decrypt_cache_) {
+    auto stats = decrypt_cache_->GetStats();
+    SCP_INFO(kNonteeAwsKmsClientProvider, kZeroUuid,
+             "KMS decrypt cache hit ratio: %.3f (%llu hits, %llu misses, %llu "
+             "coalesced). KMS calls avoided: %llu.",
+             stats.HitRatio(), stats.hits, stats.misses, stats.coalesced,
+             stats.KmsCallsAvoided());
+    decrypt_cache_->Clear();
+  }
   return SuccessExecutionResult();
 }
 
+KmsDecryptCache::Stats
+NonteeAwsKmsClientProvider::GetDecryptCacheStats() noexcept {
+  return decrypt_cache_ ? decrypt_cache_->GetStats() : KmsDecryptCache::Stats();
+}
+
 void NonteeAwsKmsClientProvider::Decrypt(
     AsyncContext<CmrtKmsProto::DecryptRequest, DecryptResponse>&
         decrypt_context) noexcept {
+  if (decrypt_cache_) {
+    decrypt_cache_->Decrypt(
+        decrypt_context,
+        bind(&NonteeAwsKmsClientProvider::DecryptWithKms, this, _1));
+    return;
+  }
+  DecryptWithKms(decrypt_context);
+}
+
+void NonteeAwsKmsClientProvider::DecryptWithKms(
+    AsyncContext<CmrtKmsProto::DecryptRequest, DecryptResponse>&
+        decrypt_context) noexcept {
   const auto& ciphertext = decrypt_context.request->ciphertext();
   if (ciphertext.empty()) {
     auto execution_result = FailureExecutionResult(
@@ -29,6 +29,7 @@
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/interface/kms_client_provider_interface.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
+#include "cpio/client_providers/kms_client_provider/src/kms_decrypt_cache.h"
 #include "public/core/interface/execution_result.h"
 
 namespace google::scp::cpio::client_providers {
@@ -68,7 +69,21 @@ class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
                                   cmrt::sdk::kms_service::v1::DecryptResponse>&
                    decrypt_context) noexcept override;
 
+  /// Gets the stats of the decrypt cache, which are all 0 if it is disabled.
+  KmsDecryptCache::Stats GetDecryptCacheStats() noexcept;
+
  protected:
+  /**
+   * @brief Validates the request and decrypts it with Aws KMS. With the
+   * decrypt cache, this only runs when the plaintext is not cached.
+   *
+   * @param decrypt_context the context of the decrypt operation.
+   */
+  void DecryptWithKms(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context) noexcept;
+
   /**
    * @brief Creates the Client Config object.
    *
@@ -118,5 +133,8 @@ class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
   /// The instance of the io async executor.
   const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_,
       cpu_async_executor_;
+
+  /// Caches decrypted plaintexts, if enabled in the options.
+  std::unique_ptr<KmsDecryptCache> decrypt_cache_;
 };
 }  // namespace google::scp::cpio::client_providers
@@ -16,6 +16,7 @@
 
 #include "tee_aws_kms_client_provider.h"
 
+#include <chrono>
 #include <cstdio>
 #include <iostream>
 #include <memory>
@@ -27,6 +28,7 @@
 #include "core/utils/src/base64.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
 #include "cpio/common/src/aws/aws_utils.h"
+#include "public/cpio/interface/kms_client/aws/type_def.h"
 #include "public/cpio/interface/kms_client/type_def.h"
 
 #include "tee_aws_kms_client_provider_utils.h"
@@ -38,7 +40,9 @@ using google::cmrt::sdk::kms_service::v1::DecryptRequest;
 using google::cmrt::sdk::kms_service::v1::DecryptResponse;
 using google::scp::core::AsyncContext;
 using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
+using google::scp::core::FinishContext;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::errors::
@@ -60,10 +64,12 @@ using google::scp::cpio::common::CreateClientConfiguration;
 using std::array;
 using std::bind;
 using std::make_shared;
+using std::make_unique;
 using std::move;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::chrono::seconds;
 using std::placeholders::_1;
 
 /// Filename for logging errors
@@ -110,19 +116,62 @@ ExecutionResult TeeAwsKmsClientProvider::Init() noexcept {
     return execution_result;
   }
 
+  if (options_ && options_->decrypt_cache_ttl_in_s > 0) {
+    decrypt_cache_ = make_unique<KmsDecryptCache>(
+        options_->decrypt_cache_size,
+        seconds(options_->decrypt_cache_ttl_in_s));
+  }
+
   return SuccessExecutionResult();
 }
 
 ExecutionResult TeeAwsKmsClientProvider::Run() noexcept {
+  if (decrypt_channel_) {
+    // Not fatal: decryption falls back to kmstool_enclave_cli, and the
+    // channel is restarted on later requests.
+    auto execution_result = decrypt_channel_->Start();
+    if (!execution_result.Successful()) {
+      SCP_ERROR(kTeeAwsKmsClientProvider, kZeroUuid, execution_result,
+                "Failed to start the kmstool decrypt helper.");
+    }
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult TeeAwsKmsClientProvider::Stop() noexcept {
+  if (decrypt_channel_) {
+    decrypt_channel_->Stop();
+  }
+  if (decrypt_cache_) {
+    auto stats = decrypt_cache_->GetStats();
+    SCP_INFO(kTeeAwsKmsClientProvider, kZeroUuid,
+             "KMS decrypt cache hit ratio: %.3f (%llu hits, %llu misses, %llu "
+             "coalesced). KMS calls avoided: %llu.",
+             stats.HitRatio(), stats.hits, stats.misses, stats.coalesced,
+             stats.KmsCallsAvoided());
+    decrypt_cache_->Clear();
+  }
   return SuccessExecutionResult();
 }
 
+KmsDecryptCache::Stats
+TeeAwsKmsClientProvider::GetDecryptCacheStats() noexcept {
+  return decrypt_cache_ ? decrypt_cache_->GetStats() : KmsDecryptCache::Stats();
+}
+
 void TeeAwsKmsClientProvider::Decrypt(
     AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context) noexcept {
+  if (decrypt_cache_) {
+    decrypt_cache_->Decrypt(
+        decrypt_context,
+        bind(&TeeAwsKmsClientProvider::DecryptWithKms, this, _1));
+    return;
+  }
+  DecryptWithKms(decrypt_context);
+}
+
+void TeeAwsKmsClientProvider::DecryptWithKms(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context) noexcept {
   const auto& ciphertext = decrypt_context.request->ciphertext();
   if (ciphertext.empty()) {
     auto execution_result = FailureExecutionResult(
@@ -185,6 +234,16 @@ void TeeAwsKmsClientProvider::GetSessionCredentialsCallbackToDecrypt(
   const auto& get_session_credentials_response =
       *get_session_credentials_context.response;
 
+  if (decrypt_channel_ && decrypt_channel_->Start().Successful()) {
+    decrypt_channel_->Decrypt(
+        *decrypt_context.request, get_session_credentials_response,
+        [this, decrypt_context](
+            ExecutionResultOr<string> plaintext_or) mutable {
+          FinishDecrypt(decrypt_context, plaintext_or);
+        });
+    return;
+  }
+
   string command;
   BuildDecryptCmd(decrypt_context.request->kms_region(),
                   decrypt_context.request->ciphertext(),
@@ -195,20 +254,28 @@ void TeeAwsKmsClientProvider::GetSessionCredentialsCallbackToDecrypt(
 
   string plaintext;
   auto execute_result = DecryptUsingEnclavesKmstoolCli(command, plaintext);
-
   if (!execute_result.Successful()) {
-    decrypt_context.result = execute_result;
-    decrypt_context.Finish();
+    FinishDecrypt(decrypt_context, execute_result);
+    return;
+  }
+  FinishDecrypt(decrypt_context, plaintext);
+}
+
+void TeeAwsKmsClientProvider::FinishDecrypt(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context,
+    const ExecutionResultOr<string>& plaintext_or) noexcept {
+  if (!plaintext_or.Successful()) {
+    FinishContext(plaintext_or.result(), decrypt_context, cpu_async_executor_);
     return;
   }
 
   // Decode the plaintext.
-  auto decoded_plaintext_or = Base64Decode(plaintext);
+  auto decoded_plaintext_or = Base64Decode(*plaintext_or);
   if (!decoded_plaintext_or.Successful()) {
     SCP_ERROR_CONTEXT(kTeeAwsKmsClientProvider, decrypt_context,
                       decoded_plaintext_or.result(), "Failed to decode data.");
-    decrypt_context.result = decoded_plaintext_or.result();
-    decrypt_context.Finish();
+    FinishContext(decoded_plaintext_or.result(), decrypt_context,
+                  cpu_async_executor_);
     return;
   }
   string decoded_plaintext = decoded_plaintext_or.release();
@@ -216,8 +283,7 @@ void TeeAwsKmsClientProvider::GetSessionCredentialsCallbackToDecrypt(
   auto kms_decrypt_response = make_shared<DecryptResponse>();
   kms_decrypt_response->set_plaintext(move(decoded_plaintext));
   decrypt_context.response = kms_decrypt_response;
-  decrypt_context.result = SuccessExecutionResult();
-  decrypt_context.Finish();
+  FinishContext(SuccessExecutionResult(), decrypt_context, cpu_async_executor_);
 }
 
 ExecutionResult TeeAwsKmsClientProvider::DecryptUsingEnclavesKmstoolCli(
@@ -268,7 +334,14 @@ std::shared_ptr<KmsClientProviderInterface> KmsClientProviderFactory::Create(
     const shared_ptr<core::AsyncExecutorInterface>& io_async_executor,
     const std::shared_ptr<core::AsyncExecutorInterface>&
         cpu_async_executor) noexcept {
-  return make_shared<TeeAwsKmsClientProvider>(role_credentials_provider);
+  shared_ptr<KmstoolDecryptChannel> decrypt_channel;
+  auto aws_options = std::dynamic_pointer_cast<AwsKmsClientOptions>(options);
+  if (aws_options && !aws_options->kmstool_decrypt_helper_path.empty()) {
+    decrypt_channel = make_shared<KmstoolDecryptChannel>(
+        aws_options->kmstool_decrypt_helper_path);
+  }
+  return make_shared<TeeAwsKmsClientProvider>(
+      role_credentials_provider, cpu_async_executor, decrypt_channel, options);
 }
 #endif
 }  // namespace google::scp::cpio::client_providers
@@ -20,10 +20,15 @@
 #include <string>
 
 #include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
 #include "core/interface/credentials_provider_interface.h"
 #include "cpio/client_providers/interface/kms_client_provider_interface.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
+#include "cpio/client_providers/kms_client_provider/src/kms_decrypt_cache.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/interface/kms_client/type_def.h"
+
+#include "kmstool_decrypt_channel.h"
 
 namespace google::scp::cpio::client_providers {
 /*! @copydoc KmsClientProviderInterface
@@ -34,11 +39,23 @@ class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
    * @brief Constructs a new Aws Enclaves Kms Client Provider.
    *
    * @param credential_provider the credential provider.
+   * @param cpu_async_executor the executor decrypt contexts are finished on.
+   * @param decrypt_channel optional channel to a long-lived kmstool helper.
+   * If set, decryption goes through it, and kmstool_enclave_cli is only run
+   * when the helper is unavailable.
+   * @param options the options of the KMS client.
    */
   explicit TeeAwsKmsClientProvider(
       const std::shared_ptr<RoleCredentialsProviderInterface>&
-          credential_provider)
-      : credential_provider_(credential_provider) {}
+          credential_provider,
+      const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
+      const std::shared_ptr<KmstoolDecryptChannel>& decrypt_channel = nullptr,
+      const std::shared_ptr<KmsClientOptions>& options =
+          std::make_shared<KmsClientOptions>())
+      : credential_provider_(credential_provider),
+        cpu_async_executor_(cpu_async_executor),
+        decrypt_channel_(decrypt_channel),
+        options_(options) {}
 
   TeeAwsKmsClientProvider() = delete;
 
@@ -52,7 +69,21 @@ class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
                                   cmrt::sdk::kms_service::v1::DecryptResponse>&
                    decrypt_context) noexcept override;
 
+  /// Gets the stats of the decrypt cache, which are all 0 if it is disabled.
+  KmsDecryptCache::Stats GetDecryptCacheStats() noexcept;
+
  protected:
+  /**
+   * @brief Validates the request and decrypts it with Aws KMS. With the
+   * decrypt cache, this only runs when the plaintext is not cached.
+   *
+   * @param decrypt_context the context of the decrypt operation.
+   */
+  void DecryptWithKms(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context) noexcept;
+
   /**
    * @brief Callback to pass session credentials for decryption.
    *
@@ -71,7 +102,28 @@ class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
   virtual core::ExecutionResult DecryptUsingEnclavesKmstoolCli(
       const std::string& command, std::string& plaintext) noexcept;
 
+  /**
+   * @brief Decodes the base64 encoded plaintext and finishes the decrypt
+   * context on cpu_async_executor_, so callbacks never run on the decrypt
+   * channel's reader thread.
+   *
+   * @param decrypt_context the context of the decryption.
+   * @param plaintext_or the base64 encoded plaintext or the failure.
+   */
+  void FinishDecrypt(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context,
+      const core::ExecutionResultOr<std::string>& plaintext_or) noexcept;
+
   /// Credential provider.
   const std::shared_ptr<RoleCredentialsProviderInterface> credential_provider_;
+  /// Executor to finish the decrypt contexts on.
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+  /// Channel to the long-lived kmstool helper, if any.
+  const std::shared_ptr<KmstoolDecryptChannel> decrypt_channel_;
+  const std::shared_ptr<KmsClientOptions> options_;
+  /// Caches decrypted plaintexts, if enabled in the options.
+  std::unique_ptr<KmsDecryptCache> decrypt_cache_;
 };
 }  // namespace google::scp::cpio::client_providers
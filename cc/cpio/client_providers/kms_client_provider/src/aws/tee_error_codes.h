@@ -51,6 +51,23 @@ DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_CLI_EXECUTION_FAILED,
                   "Cannot execute enclaves kmstools cli",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED,
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x0008,
+    "Cannot start the kmstool decrypt helper",
+    HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x0009,
+                  "The kmstool decrypt helper is not running",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
+DEFINE_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST,
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x000A,
+    "The decrypt request cannot be sent to the kmstool decrypt helper",
+    HttpStatusCode::BAD_REQUEST)
+
 MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_ASSUME_ROLE_NOT_FOUND,
                          SC_CPIO_COMPONENT_FAILED_INITIALIZED)
 MAP_TO_PUBLIC_ERROR_CODE(
@@ -67,5 +84,14 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED,
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_CLI_EXECUTION_FAILED,
     SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED,
+    SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE,
+    SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST,
+    SC_CPIO_INVALID_ARGUMENT)
 
 }  // namespace google::scp::core::errors
@@ -16,6 +16,7 @@
 
 #include "gcp_kms_client_provider.h"
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -50,9 +51,12 @@ using google::scp::core::errors::SC_GCP_KMS_CLIENT_PROVIDER_KEY_ARN_NOT_FOUND;
 using google::scp::core::utils::Base64Decode;
 using std::bind;
 using std::make_shared;
+using std::make_unique;
 using std::move;
 using std::shared_ptr;
 using std::string;
+using std::chrono::seconds;
+using std::placeholders::_1;
 
 /// Filename for logging errors
 static constexpr char kGcpKmsClientProvider[] = "GcpKmsClientProvider";
@@ -60,6 +64,11 @@ static constexpr char kGcpKmsClientProvider[] = "GcpKmsClientProvider";
 namespace google::scp::cpio::client_providers {
 
 ExecutionResult GcpKmsClientProvider::Init() noexcept {
+  if (options_ && options_->decrypt_cache_ttl_in_s > 0) {
+    decrypt_cache_ = make_unique<KmsDecryptCache>(
+        options_->decrypt_cache_size,
+        seconds(options_->decrypt_cache_ttl_in_s));
+  }
   return SuccessExecutionResult();
 }
 
@@ -68,11 +77,34 @@ ExecutionResult GcpKmsClientProvider::Run() noexcept {
 }
 
 ExecutionResult GcpKmsClientProvider::Stop() noexcept {
+  if (decrypt_cache_) {
+    auto stats = decrypt_cache_->GetStats();
+    SCP_INFO(kGcpKmsClientProvider, kZeroUuid,
+             "KMS decrypt cache hit ratio: %.3f (%llu hits, %llu misses, %llu "
+             "coalesced). KMS calls avoided: %llu.",
+             stats.HitRatio(), stats.hits, stats.misses, stats.coalesced,
+             stats.KmsCallsAvoided());
+    decrypt_cache_->Clear();
+  }
   return SuccessExecutionResult();
 }
 
+KmsDecryptCache::Stats GcpKmsClientProvider::GetDecryptCacheStats() noexcept {
+  return decrypt_cache_ ? decrypt_cache_->GetStats() : KmsDecryptCache::Stats();
+}
+
 void GcpKmsClientProvider::Decrypt(
     AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context) noexcept {
+  if (decrypt_cache_) {
+    decrypt_cache_->Decrypt(
+        decrypt_context, bind(&GcpKmsClientProvider::DecryptWithKms, this, _1));
+    return;
+  }
+  DecryptWithKms(decrypt_context);
+}
+
+void GcpKmsClientProvider::DecryptWithKms(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context) noexcept {
   if (decrypt_context.request->ciphertext().empty()) {
     auto execution_result =
         FailureExecutionResult(SC_GCP_KMS_CLIENT_PROVIDER_CIPHERTEXT_NOT_FOUND);
@@ -161,8 +193,9 @@ shared_ptr<KmsClientProviderInterface> KmsClientProviderFactory::Create(
         role_credentials_provider,
     const shared_ptr<AsyncExecutorInterface>& io_async_executor,
     const shared_ptr<AsyncExecutorInterface>& cpu_async_executor) noexcept {
-  return make_shared<GcpKmsClientProvider>(io_async_executor,
-                                           cpu_async_executor);
+  return make_shared<GcpKmsClientProvider>(
+      io_async_executor, cpu_async_executor, make_shared<GcpKmsFactory>(),
+      options);
 }
 #endif
 }  // namespace google::scp::cpio::client_providers
@@ -22,8 +22,10 @@
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/interface/kms_client_provider_interface.h"
 #include "cpio/client_providers/kms_client_provider/interface/gcp/gcp_key_management_service_client_interface.h"
+#include "cpio/client_providers/kms_client_provider/src/kms_decrypt_cache.h"
 #include "google/cloud/kms/key_management_client.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/interface/kms_client/type_def.h"
 
 #include "error_codes.h"
 
@@ -38,10 +40,13 @@ class GcpKmsClientProvider : public KmsClientProviderInterface {
       const std::shared_ptr<core::AsyncExecutorInterface>& io_async_executor,
       const std::shared_ptr<core::AsyncExecutorInterface>& cpu_async_executor,
       const std::shared_ptr<GcpKmsFactory>& gcp_kms_factory =
-          std::make_shared<GcpKmsFactory>())
+          std::make_shared<GcpKmsFactory>(),
+      const std::shared_ptr<KmsClientOptions>& options =
+          std::make_shared<KmsClientOptions>())
       : io_async_executor_(io_async_executor),
         cpu_async_executor_(cpu_async_executor),
-        gcp_kms_factory_(gcp_kms_factory) {}
+        gcp_kms_factory_(gcp_kms_factory),
+        options_(options) {}
 
   core::ExecutionResult Init() noexcept override;
 
@@ -53,7 +58,21 @@ class GcpKmsClientProvider : public KmsClientProviderInterface {
                                   cmrt::sdk::kms_service::v1::DecryptResponse>&
                    decrypt_context) noexcept override;
 
+  /// Gets the stats of the decrypt cache, which are all 0 if it is disabled.
+  KmsDecryptCache::Stats GetDecryptCacheStats() noexcept;
+
  private:
+  /**
+   * @brief Validates the request and decrypts it with Gcp KMS. With the
+   * decrypt cache, this only runs when the plaintext is not cached.
+   *
+   * @param decrypt_context the context of the decrypt operation.
+   */
+  void DecryptWithKms(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context) noexcept;
+
   void AeadDecrypt(
       core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
                          cmrt::sdk::kms_service::v1::DecryptResponse>&
@@ -62,6 +81,9 @@ class GcpKmsClientProvider : public KmsClientProviderInterface {
   const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_,
       cpu_async_executor_;
   std::shared_ptr<GcpKmsFactory> gcp_kms_factory_;
+  std::shared_ptr<KmsClientOptions> options_;
+  /// Caches decrypted plaintexts, if enabled in the options.
+  std::unique_ptr<KmsDecryptCache> decrypt_cache_;
 };
 
 /// Provides GcpKms.
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kms_decrypt_cache.h"
+
+#include <openssl/mem.h>
+#include <openssl/sha.h>
+
+#include <utility>
+
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::kms_service::v1::DecryptRequest;
+using google::cmrt::sdk::kms_service::v1::DecryptResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::SuccessExecutionResult;
+using std::lock_guard;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::cpio::client_providers {
+KmsDecryptCache::Entry::~Entry() {
+  OPENSSL_cleanse(plaintext.data(), plaintext.size());
+}
+
+KmsDecryptCache::KmsDecryptCache(size_t capacity, milliseconds ttl)
+    : ttl_(ttl), cache_(capacity) {}
+
+void KmsDecryptCache::Decrypt(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context,
+    const DecryptOperation& decrypt) noexcept {
+  auto cache_key = GetCacheKey(*decrypt_context.request);
+  shared_ptr<const Entry> entry;
+  if (cache_.TryGet(cache_key, entry)) {
+    if (steady_clock::now() < entry->expire_time) {
+      {
+        lock_guard lock(mutex_);
+        stats_.hits++;
+      }
+      // Every caller owns its response.
+      decrypt_context.response = make_shared<DecryptResponse>();
+      decrypt_context.response->set_plaintext(entry->plaintext);
+      decrypt_context.result = SuccessExecutionResult();
+      decrypt_context.Finish();
+      return;
+    }
+    cache_.Erase(cache_key);
+  }
+
+  {
+    lock_guard lock(mutex_);
+    stats_.misses++;
+  }
+  single_flight_.Execute(
+      cache_key, decrypt_context,
+      [this, cache_key,
+       &decrypt](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+        auto caching_context = context;
+        caching_context.callback =
+            [this, cache_key, callback = context.callback](
+                AsyncContext<DecryptRequest, DecryptResponse>& context) {
+              if (context.result.Successful() && context.response) {
+                auto entry = make_shared<Entry>();
+                entry->plaintext = context.response->plaintext();
+                entry->expire_time = steady_clock::now() + ttl_;
+                cache_.Set(cache_key, entry);
+              }
+              callback(context);
+            };
+        decrypt(caching_context);
+      });
+}
+
+KmsDecryptCache::Stats KmsDecryptCache::GetStats() noexcept {
+  lock_guard lock(mutex_);
+  auto stats = stats_;
+  stats.coalesced = single_flight_.GetCoalescedCount();
+  return stats;
+}
+
+void KmsDecryptCache::Clear() noexcept {
+  cache_.Clear();
+}
+
+string KmsDecryptCache::GetCacheKey(const DecryptRequest& request) noexcept {
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  // Length-prefixed, so that no two requests hash the same fields.
+  for (const string* field :
+       {&request.ciphertext(), &request.kms_region(),
+        &request.key_resource_name(), &request.account_identity(),
+        &request.gcp_wip_provider()}) {
+    uint64_t size = field->size();
+    SHA256_Update(&sha256, &size, sizeof(size));
+    SHA256_Update(&sha256, field->data(), field->size());
+  }
+  string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256_Final(reinterpret_cast<uint8_t*>(digest.data()), &sha256);
+  return digest;
+}
+}  // namespace google::scp::cpio::client_providers
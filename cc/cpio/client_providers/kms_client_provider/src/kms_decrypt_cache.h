@@ -0,0 +1,119 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/common/lru_cache/src/lru_cache.h"
+#include "core/common/single_flight/src/single_flight.h"
+#include "core/interface/async_context.h"
+#include "public/cpio/proto/kms_service/v1/kms_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief In-memory cache of KMS decrypt results, which also collapses
+ * concurrent decrypts of the same request into one KMS call.
+ *
+ * Entries are keyed by the SHA-256 digest of the whole request, so a cached
+ * plaintext is only served to requests for the same ciphertext, key, region
+ * and identity. Plaintexts are served for the TTL, and are wiped from memory
+ * once the last reference to an evicted entry is gone. Failures are never
+ * cached.
+ */
+class KmsDecryptCache {
+ public:
+  using DecryptOperation = std::function<void(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&)>;
+
+  /// Counters since construction.
+  struct Stats {
+    /// Decrypts served from the cache.
+    uint64_t hits = 0;
+    /// Decrypts not found in the cache.
+    uint64_t misses = 0;
+    /// Misses that joined a KMS call already in flight.
+    uint64_t coalesced = 0;
+
+    /// The number of KMS calls saved by the cache and by coalescing.
+    uint64_t KmsCallsAvoided() const { return hits + coalesced; }
+
+    double HitRatio() const {
+      return hits + misses == 0 ? 0 : static_cast<double>(hits) /
+                                          static_cast<double>(hits + misses);
+    }
+  };
+
+  /**
+   * @brief Construct a new cache.
+   *
+   * @param capacity the max number of cached plaintexts.
+   * @param ttl how long a plaintext is served.
+   */
+  KmsDecryptCache(size_t capacity, std::chrono::milliseconds ttl);
+
+  /**
+   * @brief Finishes the context with the cached plaintext of its request.
+   * Otherwise, runs decrypt for it, or waits for a decrypt of the same request
+   * which is already in flight, and caches the plaintext.
+   *
+   * @param decrypt_context the context of the decrypt operation.
+   * @param decrypt makes the KMS call and finishes the context it is given.
+   */
+  void Decrypt(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context,
+      const DecryptOperation& decrypt) noexcept;
+
+  /// Gets the stats since construction.
+  Stats GetStats() noexcept;
+
+  /// Drops all the cached plaintexts. Decrypts in flight are not affected.
+  void Clear() noexcept;
+
+ private:
+  /// A cached plaintext. Wipes it on destruction.
+  struct Entry {
+    ~Entry();
+
+    std::string plaintext;
+    /// When the plaintext stops being served.
+    std::chrono::steady_clock::time_point expire_time;
+  };
+
+  /// Gets the SHA-256 digest of all the fields of the request.
+  static std::string GetCacheKey(
+      const cmrt::sdk::kms_service::v1::DecryptRequest& request) noexcept;
+
+  const std::chrono::milliseconds ttl_;
+
+  core::common::LruCache<std::string, std::shared_ptr<const Entry>> cache_;
+
+  core::common::SingleFlight<cmrt::sdk::kms_service::v1::DecryptRequest,
+                             cmrt::sdk::kms_service::v1::DecryptResponse>
+      single_flight_;
+
+  std::mutex mutex_;
+  Stats stats_;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/kms_client_provider/src/aws/kmstool_decrypt_channel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/test/utils/conditional_wait.h"
+#include "cpio/client_providers/kms_client_provider/src/aws/tee_error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::kms_service::v1::DecryptRequest;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::WaitUntil;
+using std::atomic;
+using std::make_shared;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::filesystem::path;
+
+namespace google::scp::cpio::client_providers::test {
+static string GetHelperPath() {
+  path test_srcdir_env = std::getenv("TEST_SRCDIR");
+  path test_workspace_env = std::getenv("TEST_WORKSPACE");
+  return test_srcdir_env / test_workspace_env /
+         "cc/cpio/client_providers/kms_client_provider/mock/aws/"
+         "mock_kmstool_decrypt_helper";
+}
+
+static DecryptRequest CreateRequest(const string& ciphertext) {
+  DecryptRequest request;
+  request.set_kms_region("us-east-1");
+  request.set_ciphertext(ciphertext);
+  return request;
+}
+
+static GetRoleCredentialsResponse CreateCredentials() {
+  GetRoleCredentialsResponse credentials;
+  credentials.access_key_id = make_shared<string>("access_key_id");
+  credentials.access_key_secret = make_shared<string>("access_key_secret");
+  credentials.security_token = make_shared<string>("security_token");
+  return credentials;
+}
+
+TEST(KmstoolDecryptChannelTest, DecryptConcurrently) {
+  KmstoolDecryptChannel channel(GetHelperPath());
+  EXPECT_SUCCESS(channel.Start());
+  EXPECT_TRUE(channel.IsRunning());
+
+  constexpr int kNumThreads = 8;
+  constexpr int kRequestsPerThread = 100;
+  auto credentials = CreateCredentials();
+  atomic<int> finished = 0;
+  vector<thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kRequestsPerThread; ++i) {
+        auto ciphertext = to_string(t) + "-" + to_string(i);
+        channel.Decrypt(CreateRequest(ciphertext), credentials,
+                        [&, ciphertext](ExecutionResultOr<string> plaintext) {
+                          EXPECT_SUCCESS(plaintext);
+                          EXPECT_EQ(*plaintext, ciphertext);
+                          finished++;
+                        });
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  WaitUntil(
+      [&]() { return finished.load() == kNumThreads * kRequestsPerThread; });
+  channel.Stop();
+  EXPECT_FALSE(channel.IsRunning());
+}
+
+TEST(KmstoolDecryptChannelTest, HelperFailsRequest) {
+  KmstoolDecryptChannel channel(GetHelperPath());
+  EXPECT_SUCCESS(channel.Start());
+
+  atomic<bool> finished = false;
+  channel.Decrypt(CreateRequest("fail"), CreateCredentials(),
+                  [&](ExecutionResultOr<string> plaintext) {
+                    EXPECT_THAT(
+                        plaintext.result(),
+                        ResultIs(FailureExecutionResult(
+                            SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED)));
+                    finished = true;
+                  });
+  WaitUntil([&]() { return finished.load(); });
+  // The helper keeps serving after a failed request.
+  EXPECT_TRUE(channel.IsRunning());
+}
+
+TEST(KmstoolDecryptChannelTest, RejectsSeparatorsInFields) {
+  KmstoolDecryptChannel channel(GetHelperPath());
+  EXPECT_SUCCESS(channel.Start());
+
+  ExecutionResultOr<string> result;
+  channel.Decrypt(
+      CreateRequest("cipher\ttext"), CreateCredentials(),
+      [&](ExecutionResultOr<string> plaintext) { result = plaintext; });
+  EXPECT_THAT(
+      result.result(),
+      ResultIs(FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_INVALID_REQUEST)));
+}
+
+TEST(KmstoolDecryptChannelTest, FailsWithoutHelper) {
+  KmstoolDecryptChannel channel("/nonexistent/kmstool_decrypt_helper", {},
+                                milliseconds(0));
+  EXPECT_THAT(channel.Start(),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_START_FAILED)));
+  EXPECT_FALSE(channel.IsRunning());
+
+  ExecutionResultOr<string> result;
+  channel.Decrypt(
+      CreateRequest("ciphertext"), CreateCredentials(),
+      [&](ExecutionResultOr<string> plaintext) { result = plaintext; });
+  EXPECT_THAT(result.result(),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE)));
+}
+
+TEST(KmstoolDecryptChannelTest, RestartsAfterStop) {
+  KmstoolDecryptChannel channel(GetHelperPath(), {}, milliseconds(0));
+  EXPECT_SUCCESS(channel.Start());
+  channel.Stop();
+  EXPECT_FALSE(channel.IsRunning());
+  EXPECT_SUCCESS(channel.Start());
+
+  atomic<bool> finished = false;
+  channel.Decrypt(CreateRequest("ciphertext"), CreateCredentials(),
+                  [&](ExecutionResultOr<string> plaintext) {
+                    EXPECT_SUCCESS(plaintext);
+                    finished = true;
+                  });
+  WaitUntil([&]() { return finished.load(); });
+}
+
+TEST(KmstoolDecryptChannelTest, StopAnswersInFlightRequests) {
+  KmstoolDecryptChannel channel(GetHelperPath());
+  EXPECT_SUCCESS(channel.Start());
+
+  ExecutionResultOr<string> result;
+  channel.Decrypt(
+      CreateRequest("ciphertext"), CreateCredentials(),
+      [&](ExecutionResultOr<string> plaintext) { result = plaintext; });
+  // The helper reads the request before the end of its stdin.
+  channel.Stop();
+  EXPECT_SUCCESS(result);
+  EXPECT_EQ(*result, "ciphertext");
+}
+
+TEST(KmstoolDecryptChannelTest, StopKillsHelperThatDoesNotExit) {
+  // Ignores its stdin, so it neither answers nor exits.
+  KmstoolDecryptChannel channel("/bin/sleep", {"60"});
+  EXPECT_SUCCESS(channel.Start());
+
+  ExecutionResultOr<string> result;
+  channel.Decrypt(
+      CreateRequest("ciphertext"), CreateCredentials(),
+      [&](ExecutionResultOr<string> plaintext) { result = plaintext; });
+  channel.Stop();
+  EXPECT_FALSE(channel.IsRunning());
+  EXPECT_THAT(result.result(),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPT_HELPER_UNAVAILABLE)));
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -14,6 +14,8 @@
 
 #include "cpio/client_providers/kms_client_provider/src/aws/tee_aws_kms_client_provider.h"
 
+#include <cstdlib>
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -21,6 +23,7 @@
 
 #include <aws/core/Aws.h>
 
+#include "core/async_executor/mock/mock_async_executor.h"
 #include "core/interface/async_context.h"
 #include "core/test/utils/conditional_wait.h"
 #include "core/test/utils/scp_test_base.h"
@@ -40,9 +43,11 @@ using Aws::Utils::ByteBuffer;
 using google::cmrt::sdk::kms_service::v1::DecryptRequest;
 using google::cmrt::sdk::kms_service::v1::DecryptResponse;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncOperation;
 using google::scp::core::ExecutionStatus;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_CORE_UTILS_INVALID_BASE64_ENCODING_LENGTH;
 using google::scp::core::errors::
     SC_TEE_AWS_KMS_CLIENT_PROVIDER_ASSUME_ROLE_NOT_FOUND;
@@ -73,10 +78,14 @@ using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using std::vector;
+using std::filesystem::path;
 
 static constexpr char kAssumeRoleArn[] = "assumeRoleArn";
 static constexpr char kCiphertext[] = "ciphertext";
 static constexpr char kRegion[] = "us-east-1";
+static constexpr char kDecryptHelperPath[] =
+    "cc/cpio/client_providers/kms_client_provider/mock/aws/"
+    "mock_kmstool_decrypt_helper";
 
 namespace google::scp::cpio::client_providers::test {
 class TeeAwsKmsClientProviderTest : public ScpTestBase {
@@ -94,7 +103,7 @@ class TeeAwsKmsClientProviderTest : public ScpTestBase {
   void SetUp() override {
     mock_credentials_provider_ = make_shared<MockRoleCredentialsProvider>();
     client_ = make_unique<MockTeeAwsKmsClientProviderWithOverrides>(
-        mock_credentials_provider_);
+        mock_credentials_provider_, mock_cpu_async_executor_);
   }
 
   void TearDown() override { EXPECT_SUCCESS(client_->Stop()); }
@@ -116,10 +125,13 @@ class TeeAwsKmsClientProviderTest : public ScpTestBase {
 
   unique_ptr<MockTeeAwsKmsClientProviderWithOverrides> client_;
   shared_ptr<MockRoleCredentialsProvider> mock_credentials_provider_;
+  shared_ptr<MockAsyncExecutor> mock_cpu_async_executor_ =
+      make_shared<MockAsyncExecutor>();
 };
 
 TEST_F(TeeAwsKmsClientProviderTest, MissingCredentialsProvider) {
-  client_ = make_unique<MockTeeAwsKmsClientProviderWithOverrides>(nullptr);
+  client_ = make_unique<MockTeeAwsKmsClientProviderWithOverrides>(
+      nullptr, mock_cpu_async_executor_);
 
   EXPECT_THAT(
       client_->Init(),
@@ -249,4 +261,46 @@ TEST_F(TeeAwsKmsClientProviderTest, MissingRegion) {
   client_->Decrypt(context);
   WaitUntil([&]() { return condition.load(); });
 }
+
+TEST_F(TeeAwsKmsClientProviderTest, SuccessToDecryptWithHelper) {
+  path test_srcdir_env = std::getenv("TEST_SRCDIR");
+  path test_workspace_env = std::getenv("TEST_WORKSPACE");
+  auto decrypt_channel = make_shared<KmstoolDecryptChannel>(
+      test_srcdir_env / test_workspace_env / kDecryptHelperPath);
+  client_ = make_unique<MockTeeAwsKmsClientProviderWithOverrides>(
+      mock_credentials_provider_, mock_cpu_async_executor_, decrypt_channel);
+  // The context must be finished on the executor, not the reader thread.
+  atomic<bool> scheduled = false;
+  mock_cpu_async_executor_->schedule_mock = [&](const AsyncOperation& work) {
+    scheduled = true;
+    work();
+    return SuccessExecutionResult();
+  };
+  ExpectCallGetRoleCredentials();
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+  EXPECT_TRUE(decrypt_channel->IsRunning());
+
+  // The mock helper returns the ciphertext as the encoded plaintext.
+  string plaintext = "plaintext";
+  auto kms_decrpyt_request = make_shared<DecryptRequest>();
+  kms_decrpyt_request->set_account_identity(kAssumeRoleArn);
+  kms_decrpyt_request->set_kms_region(kRegion);
+  kms_decrpyt_request->set_ciphertext(*Base64Encode(plaintext));
+  // Must not fall back to the CLI.
+  client_->returned_plaintext = "invalid";
+  atomic<bool> condition = false;
+
+  AsyncContext<DecryptRequest, DecryptResponse> context(
+      kms_decrpyt_request,
+      [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->plaintext(), plaintext);
+        EXPECT_TRUE(scheduled.load());
+        condition = true;
+      });
+
+  client_->Decrypt(context);
+  WaitUntil([&]() { return condition.load(); });
+}
 }  // namespace google::scp::cpio::client_providers::test
@@ -277,4 +277,45 @@ TEST_F(GcpKmsClientProviderTest, FailedToDecrypt) {
 
   WaitUntil([&]() { return condition.load(); });
 }
+
+TEST_F(GcpKmsClientProviderTest, DecryptCacheSkipsRepeatedKmsCalls) {
+  auto options = make_shared<KmsClientOptions>();
+  options->decrypt_cache_ttl_in_s = 60;
+  auto client = make_unique<GcpKmsClientProvider>(
+      mock_io_async_executor_, mock_cpu_async_executor_,
+      mock_gcp_kms_factory_, options);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  EXPECT_CALL(*mock_gcp_kms_factory_, CreateGcpKeyManagementServiceClient(
+                                          kWipProvider, kServiceAccount))
+      .WillOnce(Return(mock_gcp_key_management_service_client_));
+  GcsDecryptResponse decrypt_response;
+  decrypt_response.set_plaintext(kPlaintext);
+  EXPECT_CALL(*mock_gcp_key_management_service_client_, Decrypt)
+      .WillOnce(Return(decrypt_response));
+
+  auto kms_decrpyt_request = make_shared<DecryptRequest>();
+  kms_decrpyt_request->set_key_resource_name(kKeyArn);
+  kms_decrpyt_request->set_ciphertext(*Base64Encode(kCiphertext));
+  kms_decrpyt_request->set_account_identity(kServiceAccount);
+  kms_decrpyt_request->set_gcp_wip_provider(kWipProvider);
+  for (int i = 0; i < 2; ++i) {
+    atomic<bool> condition = false;
+    AsyncContext<DecryptRequest, DecryptResponse> context(
+        kms_decrpyt_request,
+        [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          EXPECT_EQ(context.response->plaintext(), kPlaintext);
+          condition = true;
+        });
+    client->Decrypt(context);
+    WaitUntil([&]() { return condition.load(); });
+  }
+
+  auto stats = client->GetDecryptCacheStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.KmsCallsAvoided(), 1);
+  EXPECT_SUCCESS(client->Stop());
+}
 }  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/kms_client_provider/src/kms_decrypt_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+#include "public/cpio/proto/kms_service/v1/kms_service.pb.h"
+
+using google::cmrt::sdk::kms_service::v1::DecryptRequest;
+using google::cmrt::sdk::kms_service::v1::DecryptResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::string;
+using std::vector;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+namespace {
+constexpr char kCiphertext[] = "ciphertext";
+constexpr char kKeyResourceName[] = "key_resource_name";
+constexpr char kAccountIdentity[] = "account_identity";
+constexpr size_t kCapacity = 10;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+using DecryptContext = AsyncContext<DecryptRequest, DecryptResponse>;
+
+class KmsDecryptCacheTest : public testing::Test {
+ protected:
+  static DecryptRequest CreateRequest(
+      const string& ciphertext = kCiphertext,
+      const string& account_identity = kAccountIdentity) {
+    DecryptRequest request;
+    request.set_ciphertext(ciphertext);
+    request.set_key_resource_name(kKeyResourceName);
+    request.set_account_identity(account_identity);
+    return request;
+  }
+
+  // Decrypts through the cache. KMS calls are held in flight until
+  // FinishKmsCalls().
+  void Decrypt(KmsDecryptCache& cache, const DecryptRequest& request) {
+    DecryptContext context(make_shared<DecryptRequest>(request),
+                           [this](DecryptContext& context) {
+                             results_.push_back(context.result);
+                             if (context.response) {
+                               plaintexts_.push_back(
+                                   context.response->plaintext());
+                             }
+                           });
+    cache.Decrypt(context, [this](DecryptContext& context) {
+      kms_call_count_++;
+      in_flight_.push_back(context);
+    });
+  }
+
+  void FinishKmsCalls(
+      const ExecutionResult& result = SuccessExecutionResult()) {
+    auto in_flight = std::move(in_flight_);
+    for (auto& context : in_flight) {
+      if (result.Successful()) {
+        context.response = make_shared<DecryptResponse>();
+        context.response->set_plaintext("plaintext:" +
+                                        context.request->ciphertext());
+      }
+      context.result = result;
+      context.Finish();
+    }
+  }
+
+  int kms_call_count_ = 0;
+  vector<DecryptContext> in_flight_;
+  vector<ExecutionResult> results_;
+  vector<string> plaintexts_;
+};
+
+TEST_F(KmsDecryptCacheTest, DecryptThenHit) {
+  KmsDecryptCache cache(kCapacity, hours(1));
+
+  Decrypt(cache, CreateRequest());
+  FinishKmsCalls();
+  Decrypt(cache, CreateRequest());
+  EXPECT_EQ(kms_call_count_, 1);
+  ASSERT_EQ(plaintexts_.size(), 2);
+  EXPECT_EQ(plaintexts_[0], "plaintext:ciphertext");
+  EXPECT_EQ(plaintexts_[1], "plaintext:ciphertext");
+
+  // Other ciphertexts are not affected.
+  Decrypt(cache, CreateRequest("other_ciphertext"));
+  EXPECT_EQ(kms_call_count_, 2);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.KmsCallsAvoided(), 1);
+}
+
+TEST_F(KmsDecryptCacheTest, OtherIdentitiesAreNotServed) {
+  KmsDecryptCache cache(kCapacity, hours(1));
+
+  Decrypt(cache, CreateRequest());
+  FinishKmsCalls();
+  // KMS decides whether the other identity may decrypt the ciphertext.
+  Decrypt(cache, CreateRequest(kCiphertext, "other_account_identity"));
+  EXPECT_EQ(kms_call_count_, 2);
+  EXPECT_EQ(cache.GetStats().hits, 0);
+}
+
+TEST_F(KmsDecryptCacheTest, ConcurrentDecryptsShareOneKmsCall) {
+  KmsDecryptCache cache(kCapacity, hours(1));
+
+  Decrypt(cache, CreateRequest());
+  Decrypt(cache, CreateRequest());
+  Decrypt(cache, CreateRequest());
+  EXPECT_EQ(kms_call_count_, 1);
+  EXPECT_TRUE(results_.empty());
+
+  FinishKmsCalls();
+  ASSERT_EQ(plaintexts_.size(), 3);
+  for (const auto& plaintext : plaintexts_) {
+    EXPECT_EQ(plaintext, "plaintext:ciphertext");
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.coalesced, 2);
+  EXPECT_EQ(stats.KmsCallsAvoided(), 2);
+}
+
+TEST_F(KmsDecryptCacheTest, FailuresAreNotCached) {
+  KmsDecryptCache cache(kCapacity, hours(1));
+
+  Decrypt(cache, CreateRequest());
+  FinishKmsCalls(FailureExecutionResult(SC_UNKNOWN));
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_THAT(results_[0], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+
+  Decrypt(cache, CreateRequest());
+  EXPECT_EQ(kms_call_count_, 2);
+  FinishKmsCalls();
+  ASSERT_EQ(results_.size(), 2);
+  EXPECT_SUCCESS(results_[1]);
+}
+
+TEST_F(KmsDecryptCacheTest, ExpiresAfterTtl) {
+  KmsDecryptCache cache(kCapacity, milliseconds(10));
+
+  Decrypt(cache, CreateRequest());
+  FinishKmsCalls();
+  sleep_for(milliseconds(50));
+  Decrypt(cache, CreateRequest());
+  EXPECT_EQ(kms_call_count_, 2);
+  EXPECT_EQ(cache.GetStats().hits, 0);
+}
+
+TEST_F(KmsDecryptCacheTest, ClearDropsPlaintexts) {
+  KmsDecryptCache cache(kCapacity, hours(1));
+
+  Decrypt(cache, CreateRequest());
+  FinishKmsCalls();
+  cache.Clear();
+  Decrypt(cache, CreateRequest());
+  EXPECT_EQ(kms_call_count_, 2);
+}
+
+TEST_F(KmsDecryptCacheTest, EvictsLeastRecentlyUsed) {
+  KmsDecryptCache cache(1, hours(1));
+
+  Decrypt(cache, CreateRequest("ciphertext_1"));
+  FinishKmsCalls();
+  Decrypt(cache, CreateRequest("ciphertext_2"));
+  FinishKmsCalls();
+  Decrypt(cache, CreateRequest("ciphertext_1"));
+  EXPECT_EQ(kms_call_count_, 3);
+}
+}  // namespace google::scp::cpio::client_providers::test
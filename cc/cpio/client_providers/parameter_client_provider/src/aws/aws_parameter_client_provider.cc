@@ -105,6 +105,14 @@ ExecutionResult AwsParameterClientProvider::Stop() noexcept {
 }
 
 void AwsParameterClientProvider::GetParameter(
+    AsyncContext<GetParameterRequest, GetParameterResponse>&
+        get_parameter_context) noexcept {
+  get_parameter_single_flight_.Execute(
+      get_parameter_context.request->parameter_name(), get_parameter_context,
+      bind(&AwsParameterClientProvider::GetParameterFromSsm, this, _1));
+}
+
+void AwsParameterClientProvider::GetParameterFromSsm(
     AsyncContext<GetParameterRequest, GetParameterResponse>&
         list_parameters_context) noexcept {
   if (list_parameters_context.request->parameter_name().empty()) {
@@ -23,6 +23,7 @@
 
 #include <aws/ssm/SSMClient.h>
 
+#include "core/common/single_flight/src/single_flight.h"
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
 #include "cpio/client_providers/interface/parameter_client_provider_interface.h"
@@ -69,6 +70,18 @@ class AwsParameterClientProvider : public ParameterClientProviderInterface {
                         context) noexcept override;
 
  protected:
+  /**
+   * @brief Gets the parameter from SSM. Concurrent gets of the same parameter
+   * are collapsed into one call to this.
+   *
+   * @param get_parameter_context the get parameter operation context.
+   */
+  void GetParameterFromSsm(
+      core::AsyncContext<
+          cmrt::sdk::parameter_service::v1::GetParameterRequest,
+          cmrt::sdk::parameter_service::v1::GetParameterResponse>&
+          get_parameter_context) noexcept;
+
   /**
    * @brief Is called after AWS GetParameters call is completed.
    *
@@ -101,6 +114,11 @@ class AwsParameterClientProvider : public ParameterClientProviderInterface {
   /// SSMClient.
   std::shared_ptr<Aws::SSM::SSMClient> ssm_client_;
   std::shared_ptr<SSMClientFactory> ssm_client_factory_;
+  /// Collapses concurrent gets of the same parameter.
+  core::common::SingleFlight<
+      cmrt::sdk::parameter_service::v1::GetParameterRequest,
+      cmrt::sdk::parameter_service::v1::GetParameterResponse>
+      get_parameter_single_flight_;
 };
 
 /// Provides SSMClient.
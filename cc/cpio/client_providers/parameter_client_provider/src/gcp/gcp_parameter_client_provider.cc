@@ -105,6 +105,15 @@ shared_ptr<SecretManagerServiceClient> SecretManagerFactory::CreateClient(
 void GcpParameterClientProvider::GetParameter(
     AsyncContext<GetParameterRequest, GetParameterResponse>&
         get_parameter_context) noexcept {
+  get_parameter_single_flight_.Execute(
+      get_parameter_context.request->parameter_name(), get_parameter_context,
+      bind(&GcpParameterClientProvider::GetParameterFromSecretManager, this,
+           _1));
+}
+
+void GcpParameterClientProvider::GetParameterFromSecretManager(
+    AsyncContext<GetParameterRequest, GetParameterResponse>&
+        get_parameter_context) noexcept {
   const auto& secret = get_parameter_context.request->parameter_name();
   if (secret.empty()) {
     auto execution_result = FailureExecutionResult(
@@ -20,6 +20,7 @@
 #include <string>
 #include <utility>
 
+#include "core/common/single_flight/src/single_flight.h"
 #include "core/interface/async_context.h"
 #include "core/interface/async_executor_interface.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
@@ -73,6 +74,19 @@ class GcpParameterClientProvider : public ParameterClientProviderInterface {
                         get_parameter_context) noexcept override;
 
  private:
+  /**
+   * @brief Gets the parameter from Gcp Secret Manager. Concurrent gets of the
+   * same parameter are collapsed into one call to this.
+   *
+   * @param get_parameter_context the context object of the get parameter
+   * operation.
+   */
+  void GetParameterFromSecretManager(
+      core::AsyncContext<
+          cmrt::sdk::parameter_service::v1::GetParameterRequest,
+          cmrt::sdk::parameter_service::v1::GetParameterResponse>&
+          get_parameter_context) noexcept;
+
   /**
    * @brief Is called by async executor in order to get the secret of parameter
    * from Gcp Secret Manager.
@@ -108,6 +122,12 @@ class GcpParameterClientProvider : public ParameterClientProviderInterface {
       sm_client_shared_;
 
   std::shared_ptr<SecretManagerFactory> secret_manager_factory_;
+
+  /// Collapses concurrent gets of the same parameter.
+  core::common::SingleFlight<
+      cmrt::sdk::parameter_service::v1::GetParameterRequest,
+      cmrt::sdk::parameter_service::v1::GetParameterResponse>
+      get_parameter_single_flight_;
 };
 
 class SecretManagerFactory {
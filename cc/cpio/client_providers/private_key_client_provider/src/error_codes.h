@@ -64,6 +64,11 @@ DEFINE_ERROR_CODE(SC_PRIVATE_KEY_CLIENT_PROVIDER_CANNOT_READ_ENCRYPTED_KEY_SET,
                   "Cannot read encrypted keyset from json keyset",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_NOT_FOUND,
+                  SC_PRIVATE_KEY_CLIENT_PROVIDER, 0x0009,
+                  "Private key is missing from the listing response",
+                  HttpStatusCode::NOT_FOUND)
+
 MAP_TO_PUBLIC_ERROR_CODE(SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_DATA_NOT_FOUND,
                          SC_CPIO_INVALID_ARGUMENT)
 MAP_TO_PUBLIC_ERROR_CODE(
@@ -86,4 +91,6 @@ MAP_TO_PUBLIC_ERROR_CODE(
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_PRIVATE_KEY_CLIENT_PROVIDER_CANNOT_READ_ENCRYPTED_KEY_SET,
     SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_NOT_FOUND,
+                         SC_CPIO_INTERNAL_ERROR)
 }  // namespace google::scp::core::errors
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "private_key_cache.h"
+
+#include <openssl/mem.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <google/protobuf/util/time_util.h>
+
+using google::cmrt::sdk::private_key_service::v1::PrivateKey;
+using google::protobuf::util::TimeUtil;
+using google::scp::core::ExecutionResultOr;
+using std::lock_guard;
+using std::make_shared;
+using std::max;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::system_clock;
+
+namespace google::scp::cpio::client_providers {
+PrivateKeyCache::Entry::~Entry() {
+  auto* key_material = private_key.mutable_private_key();
+  OPENSSL_cleanse(key_material->data(), key_material->size());
+}
+
+PrivateKeyCache::PrivateKeyCache(size_t capacity, milliseconds ttl,
+                                 milliseconds refresh_ahead)
+    : ttl_(ttl), refresh_ahead_(refresh_ahead), cache_(capacity) {}
+
+PrivateKeyCache::LookupAction PrivateKeyCache::Lookup(
+    const string& cache_key, const PrivateKeyCallback& callback,
+    shared_ptr<const PrivateKey>& private_key) noexcept {
+  auto now = system_clock::now();
+  lock_guard lock(mutex_);
+  shared_ptr<const Entry> entry;
+  if (cache_.TryGet(cache_key, entry)) {
+    if (now < entry->expire_time) {
+      stats_.hits++;
+      if (stats_.fetches > 0) {
+        stats_.latency_saved += stats_.total_fetch_latency / stats_.fetches;
+      }
+      // Shares ownership of the entry, so that the key material is wiped only
+      // after the caller is done with it.
+      private_key = shared_ptr<const PrivateKey>(entry, &entry->private_key);
+      if (now >= entry->refresh_time &&
+          in_flight_.try_emplace(cache_key).second) {
+        stats_.refreshes++;
+        return LookupAction::kHitAndRefresh;
+      }
+      return LookupAction::kHit;
+    }
+    cache_.Erase(cache_key);
+  }
+
+  stats_.misses++;
+  auto [it, inserted] = in_flight_.try_emplace(cache_key);
+  it->second.push_back(callback);
+  if (!inserted) {
+    stats_.coalesced++;
+    return LookupAction::kWait;
+  }
+  return LookupAction::kFetch;
+}
+
+void PrivateKeyCache::Complete(const string& cache_key,
+                               ExecutionResultOr<PrivateKey> private_key_or,
+                               nanoseconds fetch_latency) noexcept {
+  vector<PrivateKeyCallback> callbacks;
+  shared_ptr<const PrivateKey> private_key;
+  {
+    lock_guard lock(mutex_);
+    if (auto it = in_flight_.find(cache_key); it != in_flight_.end()) {
+      callbacks = move(it->second);
+      in_flight_.erase(it);
+    }
+    stats_.fetches++;
+    stats_.total_fetch_latency += fetch_latency;
+
+    if (private_key_or.Successful()) {
+      auto now = system_clock::now();
+      auto entry = make_shared<Entry>();
+      entry->private_key = move(*private_key_or);
+      auto ttl_end = now + ttl_;
+      entry->expire_time = ttl_end;
+      entry->refresh_time = max(now, ttl_end - refresh_ahead_);
+      auto expiration_time_in_ms = TimeUtil::TimestampToMilliseconds(
+          entry->private_key.expiration_time());
+      // 0 means that the key does not expire.
+      if (expiration_time_in_ms > 0) {
+        auto expiration_time =
+            system_clock::time_point(milliseconds(expiration_time_in_ms));
+        // Refreshing cannot extend the life of an expiring key.
+        if (expiration_time < ttl_end) {
+          entry->expire_time = expiration_time;
+          entry->refresh_time = expiration_time;
+        }
+      }
+      if (entry->expire_time > now) {
+        cache_.Set(cache_key, entry);
+      }
+      private_key = shared_ptr<const PrivateKey>(entry, &entry->private_key);
+    }
+  }
+
+  for (auto& callback : callbacks) {
+    if (private_key) {
+      callback(private_key);
+    } else {
+      callback(private_key_or.result());
+    }
+  }
+}
+
+PrivateKeyCache::Stats PrivateKeyCache::GetStats() noexcept {
+  lock_guard lock(mutex_);
+  return stats_;
+}
+
+void PrivateKeyCache::Clear() noexcept {
+  cache_.Clear();
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "core/common/lru_cache/src/lru_cache.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/private_key_service/v1/private_key_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief In-memory cache of assembled private keys, which also collapses
+ * concurrent fetches of the same key into one.
+ *
+ * A key is served until the end of its TTL or its expiration time, whichever
+ * comes first. Within refresh_ahead of the end of the TTL, lookups still hit
+ * but also ask the caller to refresh the key, so that busy keys never expire
+ * from the cache. The key material is wiped from memory once the last
+ * reference to an evicted key is gone.
+ */
+class PrivateKeyCache {
+ public:
+  using PrivateKeyCallback = std::function<void(core::ExecutionResultOr<
+      std::shared_ptr<const cmrt::sdk::private_key_service::v1::PrivateKey>>)>;
+
+  /// What the caller has to do after Lookup().
+  enum class LookupAction {
+    /// The key was returned.
+    kHit,
+    /// The key was returned, and the caller must fetch it and call Complete().
+    kHitAndRefresh,
+    /// The callback will be invoked once another caller's fetch completes.
+    kWait,
+    /// The caller must fetch the key and call Complete(), which invokes the
+    /// callback.
+    kFetch,
+  };
+
+  /// Counters since construction.
+  struct Stats {
+    /// Lookups served from the cache.
+    uint64_t hits = 0;
+    /// Lookups that had to wait for a fetch.
+    uint64_t misses = 0;
+    /// Misses that joined a fetch already in flight.
+    uint64_t coalesced = 0;
+    /// Background refreshes started ahead of expiry.
+    uint64_t refreshes = 0;
+    /// Completed fetches, and the time they took in total.
+    uint64_t fetches = 0;
+    std::chrono::nanoseconds total_fetch_latency{0};
+    /// Hits times the average fetch latency at the time of each hit.
+    std::chrono::nanoseconds latency_saved{0};
+
+    double HitRatio() const {
+      return hits + misses == 0 ? 0 : static_cast<double>(hits) /
+                                          static_cast<double>(hits + misses);
+    }
+  };
+
+  /**
+   * @brief Construct a new cache.
+   *
+   * @param capacity the max number of cached keys.
+   * @param ttl how long a fetched key is served.
+   * @param refresh_ahead how long before the end of the TTL refreshes start.
+   */
+  PrivateKeyCache(size_t capacity, std::chrono::milliseconds ttl,
+                  std::chrono::milliseconds refresh_ahead);
+
+  /**
+   * @brief Looks up the key, and registers the callback if the key must be
+   * fetched.
+   *
+   * @param cache_key identifies the key and where it is fetched from.
+   * @param callback invoked when the fetch completes, for kWait and kFetch.
+   * @param[out] private_key set for kHit and kHitAndRefresh.
+   * @return LookupAction what the caller has to do.
+   */
+  LookupAction Lookup(
+      const std::string& cache_key, const PrivateKeyCallback& callback,
+      std::shared_ptr<const cmrt::sdk::private_key_service::v1::PrivateKey>&
+          private_key) noexcept;
+
+  /**
+   * @brief Completes the fetch of the key started by Lookup(). Caches the key
+   * if the fetch succeeded, and invokes all the callbacks waiting for it.
+   *
+   * @param cache_key the key passed to Lookup().
+   * @param private_key_or the fetched key, or the failure.
+   * @param fetch_latency how long the fetch took.
+   */
+  void Complete(
+      const std::string& cache_key,
+      core::ExecutionResultOr<cmrt::sdk::private_key_service::v1::PrivateKey>
+          private_key_or,
+      std::chrono::nanoseconds fetch_latency) noexcept;
+
+  /// Gets the stats since construction.
+  Stats GetStats() noexcept;
+
+  /// Drops all the cached keys. Fetches in flight are not affected.
+  void Clear() noexcept;
+
+ private:
+  /// A cached key. Wipes the key material on destruction.
+  struct Entry {
+    ~Entry();
+
+    cmrt::sdk::private_key_service::v1::PrivateKey private_key;
+    /// When the key stops being served.
+    std::chrono::system_clock::time_point expire_time;
+    /// When lookups start to refresh the key.
+    std::chrono::system_clock::time_point refresh_time;
+  };
+
+  const std::chrono::milliseconds ttl_;
+  const std::chrono::milliseconds refresh_ahead_;
+
+  core::common::LruCache<std::string, std::shared_ptr<const Entry>> cache_;
+
+  std::mutex mutex_;
+  /// Callbacks waiting for each key being fetched. A refresh nobody waits
+  /// for has an empty list.
+  absl::flat_hash_map<std::string, std::vector<PrivateKeyCallback>> in_flight_;
+  Stats stats_;
+};
+}  // namespace google::scp::cpio::client_providers
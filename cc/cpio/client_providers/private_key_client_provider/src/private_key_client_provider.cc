@@ -16,9 +16,13 @@
 
 #include "private_key_client_provider.h"
 
+#include <openssl/mem.h>
+
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -30,6 +34,7 @@
 #include "public/cpio/proto/private_key_service/v1/private_key_service.pb.h"
 
 #include "error_codes.h"
+#include "private_key_cache.h"
 #include "private_key_client_utils.h"
 
 using google::cmrt::sdk::kms_service::v1::DecryptRequest;
@@ -47,22 +52,38 @@ using google::scp::core::SuccessExecutionResult;
 using google::scp::core::Uri;
 using google::scp::core::common::ConcurrentMap;
 using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_NOT_FOUND;
 using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_UNMATCHED_ENDPOINTS_SPLITS;
 using std::atomic;
 using std::bind;
+using std::lock_guard;
 using std::make_pair;
 using std::make_shared;
+using std::make_unique;
 using std::move;
+using std::set;
 using std::shared_ptr;
 using std::string;
+using std::to_string;
 using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
 using std::placeholders::_1;
 
 static constexpr char kPrivateKeyClientProvider[] = "PrivateKeyClientProvider";
 
 namespace google::scp::cpio::client_providers {
 ExecutionResult PrivateKeyClientProvider::Init() noexcept {
+  if (private_key_client_options_ &&
+      private_key_client_options_->key_cache_ttl_in_s > 0) {
+    key_cache_ = make_unique<PrivateKeyCache>(
+        private_key_client_options_->key_cache_size,
+        seconds(private_key_client_options_->key_cache_ttl_in_s),
+        seconds(private_key_client_options_->key_cache_refresh_ahead_in_s));
+  }
   return SuccessExecutionResult();
 }
 
@@ -71,12 +92,169 @@ ExecutionResult PrivateKeyClientProvider::Run() noexcept {
 }
 
 ExecutionResult PrivateKeyClientProvider::Stop() noexcept {
+  if (key_cache_) {
+    auto stats = key_cache_->GetStats();
+    SCP_INFO(kPrivateKeyClientProvider, kZeroUuid,
+             "Private key cache hit ratio: %.3f (%llu hits, %llu misses, %llu "
+             "coalesced, %llu refreshes). Estimated latency saved: %lld ms.",
+             stats.HitRatio(), stats.hits, stats.misses, stats.coalesced,
+             stats.refreshes,
+             duration_cast<milliseconds>(stats.latency_saved).count());
+    key_cache_->Clear();
+  }
   return SuccessExecutionResult();
 }
 
+PrivateKeyCache::Stats PrivateKeyClientProvider::GetKeyCacheStats() noexcept {
+  return key_cache_ ? key_cache_->GetStats() : PrivateKeyCache::Stats();
+}
+
 void PrivateKeyClientProvider::ListPrivateKeys(
     AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
         list_private_keys_context) noexcept {
+  // Listing by max age returns whatever keys are current, so only listing by
+  // key IDs can be served from the cache.
+  if (key_cache_ && !list_private_keys_context.request->key_ids().empty()) {
+    ListPrivateKeysFromCache(list_private_keys_context);
+    return;
+  }
+  FetchPrivateKeys(list_private_keys_context);
+}
+
+void PrivateKeyClientProvider::ListPrivateKeysFromCache(
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+        list_private_keys_context) noexcept {
+  // The same key ID can be served by different endpoints, so cached keys are
+  // also keyed by the endpoints they are fetched from.
+  string endpoints_key;
+  for (const auto& endpoint :
+       list_private_keys_context.request->key_endpoints()) {
+    auto serialized_endpoint = endpoint.SerializeAsString();
+    endpoints_key += to_string(serialized_endpoint.size());
+    endpoints_key += ':';
+    endpoints_key += serialized_endpoint;
+  }
+
+  set<string> key_ids(list_private_keys_context.request->key_ids().begin(),
+                      list_private_keys_context.request->key_ids().end());
+  auto list_keys_status = make_shared<CachedListPrivateKeysStatus>();
+  list_keys_status->pending_key_count = key_ids.size();
+  for (const auto& key_id : key_ids) {
+    auto cache_key = endpoints_key + key_id;
+    shared_ptr<const PrivateKey> private_key;
+    auto action = key_cache_->Lookup(
+        cache_key,
+        [this, list_private_keys_context, list_keys_status](
+            ExecutionResultOr<shared_ptr<const PrivateKey>>
+                private_key_or) mutable {
+          OnPrivateKeyFromCache(list_private_keys_context, list_keys_status,
+                                move(private_key_or));
+        },
+        private_key);
+    switch (action) {
+      case PrivateKeyCache::LookupAction::kHit:
+        OnPrivateKeyFromCache(list_private_keys_context, list_keys_status,
+                              move(private_key));
+        break;
+      case PrivateKeyCache::LookupAction::kHitAndRefresh:
+        OnPrivateKeyFromCache(list_private_keys_context, list_keys_status,
+                              move(private_key));
+        FetchPrivateKeyIntoCache(list_private_keys_context, key_id, cache_key);
+        break;
+      case PrivateKeyCache::LookupAction::kFetch:
+        FetchPrivateKeyIntoCache(list_private_keys_context, key_id, cache_key);
+        break;
+      case PrivateKeyCache::LookupAction::kWait:
+        break;
+    }
+  }
+}
+
+void PrivateKeyClientProvider::FetchPrivateKeyIntoCache(
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+        list_private_keys_context,
+    const string& key_id, const string& cache_key) noexcept {
+  // Every key is fetched on its own, so that one bad key does not fail the
+  // callers waiting for the others. It costs no extra calls since keys are
+  // fetched one by one anyway.
+  auto request = make_shared<ListPrivateKeysRequest>();
+  *request->mutable_key_endpoints() =
+      list_private_keys_context.request->key_endpoints();
+  request->add_key_ids(key_id);
+  auto start_time = steady_clock::now();
+  AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse> fetch_context(
+      move(request),
+      [this, key_id, cache_key, start_time](
+          AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+              fetch_context) {
+        auto fetch_latency = steady_clock::now() - start_time;
+        if (!fetch_context.result.Successful()) {
+          SCP_ERROR_CONTEXT(kPrivateKeyClientProvider, fetch_context,
+                            fetch_context.result,
+                            "Failed to fetch private key %s for the cache.",
+                            key_id.c_str());
+          key_cache_->Complete(cache_key, fetch_context.result, fetch_latency);
+          return;
+        }
+        for (auto& private_key :
+             *fetch_context.response->mutable_private_keys()) {
+          if (private_key.key_id() == key_id) {
+            key_cache_->Complete(cache_key, move(private_key), fetch_latency);
+            return;
+          }
+        }
+        FailureExecutionResult execution_result(
+            SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_NOT_FOUND);
+        SCP_ERROR_CONTEXT(kPrivateKeyClientProvider, fetch_context,
+                          execution_result,
+                          "Private key %s is missing from the response.",
+                          key_id.c_str());
+        key_cache_->Complete(cache_key, execution_result, fetch_latency);
+      },
+      list_private_keys_context);
+  FetchPrivateKeys(fetch_context);
+}
+
+void PrivateKeyClientProvider::OnPrivateKeyFromCache(
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+        list_private_keys_context,
+    shared_ptr<CachedListPrivateKeysStatus> list_keys_status,
+    ExecutionResultOr<shared_ptr<const PrivateKey>> private_key_or) noexcept {
+  if (!private_key_or.Successful()) {
+    auto got_failure = false;
+    if (list_keys_status->got_failure.compare_exchange_strong(got_failure,
+                                                              true)) {
+      list_private_keys_context.result = private_key_or.result();
+      SCP_ERROR_CONTEXT(kPrivateKeyClientProvider, list_private_keys_context,
+                        list_private_keys_context.result,
+                        "Failed to get the private key.");
+      list_private_keys_context.Finish();
+    }
+    return;
+  }
+
+  {
+    lock_guard lock(list_keys_status->private_keys_mutex);
+    list_keys_status->private_keys[(*private_key_or)->key_id()] =
+        *private_key_or;
+  }
+  // A failure never counts down, so the last key means no failure.
+  if (list_keys_status->pending_key_count.fetch_sub(1) != 1) {
+    return;
+  }
+
+  // Keys are ordered by key ID, like the ones fetched directly.
+  list_private_keys_context.response = make_shared<ListPrivateKeysResponse>();
+  for (const auto& [key_id, private_key] : list_keys_status->private_keys) {
+    *list_private_keys_context.response->add_private_keys() = *private_key;
+  }
+  list_private_keys_context.result = SuccessExecutionResult();
+  list_private_keys_context.Finish();
+}
+
+void PrivateKeyClientProvider::FetchPrivateKeys(
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+        list_private_keys_context) noexcept {
   auto endpoint_count = list_private_keys_context.request->key_endpoints_size();
   auto list_keys_status = make_shared<ListPrivateKeysStatus>();
   list_keys_status->listing_method =
@@ -336,12 +514,16 @@ void PrivateKeyClientProvider::OnDecryptCallback(
               break;
             }
           }
-          success_decrypt_result.emplace_back(decrypt_result);
+          success_decrypt_result.emplace_back(move(decrypt_result));
         }
       }
       if (all_splits_are_available) {
         auto private_key_or =
             PrivateKeyClientUtils::ConstructPrivateKey(success_decrypt_result);
+        for (auto& decrypt_result : success_decrypt_result) {
+          OPENSSL_cleanse(decrypt_result.plaintext.data(),
+                          decrypt_result.plaintext.size());
+        }
         if (!private_key_or.Successful()) {
           list_private_keys_context.result = private_key_or.result();
           SCP_ERROR_CONTEXT(kPrivateKeyClientProvider,
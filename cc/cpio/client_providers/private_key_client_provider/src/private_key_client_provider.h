@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -34,6 +35,7 @@
 #include "public/core/interface/execution_result.h"
 
 #include "error_codes.h"
+#include "private_key_cache.h"
 #include "private_key_client_utils.h"
 
 namespace google::scp::cpio::client_providers {
@@ -66,6 +68,13 @@ class PrivateKeyClientProvider : public PrivateKeyClientProviderInterface {
           cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
           context) noexcept override;
 
+  /**
+   * @brief Gets the stats of the private key cache.
+   *
+   * @return PrivateKeyCache::Stats the stats, all 0 if the cache is disabled.
+   */
+  PrivateKeyCache::Stats GetKeyCacheStats() noexcept;
+
  protected:
   /// The overrall status of the whole ListPrivateKeys call.
   struct ListPrivateKeysStatus {
@@ -142,6 +151,77 @@ class PrivateKeyClientProvider : public PrivateKeyClientProviderInterface {
       std::shared_ptr<ListPrivateKeysStatus> list_keys_status,
       std::shared_ptr<EncryptionKey> encryption_key, size_t uri_index) noexcept;
 
+  /// The status of a ListPrivateKeys call served through the key cache.
+  struct CachedListPrivateKeysStatus {
+    /// The keys obtained so far, by key ID.
+    std::map<std::string,
+             std::shared_ptr<
+                 const cmrt::sdk::private_key_service::v1::PrivateKey>>
+        private_keys;
+    std::mutex private_keys_mutex;
+    /// How many keys are not obtained yet.
+    std::atomic<size_t> pending_key_count{0};
+    /// Whether the call got a failure result.
+    std::atomic<bool> got_failure{false};
+  };
+
+  /**
+   * @brief Fetches and decrypts the requested keys from the endpoints,
+   * bypassing the key cache.
+   *
+   * @param list_private_keys_context ListPrivateKeys context.
+   */
+  void FetchPrivateKeys(
+      core::AsyncContext<
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
+          list_private_keys_context) noexcept;
+
+  /**
+   * @brief Serves ListPrivateKeys by key IDs from the key cache, fetching only
+   * the keys that are not cached or being fetched already.
+   *
+   * @param list_private_keys_context ListPrivateKeys context.
+   */
+  void ListPrivateKeysFromCache(
+      core::AsyncContext<
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
+          list_private_keys_context) noexcept;
+
+  /**
+   * @brief Fetches one key and completes it in the key cache.
+   *
+   * @param list_private_keys_context the ListPrivateKeys context the fetch is
+   * started for.
+   * @param key_id the ID of the key.
+   * @param cache_key the key of the key in the cache.
+   */
+  void FetchPrivateKeyIntoCache(
+      core::AsyncContext<
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
+          list_private_keys_context,
+      const std::string& key_id, const std::string& cache_key) noexcept;
+
+  /**
+   * @brief Is called when one key of a cached ListPrivateKeys call is
+   * obtained.
+   *
+   * @param list_private_keys_context ListPrivateKeys context.
+   * @param list_keys_status ListPrivateKeys operation status.
+   * @param private_key_or the key, or the failure to obtain it.
+   */
+  void OnPrivateKeyFromCache(
+      core::AsyncContext<
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
+          list_private_keys_context,
+      std::shared_ptr<CachedListPrivateKeysStatus> list_keys_status,
+      core::ExecutionResultOr<
+          std::shared_ptr<const cmrt::sdk::private_key_service::v1::PrivateKey>>
+          private_key_or) noexcept;
+
   /// Configurations for PrivateKeyClient.
   std::shared_ptr<PrivateKeyClientOptions> private_key_client_options_;
 
@@ -150,5 +230,8 @@ class PrivateKeyClientProvider : public PrivateKeyClientProviderInterface {
 
   /// KMS client provider.
   std::shared_ptr<KmsClientProviderInterface> kms_client_provider_;
+
+  /// Cache of assembled private keys. Null if disabled.
+  std::unique_ptr<PrivateKeyCache> key_cache_;
 };
 }  // namespace google::scp::cpio::client_providers
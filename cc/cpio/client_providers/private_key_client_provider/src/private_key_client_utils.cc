@@ -16,8 +16,14 @@
 
 #include "private_key_client_utils.h"
 
+#include <openssl/mem.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -32,6 +38,7 @@
 #include "absl/strings/escaping.h"
 #include "core/interface/http_types.h"
 #include "core/utils/src/base64.h"
+#include "core/utils/src/error_codes.h"
 #include "cpio/client_providers/interface/private_key_fetcher_provider_interface.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/proto/private_key_service/v1/private_key_service.pb.h"
@@ -52,6 +59,7 @@ using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_CANNOT_CREATE_JSON_KEY_SET;
 using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_CANNOT_READ_ENCRYPTED_KEY_SET;
+using google::scp::core::errors::SC_CORE_UTILS_INVALID_INPUT;
 using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_INVALID_KEY_DATA_COUNT;
 using google::scp::core::errors::
@@ -66,6 +74,7 @@ using google::scp::core::utils::Base64Encode;
 using google::scp::cpio::client_providers::KeyData;
 using google::scp::cpio::client_providers::PrivateKeyFetchingResponse;
 using std::byte;
+using std::memcpy;
 using std::move;
 using std::optional;
 using std::shared_ptr;
@@ -140,23 +149,44 @@ ExecutionResult PrivateKeyClientUtils::GetKmsDecryptRequest(
 }
 
 vector<byte> PrivateKeyClientUtils::StrToBytes(const string& string) noexcept {
-  vector<byte> bytes;
-  for (char c : string) {
-    bytes.push_back(byte(c));
-  }
-  return bytes;
+  auto* data = reinterpret_cast<const byte*>(string.data());
+  return vector<byte>(data, data + string.size());
 }
 
 vector<byte> PrivateKeyClientUtils::XOR(const vector<byte>& arr1,
                                         const vector<byte>& arr2) noexcept {
-  vector<byte> result;
-  for (int i = 0; i < arr1.size(); ++i) {
-    result.push_back((byte)(arr1[i] ^ arr2[i]));
-  }
-
+  vector<byte> result(arr1);
+  XorInPlace(reinterpret_cast<const char*>(arr2.data()), result.size(),
+             reinterpret_cast<char*>(result.data()));
   return result;
 }
 
+void PrivateKeyClientUtils::XorInPlace(const char* piece, size_t size,
+                                       char* buffer) noexcept {
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+    auto* out = reinterpret_cast<__m128i*>(buffer + i);
+    _mm_storeu_si128(
+        out, _mm_xor_si128(_mm_loadu_si128(out),
+                           _mm_loadu_si128(
+                               reinterpret_cast<const __m128i*>(piece + i))));
+  }
+#endif
+  // Elsewhere, the compiler vectorizes the word loop on its own.
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    uint64_t piece_word;
+    memcpy(&word, buffer + i, sizeof(word));
+    memcpy(&piece_word, piece + i, sizeof(piece_word));
+    word ^= piece_word;
+    memcpy(buffer + i, &word, sizeof(word));
+  }
+  for (; i < size; ++i) {
+    buffer[i] ^= piece[i];
+  }
+}
+
 ExecutionResultOr<PrivateKey> PrivateKeyClientUtils::ConstructPrivateKey(
     const vector<DecryptResult>& decrypt_results) noexcept {
   if (decrypt_results.empty()) {
@@ -164,6 +194,18 @@ ExecutionResultOr<PrivateKey> PrivateKeyClientUtils::ConstructPrivateKey(
         SC_PRIVATE_KEY_CLIENT_PROVIDER_KEY_DATA_NOT_FOUND);
   }
 
+  auto secret_size = decrypt_results.at(0).plaintext.size();
+  for (const auto& decrypt_result : decrypt_results) {
+    if (decrypt_result.plaintext.size() != secret_size) {
+      return FailureExecutionResult(
+          SC_PRIVATE_KEY_CLIENT_PROVIDER_SECRET_PIECE_SIZE_UNMATCHED);
+    }
+  }
+  // An empty secret is no key at all.
+  if (secret_size == 0) {
+    return FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT);
+  }
+
   auto& encryption_key = decrypt_results.at(0).encryption_key;
   PrivateKey private_key;
   private_key.set_key_id(*encryption_key.key_id);
@@ -173,21 +215,22 @@ ExecutionResultOr<PrivateKey> PrivateKeyClientUtils::ConstructPrivateKey(
   *private_key.mutable_creation_time() =
       TimeUtil::MillisecondsToTimestamp(encryption_key.creation_time_in_ms);
 
-  vector<byte> xor_secret = StrToBytes(decrypt_results.at(0).plaintext);
-
-  for (auto i = 1; i < decrypt_results.size(); ++i) {
-    vector<byte> next_piece = StrToBytes(decrypt_results.at(i).plaintext);
-    if (xor_secret.size() != next_piece.size()) {
-      return FailureExecutionResult(
-          SC_PRIVATE_KEY_CLIENT_PROVIDER_SECRET_PIECE_SIZE_UNMATCHED);
+  // A single split is the key itself, and needs no buffer of its own.
+  const string* secret = &decrypt_results.at(0).plaintext;
+  string xor_secret;
+  if (decrypt_results.size() > 1) {
+    xor_secret = *secret;
+    for (size_t i = 1; i < decrypt_results.size(); ++i) {
+      XorInPlace(decrypt_results.at(i).plaintext.data(), secret_size,
+                 xor_secret.data());
     }
-    xor_secret = XOR(xor_secret, next_piece);
+    secret = &xor_secret;
   }
-  string key_string(reinterpret_cast<const char*>(&xor_secret[0]),
-                    xor_secret.size());
 
-  ASSIGN_OR_RETURN(string encoded_key, Base64Encode(key_string));
-  private_key.set_private_key(encoded_key);
+  auto encode_result = Base64Encode(secret->data(), secret_size,
+                                   *private_key.mutable_private_key());
+  OPENSSL_cleanse(xor_secret.data(), xor_secret.size());
+  RETURN_IF_FAILURE(encode_result);
   return private_key;
 }
 
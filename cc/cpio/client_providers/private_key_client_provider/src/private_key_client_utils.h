@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
@@ -89,7 +90,19 @@ class PrivateKeyClientUtils {
       const std::vector<std::byte>& arr2) noexcept;
 
   /**
-   * @brief Construct private key from decrypt result.
+   * @brief XORs the piece into the buffer in place, 16 bytes at a time where
+   * SSE2 is available.
+   *
+   * @param piece the bytes to XOR into the buffer.
+   * @param size the size of both the piece and the buffer.
+   * @param[in,out] buffer the bytes to XOR the piece into.
+   */
+  static void XorInPlace(const char* piece, size_t size, char* buffer) noexcept;
+
+  /**
+   * @brief Construct private key from decrypt result. The splits are XORed
+   * into one buffer, which is encoded straight into the private key and then
+   * wiped.
    *
    * @param decrypt_results decrypt results.
    * @return core::ExecutionResultOr<PrivateKey> construct result.
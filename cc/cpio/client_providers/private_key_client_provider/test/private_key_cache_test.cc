@@ -0,0 +1,236 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/private_key_client_provider/src/private_key_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <google/protobuf/util/time_util.h>
+
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+#include "public/cpio/proto/private_key_service/v1/private_key_service.pb.h"
+
+using google::cmrt::sdk::private_key_service::v1::PrivateKey;
+using google::protobuf::util::TimeUtil;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::test::ResultIs;
+using std::shared_ptr;
+using std::string;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::system_clock;
+using std::this_thread::sleep_for;
+
+namespace {
+constexpr char kCacheKey1[] = "cache_key_1";
+constexpr char kCacheKey2[] = "cache_key_2";
+constexpr char kKeyId[] = "key_id";
+constexpr char kPrivateKey[] = "private_key";
+constexpr size_t kCapacity = 10;
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+using LookupAction = PrivateKeyCache::LookupAction;
+
+static PrivateKey CreatePrivateKey(int64_t expiration_time_in_ms = 0) {
+  PrivateKey private_key;
+  private_key.set_key_id(kKeyId);
+  private_key.set_private_key(kPrivateKey);
+  *private_key.mutable_expiration_time() =
+      TimeUtil::MillisecondsToTimestamp(expiration_time_in_ms);
+  return private_key;
+}
+
+static int64_t NowInMs() {
+  return std::chrono::duration_cast<milliseconds>(
+             system_clock::now().time_since_epoch())
+      .count();
+}
+
+TEST(PrivateKeyCacheTest, FetchThenHit) {
+  PrivateKeyCache cache(kCapacity, hours(1), milliseconds(0));
+
+  int callback_count = 0;
+  auto callback = [&](ExecutionResultOr<shared_ptr<const PrivateKey>> key_or) {
+    EXPECT_SUCCESS(key_or);
+    EXPECT_EQ((*key_or)->private_key(), kPrivateKey);
+    callback_count++;
+  };
+  shared_ptr<const PrivateKey> private_key;
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  EXPECT_EQ(private_key, nullptr);
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(100));
+  EXPECT_EQ(callback_count, 1);
+
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHit);
+  ASSERT_NE(private_key, nullptr);
+  EXPECT_EQ(private_key->private_key(), kPrivateKey);
+  EXPECT_EQ(callback_count, 1);
+
+  // Other keys are not affected.
+  EXPECT_EQ(cache.Lookup(kCacheKey2, callback, private_key),
+            LookupAction::kFetch);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.fetches, 1);
+  EXPECT_EQ(stats.latency_saved, nanoseconds(100));
+}
+
+TEST(PrivateKeyCacheTest, ConcurrentMissesShareOneFetch) {
+  PrivateKeyCache cache(kCapacity, hours(1), milliseconds(0));
+
+  int callback_count = 0;
+  auto callback = [&](ExecutionResultOr<shared_ptr<const PrivateKey>> key_or) {
+    EXPECT_SUCCESS(key_or);
+    callback_count++;
+  };
+  shared_ptr<const PrivateKey> private_key;
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kWait);
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kWait);
+  EXPECT_EQ(callback_count, 0);
+
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(0));
+  EXPECT_EQ(callback_count, 3);
+  EXPECT_EQ(cache.GetStats().coalesced, 2);
+}
+
+TEST(PrivateKeyCacheTest, FailureIsPassedToWaitersButNotCached) {
+  PrivateKeyCache cache(kCapacity, hours(1), milliseconds(0));
+
+  auto failure = FailureExecutionResult(SC_UNKNOWN);
+  int callback_count = 0;
+  auto callback = [&](ExecutionResultOr<shared_ptr<const PrivateKey>> key_or) {
+    EXPECT_THAT(key_or.result(), ResultIs(failure));
+    callback_count++;
+  };
+  shared_ptr<const PrivateKey> private_key;
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kWait);
+  cache.Complete(kCacheKey1, failure, nanoseconds(0));
+  EXPECT_EQ(callback_count, 2);
+
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+}
+
+TEST(PrivateKeyCacheTest, EntryExpiresAfterTtl) {
+  PrivateKeyCache cache(kCapacity, milliseconds(1), milliseconds(0));
+
+  shared_ptr<const PrivateKey> private_key;
+  auto callback = [](ExecutionResultOr<shared_ptr<const PrivateKey>>) {};
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(0));
+  sleep_for(milliseconds(5));
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+}
+
+TEST(PrivateKeyCacheTest, ExpiredKeyIsNotCached) {
+  PrivateKeyCache cache(kCapacity, hours(1), milliseconds(0));
+
+  int callback_count = 0;
+  auto callback = [&](ExecutionResultOr<shared_ptr<const PrivateKey>> key_or) {
+    // The caller still gets the key it asked for.
+    EXPECT_SUCCESS(key_or);
+    callback_count++;
+  };
+  shared_ptr<const PrivateKey> private_key;
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  cache.Complete(kCacheKey1, CreatePrivateKey(NowInMs() - 1000),
+                 nanoseconds(0));
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+}
+
+TEST(PrivateKeyCacheTest, RefreshesAheadOfTtl) {
+  // Refreshing starts right away since refresh_ahead covers the whole TTL.
+  PrivateKeyCache cache(kCapacity, hours(1), hours(2));
+
+  shared_ptr<const PrivateKey> private_key;
+  auto callback = [](ExecutionResultOr<shared_ptr<const PrivateKey>>) {};
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(0));
+
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHitAndRefresh);
+  EXPECT_NE(private_key, nullptr);
+  // Only one refresh is in flight at a time.
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHit);
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(0));
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHitAndRefresh);
+  EXPECT_EQ(cache.GetStats().refreshes, 2);
+}
+
+TEST(PrivateKeyCacheTest, KeyExpirationStopsRefreshing) {
+  PrivateKeyCache cache(kCapacity, hours(1), hours(2));
+
+  shared_ptr<const PrivateKey> private_key;
+  auto callback = [](ExecutionResultOr<shared_ptr<const PrivateKey>>) {};
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  // The key expires before the end of the TTL, so refreshing cannot help.
+  cache.Complete(kCacheKey1, CreatePrivateKey(NowInMs() + 60000),
+                 nanoseconds(0));
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHit);
+}
+
+TEST(PrivateKeyCacheTest, KeyOutlivesEviction) {
+  PrivateKeyCache cache(1, hours(1), milliseconds(0));
+
+  shared_ptr<const PrivateKey> private_key;
+  auto callback = [](ExecutionResultOr<shared_ptr<const PrivateKey>>) {};
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+  cache.Complete(kCacheKey1, CreatePrivateKey(), nanoseconds(0));
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kHit);
+
+  shared_ptr<const PrivateKey> other_private_key;
+  EXPECT_EQ(cache.Lookup(kCacheKey2, callback, other_private_key),
+            LookupAction::kFetch);
+  cache.Complete(kCacheKey2, CreatePrivateKey(), nanoseconds(0));
+  cache.Clear();
+  // The key handed out before is still intact.
+  EXPECT_EQ(private_key->private_key(), kPrivateKey);
+  EXPECT_EQ(cache.Lookup(kCacheKey1, callback, private_key),
+            LookupAction::kFetch);
+}
+}  // namespace google::scp::cpio::client_providers::test
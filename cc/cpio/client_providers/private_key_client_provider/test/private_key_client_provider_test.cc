@@ -750,6 +750,144 @@ TEST_F(PrivateKeyClientProviderTest, FailedWithOneKmsDecryptContext) {
   WaitUntil([&]() { return response_count.load() == 1; });
 }
 
+class PrivateKeyClientProviderKeyCacheTest
+    : public PrivateKeyClientProviderTest {
+ protected:
+  void SetUp() override {
+    PrivateKeyClientProviderTest::SetUp();
+    EXPECT_SUCCESS(private_key_client_provider->Stop());
+
+    auto private_key_client_options = make_shared<PrivateKeyClientOptions>();
+    private_key_client_options->key_cache_ttl_in_s = 3600;
+    private_key_client_provider =
+        make_shared<MockPrivateKeyClientProviderWithOverrides>(
+            private_key_client_options);
+    mock_private_key_fetcher =
+        private_key_client_provider->GetPrivateKeyFetcherProvider();
+    mock_kms_client = private_key_client_provider->GetKmsClientProvider();
+    EXPECT_SUCCESS(private_key_client_provider->Init());
+    EXPECT_SUCCESS(private_key_client_provider->Run());
+  }
+
+  // Keys in the default responses have long expired, so cannot be cached.
+  static map<string, map<string, PrivateKeyFetchingResponse>>
+  CreateUnexpiredKeyFetchingResponseMap() {
+    auto responses = CreateSuccessKeyFetchingResponseMap();
+    for (auto& [key_id, endpoint_responses] : responses) {
+      for (auto& [endpoint, response] : endpoint_responses) {
+        for (auto& encryption_key : response.encryption_keys) {
+          encryption_key->expiration_time_in_ms = kUnexpiredExpirationTime;
+        }
+      }
+    }
+    return responses;
+  }
+
+  void ListPrivateKeysAndExpect(const vector<string>& key_ids,
+                                const vector<string>& expected_key_ids) {
+    auto request = make_shared<ListPrivateKeysRequest>();
+    *request->mutable_key_endpoints() = list_request_->key_endpoints();
+    for (const auto& key_id : key_ids) {
+      request->add_key_ids(key_id);
+    }
+
+    string encoded_private_key = *Base64Encode(kTestPrivateKey);
+    atomic<bool> finished = false;
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse> context(
+        move(request), [&](AsyncContext<ListPrivateKeysRequest,
+                                        ListPrivateKeysResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          vector<string> listed_key_ids;
+          for (const auto& private_key : context.response->private_keys()) {
+            listed_key_ids.push_back(private_key.key_id());
+            EXPECT_EQ(private_key.private_key(), encoded_private_key);
+          }
+          EXPECT_EQ(listed_key_ids, expected_key_ids);
+          finished = true;
+        });
+    private_key_client_provider->ListPrivateKeys(context);
+    WaitUntil([&]() { return finished.load(); });
+  }
+
+  static constexpr int64_t kUnexpiredExpirationTime = 4102444800000;
+};
+
+TEST_F(PrivateKeyClientProviderKeyCacheTest, RepeatedListingIsServedByCache) {
+  // Only the first listing fetches and decrypts the 3 splits of each key.
+  SetMockKmsClient(SuccessExecutionResult(), 9);
+  SetMockPrivateKeyFetchingClient(kMockSuccessKeyFetchingResults,
+                                  CreateUnexpiredKeyFetchingResponseMap(), 9);
+
+  ListPrivateKeysAndExpect(kTestKeyIds, kTestKeyIds);
+  ListPrivateKeysAndExpect({kTestKeyIds[2], kTestKeyIds[0], kTestKeyIds[1]},
+                           kTestKeyIds);
+
+  auto stats = private_key_client_provider->GetKeyCacheStats();
+  EXPECT_EQ(stats.hits, 3);
+  EXPECT_EQ(stats.misses, 3);
+}
+
+TEST_F(PrivateKeyClientProviderKeyCacheTest, OnlyMissingKeysAreFetched) {
+  SetMockKmsClient(SuccessExecutionResult(), 9);
+  SetMockPrivateKeyFetchingClient(kMockSuccessKeyFetchingResults,
+                                  CreateUnexpiredKeyFetchingResponseMap(), 9);
+
+  ListPrivateKeysAndExpect({kTestKeyIds[0], kTestKeyIds[1]},
+                           {kTestKeyIds[0], kTestKeyIds[1]});
+  ListPrivateKeysAndExpect({kTestKeyIds[1], kTestKeyIds[2], kTestKeyIds[2]},
+                           {kTestKeyIds[1], kTestKeyIds[2]});
+}
+
+TEST_F(PrivateKeyClientProviderKeyCacheTest, ExpiredKeysAreNotCached) {
+  SetMockKmsClient(SuccessExecutionResult(), 18);
+  SetMockPrivateKeyFetchingClient(kMockSuccessKeyFetchingResults,
+                                  kMockSuccessKeyFetchingResponses, 18);
+
+  ListPrivateKeysAndExpect(kTestKeyIds, kTestKeyIds);
+  ListPrivateKeysAndExpect(kTestKeyIds, kTestKeyIds);
+}
+
+TEST_F(PrivateKeyClientProviderKeyCacheTest, FailedFetchIsNotCached) {
+  // The first listing fails on the first endpoint of key 2, the second one
+  // succeeds and fetches key 2 only. The splits of key 2 from the other
+  // endpoints are still decrypted in the first listing.
+  auto failure = FailureExecutionResult(SC_UNKNOWN);
+  atomic<bool> failed_once = false;
+  auto responses = CreateUnexpiredKeyFetchingResponseMap();
+  EXPECT_CALL(*mock_private_key_fetcher, FetchPrivateKey)
+      .WillRepeatedly([&](AsyncContext<PrivateKeyFetchingRequest,
+                                       PrivateKeyFetchingResponse>& context) {
+        const auto& endpoint = context.request->key_endpoint->endpoint();
+        const auto& key_id = *context.request->key_id;
+        if (key_id == kTestKeyIds[1] && endpoint == kTestEndpoint1 &&
+            !failed_once.exchange(true)) {
+          context.result = failure;
+        } else {
+          context.result = SuccessExecutionResult();
+          context.response = make_shared<PrivateKeyFetchingResponse>(
+              responses.at(key_id).at(endpoint));
+        }
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  SetMockKmsClient(SuccessExecutionResult(), 8);
+
+  atomic<bool> finished = false;
+  list_request_->add_key_ids(kTestKeyIds[0]);
+  list_request_->add_key_ids(kTestKeyIds[1]);
+  AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse> context(
+      list_request_, [&](AsyncContext<ListPrivateKeysRequest,
+                                      ListPrivateKeysResponse>& context) {
+        EXPECT_THAT(context.result, ResultIs(failure));
+        finished = true;
+      });
+  private_key_client_provider->ListPrivateKeys(context);
+  WaitUntil([&]() { return finished.load(); });
+
+  ListPrivateKeysAndExpect({kTestKeyIds[0], kTestKeyIds[1]},
+                           {kTestKeyIds[0], kTestKeyIds[1]});
+}
+
 class PrivateKeyClientProviderSinglePartyKeyTest : public ScpTestBase {
  protected:
   void SetUp() override {
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/util/time_util.h>
+
+#include "core/utils/src/base64.h"
+#include "cpio/client_providers/private_key_client_provider/src/private_key_client_utils.h"
+#include "public/core/interface/execution_result.h"
+
+using google::cmrt::sdk::private_key_service::v1::PrivateKey;
+using google::protobuf::util::TimeUtil;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::utils::Base64Encode;
+using std::byte;
+using std::make_shared;
+using std::mt19937;
+using std::string;
+using std::vector;
+
+namespace google::scp::cpio::client_providers::test {
+
+// Creates split_count decrypted splits of key_size random bytes each.
+static vector<DecryptResult> CreateDecryptResults(size_t split_count,
+                                                  size_t key_size) {
+  mt19937 random(split_count * key_size);
+  vector<DecryptResult> decrypt_results(split_count);
+  for (auto& decrypt_result : decrypt_results) {
+    decrypt_result.encryption_key.key_id = make_shared<string>("key_id");
+    decrypt_result.encryption_key.public_key_material =
+        make_shared<string>("public_key");
+    decrypt_result.plaintext.resize(key_size);
+    for (auto& c : decrypt_result.plaintext) {
+      c = static_cast<char>(random());
+    }
+  }
+  return decrypt_results;
+}
+
+// Args: split count, key size in bytes.
+static void BM_ConstructPrivateKey(benchmark::State& state) {
+  auto decrypt_results = CreateDecryptResults(state.range(0), state.range(1));
+  for (auto _ : state) {
+    auto private_key_or =
+        PrivateKeyClientUtils::ConstructPrivateKey(decrypt_results);
+    benchmark::DoNotOptimize(private_key_or);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+// The assembly through byte vectors and intermediate strings which
+// ConstructPrivateKey() used before, for comparison.
+static ExecutionResultOr<PrivateKey> ConstructPrivateKeyWithByteVectors(
+    const vector<DecryptResult>& decrypt_results) {
+  auto str_to_bytes = [](const string& str) {
+    vector<byte> bytes;
+    for (char c : str) {
+      bytes.push_back(byte(c));
+    }
+    return bytes;
+  };
+  auto& encryption_key = decrypt_results.at(0).encryption_key;
+  PrivateKey private_key;
+  private_key.set_key_id(*encryption_key.key_id);
+  private_key.set_public_key(*encryption_key.public_key_material);
+  *private_key.mutable_expiration_time() =
+      TimeUtil::MillisecondsToTimestamp(encryption_key.expiration_time_in_ms);
+  *private_key.mutable_creation_time() =
+      TimeUtil::MillisecondsToTimestamp(encryption_key.creation_time_in_ms);
+
+  auto xor_secret = str_to_bytes(decrypt_results.at(0).plaintext);
+  for (size_t i = 1; i < decrypt_results.size(); ++i) {
+    auto next_piece = str_to_bytes(decrypt_results.at(i).plaintext);
+    vector<byte> result;
+    for (size_t j = 0; j < xor_secret.size(); ++j) {
+      result.push_back(xor_secret[j] ^ next_piece[j]);
+    }
+    xor_secret = result;
+  }
+  string key_string(reinterpret_cast<const char*>(&xor_secret[0]),
+                    xor_secret.size());
+  ASSIGN_OR_RETURN(string encoded_key, Base64Encode(key_string));
+  private_key.set_private_key(encoded_key);
+  return private_key;
+}
+
+// Args: split count, key size in bytes.
+static void BM_ConstructPrivateKeyWithByteVectors(benchmark::State& state) {
+  auto decrypt_results = CreateDecryptResults(state.range(0), state.range(1));
+  for (auto _ : state) {
+    auto private_key_or = ConstructPrivateKeyWithByteVectors(decrypt_results);
+    benchmark::DoNotOptimize(private_key_or);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+// Args: split count, key size in bytes.
+static void BM_XorInPlace(benchmark::State& state) {
+  auto decrypt_results = CreateDecryptResults(state.range(0), state.range(1));
+  string buffer(state.range(1), '\0');
+  for (auto _ : state) {
+    for (const auto& decrypt_result : decrypt_results) {
+      PrivateKeyClientUtils::XorInPlace(decrypt_result.plaintext.data(),
+                                        buffer.size(), buffer.data());
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+}  // namespace google::scp::cpio::client_providers::test
+
+// ArgsProduct<Split count, Key size>. A typical multi-party key is a Tink
+// keyset of a few hundred bytes; the large sizes show the throughput of the
+// XOR combine itself.
+BENCHMARK(google::scp::cpio::client_providers::test::BM_ConstructPrivateKey)
+    ->ArgsProduct({{2, 3, 5}, {32, 512, 4096, 65536}});
+
+BENCHMARK(google::scp::cpio::client_providers::test::
+              BM_ConstructPrivateKeyWithByteVectors)
+    ->ArgsProduct({{2, 3, 5}, {32, 512, 4096, 65536}});
+
+BENCHMARK(google::scp::cpio::client_providers::test::BM_XorInPlace)
+    ->ArgsProduct({{2, 5}, {512, 65536}});
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -29,6 +29,7 @@
 #include "core/interface/http_types.h"
 #include "core/test/utils/timestamp_test_utils.h"
 #include "core/utils/src/base64.h"
+#include "core/utils/src/error_codes.h"
 #include "public/core/interface/execution_result.h"
 #include "public/core/test/interface/execution_result_matchers.h"
 
@@ -38,6 +39,7 @@ using google::protobuf::util::TimeUtil;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::SC_CORE_UTILS_INVALID_INPUT;
 using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_CANNOT_READ_ENCRYPTED_KEY_SET;
 using google::scp::core::errors::
@@ -250,6 +252,45 @@ TEST(PrivateKeyClientUtilsTest, ConsturctPrivateKeySuccess) {
   EXPECT_EQ(private_key.private_key(), encoded_key);
 }
 
+TEST(PrivateKeyClientUtilsTest, ConsturctPrivateKeyFromSingleSplit) {
+  vector<DecryptResult> decrypt_results;
+  decrypt_results.emplace_back(CreateDecryptResult("Test message"));
+
+  auto private_key_or =
+      PrivateKeyClientUtils::ConstructPrivateKey(decrypt_results);
+  EXPECT_SUCCESS(private_key_or);
+  EXPECT_EQ(private_key_or->private_key(), *Base64Encode("Test message"));
+}
+
+TEST(PrivateKeyClientUtilsTest, ConsturctPrivateKeyFailedWithEmptySplits) {
+  for (int num_splits : {1, 3}) {
+    vector<DecryptResult> decrypt_results;
+    for (int i = 0; i < num_splits; ++i) {
+      decrypt_results.emplace_back(CreateDecryptResult(""));
+    }
+
+    EXPECT_THAT(
+        PrivateKeyClientUtils::ConstructPrivateKey(decrypt_results),
+        ResultIs(FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT)));
+  }
+}
+
+TEST(PrivateKeyClientUtilsTest, XorInPlaceMatchesBytewiseXor) {
+  // Covers the vector, word and byte loops, and their boundaries.
+  for (size_t size = 0; size <= 67; ++size) {
+    string buffer;
+    string piece;
+    string expected;
+    for (size_t i = 0; i < size; ++i) {
+      buffer.push_back(static_cast<char>(i * 7 + 1));
+      piece.push_back(static_cast<char>(255 - i * 3));
+      expected.push_back(static_cast<char>(buffer[i] ^ piece[i]));
+    }
+    PrivateKeyClientUtils::XorInPlace(piece.data(), size, buffer.data());
+    EXPECT_EQ(buffer, expected) << "size " << size;
+  }
+}
+
 TEST(PrivateKeyClientUtilsTest,
      ConsturctPrivateKeyFailedWithUnmatchedPlaintextSize) {
   vector<DecryptResult> decrypt_results;
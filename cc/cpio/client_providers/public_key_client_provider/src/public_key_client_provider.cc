@@ -16,8 +16,11 @@
 
 #include "public_key_client_provider.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -60,11 +63,15 @@ using google::scp::core::errors::
     SC_PUBLIC_KEY_CLIENT_PROVIDER_INVALID_CONFIG_OPTIONS;
 using std::atomic;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
+using std::min;
 using std::move;
 using std::shared_ptr;
 using std::vector;
 using std::placeholders::_1;
+using std::chrono::seconds;
+using std::chrono::system_clock;
 
 static constexpr char kPublicKeyClientProvider[] = "PublicKeyClientProvider";
 
@@ -96,12 +103,95 @@ ExecutionResult PublicKeyClientProvider::Run() noexcept {
 }
 
 ExecutionResult PublicKeyClientProvider::Stop() noexcept {
+  lock_guard lock(key_cache_mutex_);
+  cached_response_.reset();
   return SuccessExecutionResult();
 }
 
 void PublicKeyClientProvider::ListPublicKeys(
     AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
         public_key_fetching_context) noexcept {
+  if (public_key_client_options_->enable_key_cache) {
+    shared_ptr<const ListPublicKeysResponse> cached_response;
+    auto refresh = false;
+    {
+      auto now = system_clock::now();
+      lock_guard lock(key_cache_mutex_);
+      if (cached_response_ && now < key_cache_expire_time_) {
+        cached_response = cached_response_;
+        if (now >= key_cache_refresh_time_ && !key_cache_refresh_in_flight_) {
+          key_cache_refresh_in_flight_ = true;
+          refresh = true;
+        }
+      }
+    }
+
+    if (cached_response) {
+      public_key_fetching_context.response =
+          make_shared<ListPublicKeysResponse>(*cached_response);
+      public_key_fetching_context.result = SuccessExecutionResult();
+      public_key_fetching_context.Finish();
+      if (refresh) {
+        RefreshPublicKeys(public_key_fetching_context);
+      }
+      return;
+    }
+  }
+
+  // All the listings get the same keys, but the request is still part of the
+  // key in case it gains fields.
+  list_public_keys_single_flight_.Execute(
+      public_key_fetching_context.request->SerializeAsString(),
+      public_key_fetching_context,
+      bind(&PublicKeyClientProvider::FetchPublicKeys, this, _1));
+}
+
+void PublicKeyClientProvider::RefreshPublicKeys(
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+        public_key_fetching_context) noexcept {
+  AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> refresh_context(
+      public_key_fetching_context.request,
+      bind(&PublicKeyClientProvider::OnRefreshPublicKeysCallback, this, _1),
+      public_key_fetching_context);
+  // Listings which miss the cache in the meantime join the refresh.
+  list_public_keys_single_flight_.Execute(
+      refresh_context.request->SerializeAsString(), refresh_context,
+      bind(&PublicKeyClientProvider::FetchPublicKeys, this, _1));
+}
+
+void PublicKeyClientProvider::OnRefreshPublicKeysCallback(
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+        refresh_context) noexcept {
+  // On failure, the cached keys are still served until they expire, and the
+  // next listing retries the refresh.
+  lock_guard lock(key_cache_mutex_);
+  key_cache_refresh_in_flight_ = false;
+}
+
+void PublicKeyClientProvider::CachePublicKeys(
+    const ListPublicKeysResponse& response,
+    uint64_t expired_time_in_s) noexcept {
+  auto now = system_clock::now();
+  auto expire_time = system_clock::time_point(seconds(expired_time_in_s));
+  if (expire_time <= now) {
+    return;
+  }
+  // Short-lived keys are refreshed halfway through their life at the latest,
+  // so that not every listing triggers a refresh.
+  auto refresh_ahead = min<system_clock::duration>(
+      seconds(public_key_client_options_->key_cache_refresh_ahead_in_s),
+      (expire_time - now) / 2);
+  auto cached_response = make_shared<const ListPublicKeysResponse>(response);
+
+  lock_guard lock(key_cache_mutex_);
+  cached_response_ = move(cached_response);
+  key_cache_expire_time_ = expire_time;
+  key_cache_refresh_time_ = expire_time - refresh_ahead;
+}
+
+void PublicKeyClientProvider::FetchPublicKeys(
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+        public_key_fetching_context) noexcept {
   // Use got_success_result and unfinished_counter to track whether get success
   // response and how many failed responses. Only return one response whether
   // success or failed.
@@ -201,6 +291,9 @@ void PublicKeyClientProvider::OnPerformRequestCallback(
         TimeUtil::SecondsToTimestamp(expired_time_in_s);
     public_key_fetching_context.response->mutable_public_keys()->Add(
         public_keys.begin(), public_keys.end());
+    if (public_key_client_options_->enable_key_cache) {
+      CachePublicKeys(*public_key_fetching_context.response, expired_time_in_s);
+    }
     public_key_fetching_context.result = SuccessExecutionResult();
     public_key_fetching_context.Finish();
   }
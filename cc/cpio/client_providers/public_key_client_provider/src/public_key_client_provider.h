@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 
+#include "core/common/single_flight/src/single_flight.h"
 #include "core/interface/async_context.h"
 #include "core/interface/http_client_interface.h"
 #include "core/interface/http_types.h"
@@ -54,6 +58,53 @@ class PublicKeyClientProvider : public PublicKeyClientProviderInterface {
           context) noexcept override;
 
  protected:
+  /**
+   * @brief Fetches the public keys from all the endpoints. Concurrent listings
+   * are collapsed into one call to this.
+   *
+   * @param public_key_fetching_context public key fetching context.
+   */
+  void FetchPublicKeys(
+      core::AsyncContext<
+          cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+          cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>&
+          public_key_fetching_context) noexcept;
+
+  /**
+   * @brief Fetches the public keys in the background to replace the cached
+   * ones before they expire.
+   *
+   * @param public_key_fetching_context the listing that found the cached keys
+   * due for a refresh.
+   */
+  void RefreshPublicKeys(
+      core::AsyncContext<
+          cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+          cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>&
+          public_key_fetching_context) noexcept;
+
+  /**
+   * @brief Is called when a background refresh is completed.
+   *
+   * @param refresh_context the context of the refresh.
+   */
+  void OnRefreshPublicKeysCallback(
+      core::AsyncContext<
+          cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+          cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>&
+          refresh_context) noexcept;
+
+  /**
+   * @brief Caches the fetched public keys until the expiration time advertised
+   * by the endpoint. Keys which have already expired are not cached.
+   *
+   * @param response the fetched public keys.
+   * @param expired_time_in_s the expiration time in seconds since the epoch.
+   */
+  void CachePublicKeys(
+      const cmrt::sdk::public_key_service::v1::ListPublicKeysResponse& response,
+      uint64_t expired_time_in_s) noexcept;
+
   /**
    * @brief Is called after http client PerformRequest() is completed.
    *
@@ -77,5 +128,23 @@ class PublicKeyClientProvider : public PublicKeyClientProviderInterface {
 
   /// Configurations for PublicKeyClient.
   std::shared_ptr<PublicKeyClientOptions> public_key_client_options_;
+
+  /// Collapses concurrent listings of the public keys.
+  core::common::SingleFlight<
+      cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+      cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>
+      list_public_keys_single_flight_;
+
+  std::mutex key_cache_mutex_;
+  /// The cached public keys. Null when nothing is cached.
+  std::shared_ptr<
+      const cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>
+      cached_response_;
+  /// When the cached keys stop being served.
+  std::chrono::system_clock::time_point key_cache_expire_time_;
+  /// When listings start to refresh the cached keys.
+  std::chrono::system_clock::time_point key_cache_refresh_time_;
+  /// Whether a background refresh is in flight.
+  bool key_cache_refresh_in_flight_ = false;
 };
 }  // namespace google::scp::cpio::client_providers
@@ -14,9 +14,14 @@
 
 #include "cpio/client_providers/public_key_client_provider/src/public_key_client_provider.h"
 
+#include <time.h>
+
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "core/http2_client/mock/mock_http_client.h"
 #include "core/interface/async_context.h"
@@ -50,12 +55,15 @@ using google::scp::core::test::ResultIs;
 using google::scp::core::test::ScpTestBase;
 using google::scp::core::test::WaitUntil;
 using std::atomic;
+using std::lock_guard;
 using std::make_shared;
 using std::make_unique;
 using std::move;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
+using std::chrono::system_clock;
 
 static constexpr char kPublicKeyHeaderDate[] = "date";
 static constexpr char kPublicKeyHeaderCacheControl[] = "cache-control";
@@ -67,6 +75,28 @@ static constexpr uint64_t kExpectedExpiredTimeInSeconds = 1668811806;
 
 namespace google::scp::cpio::client_providers::test {
 
+class TestPublicKeyClientProvider : public PublicKeyClientProvider {
+ public:
+  using PublicKeyClientProvider::PublicKeyClientProvider;
+
+  /// Makes the cached keys due for a refresh.
+  void MakeKeyCacheDueForRefresh() {
+    lock_guard lock(key_cache_mutex_);
+    key_cache_refresh_time_ = system_clock::now();
+  }
+};
+
+/// Formats the current time like the date header of the endpoints.
+static string GetCurrentHeaderDate() {
+  auto now = time(nullptr);
+  tm time_date = {};
+  // ParseExpiredTimeFromHeaders() reads the date as local time.
+  localtime_r(&now, &time_date);
+  char buffer[64];
+  strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &time_date);
+  return buffer;
+}
+
 TEST(PublicKeyClientProviderTestI, InitFailedWithInvalidConfig) {
   auto http_client = make_shared<MockHttpClient>();
 
@@ -101,17 +131,17 @@ class PublicKeyClientProviderTestII : public ScpTestBase {
     public_key_client_options->endpoints.emplace_back(kPrivateKeyBaseUri1);
     public_key_client_options->endpoints.emplace_back(kPrivateKeyBaseUri2);
 
-    public_key_client_ = make_unique<PublicKeyClientProvider>(
+    public_key_client_ = make_unique<TestPublicKeyClientProvider>(
         public_key_client_options, http_client_);
 
     EXPECT_SUCCESS(public_key_client_->Init());
     EXPECT_SUCCESS(public_key_client_->Run());
   }
 
-  HttpResponse GetValidHttpResponse() {
+  HttpResponse GetValidHttpResponse(const string& date = kHeaderDateExample) {
     HttpResponse response;
     HttpHeaders headers;
-    headers.insert({kPublicKeyHeaderDate, kHeaderDateExample});
+    headers.insert({kPublicKeyHeaderDate, date});
     headers.insert({kPublicKeyHeaderCacheControl, kCacheControlExample});
     response.headers = make_shared<HttpHeaders>(headers);
 
@@ -132,7 +162,7 @@ class PublicKeyClientProviderTestII : public ScpTestBase {
   }
 
   shared_ptr<MockHttpClient> http_client_;
-  unique_ptr<PublicKeyClientProvider> public_key_client_;
+  unique_ptr<TestPublicKeyClientProvider> public_key_client_;
 };
 
 TEST_F(PublicKeyClientProviderTestII, ListPublicKeysSuccess) {
@@ -270,4 +300,180 @@ TEST_F(PublicKeyClientProviderTestII, ListPublicKeysPartialUriSuccess) {
   WaitUntil([&]() { return perform_calls.load() == 2; });
 }
 
+TEST_F(PublicKeyClientProviderTestII, ConcurrentListingsShareRequests) {
+  atomic<int> perform_calls(0);
+  vector<AsyncContext<HttpRequest, HttpResponse>> http_contexts;
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        perform_calls++;
+        http_contexts.push_back(http_context);
+        return SuccessExecutionResult();
+      };
+
+  atomic<int> success_callback(0);
+  for (int i = 0; i < 3; ++i) {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          EXPECT_EQ(context.response->public_keys().size(), 2);
+          success_callback++;
+        });
+    public_key_client_->ListPublicKeys(context);
+  }
+  // Only the first listing requests the endpoints.
+  EXPECT_EQ(perform_calls.load(), 2);
+  EXPECT_EQ(success_callback.load(), 0);
+
+  auto success_response = GetValidHttpResponse();
+  for (auto& http_context : http_contexts) {
+    http_context.response = make_shared<HttpResponse>(success_response);
+    http_context.result = SuccessExecutionResult();
+    http_context.Finish();
+  }
+  EXPECT_EQ(success_callback.load(), 3);
+}
+
+TEST_F(PublicKeyClientProviderTestII, CachesKeysUntilExpiry) {
+  atomic<int> perform_calls(0);
+  auto success_response = GetValidHttpResponse(GetCurrentHeaderDate());
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        perform_calls++;
+        http_context.response = make_shared<HttpResponse>(success_response);
+        http_context.result = SuccessExecutionResult();
+        http_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  atomic<int> success_callback(0);
+  for (int i = 0; i < 3; ++i) {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          EXPECT_EQ(context.response->public_keys().size(), 2);
+          EXPECT_EQ(context.response->public_keys()[0].key_id(), "1234");
+          success_callback++;
+        });
+    public_key_client_->ListPublicKeys(context);
+  }
+  EXPECT_EQ(success_callback.load(), 3);
+  // Only the first listing requests the endpoints.
+  EXPECT_EQ(perform_calls.load(), 2);
+}
+
+TEST_F(PublicKeyClientProviderTestII, ExpiredKeysAreNotCached) {
+  atomic<int> perform_calls(0);
+  // The example date is long past.
+  auto success_response = GetValidHttpResponse();
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        perform_calls++;
+        http_context.response = make_shared<HttpResponse>(success_response);
+        http_context.result = SuccessExecutionResult();
+        http_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  atomic<int> success_callback(0);
+  for (int i = 0; i < 2; ++i) {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          success_callback++;
+        });
+    public_key_client_->ListPublicKeys(context);
+  }
+  EXPECT_EQ(success_callback.load(), 2);
+  EXPECT_EQ(perform_calls.load(), 4);
+}
+
+TEST_F(PublicKeyClientProviderTestII, RefreshesKeysInBackgroundBeforeExpiry) {
+  vector<AsyncContext<HttpRequest, HttpResponse>> http_contexts;
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        http_contexts.push_back(http_context);
+        return SuccessExecutionResult();
+      };
+  auto finish_http_contexts = [&]() {
+    auto success_response = GetValidHttpResponse(GetCurrentHeaderDate());
+    for (auto& http_context : http_contexts) {
+      http_context.response = make_shared<HttpResponse>(success_response);
+      http_context.result = SuccessExecutionResult();
+      http_context.Finish();
+    }
+    http_contexts.clear();
+  };
+
+  atomic<int> success_callback(0);
+  auto list_public_keys = [&]() {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          EXPECT_EQ(context.response->public_keys().size(), 2);
+          success_callback++;
+        });
+    public_key_client_->ListPublicKeys(context);
+  };
+
+  list_public_keys();
+  finish_http_contexts();
+  EXPECT_EQ(success_callback.load(), 1);
+
+  public_key_client_->MakeKeyCacheDueForRefresh();
+  // Both listings are served from the cache, but only the first one starts a
+  // refresh.
+  list_public_keys();
+  list_public_keys();
+  EXPECT_EQ(success_callback.load(), 3);
+  EXPECT_EQ(http_contexts.size(), 2);
+
+  finish_http_contexts();
+  // The refreshed keys are not due for a refresh yet.
+  list_public_keys();
+  EXPECT_EQ(success_callback.load(), 4);
+  EXPECT_EQ(http_contexts.size(), 0);
+}
+
+TEST_F(PublicKeyClientProviderTestII, DisabledCacheAlwaysFetches) {
+  auto public_key_client_options = make_shared<PublicKeyClientOptions>();
+  public_key_client_options->endpoints.emplace_back(kPrivateKeyBaseUri1);
+  public_key_client_options->enable_key_cache = false;
+  PublicKeyClientProvider public_key_client(public_key_client_options,
+                                            http_client_);
+  EXPECT_SUCCESS(public_key_client.Init());
+
+  atomic<int> perform_calls(0);
+  auto success_response = GetValidHttpResponse(GetCurrentHeaderDate());
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        perform_calls++;
+        http_context.response = make_shared<HttpResponse>(success_response);
+        http_context.result = SuccessExecutionResult();
+        http_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  atomic<int> success_callback(0);
+  for (int i = 0; i < 2; ++i) {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          success_callback++;
+        });
+    public_key_client.ListPublicKeys(context);
+  }
+  EXPECT_EQ(success_callback.load(), 2);
+  EXPECT_EQ(perform_calls.load(), 2);
+}
+
 }  // namespace google::scp::cpio::client_providers::test
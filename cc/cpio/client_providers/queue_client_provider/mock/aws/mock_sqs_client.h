@@ -21,11 +21,14 @@
 #include <memory>
 
 #include <aws/sqs/SQSClient.h>
+#include <aws/sqs/model/ChangeMessageVisibilityBatchRequest.h>
 #include <aws/sqs/model/ChangeMessageVisibilityRequest.h>
 #include <aws/sqs/model/CreateQueueRequest.h>
+#include <aws/sqs/model/DeleteMessageBatchRequest.h>
 #include <aws/sqs/model/DeleteMessageRequest.h>
 #include <aws/sqs/model/GetQueueUrlRequest.h>
 #include <aws/sqs/model/ReceiveMessageRequest.h>
+#include <aws/sqs/model/SendMessageBatchRequest.h>
 #include <aws/sqs/model/SendMessageRequest.h>
 
 namespace google::scp::cpio::client_providers::mock {
@@ -41,6 +44,11 @@ class MockSqsClient : public Aws::SQS::SQSClient {
                const Aws::SQS::SendMessageResponseReceivedHandler&,
                const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
               (const, override));
+  MOCK_METHOD(void, SendMessageBatchAsync,
+              (const Aws::SQS::Model::SendMessageBatchRequest&,
+               const Aws::SQS::SendMessageBatchResponseReceivedHandler&,
+               const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
+              (const, override));
   MOCK_METHOD(void, ReceiveMessageAsync,
               (const Aws::SQS::Model::ReceiveMessageRequest&,
                const Aws::SQS::ReceiveMessageResponseReceivedHandler&,
@@ -51,11 +59,22 @@ class MockSqsClient : public Aws::SQS::SQSClient {
                const Aws::SQS::ChangeMessageVisibilityResponseReceivedHandler&,
                const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
               (const, override));
+  MOCK_METHOD(
+      void, ChangeMessageVisibilityBatchAsync,
+      (const Aws::SQS::Model::ChangeMessageVisibilityBatchRequest&,
+       const Aws::SQS::ChangeMessageVisibilityBatchResponseReceivedHandler&,
+       const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
+      (const, override));
   MOCK_METHOD(void, DeleteMessageAsync,
               (const Aws::SQS::Model::DeleteMessageRequest&,
                const Aws::SQS::DeleteMessageResponseReceivedHandler&,
                const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
               (const, override));
+  MOCK_METHOD(void, DeleteMessageBatchAsync,
+              (const Aws::SQS::Model::DeleteMessageBatchRequest&,
+               const Aws::SQS::DeleteMessageBatchResponseReceivedHandler&,
+               const std::shared_ptr<const Aws::Client::AsyncCallerContext>&),
+              (const, override));
 };
 
 }  // namespace google::scp::cpio::client_providers::mock
@@ -38,12 +38,24 @@ class MockQueueClientProvider : public QueueClientProviderInterface {
                   cmrt::sdk::queue_service::v1::EnqueueMessageResponse>&)),
               (noexcept, override));
 
+  MOCK_METHOD(void, EnqueueMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                  cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&)),
+              (noexcept, override));
+
   MOCK_METHOD(void, GetTopMessage,
               ((core::AsyncContext<
                   cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                   cmrt::sdk::queue_service::v1::GetTopMessageResponse>&)),
               (noexcept, override));
 
+  MOCK_METHOD(void, GetTopMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                  cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&)),
+              (noexcept, override));
+
   MOCK_METHOD(
       void, UpdateMessageVisibilityTimeout,
       ((core::AsyncContext<
@@ -57,6 +69,12 @@ class MockQueueClientProvider : public QueueClientProviderInterface {
                   cmrt::sdk::queue_service::v1::DeleteMessageRequest,
                   cmrt::sdk::queue_service::v1::DeleteMessageResponse>&)),
               (noexcept, override));
+
+  MOCK_METHOD(void, DeleteMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                  cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&)),
+              (noexcept, override));
 };
 
 }  // namespace google::scp::cpio::client_providers::mock
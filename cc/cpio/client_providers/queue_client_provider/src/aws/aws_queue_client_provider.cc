@@ -16,12 +16,20 @@
 
 #include "aws_queue_client_provider.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include <aws/sqs/model/ChangeMessageVisibilityBatchRequest.h>
 #include <aws/sqs/model/ChangeMessageVisibilityRequest.h>
+#include <aws/sqs/model/DeleteMessageBatchRequest.h>
 #include <aws/sqs/model/DeleteMessageRequest.h>
 #include <aws/sqs/model/GetQueueUrlRequest.h>
 #include <aws/sqs/model/ReceiveMessageRequest.h>
+#include <aws/sqs/model/SendMessageBatchRequest.h>
 #include <aws/sqs/model/SendMessageRequest.h>
 
 #include "aws/sqs/SQSClient.h"
@@ -40,21 +48,38 @@ using Aws::Client::AsyncCallerContext;
 using Aws::Client::ClientConfiguration;
 using Aws::SQS::SQSClient;
 using Aws::SQS::SQSErrors;
+using Aws::SQS::Model::ChangeMessageVisibilityBatchOutcome;
+using Aws::SQS::Model::ChangeMessageVisibilityBatchRequest;
+using Aws::SQS::Model::ChangeMessageVisibilityBatchRequestEntry;
 using Aws::SQS::Model::ChangeMessageVisibilityOutcome;
 using Aws::SQS::Model::ChangeMessageVisibilityRequest;
+using Aws::SQS::Model::DeleteMessageBatchOutcome;
+using Aws::SQS::Model::DeleteMessageBatchRequest;
+using Aws::SQS::Model::DeleteMessageBatchRequestEntry;
 using Aws::SQS::Model::DeleteMessageOutcome;
 using Aws::SQS::Model::GetQueueUrlRequest;
+using Aws::SQS::Model::Message;
 using Aws::SQS::Model::QueueAttributeName;
 using Aws::SQS::Model::ReceiveMessageOutcome;
 using Aws::SQS::Model::ReceiveMessageRequest;
+using Aws::SQS::Model::SendMessageBatchOutcome;
+using Aws::SQS::Model::SendMessageBatchRequest;
+using Aws::SQS::Model::SendMessageBatchRequestEntry;
 using Aws::SQS::Model::SendMessageOutcome;
 using Aws::SQS::Model::SendMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
+using google::cmrt::sdk::queue_service::v1::QueueMessage;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -67,6 +92,12 @@ using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::async_executor::aws::AwsAsyncExecutor;
 using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES;
 using google::scp::core::errors::SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY;
@@ -84,12 +115,18 @@ using google::scp::core::errors::
     SC_AWS_QUEUE_CLIENT_PROVIDER_QUEUE_NAME_REQUIRED;
 using google::scp::cpio::client_providers::AwsInstanceClientUtils;
 using google::scp::cpio::common::CreateClientConfiguration;
+using std::atomic;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
 using std::move;
+using std::mutex;
 using std::shared_ptr;
 using std::string;
 using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -99,6 +136,31 @@ static constexpr char kAwsQueueClientProvider[] = "AwsQueueClientProvider";
 static const uint8_t kMaxNumberOfMessagesReceived = 1;
 static const uint8_t kMaxWaitTimeSeconds = 0;
 static const uint16_t kMaxVisibilityTimeoutSeconds = 600;
+// The most messages SQS receives, sends, deletes, or changes the visibility
+// of, at once.
+static const uint8_t kMaxNumberOfMessagesPerBatch = 10;
+// The longest SQS waits for messages to arrive before returning none.
+static const uint8_t kLongPollWaitTimeSeconds = 20;
+// Leaves half a lease for a lease extension to get through.
+static const uint16_t kMinPrefetchLeaseDurationSeconds = 10;
+
+namespace {
+QueueMessage ToQueueMessage(const Message& message) {
+  QueueMessage queue_message;
+  queue_message.set_message_id(message.GetMessageId().c_str());
+  queue_message.set_message_body(message.GetBody().c_str());
+  queue_message.set_receipt_info(message.GetReceiptHandle().c_str());
+  return queue_message;
+}
+
+/// Collects the results of the batches of a visibility change.
+struct VisibilityChangeBatches {
+  vector<string> receipt_infos;
+  mutex batches_mutex;
+  size_t pending_batches = 0;
+  vector<string> changed_receipt_infos;
+};
+}  // namespace
 
 namespace google::scp::cpio::client_providers {
 ExecutionResult AwsQueueClientProvider::Init() noexcept {
@@ -123,6 +185,18 @@ ExecutionResult AwsQueueClientProvider::Run() noexcept {
     return execution_result;
   }
 
+  const auto& lease_duration = queue_client_options_->prefetch_lease_duration;
+  if (queue_client_options_->prefetch_buffer_size > 0 &&
+      (lease_duration < seconds(kMinPrefetchLeaseDurationSeconds) ||
+       lease_duration > seconds(kMaxVisibilityTimeoutSeconds))) {
+    execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT);
+    SCP_ERROR(kAwsQueueClientProvider, kZeroUuid, execution_result,
+              "Invalid prefetch lease duration %lld.",
+              static_cast<long long>(lease_duration.count()));
+    return execution_result;
+  }
+
   auto client_config_or = CreateClientConfiguration();
   if (!client_config_or.Successful()) {
     execution_result = client_config_or.result();
@@ -142,6 +216,34 @@ ExecutionResult AwsQueueClientProvider::Run() noexcept {
   }
   queue_url_ = move(*queue_url_or);
 
+  if (queue_client_options_->prefetch_buffer_size > 0) {
+    message_prefetcher_ = make_shared<QueueMessagePrefetcher>(
+        queue_client_options_->prefetch_buffer_size, lease_duration,
+        bind(&AwsQueueClientProvider::ReceivePrefetchedMessages, this, _1, _2,
+             _3),
+        bind(&AwsQueueClientProvider::ChangePrefetchedMessagesVisibility, this,
+             _1, _2, _3),
+        cpu_async_executor_);
+    execution_result = message_prefetcher_->Run();
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+
+  const auto& linger_duration = queue_client_options_->batch_linger_duration;
+  if (linger_duration > milliseconds(0)) {
+    enqueue_batcher_ = make_shared<QueueMessageBatcher>(
+        kMaxNumberOfMessagesPerBatch, linger_duration,
+        QueueMessageBatcher::FlushWithEnqueueMessages(
+            bind(&AwsQueueClientProvider::EnqueueMessages, this, _1)),
+        cpu_async_executor_);
+    delete_batcher_ = make_shared<QueueMessageBatcher>(
+        kMaxNumberOfMessagesPerBatch, linger_duration,
+        QueueMessageBatcher::FlushWithDeleteMessages(
+            bind(&AwsQueueClientProvider::DeleteMessages, this, _1)),
+        cpu_async_executor_);
+  }
+
   return execution_result;
 }
 
@@ -182,6 +284,16 @@ ExecutionResultOr<string> AwsQueueClientProvider::GetQueueUrl() noexcept {
 }
 
 ExecutionResult AwsQueueClientProvider::Stop() noexcept {
+  // The pending batches are sent before the client goes away.
+  if (enqueue_batcher_) {
+    enqueue_batcher_->Stop();
+  }
+  if (delete_batcher_) {
+    delete_batcher_->Stop();
+  }
+  if (message_prefetcher_) {
+    return message_prefetcher_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -200,6 +312,22 @@ void AwsQueueClientProvider::EnqueueMessage(
     return;
   }
 
+  if (enqueue_batcher_) {
+    enqueue_batcher_->Add(
+        message_body, [this, enqueue_message_context](
+                          ExecutionResultOr<string> message_id_or) mutable {
+          if (message_id_or.Successful()) {
+            enqueue_message_context.response =
+                make_shared<EnqueueMessageResponse>();
+            enqueue_message_context.response->set_message_id(
+                move(*message_id_or));
+          }
+          FinishContext(message_id_or.result(), enqueue_message_context,
+                        cpu_async_executor_);
+        });
+    return;
+  }
+
   SendMessageRequest send_message_request;
   send_message_request.SetQueueUrl(queue_url_.c_str());
   send_message_request.SetMessageBody(message_body.c_str());
@@ -237,9 +365,139 @@ void AwsQueueClientProvider::OnSendMessageCallback(
   FinishContext(execution_result, enqueue_message_context, cpu_async_executor_);
 }
 
+void AwsQueueClientProvider::EnqueueMessages(
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+        enqueue_messages_context) noexcept {
+  const auto& message_bodies =
+      enqueue_messages_context.request->message_bodies();
+  for (const auto& message_body : message_bodies) {
+    if (message_body.empty()) {
+      auto execution_result =
+          FailureExecutionResult(SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE);
+      SCP_ERROR_CONTEXT(kAwsQueueClientProvider, enqueue_messages_context,
+                        execution_result,
+                        "Failed to send messages due to missing message body");
+      enqueue_messages_context.result = execution_result;
+      enqueue_messages_context.Finish();
+      return;
+    }
+  }
+
+  // Each message fails unless SQS reports it sent.
+  auto response = make_shared<EnqueueMessagesResponse>();
+  auto entry_failed_result =
+      FailureExecutionResult(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED)
+          .ToProto();
+  for (int i = 0; i < message_bodies.size(); ++i) {
+    *response->add_message_results()->mutable_result() = entry_failed_result;
+  }
+  enqueue_messages_context.response = move(response);
+
+  auto pending_batches = make_shared<atomic<size_t>>(
+      (message_bodies.size() + kMaxNumberOfMessagesPerBatch - 1) /
+      kMaxNumberOfMessagesPerBatch);
+  if (*pending_batches == 0) {
+    FinishContext(SuccessExecutionResult(), enqueue_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  for (int begin = 0; begin < message_bodies.size();
+       begin += kMaxNumberOfMessagesPerBatch) {
+    auto end = std::min<int>(message_bodies.size(),
+                             begin + kMaxNumberOfMessagesPerBatch);
+    SendMessageBatchRequest send_message_batch_request;
+    send_message_batch_request.SetQueueUrl(queue_url_.c_str());
+    // The entry ID is the index of the message.
+    for (auto i = begin; i < end; ++i) {
+      SendMessageBatchRequestEntry entry;
+      entry.SetId(to_string(i).c_str());
+      entry.SetMessageBody(message_bodies[i].c_str());
+      send_message_batch_request.AddEntries(move(entry));
+    }
+
+    sqs_client_->SendMessageBatchAsync(
+        send_message_batch_request,
+        bind(&AwsQueueClientProvider::OnSendMessageBatchCallback, this,
+             enqueue_messages_context, pending_batches, _1, _2, _3, _4),
+        nullptr);
+  }
+}
+
+void AwsQueueClientProvider::OnSendMessageBatchCallback(
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+        enqueue_messages_context,
+    const shared_ptr<atomic<size_t>>& pending_batches,
+    const SQSClient* sqs_client,
+    const SendMessageBatchRequest& send_message_batch_request,
+    SendMessageBatchOutcome send_message_batch_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  auto& message_results =
+      *enqueue_messages_context.response->mutable_message_results();
+  if (!send_message_batch_outcome.IsSuccess()) {
+    auto error_type = send_message_batch_outcome.GetError().GetErrorType();
+    auto error_message =
+        send_message_batch_outcome.GetError().GetMessage().c_str();
+    auto execution_result = SqsErrorConverter::ConvertSqsError(error_type);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, enqueue_messages_context, execution_result,
+        "Failed to send message batch due to AWS SQS service error. Error "
+        "code: %d, error message: %s",
+        error_type, error_message);
+    for (const auto& entry : send_message_batch_request.GetEntries()) {
+      auto index = std::strtoul(entry.GetId().c_str(), nullptr, 10);
+      if (index < static_cast<size_t>(message_results.size())) {
+        *message_results[index].mutable_result() = execution_result.ToProto();
+      }
+    }
+  } else {
+    const auto& result = send_message_batch_outcome.GetResult();
+    for (const auto& entry : result.GetSuccessful()) {
+      auto index = std::strtoul(entry.GetId().c_str(), nullptr, 10);
+      if (index < static_cast<size_t>(message_results.size())) {
+        *message_results[index].mutable_result() =
+            SuccessExecutionResult().ToProto();
+        message_results[index].set_message_id(entry.GetMessageId().c_str());
+      }
+    }
+    auto entry_failed_result =
+        FailureExecutionResult(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED);
+    for (const auto& entry : result.GetFailed()) {
+      SCP_ERROR_CONTEXT(kAwsQueueClientProvider, enqueue_messages_context,
+                        entry_failed_result,
+                        "Failed to send message %s of the batch. Error "
+                        "code: %s, error message: %s",
+                        entry.GetId().c_str(), entry.GetCode().c_str(),
+                        entry.GetMessage().c_str());
+    }
+  }
+
+  // The results of all the batches are in once the last one is done.
+  if (pending_batches->fetch_sub(1) == 1) {
+    FinishContext(SuccessExecutionResult(), enqueue_messages_context,
+                  cpu_async_executor_);
+  }
+}
+
 void AwsQueueClientProvider::GetTopMessage(
     AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
         get_top_message_context) noexcept {
+  // Falls back to receiving directly while the prefetch buffer is empty.
+  if (message_prefetcher_) {
+    auto messages = message_prefetcher_->TakeMessages(1);
+    if (!messages.empty()) {
+      auto& message = messages[0];
+      auto response = make_shared<GetTopMessageResponse>();
+      response->set_message_id(move(*message.mutable_message_id()));
+      response->set_message_body(move(*message.mutable_message_body()));
+      response->set_receipt_info(move(*message.mutable_receipt_info()));
+      get_top_message_context.response = move(response);
+      FinishContext(SuccessExecutionResult(), get_top_message_context,
+                    cpu_async_executor_);
+      return;
+    }
+  }
+
   ReceiveMessageRequest receive_message_request;
   receive_message_request.SetQueueUrl(queue_url_.c_str());
   receive_message_request.SetMaxNumberOfMessages(kMaxNumberOfMessagesReceived);
@@ -325,6 +583,256 @@ void AwsQueueClientProvider::OnReceiveMessageCallback(
   FinishContext(execution_result, get_top_message_context, cpu_async_executor_);
 }
 
+void AwsQueueClientProvider::GetTopMessages(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  const auto max_messages = get_top_messages_context.request->max_messages();
+  if (max_messages < 1 || max_messages > kMaxNumberOfMessagesPerBatch) {
+    auto execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES);
+    SCP_ERROR_CONTEXT(kAwsQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "Failed to get top messages due to invalid max messages "
+                      "%d",
+                      max_messages);
+    get_top_messages_context.result = execution_result;
+    get_top_messages_context.Finish();
+    return;
+  }
+
+  // Falls back to receiving directly while the prefetch buffer is empty.
+  if (message_prefetcher_) {
+    auto messages = message_prefetcher_->TakeMessages(max_messages);
+    if (!messages.empty()) {
+      auto response = make_shared<GetTopMessagesResponse>();
+      for (auto& message : messages) {
+        *response->add_messages() = move(message);
+      }
+      get_top_messages_context.response = move(response);
+      FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                    cpu_async_executor_);
+      return;
+    }
+  }
+
+  ReceiveMessageRequest receive_message_request;
+  receive_message_request.SetQueueUrl(queue_url_.c_str());
+  receive_message_request.SetMaxNumberOfMessages(max_messages);
+  receive_message_request.SetWaitTimeSeconds(kMaxWaitTimeSeconds);
+  sqs_client_->ReceiveMessageAsync(
+      receive_message_request,
+      bind(&AwsQueueClientProvider::OnReceiveMessagesCallback, this,
+           get_top_messages_context, _1, _2, _3, _4),
+      nullptr);
+}
+
+void AwsQueueClientProvider::OnReceiveMessagesCallback(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context,
+    const SQSClient* sqs_client,
+    const ReceiveMessageRequest& receive_message_request,
+    ReceiveMessageOutcome receive_message_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  auto execution_result = SuccessExecutionResult();
+  if (!receive_message_outcome.IsSuccess()) {
+    auto error_type = receive_message_outcome.GetError().GetErrorType();
+    auto error_message =
+        receive_message_outcome.GetError().GetMessage().c_str();
+    execution_result = SqsErrorConverter::ConvertSqsError(error_type);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, get_top_messages_context, execution_result,
+        "Failed to receive messages due to AWS SQS service error. Error "
+        "code: %d, error message: %s",
+        error_type, error_message);
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  const auto& messages = receive_message_outcome.GetResult().GetMessages();
+
+  // This should never happen.
+  if (messages.size() >
+      static_cast<size_t>(get_top_messages_context.request->max_messages())) {
+    execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, get_top_messages_context, execution_result,
+        "The number of messages received from the queue is higher "
+        "than the maximum number. Messages count: %d",
+        messages.size());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  if (messages.size() == 0) {
+    execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED);
+    SCP_ERROR_CONTEXT(kAwsQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "No messages are returned from the SQS. Queue Name: %s",
+                      queue_client_options_->queue_name.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  auto response = make_shared<GetTopMessagesResponse>();
+  for (const auto& message : messages) {
+    // Messages without a body are left to become visible again.
+    if (message.GetBody().empty()) {
+      SCP_WARNING_CONTEXT(kAwsQueueClientProvider, get_top_messages_context,
+                          "Skipped message %s without message body.",
+                          message.GetMessageId().c_str());
+      continue;
+    }
+    *response->add_messages() = ToQueueMessage(message);
+  }
+
+  if (response->messages_size() == 0) {
+    execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY);
+    SCP_ERROR_CONTEXT(kAwsQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "The message body in the messages receiving from SQS is "
+                      "empty. Queue Name: %s",
+                      queue_client_options_->queue_name.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  get_top_messages_context.response = move(response);
+  FinishContext(execution_result, get_top_messages_context,
+                cpu_async_executor_);
+}
+
+void AwsQueueClientProvider::ReceivePrefetchedMessages(
+    size_t max_messages, seconds visibility_timeout,
+    QueueMessagePrefetcher::ReceiveMessagesCallback callback) noexcept {
+  ReceiveMessageRequest receive_message_request;
+  receive_message_request.SetQueueUrl(queue_url_.c_str());
+  receive_message_request.SetMaxNumberOfMessages(
+      std::min<size_t>(max_messages, kMaxNumberOfMessagesPerBatch));
+  receive_message_request.SetWaitTimeSeconds(kLongPollWaitTimeSeconds);
+  receive_message_request.SetVisibilityTimeout(visibility_timeout.count());
+  sqs_client_->ReceiveMessageAsync(
+      receive_message_request,
+      [callback](const SQSClient* sqs_client,
+                 const ReceiveMessageRequest& receive_message_request,
+                 const ReceiveMessageOutcome& receive_message_outcome,
+                 const shared_ptr<const AsyncCallerContext>& async_context) {
+        if (!receive_message_outcome.IsSuccess()) {
+          auto error_type = receive_message_outcome.GetError().GetErrorType();
+          auto execution_result =
+              SqsErrorConverter::ConvertSqsError(error_type);
+          SCP_ERROR(kAwsQueueClientProvider, kZeroUuid, execution_result,
+                    "Failed to prefetch messages due to AWS SQS service "
+                    "error. Error code: %d, error message: %s",
+                    error_type,
+                    receive_message_outcome.GetError().GetMessage().c_str());
+          callback(execution_result);
+          return;
+        }
+
+        vector<QueueMessage> messages;
+        for (const auto& message :
+             receive_message_outcome.GetResult().GetMessages()) {
+          if (message.GetBody().empty()) {
+            SCP_WARNING(kAwsQueueClientProvider, kZeroUuid,
+                        "Skipped message %s without message body.",
+                        message.GetMessageId().c_str());
+            continue;
+          }
+          messages.push_back(ToQueueMessage(message));
+        }
+        callback(move(messages));
+      },
+      nullptr);
+}
+
+void AwsQueueClientProvider::ChangePrefetchedMessagesVisibility(
+    const vector<string>& receipt_infos, seconds visibility_timeout,
+    QueueMessagePrefetcher::ChangeVisibilityCallback callback) noexcept {
+  auto batches = make_shared<VisibilityChangeBatches>();
+  batches->receipt_infos = receipt_infos;
+  batches->pending_batches =
+      (receipt_infos.size() + kMaxNumberOfMessagesPerBatch - 1) /
+      kMaxNumberOfMessagesPerBatch;
+  if (batches->pending_batches == 0) {
+    callback({});
+    return;
+  }
+
+  for (size_t begin = 0; begin < receipt_infos.size();
+       begin += kMaxNumberOfMessagesPerBatch) {
+    auto end = std::min<size_t>(receipt_infos.size(),
+                                begin + kMaxNumberOfMessagesPerBatch);
+    ChangeMessageVisibilityBatchRequest change_message_visibility_request;
+    change_message_visibility_request.SetQueueUrl(queue_url_.c_str());
+    // The entry ID is the index of the receipt info.
+    for (auto i = begin; i < end; ++i) {
+      ChangeMessageVisibilityBatchRequestEntry entry;
+      entry.SetId(to_string(i).c_str());
+      entry.SetReceiptHandle(receipt_infos[i].c_str());
+      entry.SetVisibilityTimeout(visibility_timeout.count());
+      change_message_visibility_request.AddEntries(move(entry));
+    }
+
+    sqs_client_->ChangeMessageVisibilityBatchAsync(
+        change_message_visibility_request,
+        [batches, callback](
+            const SQSClient* sqs_client,
+            const ChangeMessageVisibilityBatchRequest&
+                change_message_visibility_request,
+            const ChangeMessageVisibilityBatchOutcome&
+                change_message_visibility_outcome,
+            const shared_ptr<const AsyncCallerContext>& async_context) {
+          vector<string> changed_receipt_infos;
+          if (change_message_visibility_outcome.IsSuccess()) {
+            const auto& result = change_message_visibility_outcome.GetResult();
+            for (const auto& entry : result.GetSuccessful()) {
+              auto index = std::strtoul(entry.GetId().c_str(), nullptr, 10);
+              if (index < batches->receipt_infos.size()) {
+                changed_receipt_infos.push_back(batches->receipt_infos[index]);
+              }
+            }
+            for (const auto& entry : result.GetFailed()) {
+              SCP_WARNING(kAwsQueueClientProvider, kZeroUuid,
+                          "Failed to change visibility of prefetched message. "
+                          "Error code: %s, error message: %s",
+                          entry.GetCode().c_str(), entry.GetMessage().c_str());
+            }
+          } else {
+            auto error_type =
+                change_message_visibility_outcome.GetError().GetErrorType();
+            SCP_ERROR(
+                kAwsQueueClientProvider, kZeroUuid,
+                SqsErrorConverter::ConvertSqsError(error_type),
+                "Failed to change visibility of prefetched messages due to "
+                "AWS SQS service error. Error code: %d, error message: %s",
+                error_type,
+                change_message_visibility_outcome.GetError()
+                    .GetMessage()
+                    .c_str());
+          }
+
+          {
+            lock_guard lock(batches->batches_mutex);
+            batches->changed_receipt_infos.insert(
+                batches->changed_receipt_infos.end(),
+                changed_receipt_infos.begin(), changed_receipt_infos.end());
+            if (--batches->pending_batches > 0) {
+              return;
+            }
+          }
+          callback(move(batches->changed_receipt_infos));
+        },
+        nullptr);
+  }
+}
+
 void AwsQueueClientProvider::UpdateMessageVisibilityTimeout(
     AsyncContext<UpdateMessageVisibilityTimeoutRequest,
                  UpdateMessageVisibilityTimeoutResponse>&
@@ -414,6 +922,17 @@ void AwsQueueClientProvider::DeleteMessage(
     return;
   }
 
+  if (delete_batcher_) {
+    delete_batcher_->Add(receipt_info,
+                         [this, delete_message_context](
+                             ExecutionResultOr<string> result_or) mutable {
+                           FinishContext(result_or.result(),
+                                         delete_message_context,
+                                         cpu_async_executor_);
+                         });
+    return;
+  }
+
   Aws::SQS::Model::DeleteMessageRequest delete_message_request;
   delete_message_request.SetQueueUrl(queue_url_.c_str());
   delete_message_request.SetReceiptHandle(receipt_info.c_str());
@@ -447,6 +966,120 @@ void AwsQueueClientProvider::OnDeleteMessageCallback(
   FinishContext(execution_result, delete_message_context, cpu_async_executor_);
 }
 
+void AwsQueueClientProvider::DeleteMessages(
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+        delete_messages_context) noexcept {
+  const auto& receipt_infos = delete_messages_context.request->receipt_infos();
+  for (const auto& receipt_info : receipt_infos) {
+    if (receipt_info.empty()) {
+      auto execution_result = FailureExecutionResult(
+          SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_RECEIPT_INFO);
+      SCP_ERROR_CONTEXT(
+          kAwsQueueClientProvider, delete_messages_context, execution_result,
+          "Failed to delete messages due to missing receipt info");
+      delete_messages_context.result = execution_result;
+      delete_messages_context.Finish();
+      return;
+    }
+  }
+
+  // Each message fails unless SQS reports it deleted.
+  auto response = make_shared<DeleteMessagesResponse>();
+  auto entry_failed_result =
+      FailureExecutionResult(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED)
+          .ToProto();
+  for (const auto& receipt_info : receipt_infos) {
+    auto* message_result = response->add_message_results();
+    message_result->set_receipt_info(receipt_info);
+    *message_result->mutable_result() = entry_failed_result;
+  }
+  delete_messages_context.response = move(response);
+
+  auto pending_batches = make_shared<atomic<size_t>>(
+      (receipt_infos.size() + kMaxNumberOfMessagesPerBatch - 1) /
+      kMaxNumberOfMessagesPerBatch);
+  if (*pending_batches == 0) {
+    FinishContext(SuccessExecutionResult(), delete_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  for (int begin = 0; begin < receipt_infos.size();
+       begin += kMaxNumberOfMessagesPerBatch) {
+    auto end = std::min<int>(receipt_infos.size(),
+                             begin + kMaxNumberOfMessagesPerBatch);
+    DeleteMessageBatchRequest delete_message_batch_request;
+    delete_message_batch_request.SetQueueUrl(queue_url_.c_str());
+    // The entry ID is the index of the receipt info.
+    for (auto i = begin; i < end; ++i) {
+      DeleteMessageBatchRequestEntry entry;
+      entry.SetId(to_string(i).c_str());
+      entry.SetReceiptHandle(receipt_infos[i].c_str());
+      delete_message_batch_request.AddEntries(move(entry));
+    }
+
+    sqs_client_->DeleteMessageBatchAsync(
+        delete_message_batch_request,
+        bind(&AwsQueueClientProvider::OnDeleteMessageBatchCallback, this,
+             delete_messages_context, pending_batches, _1, _2, _3, _4),
+        nullptr);
+  }
+}
+
+void AwsQueueClientProvider::OnDeleteMessageBatchCallback(
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+        delete_messages_context,
+    const shared_ptr<atomic<size_t>>& pending_batches,
+    const SQSClient* sqs_client,
+    const DeleteMessageBatchRequest& delete_message_batch_request,
+    DeleteMessageBatchOutcome delete_message_batch_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  auto& message_results =
+      *delete_messages_context.response->mutable_message_results();
+  if (!delete_message_batch_outcome.IsSuccess()) {
+    auto error_type = delete_message_batch_outcome.GetError().GetErrorType();
+    auto error_message =
+        delete_message_batch_outcome.GetError().GetMessage().c_str();
+    auto execution_result = SqsErrorConverter::ConvertSqsError(error_type);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, delete_messages_context, execution_result,
+        "Failed to delete message batch due to AWS SQS service error. Error "
+        "code: %d, error message: %s",
+        error_type, error_message);
+    for (const auto& entry : delete_message_batch_request.GetEntries()) {
+      auto index = std::strtoul(entry.GetId().c_str(), nullptr, 10);
+      if (index < static_cast<size_t>(message_results.size())) {
+        *message_results[index].mutable_result() = execution_result.ToProto();
+      }
+    }
+  } else {
+    const auto& result = delete_message_batch_outcome.GetResult();
+    for (const auto& entry : result.GetSuccessful()) {
+      auto index = std::strtoul(entry.GetId().c_str(), nullptr, 10);
+      if (index < static_cast<size_t>(message_results.size())) {
+        *message_results[index].mutable_result() =
+            SuccessExecutionResult().ToProto();
+      }
+    }
+    auto entry_failed_result =
+        FailureExecutionResult(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED);
+    for (const auto& entry : result.GetFailed()) {
+      SCP_ERROR_CONTEXT(kAwsQueueClientProvider, delete_messages_context,
+                        entry_failed_result,
+                        "Failed to delete message %s of the batch. Error "
+                        "code: %s, error message: %s",
+                        entry.GetId().c_str(), entry.GetCode().c_str(),
+                        entry.GetMessage().c_str());
+    }
+  }
+
+  // The results of all the batches are in once the last one is done.
+  if (pending_batches->fetch_sub(1) == 1) {
+    FinishContext(SuccessExecutionResult(), delete_messages_context,
+                  cpu_async_executor_);
+  }
+}
+
 shared_ptr<SQSClient> AwsSqsClientFactory::CreateSqsClient(
     const shared_ptr<ClientConfiguration> client_config) noexcept {
   return make_shared<SQSClient>(*client_config);
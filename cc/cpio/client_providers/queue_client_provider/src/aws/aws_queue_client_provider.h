@@ -16,14 +16,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "aws/sqs/SQSClient.h"
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
 #include "cpio/client_providers/interface/queue_client_provider_interface.h"
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_batcher.h"
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_prefetcher.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/proto/queue_service/v1/queue_service.pb.h"
 
@@ -63,11 +68,21 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::EnqueueMessageResponse>&
           enqueue_message_context) noexcept override;
 
+  void EnqueueMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept override;
+
   void GetTopMessage(
       core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept override;
 
+  void GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept override;
+
   void UpdateMessageVisibilityTimeout(
       core::AsyncContext<
           cmrt::sdk::queue_service::v1::UpdateMessageVisibilityTimeoutRequest,
@@ -79,6 +94,11 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::DeleteMessageResponse>&
           delete_message_context) noexcept override;
 
+  void DeleteMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept override;
+
  private:
   /**
    * @brief Creates a Client Configuration object.
@@ -117,6 +137,30 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the SQS
+   * SendMessageBatch callback of EnqueueMessages.
+   *
+   * @param enqueue_messages_context The enqueue messages context object.
+   * @param pending_batches The number of batches of the context in flight.
+   * @param sqs_client An instance of the SQS client.
+   * @param send_message_batch_request The send message batch request.
+   * @param send_message_batch_outcome The send message batch outcome of the
+   * async operation.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnSendMessageBatchCallback(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context,
+      const std::shared_ptr<std::atomic<size_t>>& pending_batches,
+      const Aws::SQS::SQSClient* sqs_client,
+      const Aws::SQS::Model::SendMessageBatchRequest&
+          send_message_batch_request,
+      Aws::SQS::Model::SendMessageBatchOutcome send_message_batch_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the SQS ReceiveMessage
    * callback.
@@ -138,6 +182,51 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the SQS ReceiveMessage
+   * callback of GetTopMessages.
+   *
+   * @param get_top_messages_context The get top messages context object.
+   * @param sqs_client An instance of the SQS client.
+   * @param receive_message_request The receive message request.
+   * @param receive_message_outcome The receive message outcome of the async
+   * operation.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnReceiveMessagesCallback(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context,
+      const Aws::SQS::SQSClient* sqs_client,
+      const Aws::SQS::Model::ReceiveMessageRequest& receive_message_request,
+      Aws::SQS::Model::ReceiveMessageOutcome receive_message_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
+  /**
+   * @brief Receives messages into the prefetch buffer, long polling for them.
+   *
+   * @param max_messages the max number of messages to receive.
+   * @param visibility_timeout the visibility timeout of the messages.
+   * @param callback is called with the messages received.
+   */
+  void ReceivePrefetchedMessages(
+      size_t max_messages, std::chrono::seconds visibility_timeout,
+      QueueMessagePrefetcher::ReceiveMessagesCallback callback) noexcept;
+
+  /**
+   * @brief Changes the visibility timeout of the messages in the prefetch
+   * buffer with SQS ChangeMessageVisibilityBatch.
+   *
+   * @param receipt_infos the receipt infos of the messages.
+   * @param visibility_timeout the new visibility timeout.
+   * @param callback is called with the receipt infos changed.
+   */
+  void ChangePrefetchedMessagesVisibility(
+      const std::vector<std::string>& receipt_infos,
+      std::chrono::seconds visibility_timeout,
+      QueueMessagePrefetcher::ChangeVisibilityCallback callback) noexcept;
+
   /**
    * @brief Is called when the object is returned from the SQS Change Message
    * Visibility callback.
@@ -185,6 +274,30 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the SQS
+   * DeleteMessageBatch callback of DeleteMessages.
+   *
+   * @param delete_messages_context The delete messages context object.
+   * @param pending_batches The number of batches of the context in flight.
+   * @param sqs_client An instance of the SQS client.
+   * @param delete_message_batch_request The delete message batch request.
+   * @param delete_message_batch_outcome The delete message batch outcome of
+   * the async operation.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnDeleteMessageBatchCallback(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context,
+      const std::shared_ptr<std::atomic<size_t>>& pending_batches,
+      const Aws::SQS::SQSClient* sqs_client,
+      const Aws::SQS::Model::DeleteMessageBatchRequest&
+          delete_message_batch_request,
+      Aws::SQS::Model::DeleteMessageBatchOutcome delete_message_batch_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
   /// The configuration for queue client.
   std::shared_ptr<QueueClientOptions> queue_client_options_;
 
@@ -203,6 +316,13 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
 
   /// An Instance of the AWS SQS client.
   std::shared_ptr<Aws::SQS::SQSClient> sqs_client_;
+
+  /// The prefetch buffer of messages, if enabled in the options.
+  std::shared_ptr<QueueMessagePrefetcher> message_prefetcher_;
+
+  /// Batch the concurrent EnqueueMessage and DeleteMessage calls, if enabled
+  /// in the options.
+  std::shared_ptr<QueueMessageBatcher> enqueue_batcher_, delete_batcher_;
 };
 
 /// Provides AwsSqsClient.
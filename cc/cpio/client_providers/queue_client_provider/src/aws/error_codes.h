@@ -61,6 +61,19 @@ DEFINE_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED,
                   SC_AWS_QUEUE_CLIENT_PROVIDER, 0x0009,
                   "No messages are being received from SQS",
                   HttpStatusCode::NOT_FOUND)
+DEFINE_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES,
+                  SC_AWS_QUEUE_CLIENT_PROVIDER, 0x000A,
+                  "Cannot execute SQS operation due to invalid max messages",
+                  HttpStatusCode::BAD_REQUEST)
+DEFINE_ERROR_CODE(
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT,
+    SC_AWS_QUEUE_CLIENT_PROVIDER, 0x000B,
+    "AWS Queue client failed to init due to invalid visibility timeout",
+    HttpStatusCode::BAD_REQUEST)
+DEFINE_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED,
+                  SC_AWS_QUEUE_CLIENT_PROVIDER, 0x000C,
+                  "SQS failed to execute the operation for a batch entry",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_AWS_QUEUE_CLIENT_PROVIDER_QUEUE_CLIENT_OPTIONS_REQUIRED,
     SC_CPIO_INTERNAL_ERROR)
@@ -81,4 +94,11 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY,
                          SC_CPIO_INTERNAL_ERROR)
 MAP_TO_PUBLIC_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED,
                          SC_CPIO_ENTITY_NOT_FOUND)
+MAP_TO_PUBLIC_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES,
+                         SC_CPIO_INVALID_ARGUMENT)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT,
+    SC_CPIO_INVALID_ARGUMENT)
+MAP_TO_PUBLIC_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED,
+                         SC_CPIO_INTERNAL_ERROR)
 }  // namespace google::scp::core::errors
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "queue_message_batcher.h"
+
+#include <utility>
+
+#include "core/common/time_provider/src/time_provider.h"
+
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::TaskCancellationLambda;
+using google::scp::core::common::TimeProvider;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+
+namespace google::scp::cpio::client_providers {
+QueueMessageBatcher::QueueMessageBatcher(
+    size_t max_batch_size, milliseconds linger_duration, FlushFunction flush,
+    shared_ptr<AsyncExecutorInterface> cpu_async_executor)
+    : max_batch_size_(max_batch_size),
+      linger_duration_(linger_duration),
+      flush_(move(flush)),
+      cpu_async_executor_(move(cpu_async_executor)) {}
+
+void QueueMessageBatcher::Add(string item, ItemCallback callback) noexcept {
+  vector<PendingItem> full_batch;
+  TaskCancellationLambda cancel_linger;
+  bool is_first_item = false;
+  uint64_t batch_number;
+  {
+    lock_guard lock(mutex_);
+    pending_batch_.push_back(PendingItem{move(item), move(callback)});
+    batch_number = batch_number_;
+    if (pending_batch_.size() >= max_batch_size_) {
+      full_batch.swap(pending_batch_);
+      ++batch_number_;
+      cancel_linger.swap(cancel_linger_);
+    } else {
+      is_first_item = pending_batch_.size() == 1;
+    }
+  }
+
+  if (!full_batch.empty()) {
+    if (cancel_linger) {
+      cancel_linger();
+    }
+    Send(move(full_batch));
+    return;
+  }
+  if (!is_first_item) {
+    return;
+  }
+
+  auto execution_result = cpu_async_executor_->ScheduleFor(
+      [self = shared_from_this(), batch_number]() {
+        self->OnLingerPassed(batch_number);
+      },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + linger_duration_)
+          .count(),
+      cancel_linger);
+  if (!execution_result.Successful()) {
+    OnLingerPassed(batch_number);
+    return;
+  }
+  lock_guard lock(mutex_);
+  // Otherwise the batch was already sent full.
+  if (batch_number_ == batch_number) {
+    cancel_linger_ = move(cancel_linger);
+  }
+}
+
+ExecutionResult QueueMessageBatcher::Stop() noexcept {
+  vector<PendingItem> batch;
+  TaskCancellationLambda cancel_linger;
+  {
+    lock_guard lock(mutex_);
+    batch.swap(pending_batch_);
+    ++batch_number_;
+    cancel_linger.swap(cancel_linger_);
+  }
+  if (cancel_linger) {
+    cancel_linger();
+  }
+  if (!batch.empty()) {
+    Send(move(batch));
+  }
+  return SuccessExecutionResult();
+}
+
+void QueueMessageBatcher::OnLingerPassed(uint64_t batch_number) noexcept {
+  vector<PendingItem> batch;
+  {
+    lock_guard lock(mutex_);
+    if (batch_number_ != batch_number || pending_batch_.empty()) {
+      return;
+    }
+    batch.swap(pending_batch_);
+    ++batch_number_;
+    cancel_linger_ = nullptr;
+  }
+  Send(move(batch));
+}
+
+void QueueMessageBatcher::Send(vector<PendingItem> batch) noexcept {
+  vector<string> items;
+  vector<ItemCallback> callbacks;
+  for (auto& pending_item : batch) {
+    items.push_back(move(pending_item.item));
+    callbacks.push_back(move(pending_item.callback));
+  }
+
+  flush_(move(items),
+         [callbacks](vector<ExecutionResultOr<string>> results) {
+           for (size_t i = 0; i < callbacks.size(); ++i) {
+             // Every item is called back, even if the flush lost its result.
+             callbacks[i](i < results.size()
+                              ? move(results[i])
+                              : ExecutionResultOr<string>(
+                                    FailureExecutionResult(SC_UNKNOWN)));
+           }
+         });
+}
+
+QueueMessageBatcher::FlushFunction
+QueueMessageBatcher::FlushWithEnqueueMessages(
+    EnqueueMessagesFunction enqueue_messages) noexcept {
+  return [enqueue_messages](vector<string> message_bodies,
+                            FlushCallback callback) {
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+        enqueue_messages_context(
+            make_shared<EnqueueMessagesRequest>(),
+            [callback](auto& enqueue_messages_context) {
+              vector<ExecutionResultOr<string>> results;
+              if (!enqueue_messages_context.result.Successful()) {
+                results.assign(
+                    enqueue_messages_context.request->message_bodies_size(),
+                    enqueue_messages_context.result);
+              } else if (enqueue_messages_context.response) {
+                for (const auto& message_result :
+                     enqueue_messages_context.response->message_results()) {
+                  ExecutionResult result(message_result.result());
+                  if (result.Successful()) {
+                    results.push_back(message_result.message_id());
+                  } else {
+                    results.push_back(result);
+                  }
+                }
+              }
+              callback(move(results));
+            });
+    for (auto& message_body : message_bodies) {
+      enqueue_messages_context.request->add_message_bodies(move(message_body));
+    }
+    enqueue_messages(enqueue_messages_context);
+  };
+}
+
+QueueMessageBatcher::FlushFunction QueueMessageBatcher::FlushWithDeleteMessages(
+    DeleteMessagesFunction delete_messages) noexcept {
+  return [delete_messages](vector<string> receipt_infos,
+                           FlushCallback callback) {
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>
+        delete_messages_context(
+            make_shared<DeleteMessagesRequest>(),
+            [callback](auto& delete_messages_context) {
+              vector<ExecutionResultOr<string>> results;
+              if (!delete_messages_context.result.Successful()) {
+                results.assign(
+                    delete_messages_context.request->receipt_infos_size(),
+                    delete_messages_context.result);
+              } else if (delete_messages_context.response) {
+                for (const auto& message_result :
+                     delete_messages_context.response->message_results()) {
+                  ExecutionResult result(message_result.result());
+                  if (result.Successful()) {
+                    results.push_back(string());
+                  } else {
+                    results.push_back(result);
+                  }
+                }
+              }
+              callback(move(results));
+            });
+    for (auto& receipt_info : receipt_infos) {
+      delete_messages_context.request->add_receipt_infos(move(receipt_info));
+    }
+    delete_messages(delete_messages_context);
+  };
+}
+}  // namespace google::scp::cpio::client_providers
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/queue_service/v1/queue_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Merges the items of concurrent single calls, such as the message
+ * bodies of EnqueueMessage, into batches sent with one batched call.
+ *
+ * A batch is sent once it has max_batch_size items, or once the linger duration
+ * passed since its first item was added.
+ */
+class QueueMessageBatcher
+    : public std::enable_shared_from_this<QueueMessageBatcher> {
+ public:
+  /// Is called with the result of an item, and its value if any.
+  using ItemCallback =
+      std::function<void(core::ExecutionResultOr<std::string>)>;
+
+  /// Is called with the result of each item of a batch, in order.
+  using FlushCallback = std::function<void(
+      std::vector<core::ExecutionResultOr<std::string>> results)>;
+
+  /// Sends a batch of items with one batched call.
+  using FlushFunction =
+      std::function<void(std::vector<std::string> items, FlushCallback)>;
+
+  /// Sends messages with the batched call of the provider.
+  using EnqueueMessagesFunction = std::function<void(
+      core::AsyncContext<
+          cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+          cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&)>;
+
+  /// Sends messages with the batched call of the provider.
+  using DeleteMessagesFunction = std::function<void(
+      core::AsyncContext<
+          cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+          cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&)>;
+
+  /**
+   * @brief Construct a new batcher.
+   *
+   * @param max_batch_size the max number of items in a batch.
+   * @param linger_duration how long a batch waits for more items.
+   * @param flush sends a batch.
+   * @param cpu_async_executor the executor to schedule the lingers on.
+   */
+  QueueMessageBatcher(
+      size_t max_batch_size, std::chrono::milliseconds linger_duration,
+      FlushFunction flush,
+      std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor);
+
+  /**
+   * @brief Adds an item to the pending batch.
+   *
+   * @param item the item.
+   * @param callback is called once the batch of the item was sent.
+   */
+  void Add(std::string item, ItemCallback callback) noexcept;
+
+  /// Sends the pending batch without waiting for more items.
+  core::ExecutionResult Stop() noexcept;
+
+  /**
+   * @brief Makes a FlushFunction which sends message bodies with
+   * EnqueueMessages. The value of an item is its message ID.
+   */
+  static FlushFunction FlushWithEnqueueMessages(
+      EnqueueMessagesFunction enqueue_messages) noexcept;
+
+  /**
+   * @brief Makes a FlushFunction which sends receipt infos with
+   * DeleteMessages. The value of an item is empty.
+   */
+  static FlushFunction FlushWithDeleteMessages(
+      DeleteMessagesFunction delete_messages) noexcept;
+
+ private:
+  /// An item waiting in the pending batch.
+  struct PendingItem {
+    std::string item;
+    ItemCallback callback;
+  };
+
+  /// Sends the pending batch once its linger passed, unless it was sent.
+  void OnLingerPassed(uint64_t batch_number) noexcept;
+
+  /// Sends a batch and calls back each of its items.
+  void Send(std::vector<PendingItem> batch) noexcept;
+
+  const size_t max_batch_size_;
+  const std::chrono::milliseconds linger_duration_;
+  const FlushFunction flush_;
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+
+  std::mutex mutex_;
+  std::vector<PendingItem> pending_batch_;
+  /// Counts the batches sent, so a linger knows if its batch was sent.
+  uint64_t batch_number_ = 0;
+  core::TaskCancellationLambda cancel_linger_;
+};
+}  // namespace google::scp::cpio::client_providers
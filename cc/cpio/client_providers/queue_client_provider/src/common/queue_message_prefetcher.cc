@@ -0,0 +1,282 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "queue_message_prefetcher.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+#include "core/common/time_provider/src/time_provider.h"
+
+using google::cmrt::sdk::queue_service::v1::QueueMessage;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::TaskCancellationLambda;
+using google::scp::core::common::TimeProvider;
+using std::lock_guard;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+using std::unordered_set;
+using std::vector;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+namespace {
+// The most messages SQS and Pub/Sub are asked for at once.
+constexpr size_t kMaxMessagesPerReceive = 10;
+constexpr seconds kReceiveRetryDelay = seconds(1);
+}  // namespace
+
+namespace google::scp::cpio::client_providers {
+QueueMessagePrefetcher::QueueMessagePrefetcher(
+    size_t buffer_size, seconds lease_duration,
+    ReceiveMessagesFunction receive_messages,
+    ChangeVisibilityFunction change_visibility,
+    shared_ptr<AsyncExecutorInterface> cpu_async_executor)
+    : buffer_size_(buffer_size),
+      lease_duration_(lease_duration),
+      receive_messages_(move(receive_messages)),
+      change_visibility_(move(change_visibility)),
+      cpu_async_executor_(move(cpu_async_executor)) {}
+
+ExecutionResult QueueMessagePrefetcher::Run() noexcept {
+  {
+    lock_guard lock(mutex_);
+    if (is_running_) {
+      return SuccessExecutionResult();
+    }
+    is_running_ = true;
+  }
+  ScheduleLeaseExtension();
+  Refill();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult QueueMessagePrefetcher::Stop() noexcept {
+  vector<string> receipt_infos;
+  TaskCancellationLambda cancel_lease_extension;
+  TaskCancellationLambda cancel_refill;
+  {
+    lock_guard lock(mutex_);
+    is_running_ = false;
+    cancel_lease_extension.swap(cancel_lease_extension_);
+    cancel_refill.swap(cancel_refill_);
+    for (const auto& buffered_message : buffer_) {
+      receipt_infos.push_back(buffered_message.message.receipt_info());
+    }
+    buffer_.clear();
+    if (!receipt_infos.empty()) {
+      calls_in_flight_++;
+    }
+  }
+  if (cancel_lease_extension) {
+    cancel_lease_extension();
+  }
+  if (cancel_refill) {
+    cancel_refill();
+  }
+  if (!receipt_infos.empty()) {
+    change_visibility_(receipt_infos, seconds(0),
+                       [self = shared_from_this()](auto) {
+                         self->OnCallDone();
+                       });
+  }
+
+  // The calls in flight run on the provider, which may be gone once stopped.
+  unique_lock lock(mutex_);
+  calls_done_.wait(lock, [this]() { return calls_in_flight_ == 0; });
+  return SuccessExecutionResult();
+}
+
+vector<QueueMessage> QueueMessagePrefetcher::TakeMessages(
+    size_t max_messages) noexcept {
+  vector<QueueMessage> messages;
+  {
+    lock_guard lock(mutex_);
+    DropExpiredMessages();
+    while (messages.size() < max_messages && !buffer_.empty()) {
+      messages.push_back(move(buffer_.front().message));
+      buffer_.pop_front();
+    }
+  }
+  Refill();
+  return messages;
+}
+
+void QueueMessagePrefetcher::Refill() noexcept {
+  size_t max_messages;
+  {
+    lock_guard lock(mutex_);
+    if (!is_running_ || is_receiving_ || buffer_.size() >= buffer_size_) {
+      return;
+    }
+    is_receiving_ = true;
+    calls_in_flight_++;
+    max_messages = std::min(buffer_size_ - buffer_.size(),
+                            kMaxMessagesPerReceive);
+  }
+
+  // The visibility timeout of the messages starts once they are received, so
+  // the lease is counted from before.
+  auto lease_expiration =
+      TimeProvider::GetSteadyTimestampInNanoseconds() + lease_duration_;
+  receive_messages_(
+      max_messages, lease_duration_,
+      [self = shared_from_this(), lease_expiration](
+          ExecutionResultOr<vector<QueueMessage>> messages_or) {
+        self->OnMessagesReceived(lease_expiration, move(messages_or));
+      });
+}
+
+void QueueMessagePrefetcher::OnMessagesReceived(
+    nanoseconds lease_expiration,
+    ExecutionResultOr<vector<QueueMessage>> messages_or) noexcept {
+  vector<string> receipt_infos_to_release;
+  bool is_running;
+  {
+    lock_guard lock(mutex_);
+    is_receiving_ = false;
+    is_running = is_running_;
+    if (messages_or.Successful()) {
+      for (auto& message : *messages_or) {
+        if (is_running) {
+          buffer_.push_back(BufferedMessage{move(message), lease_expiration});
+        } else {
+          receipt_infos_to_release.push_back(message.receipt_info());
+        }
+      }
+    }
+    // The release takes the place of the receive in flight, so Stop keeps
+    // waiting for it.
+    if (receipt_infos_to_release.empty()) {
+      calls_in_flight_--;
+    }
+  }
+  calls_done_.notify_all();
+
+  if (!receipt_infos_to_release.empty()) {
+    change_visibility_(receipt_infos_to_release, seconds(0),
+                       [self = shared_from_this()](auto) {
+                         self->OnCallDone();
+                       });
+  }
+  if (!is_running) {
+    return;
+  }
+  if (!messages_or.Successful()) {
+    ScheduleRefill();
+    return;
+  }
+  Refill();
+}
+
+void QueueMessagePrefetcher::ScheduleRefill() noexcept {
+  TaskCancellationLambda cancel_refill;
+  auto execution_result = cpu_async_executor_->ScheduleFor(
+      [self = shared_from_this()]() { self->Refill(); },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + kReceiveRetryDelay)
+          .count(),
+      cancel_refill);
+  // Otherwise the buffer is refilled once a message is taken.
+  if (execution_result.Successful()) {
+    lock_guard lock(mutex_);
+    cancel_refill_ = move(cancel_refill);
+  }
+}
+
+void QueueMessagePrefetcher::ScheduleLeaseExtension() noexcept {
+  TaskCancellationLambda cancel_lease_extension;
+  auto execution_result = cpu_async_executor_->ScheduleFor(
+      [self = shared_from_this()]() { self->ExtendLeases(); },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + lease_duration_ / 2)
+          .count(),
+      cancel_lease_extension);
+  // Otherwise the buffered messages are dropped once their lease runs out.
+  if (execution_result.Successful()) {
+    lock_guard lock(mutex_);
+    cancel_lease_extension_ = move(cancel_lease_extension);
+  }
+}
+
+void QueueMessagePrefetcher::ExtendLeases() noexcept {
+  vector<string> receipt_infos;
+  {
+    lock_guard lock(mutex_);
+    if (!is_running_) {
+      return;
+    }
+    DropExpiredMessages();
+    for (const auto& buffered_message : buffer_) {
+      receipt_infos.push_back(buffered_message.message.receipt_info());
+    }
+    if (!receipt_infos.empty()) {
+      calls_in_flight_++;
+    }
+  }
+  ScheduleLeaseExtension();
+
+  if (!receipt_infos.empty()) {
+    auto lease_expiration =
+        TimeProvider::GetSteadyTimestampInNanoseconds() + lease_duration_;
+    change_visibility_(
+        receipt_infos, lease_duration_,
+        [self = shared_from_this(),
+         lease_expiration](vector<string> changed_receipt_infos) {
+          self->OnLeasesExtended(lease_expiration,
+                                 move(changed_receipt_infos));
+          self->OnCallDone();
+        });
+  }
+  // Dropped messages leave room in the buffer.
+  Refill();
+}
+
+void QueueMessagePrefetcher::OnLeasesExtended(
+    nanoseconds lease_expiration, vector<string> receipt_infos) noexcept {
+  unordered_set<string> changed_receipt_infos(receipt_infos.begin(),
+                                              receipt_infos.end());
+  lock_guard lock(mutex_);
+  for (auto& buffered_message : buffer_) {
+    if (changed_receipt_infos.count(buffered_message.message.receipt_info())) {
+      buffered_message.lease_expiration =
+          std::max(buffered_message.lease_expiration, lease_expiration);
+    }
+  }
+}
+
+void QueueMessagePrefetcher::DropExpiredMessages() noexcept {
+  auto now = TimeProvider::GetSteadyTimestampInNanoseconds();
+  buffer_.erase(std::remove_if(buffer_.begin(), buffer_.end(),
+                               [now](const BufferedMessage& buffered_message) {
+                                 return buffered_message.lease_expiration <=
+                                        now;
+                               }),
+                buffer_.end());
+}
+
+void QueueMessagePrefetcher::OnCallDone() noexcept {
+  {
+    lock_guard lock(mutex_);
+    calls_in_flight_--;
+  }
+  calls_done_.notify_all();
+}
+}  // namespace google::scp::cpio::client_providers
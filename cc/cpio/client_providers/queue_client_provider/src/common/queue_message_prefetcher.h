@@ -0,0 +1,161 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_executor_interface.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/queue_service/v1/queue_service.pb.h"
+
+namespace google::scp::cpio::client_providers {
+/**
+ * @brief Keeps a buffer of messages received ahead of GetTopMessage and
+ * GetTopMessages, refilled in the background one receive at a time.
+ *
+ * Messages are received invisible for the lease duration, which is extended
+ * every half lease while they are buffered. A message taken from the buffer is
+ * no longer extended, and one whose lease ran out is dropped as it may have
+ * been delivered again. On Stop, the buffered messages are made visible again.
+ *
+ * The receives and visibility changes call into the provider, so Stop waits
+ * for the ones in flight, which may be a long poll, before returning.
+ */
+class QueueMessagePrefetcher
+    : public std::enable_shared_from_this<QueueMessagePrefetcher> {
+ public:
+  /// Is called with the messages received, which may be none.
+  using ReceiveMessagesCallback = std::function<void(
+      core::ExecutionResultOr<
+          std::vector<cmrt::sdk::queue_service::v1::QueueMessage>>)>;
+
+  /**
+   * @brief Receives up to max_messages messages invisible for the visibility
+   * timeout, waiting a while for them with long polling.
+   */
+  using ReceiveMessagesFunction = std::function<void(
+      size_t max_messages, std::chrono::seconds visibility_timeout,
+      ReceiveMessagesCallback callback)>;
+
+  /// Is called with the receipt infos whose visibility timeout was changed.
+  using ChangeVisibilityCallback =
+      std::function<void(std::vector<std::string> changed_receipt_infos)>;
+
+  /// Changes the visibility timeout of the messages of the receipt infos.
+  using ChangeVisibilityFunction = std::function<void(
+      const std::vector<std::string>& receipt_infos,
+      std::chrono::seconds visibility_timeout,
+      ChangeVisibilityCallback callback)>;
+
+  /**
+   * @brief Construct a new prefetcher. Nothing is received until Run().
+   *
+   * @param buffer_size the max number of buffered messages.
+   * @param lease_duration how long buffered messages stay invisible.
+   * @param receive_messages receives messages.
+   * @param change_visibility changes the visibility timeout of messages.
+   * @param cpu_async_executor the executor to schedule the lease extensions
+   * and the retries of failed receives on.
+   */
+  QueueMessagePrefetcher(
+      size_t buffer_size, std::chrono::seconds lease_duration,
+      ReceiveMessagesFunction receive_messages,
+      ChangeVisibilityFunction change_visibility,
+      std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor);
+
+  /// Starts filling the buffer and extending the leases.
+  core::ExecutionResult Run() noexcept;
+
+  /**
+   * @brief Stops filling the buffer, and makes the buffered messages visible
+   * again. Returns once no receive or visibility change is in flight, after
+   * which the provider is not called anymore.
+   */
+  core::ExecutionResult Stop() noexcept;
+
+  /**
+   * @brief Takes up to max_messages buffered messages, in the order they were
+   * received, and refills the buffer.
+   *
+   * @return std::vector<QueueMessage> the messages, which may be none.
+   */
+  std::vector<cmrt::sdk::queue_service::v1::QueueMessage> TakeMessages(
+      size_t max_messages) noexcept;
+
+ private:
+  /// A buffered message, and when its lease runs out.
+  struct BufferedMessage {
+    cmrt::sdk::queue_service::v1::QueueMessage message;
+    std::chrono::nanoseconds lease_expiration;
+  };
+
+  /// Receives more messages, unless a receive is in flight or the buffer is
+  /// full.
+  void Refill() noexcept;
+
+  /// Buffers the messages received, or retries the receive later if it
+  /// failed.
+  void OnMessagesReceived(
+      std::chrono::nanoseconds lease_expiration,
+      core::ExecutionResultOr<
+          std::vector<cmrt::sdk::queue_service::v1::QueueMessage>>
+          messages_or) noexcept;
+
+  /// Schedules a Refill after a failed receive.
+  void ScheduleRefill() noexcept;
+
+  /// Schedules the next lease extension in half a lease.
+  void ScheduleLeaseExtension() noexcept;
+
+  /// Extends the lease of the buffered messages.
+  void ExtendLeases() noexcept;
+
+  /// Moves the lease expiration of the messages whose visibility timeout was
+  /// changed.
+  void OnLeasesExtended(std::chrono::nanoseconds lease_expiration,
+                        std::vector<std::string> receipt_infos) noexcept;
+
+  /// Drops the messages whose lease ran out. Must be called under the lock.
+  void DropExpiredMessages() noexcept;
+
+  /// Marks a call into the provider as done, and wakes up Stop.
+  void OnCallDone() noexcept;
+
+  const size_t buffer_size_;
+  const std::chrono::seconds lease_duration_;
+  const ReceiveMessagesFunction receive_messages_;
+  const ChangeVisibilityFunction change_visibility_;
+  const std::shared_ptr<core::AsyncExecutorInterface> cpu_async_executor_;
+
+  std::mutex mutex_;
+  bool is_running_ = false;
+  bool is_receiving_ = false;
+  std::deque<BufferedMessage> buffer_;
+  /// The number of receives and visibility changes in flight.
+  size_t calls_in_flight_ = 0;
+  std::condition_variable calls_done_;
+  core::TaskCancellationLambda cancel_lease_extension_;
+  core::TaskCancellationLambda cancel_refill_;
+};
+}  // namespace google::scp::cpio::client_providers
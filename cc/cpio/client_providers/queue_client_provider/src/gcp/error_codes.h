@@ -70,6 +70,10 @@ DEFINE_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED,
                   SC_GCP_QUEUE_CLIENT_PROVIDER, 0x000B,
                   "No messages are being received from PubSub",
                   HttpStatusCode::NOT_FOUND)
+DEFINE_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES,
+                  SC_GCP_QUEUE_CLIENT_PROVIDER, 0x000C,
+                  "Cannot execute PubSub operation due to invalid max messages",
+                  HttpStatusCode::BAD_REQUEST)
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_GCP_QUEUE_CLIENT_PROVIDER_QUEUE_CLIENT_OPTIONS_REQUIRED,
     SC_CPIO_INTERNAL_ERROR)
@@ -95,4 +99,6 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY,
                          SC_CPIO_INTERNAL_ERROR)
 MAP_TO_PUBLIC_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED,
                          SC_CPIO_ENTITY_NOT_FOUND)
+MAP_TO_PUBLIC_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES,
+                         SC_CPIO_INVALID_ARGUMENT)
 }  // namespace google::scp::core::errors
@@ -16,7 +16,11 @@
 
 #include "gcp_queue_client_provider.h"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <grpcpp/grpcpp.h>
 
@@ -33,10 +37,17 @@
 using absl::StrFormat;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
+using google::cmrt::sdk::queue_service::v1::QueueMessage;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -50,16 +61,20 @@ using google::pubsub::v1::PublishResponse;
 using google::pubsub::v1::PubsubMessage;
 using google::pubsub::v1::PullRequest;
 using google::pubsub::v1::PullResponse;
+using google::pubsub::v1::ReceivedMessage;
 using google::pubsub::v1::Subscriber;
 using google::scp::core::AsyncContext;
 using google::scp::core::AsyncExecutorInterface;
 using google::scp::core::AsyncPriority;
 using google::scp::core::ExecutionResult;
+using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT;
+using google::scp::core::errors::
+    SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES;
 using google::scp::core::errors::SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY;
@@ -91,10 +106,17 @@ using grpc::StatusCode;
 using grpc::StubOptions;
 using std::bind;
 using std::make_shared;
+using std::move;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::system_clock;
 using std::placeholders::_1;
+using std::placeholders::_2;
+using std::placeholders::_3;
 
 static constexpr char kGcpQueueClientProvider[] = "GcpQueueClientProvider";
 static constexpr char kGcpTopicFormatString[] = "projects/%s/topics/%s";
@@ -102,6 +124,26 @@ static constexpr char kGcpSubscriptionFormatString[] =
     "projects/%s/subscriptions/%s";
 static constexpr uint8_t kMaxNumberOfMessagesReceived = 1;
 static constexpr uint16_t kMaxAckDeadlineSeconds = 600;
+static constexpr uint8_t kMaxNumberOfMessagesPerGet = 10;
+// How long a Pull into the prefetch buffer waits for messages to arrive.
+static constexpr uint8_t kLongPollWaitTimeSeconds = 20;
+// Leaves half a lease for a lease extension to get through.
+static constexpr uint16_t kMinPrefetchLeaseDurationSeconds = 10;
+// The most messages one Publish or Acknowledge of EnqueueMessages or
+// DeleteMessages carries, within the Pub/Sub request limits.
+static constexpr uint16_t kMaxNumberOfMessagesPerRequest = 1000;
+// The most concurrent EnqueueMessage or DeleteMessage calls merged into one.
+static constexpr uint8_t kMaxNumberOfMessagesPerBatch = 100;
+
+namespace {
+QueueMessage ToQueueMessage(const ReceivedMessage& received_message) {
+  QueueMessage queue_message;
+  queue_message.set_message_id(received_message.message().message_id());
+  queue_message.set_message_body(received_message.message().data());
+  queue_message.set_receipt_info(received_message.ack_id());
+  return queue_message;
+}
+}  // namespace
 
 namespace google::scp::cpio::client_providers {
 
@@ -123,6 +165,18 @@ ExecutionResult GcpQueueClientProvider::Init() noexcept {
     return execution_result;
   }
 
+  const auto& lease_duration = queue_client_options_->prefetch_lease_duration;
+  if (queue_client_options_->prefetch_buffer_size > 0 &&
+      (lease_duration < seconds(kMinPrefetchLeaseDurationSeconds) ||
+       lease_duration > seconds(kMaxAckDeadlineSeconds))) {
+    execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT);
+    SCP_ERROR(kGcpQueueClientProvider, kZeroUuid, execution_result,
+              "Invalid prefetch lease duration %lld.",
+              static_cast<long long>(lease_duration.count()));
+    return execution_result;
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -161,10 +215,49 @@ ExecutionResult GcpQueueClientProvider::Run() noexcept {
   subscription_name_ = StrFormat(kGcpSubscriptionFormatString, project_id_,
                                  queue_client_options_->queue_name);
 
+  if (queue_client_options_->prefetch_buffer_size > 0) {
+    message_prefetcher_ = make_shared<QueueMessagePrefetcher>(
+        queue_client_options_->prefetch_buffer_size,
+        queue_client_options_->prefetch_lease_duration,
+        bind(&GcpQueueClientProvider::ReceivePrefetchedMessages, this, _1, _2,
+             _3),
+        bind(&GcpQueueClientProvider::ChangePrefetchedMessagesVisibility, this,
+             _1, _2, _3),
+        cpu_async_executor_);
+    auto execution_result = message_prefetcher_->Run();
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+
+  const auto& linger_duration = queue_client_options_->batch_linger_duration;
+  if (linger_duration > milliseconds(0)) {
+    enqueue_batcher_ = make_shared<QueueMessageBatcher>(
+        kMaxNumberOfMessagesPerBatch, linger_duration,
+        QueueMessageBatcher::FlushWithEnqueueMessages(
+            bind(&GcpQueueClientProvider::EnqueueMessages, this, _1)),
+        cpu_async_executor_);
+    delete_batcher_ = make_shared<QueueMessageBatcher>(
+        kMaxNumberOfMessagesPerBatch, linger_duration,
+        QueueMessageBatcher::FlushWithDeleteMessages(
+            bind(&GcpQueueClientProvider::DeleteMessages, this, _1)),
+        cpu_async_executor_);
+  }
+
   return SuccessExecutionResult();
 }
 
 ExecutionResult GcpQueueClientProvider::Stop() noexcept {
+  // The pending batches are sent before the stubs go away.
+  if (enqueue_batcher_) {
+    enqueue_batcher_->Stop();
+  }
+  if (delete_batcher_) {
+    delete_batcher_->Stop();
+  }
+  if (message_prefetcher_) {
+    return message_prefetcher_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -184,6 +277,23 @@ void GcpQueueClientProvider::EnqueueMessage(
     return;
   }
 
+  if (enqueue_batcher_) {
+    enqueue_batcher_->Add(
+        enqueue_message_context.request->message_body(),
+        [this, enqueue_message_context](
+            ExecutionResultOr<string> message_id_or) mutable {
+          if (message_id_or.Successful()) {
+            enqueue_message_context.response =
+                make_shared<EnqueueMessageResponse>();
+            enqueue_message_context.response->set_message_id(
+                move(*message_id_or));
+          }
+          FinishContext(message_id_or.result(), enqueue_message_context,
+                        cpu_async_executor_);
+        });
+    return;
+  }
+
   auto execution_result = io_async_executor_->Schedule(
       bind(&GcpQueueClientProvider::EnqueueMessageAsync, this,
            enqueue_message_context),
@@ -244,9 +354,114 @@ void GcpQueueClientProvider::EnqueueMessageAsync(
                 cpu_async_executor_);
 }
 
+void GcpQueueClientProvider::EnqueueMessages(
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+        enqueue_messages_context) noexcept {
+  for (const auto& message_body :
+       enqueue_messages_context.request->message_bodies()) {
+    if (message_body.empty()) {
+      auto execution_result =
+          FailureExecutionResult(SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE);
+      SCP_ERROR_CONTEXT(
+          kGcpQueueClientProvider, enqueue_messages_context, execution_result,
+          "Failed to enqueue messages due to missing message body in "
+          "the request for topic: %s",
+          topic_name_.c_str());
+      enqueue_messages_context.result = execution_result;
+      enqueue_messages_context.Finish();
+      return;
+    }
+  }
+
+  auto execution_result = io_async_executor_->Schedule(
+      bind(&GcpQueueClientProvider::EnqueueMessagesAsync, this,
+           enqueue_messages_context),
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    enqueue_messages_context.result = execution_result;
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, enqueue_messages_context,
+        enqueue_messages_context.result,
+        "Enqueue Messages request failed to be scheduled. Topic: %s",
+        topic_name_.c_str());
+    enqueue_messages_context.Finish();
+  }
+}
+
+void GcpQueueClientProvider::EnqueueMessagesAsync(
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+        enqueue_messages_context) noexcept {
+  const auto& message_bodies =
+      enqueue_messages_context.request->message_bodies();
+  auto response = make_shared<EnqueueMessagesResponse>();
+  for (int begin = 0; begin < message_bodies.size();
+       begin += kMaxNumberOfMessagesPerRequest) {
+    auto end = std::min<int>(message_bodies.size(),
+                             begin + kMaxNumberOfMessagesPerRequest);
+    PublishRequest publish_request;
+    publish_request.set_topic(topic_name_);
+    for (auto i = begin; i < end; ++i) {
+      publish_request.add_messages()->set_data(message_bodies[i]);
+    }
+
+    ClientContext client_context;
+    PublishResponse publish_response;
+    auto status = publisher_stub_->Publish(&client_context, publish_request,
+                                           &publish_response);
+    ExecutionResult execution_result = SuccessExecutionResult();
+    if (!status.ok()) {
+      execution_result = GcpUtils::GcpErrorConverter(status);
+      SCP_ERROR_CONTEXT(kGcpQueueClientProvider, enqueue_messages_context,
+                        execution_result,
+                        "Failed to enqueue messages due to GCP Pub/Sub "
+                        "service error. Topic: %s",
+                        topic_name_.c_str());
+    } else if (publish_response.message_ids_size() != end - begin) {
+      // This should never happen.
+      execution_result = FailureExecutionResult(
+          SC_GCP_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_MISMATCH);
+      SCP_ERROR_CONTEXT(
+          kGcpQueueClientProvider, enqueue_messages_context, execution_result,
+          "The number of message ids received from the response does "
+          "not match the number of messages in the request. Topic: %s",
+          topic_name_.c_str());
+    }
+
+    // A Publish is all or nothing.
+    for (auto i = begin; i < end; ++i) {
+      auto* message_result = response->add_message_results();
+      *message_result->mutable_result() = execution_result.ToProto();
+      if (execution_result.Successful()) {
+        message_result->set_message_id(
+            publish_response.message_ids(i - begin));
+      }
+    }
+  }
+
+  enqueue_messages_context.response = move(response);
+  FinishContext(SuccessExecutionResult(), enqueue_messages_context,
+                cpu_async_executor_);
+}
+
 void GcpQueueClientProvider::GetTopMessage(
     AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
         get_top_message_context) noexcept {
+  // Falls back to pulling directly while the prefetch buffer is empty.
+  if (message_prefetcher_) {
+    auto messages = message_prefetcher_->TakeMessages(1);
+    if (!messages.empty()) {
+      auto& message = messages[0];
+      auto response = make_shared<GetTopMessageResponse>();
+      response->set_message_id(move(*message.mutable_message_id()));
+      response->set_message_body(move(*message.mutable_message_body()));
+      response->set_receipt_info(move(*message.mutable_receipt_info()));
+      get_top_message_context.response = move(response);
+      FinishContext(SuccessExecutionResult(), get_top_message_context,
+                    cpu_async_executor_);
+      return;
+    }
+  }
+
   auto execution_result = io_async_executor_->Schedule(
       bind(&GcpQueueClientProvider::GetTopMessageAsync, this,
            get_top_message_context),
@@ -338,6 +553,250 @@ void GcpQueueClientProvider::GetTopMessageAsync(
                 cpu_async_executor_);
 }
 
+void GcpQueueClientProvider::GetTopMessages(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  const auto max_messages = get_top_messages_context.request->max_messages();
+  if (max_messages < 1 || max_messages > kMaxNumberOfMessagesPerGet) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES);
+    SCP_ERROR_CONTEXT(kGcpQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "Failed to get top messages due to invalid max messages "
+                      "%d. Subscription: %s",
+                      max_messages, subscription_name_.c_str());
+    get_top_messages_context.result = execution_result;
+    get_top_messages_context.Finish();
+    return;
+  }
+
+  // Falls back to pulling directly while the prefetch buffer is empty.
+  if (message_prefetcher_) {
+    auto messages = message_prefetcher_->TakeMessages(max_messages);
+    if (!messages.empty()) {
+      auto response = make_shared<GetTopMessagesResponse>();
+      for (auto& message : messages) {
+        *response->add_messages() = move(message);
+      }
+      get_top_messages_context.response = move(response);
+      FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                    cpu_async_executor_);
+      return;
+    }
+  }
+
+  auto execution_result = io_async_executor_->Schedule(
+      bind(&GcpQueueClientProvider::GetTopMessagesAsync, this,
+           get_top_messages_context),
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    get_top_messages_context.result = execution_result;
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context,
+        get_top_messages_context.result,
+        "Get Top Messages request failed to be scheduled. Topic: %s",
+        topic_name_.c_str());
+    get_top_messages_context.Finish();
+  }
+}
+
+void GcpQueueClientProvider::GetTopMessagesAsync(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  const auto max_messages = get_top_messages_context.request->max_messages();
+  PullRequest pull_request;
+  pull_request.set_subscription(subscription_name_);
+  pull_request.set_max_messages(max_messages);
+  ClientContext client_context;
+  PullResponse pull_response;
+  auto status =
+      subscriber_stub_->Pull(&client_context, pull_request, &pull_response);
+
+  if (!status.ok()) {
+    auto execution_result = GcpUtils::GcpErrorConverter(status);
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context, execution_result,
+        "Failed to get top messages due to GCP Pub/Sub service error. "
+        "Subscription: %s",
+        subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  const auto& received_messages = pull_response.received_messages();
+
+  // This should never happen.
+  if (received_messages.size() > max_messages) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED);
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context, execution_result,
+        "The number of messages received from the response is larger "
+        "than the maximum number. Subscription: %s",
+        subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  if (received_messages.empty()) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_NO_MESSAGE_RETURNED);
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context, execution_result,
+        "No messages are returned from the PubSub. Subscription: %s",
+        subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  auto response = make_shared<GetTopMessagesResponse>();
+  for (const auto& received_message : received_messages) {
+    // Messages without a body are left to be redelivered.
+    if (received_message.message().data().empty()) {
+      SCP_WARNING_CONTEXT(kGcpQueueClientProvider, get_top_messages_context,
+                          "Skipped message %s without message body.",
+                          received_message.message().message_id().c_str());
+      continue;
+    }
+    *response->add_messages() = ToQueueMessage(received_message);
+  }
+
+  if (response->messages().empty()) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY);
+    SCP_ERROR_CONTEXT(kGcpQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "The message body in the messages receiving from PubSub "
+                      "is empty. Subscription: %s",
+                      subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  get_top_messages_context.response = move(response);
+  FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                cpu_async_executor_);
+}
+
+void GcpQueueClientProvider::ReceivePrefetchedMessages(
+    size_t max_messages, seconds visibility_timeout,
+    QueueMessagePrefetcher::ReceiveMessagesCallback callback) noexcept {
+  auto execution_result = io_async_executor_->Schedule(
+      [this, max_messages, visibility_timeout, callback]() {
+        PullRequest pull_request;
+        pull_request.set_subscription(subscription_name_);
+        pull_request.set_max_messages(max_messages);
+        // Pull waits for messages to arrive until the deadline.
+        ClientContext client_context;
+        client_context.set_deadline(system_clock::now() +
+                                    seconds(kLongPollWaitTimeSeconds));
+        PullResponse pull_response;
+        auto status = subscriber_stub_->Pull(&client_context, pull_request,
+                                             &pull_response);
+        if (status.error_code() == StatusCode::DEADLINE_EXCEEDED) {
+          callback(vector<QueueMessage>());
+          return;
+        }
+        if (!status.ok()) {
+          auto execution_result = GcpUtils::GcpErrorConverter(status);
+          SCP_ERROR(kGcpQueueClientProvider, kZeroUuid, execution_result,
+                    "Failed to prefetch messages due to GCP Pub/Sub service "
+                    "error. Subscription: %s",
+                    subscription_name_.c_str());
+          callback(execution_result);
+          return;
+        }
+
+        vector<QueueMessage> messages;
+        ModifyAckDeadlineRequest modify_ack_deadline_request;
+        modify_ack_deadline_request.set_subscription(subscription_name_);
+        modify_ack_deadline_request.set_ack_deadline_seconds(
+            visibility_timeout.count());
+        for (const auto& received_message : pull_response.received_messages()) {
+          if (received_message.message().data().empty()) {
+            SCP_WARNING(kGcpQueueClientProvider, kZeroUuid,
+                        "Skipped message %s without message body.",
+                        received_message.message().message_id().c_str());
+            continue;
+          }
+          modify_ack_deadline_request.add_ack_ids(received_message.ack_id());
+          messages.push_back(ToQueueMessage(received_message));
+        }
+        if (messages.empty()) {
+          callback(move(messages));
+          return;
+        }
+
+        // Pull leaves the messages with the ack deadline of the subscription.
+        ClientContext modify_client_context;
+        Empty modify_ack_deadline_response;
+        status = subscriber_stub_->ModifyAckDeadline(
+            &modify_client_context, modify_ack_deadline_request,
+            &modify_ack_deadline_response);
+        if (!status.ok()) {
+          auto execution_result = GcpUtils::GcpErrorConverter(status);
+          SCP_ERROR(kGcpQueueClientProvider, kZeroUuid, execution_result,
+                    "Failed to modify ack deadline of prefetched messages due "
+                    "to GCP Pub/Sub service error. Subscription: %s",
+                    subscription_name_.c_str());
+          callback(execution_result);
+          return;
+        }
+        callback(move(messages));
+      },
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kGcpQueueClientProvider, kZeroUuid, execution_result,
+              "Prefetch request failed to be scheduled. Subscription: %s",
+              subscription_name_.c_str());
+    callback(execution_result);
+  }
+}
+
+void GcpQueueClientProvider::ChangePrefetchedMessagesVisibility(
+    const vector<string>& receipt_infos, seconds visibility_timeout,
+    QueueMessagePrefetcher::ChangeVisibilityCallback callback) noexcept {
+  ModifyAckDeadlineRequest modify_ack_deadline_request;
+  modify_ack_deadline_request.set_subscription(subscription_name_);
+  modify_ack_deadline_request.set_ack_deadline_seconds(
+      visibility_timeout.count());
+  for (const auto& receipt_info : receipt_infos) {
+    modify_ack_deadline_request.add_ack_ids(receipt_info);
+  }
+
+  auto execution_result = io_async_executor_->Schedule(
+      [this, receipt_infos, callback,
+       modify_ack_deadline_request = move(modify_ack_deadline_request)]() {
+        ClientContext client_context;
+        Empty modify_ack_deadline_response;
+        auto status = subscriber_stub_->ModifyAckDeadline(
+            &client_context, modify_ack_deadline_request,
+            &modify_ack_deadline_response);
+        if (!status.ok()) {
+          SCP_ERROR(kGcpQueueClientProvider, kZeroUuid,
+                    GcpUtils::GcpErrorConverter(status),
+                    "Failed to modify ack deadline of prefetched messages due "
+                    "to GCP Pub/Sub service error. Subscription: %s",
+                    subscription_name_.c_str());
+          callback({});
+          return;
+        }
+        callback(receipt_infos);
+      },
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kGcpQueueClientProvider, kZeroUuid, execution_result,
+              "Modify ack deadline request failed to be scheduled. "
+              "Subscription: %s",
+              subscription_name_.c_str());
+    callback({});
+  }
+}
+
 void GcpQueueClientProvider::UpdateMessageVisibilityTimeout(
     AsyncContext<UpdateMessageVisibilityTimeoutRequest,
                  UpdateMessageVisibilityTimeoutResponse>&
@@ -444,6 +903,21 @@ void GcpQueueClientProvider::DeleteMessage(
     return;
   }
 
+  if (delete_batcher_) {
+    delete_batcher_->Add(delete_message_context.request->receipt_info(),
+                         [this, delete_message_context](
+                             ExecutionResultOr<string> result_or) mutable {
+                           if (result_or.Successful()) {
+                             delete_message_context.response =
+                                 make_shared<DeleteMessageResponse>();
+                           }
+                           FinishContext(result_or.result(),
+                                         delete_message_context,
+                                         cpu_async_executor_);
+                         });
+    return;
+  }
+
   auto execution_result = io_async_executor_->Schedule(
       bind(&GcpQueueClientProvider::DeleteMessageAsync, this,
            delete_message_context),
@@ -488,6 +962,82 @@ void GcpQueueClientProvider::DeleteMessageAsync(
                 cpu_async_executor_);
 }
 
+void GcpQueueClientProvider::DeleteMessages(
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+        delete_messages_context) noexcept {
+  for (const auto& receipt_info :
+       delete_messages_context.request->receipt_infos()) {
+    if (receipt_info.empty()) {
+      auto execution_result =
+          FailureExecutionResult(SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE);
+      SCP_ERROR_CONTEXT(kGcpQueueClientProvider, delete_messages_context,
+                        execution_result,
+                        "Failed to delete messages due to missing receipt "
+                        "info in the request. Subscription: %s",
+                        subscription_name_.c_str());
+      delete_messages_context.result = execution_result;
+      delete_messages_context.Finish();
+      return;
+    }
+  }
+
+  auto execution_result = io_async_executor_->Schedule(
+      bind(&GcpQueueClientProvider::DeleteMessagesAsync, this,
+           delete_messages_context),
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    delete_messages_context.result = execution_result;
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, delete_messages_context,
+        delete_messages_context.result,
+        "Delete Messages request failed to be scheduled for subscription: %s",
+        subscription_name_.c_str());
+    delete_messages_context.Finish();
+  }
+}
+
+void GcpQueueClientProvider::DeleteMessagesAsync(
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+        delete_messages_context) noexcept {
+  const auto& receipt_infos = delete_messages_context.request->receipt_infos();
+  auto response = make_shared<DeleteMessagesResponse>();
+  for (int begin = 0; begin < receipt_infos.size();
+       begin += kMaxNumberOfMessagesPerRequest) {
+    auto end = std::min<int>(receipt_infos.size(),
+                             begin + kMaxNumberOfMessagesPerRequest);
+    AcknowledgeRequest acknowledge_request;
+    acknowledge_request.set_subscription(subscription_name_);
+    for (auto i = begin; i < end; ++i) {
+      acknowledge_request.add_ack_ids(receipt_infos[i]);
+    }
+
+    ClientContext client_context;
+    Empty acknowledge_response;
+    auto status = subscriber_stub_->Acknowledge(
+        &client_context, acknowledge_request, &acknowledge_response);
+    ExecutionResult execution_result = SuccessExecutionResult();
+    if (!status.ok()) {
+      execution_result = GcpUtils::GcpErrorConverter(status);
+      SCP_ERROR_CONTEXT(kGcpQueueClientProvider, delete_messages_context,
+                        execution_result,
+                        "Failed to acknowledge messages due to GCP Pub/Sub "
+                        "service error. Subscription: %s",
+                        subscription_name_.c_str());
+    }
+
+    // An Acknowledge is all or nothing.
+    for (auto i = begin; i < end; ++i) {
+      auto* message_result = response->add_message_results();
+      message_result->set_receipt_info(receipt_infos[i]);
+      *message_result->mutable_result() = execution_result.ToProto();
+    }
+  }
+
+  delete_messages_context.response = move(response);
+  FinishContext(SuccessExecutionResult(), delete_messages_context,
+                cpu_async_executor_);
+}
+
 string CreatePubSubServiceConfigJson() {
   // We had to hard-coded service config json here as the json created by
   // nlohmann::json is not accepted by grpc validator.
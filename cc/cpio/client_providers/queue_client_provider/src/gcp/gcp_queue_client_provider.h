@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <google/pubsub/v1/pubsub.grpc.pb.h>
 
@@ -26,6 +28,8 @@
 #include "core/interface/async_executor_interface.h"
 #include "cpio/client_providers/interface/instance_client_provider_interface.h"
 #include "cpio/client_providers/interface/queue_client_provider_interface.h"
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_batcher.h"
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_prefetcher.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/proto/queue_service/v1/queue_service.pb.h"
 
@@ -67,11 +71,21 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::EnqueueMessageResponse>&
           enqueue_message_context) noexcept override;
 
+  void EnqueueMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept override;
+
   void GetTopMessage(
       core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept override;
 
+  void GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept override;
+
   void UpdateMessageVisibilityTimeout(
       core::AsyncContext<
           cmrt::sdk::queue_service::v1::UpdateMessageVisibilityTimeoutRequest,
@@ -83,6 +97,11 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::DeleteMessageResponse>&
           delete_message_context) noexcept override;
 
+  void DeleteMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept override;
+
  private:
   /**
    * @brief Is called when the object is returned from the GCP Publish callback.
@@ -94,6 +113,17 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::EnqueueMessageResponse>&
           enqueue_message_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the GCP Publish callback
+   * of EnqueueMessages.
+   *
+   * @param enqueue_messages_context the enqueue messages context.
+   */
+  void EnqueueMessagesAsync(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the GCP Pull callback.
    *
@@ -104,6 +134,41 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the GCP Pull callback
+   * of GetTopMessages.
+   *
+   * @param get_top_messages_context the get top messages context.
+   */
+  void GetTopMessagesAsync(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept;
+
+  /**
+   * @brief Pulls messages into the prefetch buffer, waiting a while for them,
+   * and modifies their ack deadline to the visibility timeout.
+   *
+   * @param max_messages the max number of messages to pull.
+   * @param visibility_timeout the ack deadline of the messages.
+   * @param callback is called with the messages pulled.
+   */
+  void ReceivePrefetchedMessages(
+      size_t max_messages, std::chrono::seconds visibility_timeout,
+      QueueMessagePrefetcher::ReceiveMessagesCallback callback) noexcept;
+
+  /**
+   * @brief Modifies the ack deadline of the messages in the prefetch buffer.
+   *
+   * @param receipt_infos the ack IDs of the messages.
+   * @param visibility_timeout the new ack deadline.
+   * @param callback is called with the ack IDs modified.
+   */
+  void ChangePrefetchedMessagesVisibility(
+      const std::vector<std::string>& receipt_infos,
+      std::chrono::seconds visibility_timeout,
+      QueueMessagePrefetcher::ChangeVisibilityCallback callback) noexcept;
+
   /**
    * @brief Is called when the object is returned from the GCP Update Ack
    * Deadline callback.
@@ -128,6 +193,17 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::DeleteMessageResponse>&
           delete_message_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the GCP Acknowledge
+   * callback of DeleteMessages.
+   *
+   * @param delete_messages_context the delete messages context.
+   */
+  void DeleteMessagesAsync(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept;
+
   /// The configuration for queue client.
   std::shared_ptr<QueueClientOptions> queue_client_options_;
 
@@ -158,6 +234,13 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
   /// An Instance of the GCP Subscriber stub.
   std::shared_ptr<google::pubsub::v1::Subscriber::StubInterface>
       subscriber_stub_;
+
+  /// The prefetch buffer of messages, if enabled in the options.
+  std::shared_ptr<QueueMessagePrefetcher> message_prefetcher_;
+
+  /// Batch the concurrent EnqueueMessage and DeleteMessage calls, if enabled
+  /// in the options.
+  std::shared_ptr<QueueMessageBatcher> enqueue_batcher_, delete_batcher_;
 };
 
 /// Provides GCP Pub/Sub stubs.
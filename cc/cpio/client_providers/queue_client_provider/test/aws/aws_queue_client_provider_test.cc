@@ -16,7 +16,10 @@
 
 #include <gmock/gmock.h>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 #include <aws/core/Aws.h>
 #include <aws/sqs/SQSClient.h>
@@ -45,6 +48,11 @@ using Aws::SQS::SQSClient;
 using Aws::SQS::SQSErrors;
 using Aws::SQS::Model::ChangeMessageVisibilityOutcome;
 using Aws::SQS::Model::ChangeMessageVisibilityRequest;
+using Aws::SQS::Model::BatchResultErrorEntry;
+using Aws::SQS::Model::DeleteMessageBatchOutcome;
+using Aws::SQS::Model::DeleteMessageBatchRequest;
+using Aws::SQS::Model::DeleteMessageBatchResult;
+using Aws::SQS::Model::DeleteMessageBatchResultEntry;
 using Aws::SQS::Model::DeleteMessageOutcome;
 using Aws::SQS::Model::GetQueueUrlOutcome;
 using Aws::SQS::Model::GetQueueUrlResult;
@@ -53,26 +61,46 @@ using Aws::SQS::Model::QueueAttributeName;
 using Aws::SQS::Model::ReceiveMessageOutcome;
 using Aws::SQS::Model::ReceiveMessageRequest;
 using Aws::SQS::Model::ReceiveMessageResult;
+using Aws::SQS::Model::SendMessageBatchOutcome;
+using Aws::SQS::Model::SendMessageBatchRequest;
+using Aws::SQS::Model::SendMessageBatchResult;
+using Aws::SQS::Model::SendMessageBatchResultEntry;
 using Aws::SQS::Model::SendMessageOutcome;
 using Aws::SQS::Model::SendMessageRequest;
 using Aws::SQS::Model::SendMessageResult;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutResponse;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncOperation;
 using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionStatus;
 using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_AWS_INVALID_CREDENTIALS;
 using google::scp::core::errors::SC_AWS_INVALID_REQUEST;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES;
+using google::scp::core::errors::SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY;
 using google::scp::core::errors::
@@ -103,7 +131,12 @@ using std::make_shared;
 using std::make_unique;
 using std::move;
 using std::shared_ptr;
+using std::thread;
+using std::to_string;
 using std::unique_ptr;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
 using testing::_;
 using testing::Eq;
 using testing::NiceMock;
@@ -120,6 +153,7 @@ constexpr char kReceiptInfo[] = "receipt info";
 constexpr char kInvalidReceiptInfo[] = "";
 const uint8_t kDefaultMaxNumberOfMessagesReceived = 1;
 const uint8_t kDefaultMaxWaitTimeSeconds = 0;
+const uint8_t kLongPollWaitTimeSeconds = 20;
 const uint16_t kVisibilityTimeoutSeconds = 10;
 const uint16_t kInvalidVisibilityTimeoutSeconds = 50000;
 }  // namespace
@@ -339,6 +373,190 @@ TEST_F(AwsQueueClientProviderTest, EnqueueMessageCallbackFailed) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsQueueClientProviderTest, EnqueueMessagesInBatchesOfTen) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+      enqueue_messages_context;
+  enqueue_messages_context.request = make_shared<EnqueueMessagesRequest>();
+  for (int i = 0; i < 12; ++i) {
+    enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  }
+  enqueue_messages_context.callback =
+      [this](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                 enqueue_messages_context) {
+        EXPECT_SUCCESS(enqueue_messages_context.result);
+
+        const auto& message_results =
+            enqueue_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 12);
+        for (int i = 0; i < 11; ++i) {
+          EXPECT_SUCCESS(ExecutionResult(message_results[i].result()));
+          EXPECT_EQ(message_results[i].message_id(), "id_" + to_string(i));
+        }
+        // The last message failed on its own.
+        EXPECT_THAT(ExecutionResult(message_results[11].result()),
+                    ResultIs(FailureExecutionResult(
+                        SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED)));
+        finish_called_ = true;
+      };
+
+  vector<size_t> batch_sizes;
+  EXPECT_CALL(*mock_sqs_client_, SendMessageBatchAsync)
+      .Times(2)
+      .WillRepeatedly([&batch_sizes](const SendMessageBatchRequest& request,
+                                     auto callback, auto) {
+        EXPECT_EQ(request.GetQueueUrl(), kQueueUrl);
+        batch_sizes.push_back(request.GetEntries().size());
+        SendMessageBatchResult send_message_batch_result;
+        for (const auto& entry : request.GetEntries()) {
+          EXPECT_EQ(entry.GetMessageBody(), kMessageBody);
+          if (entry.GetId() == "11") {
+            BatchResultErrorEntry failed_entry;
+            failed_entry.SetId(entry.GetId());
+            failed_entry.SetCode("InternalError");
+            send_message_batch_result.AddFailed(failed_entry);
+            continue;
+          }
+          SendMessageBatchResultEntry successful_entry;
+          successful_entry.SetId(entry.GetId());
+          successful_entry.SetMessageId("id_" + entry.GetId());
+          send_message_batch_result.AddSuccessful(successful_entry);
+        }
+        SendMessageBatchOutcome send_message_batch_outcome(
+            move(send_message_batch_result));
+        callback(nullptr, request, move(send_message_batch_outcome), nullptr);
+      });
+
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_THAT(batch_sizes, testing::ElementsAre(10, 2));
+}
+
+TEST_F(AwsQueueClientProviderTest, EnqueueMessagesCallbackFailed) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+      enqueue_messages_context;
+  enqueue_messages_context.request = make_shared<EnqueueMessagesRequest>();
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.callback =
+      [this](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                 enqueue_messages_context) {
+        EXPECT_SUCCESS(enqueue_messages_context.result);
+
+        const auto& message_results =
+            enqueue_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 2);
+        for (const auto& message_result : message_results) {
+          EXPECT_THAT(
+              ExecutionResult(message_result.result()),
+              ResultIs(FailureExecutionResult(SC_AWS_INVALID_CREDENTIALS)));
+        }
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_, SendMessageBatchAsync)
+      .WillOnce([](const SendMessageBatchRequest& request, auto callback,
+                   auto) {
+        AWSError<SQSErrors> sqs_error(SQSErrors::INVALID_CLIENT_TOKEN_ID,
+                                      false);
+        SendMessageBatchOutcome send_message_batch_outcome(sqs_error);
+        callback(nullptr, request, move(send_message_batch_outcome), nullptr);
+      });
+
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, EnqueueMessagesWithEmptyMessageBody) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+      enqueue_messages_context;
+  enqueue_messages_context.request = make_shared<EnqueueMessagesRequest>();
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.request->add_message_bodies("");
+  enqueue_messages_context.callback =
+      [this](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                 enqueue_messages_context) {
+        EXPECT_THAT(enqueue_messages_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_, SendMessageBatchAsync).Times(0);
+
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, EnqueueMessageWithBatchLinger) {
+  queue_client_options_->batch_linger_duration = milliseconds(10);
+  vector<AsyncOperation> lingers;
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [&lingers](const AsyncOperation& work, Timestamp,
+                 std::function<bool()>& cancellation_callback) {
+        lingers.push_back(work);
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  auto client = make_unique<AwsQueueClientProvider>(
+      queue_client_options_, mock_instance_client_, cpu_async_executor,
+      make_shared<MockAsyncExecutor>(), mock_sqs_client_factory_);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  EXPECT_CALL(*mock_sqs_client_, SendMessageAsync).Times(0);
+  EXPECT_CALL(*mock_sqs_client_, SendMessageBatchAsync)
+      .WillOnce([](const SendMessageBatchRequest& request, auto callback,
+                   auto) {
+        EXPECT_EQ(request.GetEntries().size(), 2);
+        SendMessageBatchResult send_message_batch_result;
+        for (const auto& entry : request.GetEntries()) {
+          SendMessageBatchResultEntry successful_entry;
+          successful_entry.SetId(entry.GetId());
+          successful_entry.SetMessageId(entry.GetMessageBody());
+          send_message_batch_result.AddSuccessful(successful_entry);
+        }
+        SendMessageBatchOutcome send_message_batch_outcome(
+            move(send_message_batch_result));
+        callback(nullptr, request, move(send_message_batch_outcome), nullptr);
+      });
+
+  // Both messages are sent in one batch once the linger passed.
+  atomic_bool first_finished{false};
+  atomic_bool second_finished{false};
+  AsyncContext<EnqueueMessageRequest, EnqueueMessageResponse> first_context(
+      make_shared<EnqueueMessageRequest>(), [&first_finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->message_id(), "first");
+        first_finished = true;
+      });
+  first_context.request->set_message_body("first");
+  AsyncContext<EnqueueMessageRequest, EnqueueMessageResponse> second_context(
+      make_shared<EnqueueMessageRequest>(), [&second_finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->message_id(), "second");
+        second_finished = true;
+      });
+  second_context.request->set_message_body("second");
+  client->EnqueueMessage(first_context);
+  client->EnqueueMessage(second_context);
+  EXPECT_FALSE(first_finished.load());
+
+  ASSERT_EQ(lingers.size(), 1);
+  lingers[0]();
+  WaitUntil([&]() { return first_finished.load() && second_finished.load(); });
+  EXPECT_SUCCESS(client->Stop());
+}
+
 MATCHER_P3(HasReceiveMessageRequestParams, queue_url, max_number_of_messages,
            wait_time_seconds, "") {
   return ExplainMatchResult(Eq(queue_url), arg.GetQueueUrl(),
@@ -526,6 +744,173 @@ TEST_F(AwsQueueClientProviderTest, GetTopMessageCallbackWithMulitpleMessages) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsQueueClientProviderTest, GetTopMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context;
+  get_top_messages_context.request = make_shared<GetTopMessagesRequest>();
+  get_top_messages_context.request->set_max_messages(3);
+  get_top_messages_context.callback =
+      [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                 get_top_messages_context) {
+        EXPECT_SUCCESS(get_top_messages_context.result);
+
+        // The message without body is skipped.
+        ASSERT_EQ(get_top_messages_context.response->messages_size(), 1);
+        const auto& message = get_top_messages_context.response->messages(0);
+        EXPECT_EQ(message.message_id(), kMessageId);
+        EXPECT_EQ(message.message_body(), kMessageBody);
+        EXPECT_EQ(message.receipt_info(), kReceiptInfo);
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_,
+              ReceiveMessageAsync(
+                  HasReceiveMessageRequestParams(kQueueUrl, 3,
+                                                 kDefaultMaxWaitTimeSeconds),
+                  _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        ReceiveMessageRequest receive_message_request;
+        Message message;
+        message.SetMessageId(kMessageId);
+        message.SetBody(kMessageBody);
+        message.SetReceiptHandle(kReceiptInfo);
+        Message message_without_body;
+        message_without_body.SetMessageId(kMessageId);
+        message_without_body.SetReceiptHandle(kReceiptInfo);
+        Vector<Message> messages;
+        messages.push_back(message);
+        messages.push_back(message_without_body);
+        ReceiveMessageResult receive_message_result;
+        receive_message_result.SetMessages(messages);
+        ReceiveMessageOutcome receive_message_outcome(
+            move(receive_message_result));
+        callback(nullptr, receive_message_request,
+                 move(receive_message_outcome), nullptr);
+      });
+
+  queue_client_provider_->GetTopMessages(get_top_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, GetTopMessagesWithInvalidMaxMessages) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context;
+  get_top_messages_context.request = make_shared<GetTopMessagesRequest>();
+  get_top_messages_context.request->set_max_messages(11);
+  get_top_messages_context.callback =
+      [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                 get_top_messages_context) {
+        EXPECT_THAT(get_top_messages_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_, ReceiveMessageAsync).Times(0);
+
+  queue_client_provider_->GetTopMessages(get_top_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, RunWithInvalidPrefetchLeaseDuration) {
+  queue_client_options_->prefetch_buffer_size = 10;
+  queue_client_options_->prefetch_lease_duration = seconds(601);
+  auto client = make_unique<AwsQueueClientProvider>(
+      queue_client_options_, mock_instance_client_,
+      make_shared<MockAsyncExecutor>(), make_shared<MockAsyncExecutor>(),
+      mock_sqs_client_factory_);
+
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_THAT(
+      client->Run(),
+      ResultIs(FailureExecutionResult(
+          SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT)));
+}
+
+TEST_F(AwsQueueClientProviderTest, GetTopMessageFromPrefetchBuffer) {
+  queue_client_options_->prefetch_buffer_size = 2;
+  // The lease extensions are not run.
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [](const AsyncOperation& work, Timestamp,
+         std::function<bool()>& cancellation_callback) {
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  auto client = make_unique<AwsQueueClientProvider>(
+      queue_client_options_, mock_instance_client_, cpu_async_executor,
+      make_shared<MockAsyncExecutor>(), mock_sqs_client_factory_);
+
+  EXPECT_CALL(*mock_sqs_client_,
+              ReceiveMessageAsync(HasReceiveMessageRequestParams(
+                                      kQueueUrl, 2, kLongPollWaitTimeSeconds),
+                                  _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        ReceiveMessageRequest receive_message_request;
+        Message message;
+        message.SetMessageId(kMessageId);
+        message.SetBody(kMessageBody);
+        message.SetReceiptHandle(kReceiptInfo);
+        Vector<Message> messages;
+        messages.push_back(message);
+        ReceiveMessageResult receive_message_result;
+        receive_message_result.SetMessages(messages);
+        ReceiveMessageOutcome receive_message_outcome(
+            move(receive_message_result));
+        callback(nullptr, receive_message_request,
+                 move(receive_message_outcome), nullptr);
+      });
+  // The next receive into the buffer is still waiting on Stop.
+  Aws::SQS::ReceiveMessageResponseReceivedHandler pending_receive;
+  EXPECT_CALL(*mock_sqs_client_,
+              ReceiveMessageAsync(HasReceiveMessageRequestParams(
+                                      kQueueUrl, 1, kLongPollWaitTimeSeconds),
+                                  _, _))
+      .WillOnce([&pending_receive](auto, auto callback, auto) {
+        pending_receive = callback;
+      });
+
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  get_top_message_context_.callback =
+      [this](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
+                 get_top_message_context) {
+        EXPECT_SUCCESS(get_top_message_context.result);
+
+        EXPECT_EQ(get_top_message_context.response->message_id(), kMessageId);
+        EXPECT_EQ(get_top_message_context.response->message_body(),
+                  kMessageBody);
+        EXPECT_EQ(get_top_message_context.response->receipt_info(),
+                  kReceiptInfo);
+        finish_called_ = true;
+      };
+
+  client->GetTopMessage(get_top_message_context_);
+  WaitUntil([this]() { return finish_called_.load(); });
+
+  // Stop does not return while the receive may still call into the provider.
+  ASSERT_TRUE(pending_receive);
+  atomic_bool is_stopped{false};
+  thread stop_thread([&client, &is_stopped]() {
+    EXPECT_SUCCESS(client->Stop());
+    is_stopped = true;
+  });
+  std::this_thread::sleep_for(milliseconds(50));
+  EXPECT_FALSE(is_stopped.load());
+  AWSError<SQSErrors> sqs_error(SQSErrors::INVALID_CLIENT_TOKEN_ID, false);
+  pending_receive(nullptr, ReceiveMessageRequest(),
+                  ReceiveMessageOutcome(sqs_error), nullptr);
+  stop_thread.join();
+  EXPECT_TRUE(is_stopped.load());
+}
+
 MATCHER_P3(HasChangeVisibilityRequestParams, queue_url, visibility_timeout,
            receipt_handle, "") {
   return ExplainMatchResult(Eq(queue_url), arg.GetQueueUrl(),
@@ -724,4 +1109,125 @@ TEST_F(AwsQueueClientProviderTest, DeleteMessageCallbackFailed) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(AwsQueueClientProviderTest, DeleteMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>
+      delete_messages_context;
+  delete_messages_context.request = make_shared<DeleteMessagesRequest>();
+  delete_messages_context.request->add_receipt_infos("receipt_0");
+  delete_messages_context.request->add_receipt_infos("receipt_1");
+  delete_messages_context.callback =
+      [this](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                 delete_messages_context) {
+        EXPECT_SUCCESS(delete_messages_context.result);
+
+        const auto& message_results =
+            delete_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 2);
+        EXPECT_EQ(message_results[0].receipt_info(), "receipt_0");
+        EXPECT_SUCCESS(ExecutionResult(message_results[0].result()));
+        // The second message is no longer in flight.
+        EXPECT_EQ(message_results[1].receipt_info(), "receipt_1");
+        EXPECT_THAT(ExecutionResult(message_results[1].result()),
+                    ResultIs(FailureExecutionResult(
+                        SC_AWS_QUEUE_CLIENT_PROVIDER_BATCH_ENTRY_FAILED)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_, DeleteMessageBatchAsync)
+      .WillOnce([](const DeleteMessageBatchRequest& request, auto callback,
+                   auto) {
+        EXPECT_EQ(request.GetQueueUrl(), kQueueUrl);
+        const auto& entries = request.GetEntries();
+        EXPECT_EQ(entries.size(), 2);
+        EXPECT_EQ(entries[0].GetReceiptHandle(), "receipt_0");
+        EXPECT_EQ(entries[1].GetReceiptHandle(), "receipt_1");
+        DeleteMessageBatchResult delete_message_batch_result;
+        DeleteMessageBatchResultEntry successful_entry;
+        successful_entry.SetId(entries[0].GetId());
+        delete_message_batch_result.AddSuccessful(successful_entry);
+        BatchResultErrorEntry failed_entry;
+        failed_entry.SetId(entries[1].GetId());
+        failed_entry.SetCode("ReceiptHandleIsInvalid");
+        delete_message_batch_result.AddFailed(failed_entry);
+        DeleteMessageBatchOutcome delete_message_batch_outcome(
+            move(delete_message_batch_result));
+        callback(nullptr, request, move(delete_message_batch_outcome),
+                 nullptr);
+      });
+
+  queue_client_provider_->DeleteMessages(delete_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, DeleteMessagesWithEmptyReceiptInfo) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>
+      delete_messages_context;
+  delete_messages_context.request = make_shared<DeleteMessagesRequest>();
+  delete_messages_context.request->add_receipt_infos(kInvalidReceiptInfo);
+  delete_messages_context.callback =
+      [this](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                 delete_messages_context) {
+        EXPECT_THAT(delete_messages_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_RECEIPT_INFO)));
+        finish_called_ = true;
+      };
+
+  EXPECT_CALL(*mock_sqs_client_, DeleteMessageBatchAsync).Times(0);
+
+  queue_client_provider_->DeleteMessages(delete_messages_context);
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, StopSendsPendingDeleteMessageBatch) {
+  queue_client_options_->batch_linger_duration = milliseconds(10);
+  // The lingers never pass.
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [](const AsyncOperation& work, Timestamp,
+         std::function<bool()>& cancellation_callback) {
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  auto client = make_unique<AwsQueueClientProvider>(
+      queue_client_options_, mock_instance_client_, cpu_async_executor,
+      make_shared<MockAsyncExecutor>(), mock_sqs_client_factory_);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  EXPECT_CALL(*mock_sqs_client_, DeleteMessageAsync).Times(0);
+  EXPECT_CALL(*mock_sqs_client_, DeleteMessageBatchAsync)
+      .WillOnce([](const DeleteMessageBatchRequest& request, auto callback,
+                   auto) {
+        EXPECT_EQ(request.GetEntries().size(), 1);
+        DeleteMessageBatchResult delete_message_batch_result;
+        DeleteMessageBatchResultEntry successful_entry;
+        successful_entry.SetId(request.GetEntries()[0].GetId());
+        delete_message_batch_result.AddSuccessful(successful_entry);
+        DeleteMessageBatchOutcome delete_message_batch_outcome(
+            move(delete_message_batch_result));
+        callback(nullptr, request, move(delete_message_batch_outcome),
+                 nullptr);
+      });
+
+  delete_message_context_.request->set_receipt_info(kReceiptInfo);
+  delete_message_context_.callback =
+      [this](AsyncContext<DeleteMessageRequest, DeleteMessageResponse>&
+                 delete_message_context) {
+        EXPECT_SUCCESS(delete_message_context.result);
+        finish_called_ = true;
+      };
+  client->DeleteMessage(delete_message_context_);
+  EXPECT_FALSE(finish_called_.load());
+
+  EXPECT_SUCCESS(client->Stop());
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 }  // namespace google::scp::cpio::client_providers::test
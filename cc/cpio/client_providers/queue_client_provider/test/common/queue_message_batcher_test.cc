@@ -0,0 +1,215 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_batcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncOperation;
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace google::scp::cpio::client_providers::test {
+class QueueMessageBatcherTest : public testing::Test {
+ protected:
+  struct Flush {
+    vector<string> items;
+    QueueMessageBatcher::FlushCallback callback;
+  };
+
+  QueueMessageBatcherTest() {
+    cpu_async_executor_->schedule_for_mock =
+        [this](const AsyncOperation& work, Timestamp,
+               std::function<bool()>& cancellation_callback) {
+          scheduled_work_.push_back(work);
+          cancellation_callback = [this]() {
+            ++cancelled_count_;
+            return true;
+          };
+          return SuccessExecutionResult();
+        };
+    batcher_ = make_shared<QueueMessageBatcher>(
+        3 /*max_batch_size*/, milliseconds(10),
+        [this](vector<string> items,
+               QueueMessageBatcher::FlushCallback callback) {
+          flushes_.push_back(Flush{move(items), move(callback)});
+        },
+        cpu_async_executor_);
+  }
+
+  void Add(const string& item) {
+    batcher_->Add(item, [this](ExecutionResultOr<string> result) {
+      results_.push_back(move(result));
+    });
+  }
+
+  shared_ptr<MockAsyncExecutor> cpu_async_executor_ =
+      make_shared<MockAsyncExecutor>();
+  shared_ptr<QueueMessageBatcher> batcher_;
+  vector<Flush> flushes_;
+  vector<ExecutionResultOr<string>> results_;
+  vector<AsyncOperation> scheduled_work_;
+  int cancelled_count_ = 0;
+};
+
+TEST_F(QueueMessageBatcherTest, SendsFullBatch) {
+  Add("a");
+  Add("b");
+  EXPECT_THAT(flushes_, IsEmpty());
+  Add("c");
+  ASSERT_EQ(flushes_.size(), 1);
+  EXPECT_THAT(flushes_[0].items, ElementsAre("a", "b", "c"));
+  // The linger of the batch is cancelled.
+  EXPECT_EQ(scheduled_work_.size(), 1);
+  EXPECT_EQ(cancelled_count_, 1);
+
+  // A new batch lingers again.
+  Add("d");
+  EXPECT_EQ(scheduled_work_.size(), 2);
+  EXPECT_EQ(flushes_.size(), 1);
+}
+
+TEST_F(QueueMessageBatcherTest, SendsBatchOnceLingerPassed) {
+  Add("a");
+  Add("b");
+  ASSERT_EQ(scheduled_work_.size(), 1);
+  scheduled_work_[0]();
+  ASSERT_EQ(flushes_.size(), 1);
+  EXPECT_THAT(flushes_[0].items, ElementsAre("a", "b"));
+}
+
+TEST_F(QueueMessageBatcherTest, IgnoresLingerOfSentBatch) {
+  Add("a");
+  Add("b");
+  Add("c");
+  Add("d");
+  ASSERT_EQ(scheduled_work_.size(), 2);
+  // The linger of the first batch does not send the second one.
+  scheduled_work_[0]();
+  EXPECT_EQ(flushes_.size(), 1);
+  scheduled_work_[1]();
+  ASSERT_EQ(flushes_.size(), 2);
+  EXPECT_THAT(flushes_[1].items, ElementsAre("d"));
+}
+
+TEST_F(QueueMessageBatcherTest, SendsBatchRightAwayIfLingerFailsToSchedule) {
+  cpu_async_executor_->schedule_for_mock =
+      [](const AsyncOperation&, Timestamp, std::function<bool()>&) {
+        return FailureExecutionResult(SC_UNKNOWN);
+      };
+  Add("a");
+  ASSERT_EQ(flushes_.size(), 1);
+  EXPECT_THAT(flushes_[0].items, ElementsAre("a"));
+}
+
+TEST_F(QueueMessageBatcherTest, CallsBackEachItem) {
+  Add("a");
+  Add("b");
+  Add("c");
+  ASSERT_EQ(flushes_.size(), 1);
+  // The result of the last item is missing.
+  flushes_[0].callback({string("id_a"), FailureExecutionResult(SC_UNKNOWN)});
+  ASSERT_EQ(results_.size(), 3);
+  ASSERT_SUCCESS(results_[0]);
+  EXPECT_EQ(*results_[0], "id_a");
+  EXPECT_THAT(results_[1], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  EXPECT_THAT(results_[2], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+}
+
+TEST_F(QueueMessageBatcherTest, StopSendsPendingBatch) {
+  Add("a");
+  EXPECT_SUCCESS(batcher_->Stop());
+  EXPECT_EQ(cancelled_count_, 1);
+  ASSERT_EQ(flushes_.size(), 1);
+  EXPECT_THAT(flushes_[0].items, ElementsAre("a"));
+
+  ASSERT_EQ(scheduled_work_.size(), 1);
+  scheduled_work_[0]();
+  EXPECT_EQ(flushes_.size(), 1);
+}
+
+TEST_F(QueueMessageBatcherTest, FlushesWithEnqueueMessages) {
+  auto flush = QueueMessageBatcher::FlushWithEnqueueMessages(
+      [](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+             context) {
+        EXPECT_THAT(context.request->message_bodies(), ElementsAre("a", "b"));
+        context.response = make_shared<EnqueueMessagesResponse>();
+        auto* message_result = context.response->add_message_results();
+        message_result->mutable_result()->CopyFrom(
+            SuccessExecutionResult().ToProto());
+        message_result->set_message_id("id_a");
+        context.response->add_message_results()->mutable_result()->CopyFrom(
+            FailureExecutionResult(SC_UNKNOWN).ToProto());
+        context.result = SuccessExecutionResult();
+        context.Finish();
+      });
+
+  vector<ExecutionResultOr<string>> results;
+  flush({"a", "b"}, [&results](vector<ExecutionResultOr<string>> flushed) {
+    results = move(flushed);
+  });
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_SUCCESS(results[0]);
+  EXPECT_EQ(*results[0], "id_a");
+  EXPECT_THAT(results[1], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+}
+
+TEST_F(QueueMessageBatcherTest, FlushesWithFailedDeleteMessages) {
+  auto flush = QueueMessageBatcher::FlushWithDeleteMessages(
+      [](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+             context) {
+        EXPECT_THAT(context.request->receipt_infos(), ElementsAre("a", "b"));
+        context.result = FailureExecutionResult(SC_UNKNOWN);
+        context.Finish();
+      });
+
+  vector<ExecutionResultOr<string>> results;
+  flush({"a", "b"}, [&results](vector<ExecutionResultOr<string>> flushed) {
+    results = move(flushed);
+  });
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_THAT(results[0], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  EXPECT_THAT(results[1], ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpio/client_providers/queue_client_provider/src/common/queue_message_prefetcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/test/utils/conditional_wait.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cmrt::sdk::queue_service::v1::QueueMessage;
+using google::scp::core::AsyncOperation;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::test::WaitUntil;
+using std::atomic_bool;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace {
+constexpr seconds kLeaseDuration = seconds(30);
+}  // namespace
+
+namespace google::scp::cpio::client_providers::test {
+class QueueMessagePrefetcherTest : public testing::Test {
+ protected:
+  struct Receive {
+    size_t max_messages;
+    seconds visibility_timeout;
+    QueueMessagePrefetcher::ReceiveMessagesCallback callback;
+    bool is_finished = false;
+  };
+
+  struct VisibilityChange {
+    vector<string> receipt_infos;
+    seconds visibility_timeout;
+    QueueMessagePrefetcher::ChangeVisibilityCallback callback;
+    bool is_finished = false;
+  };
+
+  QueueMessagePrefetcherTest() {
+    cpu_async_executor_->schedule_for_mock =
+        [this](const AsyncOperation& work, Timestamp,
+               std::function<bool()>& cancellation_callback) {
+          scheduled_work_.push_back(work);
+          cancellation_callback = [this]() {
+            ++cancelled_count_;
+            return true;
+          };
+          return SuccessExecutionResult();
+        };
+  }
+
+  ~QueueMessagePrefetcherTest() {
+    if (prefetcher_) {
+      // Stop waits for the calls in flight, so they are finished first.
+      finishes_visibility_changes_ = true;
+      FinishPendingCalls();
+      EXPECT_SUCCESS(prefetcher_->Stop());
+    }
+  }
+
+  void CreatePrefetcher(size_t buffer_size,
+                        seconds lease_duration = kLeaseDuration) {
+    prefetcher_ = make_shared<QueueMessagePrefetcher>(
+        buffer_size, lease_duration,
+        [this](size_t max_messages, seconds visibility_timeout,
+               QueueMessagePrefetcher::ReceiveMessagesCallback callback) {
+          lock_guard lock(mutex_);
+          auto index = receives_.size();
+          receives_.push_back(Receive{
+              max_messages, visibility_timeout,
+              [this, index, callback](auto messages_or) {
+                {
+                  lock_guard lock(mutex_);
+                  receives_[index].is_finished = true;
+                }
+                callback(move(messages_or));
+              }});
+        },
+        [this](const vector<string>& receipt_infos, seconds visibility_timeout,
+               QueueMessagePrefetcher::ChangeVisibilityCallback callback) {
+          QueueMessagePrefetcher::ChangeVisibilityCallback tracked_callback;
+          {
+            lock_guard lock(mutex_);
+            auto index = visibility_changes_.size();
+            tracked_callback = [this, index, callback](auto receipt_infos) {
+              {
+                lock_guard lock(mutex_);
+                visibility_changes_[index].is_finished = true;
+              }
+              callback(move(receipt_infos));
+            };
+            visibility_changes_.push_back(VisibilityChange{
+                receipt_infos, visibility_timeout, tracked_callback});
+            if (!finishes_visibility_changes_) {
+              return;
+            }
+          }
+          tracked_callback(receipt_infos);
+        },
+        cpu_async_executor_);
+  }
+
+  // Fails the receives in flight, which only schedules a retry, and finishes
+  // the visibility changes in flight.
+  void FinishPendingCalls() {
+    for (size_t i = 0;; ++i) {
+      QueueMessagePrefetcher::ReceiveMessagesCallback callback;
+      {
+        lock_guard lock(mutex_);
+        if (i >= receives_.size()) {
+          break;
+        }
+        if (!receives_[i].is_finished) {
+          callback = receives_[i].callback;
+        }
+      }
+      if (callback) {
+        callback(FailureExecutionResult(SC_UNKNOWN));
+      }
+    }
+    for (size_t i = 0;; ++i) {
+      QueueMessagePrefetcher::ChangeVisibilityCallback callback;
+      vector<string> receipt_infos;
+      {
+        lock_guard lock(mutex_);
+        if (i >= visibility_changes_.size()) {
+          break;
+        }
+        if (!visibility_changes_[i].is_finished) {
+          callback = visibility_changes_[i].callback;
+          receipt_infos = visibility_changes_[i].receipt_infos;
+        }
+      }
+      if (callback) {
+        callback(move(receipt_infos));
+      }
+    }
+  }
+
+  // Finishes the last receive with count messages numbered from first.
+  void FinishReceive(int first, int count) {
+    vector<QueueMessage> messages;
+    for (int i = first; i < first + count; ++i) {
+      QueueMessage message;
+      message.set_message_id(to_string(i));
+      message.set_receipt_info("receipt_" + to_string(i));
+      messages.push_back(move(message));
+    }
+    QueueMessagePrefetcher::ReceiveMessagesCallback callback;
+    {
+      lock_guard lock(mutex_);
+      callback = receives_.back().callback;
+    }
+    callback(move(messages));
+  }
+
+  static vector<string> MessageIds(const vector<QueueMessage>& messages) {
+    vector<string> message_ids;
+    for (const auto& message : messages) {
+      message_ids.push_back(message.message_id());
+    }
+    return message_ids;
+  }
+
+  shared_ptr<MockAsyncExecutor> cpu_async_executor_ =
+      make_shared<MockAsyncExecutor>();
+  shared_ptr<QueueMessagePrefetcher> prefetcher_;
+  // Guards the calls, which Stop may make on another thread.
+  std::mutex mutex_;
+  vector<Receive> receives_;
+  vector<VisibilityChange> visibility_changes_;
+  // Whether visibility changes are finished as soon as they are made.
+  atomic_bool finishes_visibility_changes_{false};
+  vector<AsyncOperation> scheduled_work_;
+  int cancelled_count_ = 0;
+};
+
+TEST_F(QueueMessagePrefetcherTest, FillsBufferOneReceiveAtATime) {
+  CreatePrefetcher(15 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  ASSERT_EQ(receives_.size(), 1);
+  EXPECT_EQ(receives_[0].max_messages, 10);
+  EXPECT_EQ(receives_[0].visibility_timeout, kLeaseDuration);
+
+  // A receive which got nothing is sent again.
+  FinishReceive(0, 0);
+  ASSERT_EQ(receives_.size(), 2);
+  FinishReceive(0, 10);
+  ASSERT_EQ(receives_.size(), 3);
+  EXPECT_EQ(receives_[2].max_messages, 5);
+  FinishReceive(10, 5);
+  // The buffer is full.
+  EXPECT_EQ(receives_.size(), 3);
+
+  EXPECT_THAT(MessageIds(prefetcher_->TakeMessages(3)),
+              ElementsAre("0", "1", "2"));
+  ASSERT_EQ(receives_.size(), 4);
+  EXPECT_EQ(receives_[3].max_messages, 3);
+}
+
+TEST_F(QueueMessagePrefetcherTest, TakesNothingFromEmptyBuffer) {
+  CreatePrefetcher(5 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  EXPECT_THAT(prefetcher_->TakeMessages(1), IsEmpty());
+  // The receive in flight is not sent again.
+  EXPECT_EQ(receives_.size(), 1);
+}
+
+TEST_F(QueueMessagePrefetcherTest, ExtendsLeasesOfBufferedMessages) {
+  CreatePrefetcher(2 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  FinishReceive(0, 2);
+  EXPECT_THAT(MessageIds(prefetcher_->TakeMessages(1)), ElementsAre("0"));
+
+  ASSERT_EQ(scheduled_work_.size(), 1);
+  scheduled_work_[0]();
+  ASSERT_EQ(visibility_changes_.size(), 1);
+  EXPECT_THAT(visibility_changes_[0].receipt_infos, ElementsAre("receipt_1"));
+  EXPECT_EQ(visibility_changes_[0].visibility_timeout, kLeaseDuration);
+  visibility_changes_[0].callback({"receipt_1"});
+  // The next extension is scheduled.
+  EXPECT_EQ(scheduled_work_.size(), 2);
+}
+
+TEST_F(QueueMessagePrefetcherTest, DropsMessagesWhoseLeaseRanOut) {
+  CreatePrefetcher(2 /*buffer_size*/, seconds(0) /*lease_duration*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  FinishReceive(0, 2);
+  EXPECT_THAT(prefetcher_->TakeMessages(2), IsEmpty());
+  // The room left is filled again.
+  ASSERT_EQ(receives_.size(), 2);
+  EXPECT_EQ(receives_[1].max_messages, 2);
+}
+
+TEST_F(QueueMessagePrefetcherTest, RetriesFailedReceiveLater) {
+  CreatePrefetcher(2 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  receives_.back().callback(FailureExecutionResult(SC_UNKNOWN));
+  EXPECT_EQ(receives_.size(), 1);
+
+  // The lease extension and the retry are scheduled.
+  ASSERT_EQ(scheduled_work_.size(), 2);
+  scheduled_work_[1]();
+  EXPECT_EQ(receives_.size(), 2);
+}
+
+TEST_F(QueueMessagePrefetcherTest, StopReleasesMessages) {
+  CreatePrefetcher(4 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  FinishReceive(0, 2);
+  ASSERT_EQ(receives_.size(), 2);
+
+  finishes_visibility_changes_ = true;
+  thread stop_thread([this]() { EXPECT_SUCCESS(prefetcher_->Stop()); });
+  WaitUntil([this]() {
+    lock_guard lock(mutex_);
+    return !visibility_changes_.empty();
+  });
+  EXPECT_THAT(visibility_changes_[0].receipt_infos,
+              ElementsAre("receipt_0", "receipt_1"));
+  EXPECT_EQ(visibility_changes_[0].visibility_timeout, seconds(0));
+
+  // The messages of the receive in flight are released too.
+  FinishReceive(2, 1);
+  stop_thread.join();
+  EXPECT_EQ(cancelled_count_, 1);
+  ASSERT_EQ(visibility_changes_.size(), 2);
+  EXPECT_THAT(visibility_changes_[1].receipt_infos, ElementsAre("receipt_2"));
+  EXPECT_EQ(visibility_changes_[1].visibility_timeout, seconds(0));
+  EXPECT_EQ(receives_.size(), 2);
+  EXPECT_THAT(prefetcher_->TakeMessages(1), IsEmpty());
+}
+
+TEST_F(QueueMessagePrefetcherTest, StopWaitsForReceiveInFlight) {
+  CreatePrefetcher(4 /*buffer_size*/);
+  EXPECT_SUCCESS(prefetcher_->Run());
+  ASSERT_EQ(receives_.size(), 1);
+
+  atomic_bool is_stopped{false};
+  thread stop_thread([this, &is_stopped]() {
+    EXPECT_SUCCESS(prefetcher_->Stop());
+    is_stopped = true;
+  });
+  // The receive may still call into the provider.
+  std::this_thread::sleep_for(milliseconds(50));
+  EXPECT_FALSE(is_stopped.load());
+
+  // Nor does it return while the message received is released.
+  FinishReceive(0, 1);
+  std::this_thread::sleep_for(milliseconds(50));
+  EXPECT_FALSE(is_stopped.load());
+  {
+    lock_guard lock(mutex_);
+    ASSERT_EQ(visibility_changes_.size(), 1);
+    EXPECT_THAT(visibility_changes_[0].receipt_infos, ElementsAre("receipt_0"));
+  }
+
+  visibility_changes_[0].callback({"receipt_0"});
+  stop_thread.join();
+  EXPECT_TRUE(is_stopped.load());
+  // Nothing is received once stopped.
+  EXPECT_EQ(receives_.size(), 1);
+}
+}  // namespace google::scp::cpio::client_providers::test
@@ -14,8 +14,12 @@
 
 #include "cc/cpio/client_providers/queue_client_provider/src/gcp/gcp_queue_client_provider.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <google/pubsub/v1/pubsub.grpc.pb.h>
 
@@ -34,10 +38,16 @@
 
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -45,7 +55,11 @@ using google::cmrt::sdk::queue_service::v1::
 using google::pubsub::v1::Publisher;
 using google::pubsub::v1::Subscriber;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncOperation;
+using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_GCP_ABORTED;
 using google::scp::core::errors::SC_GCP_DATA_LOSS;
@@ -54,6 +68,8 @@ using google::scp::core::errors::SC_GCP_INVALID_ARGUMENT;
 using google::scp::core::errors::SC_GCP_PERMISSION_DENIED;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT;
+using google::scp::core::errors::
+    SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES;
 using google::scp::core::errors::SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE_BODY;
@@ -84,7 +100,12 @@ using std::make_unique;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
 using testing::_;
+using testing::ElementsAre;
 using testing::Eq;
 using testing::NiceMock;
 using testing::Return;
@@ -315,6 +336,135 @@ TEST_F(GcpQueueClientProviderTest, EnqueueMessageFailureWithPubSubError) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpQueueClientProviderTest, EnqueueMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_publisher_stub_, Publish)
+      .WillOnce([](auto, const auto& publish_request, auto* publish_response) {
+        EXPECT_EQ(publish_request.topic(), kExpectedTopicName);
+        EXPECT_EQ(publish_request.messages_size(), 2);
+        for (int i = 0; i < publish_request.messages_size(); ++i) {
+          EXPECT_EQ(publish_request.messages(i).data(), kMessageBody);
+          publish_response->add_message_ids(kMessageId + to_string(i));
+        }
+        return Status(StatusCode::OK, "");
+      });
+
+  AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+      enqueue_messages_context;
+  enqueue_messages_context.request = make_shared<EnqueueMessagesRequest>();
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.callback =
+      [this](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                 enqueue_messages_context) {
+        EXPECT_SUCCESS(enqueue_messages_context.result);
+
+        const auto& message_results =
+            enqueue_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 2);
+        for (int i = 0; i < message_results.size(); ++i) {
+          EXPECT_SUCCESS(ExecutionResult(message_results[i].result()));
+          EXPECT_EQ(message_results[i].message_id(),
+                    kMessageId + to_string(i));
+        }
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, EnqueueMessagesFailureWithPubSubError) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_publisher_stub_, Publish)
+      .WillOnce(Return(Status(StatusCode::PERMISSION_DENIED, "")));
+
+  AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>
+      enqueue_messages_context;
+  enqueue_messages_context.request = make_shared<EnqueueMessagesRequest>();
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.request->add_message_bodies(kMessageBody);
+  enqueue_messages_context.callback =
+      [this](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                 enqueue_messages_context) {
+        EXPECT_SUCCESS(enqueue_messages_context.result);
+
+        // A Publish is all or nothing.
+        const auto& message_results =
+            enqueue_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 2);
+        for (const auto& message_result : message_results) {
+          EXPECT_THAT(
+              ExecutionResult(message_result.result()),
+              ResultIs(FailureExecutionResult(SC_GCP_PERMISSION_DENIED)));
+        }
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, EnqueueMessageWithBatchLinger) {
+  queue_client_options_->batch_linger_duration = milliseconds(10);
+  vector<AsyncOperation> lingers;
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [&lingers](const AsyncOperation& work, Timestamp,
+                 std::function<bool()>& cancellation_callback) {
+        lingers.push_back(work);
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  auto client = make_unique<GcpQueueClientProvider>(
+      queue_client_options_, mock_instance_client_provider_,
+      cpu_async_executor, make_shared<MockAsyncExecutor>(),
+      mock_pubsub_stub_factory_);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  EXPECT_CALL(*mock_publisher_stub_, Publish)
+      .WillOnce([](auto, const auto& publish_request, auto* publish_response) {
+        EXPECT_EQ(publish_request.messages_size(), 2);
+        for (const auto& message : publish_request.messages()) {
+          publish_response->add_message_ids(message.data());
+        }
+        return Status(StatusCode::OK, "");
+      });
+
+  // Both messages are published together once the linger passed.
+  std::atomic_bool first_finished{false};
+  std::atomic_bool second_finished{false};
+  AsyncContext<EnqueueMessageRequest, EnqueueMessageResponse> first_context(
+      make_shared<EnqueueMessageRequest>(), [&first_finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->message_id(), "first");
+        first_finished = true;
+      });
+  first_context.request->set_message_body("first");
+  AsyncContext<EnqueueMessageRequest, EnqueueMessageResponse> second_context(
+      make_shared<EnqueueMessageRequest>(), [&second_finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->message_id(), "second");
+        second_finished = true;
+      });
+  second_context.request->set_message_body("second");
+  client->EnqueueMessage(first_context);
+  client->EnqueueMessage(second_context);
+  EXPECT_FALSE(first_finished.load());
+
+  ASSERT_EQ(lingers.size(), 1);
+  lingers[0]();
+  WaitUntil([&]() { return first_finished.load() && second_finished.load(); });
+  EXPECT_SUCCESS(client->Stop());
+}
+
 MATCHER_P2(HasPullParams, subscription_name, max_messages, "") {
   return ExplainMatchResult(Eq(subscription_name), arg.subscription(),
                             result_listener) &&
@@ -603,6 +753,162 @@ TEST_F(GcpQueueClientProviderTest,
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpQueueClientProviderTest, GetTopMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_subscriber_stub_,
+              Pull(_, HasPullParams(kExpectedSubscriptionName, 3), _))
+      .WillOnce([](auto, auto, auto* pull_response) {
+        auto* received_message = pull_response->add_received_messages();
+        received_message->mutable_message()->set_data(kMessageBody);
+        received_message->mutable_message()->set_message_id(kMessageId);
+        received_message->set_ack_id(kReceiptInfo);
+        auto* message_without_body = pull_response->add_received_messages();
+        message_without_body->mutable_message()->set_message_id(kMessageId);
+        message_without_body->set_ack_id(kReceiptInfo);
+        return Status(StatusCode::OK, "");
+      });
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context;
+  get_top_messages_context.request = make_shared<GetTopMessagesRequest>();
+  get_top_messages_context.request->set_max_messages(3);
+  get_top_messages_context.callback =
+      [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                 get_top_messages_context) {
+        EXPECT_SUCCESS(get_top_messages_context.result);
+
+        // The message without body is skipped.
+        ASSERT_EQ(get_top_messages_context.response->messages_size(), 1);
+        const auto& message = get_top_messages_context.response->messages(0);
+        EXPECT_EQ(message.message_id(), kMessageId);
+        EXPECT_EQ(message.message_body(), kMessageBody);
+        EXPECT_EQ(message.receipt_info(), kReceiptInfo);
+
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->GetTopMessages(get_top_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, GetTopMessagesWithInvalidMaxMessages) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_subscriber_stub_, Pull).Times(0);
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context;
+  get_top_messages_context.request = make_shared<GetTopMessagesRequest>();
+  get_top_messages_context.callback =
+      [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                 get_top_messages_context) {
+        EXPECT_THAT(get_top_messages_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_MESSAGES)));
+
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->GetTopMessages(get_top_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, InitWithInvalidPrefetchLeaseDuration) {
+  queue_client_options_->prefetch_buffer_size = 10;
+  queue_client_options_->prefetch_lease_duration = seconds(5);
+
+  EXPECT_THAT(
+      queue_client_provider_->Init(),
+      ResultIs(FailureExecutionResult(
+          SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT)));
+}
+
+TEST_F(GcpQueueClientProviderTest, GetTopMessageFromPrefetchBuffer) {
+  queue_client_options_->prefetch_buffer_size = 2;
+  queue_client_options_->prefetch_lease_duration = seconds(30);
+  // The lease extensions are not run, and the pulls are run by the test.
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [](const AsyncOperation& work, Timestamp,
+         std::function<bool()>& cancellation_callback) {
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  vector<AsyncOperation> io_work;
+  auto io_async_executor = make_shared<MockAsyncExecutor>();
+  io_async_executor->schedule_mock = [&io_work](const AsyncOperation& work) {
+    io_work.push_back(work);
+    return SuccessExecutionResult();
+  };
+  auto client = make_unique<GcpQueueClientProvider>(
+      queue_client_options_, mock_instance_client_provider_,
+      cpu_async_executor, io_async_executor, mock_pubsub_stub_factory_);
+
+  EXPECT_CALL(*mock_subscriber_stub_,
+              Pull(_, HasPullParams(kExpectedSubscriptionName, 2), _))
+      .WillOnce([](auto, auto, auto* pull_response) {
+        auto* received_message = pull_response->add_received_messages();
+        received_message->mutable_message()->set_data(kMessageBody);
+        received_message->mutable_message()->set_message_id(kMessageId);
+        received_message->set_ack_id(kReceiptInfo);
+        return Status(StatusCode::OK, "");
+      });
+  EXPECT_CALL(*mock_subscriber_stub_,
+              ModifyAckDeadline(_,
+                                HasModifyAckDeadlineParams(
+                                    kExpectedSubscriptionName, kReceiptInfo,
+                                    30),
+                                _))
+      .WillOnce(Return(Status(StatusCode::OK, "")));
+  // The next pull into the buffer is still waiting on Stop.
+  EXPECT_CALL(*mock_subscriber_stub_,
+              Pull(_, HasPullParams(kExpectedSubscriptionName, 1), _))
+      .WillOnce(Return(Status(StatusCode::DEADLINE_EXCEEDED, "")));
+
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+  ASSERT_EQ(io_work.size(), 1);
+  io_work[0]();
+  // The next pull into the buffer is scheduled.
+  EXPECT_EQ(io_work.size(), 2);
+
+  get_top_message_context_.callback =
+      [this](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
+                 get_top_message_context) {
+        EXPECT_SUCCESS(get_top_message_context.result);
+
+        EXPECT_EQ(get_top_message_context.response->message_id(), kMessageId);
+        EXPECT_EQ(get_top_message_context.response->message_body(),
+                  kMessageBody);
+        EXPECT_EQ(get_top_message_context.response->receipt_info(),
+                  kReceiptInfo);
+
+        finish_called_ = true;
+      };
+
+  client->GetTopMessage(get_top_message_context_);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+
+  // Stop does not return while the pull may still call into the provider.
+  ASSERT_EQ(io_work.size(), 2);
+  std::atomic_bool is_stopped{false};
+  std::thread stop_thread([&client, &is_stopped]() {
+    EXPECT_SUCCESS(client->Stop());
+    is_stopped = true;
+  });
+  std::this_thread::sleep_for(milliseconds(50));
+  EXPECT_FALSE(is_stopped.load());
+  io_work[1]();
+  stop_thread.join();
+  EXPECT_TRUE(is_stopped.load());
+}
+
 MATCHER_P2(HasAcknowledgeParams, subscription_name, ack_id, "") {
   return ExplainMatchResult(Eq(subscription_name), arg.subscription(),
                             result_listener) &&
@@ -681,4 +987,107 @@ TEST_F(GcpQueueClientProviderTest, DeleteMessageFailureWithPubSubError) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpQueueClientProviderTest, DeleteMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_subscriber_stub_, Acknowledge)
+      .WillOnce([](auto, const auto& acknowledge_request, auto) {
+        EXPECT_EQ(acknowledge_request.subscription(),
+                  kExpectedSubscriptionName);
+        EXPECT_THAT(acknowledge_request.ack_ids(),
+                    ElementsAre("receipt_0", "receipt_1"));
+        return Status(StatusCode::OK, "");
+      });
+
+  AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>
+      delete_messages_context;
+  delete_messages_context.request = make_shared<DeleteMessagesRequest>();
+  delete_messages_context.request->add_receipt_infos("receipt_0");
+  delete_messages_context.request->add_receipt_infos("receipt_1");
+  delete_messages_context.callback =
+      [this](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                 delete_messages_context) {
+        EXPECT_SUCCESS(delete_messages_context.result);
+
+        const auto& message_results =
+            delete_messages_context.response->message_results();
+        ASSERT_EQ(message_results.size(), 2);
+        for (int i = 0; i < message_results.size(); ++i) {
+          EXPECT_EQ(message_results[i].receipt_info(),
+                    "receipt_" + to_string(i));
+          EXPECT_SUCCESS(ExecutionResult(message_results[i].result()));
+        }
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->DeleteMessages(delete_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, DeleteMessagesFailureWithEmptyReceiptInfo) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_subscriber_stub_, Acknowledge).Times(0);
+
+  AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>
+      delete_messages_context;
+  delete_messages_context.request = make_shared<DeleteMessagesRequest>();
+  delete_messages_context.request->add_receipt_infos(kReceiptInfo);
+  delete_messages_context.request->add_receipt_infos("");
+  delete_messages_context.callback =
+      [this](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                 delete_messages_context) {
+        EXPECT_THAT(delete_messages_context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE)));
+
+        finish_called_ = true;
+      };
+
+  queue_client_provider_->DeleteMessages(delete_messages_context);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(GcpQueueClientProviderTest, StopAcknowledgesPendingDeleteMessageBatch) {
+  queue_client_options_->batch_linger_duration = milliseconds(10);
+  // The lingers never pass.
+  auto cpu_async_executor = make_shared<MockAsyncExecutor>();
+  cpu_async_executor->schedule_for_mock =
+      [](const AsyncOperation& work, Timestamp,
+         std::function<bool()>& cancellation_callback) {
+        cancellation_callback = []() { return true; };
+        return SuccessExecutionResult();
+      };
+  auto client = make_unique<GcpQueueClientProvider>(
+      queue_client_options_, mock_instance_client_provider_,
+      cpu_async_executor, make_shared<MockAsyncExecutor>(),
+      mock_pubsub_stub_factory_);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  EXPECT_CALL(
+      *mock_subscriber_stub_,
+      Acknowledge(
+          _, HasAcknowledgeParams(kExpectedSubscriptionName, kReceiptInfo), _))
+      .WillOnce(Return(Status(StatusCode::OK, "")));
+
+  delete_message_context_.request->set_receipt_info(kReceiptInfo);
+  delete_message_context_.callback =
+      [this](AsyncContext<DeleteMessageRequest, DeleteMessageResponse>&
+                 delete_message_context) {
+        EXPECT_SUCCESS(delete_message_context.result);
+
+        finish_called_ = true;
+      };
+  client->DeleteMessage(delete_message_context_);
+  EXPECT_FALSE(finish_called_.load());
+
+  EXPECT_SUCCESS(client->Stop());
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 }  // namespace google::scp::cpio::client_providers::gcp_queue_client::test
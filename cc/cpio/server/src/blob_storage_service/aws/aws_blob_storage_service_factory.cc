@@ -19,11 +19,10 @@
 #include <memory>
 #include <utility>
 
-#include "cpio/client_providers/blob_storage_client_provider/src/aws/aws_blob_storage_client_provider.h"
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/server/src/instance_service/aws/aws_instance_service_factory.h"
 
-using google::scp::cpio::client_providers::AwsBlobStorageClientProvider;
+using google::scp::cpio::client_providers::BlobStorageClientProviderFactory;
 using google::scp::cpio::client_providers::BlobStorageClientProviderInterface;
 using std::make_shared;
 using std::shared_ptr;
@@ -38,8 +37,10 @@ AwsBlobStorageServiceFactory::CreateInstanceServiceFactory() noexcept {
 
 std::shared_ptr<BlobStorageClientProviderInterface>
 AwsBlobStorageServiceFactory::CreateBlobStorageClient() noexcept {
-  return make_shared<AwsBlobStorageClientProvider>(
-      make_shared<BlobStorageClientOptions>(), instance_client_,
+  // The factory creates a local provider instead when a local root
+  // directory is configured.
+  return BlobStorageClientProviderFactory::Create(
+      CreateBlobStorageClientOptions(), instance_client_,
       instance_service_factory_->GetCpuAsynceExecutor(),
       instance_service_factory_->GetIoAsynceExecutor());
 }
@@ -56,6 +56,8 @@ using google::cmrt::sdk::blob_storage_service::v1::ClientConfigurationKeys;
 using google::cmrt::sdk::blob_storage_service::v1::ClientConfigurationKeys_Name;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
@@ -218,6 +220,16 @@ class BlobStorageServiceImpl : public BlobStorageService::CallbackService {
         bind(&BlobStorageClientProviderInterface::DeleteBlob,
              blob_storage_client, _1));
   }
+
+  grpc::ServerUnaryReactor* DeleteBlobs(
+      grpc::CallbackServerContext* server_context,
+      const DeleteBlobsRequest* request,
+      DeleteBlobsResponse* response) override {
+    return ExecuteNetworkCall2<DeleteBlobsRequest, DeleteBlobsResponse>(
+        server_context, request, response,
+        bind(&BlobStorageClientProviderInterface::DeleteBlobs,
+             blob_storage_client, _1));
+  }
 };
 
 int main(int argc, char* argv[]) {
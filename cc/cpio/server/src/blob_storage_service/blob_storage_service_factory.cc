@@ -16,12 +16,14 @@
 
 #include "blob_storage_service_factory.h"
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/server/interface/blob_storage_service/blob_storage_service_factory_interface.h"
+#include "cpio/server/src/service_utils.h"
 #include "public/cpio/proto/blob_storage_service/v1/configuration_keys.pb.h"
 
 using google::cmrt::sdk::blob_storage_service::v1::ClientConfigurationKeys;
@@ -30,8 +32,11 @@ using google::cmrt::sdk::blob_storage_service::v1::
 using google::scp::core::ExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
+using google::scp::cpio::TryReadConfigInt;
+using google::scp::cpio::TryReadConfigString;
 using std::make_shared;
 using std::shared_ptr;
+using std::chrono::seconds;
 
 namespace {
 constexpr char kBlobStorageServiceFactory[] = "BlobStorageServiceFactory";
@@ -61,6 +66,40 @@ BlobStorageServiceFactory::CreateInstanceServiceFactoryOptions() noexcept {
   return instance_service_factory_options;
 }
 
+shared_ptr<BlobStorageClientOptions>
+BlobStorageServiceFactory::CreateBlobStorageClientOptions() noexcept {
+  auto options = make_shared<BlobStorageClientOptions>();
+  TryReadConfigString(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::
+              CMRT_BLOB_STORAGE_CLIENT_LOCAL_ROOT_DIRECTORY),
+      options->local_root_directory);
+  TryReadConfigString(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::CMRT_BLOB_STORAGE_CLIENT_CACHE_DIRECTORY),
+      options->cache_directory);
+  int32_t cache_size_mb = options->cache_size_bytes >> 20;
+  TryReadConfigInt(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::CMRT_BLOB_STORAGE_CLIENT_CACHE_SIZE_MB),
+      cache_size_mb);
+  options->cache_size_bytes = static_cast<uint64_t>(cache_size_mb) << 20;
+  int32_t cache_revalidation_interval_in_s =
+      options->cache_revalidation_interval.count();
+  TryReadConfigInt(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::
+              CMRT_BLOB_STORAGE_CLIENT_CACHE_REVALIDATION_INTERVAL_IN_S),
+      cache_revalidation_interval_in_s);
+  options->cache_revalidation_interval =
+      seconds(cache_revalidation_interval_in_s);
+  return options;
+}
+
 ExecutionResult BlobStorageServiceFactory::Init() noexcept {
   instance_service_factory_options_ = CreateInstanceServiceFactoryOptions();
   instance_service_factory_ = CreateInstanceServiceFactory();
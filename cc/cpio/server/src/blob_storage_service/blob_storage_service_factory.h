@@ -22,6 +22,7 @@
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/server/interface/blob_storage_service/blob_storage_service_factory_interface.h"
 #include "cpio/server/interface/instance_service/instance_service_factory_interface.h"
+#include "public/cpio/interface/blob_storage_client/type_def.h"
 
 namespace google::scp::cpio {
 /// Base class for setting up protected members.
@@ -41,6 +42,10 @@ class BlobStorageServiceFactory : public BlobStorageServiceFactoryInterface {
   virtual std::shared_ptr<InstanceServiceFactoryOptions>
   CreateInstanceServiceFactoryOptions() noexcept;
 
+  /// Creates the options of the blob storage client from the configs.
+  virtual std::shared_ptr<BlobStorageClientOptions>
+  CreateBlobStorageClientOptions() noexcept;
+
   std::shared_ptr<core::ConfigProviderInterface> config_provider_;
 
   std::shared_ptr<client_providers::InstanceClientProviderInterface>
@@ -19,14 +19,13 @@
 #include <memory>
 #include <utility>
 
-#include "cpio/client_providers/blob_storage_client_provider/src/gcp/gcp_blob_storage_client_provider.h"
 #include "cpio/client_providers/interface/blob_storage_client_provider_interface.h"
 #include "cpio/server/interface/blob_storage_service/blob_storage_service_factory_interface.h"
 #include "cpio/server/src/instance_service/gcp/gcp_instance_service_factory.h"
 
 using google::scp::core::ExecutionResult;
+using google::scp::cpio::client_providers::BlobStorageClientProviderFactory;
 using google::scp::cpio::client_providers::BlobStorageClientProviderInterface;
-using google::scp::cpio::client_providers::GcpBlobStorageClientProvider;
 using std::make_shared;
 using std::shared_ptr;
 
@@ -40,8 +39,10 @@ GcpBlobStorageServiceFactory::CreateInstanceServiceFactory() noexcept {
 
 std::shared_ptr<BlobStorageClientProviderInterface>
 GcpBlobStorageServiceFactory::CreateBlobStorageClient() noexcept {
-  return make_shared<GcpBlobStorageClientProvider>(
-      make_shared<BlobStorageClientOptions>(), instance_client_,
+  // The factory creates a local provider instead when a local root
+  // directory is configured.
+  return BlobStorageClientProviderFactory::Create(
+      CreateBlobStorageClientOptions(), instance_client_,
       instance_service_factory_->GetCpuAsynceExecutor(),
       instance_service_factory_->GetIoAsynceExecutor());
 }
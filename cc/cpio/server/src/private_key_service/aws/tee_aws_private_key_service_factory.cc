@@ -17,21 +17,40 @@
 #include "tee_aws_private_key_service_factory.h"
 
 #include <memory>
+#include <string>
 
+#include "cpio/client_providers/kms_client_provider/src/aws/kmstool_decrypt_channel.h"
 #include "cpio/client_providers/kms_client_provider/src/aws/tee_aws_kms_client_provider.h"
+#include "cpio/server/src/service_utils.h"
+#include "public/cpio/proto/private_key_service/v1/configuration_keys.pb.h"
 
+using google::cmrt::sdk::private_key_service::v1::ClientConfigurationKeys;
+using google::cmrt::sdk::private_key_service::v1::ClientConfigurationKeys_Name;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::ServiceInterface;
 using google::scp::cpio::client_providers::KmsClientProviderInterface;
+using google::scp::cpio::client_providers::KmstoolDecryptChannel;
 using google::scp::cpio::client_providers::TeeAwsKmsClientProvider;
 using std::make_shared;
 using std::shared_ptr;
+using std::string;
 
 namespace google::scp::cpio {
 ExecutionResultOr<shared_ptr<ServiceInterface>>
 TeeAwsPrivateKeyServiceFactory::CreateKmsClient() noexcept {
-  kms_client_ =
-      make_shared<TeeAwsKmsClientProvider>(role_credentials_provider_);
+  string decrypt_helper_path;
+  TryReadConfigString(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::
+              CMRT_AWS_PRIVATE_KEY_CLIENT_KMSTOOL_DECRYPT_HELPER_PATH),
+      decrypt_helper_path);
+  shared_ptr<KmstoolDecryptChannel> decrypt_channel;
+  if (!decrypt_helper_path.empty()) {
+    decrypt_channel = make_shared<KmstoolDecryptChannel>(decrypt_helper_path);
+  }
+  kms_client_ = make_shared<TeeAwsKmsClientProvider>(
+      role_credentials_provider_, cpu_async_executor_, decrypt_channel);
   return kms_client_;
 }
 }  // namespace google::scp::cpio
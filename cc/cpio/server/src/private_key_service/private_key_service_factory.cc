@@ -70,6 +70,32 @@ namespace google::scp::cpio {
 ExecutionResult PrivateKeyServiceFactory::ReadConfigurations() noexcept {
   client_options_ = CreatePrivateKeyClientOptions();
 
+  int32_t key_cache_ttl_in_s = client_options_->key_cache_ttl_in_s;
+  TryReadConfigInt(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::CMRT_PRIVATE_KEY_CLIENT_KEY_CACHE_TTL_IN_S),
+      key_cache_ttl_in_s);
+  client_options_->key_cache_ttl_in_s = key_cache_ttl_in_s;
+
+  int32_t key_cache_refresh_ahead_in_s =
+      client_options_->key_cache_refresh_ahead_in_s;
+  TryReadConfigInt(
+      config_provider_,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::
+              CMRT_PRIVATE_KEY_CLIENT_KEY_CACHE_REFRESH_AHEAD_IN_S),
+      key_cache_refresh_ahead_in_s);
+  client_options_->key_cache_refresh_ahead_in_s = key_cache_refresh_ahead_in_s;
+
+  int32_t key_cache_size = client_options_->key_cache_size;
+  TryReadConfigInt(config_provider_,
+                   ClientConfigurationKeys_Name(
+                       ClientConfigurationKeys::
+                           CMRT_PRIVATE_KEY_CLIENT_KEY_CACHE_SIZE),
+                   key_cache_size);
+  client_options_->key_cache_size = key_cache_size;
+
   return SuccessExecutionResult();
 }
 
@@ -74,6 +74,7 @@ using google::scp::cpio::RunServer;
 using google::scp::cpio::SignalSegmentationHandler;
 using google::scp::cpio::Stop;
 using google::scp::cpio::StopLogger;
+using google::scp::cpio::TryReadConfigBool;
 using google::scp::cpio::TryReadConfigInt;
 using google::scp::cpio::client_providers::PublicKeyClientProviderFactory;
 using google::scp::cpio::client_providers::PublicKeyClientProviderInterface;
@@ -212,6 +213,18 @@ void RunClients() {
   options->endpoints =
       vector<string>(public_key_vending_service_endpoints.begin(),
                      public_key_vending_service_endpoints.end());
+  TryReadConfigBool(
+      config_provider,
+      ClientConfigurationKeys_Name(
+          ClientConfigurationKeys::CMRT_PUBLIC_KEY_CLIENT_ENABLE_KEY_CACHE),
+      options->enable_key_cache);
+  int32_t key_cache_refresh_ahead_in_s = options->key_cache_refresh_ahead_in_s;
+  TryReadConfigInt(config_provider,
+                   ClientConfigurationKeys_Name(
+                       ClientConfigurationKeys::
+                           CMRT_PUBLIC_KEY_CLIENT_KEY_CACHE_REFRESH_AHEAD_IN_S),
+                   key_cache_refresh_ahead_in_s);
+  options->key_cache_refresh_ahead_in_s = key_cache_refresh_ahead_in_s;
   public_key_client =
       PublicKeyClientProviderFactory::Create(options, http_client);
   Init(public_key_client, kPublicKeyClientName);
@@ -51,10 +51,16 @@ using google::cmrt::sdk::queue_service::v1::ClientConfigurationKeys;
 using google::cmrt::sdk::queue_service::v1::ClientConfigurationKeys_Name;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::QueueService;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
@@ -117,6 +123,15 @@ class QueueServiceImpl : public QueueService::CallbackService {
         bind(&QueueClientProviderInterface::EnqueueMessage, queue_client, _1));
   }
 
+  grpc::ServerUnaryReactor* EnqueueMessages(
+      grpc::CallbackServerContext* server_context,
+      const EnqueueMessagesRequest* request,
+      EnqueueMessagesResponse* response) override {
+    return ExecuteNetworkCall2<EnqueueMessagesRequest, EnqueueMessagesResponse>(
+        server_context, request, response,
+        bind(&QueueClientProviderInterface::EnqueueMessages, queue_client, _1));
+  }
+
   grpc::ServerUnaryReactor* GetTopMessage(
       grpc::CallbackServerContext* server_context,
       const GetTopMessageRequest* request,
@@ -126,6 +141,15 @@ class QueueServiceImpl : public QueueService::CallbackService {
         bind(&QueueClientProviderInterface::GetTopMessage, queue_client, _1));
   }
 
+  grpc::ServerUnaryReactor* GetTopMessages(
+      grpc::CallbackServerContext* server_context,
+      const GetTopMessagesRequest* request,
+      GetTopMessagesResponse* response) override {
+    return ExecuteNetworkCall2<GetTopMessagesRequest, GetTopMessagesResponse>(
+        server_context, request, response,
+        bind(&QueueClientProviderInterface::GetTopMessages, queue_client, _1));
+  }
+
   grpc::ServerUnaryReactor* UpdateMessageVisibilityTimeout(
       grpc::CallbackServerContext* server_context,
       const UpdateMessageVisibilityTimeoutRequest* request,
@@ -145,6 +169,15 @@ class QueueServiceImpl : public QueueService::CallbackService {
         server_context, request, response,
         bind(&QueueClientProviderInterface::DeleteMessage, queue_client, _1));
   }
+
+  grpc::ServerUnaryReactor* DeleteMessages(
+      grpc::CallbackServerContext* server_context,
+      const DeleteMessagesRequest* request,
+      DeleteMessagesResponse* response) override {
+    return ExecuteNetworkCall2<DeleteMessagesRequest, DeleteMessagesResponse>(
+        server_context, request, response,
+        bind(&QueueClientProviderInterface::DeleteMessages, queue_client, _1));
+  }
 };
 
 static void SignalHandler(int signum) {
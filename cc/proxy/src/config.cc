@@ -31,6 +31,7 @@ Config Config::Parse(int argc, char* argv[]) {
     { "tcp", no_argument, 0, 't'},
     { "port", required_argument, 0, 'p'},
     { "buffer_size", required_argument, 0, 'b'},
+    { "mux", no_argument, 0, 'm'},
     {0, 0, 0, 0}
   };
 
@@ -38,7 +39,7 @@ Config Config::Parse(int argc, char* argv[]) {
 
   while (true) {
     int opt_idx = 0;
-    int c = getopt_long(argc, argv, "tp:b:", long_options, &opt_idx);
+    int c = getopt_long(argc, argv, "tp:b:m", long_options, &opt_idx);
     if (c == -1) {
       break;
     }
@@ -50,6 +51,10 @@ Config Config::Parse(int argc, char* argv[]) {
         config.vsock_ = false;
         break;
       }
+      case 'm': {
+        config.mux_ = true;
+        break;
+      }
       case 'p': {
         char* endptr;
         std::string port_str(optarg);
@@ -29,6 +29,7 @@ struct Config {
       : buffer_size_(kDefaultBufferSize),
         socks5_port_(kDefaultPort),
         vsock_(true),
+        mux_(false),
         bad_(false) {}
 
   // Parse the command line arguments and get a Config object.
@@ -40,6 +41,9 @@ struct Config {
   uint16_t socks5_port_;
   // True if listen on vsock. Otherwise on TCP.
   bool vsock_;
+  // True if mux connections (see mux_protocol.h) are accepted besides plain
+  // SOCKS5 connections.
+  bool mux_;
   // If the config is bad.
   bool bad_;
 };
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <string.h>
+
+// The multiplexing protocol carries many logical streams over one long-lived
+// connection between the enclave and the proxy. A mux connection starts with
+// kPreamble sent by the opening side, followed by a sequence of frames in both
+// directions. Each frame is a fixed-size FrameHeader, followed by [length]
+// bytes of payload for kData frames.
+//
+// Each logical stream carries exactly the same bytes a direct connection to the
+// proxy would, i.e. the SOCKS5 handshake followed by the proxied traffic.
+//
+// Flow control is per stream and credit based. A sender may have at most
+// kInitialWindowSize bytes of kData payload that the receiver has not yet
+// acknowledged with kWindowUpdate frames.
+namespace google::scp::proxy::mux {
+
+// The first byte of the preamble must not be 0x05, so that the proxy can tell a
+// mux connection from a SOCKS5 connection by peeking the first byte.
+static constexpr uint8_t kPreamble[8] = {'S', 'C', 'P', 'M', 'U', 'X', '0', '1'};
+
+static constexpr uint32_t kInitialWindowSize = 256 * 1024;
+static constexpr uint32_t kMaxFramePayload = 32 * 1024;
+
+enum class FrameType : uint8_t {
+  // Open a new stream. No payload.
+  kOpen = 0u,
+  // Data of a stream. Payload is [length] bytes.
+  kData,
+  // Grant [length] more bytes of send window to the peer. No payload.
+  kWindowUpdate,
+  // The sender will send no more data on the stream. No payload.
+  kFin,
+  // The stream is aborted in both directions. No payload.
+  kReset,
+  // Anything not less than kInvalidFrame are invalid.
+  kInvalidFrame,
+};
+
+// Frame header in host byte order. Use Encode() and Decode() to convert from/to
+// the wire format, which is in network byte order.
+struct FrameHeader {
+  static constexpr size_t kWireSize = 12u;
+
+  uint32_t stream_id = 0u;
+  uint32_t length = 0u;
+  FrameType type = FrameType::kInvalidFrame;
+
+  FrameHeader() = default;
+
+  FrameHeader(FrameType type, uint32_t stream_id, uint32_t length = 0u)
+      : stream_id(stream_id), length(length), type(type) {}
+
+  // Serialize the header into kWireSize bytes at buf.
+  void Encode(uint8_t* buf) const {
+    uint32_t id = htonl(stream_id);
+    uint32_t len = htonl(length);
+    memcpy(buf, &id, sizeof(id));
+    memcpy(buf + 4, &len, sizeof(len));
+    buf[8] = static_cast<uint8_t>(type);
+    buf[9] = buf[10] = buf[11] = 0u;
+  }
+
+  // Deserialize the header from kWireSize bytes at buf. Returns false if the
+  // header is malformed.
+  bool Decode(const uint8_t* buf) {
+    uint32_t id, len;
+    memcpy(&id, buf, sizeof(id));
+    memcpy(&len, buf + 4, sizeof(len));
+    stream_id = ntohl(id);
+    length = ntohl(len);
+    if (buf[8] >= static_cast<uint8_t>(FrameType::kInvalidFrame)) {
+      type = FrameType::kInvalidFrame;
+      return false;
+    }
+    type = static_cast<FrameType>(buf[8]);
+    return type != FrameType::kData || length <= kMaxFramePayload;
+  }
+};
+
+}  // namespace google::scp::proxy::mux
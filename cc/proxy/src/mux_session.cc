@@ -0,0 +1,361 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mux_session.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "logging.h"
+
+using boost::asio::bind_executor;
+using boost::asio::const_buffer;
+using boost::asio::mutable_buffer;
+using boost::asio::error::eof;
+using boost::system::error_code;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::vector;
+
+namespace asio = boost::asio;
+
+namespace google::scp::proxy {
+
+using mux::FrameHeader;
+using mux::FrameType;
+
+MuxSession::~MuxSession() {
+  error_code ec;
+  transport_.close(ec);
+}
+
+void MuxSession::Start() {
+  asio::dispatch(bind_executor(
+      strand_, [self = shared_from_this()]() { self->ReadTransport(); }));
+}
+
+bool MuxSession::OpenStream(Socket local_sock) {
+  if (!open_.load()) {
+    return false;
+  }
+  // The socket is moved into a shared_ptr, as asio handlers must be copyable.
+  auto sock = make_shared<Socket>(move(local_sock));
+  asio::dispatch(
+      bind_executor(strand_, [self = shared_from_this(), sock]() {
+        if (!self->open_.load()) {
+          error_code ec;
+          sock->close(ec);
+          return;
+        }
+        uint32_t id = self->next_stream_id_;
+        self->next_stream_id_ += 2;
+        self->SendFrame(FrameHeader(FrameType::kOpen, id));
+        self->AddStream(id, move(*sock));
+      }));
+  return true;
+}
+
+void MuxSession::Close() {
+  asio::dispatch(bind_executor(
+      strand_, [self = shared_from_this()]() { self->DoClose(); }));
+}
+
+void MuxSession::DoClose() {
+  if (!open_.exchange(false)) {
+    return;
+  }
+  error_code ec;
+  transport_.close(ec);
+  for (auto& [id, stream] : streams_) {
+    stream->closed = true;
+    stream->sock.close(ec);
+  }
+  streams_.clear();
+  num_streams_.store(0u);
+}
+
+void MuxSession::ReadTransport() {
+  auto buffer = inbound_buff_.ReserveAtLeast<mutable_buffer>(kReadSize);
+  transport_.async_read_some(
+      buffer, bind_executor(strand_, [self = shared_from_this()](
+                                         const error_code& ec, size_t n) {
+        self->TransportReadHandler(ec, n);
+      }));
+}
+
+void MuxSession::TransportReadHandler(const error_code& ec,
+                                      size_t bytes_read) {
+  inbound_buff_.Commit(bytes_read);
+  if (!open_.load()) {
+    return;
+  }
+  if (!ProcessFrames()) {
+    LogError("Mux protocol error, closing session.");
+    DoClose();
+    return;
+  }
+  if (ec.failed()) {
+    if (ec != eof) {
+      LogError("Mux transport read failed with error ", ec.value());
+    }
+    DoClose();
+    return;
+  }
+  ReadTransport();
+}
+
+bool MuxSession::ProcessFrames() {
+  while (true) {
+    if (!has_pending_header_) {
+      if (inbound_buff_.data_size() < FrameHeader::kWireSize) {
+        return true;
+      }
+      uint8_t header[FrameHeader::kWireSize];
+      inbound_buff_.CopyOut(header, sizeof(header));
+      if (!pending_header_.Decode(header)) {
+        return false;
+      }
+      has_pending_header_ = true;
+    }
+    const FrameHeader& header = pending_header_;
+    if (header.type == FrameType::kData &&
+        inbound_buff_.data_size() < header.length) {
+      return true;
+    }
+    has_pending_header_ = false;
+
+    auto it = streams_.find(header.stream_id);
+    shared_ptr<Stream> stream = it == streams_.end() ? nullptr : it->second;
+    switch (header.type) {
+      case FrameType::kOpen: {
+        if (stream != nullptr || stream_handler_ == nullptr) {
+          SendFrame(FrameHeader(FrameType::kReset, header.stream_id));
+          break;
+        }
+        Socket sock = stream_handler_(transport_.get_executor());
+        if (!sock.is_open()) {
+          SendFrame(FrameHeader(FrameType::kReset, header.stream_id));
+          break;
+        }
+        AddStream(header.stream_id, move(sock));
+        break;
+      }
+      case FrameType::kData: {
+        // The stream may have been reset locally while the data was in flight.
+        // Discard the data in that case.
+        if (stream == nullptr || stream->fin_received) {
+          inbound_buff_.CopyOut(nullptr, header.length);
+          break;
+        }
+        if (header.length > stream->recv_window) {
+          LogError("Mux stream ", header.stream_id, " exceeded its window.");
+          inbound_buff_.CopyOut(nullptr, header.length);
+          ResetStream(stream, true);
+          break;
+        }
+        stream->recv_window -= header.length;
+        auto buffers = stream->inbound.Reserve<SysBuf>(header.length);
+        for (auto& buf : buffers) {
+          inbound_buff_.CopyOut(buf.iov_base, buf.iov_len);
+        }
+        stream->inbound.Commit(header.length);
+        WriteStream(stream);
+        break;
+      }
+      case FrameType::kWindowUpdate: {
+        if (stream != nullptr) {
+          stream->send_window += header.length;
+          ReadStream(stream);
+        }
+        break;
+      }
+      case FrameType::kFin: {
+        if (stream != nullptr) {
+          stream->fin_received = true;
+          WriteStream(stream);
+          MaybeFinishStream(stream);
+        }
+        break;
+      }
+      case FrameType::kReset: {
+        if (stream != nullptr) {
+          ResetStream(stream, false);
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+void MuxSession::SendFrame(const FrameHeader& header, const void* payload) {
+  uint8_t buf[FrameHeader::kWireSize];
+  header.Encode(buf);
+  outbound_buff_.CopyIn(buf, sizeof(buf));
+  if (header.type == FrameType::kData && header.length > 0u) {
+    outbound_buff_.CopyIn(payload, header.length);
+  }
+  WriteTransport();
+}
+
+void MuxSession::WriteTransport() {
+  if (writing_transport_ || outbound_buff_.data_size() == 0u ||
+      !open_.load()) {
+    return;
+  }
+  writing_transport_ = true;
+  auto buffer = outbound_buff_.Peek<const_buffer>();
+  transport_.async_write_some(
+      buffer, bind_executor(strand_, [self = shared_from_this()](
+                                         const error_code& ec, size_t n) {
+        self->TransportWriteHandler(ec, n);
+      }));
+}
+
+void MuxSession::TransportWriteHandler(const error_code& ec,
+                                       size_t bytes_written) {
+  writing_transport_ = false;
+  bool was_full = outbound_buff_.data_size() >= kMaxBufferSize;
+  outbound_buff_.Drain(bytes_written);
+  if (ec.failed()) {
+    LogError("Mux transport write failed with error ", ec.value());
+    DoClose();
+    return;
+  }
+  // Resume the streams that were paused on a full outbound buffer.
+  if (was_full && outbound_buff_.data_size() < kMaxBufferSize) {
+    vector<shared_ptr<Stream>> streams;
+    streams.reserve(streams_.size());
+    for (auto& [id, stream] : streams_) {
+      streams.push_back(stream);
+    }
+    for (auto& stream : streams) {
+      ReadStream(stream);
+    }
+  }
+  WriteTransport();
+}
+
+void MuxSession::AddStream(uint32_t id, Socket sock) {
+  auto stream = make_shared<Stream>(id, move(sock), freelist_);
+  streams_.emplace(id, stream);
+  num_streams_.fetch_add(1u);
+  ReadStream(stream);
+}
+
+void MuxSession::ReadStream(const shared_ptr<Stream>& stream) {
+  if (stream->closed || stream->reading || stream->fin_sent ||
+      stream->send_window == 0u ||
+      outbound_buff_.data_size() >= kMaxBufferSize) {
+    return;
+  }
+  stream->reading = true;
+  size_t size = std::min(stream->send_window, mux::kMaxFramePayload);
+  stream->sock.async_read_some(
+      mutable_buffer(stream->read_buf.get(), size),
+      bind_executor(strand_, [self = shared_from_this(), stream](
+                                 const error_code& ec, size_t n) {
+        stream->reading = false;
+        if (stream->closed) {
+          return;
+        }
+        if (n > 0u) {
+          stream->send_window -= n;
+          self->SendFrame(FrameHeader(FrameType::kData, stream->id, n),
+                          stream->read_buf.get());
+        }
+        if (ec.failed()) {
+          if (ec != eof) {
+            self->ResetStream(stream, true);
+            return;
+          }
+          stream->fin_sent = true;
+          self->SendFrame(FrameHeader(FrameType::kFin, stream->id));
+          self->MaybeFinishStream(stream);
+          return;
+        }
+        self->ReadStream(stream);
+      }));
+}
+
+void MuxSession::WriteStream(const shared_ptr<Stream>& stream) {
+  if (stream->closed || stream->writing) {
+    return;
+  }
+  if (stream->inbound.data_size() == 0u) {
+    if (stream->fin_received) {
+      error_code ec;
+      stream->sock.shutdown(Socket::shutdown_send, ec);
+    }
+    return;
+  }
+  stream->writing = true;
+  auto buffer = stream->inbound.Peek<const_buffer>();
+  stream->sock.async_write_some(
+      buffer, bind_executor(strand_, [self = shared_from_this(), stream](
+                                         const error_code& ec, size_t n) {
+        stream->writing = false;
+        if (stream->closed) {
+          return;
+        }
+        stream->inbound.Drain(n);
+        if (ec.failed()) {
+          self->ResetStream(stream, true);
+          return;
+        }
+        // Grant the window back in batches to limit the number of frames.
+        stream->consumed += n;
+        if (stream->consumed >= mux::kInitialWindowSize / 2) {
+          stream->recv_window += stream->consumed;
+          self->SendFrame(FrameHeader(FrameType::kWindowUpdate, stream->id,
+                                      stream->consumed));
+          stream->consumed = 0u;
+        }
+        self->WriteStream(stream);
+        self->MaybeFinishStream(stream);
+      }));
+}
+
+void MuxSession::ResetStream(const shared_ptr<Stream>& stream,
+                             bool notify_peer) {
+  if (stream->closed) {
+    return;
+  }
+  if (notify_peer) {
+    SendFrame(FrameHeader(FrameType::kReset, stream->id));
+  }
+  stream->closed = true;
+  error_code ec;
+  stream->sock.close(ec);
+  if (streams_.erase(stream->id) > 0u) {
+    num_streams_.fetch_sub(1u);
+  }
+}
+
+void MuxSession::MaybeFinishStream(const shared_ptr<Stream>& stream) {
+  if (stream->fin_sent && stream->fin_received && !stream->reading &&
+      !stream->writing && stream->inbound.data_size() == 0u) {
+    ResetStream(stream, false);
+  }
+}
+
+}  // namespace google::scp::proxy
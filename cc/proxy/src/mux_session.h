@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include <boost/asio/strand.hpp>
+
+#include "buffer.h"
+#include "mux_protocol.h"
+#include "socket_types.h"
+
+namespace google::scp::proxy {
+// MuxSession carries many logical streams over a single transport connection,
+// using the protocol defined in mux_protocol.h. Each logical stream is bridged
+// to a local stream socket: bytes read from the local socket are sent on the
+// stream, and bytes received on the stream are written to the local socket.
+// The same class is used on both ends of the transport. The opening side calls
+// OpenStream(), and the accepting side provides a StreamHandler to create the
+// local socket for each stream opened by the peer.
+// All IO is serialized on a strand, so the public methods are thread safe.
+class MuxSession : public std::enable_shared_from_this<MuxSession> {
+ public:
+  // Called when the peer opens a new stream. Returns the local socket that the
+  // stream is bridged to, or a socket that is not open to refuse the stream.
+  using StreamHandler = std::function<Socket(const Executor&)>;
+
+  // The max size of outgoing data buffered for the transport. Reading from the
+  // local sockets is paused when this is exceeded.
+  static constexpr size_t kMaxBufferSize = 1024 * 1024;
+  static constexpr size_t kReadSize = 64 * 1024;
+
+  // Construct a MuxSession over a connected transport socket. The preamble is
+  // expected to be already exchanged. SocketType can be any stream socket
+  // implementation of boost::asio.
+  template <typename SocketType>
+  explicit MuxSession(
+      SocketType transport, StreamHandler stream_handler = nullptr,
+      const std::shared_ptr<Freelist<Buffer::Block>>& freelist = nullptr)
+      : strand_(transport.get_executor()),
+        transport_(std::move(transport)),
+        stream_handler_(std::move(stream_handler)),
+        freelist_(freelist == nullptr
+                      ? std::make_shared<Freelist<Buffer::Block>>()
+                      : freelist),
+        inbound_buff_(freelist_),
+        outbound_buff_(freelist_) {}
+
+  ~MuxSession();
+
+  // Start processing frames from the transport.
+  void Start();
+
+  // Open a new stream to the peer and bridge it to the local socket. Returns
+  // false if the session is already closed.
+  bool OpenStream(Socket local_sock);
+
+  // Close the transport and all streams.
+  void Close();
+
+  bool IsOpen() const { return open_.load(); }
+
+  // The number of streams currently alive.
+  size_t NumStreams() const { return num_streams_.load(); }
+
+ private:
+  struct Stream {
+    Stream(uint32_t id, Socket sock,
+           const std::shared_ptr<Freelist<Buffer::Block>>& freelist)
+        : id(id),
+          sock(std::move(sock)),
+          inbound(freelist),
+          read_buf(new uint8_t[mux::kMaxFramePayload]) {}
+
+    const uint32_t id;
+    // The local socket this stream is bridged to.
+    Socket sock;
+    // Data received from the peer, to be written to the local socket.
+    Buffer inbound;
+    // Data read from the local socket, to be framed and sent to the peer.
+    std::unique_ptr<uint8_t[]> read_buf;
+    // The number of bytes we may still send before the peer grants more.
+    uint32_t send_window = mux::kInitialWindowSize;
+    // The number of bytes the peer may still send before we grant more.
+    uint32_t recv_window = mux::kInitialWindowSize;
+    // Bytes written to the local socket but not yet granted back to the peer.
+    uint32_t consumed = 0u;
+    bool reading = false;
+    bool writing = false;
+    bool fin_sent = false;
+    bool fin_received = false;
+    bool closed = false;
+  };
+
+  // Schedule reading of the transport.
+  void ReadTransport();
+  // The handler for reading the transport.
+  void TransportReadHandler(const boost::system::error_code& ec,
+                            size_t bytes_read);
+  // Process all complete frames in inbound_buff_. Returns false on protocol
+  // errors.
+  bool ProcessFrames();
+  // Schedule writing of the transport if there is pending outbound data.
+  void WriteTransport();
+  // The handler for writing the transport.
+  void TransportWriteHandler(const boost::system::error_code& ec,
+                             size_t bytes_written);
+  // Append a frame to the outbound buffer and schedule writing.
+  void SendFrame(const mux::FrameHeader& header, const void* payload = nullptr);
+
+  // Add a stream bridged to sock and start forwarding.
+  void AddStream(uint32_t id, Socket sock);
+  // Schedule reading of the local socket of stream, if allowed.
+  void ReadStream(const std::shared_ptr<Stream>& stream);
+  // Schedule writing to the local socket of stream, if there is data.
+  void WriteStream(const std::shared_ptr<Stream>& stream);
+  // Close and remove the stream. Sends kReset to the peer if notify_peer.
+  void ResetStream(const std::shared_ptr<Stream>& stream, bool notify_peer);
+  // Remove the stream if both directions are done.
+  void MaybeFinishStream(const std::shared_ptr<Stream>& stream);
+  // Close everything. Must be called on strand_.
+  void DoClose();
+
+  boost::asio::strand<Executor> strand_;
+  Socket transport_;
+  StreamHandler stream_handler_;
+  std::shared_ptr<Freelist<Buffer::Block>> freelist_;
+  // Raw bytes read from the transport.
+  Buffer inbound_buff_;
+  // Framed bytes to be written to the transport.
+  Buffer outbound_buff_;
+  std::map<uint32_t, std::shared_ptr<Stream>> streams_;
+  // The header of the frame being received, if has_pending_header_.
+  mux::FrameHeader pending_header_;
+  bool has_pending_header_ = false;
+  bool writing_transport_ = false;
+  // The next id to use for streams opened by this side.
+  uint32_t next_stream_id_ = 1u;
+  std::atomic<bool> open_{true};
+  std::atomic<size_t> num_streams_{0u};
+};
+
+}  // namespace google::scp::proxy
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mux_session_pool.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <boost/asio.hpp>
+
+#include "logging.h"
+#include "mux_protocol.h"
+
+namespace asio = boost::asio;
+using boost::system::error_code;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::unique_lock;
+
+namespace google::scp::proxy {
+
+MuxSessionPool::~MuxSessionPool() {
+  for (auto& session : sessions_) {
+    if (session != nullptr) {
+      session->Close();
+    }
+  }
+}
+
+void MuxSessionPool::OpenStream(Socket local_sock) {
+  size_t index;
+  shared_ptr<MuxSession> session;
+  {
+    unique_lock lock(mutex_);
+    if (sessions_.empty()) {
+      return;
+    }
+    index = next_;
+    next_ = (next_ + 1) % sessions_.size();
+    if (sessions_[index] != nullptr && sessions_[index]->IsOpen()) {
+      session = sessions_[index];
+    }
+  }
+  if (session == nullptr) {
+    ConnectAndOpenStream(index, make_shared<Socket>(move(local_sock)));
+    return;
+  }
+  session->OpenStream(move(local_sock));
+}
+
+void MuxSessionPool::ConnectAndOpenStream(size_t index,
+                                          shared_ptr<Socket> local_sock) {
+  // This only happens once per pooled connection unless the connection breaks.
+  auto transport = make_shared<Socket>(local_sock->get_executor());
+  transport->async_connect(proxy_endpoint_, [this, index, local_sock,
+                                             transport](error_code ec) {
+    if (ec.failed()) {
+      LogError("socket_vendor: cannot connect mux to proxy, ", ec.message());
+      return;
+    }
+    asio::async_write(
+        *transport, asio::buffer(mux::kPreamble),
+        [this, index, local_sock, transport](error_code write_ec, size_t) {
+          if (write_ec.failed()) {
+            LogError("socket_vendor: cannot write mux preamble, ",
+                     write_ec.message());
+            return;
+          }
+          shared_ptr<MuxSession> session;
+          {
+            unique_lock lock(mutex_);
+            auto& slot = sessions_[index];
+            if (slot != nullptr && slot->IsOpen()) {
+              // Another stream reconnected the same slot first, so use its
+              // connection.
+              transport->close(write_ec);
+            } else {
+              slot = make_shared<MuxSession>(move(*transport));
+              slot->Start();
+            }
+            session = slot;
+          }
+          session->OpenStream(move(*local_sock));
+        });
+  });
+}
+
+}  // namespace google::scp::proxy
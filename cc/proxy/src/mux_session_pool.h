@@ -0,0 +1,56 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mux_session.h"
+#include "socket_types.h"
+
+namespace google::scp::proxy {
+// MuxSessionPool is used by socket_vendor to keep a few long-lived mux
+// connections to the proxy, and to spread outbound streams over them. Broken
+// connections are re-established lazily on the next OpenStream().
+class MuxSessionPool {
+ public:
+  MuxSessionPool(const Endpoint& proxy_endpoint, size_t pool_size)
+      : proxy_endpoint_(proxy_endpoint), sessions_(pool_size) {}
+
+  ~MuxSessionPool();
+
+  // Open a stream to the proxy over one of the pooled connections, and bridge
+  // it to local_sock. If the picked connection is broken, it is reconnected
+  // asynchronously first. local_sock is closed if no connection to the proxy
+  // can be made.
+  void OpenStream(Socket local_sock);
+
+ private:
+  // Connect a new session for the slot at index, then open the stream for
+  // local_sock on it. The connect and the preamble write are asynchronous and
+  // done without holding mutex_, so neither an io_context thread nor the
+  // streams on the other connections wait for the proxy.
+  void ConnectAndOpenStream(size_t index, std::shared_ptr<Socket> local_sock);
+
+  Endpoint proxy_endpoint_;
+  // Guards sessions_ and next_.
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<MuxSession>> sessions_;
+  size_t next_ = 0u;
+};
+}  // namespace google::scp::proxy
@@ -73,6 +73,10 @@ int ioctl(int fd, unsigned long request, void* argp);
 
 static int socks5_client_connect(int sockfd, const struct sockaddr* addr);
 
+// True if outbound connections are carried over socket_vendor's mux
+// connections, instead of one VSOCK connection to the proxy each.
+static bool mux_enabled = false;
+
 namespace {
 class AutoCloseFd {
  public:
@@ -92,22 +96,109 @@ class AutoCloseFd {
   int fd_;
 };
 
-// Convert the file descriptor sockfd into a VSOCK socket. This means atomically
-// closing sockfd and create a new VSOCK socket descriptor of the same value.
-// Returns the fcntl flags of the original sockfd.
-int ConvertToVsock(int sockfd) {
-  int vsock_fd = socket(AF_VSOCK, SOCK_STREAM, 0);
-  if (vsock_fd < 0) {
+// Convert the file descriptor sockfd into a socket of the given domain. This
+// means atomically closing sockfd and create a new socket descriptor of the
+// same value. Returns the fcntl flags of the original sockfd.
+int ConvertSocket(int sockfd, int domain) {
+  int new_fd = socket(domain, SOCK_STREAM, 0);
+  if (new_fd < 0) {
     return -1;
   }
-  AutoCloseFd autoclose(vsock_fd);
+  AutoCloseFd autoclose(new_fd);
   int flags = fcntl(sockfd, F_GETFL);
-  if (dup2(vsock_fd, sockfd) < 0) {
+  if (dup2(new_fd, sockfd) < 0) {
     return -1;
   }
   return flags;
 }
 
+// The domain of sockets that carry outbound connections to the proxy. With the
+// mux enabled, these are unix domain sockets connected to socket_vendor.
+int ProxiedDomain() {
+  return mux_enabled ? AF_UNIX : AF_VSOCK;
+}
+
+// With the mux enabled, the proxied sockets are unix domain sockets, which
+// cannot be told from the application's own ones by their domain. So the file
+// descriptors converted here are marked in a bitmap until they are closed. The
+// bitmap is a plain array updated with atomic builtins, as the library must
+// not export any symbols other than the ones it overrides.
+constexpr int kMaxTrackedFd = 1 << 16;
+constexpr int kFdsPerWord = 64;
+uint64_t converted_fds[kMaxTrackedFd / kFdsPerWord];
+
+void MarkConverted(int fd, bool converted) {
+  if (fd < 0 || fd >= kMaxTrackedFd) {
+    return;
+  }
+  uint64_t bit = uint64_t{1} << (fd % kFdsPerWord);
+  if (converted) {
+    __atomic_fetch_or(&converted_fds[fd / kFdsPerWord], bit, __ATOMIC_RELAXED);
+  } else {
+    __atomic_fetch_and(&converted_fds[fd / kFdsPerWord], ~bit,
+                       __ATOMIC_RELAXED);
+  }
+}
+
+// Descriptors beyond the bitmap are not tracked, so any unix domain socket
+// among them is taken as converted.
+bool IsConverted(int fd) {
+  if (fd < 0 || fd >= kMaxTrackedFd) {
+    return true;
+  }
+  uint64_t bit = uint64_t{1} << (fd % kFdsPerWord);
+  return __atomic_load_n(&converted_fds[fd / kFdsPerWord], __ATOMIC_RELAXED) &
+         bit;
+}
+
+// Convert sockfd into a proxied socket. Returns the fcntl flags of the
+// original sockfd, or -1 on failure.
+int ConvertToProxiedSocket(int sockfd) {
+  int flags = ConvertSocket(sockfd, ProxiedDomain());
+  if (flags >= 0 && mux_enabled) {
+    MarkConverted(sockfd, true);
+  }
+  return flags;
+}
+
+// True if sockfd carries an outbound connection to the proxy, so that the IP
+// and TCP level options of the application do not apply to it.
+bool IsProxiedSocket(int sockfd) {
+  int sock_domain = 0;
+  socklen_t sock_domain_len = sizeof(sock_domain);
+  if (libc_getsockopt(sockfd, SOL_SOCKET, SO_DOMAIN,
+                      static_cast<void*>(&sock_domain), &sock_domain_len)) {
+    return false;
+  }
+  if (sock_domain == AF_VSOCK) {
+    return true;
+  }
+  return mux_enabled && sock_domain == AF_UNIX && IsConverted(sockfd);
+}
+
+bool IsIpLevel(int level) {
+  return level == IPPROTO_TCP || level == IPPROTO_IP || level == IPPROTO_IPV6;
+}
+
+// Connect sockfd to socket_vendor and ask it to bridge the connection to a new
+// mux stream. Returns 0 on success, -1 on failure.
+int ConnectSocketVendorMux(int sockfd) {
+  sockaddr_un uds_addr;
+  memset(&uds_addr, 0, sizeof(uds_addr));
+  uds_addr.sun_family = AF_UNIX;
+  memcpy(uds_addr.sun_path, kSocketVendorUdsPath, sizeof(kSocketVendorUdsPath));
+  if (libc_connect(sockfd, reinterpret_cast<sockaddr*>(&uds_addr),
+                   sizeof(uds_addr)) < 0) {
+    return -1;
+  }
+  socket_vendor::ConnectRequest connect_req;
+  ssize_t num_bytes = send(sockfd, &connect_req, sizeof(connect_req), 0);
+  if (num_bytes != static_cast<ssize_t>(sizeof(connect_req))) {
+    return -1;
+  }
+  return 0;
+}
+
 }  // namespace
 
 void preload_init(void) {
@@ -142,6 +233,9 @@ void preload_init(void) {
       dlsym(RTLD_NEXT, STR(epoll_ctl)));
 #undef _STR
 #undef STR
+  unsigned int mux_connections = 0;
+  EnvGetVal(kMuxConnectionsEnv, mux_connections);
+  mux_enabled = mux_connections > 0;
 }
 
 #define EXPORT __attribute__((visibility("default")))
@@ -196,8 +290,9 @@ EXPORT int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event) {
     return libc_epoll_ctl(epfd, op, fd, event);
   }
   // If we reach here, we have a TCP socket trying to be added into a epoll
-  // instance. Convert the socket into VSOCK and resume to epoll_ctl.
-  int fl = ConvertToVsock(fd);
+  // instance. Convert the socket into VSOCK (or UDS when mux is enabled) and
+  // resume to epoll_ctl.
+  int fl = ConvertToProxiedSocket(fd);
   fcntl(fd, F_SETFL, fl);
   return libc_epoll_ctl(epfd, op, fd, event);
 }
@@ -222,28 +317,37 @@ EXPORT int connect(int sockfd, const struct sockaddr* addr, socklen_t addrlen) {
   }
   // If:
   //    * the sockfd type is not SOCK_STREAM, or
-  //    * sockfd domain is not IP/IPv6/VSOCK, or
+  //    * sockfd domain is not IP/IPv6/VSOCK (or UDS when mux is enabled), or
   //    * target address is not IP/IPv6,
   // then fallback to libc connect().
   if (sock_type != SOCK_STREAM ||
       (sock_domain != AF_INET && sock_domain != AF_INET6 &&
-       sock_domain != AF_VSOCK) ||
+       sock_domain != AF_VSOCK && sock_domain != ProxiedDomain()) ||
       (addr->sa_family != AF_INET && addr->sa_family != AF_INET6)) {
     return libc_connect(sockfd, addr, addrlen);
   }
   int fl = 0;
-  if (sock_domain == AF_VSOCK) {
+  if (sock_domain == ProxiedDomain()) {
     fl = fcntl(sockfd, F_GETFL);
   } else {
-    fl = ConvertToVsock(sockfd);
+    fl = ConvertToProxiedSocket(sockfd);
   }
   // Set blocking
   fcntl(sockfd, F_SETFL, (fl & ~O_NONBLOCK));
-  sockaddr_vm vsock_addr = GetProxyVsockAddr();
-  if (libc_connect(sockfd, reinterpret_cast<sockaddr*>(&vsock_addr),
-                   sizeof(vsock_addr)) < 0) {
-    fcntl(sockfd, F_SETFL, fl);
-    return -1;
+  if (mux_enabled) {
+    // Connecting to socket_vendor over UDS is much cheaper than a VSOCK
+    // connection to the proxy, which socket_vendor already holds.
+    if (ConnectSocketVendorMux(sockfd) < 0) {
+      fcntl(sockfd, F_SETFL, fl);
+      return -1;
+    }
+  } else {
+    sockaddr_vm vsock_addr = GetProxyVsockAddr();
+    if (libc_connect(sockfd, reinterpret_cast<sockaddr*>(&vsock_addr),
+                     sizeof(vsock_addr)) < 0) {
+      fcntl(sockfd, F_SETFL, fl);
+      return -1;
+    }
   }
   // Here this is a blocking call. This potentially hurts performance on many,
   // frequent, short non-blocking connections. However, without a blocking call
@@ -260,12 +364,7 @@ EXPORT int setsockopt(int sockfd, int level, int optname, const void* optval,
   // Application may still have the illusion that the socket is a TCP socket and
   // wants to set some TCP-level opts, e.g. TCP_NODELAY. Here we simply return 0
   // (success) in these scenarios, to avoid unnecessary failures.
-  int sock_domain = 0;
-  socklen_t sock_domain_len = sizeof(sock_domain);
-  if ((level == IPPROTO_TCP || level == IPPROTO_IP || level == IPPROTO_IPV6) &&
-      !libc_getsockopt(sockfd, SOL_SOCKET, SO_DOMAIN,
-                       static_cast<void*>(&sock_domain), &sock_domain_len) &&
-      sock_domain == AF_VSOCK) {
+  if (IsIpLevel(level) && IsProxiedSocket(sockfd)) {
     return 0;
   }
   return libc_setsockopt(sockfd, level, optname, optval, optlen);
@@ -273,17 +372,34 @@ EXPORT int setsockopt(int sockfd, int level, int optname, const void* optval,
 
 EXPORT int getsockopt(int sockfd, int level, int optname,
                       void* __restrict optval, socklen_t* __restrict optlen) {
-  int sock_domain = 0;
-  socklen_t sock_domain_len = sizeof(sock_domain);
-  if ((level == IPPROTO_TCP || level == IPPROTO_IP || level == IPPROTO_IPV6) &&
-      !libc_getsockopt(sockfd, SOL_SOCKET, SO_DOMAIN,
-                       static_cast<void*>(&sock_domain), &sock_domain_len) &&
-      sock_domain == AF_VSOCK) {
+  // Likewise, report the TCP-level opts of a proxied socket as an int 0, which
+  // is what most of them, e.g. TCP_NODELAY, read as when unset.
+  if (IsIpLevel(level) && IsProxiedSocket(sockfd)) {
+    if (optval == nullptr || optlen == nullptr) {
+      errno = EFAULT;
+      return -1;
+    }
+    int value = 0;
+    socklen_t len = *optlen < sizeof(value) ? *optlen : sizeof(value);
+    memcpy(optval, &value, len);
+    *optlen = len;
     return 0;
   }
   return libc_getsockopt(sockfd, level, optname, optval, optlen);
 }
 
+EXPORT int close(int fd) {
+  // close() may be called by other libraries before preload_init().
+  if (libc_close == nullptr) {
+    libc_close =
+        reinterpret_cast<decltype(libc_close)>(dlsym(RTLD_NEXT, "close"));
+  }
+  if (mux_enabled) {
+    MarkConverted(fd, false);
+  }
+  return libc_close(fd);
+}
+
 // A wrapper for resuming recv() call on EINTR.
 // Return the total number of bytes received.
 static ssize_t recv_all(int fd, void* buf, size_t len, int flags) {
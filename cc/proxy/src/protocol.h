@@ -21,6 +21,9 @@
 
 static constexpr char kParentCidEnv[] = "PROXY_PARENT_CID";
 static constexpr char kParentPortEnv[] = "PROXY_PARENT_PORT";
+// Set to the number of mux connections to carry outbound connections over a
+// few long-lived connections to the proxy. Unset or 0 disables the mux.
+static constexpr char kMuxConnectionsEnv[] = "PROXY_MUX_CONNECTIONS";
 static constexpr unsigned int kDefaultParentCid = 3;
 static constexpr unsigned int kDefaultParentPort = 8888;
 
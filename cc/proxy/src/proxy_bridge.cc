@@ -16,6 +16,7 @@
 
 #include "proxy_bridge.h"
 
+#include <algorithm>
 #include <functional>
 #include <utility>
 
@@ -43,6 +44,15 @@ namespace google::scp::proxy {
 
 std::atomic<uint64_t> ProxyBridge::connection_id_counter = 0;
 
+// Adapt the read size to the size of the last read.
+static void AdaptReadSize(size_t& read_size, size_t bytes_read) {
+  if (bytes_read >= read_size) {
+    read_size = std::min(read_size * 2, ProxyBridge::kMaxReadSize);
+  } else if (bytes_read < read_size / 4) {
+    read_size = std::max(read_size / 2, ProxyBridge::kReadSize);
+  }
+}
+
 ProxyBridge::~ProxyBridge() {
 #ifndef NDEBUG
   LogInfo("[", connection_id_, "]",
@@ -93,7 +103,9 @@ void ProxyBridge::ForwardTraffic() {
   // Now determine if we need to schedule IO operations.
   if (!reading_client_ && client_readable_ && dest_writable_ &&
       upstream_buff_.data_size() < kMaxBufferSize) {
-    auto buffer = upstream_buff_.ReserveAtLeast<mutable_buffer>(kReadSize);
+    // A copy, as ReserveAtLeast(size_t&) updates the size to what it reserved.
+    size_t read_size = upstream_read_size_;
+    auto buffer = upstream_buff_.ReserveAtLeast<mutable_buffer>(read_size);
     reading_client_ = true;
     client_sock_.async_read_some(
         buffer,
@@ -113,7 +125,8 @@ void ProxyBridge::ForwardTraffic() {
   }
   if (!reading_dest_ && dest_readable_ && client_writable_ &&
       downstream_buff_.data_size() < kMaxBufferSize) {
-    auto buffer = downstream_buff_.ReserveAtLeast<mutable_buffer>(kReadSize);
+    size_t read_size = downstream_read_size_;
+    auto buffer = downstream_buff_.ReserveAtLeast<mutable_buffer>(read_size);
     reading_dest_ = true;
     dest_sock_.async_read_some(
         buffer,
@@ -134,7 +147,9 @@ void ProxyBridge::ForwardTraffic() {
 
 void ProxyBridge::ClientReadHandler(const error_code& ec, size_t bytes_read) {
   reading_client_ = false;
+  ++num_reads_;
   upstream_buff_.Commit(bytes_read);
+  AdaptReadSize(upstream_read_size_, bytes_read);
   if (ec.failed()) {
     if (ec == eof) {
       LogInfo("[", connection_id_, "]",
@@ -155,6 +170,7 @@ void ProxyBridge::ClientReadHandler(const error_code& ec, size_t bytes_read) {
 void ProxyBridge::ClientWriteHandler(const error_code& ec,
                                      size_t bytes_written) {
   writing_client_ = false;
+  ++num_writes_;
   downstream_buff_.Drain(bytes_written);
 #ifndef NDEBUG
   downstream_size_ += bytes_written;
@@ -175,7 +191,9 @@ void ProxyBridge::ClientWriteHandler(const error_code& ec,
 
 void ProxyBridge::DestReadHandler(const error_code& ec, size_t bytes_read) {
   reading_dest_ = false;
+  ++num_reads_;
   downstream_buff_.Commit(bytes_read);
+  AdaptReadSize(downstream_read_size_, bytes_read);
   if (ec.failed()) {
     if (ec == eof) {
       LogInfo("[", connection_id_, "]",
@@ -195,6 +213,7 @@ void ProxyBridge::DestReadHandler(const error_code& ec, size_t bytes_read) {
 
 void ProxyBridge::DestWriteHandler(const error_code& ec, size_t bytes_written) {
   writing_dest_ = false;
+  ++num_writes_;
   upstream_buff_.Drain(bytes_written);
 #ifndef NDEBUG
   upstream_size_ += bytes_written;
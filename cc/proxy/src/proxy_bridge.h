@@ -39,7 +39,12 @@ namespace google::scp::proxy {
 class ProxyBridge : public std::enable_shared_from_this<ProxyBridge> {
  public:
   static constexpr size_t kMaxBufferSize = 1024 * 1024;
+  // The initial and minimum size of each read.
   static constexpr size_t kReadSize = 64 * 1024;
+  // The maximum size of each read. This must span fewer blocks than the max
+  // number of buffers asio passes to one readv (64), otherwise the excess
+  // blocks are reserved for nothing.
+  static constexpr size_t kMaxReadSize = 128 * 1024;
 
   // Construct a ProxyBridge with a connected client socket. SocketType can be
   // any stream socket implementation of boost::asio.
@@ -114,6 +119,11 @@ class ProxyBridge : public std::enable_shared_from_this<ProxyBridge> {
 
   Executor GetExecutor() { return client_sock_.get_executor(); }
 
+  // The number of read and write operations completed while forwarding
+  // traffic, in both directions. Each is normally one readv/writev syscall.
+  size_t NumReads() const { return num_reads_; }
+  size_t NumWrites() const { return num_writes_; }
+
   // Accept an inbound connection if this object was processing a BIND request.
   void AcceptInboundConnection(Socket sock);
   // Stop waiting to accept an inbound connection.
@@ -140,6 +150,13 @@ class ProxyBridge : public std::enable_shared_from_this<ProxyBridge> {
   size_t upstream_size_;
   size_t downstream_size_;
 #endif
+  // The size of the next read in each direction. It grows when reads fill the
+  // reserved space, i.e. the peer is fast, so that more blocks are covered by
+  // each readv, and shrinks back when reads come back small.
+  size_t upstream_read_size_ = kReadSize;
+  size_t downstream_read_size_ = kReadSize;
+  size_t num_reads_ = 0u;
+  size_t num_writes_ = 0u;
   boost::asio::cancellation_signal cancel_signal_;
   AcceptorPool* acceptor_pool_;
   // Flags indicating the state of the proxy connection. We only have 8 of them,
@@ -25,6 +25,7 @@
 
 #include <linux/vm_sockets.h>
 
+#include <array>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -36,6 +37,8 @@
 #include <boost/asio.hpp>
 
 #include "logging.h"
+#include "mux_protocol.h"
+#include "mux_session.h"
 #include "proxy_bridge.h"
 #include "socket_types.h"
 
@@ -55,7 +58,8 @@ namespace google::scp::proxy {
 ProxyServer::ProxyServer(const Config& config)
     : acceptor_(io_context_),
       port_(config.socks5_port_),
-      vsock_(config.vsock_) {}
+      vsock_(config.vsock_),
+      mux_(config.mux_) {}
 
 void ProxyServer::BindListen() {
   if (vsock_) {
@@ -101,13 +105,70 @@ void ProxyServer::StartAsyncAccept() {
   acceptor_.async_accept([this](boost::system::error_code ec, Socket socket) {
     StartAsyncAccept();
     if (!ec) {
-      auto bridge =
-          make_shared<ProxyBridge>(std::move(socket), &acceptor_pool_);
-      bridge->PerformSocks5Handshake();
+      if (mux_) {
+        DispatchConnection(std::move(socket));
+      } else {
+        HandleConnection(std::move(socket));
+      }
     }
   });
 }
 
+void ProxyServer::HandleConnection(Socket socket) {
+  auto bridge = make_shared<ProxyBridge>(std::move(socket), &acceptor_pool_);
+  bridge->PerformSocks5Handshake();
+}
+
+void ProxyServer::DispatchConnection(Socket socket) {
+  auto sock = make_shared<Socket>(std::move(socket));
+  auto first_byte = make_shared<uint8_t>(0u);
+  sock->async_receive(
+      buffer(first_byte.get(), 1), socket_base::message_peek,
+      [this, sock, first_byte](boost::system::error_code ec, size_t) {
+        if (ec.failed()) {
+          return;
+        }
+        if (*first_byte == mux::kPreamble[0]) {
+          HandleMuxConnection(sock);
+        } else {
+          HandleConnection(std::move(*sock));
+        }
+      });
+}
+
+void ProxyServer::HandleMuxConnection(shared_ptr<Socket> socket) {
+  auto preamble = make_shared<std::array<uint8_t, sizeof(mux::kPreamble)>>();
+  async_read(
+      *socket, buffer(*preamble),
+      [this, socket, preamble](boost::system::error_code ec, size_t) {
+        if (ec.failed() ||
+            memcmp(preamble->data(), mux::kPreamble, preamble->size()) != 0) {
+          LogError("Bad mux preamble.");
+          return;
+        }
+        // Each stream is bridged to a ProxyBridge over a socket pair, so that
+        // the SOCKS5 handshake and forwarding work exactly as they do for
+        // direct connections.
+        auto stream_handler = [this](const Executor& executor) {
+          local::stream_protocol::socket mux_end(executor);
+          local::stream_protocol::socket bridge_end(executor);
+          boost::system::error_code ec;
+          local::connect_pair(mux_end, bridge_end, ec);
+          if (ec.failed()) {
+            LogError("Cannot create socket pair, ", ec.message());
+            return Socket(executor);
+          }
+          auto bridge =
+              make_shared<ProxyBridge>(std::move(bridge_end), &acceptor_pool_);
+          bridge->PerformSocks5Handshake();
+          return Socket(std::move(mux_end));
+        };
+        auto session =
+            make_shared<MuxSession>(std::move(*socket), stream_handler);
+        session->Start();
+      });
+}
+
 void ProxyServer::Stop() {
   io_context_.stop();
 }
@@ -49,11 +49,19 @@ class ProxyServer {
 
  private:
   void StartAsyncAccept();
+  // Start serving an accepted connection.
+  void HandleConnection(Socket socket);
+  // Tell a mux connection from a SOCKS5 connection by its first byte, and
+  // start serving it.
+  void DispatchConnection(Socket socket);
+  // Start serving a mux connection whose preamble has been peeked.
+  void HandleMuxConnection(std::shared_ptr<Socket> socket);
   boost::asio::io_context io_context_;
   Acceptor acceptor_;
   // The acceptor pool for handling BIND requests.
   AcceptorPool acceptor_pool_;
   uint16_t port_;
   const bool vsock_;
+  const bool mux_;
 };
 }  // namespace google::scp::proxy
@@ -64,7 +64,14 @@ int main(int argc, char* argv[]) {
   auto addr = GetProxyVsockAddr();
   Endpoint ep(&addr, sizeof(addr));
 
-  SocketVendorServer server(kSocketVendorUdsPath, ep, 4);
+  unsigned int mux_connections = 0;
+  EnvGetVal(kMuxConnectionsEnv, mux_connections);
+  if (mux_connections > 0) {
+    LogInfo("Carrying outbound connections over ", mux_connections,
+            " mux connections.");
+  }
+
+  SocketVendorServer server(kSocketVendorUdsPath, ep, 4, mux_connections);
   if (!server.Init()) {
     return 1;
   }
@@ -26,6 +26,7 @@ enum class MessageType : uint32_t {
   kListenRequest,
   kListenResponse,
   kNewConnectionResponse,
+  kConnectRequest,
   // Anything not less than kInvalidMessage are invalid.
   kInvalidMessage,
 };
@@ -67,4 +68,11 @@ struct NewConnectionResponse : public Message {
   NewConnectionResponse() : Message(MessageType::kNewConnectionResponse) {}
 };
 
+// Sent by the preload library on connect() when the mux transport is enabled.
+// The connection is then bridged by socket_vendor to a stream of a multiplexed
+// connection to the proxy, and the SOCKS5 handshake follows on the same socket.
+struct ConnectRequest : public Message {
+  ConnectRequest() : Message(MessageType::kConnectRequest) {}
+};
+
 }  // namespace google::scp::proxy::socket_vendor
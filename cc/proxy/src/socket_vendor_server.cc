@@ -27,11 +27,13 @@
 
 #include "logging.h"
 #include "socket_types.h"
+#include "socket_vendor_protocol.h"
 
 namespace asio = boost::asio;
 using boost::system::error_code;
 using std::make_shared;
 using std::move;
+using std::shared_ptr;
 using std::thread;
 
 namespace google::scp::proxy {
@@ -87,13 +89,47 @@ void SocketVendorServer::Stop() {
 void SocketVendorServer::StartAsyncAccept() {
   acceptor_.async_accept([this](boost::system::error_code ec, Socket socket) {
     StartAsyncAccept();
-    if (!ec) {
-      auto pool = make_shared<ClientSessionPool>(move(socket), proxy_endpoint_);
-      if (!pool->Start()) {
-        pool->Stop();
-      }
+    if (ec) {
+      return;
     }
+    // Peek the message type to tell a connect request from a bind request.
+    auto sock = make_shared<Socket>(move(socket));
+    auto msg = make_shared<socket_vendor::Message>();
+    sock->async_receive(
+        asio::buffer(msg.get(), sizeof(*msg)), Socket::message_peek,
+        [this, sock, msg](error_code peek_ec, size_t) {
+          if (!peek_ec.failed() &&
+              msg->type == socket_vendor::MessageType::kConnectRequest) {
+            HandleConnectRequest(sock);
+            return;
+          }
+          auto pool =
+              make_shared<ClientSessionPool>(move(*sock), proxy_endpoint_);
+          if (!pool->Start()) {
+            pool->Stop();
+          }
+        });
   });
 }
 
+void SocketVendorServer::HandleConnectRequest(shared_ptr<Socket> sock) {
+  auto connect_req = make_shared<socket_vendor::ConnectRequest>();
+  asio::async_read(
+      *sock, asio::buffer(connect_req.get(), sizeof(*connect_req)),
+      [this, sock, connect_req](error_code ec, size_t) {
+        if (ec.failed()) {
+          LogError("socket_vendor: bad ConnectRequest, ", ec.message());
+          return;
+        }
+        if (mux_pool_ == nullptr) {
+          LogError(
+              "socket_vendor: ConnectRequest received but mux is disabled.");
+          return;
+        }
+        // On failure the socket is closed, and the client fails the SOCKS5
+        // handshake.
+        mux_pool_->OpenStream(move(*sock));
+      });
+}
+
 }  // namespace google::scp::proxy
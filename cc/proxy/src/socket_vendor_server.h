@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -24,17 +25,25 @@
 #include <boost/asio/local/stream_protocol.hpp>
 
 #include "client_session_pool.h"
+#include "mux_session_pool.h"
 #include "socket_types.h"
 
 namespace google::scp::proxy {
 class SocketVendorServer {
  public:
+  // mux_connections is the number of mux connections to the proxy to carry
+  // outbound connections over. 0 disables the mux.
   SocketVendorServer(const std::string& sock_path, Endpoint proxy_endpoint,
-                     size_t concurrency)
+                     size_t concurrency, size_t mux_connections = 0u)
       : acceptor_(io_context_),
         sock_path_(sock_path),
         proxy_endpoint_(proxy_endpoint),
-        concurrency_(concurrency) {}
+        concurrency_(concurrency) {
+    if (mux_connections > 0u) {
+      mux_pool_ =
+          std::make_unique<MuxSessionPool>(proxy_endpoint, mux_connections);
+    }
+  }
 
   bool Init();
   void Run();
@@ -42,6 +51,8 @@ class SocketVendorServer {
 
  private:
   void StartAsyncAccept();
+  // Bridge a connection that sent a ConnectRequest to a new mux stream.
+  void HandleConnectRequest(std::shared_ptr<Socket> sock);
 
   boost::asio::io_context io_context_;
   Acceptor acceptor_;
@@ -49,5 +60,6 @@ class SocketVendorServer {
   std::string sock_path_;
   Endpoint proxy_endpoint_;
   size_t concurrency_;
+  std::unique_ptr<MuxSessionPool> mux_pool_;
 };
 }  // namespace google::scp::proxy
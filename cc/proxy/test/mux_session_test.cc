@@ -0,0 +1,330 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "proxy/src/mux_session.h"
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "proxy/src/mux_protocol.h"
+#include "proxy/src/mux_session_pool.h"
+
+using boost::system::error_code;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::thread;
+using std::vector;
+using UdsSocket = boost::asio::local::stream_protocol::socket;
+
+namespace asio = boost::asio;
+
+namespace google::scp::proxy::test {
+
+using mux::FrameHeader;
+using mux::FrameType;
+
+TEST(MuxProtocol, FrameHeaderRoundTrip) {
+  uint8_t buf[FrameHeader::kWireSize];
+  FrameHeader(FrameType::kWindowUpdate, 0x12345678, 0x9abcdef0).Encode(buf);
+  FrameHeader header;
+  EXPECT_TRUE(header.Decode(buf));
+  EXPECT_EQ(header.type, FrameType::kWindowUpdate);
+  EXPECT_EQ(header.stream_id, 0x12345678);
+  EXPECT_EQ(header.length, 0x9abcdef0);
+}
+
+TEST(MuxProtocol, FrameHeaderInvalid) {
+  uint8_t buf[FrameHeader::kWireSize];
+  FrameHeader header;
+  FrameHeader(FrameType::kData, 1, mux::kMaxFramePayload + 1).Encode(buf);
+  EXPECT_FALSE(header.Decode(buf));
+  FrameHeader(FrameType::kData, 1, 0).Encode(buf);
+  buf[8] = static_cast<uint8_t>(FrameType::kInvalidFrame);
+  EXPECT_FALSE(header.Decode(buf));
+}
+
+class MuxSessionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    UdsSocket client_transport(io_context_);
+    UdsSocket server_transport(io_context_);
+    asio::local::connect_pair(client_transport, server_transport);
+    client_ = make_shared<MuxSession>(move(client_transport));
+    server_ = make_shared<MuxSession>(
+        move(server_transport), [this](const Executor& executor) {
+          UdsSocket mux_end(executor);
+          UdsSocket test_end(io_context_);
+          asio::local::connect_pair(mux_end, test_end);
+          std::unique_lock lock(mutex_);
+          accepted_.push_back(move(test_end));
+          cv_.notify_all();
+          return Socket(move(mux_end));
+        });
+    client_->Start();
+    server_->Start();
+    worker_ = thread([this]() { io_context_.run(); });
+  }
+
+  void TearDown() override {
+    client_->Close();
+    server_->Close();
+    io_context_.stop();
+    worker_.join();
+  }
+
+  // Open a stream from the client side. Returns the app end of the stream.
+  UdsSocket OpenStream() {
+    UdsSocket app_end(io_context_);
+    UdsSocket mux_end(io_context_);
+    asio::local::connect_pair(app_end, mux_end);
+    EXPECT_TRUE(client_->OpenStream(Socket(move(mux_end))));
+    return app_end;
+  }
+
+  // Wait for the server side to accept a stream. Returns the far end of it.
+  UdsSocket AcceptStream() {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this]() { return !accepted_.empty(); });
+    UdsSocket sock = move(accepted_.front());
+    accepted_.pop_front();
+    return sock;
+  }
+
+  asio::io_context io_context_;
+  std::shared_ptr<MuxSession> client_;
+  std::shared_ptr<MuxSession> server_;
+  thread worker_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<UdsSocket> accepted_;
+};
+
+TEST_F(MuxSessionTest, ForwardTraffic) {
+  UdsSocket app_sock = OpenStream();
+  UdsSocket dest_sock = AcceptStream();
+
+  constexpr size_t kSize = 10 * 1024 * 1024;
+  auto send_buf = make_unique<uint8_t[]>(kSize);
+  for (size_t i = 0; i < kSize; ++i) {
+    send_buf[i] = i & 0xff;
+  }
+  thread writer_thread([&]() {
+    error_code ec;
+    asio::write(app_sock, asio::buffer(send_buf.get(), kSize), ec);
+    EXPECT_FALSE(ec.failed());
+    app_sock.shutdown(UdsSocket::shutdown_send);
+  });
+
+  uint8_t recv_buf[1024];
+  size_t counter = 0UL;
+  while (true) {
+    error_code ec;
+    auto sz = dest_sock.read_some(asio::buffer(recv_buf), ec);
+    for (auto i = 0u; i < sz; ++i) {
+      EXPECT_EQ(recv_buf[i], counter++ & 0xff);
+    }
+    if (ec.failed()) {
+      break;
+    }
+  }
+  EXPECT_EQ(counter, kSize);
+  writer_thread.join();
+
+  // The other direction still works on the half-closed stream.
+  uint8_t reply[] = "foo bar hello world easy peasy lemon squeezy";
+  asio::write(dest_sock, asio::buffer(reply));
+  dest_sock.close();
+  uint8_t reply_buf[sizeof(reply)];
+  error_code ec;
+  size_t sz = asio::read(app_sock, asio::buffer(reply_buf), ec);
+  ASSERT_EQ(sz, sizeof(reply));
+  EXPECT_EQ(memcmp(reply, reply_buf, sizeof(reply)), 0);
+  sz = app_sock.read_some(asio::buffer(reply_buf), ec);
+  EXPECT_TRUE(ec.failed());
+  EXPECT_EQ(sz, 0);
+
+  // Both directions are done, so the stream goes away on both sides.
+  while (client_->NumStreams() > 0 || server_->NumStreams() > 0) {
+    std::this_thread::yield();
+  }
+}
+
+TEST_F(MuxSessionTest, ManyStreams) {
+  constexpr size_t kNumStreams = 16;
+  constexpr size_t kSize = 1024 * 1024;
+  vector<UdsSocket> app_socks;
+  vector<UdsSocket> dest_socks;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    app_socks.push_back(OpenStream());
+    dest_socks.push_back(AcceptStream());
+  }
+  // Echo on every stream, so that each stream has traffic in both directions
+  // at the same time.
+  vector<thread> threads;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    threads.emplace_back([&, i]() {
+      uint8_t buf[4096];
+      error_code ec;
+      while (true) {
+        size_t sz = dest_socks[i].read_some(asio::buffer(buf), ec);
+        if (ec.failed()) {
+          break;
+        }
+        asio::write(dest_socks[i], asio::buffer(buf, sz), ec);
+      }
+      dest_socks[i].close();
+    });
+    threads.emplace_back([&, i]() {
+      vector<uint8_t> data(kSize, static_cast<uint8_t>(i));
+      thread writer([&]() {
+        asio::write(app_socks[i], asio::buffer(data));
+        app_socks[i].shutdown(UdsSocket::shutdown_send);
+      });
+      vector<uint8_t> received(kSize);
+      error_code ec;
+      size_t sz = asio::read(app_socks[i], asio::buffer(received), ec);
+      EXPECT_EQ(sz, kSize);
+      EXPECT_EQ(received, data);
+      writer.join();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST(MuxSession, RefusedStream) {
+  asio::io_context io_context;
+  UdsSocket client_transport(io_context);
+  UdsSocket server_transport(io_context);
+  asio::local::connect_pair(client_transport, server_transport);
+  // Neither side accepts streams.
+  auto client = make_shared<MuxSession>(move(client_transport));
+  auto server = make_shared<MuxSession>(move(server_transport));
+  client->Start();
+  server->Start();
+  thread worker([&]() { io_context.run(); });
+
+  UdsSocket app_end(io_context);
+  UdsSocket mux_end(io_context);
+  asio::local::connect_pair(app_end, mux_end);
+  EXPECT_TRUE(client->OpenStream(Socket(move(mux_end))));
+  uint8_t buf[16];
+  error_code ec;
+  size_t sz = app_end.read_some(asio::buffer(buf), ec);
+  EXPECT_TRUE(ec.failed());
+  EXPECT_EQ(sz, 0);
+
+  client->Close();
+  server->Close();
+  io_context.stop();
+  worker.join();
+}
+
+TEST(MuxSession, TransportClosure) {
+  asio::io_context io_context;
+  UdsSocket client_transport(io_context);
+  UdsSocket server_transport(io_context);
+  asio::local::connect_pair(client_transport, server_transport);
+  auto client = make_shared<MuxSession>(move(client_transport));
+  client->Start();
+  thread worker([&]() { io_context.run(); });
+
+  UdsSocket app_end(io_context);
+  UdsSocket mux_end(io_context);
+  asio::local::connect_pair(app_end, mux_end);
+  EXPECT_TRUE(client->OpenStream(Socket(move(mux_end))));
+  // Losing the transport closes all the streams.
+  server_transport.close();
+  uint8_t buf[16];
+  error_code ec;
+  size_t sz = app_end.read_some(asio::buffer(buf), ec);
+  EXPECT_TRUE(ec.failed());
+  EXPECT_EQ(sz, 0);
+  EXPECT_FALSE(client->IsOpen());
+  EXPECT_FALSE(client->OpenStream(Socket(io_context)));
+
+  io_context.stop();
+  worker.join();
+}
+
+TEST(MuxSessionPool, ConnectsAndOpensStream) {
+  asio::io_context io_context;
+  auto work = asio::make_work_guard(io_context);
+  std::string sock_path = ::testing::TempDir() + "mux_session_pool_test.sock";
+  unlink(sock_path.c_str());
+  asio::local::stream_protocol::endpoint proxy_endpoint(sock_path);
+  asio::local::stream_protocol::acceptor proxy(io_context, proxy_endpoint);
+  MuxSessionPool pool(Endpoint(proxy_endpoint), 1u);
+  thread worker([&]() { io_context.run(); });
+
+  UdsSocket app_end(io_context);
+  UdsSocket mux_end(io_context);
+  asio::local::connect_pair(app_end, mux_end);
+  pool.OpenStream(Socket(move(mux_end)));
+  // The pool connects, sends the preamble, then opens the stream.
+  UdsSocket transport = proxy.accept();
+  uint8_t preamble[sizeof(mux::kPreamble)];
+  asio::read(transport, asio::buffer(preamble));
+  EXPECT_EQ(memcmp(preamble, mux::kPreamble, sizeof(preamble)), 0);
+  uint8_t buf[FrameHeader::kWireSize];
+  asio::read(transport, asio::buffer(buf));
+  FrameHeader header;
+  EXPECT_TRUE(header.Decode(buf));
+  EXPECT_EQ(header.type, FrameType::kOpen);
+
+  io_context.stop();
+  worker.join();
+  unlink(sock_path.c_str());
+}
+
+TEST(MuxSessionPool, ClosesStreamWithoutProxy) {
+  asio::io_context io_context;
+  auto work = asio::make_work_guard(io_context);
+  asio::local::stream_protocol::endpoint proxy_endpoint(
+      ::testing::TempDir() + "mux_session_pool_test_no_proxy.sock");
+  MuxSessionPool pool(Endpoint(proxy_endpoint), 1u);
+  thread worker([&]() { io_context.run(); });
+
+  UdsSocket app_end(io_context);
+  UdsSocket mux_end(io_context);
+  asio::local::connect_pair(app_end, mux_end);
+  pool.OpenStream(Socket(move(mux_end)));
+  uint8_t buf[16];
+  error_code ec;
+  size_t sz = app_end.read_some(asio::buffer(buf), ec);
+  EXPECT_TRUE(ec.failed());
+  EXPECT_EQ(sz, 0);
+
+  io_context.stop();
+  worker.join();
+}
+
+}  // namespace google::scp::proxy::test
@@ -29,6 +29,7 @@ __res_ninit
 accept
 accept4
 bind
+close
 connect
 epoll_ctl
 getsockopt
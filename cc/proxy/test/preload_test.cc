@@ -60,6 +60,17 @@ TEST_F(PreloadSyscallTest, getsockopt) {
   EXPECT_EQ(rc, 0);
 }
 
+// Test that getsockopt(IPPROTO_TCP) on a VSOCK socket fills in the value.
+TEST_F(PreloadSyscallTest, getsockoptFillsValue) {
+  int val = 1;
+  socklen_t sz = sizeof(val);
+
+  int rc = getsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &val, &sz);
+  EXPECT_EQ(rc, 0);
+  EXPECT_EQ(val, 0);
+  EXPECT_EQ(sz, sizeof(val));
+}
+
 TEST_F(PreloadSyscallTest, setsockopt) {
   int val = 1;
 
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// End-to-end benchmark of the proxy over loopback TCP. The ProxyServer runs in
+// a forked child process so that its CPU time and peak RSS can be measured in
+// isolation from the clients and the destination servers, which run in this
+// process. Each benchmark iteration starts [clients] concurrent SOCKS5 clients,
+// each of which makes one connection through the proxy and transfers
+// [payload] bytes to either an echo server or a sink server.
+//
+// BM_ProxyBridgeForward drives a single ProxyBridge in-process over unix domain
+// socket pairs, to count the read and write operations (i.e. syscalls) the
+// bridge makes to forward [payload] bytes.
+//
+// Reported counters:
+//   bytes_per_second   Bytes forwarded by the proxy, in both directions.
+//   connect_p50_us     TCP connect + SOCKS5 handshake latency percentiles.
+//   connect_p90_us
+//   connect_p99_us
+//   proxy_cpu_s_per_GB CPU seconds (user + sys) spent by the proxy per GB.
+//   proxy_peak_rss_MB  Peak resident set size of the proxy process.
+//   bytes_per_read     Average bytes forwarded per read/write operation of the
+//   bytes_per_write    bridge (BM_ProxyBridgeForward only).
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+
+#include "proxy/src/config.h"
+#include "proxy/src/proxy_bridge.h"
+#include "proxy/src/proxy_server.h"
+
+using boost::system::error_code;
+using std::atomic;
+using std::enable_shared_from_this;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+using tcp = boost::asio::ip::tcp;
+using UdsSocket = boost::asio::local::stream_protocol::socket;
+
+namespace asio = boost::asio;
+
+namespace google::scp::proxy::test {
+
+static constexpr size_t kChunkSize = 64 * 1024;
+
+// A destination server. In echo mode every byte received is written back. In
+// sink mode the data is discarded, and the connection is closed on EOF.
+class DestServer {
+ public:
+  explicit DestServer(bool echo)
+      : echo_(echo),
+        acceptor_(io_context_,
+                  tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0)) {
+    StartAccept();
+    for (size_t i = 0; i < 2; ++i) {
+      threads_.emplace_back([this]() { io_context_.run(); });
+    }
+  }
+
+  ~DestServer() {
+    io_context_.stop();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  uint16_t Port() const { return acceptor_.local_endpoint().port(); }
+
+ private:
+  class Session : public enable_shared_from_this<Session> {
+   public:
+    Session(tcp::socket sock, bool echo)
+        : sock_(std::move(sock)), echo_(echo) {}
+
+    void Read() {
+      sock_.async_read_some(
+          asio::buffer(buf_, sizeof(buf_)),
+          [self = shared_from_this()](const error_code& ec, size_t n) {
+            if (ec.failed()) {
+              return;
+            }
+            if (!self->echo_) {
+              self->Read();
+              return;
+            }
+            asio::async_write(
+                self->sock_, asio::buffer(self->buf_, n),
+                [self](const error_code& ec, size_t) {
+                  if (!ec.failed()) {
+                    self->Read();
+                  }
+                });
+          });
+    }
+
+   private:
+    tcp::socket sock_;
+    const bool echo_;
+    uint8_t buf_[kChunkSize];
+  };
+
+  void StartAccept() {
+    acceptor_.async_accept([this](const error_code& ec, tcp::socket sock) {
+      if (ec.failed()) {
+        return;
+      }
+      make_shared<Session>(std::move(sock), echo_)->Read();
+      StartAccept();
+    });
+  }
+
+  const bool echo_;
+  asio::io_context io_context_;
+  tcp::acceptor acceptor_;
+  vector<thread> threads_;
+};
+
+// The proxy under test, running in a child process.
+class ProxyProcess {
+ public:
+  // Must be called before any thread is started in this process.
+  ProxyProcess() {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      abort();
+    }
+    pid_ = fork();
+    if (pid_ == 0) {
+      close(fds[0]);
+      // Silence the per-connection logs.
+      freopen("/dev/null", "w", stdout);
+      Config config;
+      config.vsock_ = false;
+      config.socks5_port_ = 0;
+      ProxyServer server(config);
+      server.BindListen();
+      uint16_t port = server.Port();
+      write(fds[1], &port, sizeof(port));
+      close(fds[1]);
+      server.Run();
+      _exit(0);
+    }
+    close(fds[1]);
+    if (read(fds[0], &port_, sizeof(port_)) != sizeof(port_)) {
+      abort();
+    }
+    close(fds[0]);
+  }
+
+  ~ProxyProcess() {
+    kill(pid_, SIGKILL);
+    waitpid(pid_, nullptr, 0);
+  }
+
+  uint16_t Port() const { return port_; }
+
+  // CPU seconds (user + sys) consumed by the proxy so far.
+  double CpuSeconds() const {
+    std::ifstream stat("/proc/" + std::to_string(pid_) + "/stat");
+    string field;
+    // Skip to field 14 (utime), followed by field 15 (stime). The second field
+    // is the command name in parentheses, which contains no spaces here.
+    for (int i = 0; i < 13; ++i) {
+      stat >> field;
+    }
+    uint64_t utime = 0, stime = 0;
+    stat >> utime >> stime;
+    return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+  }
+
+  // Peak resident set size of the proxy in MB.
+  double PeakRssMB() const {
+    std::ifstream status("/proc/" + std::to_string(pid_) + "/status");
+    string line;
+    while (std::getline(status, line)) {
+      if (line.rfind("VmHWM:", 0) == 0) {
+        return std::stod(line.substr(6)) / 1024;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  pid_t pid_;
+  uint16_t port_;
+};
+
+// Connect to dest_port through the proxy, returning the time taken by TCP
+// connect and the SOCKS5 handshake.
+static microseconds Socks5Connect(tcp::socket& sock, uint16_t proxy_port,
+                                  uint16_t dest_port) {
+  auto start = steady_clock::now();
+  sock.connect(
+      tcp::endpoint(asio::ip::make_address("127.0.0.1"), proxy_port));
+  sock.set_option(tcp::no_delay(true));
+  uint8_t request[] = {0x05, 0x01, 0x00,        // <- Greeting
+                       0x05, 0x01, 0x00, 0x01,  // <- CONNECT, IPv4
+                       0x7f, 0x00, 0x00, 0x01,  // <- addr = 127.0.0.1
+                       0x00, 0x00};             // <- port
+  request[11] = dest_port >> 8;
+  request[12] = dest_port & 0xff;
+  asio::write(sock, asio::buffer(request));
+  // Method selection reply is 2 bytes, connection reply is 10 bytes in IPv4.
+  uint8_t reply[12];
+  asio::read(sock, asio::buffer(reply));
+  if (reply[1] != 0x00 || reply[3] != 0x00) {
+    abort();
+  }
+  return duration_cast<microseconds>(steady_clock::now() - start);
+}
+
+// Send payload_size bytes and, in echo mode, read them back in lockstep. In
+// sink mode, half-close and wait for the proxy to relay the sink's EOF.
+static void Transfer(tcp::socket& sock, size_t payload_size, bool echo) {
+  vector<uint8_t> buf(kChunkSize, 0x5a);
+  size_t remaining = payload_size;
+  while (remaining > 0) {
+    size_t len = std::min(remaining, kChunkSize);
+    asio::write(sock, asio::buffer(buf.data(), len));
+    if (echo) {
+      asio::read(sock, asio::buffer(buf.data(), len));
+    }
+    remaining -= len;
+  }
+  sock.shutdown(tcp::socket::shutdown_send);
+  error_code ec;
+  while (!ec.failed()) {
+    sock.read_some(asio::buffer(buf), ec);
+  }
+}
+
+static void RunProxyBenchmark(benchmark::State& state, bool echo) {
+  const size_t num_clients = state.range(0);
+  const size_t payload_size = state.range(1);
+  ProxyProcess proxy;
+  DestServer dest(echo);
+  const uint16_t dest_port = dest.Port();
+
+  vector<int64_t> connect_latencies;
+  double cpu_start = proxy.CpuSeconds();
+  for (auto _ : state) {
+    vector<int64_t> latencies(num_clients);
+    vector<thread> clients;
+    clients.reserve(num_clients);
+    for (size_t i = 0; i < num_clients; ++i) {
+      clients.emplace_back([&, i]() {
+        asio::io_context io_context;
+        tcp::socket sock(io_context);
+        latencies[i] = Socks5Connect(sock, proxy.Port(), dest_port).count();
+        Transfer(sock, payload_size, echo);
+      });
+    }
+    for (auto& t : clients) {
+      t.join();
+    }
+    connect_latencies.insert(connect_latencies.end(), latencies.begin(),
+                             latencies.end());
+  }
+  double cpu_seconds = proxy.CpuSeconds() - cpu_start;
+
+  int64_t bytes_forwarded =
+      state.iterations() * num_clients * payload_size * (echo ? 2 : 1);
+  state.SetBytesProcessed(bytes_forwarded);
+
+  std::sort(connect_latencies.begin(), connect_latencies.end());
+  auto percentile = [&](double p) {
+    if (connect_latencies.empty()) {
+      return 0.0;
+    }
+    size_t idx = static_cast<size_t>(p * (connect_latencies.size() - 1));
+    return static_cast<double>(connect_latencies[idx]);
+  };
+  state.counters["connect_p50_us"] = percentile(0.50);
+  state.counters["connect_p90_us"] = percentile(0.90);
+  state.counters["connect_p99_us"] = percentile(0.99);
+  if (bytes_forwarded > 0) {
+    state.counters["proxy_cpu_s_per_GB"] =
+        cpu_seconds / (static_cast<double>(bytes_forwarded) / (1 << 30));
+  }
+  state.counters["proxy_peak_rss_MB"] = proxy.PeakRssMB();
+}
+
+static void BM_ProxyBridgeForward(benchmark::State& state) {
+  const size_t payload_size = state.range(0);
+  vector<uint8_t> send_buf(payload_size, 0x5a);
+  size_t num_reads = 0, num_writes = 0;
+  for (auto _ : state) {
+    asio::io_context io_context;
+    UdsSocket client_sock0(io_context);
+    UdsSocket client_sock1(io_context);
+    UdsSocket dest_sock0(io_context);
+    UdsSocket dest_sock1(io_context);
+    asio::local::connect_pair(client_sock0, client_sock1);
+    asio::local::connect_pair(dest_sock0, dest_sock1);
+    auto bridge =
+        make_shared<ProxyBridge>(std::move(client_sock1), std::move(dest_sock1));
+    bridge->ForwardTraffic();
+    thread worker_thread([&]() { io_context.run(); });
+    thread writer_thread([&]() {
+      asio::write(client_sock0, asio::buffer(send_buf));
+      client_sock0.close();
+    });
+    vector<uint8_t> recv_buf(1024 * 1024);
+    error_code ec;
+    while (!ec.failed()) {
+      dest_sock0.read_some(asio::buffer(recv_buf), ec);
+    }
+    writer_thread.join();
+    dest_sock0.close();
+    worker_thread.join();
+    num_reads += bridge->NumReads();
+    num_writes += bridge->NumWrites();
+  }
+  state.SetBytesProcessed(state.iterations() * payload_size);
+  // The EOF read and the final zero-byte operations are negligible here.
+  state.counters["bytes_per_read"] =
+      static_cast<double>(state.iterations() * payload_size) / num_reads;
+  state.counters["bytes_per_write"] =
+      static_cast<double>(state.iterations() * payload_size) / num_writes;
+}
+
+static void BM_ProxyEcho(benchmark::State& state) {
+  RunProxyBenchmark(state, /*echo=*/true);
+}
+
+static void BM_ProxySink(benchmark::State& state) {
+  RunProxyBenchmark(state, /*echo=*/false);
+}
+}  // namespace google::scp::proxy::test
+
+// Arg<Payload size>
+BENCHMARK(google::scp::proxy::test::BM_ProxyBridgeForward)
+    ->Arg(1 << 20)
+    ->Arg(64 << 20)
+    ->UseRealTime();
+
+// Args<Number of concurrent clients, Payload size per client>
+BENCHMARK(google::scp::proxy::test::BM_ProxyEcho)
+    ->ArgsProduct({{1, 8, 64}, {0, 1 << 10, 64 << 10, 1 << 20, 16 << 20}})
+    ->UseRealTime();
+
+// Args<Number of concurrent clients, Payload size per client>
+BENCHMARK(google::scp::proxy::test::BM_ProxySink)
+    ->ArgsProduct({{1, 8, 64}, {1 << 10, 64 << 10, 1 << 20, 16 << 20}})
+    ->UseRealTime();
+
+int main(int argc, char** argv) {
+  // Writes to a connection closed by the proxy should fail, not kill us.
+  signal(SIGPIPE, SIG_IGN);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
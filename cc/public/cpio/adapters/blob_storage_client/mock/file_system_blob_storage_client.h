@@ -167,6 +167,21 @@ class FileSystemBlobStorageClient : public BlobStorageClientInterface {
     return core::FailureExecutionResult(SC_UNKNOWN);
   }
 
+  void DeleteBlobs(core::AsyncContext<
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+                   cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+                       delete_blobs_context) noexcept override {
+    delete_blobs_context.result = core::FailureExecutionResult(SC_UNKNOWN);
+    delete_blobs_context.Finish();
+  }
+
+  core::ExecutionResultOr<
+      cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>
+  DeleteBlobsSync(cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest
+                      request) noexcept override {
+    return core::FailureExecutionResult(SC_UNKNOWN);
+  }
+
   void GetBlobStream(
       core::ConsumerStreamingContext<
           cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
@@ -31,6 +31,8 @@
 
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse;
@@ -192,6 +194,44 @@ ExecutionResultOr<DeleteBlobResponse> BlobStorageClient::DeleteBlobSync(
   return response;
 }
 
+void BlobStorageClient::DeleteBlobs(
+    AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>&
+        delete_blobs_context) noexcept {
+  delete_blobs_context.setConvertToPublicError(true);
+  // The result of each blob is converted as well as the one of the operation.
+  AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse> context(
+      delete_blobs_context.request,
+      [delete_blobs_context](auto& context) mutable {
+        delete_blobs_context.result = context.result;
+        delete_blobs_context.response = context.response;
+        if (delete_blobs_context.response) {
+          for (auto& blob_result :
+               *delete_blobs_context.response->mutable_blob_results()) {
+            *blob_result.mutable_result() =
+                ConvertToPublicExecutionResult(
+                    ExecutionResult(blob_result.result()))
+                    .ToProto();
+          }
+        }
+        delete_blobs_context.Finish();
+      },
+      delete_blobs_context);
+  blob_storage_client_provider_->DeleteBlobs(context);
+}
+
+ExecutionResultOr<DeleteBlobsResponse> BlobStorageClient::DeleteBlobsSync(
+    DeleteBlobsRequest request) noexcept {
+  DeleteBlobsResponse response;
+  auto execution_result =
+      SyncUtils::AsyncToSync2<DeleteBlobsRequest, DeleteBlobsResponse>(
+          bind(&BlobStorageClient::DeleteBlobs, this, _1), move(request),
+          response);
+  RETURN_AND_LOG_IF_FAILURE(ConvertToPublicExecutionResult(execution_result),
+                            kBlobStorageClient, kZeroUuid,
+                            "Failed to delete blobs.");
+  return response;
+}
+
 void BlobStorageClient::GetBlobStream(
     ConsumerStreamingContext<
         cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
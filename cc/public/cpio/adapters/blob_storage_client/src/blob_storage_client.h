@@ -86,6 +86,18 @@ class BlobStorageClient : public BlobStorageClientInterface {
   DeleteBlobSync(google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest
                      request) noexcept override;
 
+  void DeleteBlobs(
+      core::AsyncContext<
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+          delete_blobs_context) noexcept override;
+
+  core::ExecutionResultOr<
+      google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>
+  DeleteBlobsSync(
+      google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest
+          request) noexcept override;
+
   /// Streaming operations.
 
   void GetBlobStream(
@@ -18,6 +18,7 @@
 #include "core/test/utils/conditional_wait.h"
 #include "core/test/utils/proto_test_utils.h"
 #include "core/test/utils/scp_test_base.h"
+#include "cpio/client_providers/blob_storage_client_provider/src/common/error_codes.h"
 #include "public/core/interface/execution_result.h"
 #include "public/core/test/interface/execution_result_matchers.h"
 #include "public/cpio/adapters/blob_storage_client/mock/mock_blob_storage_client_with_overrides.h"
@@ -28,6 +29,8 @@
 using google::cmrt::sdk::blob_storage_service::v1::BlobMetadata;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobResponse;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest;
+using google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobRequest;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobResponse;
 using google::cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest;
@@ -40,9 +43,12 @@ using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest;
 using google::cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse;
 using google::scp::core::AsyncContext;
 using google::scp::core::ConsumerStreamingContext;
+using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::ProducerStreamingContext;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND;
+using google::scp::core::errors::SC_CPIO_ENTITY_NOT_FOUND;
 using google::scp::core::errors::SC_CPIO_UNKNOWN_ERROR;
 using google::scp::core::test::EqualsProto;
 using google::scp::core::test::IsSuccessful;
@@ -193,6 +199,28 @@ TEST_F(BlobStorageClientTest, DeleteBlobSyncSuccess) {
   EXPECT_SUCCESS(client_.DeleteBlobSync(DeleteBlobRequest()).result());
 }
 
+TEST_F(BlobStorageClientTest, DeleteBlobsSyncConvertsBlobResults) {
+  EXPECT_CALL(client_.GetBlobStorageClientProvider(), DeleteBlobs)
+      .WillOnce(
+          [=](AsyncContext<DeleteBlobsRequest, DeleteBlobsResponse>& context) {
+            context.response = make_shared<DeleteBlobsResponse>();
+            *context.response->add_blob_results()->mutable_result() =
+                SuccessExecutionResult().ToProto();
+            *context.response->add_blob_results()->mutable_result() =
+                FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)
+                    .ToProto();
+            context.result = SuccessExecutionResult();
+            context.Finish();
+          });
+  auto response = client_.DeleteBlobsSync(DeleteBlobsRequest());
+  ASSERT_SUCCESS(response.result());
+  ASSERT_EQ(response->blob_results_size(), 2);
+  EXPECT_SUCCESS(ExecutionResult(response->blob_results(0).result()));
+  EXPECT_THAT(ExecutionResult(response->blob_results(1).result()),
+              ResultIs(FailureExecutionResult(SC_CPIO_ENTITY_NOT_FOUND)));
+}
+
 TEST_F(BlobStorageClientTest, GetBlobStreamSuccess) {
   atomic_bool finished(false);
   EXPECT_CALL(client_.GetBlobStorageClientProvider(), GetBlobStream)
@@ -26,6 +26,7 @@
 #include "core/interface/errors.h"
 #include "core/utils/src/error_utils.h"
 #include "cpio/client_providers/crypto_client_provider/src/crypto_client_provider.h"
+#include "cpio/client_providers/global_cpio/src/global_cpio.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/adapters/common/adapter_utils.h"
 #include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
@@ -37,6 +38,10 @@ using google::cmrt::sdk::crypto_service::v1::AeadDecryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacRequest;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacResponse;
 using google::cmrt::sdk::crypto_service::v1::HpkeDecryptRequest;
@@ -44,12 +49,14 @@ using google::cmrt::sdk::crypto_service::v1::HpkeDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::HpkeEncryptRequest;
 using google::cmrt::sdk::crypto_service::v1::HpkeEncryptResponse;
 using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
 using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::utils::ConvertToPublicExecutionResult;
 using google::scp::cpio::client_providers::CryptoClientProvider;
+using google::scp::cpio::client_providers::GlobalCpio;
 using std::bind;
 using std::make_shared;
 using std::make_unique;
@@ -64,12 +71,23 @@ constexpr char kCryptoClient[] = "CryptoClient";
 
 namespace google::scp::cpio {
 CryptoClient::CryptoClient(const std::shared_ptr<CryptoClientOptions>& options)
-    : options_(options) {
-  crypto_client_provider_ = make_shared<CryptoClientProvider>(options_);
-}
+    : options_(options) {}
 
 ExecutionResult CryptoClient::Init() noexcept {
-  return ConvertToPublicExecutionResult(crypto_client_provider_->Init());
+  shared_ptr<AsyncExecutorInterface> cpu_async_executor;
+  auto execution_result =
+      GlobalCpio::GetGlobalCpio()->GetCpuAsyncExecutor(cpu_async_executor);
+  RETURN_AND_LOG_IF_FAILURE(ConvertToPublicExecutionResult(execution_result),
+                            kCryptoClient, kZeroUuid,
+                            "Failed to get CpuAsyncExecutor.");
+
+  crypto_client_provider_ =
+      make_shared<CryptoClientProvider>(options_, cpu_async_executor);
+  execution_result = crypto_client_provider_->Init();
+  RETURN_AND_LOG_IF_FAILURE(ConvertToPublicExecutionResult(execution_result),
+                            kCryptoClient, kZeroUuid,
+                            "Failed to initialize CryptoClientProvider.");
+  return SuccessExecutionResult();
 }
 
 ExecutionResult CryptoClient::Run() noexcept {
@@ -104,6 +122,35 @@ ExecutionResultOr<AeadDecryptResponse> CryptoClient::AeadDecryptSync(
       crypto_client_provider_->AeadDecryptSync(request));
 }
 
+/// Converts the per item results of a batch response to public results.
+template <typename TResponse>
+ExecutionResultOr<TResponse> ConvertBatchToPublicExecutionResult(
+    ExecutionResultOr<TResponse> response_or) {
+  if (!response_or.Successful()) {
+    return ConvertToPublicExecutionResult(response_or.result());
+  }
+  for (auto& item_response : *response_or->mutable_responses()) {
+    ExecutionResult item_result(item_response.result());
+    if (!item_result.Successful()) {
+      *item_response.mutable_result() =
+          ConvertToPublicExecutionResult(item_result).ToProto();
+    }
+  }
+  return response_or;
+}
+
+ExecutionResultOr<BatchHpkeDecryptResponse> CryptoClient::BatchHpkeDecryptSync(
+    const BatchHpkeDecryptRequest& request) noexcept {
+  return ConvertBatchToPublicExecutionResult(
+      crypto_client_provider_->BatchHpkeDecryptSync(request));
+}
+
+ExecutionResultOr<BatchAeadDecryptResponse> CryptoClient::BatchAeadDecryptSync(
+    const BatchAeadDecryptRequest& request) noexcept {
+  return ConvertBatchToPublicExecutionResult(
+      crypto_client_provider_->BatchAeadDecryptSync(request));
+}
+
 ExecutionResultOr<ComputeMacResponse> CryptoClient::ComputeMacSync(
     const ComputeMacRequest& request) noexcept {
   return ConvertToPublicExecutionResult(
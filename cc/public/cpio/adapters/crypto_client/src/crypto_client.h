@@ -55,6 +55,18 @@ class CryptoClient : public CryptoClientInterface {
   AeadDecryptSync(const cmrt::sdk::crypto_service::v1::AeadDecryptRequest&
                       request) noexcept override;
 
+  core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse>
+  BatchHpkeDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest&
+          request) noexcept override;
+
+  core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse>
+  BatchAeadDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest&
+          request) noexcept override;
+
   core::ExecutionResultOr<cmrt::sdk::crypto_service::v1::ComputeMacResponse>
   ComputeMacSync(const cmrt::sdk::crypto_service::v1::ComputeMacRequest&
                      request) noexcept override;
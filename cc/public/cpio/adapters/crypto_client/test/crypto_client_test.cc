@@ -36,6 +36,10 @@ using google::cmrt::sdk::crypto_service::v1::AeadDecryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
 using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest;
+using google::cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacRequest;
 using google::cmrt::sdk::crypto_service::v1::ComputeMacResponse;
 using google::cmrt::sdk::crypto_service::v1::HpkeDecryptRequest;
@@ -149,6 +153,40 @@ TEST_F(CryptoClientTest, AeadDecryptSyncFailure) {
               ResultIs(FailureExecutionResult(SC_CPIO_UNKNOWN_ERROR)));
 }
 
+TEST_F(CryptoClientTest, BatchHpkeDecryptSyncSuccess) {
+  EXPECT_CALL(*client_->GetCryptoClientProvider(), BatchHpkeDecryptSync)
+      .WillOnce(Return(BatchHpkeDecryptResponse()));
+
+  EXPECT_THAT(client_->BatchHpkeDecryptSync(BatchHpkeDecryptRequest()),
+              IsSuccessfulAndHolds(EqualsProto(BatchHpkeDecryptResponse())));
+}
+
+TEST_F(CryptoClientTest, BatchHpkeDecryptSyncFailure) {
+  auto failure = FailureExecutionResult(SC_UNKNOWN);
+  EXPECT_CALL(*client_->GetCryptoClientProvider(), BatchHpkeDecryptSync)
+      .WillOnce(Return(failure));
+
+  EXPECT_THAT(client_->BatchHpkeDecryptSync(BatchHpkeDecryptRequest()).result(),
+              ResultIs(FailureExecutionResult(SC_CPIO_UNKNOWN_ERROR)));
+}
+
+TEST_F(CryptoClientTest, BatchAeadDecryptSyncConvertsItemResults) {
+  BatchAeadDecryptResponse response;
+  *response.add_responses()->mutable_result() =
+      SuccessExecutionResult().ToProto();
+  *response.add_responses()->mutable_result() =
+      FailureExecutionResult(SC_UNKNOWN).ToProto();
+  EXPECT_CALL(*client_->GetCryptoClientProvider(), BatchAeadDecryptSync)
+      .WillOnce(Return(response));
+
+  auto response_or = client_->BatchAeadDecryptSync(BatchAeadDecryptRequest());
+  ASSERT_SUCCESS(response_or);
+  ASSERT_EQ(response_or->responses_size(), 2);
+  EXPECT_SUCCESS(ExecutionResult(response_or->responses(0).result()));
+  EXPECT_THAT(ExecutionResult(response_or->responses(1).result()),
+              ResultIs(FailureExecutionResult(SC_CPIO_UNKNOWN_ERROR)));
+}
+
 TEST_F(CryptoClientTest, ComputeMacSyncSuccess) {
   EXPECT_CALL(*client_->GetCryptoClientProvider(), ComputeMacSync)
       .WillOnce(Return(ComputeMacResponse()));
@@ -30,10 +30,16 @@
 
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -115,6 +121,24 @@ ExecutionResultOr<EnqueueMessageResponse> QueueClient::EnqueueMessageSync(
   return response;
 }
 
+void QueueClient::EnqueueMessages(
+    AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+        enqueue_messages_context) noexcept {
+  queue_client_provider_->EnqueueMessages(enqueue_messages_context);
+}
+
+ExecutionResultOr<EnqueueMessagesResponse> QueueClient::EnqueueMessagesSync(
+    EnqueueMessagesRequest request) noexcept {
+  EnqueueMessagesResponse response;
+  auto execution_result =
+      SyncUtils::AsyncToSync2<EnqueueMessagesRequest, EnqueueMessagesResponse>(
+          bind(&QueueClient::EnqueueMessages, this, _1), move(request),
+          response);
+  RETURN_AND_LOG_IF_FAILURE(execution_result, kQueueClient, kZeroUuid,
+                            "Failed to enqueue messages.");
+  return response;
+}
+
 void QueueClient::GetTopMessage(
     AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
         get_top_message_context) noexcept {
@@ -132,6 +156,24 @@ ExecutionResultOr<GetTopMessageResponse> QueueClient::GetTopMessageSync(
   return response;
 }
 
+void QueueClient::GetTopMessages(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  queue_client_provider_->GetTopMessages(get_top_messages_context);
+}
+
+ExecutionResultOr<GetTopMessagesResponse> QueueClient::GetTopMessagesSync(
+    GetTopMessagesRequest request) noexcept {
+  GetTopMessagesResponse response;
+  auto execution_result =
+      SyncUtils::AsyncToSync2<GetTopMessagesRequest, GetTopMessagesResponse>(
+          bind(&QueueClient::GetTopMessages, this, _1), move(request),
+          response);
+  RETURN_AND_LOG_IF_FAILURE(execution_result, kQueueClient, kZeroUuid,
+                            "Failed to get top messages.");
+  return response;
+}
+
 void QueueClient::UpdateMessageVisibilityTimeout(
     AsyncContext<UpdateMessageVisibilityTimeoutRequest,
                  UpdateMessageVisibilityTimeoutResponse>&
@@ -171,6 +213,24 @@ ExecutionResultOr<DeleteMessageResponse> QueueClient::DeleteMessageSync(
   return response;
 }
 
+void QueueClient::DeleteMessages(
+    AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+        delete_messages_context) noexcept {
+  queue_client_provider_->DeleteMessages(delete_messages_context);
+}
+
+ExecutionResultOr<DeleteMessagesResponse> QueueClient::DeleteMessagesSync(
+    DeleteMessagesRequest request) noexcept {
+  DeleteMessagesResponse response;
+  auto execution_result =
+      SyncUtils::AsyncToSync2<DeleteMessagesRequest, DeleteMessagesResponse>(
+          bind(&QueueClient::DeleteMessages, this, _1), move(request),
+          response);
+  RETURN_AND_LOG_IF_FAILURE(execution_result, kQueueClient, kZeroUuid,
+                            "Failed to delete messages.");
+  return response;
+}
+
 unique_ptr<QueueClientInterface> QueueClientFactory::Create(
     QueueClientOptions options) noexcept {
   return make_unique<QueueClient>(make_shared<QueueClientOptions>(options));
@@ -50,6 +50,15 @@ class QueueClient : public QueueClientInterface {
   EnqueueMessageSync(cmrt::sdk::queue_service::v1::EnqueueMessageRequest
                          request) noexcept override;
 
+  void EnqueueMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept override;
+
+  core::ExecutionResultOr<cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>
+  EnqueueMessagesSync(cmrt::sdk::queue_service::v1::EnqueueMessagesRequest
+                          request) noexcept override;
+
   void GetTopMessage(
       core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
@@ -59,6 +68,15 @@ class QueueClient : public QueueClientInterface {
   GetTopMessageSync(cmrt::sdk::queue_service::v1::GetTopMessageRequest
                         request) noexcept override;
 
+  void GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept override;
+
+  core::ExecutionResultOr<cmrt::sdk::queue_service::v1::GetTopMessagesResponse>
+  GetTopMessagesSync(cmrt::sdk::queue_service::v1::GetTopMessagesRequest
+                         request) noexcept override;
+
   void UpdateMessageVisibilityTimeout(
       core::AsyncContext<
           cmrt::sdk::queue_service::v1::UpdateMessageVisibilityTimeoutRequest,
@@ -80,6 +98,15 @@ class QueueClient : public QueueClientInterface {
   DeleteMessageSync(cmrt::sdk::queue_service::v1::DeleteMessageRequest
                         request) noexcept override;
 
+  void DeleteMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept override;
+
+  core::ExecutionResultOr<cmrt::sdk::queue_service::v1::DeleteMessagesResponse>
+  DeleteMessagesSync(cmrt::sdk::queue_service::v1::DeleteMessagesRequest
+                         request) noexcept override;
+
  protected:
   std::shared_ptr<client_providers::QueueClientProviderInterface>
       queue_client_provider_;
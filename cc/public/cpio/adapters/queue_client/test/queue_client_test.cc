@@ -26,10 +26,16 @@
 
 using google::cmrt::sdk::queue_service::v1::DeleteMessageRequest;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::DeleteMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::EnqueueMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -87,6 +93,42 @@ TEST_F(QueueClientTest, EnqueueMessageSyncSuccess) {
   EXPECT_SUCCESS(client_.EnqueueMessageSync(EnqueueMessageRequest()).result());
 }
 
+TEST_F(QueueClientTest, EnqueueMessagesSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), EnqueueMessages)
+      .WillOnce(
+          [=](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                  context) {
+            context.response = make_shared<EnqueueMessagesResponse>();
+            context.result = SuccessExecutionResult();
+            context.Finish();
+            return SuccessExecutionResult();
+          });
+
+  atomic<bool> finished = false;
+  auto context = AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>(
+      make_shared<EnqueueMessagesRequest>(), [&finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_THAT(*context.response, EqualsProto(EnqueueMessagesResponse()));
+        finished = true;
+      });
+  client_.EnqueueMessages(context);
+  WaitUntil([&]() { return finished.load(); });
+}
+
+TEST_F(QueueClientTest, EnqueueMessagesSyncSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), EnqueueMessages)
+      .WillOnce(
+          [=](AsyncContext<EnqueueMessagesRequest, EnqueueMessagesResponse>&
+                  context) {
+            context.response = make_shared<EnqueueMessagesResponse>();
+            context.result = SuccessExecutionResult();
+            context.Finish();
+            return SuccessExecutionResult();
+          });
+  EXPECT_SUCCESS(
+      client_.EnqueueMessagesSync(EnqueueMessagesRequest()).result());
+}
+
 TEST_F(QueueClientTest, GetTopMessageSuccess) {
   EXPECT_CALL(client_.GetQueueClientProvider(), GetTopMessage)
       .WillOnce([=](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
@@ -120,6 +162,39 @@ TEST_F(QueueClientTest, GetTopMessageSyncSuccess) {
   EXPECT_SUCCESS(client_.GetTopMessageSync(GetTopMessageRequest()).result());
 }
 
+TEST_F(QueueClientTest, GetTopMessagesSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), GetTopMessages)
+      .WillOnce([=](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                        context) {
+        context.response = make_shared<GetTopMessagesResponse>();
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  atomic<bool> finished = false;
+  auto context = AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>(
+      make_shared<GetTopMessagesRequest>(), [&finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_THAT(*context.response, EqualsProto(GetTopMessagesResponse()));
+        finished = true;
+      });
+  client_.GetTopMessages(context);
+  WaitUntil([&]() { return finished.load(); });
+}
+
+TEST_F(QueueClientTest, GetTopMessagesSyncSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), GetTopMessages)
+      .WillOnce([=](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                        context) {
+        context.response = make_shared<GetTopMessagesResponse>();
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  EXPECT_SUCCESS(client_.GetTopMessagesSync(GetTopMessagesRequest()).result());
+}
+
 TEST_F(QueueClientTest, UpdateMessageVisibilityTimeoutSuccess) {
   EXPECT_CALL(client_.GetQueueClientProvider(), UpdateMessageVisibilityTimeout)
       .WillOnce(
@@ -195,4 +270,40 @@ TEST_F(QueueClientTest, DeleteMessageSyncSuccess) {
       });
   EXPECT_SUCCESS(client_.DeleteMessageSync(DeleteMessageRequest()).result());
 }
+
+TEST_F(QueueClientTest, DeleteMessagesSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), DeleteMessages)
+      .WillOnce(
+          [=](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                  context) {
+            context.response = make_shared<DeleteMessagesResponse>();
+            context.result = SuccessExecutionResult();
+            context.Finish();
+            return SuccessExecutionResult();
+          });
+
+  atomic<bool> finished = false;
+  auto context = AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>(
+      make_shared<DeleteMessagesRequest>(), [&finished](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_THAT(*context.response, EqualsProto(DeleteMessagesResponse()));
+        finished = true;
+      });
+  client_.DeleteMessages(context);
+  WaitUntil([&]() { return finished.load(); });
+}
+
+TEST_F(QueueClientTest, DeleteMessagesSyncSuccess) {
+  EXPECT_CALL(client_.GetQueueClientProvider(), DeleteMessages)
+      .WillOnce(
+          [=](AsyncContext<DeleteMessagesRequest, DeleteMessagesResponse>&
+                  context) {
+            context.response = make_shared<DeleteMessagesResponse>();
+            context.result = SuccessExecutionResult();
+            context.Finish();
+            return SuccessExecutionResult();
+          });
+  EXPECT_SUCCESS(
+      client_.DeleteMessagesSync(DeleteMessagesRequest()).result());
+}
 }  // namespace google::scp::cpio::test
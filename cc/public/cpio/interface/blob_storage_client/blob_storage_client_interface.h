@@ -131,6 +131,32 @@ class BlobStorageClientInterface : public core::ServiceInterface {
   DeleteBlobSync(google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest
                      request) noexcept = 0;
 
+  /**
+   * @brief Deletes Blobs in storage, in batches sent concurrently.
+   *
+   * The operation succeeds once every Blob was tried; the response has the
+   * result of each Blob.
+   *
+   * @param delete_blobs_context The context for the operation.
+   */
+  virtual void DeleteBlobs(
+      core::AsyncContext<
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&
+          delete_blobs_context) noexcept = 0;
+
+  /**
+   * @brief Deletes Blobs in storage in a blocking call.
+   *
+   * @param request request to delete blobs.
+   * @return ExecutionResultOr<DeleteBlobsResponse> result of the operation.
+   */
+  virtual core::ExecutionResultOr<
+      google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>
+  DeleteBlobsSync(
+      google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest
+          request) noexcept = 0;
+
   /// Streaming operations.
 
   /**
@@ -18,6 +18,7 @@
 #define SCP_CPIO_INTERFACE_BLOB_STORAGE_CLIENT_TYPE_DEF_H_
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -35,7 +36,17 @@ struct BlobStorageClientOptions {
 
   BlobStorageClientOptions(const BlobStorageClientOptions& options)
       : transfer_stall_timeout(options.transfer_stall_timeout),
-        retry_limit(options.retry_limit) {}
+        retry_limit(options.retry_limit),
+        get_blob_stream_parallelism(options.get_blob_stream_parallelism),
+        get_blob_stream_part_size(options.get_blob_stream_part_size),
+        put_blob_stream_parallelism(options.put_blob_stream_parallelism),
+        put_blob_stream_part_size(options.put_blob_stream_part_size),
+        list_all_blobs_parallelism(options.list_all_blobs_parallelism),
+        delete_blobs_parallelism(options.delete_blobs_parallelism),
+        local_root_directory(options.local_root_directory),
+        cache_directory(options.cache_directory),
+        cache_size_bytes(options.cache_size_bytes),
+        cache_revalidation_interval(options.cache_revalidation_interval) {}
 
   // GCP - How long a blob storage transfer (download or upload) should stay
   // alive for after some duration of inaction.
@@ -45,6 +56,45 @@ struct BlobStorageClientOptions {
   std::chrono::seconds cached_client_lifetime = std::chrono::seconds(60 * 10);
   // GCP - How many retries should be used for blob storage operations.
   size_t retry_limit = 3;
+  // How many ranged reads a GetBlobStream keeps in flight at once. Parts read
+  // ahead are buffered until they can be returned in order. 1 reads the blob
+  // one response at a time.
+  size_t get_blob_stream_parallelism = 1;
+  // The size of each ranged read of a GetBlobStream, when
+  // get_blob_stream_parallelism is above 1. Up to
+  // get_blob_stream_parallelism * get_blob_stream_part_size bytes are buffered
+  // per stream.
+  uint64_t get_blob_stream_part_size = 8 << 20;
+  // AWS - How many parts of a multipart upload a PutBlobStream keeps in flight
+  // at once. No more data is taken from the stream while they are in flight.
+  // 1 uploads one part at a time.
+  size_t put_blob_stream_parallelism = 1;
+  // AWS - The size of each uploaded part of a PutBlobStream, when
+  // put_blob_stream_parallelism is above 1. Sizes below the 5MiB minimum of S3
+  // are raised to it. Up to (put_blob_stream_parallelism + 1) *
+  // put_blob_stream_part_size bytes are buffered per stream.
+  uint64_t put_blob_stream_part_size = 8 << 20;
+  // How many pages a ListAllBlobsMetadata lists at once. The names are split
+  // into more ranges, listed side by side, as pages come back full.
+  size_t list_all_blobs_parallelism = 8;
+  // How many batches a DeleteBlobs deletes at once. A batch is up to 1000
+  // blobs of a bucket on AWS, and up to 100 on GCP.
+  size_t delete_blobs_parallelism = 8;
+  // If set, blobs are kept as files under this directory of the local
+  // filesystem instead of in the cloud, one subdirectory per bucket. Meant for
+  // local development and tests.
+  std::string local_root_directory;
+  // If set, whole blobs read with GetBlob are cached as files under this
+  // directory, which is meant to be on a local SSD. A cached blob is
+  // revalidated with a conditional read, and only downloaded again if it
+  // changed.
+  std::string cache_directory;
+  // The max total size of the cached blobs. The least recently used blobs are
+  // evicted past it, and larger blobs are not cached.
+  uint64_t cache_size_bytes = uint64_t(1) << 30;
+  // How long a cached blob is served without being revalidated. 0 revalidates
+  // it on every read.
+  std::chrono::seconds cache_revalidation_interval = std::chrono::seconds(0);
 };
 }  // namespace google::scp::cpio
 
@@ -87,6 +87,38 @@ class CryptoClientInterface : public core::ServiceInterface {
   AeadDecryptSync(const cmrt::sdk::crypto_service::v1::AeadDecryptRequest&
                       request) noexcept = 0;
 
+  /**
+   * @brief Decrypts many payloads sharing the same key using HPKE in a
+   * blocking call. The key is set up once and the payloads are decrypted in
+   * parallel. A failure to decrypt one payload is reported in its own
+   * response and does not fail the batch.
+   *
+   * @param request request to HPKE decrypt in batch.
+   * @return ExecutionResultOr<BatchHpkeDecryptResponse> result of the
+   * operation.
+   */
+  virtual core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse>
+  BatchHpkeDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest&
+          request) noexcept = 0;
+
+  /**
+   * @brief Decrypts many payloads sharing the same secret using Aead in a
+   * blocking call. The payloads are decrypted in parallel. A failure to
+   * decrypt one payload is reported in its own response and does not fail the
+   * batch.
+   *
+   * @param request request to AEAD decrypt in batch.
+   * @return ExecutionResultOr<BatchAeadDecryptResponse> result of the
+   * operation.
+   */
+  virtual core::ExecutionResultOr<
+      cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse>
+  BatchAeadDecryptSync(
+      const cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest&
+          request) noexcept = 0;
+
   /**
    * @brief Encrypts payload using Aead in a blocking call using streaming
    * manner. A wrapper around the ciphertext output stream will be returned to
@@ -17,6 +17,7 @@
 #ifndef SCP_CPIO_INTERFACE_CRYPTO_CLIENT_TYPE_DEF_H_
 #define SCP_CPIO_INTERFACE_CRYPTO_CLIENT_TYPE_DEF_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -27,6 +28,11 @@ namespace google::scp::cpio {
 /// Configurations for CryptoClient.
 struct CryptoClientOptions {
   virtual ~CryptoClientOptions() = default;
+
+  // The max number of decoded keys and Tink primitives cached for each kind of
+  // crypto operation, so that repeated calls with the same key skip the key
+  // setup. Setting it to 0 disables the caches.
+  size_t key_cache_size = 128;
 };
 
 // Request for aead decryption using streaming API
@@ -37,6 +43,9 @@ struct AeadDecryptStreamRequest {
   std::unique_ptr<std::istream> ciphertext_stream;
   // Streaming aead parameters
   cmrt::sdk::crypto_service::v1::StreamingAeadParams saead_params;
+  // If not 0, segments of AesGcmHkdfStreamingKey streams are processed in
+  // parallel on the CPU executor, with up to this many bytes in flight.
+  size_t parallel_window_size_in_bytes = 0;
 };
 
 // Request for aead encryption using streaming API
@@ -47,6 +56,9 @@ struct AeadEncryptStreamRequest {
   std::unique_ptr<std::ostream> ciphertext_stream;
   // Streaming aead parameters
   cmrt::sdk::crypto_service::v1::StreamingAeadParams saead_params;
+  // If not 0, segments of AesGcmHkdfStreamingKey streams are processed in
+  // parallel on the CPU executor, with up to this many bytes in flight.
+  size_t parallel_window_size_in_bytes = 0;
 };
 }  // namespace google::scp::cpio
 
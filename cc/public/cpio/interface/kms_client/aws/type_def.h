@@ -32,6 +32,11 @@ struct AwsKmsClientOptions : public KmsClientOptions {
   // If present, fetch the role credentials with web identity in the http
   // request.
   std::string target_audience_for_web_identity;
+
+  // Optional. Only used inside enclaves. The path of a long-lived kmstool
+  // helper that serves decrypt requests over its stdin and stdout. If not set,
+  // kmstool_enclave_cli is run for every decrypt request.
+  std::string kmstool_decrypt_helper_path;
 };
 }  // namespace google::scp::cpio
 
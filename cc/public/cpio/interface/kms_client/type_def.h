@@ -17,10 +17,20 @@
 #ifndef SCP_CPIO_INTERFACE_KMS_CLIENT_TYPE_DEF_H_
 #define SCP_CPIO_INTERFACE_KMS_CLIENT_TYPE_DEF_H_
 
+#include <cstddef>
+#include <cstdint>
+
 namespace google::scp::cpio {
 /// Configurations for KmsClient.
 struct KmsClientOptions {
   virtual ~KmsClientOptions() = default;
+
+  // How long in seconds decrypted plaintexts are cached in memory, so that
+  // decrypting the same ciphertext again does not call KMS. 0 disables the
+  // cache, which is the default since the cache keeps plaintexts in memory.
+  uint64_t decrypt_cache_ttl_in_s = 0;
+  // The max number of cached plaintexts.
+  size_t decrypt_cache_size = 1024;
 };
 }  // namespace google::scp::cpio
 
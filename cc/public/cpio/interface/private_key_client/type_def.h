@@ -17,6 +17,8 @@
 #ifndef SCP_CPIO_INTERFACE_PRIVATE_KEY_CLIENT_TYPE_DEF_H_
 #define SCP_CPIO_INTERFACE_PRIVATE_KEY_CLIENT_TYPE_DEF_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -26,6 +28,17 @@ namespace google::scp::cpio {
 /// Configuration for PrivateKeyClient.
 struct PrivateKeyClientOptions {
   virtual ~PrivateKeyClientOptions() = default;
+
+  // How long an assembled private key listed by key ID is served from memory
+  // before it is fetched and decrypted again. A key is never served past its
+  // expiration time. 0 disables the cache, which is the default since the
+  // cache keeps decrypted private keys in memory.
+  uint64_t key_cache_ttl_in_s = 0;
+  // Cached keys requested within this many seconds of the end of their TTL
+  // are refreshed in the background, so that callers keep hitting the cache.
+  uint64_t key_cache_refresh_ahead_in_s = 60;
+  // The max number of cached keys.
+  size_t key_cache_size = 1024;
 };
 }  // namespace google::scp::cpio
 
@@ -17,6 +17,7 @@
 #ifndef SCP_CPIO_INTERFACE_PUBLIC_KEY_CLIENT_TYPE_DEF_H_
 #define SCP_CPIO_INTERFACE_PUBLIC_KEY_CLIENT_TYPE_DEF_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,12 @@ struct PublicKeyClientOptions {
   virtual ~PublicKeyClientOptions() = default;
   /// This list of endpoints host the public key.
   std::vector<PublicKeyVendingServiceEndpoint> endpoints;
+  /// Whether listed public keys are served from memory until the expiration
+  /// time the endpoint advertised in its Cache-Control header.
+  bool enable_key_cache = true;
+  /// Cached keys listed within this many seconds of their expiration time are
+  /// refreshed in the background, so that listings keep hitting the cache.
+  uint64_t key_cache_refresh_ahead_in_s = 300;
 };
 
 }  // namespace google::scp::cpio
@@ -52,6 +52,23 @@ class QueueClientInterface : public core::ServiceInterface {
       cmrt::sdk::queue_service::v1::EnqueueMessageResponse>
   EnqueueMessageSync(
       cmrt::sdk::queue_service::v1::EnqueueMessageRequest request) noexcept = 0;
+  /**
+   * @brief Enqueue messages to the queue with as few calls as possible.
+   * @param enqueue_messages_context context of the operation.
+   */
+  virtual void EnqueueMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                         cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&
+          enqueue_messages_context) noexcept = 0;
+  /**
+   * @brief Enqueue messages to the queue in a blocking call.
+   * @param request request to enqueue messages.
+   * @return ExecutionResultOr<EnqueueMessagesResponse> result of the operation.
+   */
+  virtual core::ExecutionResultOr<
+      cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>
+  EnqueueMessagesSync(cmrt::sdk::queue_service::v1::EnqueueMessagesRequest
+                          request) noexcept = 0;
   /**
    * @brief Get top message from the queue.
    * @param get_top_message_context context of the operation.
@@ -69,6 +86,24 @@ class QueueClientInterface : public core::ServiceInterface {
       cmrt::sdk::queue_service::v1::GetTopMessageResponse>
   GetTopMessageSync(
       cmrt::sdk::queue_service::v1::GetTopMessageRequest request) noexcept = 0;
+  /**
+   * @brief Get up to max_messages top messages from the queue.
+   * @param get_top_messages_context context of the operation.
+   */
+  virtual void GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept = 0;
+  /**
+   * @brief Get up to max_messages top messages from the queue in a blocking
+   * call.
+   * @param request request to get top messages.
+   * @return ExecutionResult<GetTopMessagesResponse> result of the operation.
+   */
+  virtual core::ExecutionResultOr<
+      cmrt::sdk::queue_service::v1::GetTopMessagesResponse>
+  GetTopMessagesSync(
+      cmrt::sdk::queue_service::v1::GetTopMessagesRequest request) noexcept = 0;
   /**
    * @brief Update visibility timeout of a message from the queue.
    * @param update_message_visibility_timeout_context context of the operation.
@@ -107,6 +142,23 @@ class QueueClientInterface : public core::ServiceInterface {
       cmrt::sdk::queue_service::v1::DeleteMessageResponse>
   DeleteMessageSync(
       cmrt::sdk::queue_service::v1::DeleteMessageRequest request) noexcept = 0;
+  /**
+   * @brief Delete messages from the queue with as few calls as possible.
+   * @param delete_messages_context context of the operation.
+   */
+  virtual void DeleteMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                         cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&
+          delete_messages_context) noexcept = 0;
+  /**
+   * @brief Delete messages from the queue in a blocking call.
+   * @param request request to delete messages.
+   * @return ExecutionResultOr<DeleteMessagesResponse> result of the operation.
+   */
+  virtual core::ExecutionResultOr<
+      cmrt::sdk::queue_service::v1::DeleteMessagesResponse>
+  DeleteMessagesSync(
+      cmrt::sdk::queue_service::v1::DeleteMessagesRequest request) noexcept = 0;
 };
 
 class QueueClientFactory {
@@ -17,6 +17,8 @@
 #ifndef SCP_CPIO_INTERFACE_QUEUE_CLIENT_TYPE_DEF_H_
 #define SCP_CPIO_INTERFACE_QUEUE_CLIENT_TYPE_DEF_H_
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 
 namespace google::scp::cpio {
@@ -27,7 +29,10 @@ struct QueueClientOptions {
   QueueClientOptions() = default;
 
   QueueClientOptions(const QueueClientOptions& options)
-      : queue_name(options.queue_name) {}
+      : queue_name(options.queue_name),
+        prefetch_buffer_size(options.prefetch_buffer_size),
+        prefetch_lease_duration(options.prefetch_lease_duration),
+        batch_linger_duration(options.batch_linger_duration) {}
 
   /**
    * @brief Required. The identifier of the queue. The queue is per client per
@@ -37,6 +42,30 @@ struct QueueClientOptions {
    *
    */
   std::string queue_name;
+
+  /**
+   * @brief How many messages to receive ahead into a local buffer, which
+   * GetTopMessage and GetTopMessages then serve without a round trip. The
+   * buffer is refilled in the background with long polling. 0 disables it.
+   */
+  size_t prefetch_buffer_size = 0;
+
+  /**
+   * @brief How long buffered messages stay invisible to other consumers, from
+   * 10 to 600 seconds. It is extended while they are buffered, so a message
+   * got from the buffer stays invisible for up to this long unless its
+   * visibility timeout is updated. Buffered messages are made visible again on
+   * Stop.
+   */
+  std::chrono::seconds prefetch_lease_duration = std::chrono::seconds(30);
+
+  /**
+   * @brief How long EnqueueMessage and DeleteMessage wait for concurrent calls
+   * to send along in one batched call, unless the batch fills up first. The
+   * calls finish once their batch is sent. 0 disables it.
+   */
+  std::chrono::milliseconds batch_linger_duration =
+      std::chrono::milliseconds(0);
 };
 }  // namespace google::scp::cpio
 
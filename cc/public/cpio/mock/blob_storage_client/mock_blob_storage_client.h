@@ -94,6 +94,20 @@ class MockBlobStorageClient : public BlobStorageClientInterface {
       ((google::cmrt::sdk::blob_storage_service::v1::DeleteBlobRequest)),
       (noexcept, override));
 
+  MOCK_METHOD(
+      void, DeleteBlobs,
+      ((core::AsyncContext<
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest,
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>&)),
+      (noexcept, override));
+
+  MOCK_METHOD(
+      core::ExecutionResultOr<
+          google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsResponse>,
+      DeleteBlobsSync,
+      ((google::cmrt::sdk::blob_storage_service::v1::DeleteBlobsRequest)),
+      (noexcept, override));
+
   /// Streaming operations.
 
   MOCK_METHOD(
@@ -63,6 +63,18 @@ class MockCryptoClient : public CryptoClientInterface {
               ((const cmrt::sdk::crypto_service::v1::AeadDecryptRequest&)),
               (noexcept, override));
 
+  MOCK_METHOD(core::ExecutionResultOr<
+                  cmrt::sdk::crypto_service::v1::BatchHpkeDecryptResponse>,
+              BatchHpkeDecryptSync,
+              ((const cmrt::sdk::crypto_service::v1::BatchHpkeDecryptRequest&)),
+              (noexcept, override));
+
+  MOCK_METHOD(core::ExecutionResultOr<
+                  cmrt::sdk::crypto_service::v1::BatchAeadDecryptResponse>,
+              BatchAeadDecryptSync,
+              ((const cmrt::sdk::crypto_service::v1::BatchAeadDecryptRequest&)),
+              (noexcept, override));
+
   MOCK_METHOD(core::ExecutionResultOr<
                   cmrt::sdk::crypto_service::v1::ComputeMacResponse>,
               ComputeMacSync,
@@ -51,6 +51,18 @@ class MockQueueClient : public QueueClientInterface {
               ((cmrt::sdk::queue_service::v1::EnqueueMessageRequest)),
               (noexcept, override));
 
+  MOCK_METHOD(void, EnqueueMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::EnqueueMessagesRequest,
+                  cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>&)),
+              (noexcept, override));
+
+  MOCK_METHOD(core::ExecutionResultOr<
+                  cmrt::sdk::queue_service::v1::EnqueueMessagesResponse>,
+              EnqueueMessagesSync,
+              ((cmrt::sdk::queue_service::v1::EnqueueMessagesRequest)),
+              (noexcept, override));
+
   MOCK_METHOD(void, GetTopMessage,
               ((core::AsyncContext<
                   cmrt::sdk::queue_service::v1::GetTopMessageRequest,
@@ -63,6 +75,18 @@ class MockQueueClient : public QueueClientInterface {
               ((cmrt::sdk::queue_service::v1::GetTopMessageRequest)),
               (noexcept, override));
 
+  MOCK_METHOD(void, GetTopMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                  cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&)),
+              (noexcept, override));
+
+  MOCK_METHOD(core::ExecutionResultOr<
+                  cmrt::sdk::queue_service::v1::GetTopMessagesResponse>,
+              GetTopMessagesSync,
+              ((cmrt::sdk::queue_service::v1::GetTopMessagesRequest)),
+              (noexcept, override));
+
   MOCK_METHOD(
       void, UpdateMessageVisibilityTimeout,
       ((core::AsyncContext<
@@ -90,5 +114,17 @@ class MockQueueClient : public QueueClientInterface {
               DeleteMessageSync,
               ((cmrt::sdk::queue_service::v1::DeleteMessageRequest request)),
               (noexcept, override));
+
+  MOCK_METHOD(void, DeleteMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::DeleteMessagesRequest,
+                  cmrt::sdk::queue_service::v1::DeleteMessagesResponse>&)),
+              (noexcept, override));
+
+  MOCK_METHOD(core::ExecutionResultOr<
+                  cmrt::sdk::queue_service::v1::DeleteMessagesResponse>,
+              DeleteMessagesSync,
+              ((cmrt::sdk::queue_service::v1::DeleteMessagesRequest)),
+              (noexcept, override));
 };
 }  // namespace google::scp::cpio